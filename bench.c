@@ -0,0 +1,2842 @@
+/**
+ *\file     bench.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    性能测试实现
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加延迟子树首次显示测试
+ *          2026.10.18|增加相对虚拟地址查找测试
+ *          2026.10.18|增加正常文件与变异文件的解析测试
+ *          2026.10.18|增加JSON Lines和二进制记录输出测试
+ *          2026.10.18|增加导出函数查找测试
+ *          2026.10.18|增加重定位数据项解码测试
+ *          2026.10.18|增加名称字符串提取测试
+ *          2026.10.18|增加tar包流式读取测试
+ *          2026.10.18|增加节的熵和摘要测试
+ *          2026.10.18|增加导入表散列和Rich头测试
+ *          2026.10.18|增加分阶段计时开销测试
+ *          2026.10.18|增加合成PE文件的性能回归测试集
+ *          2026.10.18|增加资源表测试
+ *          2026.10.18|增加导入表与延迟导入表的解析和树测试
+ *          2026.10.18|增加只取符号键测试
+ *          2026.10.18|增加Authenticode摘要测试
+ */
+#include <ctype.h>
+#include "bench.h"
+#include "bench_suite.h"
+#include "pe_tree.h"
+#include "pe_emit.h"
+#include "pe_reloc.h"
+#include "pe_str.h"
+#include "pe_stream.h"
+#include "pe_digest.h"
+#include "pe_finger.h"
+#include "pe_stat.h"
+#include "pe_rsrc.h"
+#include "pe_debug.h"
+#include "pe_auth.h"
+#include "gen.h"
+
+typedef int (*bench_proc)(int argc, char **argv);                           ///< 测试项函数
+
+typedef struct _BENCH_ITEM                                                  ///  测试项
+{
+    char       *name;                                                       ///< 测试项名称
+    bench_proc  proc;                                                       ///< 测试项函数
+    char       *help;                                                       ///< 说明
+
+} BENCH_ITEM, *PBENCH_ITEM;
+
+typedef struct _BENCH_LIST                                                  ///  文件列表
+{
+    char      **list;                                                       ///< 文件路径
+    size_t      count;                                                      ///< 文件数量
+    size_t      cap;                                                        ///< 列表容量
+
+} BENCH_LIST, *PBENCH_LIST;
+
+typedef struct _BENCH_LAZY                                                  ///  延迟子树测试输出树
+{
+    ULONGLONG   items;                                                      ///< 节点数量,必须是第一个成员,bench_insert使用
+    DWORD      *lazy;                                                       ///< 还没有展开的延迟子树
+    size_t      count;                                                      ///< 还没有展开的延迟子树数量
+    size_t      cap;                                                        ///< 容量
+
+} BENCH_LAZY, *PBENCH_LAZY;
+
+
+/**
+ *\brief                        遍历目录回调,将文件加入列表
+ *\param[in]    path            文件路径
+ *\param[in]    param           文件列表
+ *\return                       0-成功,其它失败
+ */
+static int bench_add(const char *path, void *param)
+{
+    PBENCH_LIST files = (PBENCH_LIST)param;
+
+    if (files->count == files->cap)
+    {
+        size_t cap  = files->cap ? files->cap * 2 : 1024;
+        char **list = realloc(files->list, cap * sizeof(char*));
+
+        if (NULL == list)
+        {
+            return -1;
+        }
+
+        files->list = list;
+        files->cap  = cap;
+    }
+
+    files->list[files->count] = strdup(path);
+
+    return (NULL == files->list[files->count++]) ? -2 : 0;
+}
+
+/**
+ *\brief                        收集所有路径下的文件
+ *\param[in]    argc            路径个数
+ *\param[in]    argv            路径
+ *\param[out]   files           文件列表
+ *\return                       0-成功,其它失败
+ */
+static int bench_files(int argc, char **argv, PBENCH_LIST files)
+{
+    memset(files, 0, sizeof(BENCH_LIST));
+
+    for (int i = 0; i < argc; i++)
+    {
+        if (0 != dir_walk(argv[i], bench_add, files))
+        {
+            fprintf(stderr, "walk %s error\n", argv[i]);
+        }
+    }
+
+    return (files->count > 0) ? 0 : -1;
+}
+
+/**
+ *\brief                        释放文件列表
+ *\param[in]    files           文件列表
+ *\return                       无
+ */
+static void bench_files_free(PBENCH_LIST files)
+{
+    for (size_t i = 0; i < files->count; i++)
+    {
+        free(files->list[i]);
+    }
+
+    free(files->list);
+    memset(files, 0, sizeof(BENCH_LIST));
+}
+
+/**
+ *\brief                        插入树节点回调,只计数
+ *\param[in]    param           计数
+ *\param[in]    parent          父节点句柄
+ *\param[in]    txt             节点文本
+ *\return                       新节点句柄
+ */
+static PE_NODE bench_insert(void *param, PE_NODE parent, const char *txt)
+{
+    (*(ULONGLONG*)param)++;
+    return (PE_NODE)1;
+}
+
+/**
+ *\brief                        文件加载测试,比较整个文件读入内存与内存映射的耗时和内存峰值
+ *                              peinfo bench load [-n 轮数] 路径...
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_load(int argc, char **argv)
+{
+    char      *mode_name[] = { "read", "map" };
+    BENCH_LIST files;
+    FILE_MAP   map;
+    PE_IMAGE   image;
+    int        rounds = 3;
+    int        first  = 1;
+
+    if (argc > 2 && 0 == strcmp(argv[1], "-n"))
+    {
+        rounds = atoi(argv[2]);
+        first  = 3;
+    }
+
+    if (0 != bench_files(argc - first, argv + first, &files))
+    {
+        fprintf(stderr, "usage: peinfo bench load [-n rounds] path...\n");
+        return -1;
+    }
+
+    for (size_t i = 0; i < files.count; i++) // 预热,让两种方式都从页缓存读
+    {
+        if (0 == file_read(files.list[i], &map))
+        {
+            file_unmap(&map);
+        }
+    }
+
+    double best[2]  = { 1e30, 1e30 };
+    size_t peak[2]  = { 0, 0 };
+    size_t fault[2] = { 0, 0 };
+    ULONGLONG bytes = 0;
+    ULONGLONG items = 0;
+    ULONGLONG pe    = 0;
+
+    for (int r = 0; r < rounds; r++)
+    {
+        for (int mode = 0; mode < 2; mode++)
+        {
+            PE_TREE tree = { bench_insert, &items, NULL };
+
+            bytes = 0;
+            items = 0;
+            pe    = 0;
+
+            mem_peak_reset();
+
+            size_t faults = page_faults();
+            double start  = time_now();
+
+            for (size_t i = 0; i < files.count; i++)
+            {
+                int ret = (0 == mode) ? file_read(files.list[i], &map) : file_map(files.list[i], &map);
+
+                if (0 != ret)
+                {
+                    continue;
+                }
+
+                bytes += map.size;
+
+                if (0 == pe_parse(&image, map.data, map.size))
+                {
+                    pe_insert_tree(&tree, &image);
+                    pe++;
+                }
+
+                pe_free(&image);
+
+                file_unmap(&map);
+            }
+
+            double secs = time_now() - start;
+
+            if (secs < best[mode])
+            {
+                best[mode]  = secs;
+                fault[mode] = page_faults() - faults;
+            }
+
+            if (mem_peak() > peak[mode])
+            {
+                peak[mode] = mem_peak();
+            }
+        }
+    }
+
+    printf("files:%zu pe:%llu bytes:%llu items:%llu rounds:%d\n",
+           files.count, (unsigned long long)pe, (unsigned long long)bytes,
+           (unsigned long long)items, rounds);
+    printf("%-6s %10s %12s %12s %10s\n", "mode", "time(s)", "MB/s", "peak(KB)", "faults");
+
+    for (int mode = 0; mode < 2; mode++)
+    {
+        printf("%-6s %10.4f %12.2f %12zu %10zu\n", mode_name[mode], best[mode],
+               bytes / best[mode] / (1024 * 1024), peak[mode], fault[mode]);
+    }
+
+    bench_files_free(&files);
+    return 0;
+}
+
+/**
+ *\brief                        插入延迟子树节点回调,记录下来等待展开
+ *\param[in]    param           BENCH_LAZY
+ *\param[in]    parent          父节点句柄
+ *\param[in]    txt             节点文本
+ *\param[in]    lazy            延迟子树标识
+ *\return                       新节点句柄
+ */
+static PE_NODE bench_lazy_insert(void *param, PE_NODE parent, const char *txt, DWORD lazy)
+{
+    PBENCH_LAZY tree = (PBENCH_LAZY)param;
+
+    tree->items++;
+
+    if (tree->count == tree->cap)
+    {
+        size_t cap  = tree->cap ? tree->cap * 2 : 1024;
+        DWORD *list = realloc(tree->lazy, cap * sizeof(DWORD));
+
+        if (NULL == list)
+        {
+            return (PE_NODE)1; // 内存不足时不再展开
+        }
+
+        tree->lazy = list;
+        tree->cap  = cap;
+    }
+
+    tree->lazy[tree->count++] = lazy;
+    return (PE_NODE)1;
+}
+
+/**
+ *\brief                        延迟子树测试,比较立即插入全部节点与首次显示只插入顶层节点的耗时
+ *                              peinfo bench lazy [-n 轮数] [-b 重定位块数] [-r 每块重定位项数] [文件]
+ *                              没有文件时生成重定位表很大的合成PE文件
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_lazy(int argc, char **argv)
+{
+    PE_GEN     gen    = { 0, 4, 64, 256, 2048, 1024, 0, 32 };
+    char      *path   = NULL;
+    int        rounds = 3;
+    FILE_MAP   map    = { 0 };
+    PE_IMAGE   image;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (0 == strcmp(argv[i], "-n") && i + 1 < argc) rounds = atoi(argv[++i]);
+        else if (0 == strcmp(argv[i], "-b") && i + 1 < argc) gen.reloc_blocks  = (DWORD)strtoul(argv[++i], NULL, 0);
+        else if (0 == strcmp(argv[i], "-r") && i + 1 < argc) gen.reloc_entries = (DWORD)strtoul(argv[++i], NULL, 0);
+        else path = argv[i];
+    }
+
+    if ((NULL != path) ? (0 != file_map(path, &map)) : (0 != pe_gen(&gen, &map.data, &map.size)))
+    {
+        fprintf(stderr, "usage: peinfo bench lazy [-n rounds] [-b reloc_blocks] [-r reloc_entries] [file]\n");
+        return -1;
+    }
+
+    char      *mode_name[] = { "eager", "first", "block", "all" };
+    double     best[4]     = { 1e30, 1e30, 1e30, 1e30 };
+    ULONGLONG  items[4]    = { 0, 0, 0, 0 };
+    int        ret         = 0;
+    DWORD      blocks      = 0;
+
+    for (int r = 0; r < rounds && 0 == ret; r++)
+    {
+        ULONGLONG  count = 0;
+        BENCH_LAZY lazy  = { 0 };
+        PE_TREE    eager = { bench_insert, &count, NULL };
+        PE_TREE    tree  = { bench_insert, &lazy, bench_lazy_insert };
+        double     t[5];
+
+        // 立即插入全部节点
+        t[0] = time_now();
+        ret  = pe_parse(&image, map.data, map.size);
+
+        if (0 == ret)
+        {
+            pe_insert_tree(&eager, &image);
+        }
+
+        pe_free(&image);
+        t[1] = time_now();
+
+        if (0 != ret)
+        {
+            break;
+        }
+
+        // 首次显示,只插入顶层节点
+        pe_parse(&image, map.data, map.size);
+        pe_insert_tree(&tree, &image);
+        t[2] = time_now();
+
+        ULONGLONG first = lazy.items;
+
+        // 展开重定位表和第一个块,用户最常见的操作
+        for (size_t i = 0, n = 0; i < lazy.count && n < 2; i++)
+        {
+            DWORD type = PE_LAZY_TYPE(lazy.lazy[i]);
+
+            if ((0 == n && PE_LAZY_RELOC == type) || (1 == n && PE_LAZY_RELOC_BLOCK == type))
+            {
+                pe_tree_expand(&tree, &image, (PE_NODE)1, lazy.lazy[i]);
+                lazy.lazy[i] = 0;
+                n++;
+            }
+        }
+
+        t[3] = time_now();
+
+        ULONGLONG block = lazy.items;
+
+        // 展开全部,展开时产生的延迟子树追加到列表尾部
+        for (size_t i = 0; i < lazy.count; i++)
+        {
+            if (0 != lazy.lazy[i])
+            {
+                pe_tree_expand(&tree, &image, (PE_NODE)1, lazy.lazy[i]);
+            }
+        }
+
+        t[4]   = time_now();
+        blocks = image.reloc_count;
+        pe_free(&image);
+
+        double secs[4] = { t[1] - t[0], t[2] - t[1], t[3] - t[2], t[4] - t[1] };
+
+        items[0] = count;
+        items[1] = first;
+        items[2] = block - first;
+        items[3] = lazy.items;
+
+        for (int mode = 0; mode < 4; mode++)
+        {
+            if (secs[mode] < best[mode])
+            {
+                best[mode] = secs[mode];
+            }
+        }
+
+        free(lazy.lazy);
+    }
+
+    if (0 == ret)
+    {
+        printf("bytes:%zu reloc_blocks:%u rounds:%d\n", map.size, blocks, rounds);
+        printf("%-6s %10s %12s\n", "mode", "time(s)", "items");
+
+        for (int mode = 0; mode < 4; mode++)
+        {
+            printf("%-6s %10.4f %12llu\n", mode_name[mode], best[mode], (unsigned long long)items[mode]);
+        }
+
+        if (items[0] != items[3])
+        {
+            fprintf(stderr, "lazy items %llu != eager items %llu\n",
+                    (unsigned long long)items[3], (unsigned long long)items[0]);
+            ret = -3;
+        }
+    }
+    else
+    {
+        fprintf(stderr, "parse error %d\n", ret);
+    }
+
+    if (NULL != path)
+    {
+        file_unmap(&map);
+    }
+    else
+    {
+        free(map.data);
+    }
+
+    return ret;
+}
+
+/**
+ *\brief                        相对虚拟地址查找测试,比较线性查找与索引二分查找
+ *                              peinfo bench rva [-n 查找次数] [-s 节数]
+ *                              没有指定节数时测试4,16,96,256,1024个节的合成PE文件
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_rva(int argc, char **argv)
+{
+    DWORD  list[]   = { 4, 16, 96, 256, 1024 };
+    DWORD  sections = 0;
+    DWORD  lookups  = 10000000;
+    int    ret      = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (0 == strcmp(argv[i], "-n") && i + 1 < argc) lookups  = (DWORD)strtoul(argv[++i], NULL, 0);
+        else if (0 == strcmp(argv[i], "-s") && i + 1 < argc) sections = (DWORD)strtoul(argv[++i], NULL, 0);
+        else lookups = 0;
+    }
+
+    if (0 == lookups || (0 != sections && sections < 3)) // 合成文件至少3个节
+    {
+        fprintf(stderr, "usage: peinfo bench rva [-n lookups] [-s sections(>=3)]\n");
+        return -1;
+    }
+
+    DWORD *rva = malloc(lookups * sizeof(DWORD));
+
+    if (NULL == rva)
+    {
+        return -2;
+    }
+
+    printf("%-8s %12s %14s %14s %8s\n", "sections", "lookups", "linear(/s)", "index(/s)", "speedup");
+
+    for (int n = 0; n < SIZEOF(list) && 0 == ret; n++)
+    {
+        PE_GEN   gen  = { (sections ? sections : list[n]) - 3, 0, 0, 0, 0, 0, 0, 32 };
+        UCHAR   *data = NULL;
+        size_t   size = 0;
+        PE_IMAGE image;
+
+        if (0 != pe_gen(&gen, &data, &size) || 0 != pe_parse(&image, data, size))
+        {
+            fprintf(stderr, "gen error\n");
+            free(data);
+            ret = -3;
+            break;
+        }
+
+        DWORD seed = 12345;
+
+        for (DWORD i = 0; i < lookups; i++) // 地址均匀分布在映像内,少量在映像外
+        {
+            seed   = seed * 1103515245 + 12345;
+            rva[i] = seed % (image.image_size + image.image_size / 16);
+        }
+
+        ULONGLONG sum[2] = { 0, 0 };
+        double    t[3];
+
+        t[0] = time_now();
+
+        for (DWORD i = 0; i < lookups; i++)
+        {
+            sum[0] += pe_section_find_linear(&image, rva[i]);
+        }
+
+        t[1] = time_now();
+
+        for (DWORD i = 0; i < lookups; i++)
+        {
+            sum[1] += pe_section_find(&image, rva[i]);
+        }
+
+        t[2] = time_now();
+
+        if (sum[0] != sum[1])
+        {
+            fprintf(stderr, "result mismatch\n");
+            ret = -4;
+        }
+
+        printf("%-8d %12u %14.0f %14.0f %8.2f\n", image.section_count, lookups,
+               lookups / (t[1] - t[0]), lookups / (t[2] - t[1]), (t[1] - t[0]) / (t[2] - t[1]));
+
+        pe_free(&image);
+        free(data);
+
+        if (0 != sections)
+        {
+            break;
+        }
+    }
+
+    free(rva);
+    return ret;
+}
+
+/**
+ *\brief                        伪随机数
+ *\param[in,out]seed            种子
+ *\return                       随机数
+ */
+static DWORD bench_rand(DWORD *seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+/**
+ *\brief                        随机变异文件数据,一半改在头部的4KB内,也会改成特殊值或截短文件
+ *\param[in,out]data            文件数据
+ *\param[in]    size            文件长度
+ *\param[in,out]seed            随机数种子
+ *\return                       变异后的文件长度
+ */
+static size_t bench_mutate(UCHAR *data, size_t size, DWORD *seed)
+{
+    DWORD special[] = { 0, 0xFFFFFFFF, 0x7FFFFFFF, 0x80000000, 0x10000, 0xFFFF };
+    int   count     = 1 + bench_rand(seed) % 8;
+
+    for (int i = 0; i < count && size > 4; i++)
+    {
+        size_t off  = bench_rand(seed) % ((bench_rand(seed) & 1) ? size : (size < 4096 ? size : 4096));
+        DWORD  kind = bench_rand(seed) % 8;
+
+        if (off > size - 4)
+        {
+            off = size - 4;
+        }
+
+        if (kind < 4) // 改一个字节
+        {
+            data[off] = (UCHAR)bench_rand(seed);
+        }
+        else if (kind < 7) // 改一个DWORD为特殊值
+        {
+            DWORD value = special[bench_rand(seed) % SIZEOF(special)];
+            memcpy(data + off, &value, 4);
+        }
+        else // 截短
+        {
+            size = off + 4;
+        }
+    }
+
+    return size;
+}
+
+/**
+ *\brief                        解析测试,正常文件与随机变异的文件,解析并插入全部节点
+ *                              peinfo bench fuzz [-n 轮数] [-m 每个文件的变异数] [-s 种子] 路径...
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_fuzz(int argc, char **argv)
+{
+    BENCH_LIST files;
+    int        rounds  = 3;
+    int        mutants = 8;
+    DWORD      seed    = 1;
+    int        first   = 1;
+
+    for (; first + 1 < argc && '-' == argv[first][0]; first += 2)
+    {
+        if      (0 == strcmp(argv[first], "-n")) rounds  = atoi(argv[first + 1]);
+        else if (0 == strcmp(argv[first], "-m")) mutants = atoi(argv[first + 1]);
+        else if (0 == strcmp(argv[first], "-s")) seed    = (DWORD)strtoul(argv[first + 1], NULL, 0);
+    }
+
+    if (0 != bench_files(argc - first, argv + first, &files))
+    {
+        fprintf(stderr, "usage: peinfo bench fuzz [-n rounds] [-m mutants] [-s seed] path...\n");
+        return -1;
+    }
+
+    // 只用能解析的PE文件,全部读入内存,变异文件也预先生成
+    size_t    count  = 0;
+    size_t    total  = (size_t)files.count * (1 + mutants);
+    FILE_MAP *corpus = calloc(total, sizeof(FILE_MAP));
+
+    for (size_t i = 0; NULL != corpus && i < files.count; i++)
+    {
+        FILE_MAP map;
+
+        if (0 != file_read(files.list[i], &map))
+        {
+            continue;
+        }
+
+        if (PE_OK != pe_check(map.data, map.size))
+        {
+            file_unmap(&map);
+            continue;
+        }
+
+        corpus[count++] = map;
+    }
+
+    size_t valid = count;
+
+    for (size_t i = 0; NULL != corpus && i < valid; i++)
+    {
+        for (int m = 0; m < mutants; m++)
+        {
+            FILE_MAP *map = &corpus[count];
+
+            map->data = malloc(corpus[i].size);
+
+            if (NULL == map->data)
+            {
+                break;
+            }
+
+            memcpy(map->data, corpus[i].data, corpus[i].size);
+            map->size = bench_mutate(map->data, corpus[i].size, &seed);
+            count++;
+        }
+    }
+
+    char      *set_name[] = { "valid", "fuzzed" };
+    size_t     set[3]     = { 0, valid, count };
+    double     best[2]    = { 1e30, 1e30 };
+    ULONGLONG  bytes[2]   = { 0, 0 };
+    ULONGLONG  items      = 0;
+    ULONGLONG  error[16]  = { 0 };
+
+    for (size_t i = 0; i < count; i++)
+    {
+        bytes[i >= valid] += corpus[i].size;
+    }
+
+    for (int r = 0; r < rounds; r++)
+    {
+        for (int n = 0; n < 2; n++)
+        {
+            PE_TREE  tree = { bench_insert, &items, NULL };
+            PE_IMAGE image;
+            double   start = time_now();
+
+            for (size_t i = set[n]; i < set[n + 1]; i++)
+            {
+                int ret = pe_parse(&image, corpus[i].data, corpus[i].size);
+
+                if (PE_ERR_NOT_MZ != ret && PE_ERR_NT_RANGE != ret && PE_ERR_NOT_PE != ret &&
+                    PE_ERR_UNSUPPORTED != ret && PE_ERR_MEMORY != ret)
+                {
+                    pe_insert_tree(&tree, &image);
+                }
+
+                if (0 == r)
+                {
+                    error[(-ret) & 15]++;
+                }
+
+                pe_free(&image);
+            }
+
+            double secs = time_now() - start;
+
+            if (secs < best[n])
+            {
+                best[n] = secs;
+            }
+        }
+    }
+
+    printf("valid:%zu fuzzed:%zu rounds:%d\n", valid, count - valid, rounds);
+    printf("%-8s %10s %12s %12s\n", "set", "time(s)", "files/s", "MB/s");
+
+    for (int n = 0; n < 2; n++)
+    {
+        printf("%-8s %10.4f %12.0f %12.2f\n", set_name[n], best[n],
+               (set[n + 1] - set[n]) / best[n], bytes[n] / best[n] / (1024 * 1024));
+    }
+
+    printf("result:");
+
+    for (int i = 0; i < SIZEOF(error); i++)
+    {
+        if (0 != error[i])
+        {
+            printf(" %s:%llu", pe_error_string(-i), (unsigned long long)error[i]);
+        }
+    }
+
+    printf("\n");
+
+    for (size_t i = 0; NULL != corpus && i < count; i++)
+    {
+        if (i < valid)
+        {
+            file_unmap(&corpus[i]);
+        }
+        else
+        {
+            free(corpus[i].data);
+        }
+    }
+
+    free(corpus);
+    bench_files_free(&files);
+    return 0;
+}
+
+/**
+ *\brief                        插入树节点回调,累计文本长度,每个节点算一行
+ *\param[in]    param           文本长度
+ *\param[in]    parent          父节点句柄
+ *\param[in]    txt             节点文本
+ *\return                       新节点句柄
+ */
+static PE_NODE bench_text_insert(void *param, PE_NODE parent, const char *txt)
+{
+    (*(ULONGLONG*)param) += strlen(txt) + 1;
+    return (PE_NODE)1;
+}
+
+/**
+ *\brief                        机器可读输出测试,解析一次后反复输出到同一个缓冲区,与树节点文本格式化比较
+ *                              peinfo bench emit [-n 轮数] [-w 32|64] [文件]
+ *                              没有文件时生成导入导出表很大的合成PE文件
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_emit(int argc, char **argv)
+{
+    PE_GEN     gen    = { 0, 64, 512, 65536, 256, 256, 0, 32 };
+    char      *path   = NULL;
+    int        rounds = 20;
+    FILE_MAP   map    = { 0 };
+    PE_IMAGE   image;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (0 == strcmp(argv[i], "-n") && i + 1 < argc) rounds   = atoi(argv[++i]);
+        else if (0 == strcmp(argv[i], "-w") && i + 1 < argc) gen.bits = (DWORD)strtoul(argv[++i], NULL, 0);
+        else path = argv[i];
+    }
+
+    if (rounds <= 0 || ((NULL != path) ? (0 != file_map(path, &map)) : (0 != pe_gen(&gen, &map.data, &map.size))))
+    {
+        fprintf(stderr, "usage: peinfo bench emit [-n rounds] [-w 32|64] [file]\n");
+        return -1;
+    }
+
+    double t   = time_now();
+    int    ret = pe_parse(&image, map.data, map.size);
+
+    t = time_now() - t;
+
+    char      *mode_name[] = { "json", "bin", "tree" };
+    double     best[3]     = { 1e30, 1e30, 1e30 };
+    ULONGLONG  bytes[3]    = { 0, 0, 0 };
+    PE_BUF     buf         = { 0 };
+
+    for (int r = 0; r < rounds && PE_ERR_MEMORY != ret && ret > PE_ERR_UNSUPPORTED; r++)
+    {
+        for (int mode = 0; mode < 3; mode++)
+        {
+            ULONGLONG text  = 0;
+            PE_TREE   tree  = { bench_text_insert, &text, NULL };
+            double    start = time_now();
+
+            buf.len = 0; // 缓冲区重复使用,只有第一轮会扩大
+
+            if (2 == mode)
+            {
+                pe_insert_tree(&tree, &image);
+            }
+            else if (0 != pe_emit(&buf, mode, (PE_OK == ret) ? "ok" : "error", &image, map.size, (NULL != path) ? path : "gen"))
+            {
+                ret = PE_ERR_MEMORY;
+                break;
+            }
+
+            double secs = time_now() - start;
+
+            bytes[mode] = (2 == mode) ? text : buf.len;
+
+            if (secs < best[mode])
+            {
+                best[mode] = secs;
+            }
+        }
+    }
+
+    if (PE_ERR_MEMORY != ret && ret > PE_ERR_UNSUPPORTED)
+    {
+        ULONGLONG funcs = 0;
+
+        for (DWORD i = 0; i < image.lib_count; i++)
+        {
+            funcs += image.lib[i].func_count;
+        }
+
+        printf("bytes:%zu imports:%llu exports:%u relocs:%llu parse:%.4fs rounds:%d\n",
+               map.size, (unsigned long long)funcs, image.export.func_count,
+               (unsigned long long)image.reloc_entries, t, rounds);
+        printf("%-6s %10s %12s %10s\n", "format", "time(s)", "out(bytes)", "MB/s");
+
+        for (int mode = 0; mode < 3; mode++)
+        {
+            printf("%-6s %10.4f %12llu %10.1f\n", mode_name[mode], best[mode],
+                   (unsigned long long)bytes[mode], bytes[mode] / best[mode] / (1024 * 1024));
+        }
+
+        ret = 0;
+    }
+    else
+    {
+        fprintf(stderr, "parse error %d\n", ret);
+    }
+
+    pe_buf_free(&buf);
+    pe_free(&image);
+
+    if (NULL != path)
+    {
+        file_unmap(&map);
+    }
+    else
+    {
+        free(map.data);
+    }
+
+    return ret;
+}
+
+/**
+ *\brief                        比较字符串指针,用于排序
+ */
+static int bench_cmp_str(const void *a, const void *b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/**
+ *\brief                        导出函数查找测试,比较线性查找,二分查找,带提示序号,批量和按序号查找
+ *                              peinfo bench export [-n 查找次数] [-e 导出函数数] [文件]
+ *                              没有文件时生成导出函数很多的合成PE文件,线性查找只测1/1000的次数
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_export(int argc, char **argv)
+{
+    PE_GEN     gen     = { 0, 0, 0, 16384, 0, 0, 0, 32 };
+    char      *path    = NULL;
+    DWORD      lookups = 1000000;
+    FILE_MAP   map     = { 0 };
+    PE_IMAGE   image;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (0 == strcmp(argv[i], "-n") && i + 1 < argc) lookups     = (DWORD)strtoul(argv[++i], NULL, 0);
+        else if (0 == strcmp(argv[i], "-e") && i + 1 < argc) gen.exports = (DWORD)strtoul(argv[++i], NULL, 0);
+        else path = argv[i];
+    }
+
+    if (0 == lookups || ((NULL != path) ? (0 != file_map(path, &map)) : (0 != pe_gen(&gen, &map.data, &map.size))))
+    {
+        fprintf(stderr, "usage: peinfo bench export [-n lookups] [-e exports] [file]\n");
+        return -1;
+    }
+
+    int   ret   = pe_parse(&image, map.data, map.size);
+    DWORD count = image.export.name_count;
+
+    char            **names = calloc(count + 1, sizeof(char*));        // 名称表中的名称,复制出来保证以0结尾
+    const char      **query = malloc(lookups * sizeof(char*));
+    WORD             *hints = malloc(lookups * sizeof(WORD));
+    DWORD            *ords  = malloc(lookups * sizeof(DWORD));
+    PPE_EXPORT_SYMBOL syms  = malloc(lookups * sizeof(PE_EXPORT_SYMBOL));
+
+    if (PE_ERR_MEMORY == ret || ret <= PE_ERR_UNSUPPORTED || 0 == count || NULL == names ||
+        NULL == query || NULL == hints || NULL == ords || NULL == syms)
+    {
+        fprintf(stderr, "no exports or parse error %d\n", ret);
+        ret = -2;
+    }
+    else
+    {
+        ret = 0;
+    }
+
+    for (DWORD i = 0; 0 == ret && i < count; i++)
+    {
+        DWORD  fa  = 0;
+        size_t len = 0;
+
+        pe_rva_to_fa(&image, le32(map.data + image.export.names_fa + i * sizeof(DWORD)), &fa);
+
+        const char *name = view_strn(&image.view, fa, 4096, &len);
+
+        names[i] = malloc(len + 1);
+
+        if (NULL == names[i])
+        {
+            ret = -3;
+            break;
+        }
+
+        memcpy(names[i], name, len);
+        names[i][len] = '\0';
+    }
+
+    if (0 == ret)
+    {
+        char     *mode_name[] = { "linear", "find", "hint", "batch", "ordinal" };
+        DWORD     found[5]    = { 0 };
+        DWORD     runs[5]     = { lookups / 1000 ? lookups / 1000 : 1, lookups, lookups, lookups, lookups };
+        double    secs[5];
+        double    start;
+        DWORD     seed        = 12345;
+
+        for (DWORD i = 0; i < lookups; i++) // 随机取名称表中的名称
+        {
+            DWORD id = bench_rand(&seed) % count;
+
+            query[i] = names[id];
+            hints[i] = (WORD)id;
+            ords[i]  = image.export.base + bench_rand(&seed) % image.export.func_count;
+        }
+
+        start = time_now();
+
+        for (DWORD i = 0; i < runs[0]; i++) // 不用名称表的顺序,逐个比较
+        {
+            for (DWORD j = 0; j < count; j++)
+            {
+                if (0 == strcmp(names[j], query[i]))
+                {
+                    found[0]++;
+                    break;
+                }
+            }
+        }
+
+        secs[0] = time_now() - start;
+        start   = time_now();
+
+        for (DWORD i = 0; i < lookups; i++)
+        {
+            found[1] += (0 == pe_export_find(&image, query[i], strlen(query[i]), PE_EXPORT_NO_NAME, &syms[i]));
+        }
+
+        secs[1] = time_now() - start;
+        start   = time_now();
+
+        for (DWORD i = 0; i < lookups; i++)
+        {
+            found[2] += (0 == pe_export_find(&image, query[i], strlen(query[i]), hints[i], &syms[i]));
+        }
+
+        secs[2] = time_now() - start;
+
+        qsort(query, lookups, sizeof(char*), bench_cmp_str); // 批量查找前排序,不计时
+
+        start    = time_now();
+        found[3] = pe_export_resolve(&image, query, NULL, lookups, syms);
+        secs[3]  = time_now() - start;
+        start    = time_now();
+
+        for (DWORD i = 0; i < lookups; i++)
+        {
+            found[4] += (0 == pe_export_ordinal(&image, ords[i], &syms[i]));
+        }
+
+        secs[4] = time_now() - start;
+
+        printf("bytes:%zu functions:%u names:%u lookups:%u\n", map.size, image.export.func_count, count, lookups);
+        printf("%-8s %10s %10s %14s\n", "mode", "lookups", "found", "lookups/s");
+
+        for (int mode = 0; mode < 5; mode++)
+        {
+            printf("%-8s %10u %10u %14.0f\n", mode_name[mode], runs[mode], found[mode],
+                   runs[mode] / (secs[mode] > 0 ? secs[mode] : 1e-9));
+        }
+
+        for (int mode = 1; mode < 4; mode++)
+        {
+            if (found[mode] != lookups)
+            {
+                fprintf(stderr, "%s found %u of %u\n", mode_name[mode], found[mode], lookups);
+                ret = -4;
+            }
+        }
+    }
+
+    for (DWORD i = 0; NULL != names && i < count; i++)
+    {
+        free(names[i]);
+    }
+
+    free(names);
+    free(query);
+    free(hints);
+    free(ords);
+    free(syms);
+    pe_free(&image);
+
+    if (NULL != path)
+    {
+        file_unmap(&map);
+    }
+    else
+    {
+        free(map.data);
+    }
+
+    return ret;
+}
+
+/**
+ *\brief                        重定位数据项解码测试,比较逐项,SSE2和AVX2的实现,CPU不支持的跳过
+ *                              peinfo bench reloc [-n 轮数] [-b 块数] [-r 每块项数] [-w 32|64] [-m]
+ *                              -m 每7项中换一项为其它类型,测试逐项统计的情况
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_reloc(int argc, char **argv)
+{
+    PE_GEN     gen    = { 0, 0, 0, 0, 2048, 2046, 0, 32 };
+    int        rounds = 20;
+    int        mixed  = 0;
+    UCHAR     *data   = NULL;
+    size_t     size   = 0;
+    PE_IMAGE   image;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (0 == strcmp(argv[i], "-n") && i + 1 < argc) rounds             = atoi(argv[++i]);
+        else if (0 == strcmp(argv[i], "-b") && i + 1 < argc) gen.reloc_blocks  = (DWORD)strtoul(argv[++i], NULL, 0);
+        else if (0 == strcmp(argv[i], "-r") && i + 1 < argc) gen.reloc_entries = (DWORD)strtoul(argv[++i], NULL, 0);
+        else if (0 == strcmp(argv[i], "-w") && i + 1 < argc) gen.bits          = (DWORD)strtoul(argv[++i], NULL, 0);
+        else if (0 == strcmp(argv[i], "-m")) mixed = 1;
+        else rounds = 0;
+    }
+
+    if (rounds < 1 || 0 == gen.reloc_blocks || 0 == gen.reloc_entries || 0 != pe_gen(&gen, &data, &size))
+    {
+        fprintf(stderr, "usage: peinfo bench reloc [-n rounds] [-b blocks] [-r entries] [-w 32|64] [-m]\n");
+        return -1;
+    }
+
+    int   ret = pe_parse(&image, data, size);
+    DWORD max = 0;
+
+    for (DWORD i = 0; i < image.reloc_count; i++)
+    {
+        UCHAR *list = data + image.reloc[i].fa + sizeof(IMAGE_BASE_RELOCATION);
+
+        for (DWORD j = 6; mixed && j < image.reloc[i].count; j += 7)
+        {
+            list[j * 2 + 1] = (UCHAR)((list[j * 2 + 1] & 0x0F) | ((i + j) % PE_RELOC_TYPES) << 4);
+        }
+
+        max = (image.reloc[i].count > max) ? image.reloc[i].count : max;
+    }
+
+    WORD *offset = malloc(max * sizeof(WORD) + 1);
+    BYTE *type   = malloc(max + 1);
+
+    if (PE_OK != ret || NULL == offset || NULL == type)
+    {
+        fprintf(stderr, "parse error %d\n", ret);
+        ret = -2;
+    }
+
+    char     *name[]  = { "scalar", "sse2", "avx2" };
+    ULONGLONG base[PE_RELOC_TYPES];
+    ULONGLONG base_sum = 0;
+    double    base_secs = 0;
+
+    if (0 == ret)
+    {
+        printf("reloc bytes:%u blocks:%u entries:%llu rounds:%d auto:%s\n", image.dir[PE_DIR_RELOC].Size,
+               image.reloc_count, (unsigned long long)image.reloc_entries, rounds, pe_reloc_impl());
+        printf("%-8s %14s %10s %8s\n", "impl", "entries/s", "MB/s", "speedup");
+    }
+
+    for (int impl = PE_RELOC_SCALAR; 0 == ret && impl <= PE_RELOC_AVX2; impl++)
+    {
+        ULONGLONG hist[PE_RELOC_TYPES] = { 0 };
+        ULONGLONG sum                  = 0;
+
+        if (0 != pe_reloc_use(impl))
+        {
+            printf("%-8s %14s\n", name[impl], "unsupported");
+            continue;
+        }
+
+        double start = time_now();
+
+        for (int r = 0; r < rounds; r++)
+        {
+            for (DWORD i = 0; i < image.reloc_count; i++)
+            {
+                PPE_RELOC_BLOCK block = &image.reloc[i];
+
+                pe_reloc_decode(data + block->fa + sizeof(IMAGE_BASE_RELOCATION), block->count, offset, type, hist);
+                sum += offset[block->count - 1] + type[block->count / 2]; // 使用结果,不被优化掉
+            }
+        }
+
+        double secs = time_now() - start;
+
+        if (secs <= 0)
+        {
+            secs = 1e-9;
+        }
+
+        if (PE_RELOC_SCALAR == impl)
+        {
+            memcpy(base, hist, sizeof(base));
+            base_sum  = sum;
+            base_secs = secs;
+        }
+        else if (0 != memcmp(base, hist, sizeof(base)) || base_sum != sum)
+        {
+            fprintf(stderr, "%s result mismatch\n", name[impl]);
+            ret = -3;
+        }
+
+        printf("%-8s %14.0f %10.2f %8.2f\n", name[impl], image.reloc_entries * rounds / secs,
+               image.reloc_entries * rounds * sizeof(WORD) / secs / (1024 * 1024), base_secs / secs);
+    }
+
+    pe_reloc_use(PE_RELOC_AUTO);
+
+    if (0 == ret)
+    {
+        PE_RELOC_STAT stat;
+        ULONGLONG     pages = 0;
+        double        start = time_now();
+
+        for (int r = 0; r < rounds && 0 == ret; r++)
+        {
+            pages = 0;
+            ret   = pe_reloc_stat(&image, &stat);
+
+            for (DWORD i = 0; i < stat.page_count; i++)
+            {
+                pages += stat.page[i];
+            }
+
+            if (r + 1 < rounds)
+            {
+                pe_reloc_stat_free(&stat);
+            }
+        }
+
+        double secs = time_now() - start;
+
+        printf("%-8s %14.0f %10.2f\n", "stat", image.reloc_entries * rounds / (secs > 0 ? secs : 1e-9),
+               image.reloc_entries * rounds * sizeof(WORD) / (secs > 0 ? secs : 1e-9) / (1024 * 1024));
+        printf("fixups:%llu", (unsigned long long)pages);
+
+        for (int t = 0; t < PE_RELOC_TYPES; t++)
+        {
+            if (0 != stat.type[t])
+            {
+                printf(" type%d:%llu", t, (unsigned long long)stat.type[t]);
+            }
+        }
+
+        printf("\n");
+
+        for (int t = 0; t < PE_RELOC_TYPES; t++)
+        {
+            ret |= (stat.type[t] * rounds != base[t]); // 解码测试累加了所有轮
+        }
+
+        if (0 != ret || stat.type[PE_RELOC_ABSOLUTE] + pages != image.reloc_entries)
+        {
+            fprintf(stderr, "stat mismatch\n");
+            ret = -4;
+        }
+
+        pe_reloc_stat_free(&stat);
+    }
+
+    free(offset);
+    free(type);
+    pe_free(&image);
+    free(data);
+    return ret;
+}
+
+/**
+ *\brief                        原来的名称追加方法:先计算目标长度,再逐字节复制,每个字节都写结尾的0
+ *\param[in]    dst             目标
+ *\param[in]    size            目标缓冲区长度
+ *\param[in]    view            文件数据视图
+ *\param[in]    fa              名称在文件中的位置
+ *\return                       追加后的长度
+ */
+static size_t bench_append_byte(char *dst, size_t size, PPE_VIEW view, DWORD fa)
+{
+    size_t dst_len = strlen(dst);
+
+    if (0 == fa || fa >= view->size)
+    {
+        return dst_len;
+    }
+
+    const char *src = (const char*)view->data + fa;
+    size_t      max = view->size - fa;
+    size_t      i   = 0;
+
+    for (; i < max && dst_len + i + 1 < size && src[i] != '\0'; i++)
+    {
+        dst[dst_len + i]     = src[i];
+        dst[dst_len + i + 1] = '\0';
+    }
+
+    return dst_len + i;
+}
+
+/**
+ *\brief                        逐字节转为宽字符,对应原来的节点文本转换
+ *\param[in]    src             字符串,以0结尾
+ *\param[out]   dst             宽字符
+ *\param[in]    size            dst长度
+ *\return                       转换后的长度
+ */
+static size_t bench_widen_byte(const char *src, WORD *dst, size_t size)
+{
+    size_t len = strlen(src);
+    size_t i   = 0;
+
+    for (; i < len && i + 1 < size; i++)
+    {
+        dst[i] = (UCHAR)src[i];
+    }
+
+    dst[i] = 0;
+    return i;
+}
+
+/**
+ *\brief                        名称字符串提取测试,比较原来的逐字节追加与逐字节,SSE2和AVX2的查找实现,CPU不支持的跳过
+ *                              名称为导出名称,导入函数名称和库名称,每个名称前加上与树节点相同长度的前缀
+ *                              peinfo bench str [-n 轮数] [-e 导出函数数] [-i 导入库数] [-f 每库函数数] [file]
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_str(int argc, char **argv)
+{
+    PE_GEN     gen    = { 0, 16, 256, 65536, 0, 0, 0, 32 };
+    char      *path   = NULL;
+    int        rounds = 20;
+    FILE_MAP   map    = { 0 };
+    PE_IMAGE   image;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (0 == strcmp(argv[i], "-n") && i + 1 < argc) rounds      = atoi(argv[++i]);
+        else if (0 == strcmp(argv[i], "-e") && i + 1 < argc) gen.exports = (DWORD)strtoul(argv[++i], NULL, 0);
+        else if (0 == strcmp(argv[i], "-i") && i + 1 < argc) gen.libs    = (DWORD)strtoul(argv[++i], NULL, 0);
+        else if (0 == strcmp(argv[i], "-f") && i + 1 < argc) gen.funcs   = (DWORD)strtoul(argv[++i], NULL, 0);
+        else path = argv[i];
+    }
+
+    if (rounds < 1 || ((NULL != path) ? (0 != file_map(path, &map)) : (0 != pe_gen(&gen, &map.data, &map.size))))
+    {
+        fprintf(stderr, "usage: peinfo bench str [-n rounds] [-e exports] [-i libs] [-f funcs] [file]\n");
+        return -1;
+    }
+
+    int    ret   = pe_parse(&image, map.data, map.size);
+    size_t total = (size_t)image.export.name_count + image.lib_count + 1;
+    DWORD  count = 0;
+
+    for (DWORD i = 0; i < image.lib_count; i++)
+    {
+        total += image.lib[i].func_count;
+    }
+
+    DWORD *fa = malloc(total * sizeof(DWORD));
+
+    if (PE_ERR_MEMORY == ret || ret <= PE_ERR_UNSUPPORTED || NULL == fa)
+    {
+        fprintf(stderr, "parse error %d\n", ret);
+        ret = -2;
+    }
+    else
+    {
+        ret = 0;
+
+        for (DWORD i = 0; i < image.export.name_count; i++)
+        {
+            fa[count] = 0;
+            pe_rva_to_fa(&image, view_get32(&image.view, image.export.names_fa + i * sizeof(DWORD)), &fa[count]);
+            count += (0 != fa[count]);
+        }
+
+        for (DWORD i = 0; i < image.lib_count; i++)
+        {
+            PPE_IMPORT_LIB lib = &image.lib[i];
+
+            fa[count] = lib->name_fa;
+            count += (0 != fa[count]);
+
+            for (DWORD j = 0; j < lib->func_count; j++)
+            {
+                fa[count] = (lib->func[j].by_ordinal || 0 == lib->func[j].name_fa) ? 0 : lib->func[j].name_fa + 2;
+                count += (0 != fa[count]);
+            }
+        }
+    }
+
+    if (0 == ret && 0 == count)
+    {
+        fprintf(stderr, "no names\n");
+        ret = -3;
+    }
+
+    char      *name[]     = { "byte", "scalar", "sse2", "avx2" };
+    char       prefix[]   = "00012345 00412345 name:00012345 00412345 ";    // 与导出名称节点的前缀长度相近,都是ASCII
+    size_t     prefix_len = sizeof(prefix) - 1;
+    ULONGLONG  base_sum[2]  = { 0, 0 };
+    double     base_secs[2] = { 0, 0 };
+    int        ascii        = 1;
+
+    for (DWORD i = 0; 0 == ret && i < count; i++) // 有非ASCII名称时逐字节转换的结果不同,不比较
+    {
+        PE_STR str;
+
+        pe_str_view(&image.view, fa[i], SIZEOF(prefix) + 512, &str);
+        ascii &= (0 != (str.flags & PE_STR_ASCII));
+    }
+
+    if (0 == ret)
+    {
+        printf("bytes:%zu names:%u rounds:%d auto:%s\n", map.size, count, rounds, pe_str_impl());
+        printf("%-8s %14s %10s %8s %14s %8s\n", "impl", "append/s", "MB/s", "speedup", "widen/s", "speedup");
+    }
+
+    for (int impl = -1; 0 == ret && impl <= PE_STR_AVX2; impl++) // -1为原来的逐字节方法
+    {
+        char      txt[512];
+        WORD      txt_w[512];
+        ULONGLONG sum[2] = { 0, 0 };
+        ULONGLONG bytes  = 0;
+        double    secs[2];
+
+        if (impl >= 0 && 0 != pe_str_use(impl))
+        {
+            printf("%-8s %14s\n", name[impl + 1], "unsupported");
+            continue;
+        }
+
+        double start = time_now();
+
+        for (int r = 0; r < rounds; r++)
+        {
+            for (DWORD i = 0; i < count; i++)
+            {
+                size_t len;
+
+                memcpy(txt, prefix, prefix_len + 1);
+
+                if (impl < 0)
+                {
+                    len = bench_append_byte(txt, SIZEOF(txt), &image.view, fa[i]);
+                }
+                else
+                {
+                    len = pe_str_append(txt, prefix_len, SIZEOF(txt), &image.view, fa[i]);
+                }
+
+                bytes  += len - prefix_len;
+                sum[0] += len + (UCHAR)txt[len - 1]; // 使用结果,不被优化掉
+            }
+        }
+
+        secs[0] = time_now() - start;
+        start   = time_now();
+
+        for (int r = 0; r < rounds; r++)
+        {
+            for (DWORD i = 0; i < count; i++)
+            {
+                size_t len;
+
+                memcpy(txt, prefix, prefix_len + 1);
+                len = pe_str_append(txt, prefix_len, SIZEOF(txt), &image.view, fa[i]); // 转换前的文本不计入比较
+
+                if (impl < 0)
+                {
+                    len = bench_widen_byte(txt, txt_w, SIZEOF(txt_w));
+                }
+                else
+                {
+                    len = pe_str_widen(txt, len, txt_w, SIZEOF(txt_w));
+                }
+
+                sum[1] += len + txt_w[len - 1];
+            }
+        }
+
+        secs[1] = time_now() - start;
+
+        for (int k = 0; k < 2; k++)
+        {
+            secs[k] = (secs[k] > 0) ? secs[k] : 1e-9;
+        }
+
+        if (impl < 0)
+        {
+            memcpy(base_sum, sum, sizeof(sum));
+            memcpy(base_secs, secs, sizeof(secs));
+        }
+        else if (base_sum[0] != sum[0] || (ascii && base_sum[1] != sum[1]))
+        {
+            fprintf(stderr, "%s result mismatch\n", name[impl + 1]);
+            ret = -4;
+        }
+
+        printf("%-8s %14.0f %10.2f %8.2f %14.0f %8.2f\n", name[impl + 1], count * (double)rounds / secs[0],
+               bytes / secs[0] / (1024 * 1024), base_secs[0] / secs[0], count * (double)rounds / secs[1],
+               base_secs[1] / secs[1]);
+    }
+
+    pe_str_use(PE_STR_AUTO);
+
+    free(fa);
+    pe_free(&image);
+
+    if (NULL != path)
+    {
+        file_unmap(&map);
+    }
+    else
+    {
+        free(map.data);
+    }
+
+    return ret;
+}
+
+typedef struct _BENCH_PIPE                                                  ///  模拟管道,每次最多读出一段
+{
+    const UCHAR *data;                                                      ///< 数据
+    size_t       size;                                                      ///< 长度
+    size_t       pos;                                                       ///< 已读出的长度
+
+} BENCH_PIPE, *PBENCH_PIPE;
+
+/**
+ *\brief                        模拟管道读取回调,每次最多PE_STREAM_SKIP字节,并且复制出来
+ *\param[in]    param           BENCH_PIPE
+ *\param[out]   buff            缓冲区
+ *\param[in]    size            最多读取的字节数
+ *\return                       读到的字节数
+ */
+static size_t bench_pipe_read(void *param, void *buff, size_t size)
+{
+    PBENCH_PIPE pipe = (PBENCH_PIPE)param;
+    size_t      n    = pipe->size - pipe->pos;
+
+    n = (n < size) ? n : size;
+    n = (n < PE_STREAM_SKIP) ? n : PE_STREAM_SKIP;
+
+    memcpy(buff, pipe->data + pipe->pos, n);
+    pipe->pos += n;
+    return n;
+}
+
+/**
+ *\brief                        把文件打包成内存中的tar包
+ *\param[in]    files           文件列表
+ *\param[out]   tar             tar包,用pe_buf_free释放
+ *\return                       0-成功,其它失败
+ */
+static int bench_tar(PBENCH_LIST files, PPE_BUF tar)
+{
+    memset(tar, 0, sizeof(PE_BUF));
+
+    for (size_t i = 0; i < files->count; i++)
+    {
+        FILE_MAP map;
+
+        if (0 != file_read(files->list[i], &map))
+        {
+            continue;
+        }
+
+        size_t pad = (PE_TAR_BLOCK - map.size % PE_TAR_BLOCK) % PE_TAR_BLOCK;
+
+        if (0 != pe_buf_reserve(tar, PE_TAR_BLOCK + map.size + pad))
+        {
+            file_unmap(&map);
+            return -1;
+        }
+
+        UCHAR *head = (UCHAR*)tar->data + tar->len;
+        size_t len  = strlen(files->list[i]);
+        DWORD  sum  = 0;
+
+        memset(head, 0, PE_TAR_BLOCK);
+        memcpy(head, files->list[i] + ((len > 99) ? len - 99 : 0), (len > 99) ? 99 : len); // 只保留结尾
+        memcpy(head + 100, "0000644", 7);
+        memcpy(head + 108, "0000000", 7);
+        memcpy(head + 116, "0000000", 7);
+        snprintf((char*)head + 124, 12, "%011llo", (unsigned long long)map.size);
+        memcpy(head + 136, "00000000000", 11);
+        memset(head + 148, ' ', 8);
+        head[156] = '0';
+        memcpy(head + 257, "ustar\00000", 8);
+
+        for (int k = 0; k < PE_TAR_BLOCK; k++)
+        {
+            sum += head[k];
+        }
+
+        snprintf((char*)head + 148, 8, "%06o", sum);
+
+        memcpy(head + PE_TAR_BLOCK, map.data, map.size);
+        memset(head + PE_TAR_BLOCK + map.size, 0, pad);
+        tar->len += PE_TAR_BLOCK + map.size + pad;
+
+        file_unmap(&map);
+    }
+
+    if (0 != pe_buf_reserve(tar, PE_TAR_BLOCK * 2))
+    {
+        return -1;
+    }
+
+    memset(tar->data + tar->len, 0, PE_TAR_BLOCK * 2); // 结尾的两个0块
+    tar->len += PE_TAR_BLOCK * 2;
+    return 0;
+}
+
+/**
+ *\brief                        tar包流式读取测试,比较每个成员整个读入内存后解析与只保存需要的范围
+ *                              peinfo bench stream [-n 轮数] tar包|路径...
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_stream(int argc, char **argv)
+{
+    char      *mode_name[] = { "read", "stream" };
+    BENCH_LIST files;
+    PE_BUF     tar    = { 0 };
+    FILE_MAP   map    = { 0 };
+    PE_IMAGE   image;
+    int        rounds = 3;
+    int        first  = 1;
+    int        ret    = 0;
+
+    if (argc > 2 && 0 == strcmp(argv[1], "-n"))
+    {
+        rounds = atoi(argv[2]);
+        first  = 3;
+    }
+
+    if (rounds < 1 || 0 != bench_files(argc - first, argv + first, &files))
+    {
+        fprintf(stderr, "usage: peinfo bench stream [-n rounds] tar|path...\n");
+        return -1;
+    }
+
+    if (1 == files.count && 0 == file_read(files.list[0], &map)) // 已经是tar包时直接使用
+    {
+        if (map.size >= PE_TAR_BLOCK && pe_tar_check(map.data))
+        {
+            tar.data = (char*)map.data;
+            tar.len  = map.size;
+        }
+        else
+        {
+            file_unmap(&map);
+        }
+    }
+
+    if (NULL == tar.data && 0 != bench_tar(&files, &tar))
+    {
+        fprintf(stderr, "build tar error\n");
+        bench_files_free(&files);
+        pe_buf_free(&tar);
+        return -2;
+    }
+
+    double    best[2]   = { 1e30, 1e30 };
+    ULONGLONG window[2] = { 0, 0 };
+    ULONGLONG held[2]   = { 0, 0 };
+    ULONGLONG items[2]  = { 0, 0 };
+    ULONGLONG count     = 0;
+
+    for (int r = 0; r < rounds; r++)
+    {
+        for (int mode = 0; mode < 2; mode++)
+        {
+            BENCH_PIPE pipe = { (const UCHAR*)tar.data, tar.len, 0 };
+            PE_TAR     reader = { bench_pipe_read, &pipe };
+            double     start  = time_now();
+
+            count       = 0;
+            items[mode] = 0;
+            held[mode]  = 0;
+
+            while (1 == pe_tar_next(&reader))
+            {
+                PE_STREAM stream;
+                UCHAR    *data = NULL;
+                size_t    size = 0;
+
+                if (0 == mode) // 整个成员读入内存
+                {
+                    data = malloc((size_t)reader.size + 1);
+
+                    if (NULL == data)
+                    {
+                        ret = -3;
+                        break;
+                    }
+
+                    while (size < reader.size)
+                    {
+                        size_t n = pe_tar_read(&reader, data + size, (size_t)reader.size - size);
+
+                        if (0 == n)
+                        {
+                            break;
+                        }
+
+                        size += n;
+                    }
+
+                    held[mode] += size;
+                    window[mode] = (size > window[mode]) ? size : window[mode];
+                }
+                else
+                {
+                    if (0 != pe_stream_load(&stream, pe_tar_read, &reader, reader.size, PE_STREAM_DIRS))
+                    {
+                        ret = -3;
+                        break;
+                    }
+
+                    data = stream.data;
+                    size = pe_stream_size(&stream);
+
+                    held[mode] += stream.loaded;
+                    window[mode] = (stream.loaded > window[mode]) ? stream.loaded : window[mode];
+                }
+
+                int parsed = pe_parse(&image, data, size);
+
+                if (PE_ERR_MEMORY != parsed && parsed > PE_ERR_UNSUPPORTED)
+                {
+                    items[mode] += image.lib_count + image.export.func_count + image.reloc_entries;
+                }
+
+                pe_free(&image);
+
+                if (0 == mode)
+                {
+                    free(data);
+                }
+                else
+                {
+                    pe_stream_free(&stream);
+                }
+
+                count++;
+            }
+
+            double secs = time_now() - start;
+
+            best[mode] = (secs < best[mode]) ? secs : best[mode];
+        }
+    }
+
+    printf("members:%llu tar:%zu rounds:%d\n", (unsigned long long)count, tar.len, rounds);
+    printf("%-7s %10s %12s %12s %12s %12s\n", "mode", "time(s)", "MB/s", "window(KB)", "held(MB)", "items");
+
+    for (int mode = 0; mode < 2; mode++)
+    {
+        best[mode] = (best[mode] > 0) ? best[mode] : 1e-9;
+
+        printf("%-7s %10.4f %12.2f %12llu %12.2f %12llu\n", mode_name[mode], best[mode],
+               tar.len / best[mode] / (1024 * 1024), (unsigned long long)(window[mode] + 1023) / 1024,
+               held[mode] / (1024.0 * 1024), (unsigned long long)items[mode]);
+    }
+
+    bench_files_free(&files);
+
+    if (NULL != map.data)
+    {
+        file_unmap(&map);
+    }
+    else
+    {
+        pe_buf_free(&tar);
+    }
+
+    return ret;
+}
+
+/**
+ *\brief                        熵和摘要测试的一种方式
+ *\param[in]    data            数据
+ *\param[in]    size            长度
+ *\param[in]    mode            方式,见bench_digest中的mode_name
+ *\return                       结果,用于检查没有被优化掉
+ */
+static ULONGLONG bench_digest_run(const UCHAR *data, size_t size, int mode)
+{
+    PE_DIGEST_ITEM item;
+    ULONGLONG      sum = 0;
+
+    switch (mode)
+    {
+        case 0: // 只读一遍,内存带宽
+            for (size_t i = 0; i + 8 <= size; i += 8)
+            {
+                sum += le64(data + i);
+            }
+            return sum;
+
+        case 1:
+            pe_digest_data(data, size, PE_DIGEST_ENTROPY, &item);
+            return (ULONGLONG)(item.entropy * 1000000);
+
+        case 2:
+            return hash_xxh64(data, size, 0);
+
+        case 3:
+        case 4:
+            hash_sha256(data, size, item.sha256);
+            return le64(item.sha256);
+
+        case 5: // 每项各读一遍
+            pe_digest_data(data, size, PE_DIGEST_ENTROPY, &item);
+            sum = (ULONGLONG)(item.entropy * 1000000);
+            pe_digest_data(data, size, PE_DIGEST_SHA256, &item);
+            sum += le64(item.sha256);
+            pe_digest_data(data, size, PE_DIGEST_XXH64, &item);
+            return sum + item.xxh64;
+
+        default: // 分块一遍
+            pe_digest_data(data, size, PE_DIGEST_ALL, &item);
+            return (ULONGLONG)(item.entropy * 1000000) + le64(item.sha256) + item.xxh64;
+    }
+}
+
+/**
+ *\brief                        节的熵和摘要测试,比较各项单独计算,各读一遍和分块一遍的速度
+ *                              peinfo bench digest [-n 轮数] [-m MB] [文件...]
+ *                              没有文件时生成一半随机一半重复的数据,数据比缓存大时内存带宽为上限
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_digest(int argc, char **argv)
+{
+    char      *mode_name[] = { "read", "entropy", "xxh64", "sha256", "sha256", "3-pass", "1-pass" };
+    BENCH_LIST files       = { 0 };
+    size_t     size        = 64 * 1024 * 1024;
+    UCHAR     *data        = NULL;
+    int        rounds      = 5;
+    int        first       = 1;
+    int        ret         = 0;
+
+    for (; first < argc; first++)
+    {
+        if      (0 == strcmp(argv[first], "-n") && first + 1 < argc) rounds = atoi(argv[++first]);
+        else if (0 == strcmp(argv[first], "-m") && first + 1 < argc) size   = (size_t)strtoul(argv[++first], NULL, 0) * 1024 * 1024;
+        else break;
+    }
+
+    if (rounds < 1 || 0 == size || (first < argc && 0 != bench_files(argc - first, argv + first, &files)))
+    {
+        fprintf(stderr, "usage: peinfo bench digest [-n rounds] [-m MB] [file...]\n");
+        return -1;
+    }
+
+    if (files.count > 0) // 所有文件连在一起
+    {
+        size = 0;
+
+        for (size_t i = 0; i < files.count; i++)
+        {
+            ULONGLONG len = 0;
+            ULONGLONG mtime;
+
+            size += (0 == file_stat(files.list[i], &len, &mtime, NULL)) ? (size_t)len : 0;
+        }
+    }
+
+    data = malloc(size + 1);
+
+    if (NULL == data)
+    {
+        bench_files_free(&files);
+        return -2;
+    }
+
+    if (files.count > 0)
+    {
+        size_t pos = 0;
+
+        for (size_t i = 0; i < files.count; i++)
+        {
+            FILE_MAP map;
+
+            if (0 == file_read(files.list[i], &map))
+            {
+                size_t n = (map.size < size - pos) ? map.size : size - pos;
+
+                memcpy(data + pos, map.data, n);
+                pos += n;
+                file_unmap(&map);
+            }
+        }
+
+        size = pos;
+    }
+    else
+    {
+        ULONGLONG x = 0x9E3779B97F4A7C15ULL;
+
+        for (size_t i = 0; i < size; i++) // 前一半xorshift随机,后一半短的重复模式
+        {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            data[i] = (i < size / 2) ? (UCHAR)x : (UCHAR)(i % 61);
+        }
+    }
+
+    printf("digest bytes:%zu rounds:%d sha256:%s\n", size, rounds, hash_sha256_impl());
+    printf("%-8s %-8s %10s %10s %8s\n", "mode", "impl", "time(s)", "GB/s", "of-read");
+
+    double read_secs = 0;
+
+    for (int mode = 0; mode < (int)SIZEOF(mode_name); mode++)
+    {
+        const char *impl = "";
+
+        if (3 == mode || 4 == mode)
+        {
+            impl = (3 == mode) ? "scalar" : "sha-ni";
+
+            if (0 != hash_sha256_use((3 == mode) ? SIMD_SCALAR : SIMD_SHA))
+            {
+                printf("%-8s %-8s %10s\n", mode_name[mode], impl, "unsupported");
+                continue;
+            }
+        }
+        else if (mode >= 5)
+        {
+            hash_sha256_use(SIMD_AUTO);
+            impl = hash_sha256_impl();
+        }
+
+        double    best = 1e30;
+        ULONGLONG sum  = 0;
+
+        for (int r = 0; r < rounds; r++)
+        {
+            double start = time_now();
+
+            sum += bench_digest_run(data, size, mode);
+
+            double secs = time_now() - start;
+
+            best = (secs < best) ? secs : best;
+        }
+
+        best = (best > 0) ? best : 1e-9;
+
+        if (0 == mode)
+        {
+            read_secs = best;
+        }
+
+        printf("%-8s %-8s %10.4f %10.2f %8.2f%s\n", mode_name[mode], impl, best,
+               size / best / (1024.0 * 1024 * 1024), read_secs / best, (0 == sum) ? " ?" : "");
+    }
+
+    hash_sha256_use(SIMD_AUTO);
+
+    free(data);
+    bench_files_free(&files);
+    return ret;
+}
+
+/**
+ *\brief                        先拼接整个导入字符串再计算MD5的导入表散列,用于对比,按序号导入时不查表
+ *\param[in]    image           解析结果
+ *\param[in]    buf             拼接缓冲区
+ *\param[out]   md5             散列
+ *\return                       0-成功,其它失败
+ */
+static int bench_finger_concat(PPE_IMAGE image, PPE_BUF buf, UCHAR md5[HASH_MD5_SIZE])
+{
+    char part[PE_FINGER_NAME_MAX * 2 + 32];
+
+    buf->len = 0;
+
+    for (DWORD i = 0; i < image->lib_static; i++)
+    {
+        PPE_IMPORT_LIB lib = &image->lib[i];
+        size_t         len = 0;
+        const char    *dll = view_strn(&image->view, lib->name_fa, PE_FINGER_NAME_MAX, &len);
+        const char    *dot = memchr(dll, '.', len);
+
+        len = (NULL != dot) ? (size_t)(dot - dll) : len;
+
+        for (DWORD j = 0; j < lib->func_count; j++)
+        {
+            PPE_IMPORT_FUNC func = &lib->func[j];
+            size_t          name_len = 0;
+            const char     *name = view_strn(&image->view, func->name_fa ? func->name_fa + 2 : 0, PE_FINGER_NAME_MAX, &name_len);
+            int             n;
+
+            if (func->by_ordinal)
+            {
+                n = snprintf(part, sizeof(part), "%s%.*s.ord%u", buf->len ? "," : "", (int)len, dll, func->ordinal);
+            }
+            else
+            {
+                n = snprintf(part, sizeof(part), "%s%.*s.%.*s", buf->len ? "," : "", (int)len, dll, (int)name_len, name);
+            }
+
+            if (0 != pe_buf_reserve(buf, n))
+            {
+                return -1;
+            }
+
+            for (int k = 0; k < n; k++)
+            {
+                buf->data[buf->len++] = (char)tolower((UCHAR)part[k]);
+            }
+        }
+    }
+
+    hash_md5(buf->data, buf->len, md5);
+    return 0;
+}
+
+/**
+ *\brief                        导入表散列和Rich头测试,文件先读入内存,比较只解析,解析后计算指纹,
+ *                              和先拼接字符串再计算MD5的速度,估算20万个文件的耗时
+ *                              peinfo bench finger [-n 轮数] 路径...
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_finger(int argc, char **argv)
+{
+    char      *mode_name[] = { "parse", "imphash", "rich", "finger", "concat" };
+    BENCH_LIST files;
+    FILE_MAP  *map    = NULL;
+    PE_ARENA   pool   = { 0 };
+    PE_BUF     buf    = { 0 };
+    int        rounds = 5;
+    int        first  = 1;
+    int        ret    = 0;
+
+    if (argc > 2 && 0 == strcmp(argv[1], "-n"))
+    {
+        rounds = atoi(argv[2]);
+        first  = 3;
+    }
+
+    if (rounds < 1 || 0 != bench_files(argc - first, argv + first, &files))
+    {
+        fprintf(stderr, "usage: peinfo bench finger [-n rounds] path...\n");
+        return -1;
+    }
+
+    map = calloc(files.count, sizeof(FILE_MAP));
+
+    if (NULL == map)
+    {
+        bench_files_free(&files);
+        return -2;
+    }
+
+    for (size_t i = 0; i < files.count; i++) // 不计读文件的时间
+    {
+        if (0 != file_read(files.list[i], &map[i]))
+        {
+            memset(&map[i], 0, sizeof(FILE_MAP));
+        }
+    }
+
+    printf("finger files:%zu rounds:%d\n", files.count, rounds);
+    printf("%-8s %10s %12s %10s %10s %10s\n", "mode", "time(s)", "files/s", "us/file", "200k(s)", "found");
+
+    for (int mode = 0; mode < (int)SIZEOF(mode_name) && 0 == ret; mode++)
+    {
+        double    best  = 1e30;
+        ULONGLONG found = 0;
+
+        for (int r = 0; r < rounds && 0 == ret; r++)
+        {
+            double start = time_now();
+
+            found = 0;
+
+            for (size_t i = 0; i < files.count; i++)
+            {
+                PE_IMAGE image;
+                UCHAR    md5[HASH_MD5_SIZE];
+
+                if (NULL == map[i].data)
+                {
+                    continue;
+                }
+
+                int parsed = pe_parse_pool(&image, map[i].data, map[i].size, &pool, NULL);
+
+                if (PE_ERR_MEMORY == parsed || (parsed < 0 && parsed >= PE_ERR_UNSUPPORTED)) // 没有解析结果
+                {
+                    pe_free(&image);
+                    continue;
+                }
+
+                if (1 == mode || 2 == mode || 3 == mode)
+                {
+                    DWORD flags = (1 == mode) ? PE_FINGER_IMPHASH : (2 == mode) ? PE_FINGER_RICH : PE_FINGER_ALL;
+
+                    if (0 != pe_finger(&image, flags))
+                    {
+                        ret = -3;
+                    }
+                    else
+                    {
+                        found += image.finger->imphash + image.finger->rich;
+                    }
+                }
+                else if (4 == mode)
+                {
+                    ret   = bench_finger_concat(&image, &buf, md5);
+                    found += (image.lib_count > 0);
+                }
+
+                pe_free(&image);
+            }
+
+            double secs = time_now() - start;
+
+            best = (secs < best) ? secs : best;
+        }
+
+        best = (best > 0) ? best : 1e-9;
+
+        printf("%-8s %10.4f %12.0f %10.2f %10.2f %10llu\n", mode_name[mode], best, files.count / best,
+               best * 1e6 / files.count, best / files.count * 200000, (unsigned long long)found);
+    }
+
+    for (size_t i = 0; i < files.count; i++)
+    {
+        file_unmap(&map[i]);
+    }
+
+    free(map);
+    pe_buf_free(&buf);
+    pe_arena_free(&pool);
+    bench_files_free(&files);
+    return ret;
+}
+
+/**
+ *\brief                        分阶段计时开销测试,文件先读入内存,比较线程没有绑定统计和绑定统计时的解析速度,
+ *                              定义PE_STAT_OFF编译时两种都没有计时代码,与不定义时的off比较得到判断指针的开销
+ *                              peinfo bench stat [-n 轮数] 路径...
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_stat(int argc, char **argv)
+{
+    char      *mode_name[] = { "off", "on" };
+    BENCH_LIST files;
+    FILE_MAP  *map    = NULL;
+    PE_ARENA   pool   = { 0 };
+    PE_STAT    stat   = { 0 };
+    int        rounds = 5;
+    int        first  = 1;
+
+    if (argc > 2 && 0 == strcmp(argv[1], "-n"))
+    {
+        rounds = atoi(argv[2]);
+        first  = 3;
+    }
+
+    if (rounds < 1 || 0 != bench_files(argc - first, argv + first, &files))
+    {
+        fprintf(stderr, "usage: peinfo bench stat [-n rounds] path...\n");
+        return -1;
+    }
+
+    map = calloc(files.count, sizeof(FILE_MAP));
+
+    if (NULL == map)
+    {
+        bench_files_free(&files);
+        return -2;
+    }
+
+    for (size_t i = 0; i < files.count; i++) // 不计读文件的时间
+    {
+        if (0 != file_read(files.list[i], &map[i]))
+        {
+            memset(&map[i], 0, sizeof(FILE_MAP));
+        }
+    }
+
+#ifdef PE_STAT_OFF
+    printf("stat files:%zu rounds:%d compiled out\n", files.count, rounds);
+#else
+    printf("stat files:%zu rounds:%d\n", files.count, rounds);
+#endif
+    printf("%-8s %10s %12s %10s\n", "mode", "time(s)", "files/s", "us/file");
+
+    for (int mode = 0; mode < (int)SIZEOF(mode_name); mode++)
+    {
+        double best = 1e30;
+
+        pe_stat_bind((1 == mode) ? &stat : NULL);
+
+        for (int r = 0; r < rounds; r++)
+        {
+            double start = time_now();
+
+            for (size_t i = 0; i < files.count; i++)
+            {
+                PE_IMAGE image;
+
+                if (NULL != map[i].data)
+                {
+                    pe_parse_pool(&image, map[i].data, map[i].size, &pool, NULL);
+                    pe_free(&image);
+                }
+            }
+
+            double secs = time_now() - start;
+
+            best = (secs < best) ? secs : best;
+        }
+
+        best = (best > 0) ? best : 1e-9;
+
+        printf("%-8s %10.4f %12.0f %10.3f\n", mode_name[mode], best, files.count / best, best * 1e6 / files.count);
+    }
+
+    pe_stat_bind(NULL);
+    printf("\n");
+    pe_stat_print(stdout, &stat);
+
+    for (size_t i = 0; i < files.count; i++)
+    {
+        file_unmap(&map[i]);
+    }
+
+    free(map);
+    pe_arena_free(&pool);
+    bench_files_free(&files);
+    return 0;
+}
+
+/**
+ *\brief                        遍历资源的回调函数,计数并累加数据长度
+ *\param[in]    param           ULONGLONG[2],数据项数和数据长度
+ *\param[in]    type            类型层的目录项
+ *\param[in]    name            名称层的目录项
+ *\param[in]    lang            语言层的目录项
+ *\param[in]    data            数据项
+ *\return                       无
+ */
+static void bench_rsrc_proc(void *param, PPE_RSRC_ENTRY type, PPE_RSRC_ENTRY name, PPE_RSRC_ENTRY lang, PPE_RSRC_DATA data)
+{
+    ((ULONGLONG*)param)[0]++;
+    ((ULONGLONG*)param)[1] += data->avail;
+}
+
+/**
+ *\brief                        资源表测试,文件先读入内存,比较遍历全部数据项,立即插入整个资源树,
+ *                              首次显示只插入资源表节点,和只取版本信息与清单的速度
+ *                              peinfo bench rsrc [-n 轮数] [-c 图标资源数] [文件...]
+ *                              没有文件时生成资源很多的合成PE文件
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_rsrc(int argc, char **argv)
+{
+    char      *mode_name[] = { "walk", "eager", "first", "version" };
+    PE_GEN     gen         = { 0, 4, 64, 256, 16, 256, 0, 64, 2000 };
+    BENCH_LIST files       = { 0 };
+    FILE_MAP  *map         = NULL;
+    PE_ARENA   pool        = { 0 };
+    size_t     count       = 1;
+    int        rounds      = 5;
+    int        first       = 1;
+    int        ret         = 0;
+
+    for (; first < argc; first++)
+    {
+        if      (0 == strcmp(argv[first], "-n") && first + 1 < argc) rounds        = atoi(argv[++first]);
+        else if (0 == strcmp(argv[first], "-c") && first + 1 < argc) gen.resources = (DWORD)strtoul(argv[++first], NULL, 0);
+        else break;
+    }
+
+    if (rounds < 1 || (first < argc && 0 != bench_files(argc - first, argv + first, &files)))
+    {
+        fprintf(stderr, "usage: peinfo bench rsrc [-n rounds] [-c icons] [file...]\n");
+        return -1;
+    }
+
+    count = (files.count > 0) ? files.count : 1;
+    map   = calloc(count, sizeof(FILE_MAP));
+
+    if (NULL == map)
+    {
+        bench_files_free(&files);
+        return -2;
+    }
+
+    for (size_t i = 0; i < files.count; i++) // 不计读文件的时间
+    {
+        if (0 != file_read(files.list[i], &map[i]))
+        {
+            memset(&map[i], 0, sizeof(FILE_MAP));
+        }
+    }
+
+    if (0 == files.count && 0 != pe_gen(&gen, &map[0].data, &map[0].size))
+    {
+        fprintf(stderr, "gen error\n");
+        free(map);
+        return -3;
+    }
+
+    printf("rsrc files:%zu rounds:%d%s\n", count, rounds, (0 == files.count) ? " generated" : "");
+    printf("%-8s %10s %12s %10s %12s\n", "mode", "time(s)", "files/s", "us/file", "items");
+
+    for (int mode = 0; mode < (int)SIZEOF(mode_name) && 0 == ret; mode++)
+    {
+        double    best  = 1e30;
+        ULONGLONG items = 0;
+
+        for (int r = 0; r < rounds && 0 == ret; r++)
+        {
+            ULONGLONG  walk[2] = { 0, 0 };
+            BENCH_LAZY lazy    = { 0 };
+            PE_TREE    eager   = { bench_insert, &items, NULL };
+            PE_TREE    tree    = { bench_insert, &lazy, bench_lazy_insert };
+            double     secs    = 0;
+
+            items = 0;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                PE_IMAGE image;
+                PE_RSRC  rsrc;
+
+                if (NULL == map[i].data)
+                {
+                    continue;
+                }
+
+                int parsed = pe_parse_pool(&image, map[i].data, map[i].size, &pool, NULL);
+
+                if (PE_ERR_MEMORY == parsed || (parsed < 0 && parsed >= PE_ERR_UNSUPPORTED)) // 没有解析结果
+                {
+                    pe_free(&image);
+                    continue;
+                }
+
+                double start = time_now(); // 只计资源部分
+
+                switch (mode)
+                {
+                case 0:
+                    if (0 == pe_rsrc_root(&image, &rsrc))
+                    {
+                        pe_rsrc_walk(&image, &rsrc, bench_rsrc_proc, walk);
+                    }
+                    break;
+                case 1:  insert_rsrc_table(&eager, &image); break;
+                case 2:  insert_rsrc_table(&tree, &image);  break;
+                default:
+                    if (0 != pe_version(&image, PE_VERSION_ALL))
+                    {
+                        ret = -4;
+                    }
+                    else
+                    {
+                        items += image.version->info + image.version->manifest;
+                    }
+                    break;
+                }
+
+                secs += time_now() - start;
+                pe_free(&image);
+            }
+
+            items = (0 == mode) ? walk[0] : (2 == mode) ? lazy.items : items;
+            best  = (secs < best) ? secs : best;
+            free(lazy.lazy);
+        }
+
+        best = (best > 0) ? best : 1e-9;
+
+        printf("%-8s %10.4f %12.0f %10.2f %12llu\n", mode_name[mode], best, count / best,
+               best * 1e6 / count, (unsigned long long)items);
+    }
+
+    for (size_t i = 0; i < files.count; i++)
+    {
+        file_unmap(&map[i]);
+    }
+
+    if (0 == files.count)
+    {
+        free(map[0].data);
+    }
+
+    free(map);
+    pe_arena_free(&pool);
+    bench_files_free(&files);
+    return ret;
+}
+
+/**
+ *\brief                        导入表测试,文件先读入内存,比较解析和立即插入导入表,延迟导入表和绑定导入表树的速度.
+ *                              没有文件时生成函数数量相同的两个合成PE文件,一个只有导入表,一个只有延迟导入表
+ *                              peinfo bench import [-n 轮数] [-i 库数] [-f 每库函数数] [文件...]
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_import(int argc, char **argv)
+{
+    char      *mode_name[] = { "parse", "tree" };
+    char      *set_name[]  = { "static", "delay" };
+    PE_GEN     gen[2]      = { { 0, 256, 64, 0, 0, 0, 0, 64 }, { 0, 0, 64, 0, 0, 0, 0, 64 } };
+    BENCH_LIST files       = { 0 };
+    FILE_MAP  *map         = NULL;
+    PE_ARENA   pool        = { 0 };
+    size_t     count       = 2;
+    int        rounds      = 5;
+    int        first       = 1;
+    int        ret         = 0;
+
+    for (; first < argc; first++)
+    {
+        if      (0 == strcmp(argv[first], "-n") && first + 1 < argc) rounds      = atoi(argv[++first]);
+        else if (0 == strcmp(argv[first], "-i") && first + 1 < argc) gen[0].libs = (DWORD)strtoul(argv[++first], NULL, 0);
+        else if (0 == strcmp(argv[first], "-f") && first + 1 < argc) gen[0].funcs = (DWORD)strtoul(argv[++first], NULL, 0);
+        else break;
+    }
+
+    if (rounds < 1 || (first < argc && 0 != bench_files(argc - first, argv + first, &files)))
+    {
+        fprintf(stderr, "usage: peinfo bench import [-n rounds] [-i libs] [-f funcs] [file...]\n");
+        return -1;
+    }
+
+    gen[1].delays = gen[0].libs;
+    gen[1].funcs  = gen[0].funcs;
+    count         = (files.count > 0) ? files.count : 2;
+    map           = calloc(count, sizeof(FILE_MAP));
+
+    if (NULL == map)
+    {
+        bench_files_free(&files);
+        return -2;
+    }
+
+    for (size_t i = 0; i < files.count; i++) // 不计读文件的时间
+    {
+        if (0 != file_read(files.list[i], &map[i]))
+        {
+            memset(&map[i], 0, sizeof(FILE_MAP));
+        }
+    }
+
+    for (size_t i = 0; 0 == files.count && i < 2; i++)
+    {
+        if (0 != pe_gen(&gen[i], &map[i].data, &map[i].size))
+        {
+            fprintf(stderr, "gen error\n");
+            ret = -3;
+        }
+    }
+
+    printf("import files:%zu rounds:%d%s\n", count, rounds, (0 == files.count) ? " generated" : "");
+    printf("%-8s %-8s %10s %12s %12s %12s\n", "set", "mode", "time(s)", "funcs", "funcs/s", "us/file");
+
+    // 生成的文件各算一组,比较同样数量的函数在导入表和延迟导入表中的速度;指定文件时所有文件算一组
+    for (size_t set = 0; set < ((0 == files.count) ? 2 : 1) && 0 == ret; set++)
+    {
+        size_t begin = (0 == files.count) ? set : 0;
+        size_t end   = (0 == files.count) ? set + 1 : files.count;
+
+        for (int mode = 0; mode < (int)SIZEOF(mode_name); mode++)
+        {
+            double    best  = 1e30;
+            ULONGLONG funcs = 0;
+
+            for (int r = 0; r < rounds; r++)
+            {
+                ULONGLONG items = 0;
+                PE_TREE   eager = { bench_insert, &items, NULL };
+                double    secs  = 0;
+
+                funcs = 0;
+
+                for (size_t i = begin; i < end; i++)
+                {
+                    PE_IMAGE image;
+
+                    if (NULL == map[i].data)
+                    {
+                        continue;
+                    }
+
+                    double start  = time_now();
+                    int    parsed = pe_parse_pool(&image, map[i].data, map[i].size, &pool, NULL);
+
+                    if (1 == mode)
+                    {
+                        start = time_now(); // 只计树的部分
+
+                        if (PE_ERR_MEMORY != parsed && !(parsed < 0 && parsed >= PE_ERR_UNSUPPORTED))
+                        {
+                            insert_import_table(&eager, &image);
+                            insert_delay_table(&eager, &image);
+                            insert_bound_table(&eager, &image);
+                        }
+                    }
+
+                    secs += time_now() - start;
+
+                    for (DWORD j = 0; j < image.lib_count; j++)
+                    {
+                        funcs += image.lib[j].func_count;
+                    }
+
+                    pe_free(&image);
+                }
+
+                best = (secs < best) ? secs : best;
+            }
+
+            best = (best > 0) ? best : 1e-9;
+
+            printf("%-8s %-8s %10.4f %12llu %12.0f %12.2f\n", (0 == files.count) ? set_name[set] : "files",
+                   mode_name[mode], best, (unsigned long long)funcs, funcs / best, best * 1e6 / (end - begin));
+        }
+    }
+
+    for (size_t i = 0; i < files.count; i++)
+    {
+        file_unmap(&map[i]);
+    }
+
+    for (size_t i = 0; 0 == files.count && i < 2; i++)
+    {
+        free(map[i].data);
+    }
+
+    free(map);
+    pe_arena_free(&pool);
+    bench_files_free(&files);
+    return ret;
+}
+
+/**
+ *\brief                        符号键测试,比较整个文件读入内存,内存映射后完整解析再解码调试目录,
+ *                              与只按位置读入头部和调试记录的速度和读入的字节数,页缓存是热的
+ *                              peinfo bench debug [-n 轮数] 路径...
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_debug(int argc, char **argv)
+{
+    char      *mode_name[] = { "read", "map", "key" };
+    char       key[PE_DEBUG_KEY_MAX];
+    BENCH_LIST files       = { 0 };
+    PE_ARENA   pool        = { 0 };
+    int        rounds      = 3;
+    int        first       = 1;
+
+    for (; first < argc; first++)
+    {
+        if (0 == strcmp(argv[first], "-n") && first + 1 < argc) rounds = atoi(argv[++first]);
+        else break;
+    }
+
+    if (rounds < 1 || first >= argc || 0 != bench_files(argc - first, argv + first, &files))
+    {
+        fprintf(stderr, "usage: peinfo bench debug [-n rounds] path...\n");
+        bench_files_free(&files);
+        return -1;
+    }
+
+    printf("debug files:%zu rounds:%d\n", files.count, rounds);
+    printf("%-8s %10s %12s %10s %12s %10s %8s\n", "mode", "time(s)", "files/s", "us/file", "bytes", "KB/file", "keys");
+
+    for (int mode = 0; mode < (int)SIZEOF(mode_name); mode++)
+    {
+        double    best  = 1e30;
+        ULONGLONG bytes = 0;
+        ULONGLONG keys  = 0;
+
+        for (int r = 0; r < rounds; r++)
+        {
+            double start = time_now();
+
+            bytes = 0;
+            keys  = 0;
+
+            for (size_t i = 0; i < files.count; i++)
+            {
+                PE_DEBUG_FILE file;
+                PE_IMAGE      image;
+                FILE_MAP      map;
+                int           parsed;
+
+                if (2 == mode)
+                {
+                    parsed = pe_debug_open(&image, files.list[i], &pool, PE_DEBUG_CODEVIEW, &file);
+                    bytes += file.loaded;
+                }
+                else
+                {
+                    if (0 != ((0 == mode) ? file_read(files.list[i], &map) : file_map(files.list[i], &map)))
+                    {
+                        continue;
+                    }
+
+                    parsed = pe_parse_pool(&image, map.data, map.size, &pool, NULL);
+                    bytes += map.size;
+
+                    if (PE_ERR_MEMORY != parsed && !(parsed < 0 && parsed >= PE_ERR_UNSUPPORTED))
+                    {
+                        pe_debug(&image, PE_DEBUG_CODEVIEW);
+                    }
+                }
+
+                keys += (1 != parsed && NULL != image.debug && 0 != pe_debug_key(&image, key, sizeof(key)));
+
+                pe_free(&image);
+
+                if (2 == mode)
+                {
+                    pe_debug_close(&file);
+                }
+                else
+                {
+                    file_unmap(&map);
+                }
+            }
+
+            double secs = time_now() - start;
+
+            best = (secs < best) ? secs : best;
+        }
+
+        best = (best > 0) ? best : 1e-9;
+
+        printf("%-8s %10.4f %12.0f %10.2f %12llu %10.1f %8llu\n", mode_name[mode], best, files.count / best,
+               best * 1e6 / files.count, (unsigned long long)bytes, bytes / 1024.0 / files.count, (unsigned long long)keys);
+    }
+
+    pe_arena_free(&pool);
+    bench_files_free(&files);
+    return 0;
+}
+
+/**
+ *\brief                        Authenticode摘要测试,比较整个文件读入内存,内存映射后在解析结果上散列,
+ *                              与读线程按块读入,调用线程同时散列的流水线的速度,页缓存是热的.
+ *                              没有指定文件时在临时目录生成一个有证书表的大文件
+ *                              peinfo bench auth [-n 轮数] [-b 块KB] [-q 块数] [-m MB] [-d 临时目录] [文件...]
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+static int bench_auth(int argc, char **argv)
+{
+    char       *mode_name[] = { "read", "map", "pipe" };
+    BENCH_LIST  files       = { 0 };
+    PE_ARENA    pool        = { 0 };
+    const char *dir         = ".";
+    char       *path        = NULL;
+    size_t      block       = PE_AUTH_BLOCK;
+    DWORD       depth       = PE_AUTH_DEPTH;
+    DWORD       mb          = 64;
+    int         rounds      = 3;
+    int         first       = 1;
+    int         ret         = 0;
+
+    for (; first < argc; first++)
+    {
+        if      (0 == strcmp(argv[first], "-n") && first + 1 < argc) rounds = atoi(argv[++first]);
+        else if (0 == strcmp(argv[first], "-b") && first + 1 < argc) block  = (size_t)strtoul(argv[++first], NULL, 0) * 1024;
+        else if (0 == strcmp(argv[first], "-q") && first + 1 < argc) depth  = (DWORD)strtoul(argv[++first], NULL, 0);
+        else if (0 == strcmp(argv[first], "-m") && first + 1 < argc) mb     = (DWORD)strtoul(argv[++first], NULL, 0);
+        else if (0 == strcmp(argv[first], "-d") && first + 1 < argc) dir    = argv[++first];
+        else break;
+    }
+
+    if (rounds < 1 || 0 == block || 0 == depth || 0 == mb || mb > 2047
+     || (first < argc && 0 != bench_files(argc - first, argv + first, &files)))
+    {
+        fprintf(stderr, "usage: peinfo bench auth [-n rounds] [-b KB] [-q depth] [-m MB] [-d tmpdir] [file...]\n");
+        bench_files_free(&files);
+        return -1;
+    }
+
+    if (0 == files.count) // 生成的文件写到磁盘,流水线按路径读
+    {
+        PE_GEN gen  = { 0, 4, 16, 64, 16, 64, 0, 32 };
+        UCHAR *data = NULL;
+        size_t size = 0;
+
+        gen.pad  = mb * 1024 * 1024;
+        gen.sign = 1;
+        path     = malloc(strlen(dir) + 32);
+
+        if (NULL == path || 0 != pe_gen(&gen, &data, &size))
+        {
+            fprintf(stderr, "gen error\n");
+            free(path);
+            return -2;
+        }
+
+        sprintf(path, "%s%cpeinfo_auth.tmp", dir, PATH_SEP);
+
+        FILE *fp = file_open(path, "wb");
+
+        if (NULL == fp || size != fwrite(data, 1, size, fp))
+        {
+            ret = -3;
+        }
+
+        if (NULL != fp && 0 != fclose(fp))
+        {
+            ret = -3;
+        }
+
+        free(data);
+
+        if (0 != ret || NULL == (files.list = malloc(sizeof(char*))))
+        {
+            fprintf(stderr, "write %s error\n", path);
+            remove(path);
+            free(path);
+            return -3;
+        }
+
+        files.list[0] = path;
+        files.count   = 1;
+        files.cap     = 1;
+    }
+
+    printf("auth files:%zu rounds:%d block:%zuKB depth:%u%s\n", files.count, rounds, block / 1024, depth,
+           (NULL != path) ? " generated" : "");
+    printf("%-8s %10s %10s %12s %8s %8s %8s\n", "mode", "time(s)", "GB/s", "bytes", "signed", "match", "piped");
+
+    for (int mode = 0; mode < (int)SIZEOF(mode_name); mode++)
+    {
+        double    best  = 1e30;
+        ULONGLONG bytes = 0;
+        ULONGLONG sign  = 0;
+        ULONGLONG match = 0;
+        ULONGLONG piped = 0;
+
+        for (int r = 0; r < rounds; r++)
+        {
+            double start = time_now();
+
+            bytes = sign = match = piped = 0;
+
+            for (size_t i = 0; i < files.count; i++)
+            {
+                PE_IMAGE image;
+                FILE_MAP map;
+
+                if (0 != ((0 == mode) ? file_read(files.list[i], &map) : file_map(files.list[i], &map)))
+                {
+                    continue;
+                }
+
+                int parsed = pe_parse_pool(&image, map.data, map.size, &pool, NULL);
+
+                if (PE_ERR_MEMORY != parsed && !(parsed < 0 && parsed >= PE_ERR_UNSUPPORTED))
+                {
+                    if (2 == mode) // 只解码证书表,散列时按路径读
+                    {
+                        if (0 == pe_auth(&image, PE_AUTH_CERT))
+                        {
+                            pe_auth_file(&image, files.list[i], block, depth);
+                        }
+                    }
+                    else
+                    {
+                        pe_auth(&image, PE_AUTH_ALL);
+                    }
+                }
+
+                if (NULL != image.auth)
+                {
+                    bytes += image.auth->bytes;
+                    sign  += image.auth->pkcs7;
+                    match += image.auth->match;
+                    piped += image.auth->pipe;
+                }
+
+                pe_free(&image);
+                file_unmap(&map);
+            }
+
+            double secs = time_now() - start;
+
+            best = (secs < best) ? secs : best;
+        }
+
+        best = (best > 0) ? best : 1e-9;
+
+        printf("%-8s %10.4f %10.3f %12llu %8llu %8llu %8llu\n", mode_name[mode], best, bytes / best / 1e9,
+               (unsigned long long)bytes, (unsigned long long)sign, (unsigned long long)match, (unsigned long long)piped);
+    }
+
+    if (NULL != path)
+    {
+        remove(path);
+    }
+
+    pe_arena_free(&pool);
+    bench_files_free(&files);
+    return ret;
+}
+
+static BENCH_ITEM g_bench[] = {
+    { "load",   bench_load,     "[-n rounds] path...   比较整个文件读入内存与内存映射" },
+    { "lazy",   bench_lazy,     "[-n rounds] [-b blocks] [-r entries] [file]   比较立即插入全部节点与延迟子树首次显示" },
+    { "rva",    bench_rva,      "[-n lookups] [-s sections]   比较节的线性查找与索引查找" },
+    { "fuzz",   bench_fuzz,     "[-n rounds] [-m mutants] [-s seed] path...   正常文件与变异文件的解析速度" },
+    { "emit",   bench_emit,     "[-n rounds] [-w 32|64] [file]   JSON Lines和二进制记录的输出速度" },
+    { "export", bench_export,   "[-n lookups] [-e exports] [file]   导出函数按名称和序号查找的速度" },
+    { "reloc",  bench_reloc,    "[-n rounds] [-b blocks] [-r entries] [-w 32|64] [-m]   重定位数据项解码的速度" },
+    { "str",    bench_str,      "[-n rounds] [-e exports] [-i libs] [-f funcs] [file]   名称字符串追加和宽字符转换的速度" },
+    { "stream", bench_stream,   "[-n rounds] tar|path...   tar包成员整个读入与流式读取需要的范围" },
+    { "digest", bench_digest,   "[-n rounds] [-m MB] [file...]   节的熵和摘要,各项单独,各读一遍与分块一遍的速度" },
+    { "finger", bench_finger,   "[-n rounds] path...   导入表散列和Rich头,边生成边散列与先拼接字符串的速度" },
+    { "stat",   bench_stat,     "[-n rounds] path...   分阶段计时关闭和打开时的解析速度" },
+    { "rsrc",   bench_rsrc,     "[-n rounds] [-c icons] [file...]   资源树遍历,立即插入,首次显示和只取版本信息的速度" },
+    { "import", bench_import,   "[-n rounds] [-i libs] [-f funcs] [file...]   导入表与延迟导入表的解析和立即插入树的速度" },
+    { "debug",  bench_debug,    "[-n rounds] path...   完整解析后解码调试目录与只按位置读入符号键需要的部分的速度" },
+    { "auth",   bench_auth,     "[-n rounds] [-b KB] [-q depth] [-m MB] [-d tmpdir] [file...]   "
+                                "Authenticode摘要,读入内存,内存映射与读线程和散列重叠的流水线的速度" },
+    { "suite",  bench_suite,    "[-n rounds] [-c case,...] [-d tmpdir] [-o result] [-b baseline] [-t percent] [-a us]   "
+                                "合成PE文件各部分的解析,树,记录和整个扫描,与基准比较" }
+};
+
+int bench_main(int argc, char **argv)
+{
+    if (argc >= 2)
+    {
+        for (int i = 0; i < SIZEOF(g_bench); i++)
+        {
+            if (0 == strcmp(argv[1], g_bench[i].name))
+            {
+                return g_bench[i].proc(argc - 1, argv + 1);
+            }
+        }
+    }
+
+    fprintf(stderr, "usage: peinfo bench <item> [args]\n");
+
+    for (int i = 0; i < SIZEOF(g_bench); i++)
+    {
+        fprintf(stderr, "  %-8s %s\n", g_bench[i].name, g_bench[i].help);
+    }
+
+    return -1;
+}
@@ -0,0 +1,23 @@
+/**
+ *\file     bench.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    性能测试接口定义
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+/**
+ *\brief                        性能测试命令,按第1个参数分派测试项
+ *                              peinfo bench <测试项> [参数]
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数,argv[0]为命令名
+ *\return                       0-成功,其它失败
+ */
+int bench_main(int argc, char **argv);
+
+#endif
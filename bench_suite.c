@@ -0,0 +1,923 @@
+/**
+ *\file     bench_suite.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    性能回归测试集实现
+ *          每个用例生成一个合成PE文件,各项用同一份数据计时,每轮依次执行所有项目,每项取重复执行的平均值,
+ *          多轮取中位数,各轮与中位数之差的中位数(MAD)作为这一项的波动.
+ *          解析的各部分用分阶段计时得到,编译时定义PE_STAT_OFF时只有解析的总时间.
+ *          结果每行一个JSON对象: 用例行记下合成参数,计时行为{"case","metric","us","mad"},
+ *          基准用同样的格式,按用例和项目名称比较,变慢的微秒数不超过-a和两次波动较大者的SUITE_SPREAD倍时不算.
+ *          计时前检查流式读取(与scan -x -v相同的数据目录)和映射文件的JSON记录及版本信息相同,不同时用例失败
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加资源很多的用例和资源表,版本信息项目
+ *          2026.10.18|多轮取中位数,绝对阈值按每项的波动放大,减少误报
+ *          2026.10.18|用例参数用指定成员的初始化
+ *          2026.10.18|检查流式读取与映射文件的版本信息和记录相同
+ *          2026.10.18|增加只有延迟导入的用例
+ */
+#include "bench_suite.h"
+#include "pe_tree.h"
+#include "pe_emit.h"
+#include "pe_stat.h"
+#include "pe_rsrc.h"
+#include "pe_stream.h"
+#include "gen.h"
+
+typedef struct _SUITE_CASE                                                  ///  测试用例
+{
+    const char *name;                                                       ///< 名称,后面加位宽
+    PE_GEN      gen;                                                        ///< 合成参数,bits按位宽填写
+
+} SUITE_CASE, *PSUITE_CASE;
+
+typedef struct _SUITE_RUN                                                   ///  一个用例的运行数据
+{
+    char        name[64];                                                   ///< 用例名称,含位宽
+    const char *path;                                                       ///< 写到磁盘的文件,整个扫描时读取
+    UCHAR      *data;                                                       ///< 文件数据
+    size_t      size;                                                       ///< 文件长度
+    PE_IMAGE    image;                                                      ///< 解析一次的结果,树和记录使用
+    PE_ARENA    pool;                                                       ///< 解析内存池
+    PE_INTERN   intern;                                                     ///< 名称驻留表,JSON记录使用
+    PE_BUF      buf;                                                        ///< 记录缓冲区
+    PE_STAT     stat;                                                       ///< 解析各部分的计时
+    ULONGLONG   text;                                                       ///< 树节点文本长度,避免被优化掉
+    int         failed;                                                     ///< 1-执行出错
+
+} SUITE_RUN, *PSUITE_RUN;
+
+typedef void (*suite_proc)(PSUITE_RUN run);                                 ///< 计时的操作
+
+typedef struct _SUITE_METRIC                                                ///  计时项目
+{
+    const char *name;                                                       ///< 名称
+    suite_proc  proc;                                                       ///< 操作
+
+} SUITE_METRIC, *PSUITE_METRIC;
+
+typedef struct _SUITE_RESULT                                                ///  一项结果,也用于基准
+{
+    char        name[SUITE_LINE];                                           ///< "用例/项目"
+    double      us;                                                         ///< 每次的微秒数,各轮的中位数
+    double      mad;                                                        ///< 各轮与中位数之差的中位数,微秒,旧的基准中没有时为0
+
+} SUITE_RESULT, *PSUITE_RESULT;
+
+typedef struct _SUITE_LIST                                                  ///  结果列表
+{
+    PSUITE_RESULT list;                                                     ///< 结果
+    size_t      count;                                                      ///< 数量
+    size_t      cap;                                                        ///< 容量
+
+} SUITE_LIST, *PSUITE_LIST;
+
+typedef struct _SUITE_PIPE                                                  ///  模拟管道,从内存读取
+{
+    const UCHAR *data;                                                      ///< 数据
+    size_t       size;                                                      ///< 长度
+    size_t       pos;                                                       ///< 已读出的长度
+
+} SUITE_PIPE, *PSUITE_PIPE;
+
+/// 用例,覆盖每种表很大的情况,bits按位宽填写,没有写的参数为0
+static SUITE_CASE g_suite_case[] = {
+    { "tiny",      { .sections = 0,    .libs = 1,   .funcs = 4,   .exports = 0,     .reloc_blocks = 1,    .reloc_entries = 4,   .pad = 0,                .resources = 0    } },
+    { "typical",   { .sections = 4,    .libs = 16,  .funcs = 64,  .exports = 512,   .reloc_blocks = 64,   .reloc_entries = 256, .pad = 256 * 1024,       .resources = 0    } },
+    { "sections",  { .sections = 8192, .libs = 1,   .funcs = 4,   .exports = 0,     .reloc_blocks = 1,    .reloc_entries = 4,   .pad = 0,                .resources = 0    } },
+    { "imports",   { .sections = 0,    .libs = 256, .funcs = 512, .exports = 0,     .reloc_blocks = 1,    .reloc_entries = 4,   .pad = 0,                .resources = 0    } },
+    { "exports",   { .sections = 0,    .libs = 1,   .funcs = 4,   .exports = 65536, .reloc_blocks = 1,    .reloc_entries = 4,   .pad = 0,                .resources = 0    } },
+    { "relocs",    { .sections = 0,    .libs = 1,   .funcs = 4,   .exports = 0,     .reloc_blocks = 1024, .reloc_entries = 512, .pad = 0,                .resources = 0    } },
+    { "resources", { .sections = 0,    .libs = 1,   .funcs = 4,   .exports = 0,     .reloc_blocks = 1,    .reloc_entries = 4,   .pad = 0,                .resources = 8192 } },
+    { "delays",    { .sections = 0,    .libs = 0,   .funcs = 512, .exports = 0,     .reloc_blocks = 1,    .reloc_entries = 4,   .pad = 0,                .delays = 256     } },
+    { "large",     { .sections = 4,    .libs = 16,  .funcs = 64,  .exports = 512,   .reloc_blocks = 64,   .reloc_entries = 256, .pad = 64 * 1024 * 1024, .resources = 0    } },
+};
+
+
+/**
+ *\brief                        插入树节点回调,累计文本长度
+ *\param[in]    param           运行数据
+ *\param[in]    parent          父节点句柄
+ *\param[in]    txt             节点文本
+ *\return                       新节点句柄
+ */
+static PE_NODE suite_insert(void *param, PE_NODE parent, const char *txt)
+{
+    ((PSUITE_RUN)param)->text += strlen(txt) + 1;
+    return (PE_NODE)1;
+}
+
+/**
+ *\brief                        解析,不计各部分
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_parse(PSUITE_RUN run)
+{
+    PE_IMAGE image;
+
+    pe_parse_pool(&image, run->data, run->size, &run->pool, NULL);
+    pe_free(&image);
+}
+
+#ifndef PE_STAT_OFF
+/**
+ *\brief                        解析,各部分计入run->stat
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_parse_stat(PSUITE_RUN run)
+{
+    pe_stat_bind(&run->stat);
+    suite_parse(run);
+    pe_stat_bind(NULL);
+}
+#endif
+
+/**
+ *\brief                        输出DOS头和NT头的树,延迟子树全部展开
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_tree_head(PSUITE_RUN run)
+{
+    PE_TREE tree = { suite_insert, run, NULL };
+    insert_dosnt_head(&tree, &run->image);
+}
+
+/**
+ *\brief                        输出节表的树,延迟子树全部展开
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_tree_section(PSUITE_RUN run)
+{
+    PE_TREE tree = { suite_insert, run, NULL };
+    insert_section_head(&tree, &run->image);
+}
+
+/**
+ *\brief                        输出导出表的树,延迟子树全部展开
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_tree_export(PSUITE_RUN run)
+{
+    PE_TREE tree = { suite_insert, run, NULL };
+    insert_export_table(&tree, &run->image);
+}
+
+/**
+ *\brief                        输出导入表的树,延迟子树全部展开
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_tree_import(PSUITE_RUN run)
+{
+    PE_TREE tree = { suite_insert, run, NULL };
+    insert_import_table(&tree, &run->image);
+}
+
+/**
+ *\brief                        输出重定位表的树,延迟子树全部展开
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_tree_reloc(PSUITE_RUN run)
+{
+    PE_TREE tree = { suite_insert, run, NULL };
+    insert_reloc_table(&tree, &run->image);
+}
+
+/**
+ *\brief                        输出资源表的树,延迟子树全部展开
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_tree_rsrc(PSUITE_RUN run)
+{
+    PE_TREE tree = { suite_insert, run, NULL };
+    insert_rsrc_table(&tree, &run->image);
+}
+
+/**
+ *\brief                        解析并取版本信息和清单,版本信息从解析结果的内存池分配,所以每次重新解析
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_version(PSUITE_RUN run)
+{
+    PE_IMAGE image;
+
+    pe_parse_pool(&image, run->data, run->size, &run->pool, NULL);
+
+    if (0 != pe_version(&image, PE_VERSION_ALL))
+    {
+        run->failed = 1;
+    }
+
+    pe_free(&image);
+}
+
+/**
+ *\brief                        JSON记录,缓冲区重复使用
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_json(PSUITE_RUN run)
+{
+    run->buf.len = 0;
+
+    if (0 != pe_emit(&run->buf, PE_EMIT_JSON, "ok", &run->image, run->size, run->name))
+    {
+        run->failed = 1;
+    }
+}
+
+/**
+ *\brief                        整个扫描,与scan -o json相同: 映射文件,解析并驻留名称,输出记录
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_scan_json(PSUITE_RUN run)
+{
+    FILE_MAP map;
+    PE_IMAGE image;
+
+    if (0 != file_map(run->path, &map))
+    {
+        run->failed = 1;
+        return;
+    }
+
+    run->buf.len = 0;
+
+    pe_parse_pool(&image, map.data, map.size, &run->pool, &run->intern);
+
+    if (0 != pe_emit(&run->buf, PE_EMIT_JSON, "ok", &image, map.size, run->path))
+    {
+        run->failed = 1;
+    }
+
+    pe_free(&image);
+    file_unmap(&map);
+}
+
+/**
+ *\brief                        整个扫描,与scan -t相同: 映射文件,解析,输出整个树
+ *\param[in]    run             运行数据
+ *\return                       无
+ */
+static void suite_scan_tree(PSUITE_RUN run)
+{
+    PE_TREE  tree = { suite_insert, run, NULL };
+    FILE_MAP map;
+    PE_IMAGE image;
+
+    if (0 != file_map(run->path, &map))
+    {
+        run->failed = 1;
+        return;
+    }
+
+    pe_parse_pool(&image, map.data, map.size, &run->pool, NULL);
+    pe_insert_tree(&tree, &image);
+    pe_free(&image);
+    file_unmap(&map);
+}
+
+static SUITE_METRIC g_suite_metric[] = {
+    { "parse",        suite_parse        },
+    { "tree_head",    suite_tree_head    },
+    { "tree_section", suite_tree_section },
+    { "tree_export",  suite_tree_export  },
+    { "tree_import",  suite_tree_import  },
+    { "tree_reloc",   suite_tree_reloc   },
+    { "tree_rsrc",    suite_tree_rsrc    },
+    { "version",      suite_version      },
+    { "json",         suite_json         },
+    { "scan_json",    suite_scan_json    },
+    { "scan_tree",    suite_scan_tree    },
+};
+
+/**
+ *\brief                        从小到大排序,轮数不多,用插入排序
+ *\param[in,out] v              数据
+ *\param[in]    n               个数
+ *\return                       无
+ */
+static void suite_sort(double *v, int n)
+{
+    for (int i = 1; i < n; i++)
+    {
+        double x = v[i];
+        int    j = i;
+
+        for (; j > 0 && v[j - 1] > x; j--)
+        {
+            v[j] = v[j - 1];
+        }
+
+        v[j] = x;
+    }
+}
+
+/**
+ *\brief                        取中位数和中位数绝对偏差,v被改写
+ *\param[in,out] v              各轮的值
+ *\param[in]    n               轮数
+ *\param[out]   mad             各轮与中位数之差的中位数
+ *\return                       中位数
+ */
+static double suite_median(double *v, int n, double *mad)
+{
+    suite_sort(v, n);
+
+    double median = (n & 1) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+
+    for (int i = 0; i < n; i++)
+    {
+        v[i] = (v[i] > median) ? v[i] - median : median - v[i];
+    }
+
+    suite_sort(v, n);
+    *mad = (n & 1) ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+    return median;
+}
+
+/**
+ *\brief                        先执行一次,得到每轮至少SUITE_MIN_TIME的重复次数
+ *\param[in]    run             运行数据
+ *\param[in]    proc            操作
+ *\return                       每轮重复次数
+ */
+static DWORD suite_reps(PSUITE_RUN run, suite_proc proc)
+{
+    double t = time_now();
+
+    proc(run);
+    t = time_now() - t;
+
+    return (t < SUITE_MIN_TIME) ? (DWORD)(SUITE_MIN_TIME / ((t > 1e-9) ? t : 1e-9)) + 1 : 1;
+}
+
+/**
+ *\brief                        计时一轮
+ *\param[in]    run             运行数据
+ *\param[in]    proc            操作
+ *\param[in]    reps            重复次数
+ *\return                       每次的秒数
+ */
+static double suite_round(PSUITE_RUN run, suite_proc proc, DWORD reps)
+{
+    double start = time_now();
+
+    for (DWORD i = 0; i < reps; i++)
+    {
+        proc(run);
+    }
+
+    return (time_now() - start) / reps;
+}
+
+/**
+ *\brief                        追加一项结果
+ *\param[in]    results         结果列表
+ *\param[in]    name            "用例/项目"
+ *\param[in]    us              每次的微秒数
+ *\param[in]    mad             波动,微秒
+ *\return                       0-成功,其它失败
+ */
+static int suite_add(PSUITE_LIST results, const char *name, double us, double mad)
+{
+    if (results->count == results->cap)
+    {
+        size_t        cap  = results->cap ? results->cap * 2 : 256;
+        PSUITE_RESULT list = realloc(results->list, cap * sizeof(SUITE_RESULT));
+
+        if (NULL == list)
+        {
+            return -1;
+        }
+
+        results->list = list;
+        results->cap  = cap;
+    }
+
+    snprintf(results->list[results->count].name, SUITE_LINE, "%s", name);
+    results->list[results->count].us  = us;
+    results->list[results->count].mad = mad;
+    results->count++;
+    return 0;
+}
+
+/**
+ *\brief                        取结果行中字符串字段的值,值中没有引号和转义
+ *\param[in]    line            结果行
+ *\param[in]    key             字段名,带引号和冒号
+ *\param[out]   value           值
+ *\param[in]    size            value的长度
+ *\return                       0-成功,其它没有该字段
+ */
+static int suite_field(const char *line, const char *key, char *value, size_t size)
+{
+    const char *p = strstr(line, key);
+
+    if (NULL == p || '"' != p[strlen(key)])
+    {
+        return -1;
+    }
+
+    p += strlen(key) + 1;
+
+    size_t len = strcspn(p, "\"");
+
+    if ('"' != p[len] || len >= size)
+    {
+        return -2;
+    }
+
+    memcpy(value, p, len);
+    value[len] = '\0';
+    return 0;
+}
+
+/**
+ *\brief                        读取基准文件,只取计时行
+ *\param[in]    path            基准文件
+ *\param[out]   base            基准,用完释放list
+ *\return                       0-成功,其它失败
+ */
+static int suite_load(const char *path, PSUITE_LIST base)
+{
+    FILE *fp = file_open(path, "rb");
+    char  line[SUITE_LINE];
+
+    if (NULL == fp)
+    {
+        return -1;
+    }
+
+    while (NULL != fgets(line, sizeof(line), fp))
+    {
+        char        name[SUITE_LINE];
+        char        metric[64];
+        const char *us  = strstr(line, "\"us\":");
+        const char *mad = strstr(line, "\"mad\":");
+
+        if (NULL == us || 0 != suite_field(line, "\"case\":", name, 128) ||
+            0 != suite_field(line, "\"metric\":", metric, sizeof(metric)))
+        {
+            continue; // 用例行和其它行
+        }
+
+        strcat(name, "/");
+        strcat(name, metric);
+
+        if (0 != suite_add(base, name, strtod(us + 5, NULL), (NULL != mad) ? strtod(mad + 6, NULL) : 0))
+        {
+            fclose(fp);
+            return -2;
+        }
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+/**
+ *\brief                        与基准比较,按结果的顺序输出,运行了全部用例时基准中有而结果中没有的项也输出
+ *                              每项的绝对阈值为noise和两次波动较大者的SUITE_SPREAD倍中较大的一个
+ *\param[in]    results         本次结果
+ *\param[in]    base            基准
+ *\param[in]    all             1-运行了全部用例
+ *\param[in]    tolerance       变慢阈值,百分比
+ *\param[in]    noise           最小的绝对阈值,微秒
+ *\return                       变慢的项数
+ */
+static int suite_compare(PSUITE_LIST results, PSUITE_LIST base, int all, double tolerance, double noise)
+{
+    int slower = 0;
+    int faster = 0;
+
+    printf("\n%-28s %12s %12s %8s %10s\n", "case/metric", "base(us)", "now(us)", "change", "noise(us)");
+
+    for (size_t i = 0; i < results->count; i++)
+    {
+        PSUITE_RESULT now = &results->list[i];
+        PSUITE_RESULT old = NULL;
+
+        for (size_t j = 0; j < base->count && NULL == old; j++) // 项数只有几百,直接查找
+        {
+            old = (0 == strcmp(base->list[j].name, now->name)) ? &base->list[j] : NULL;
+        }
+
+        if (NULL == old)
+        {
+            printf("%-28s %12s %12.3f %8s new\n", now->name, "-", now->us, "-");
+            continue;
+        }
+
+        double change = (old->us > 0) ? (now->us - old->us) * 100 / old->us : 0;
+        double spread = SUITE_SPREAD * ((now->mad > old->mad) ? now->mad : old->mad);
+        double limit  = (spread > noise) ? spread : noise;
+        char  *flag   = "";
+
+        if (change > tolerance && now->us - old->us > limit)
+        {
+            flag = "SLOWER";
+            slower++;
+        }
+        else if (change < -tolerance && old->us - now->us > limit)
+        {
+            flag = "faster";
+            faster++;
+        }
+
+        printf("%-28s %12.3f %12.3f %+7.1f%% %10.3f %s\n", now->name, old->us, now->us, change, limit, flag);
+    }
+
+    for (size_t j = 0; j < base->count && all; j++)
+    {
+        int found = 0;
+
+        for (size_t i = 0; i < results->count && !found; i++)
+        {
+            found = (0 == strcmp(base->list[j].name, results->list[i].name));
+        }
+
+        if (!found)
+        {
+            printf("%-28s %12.3f %12s %8s missing\n", base->list[j].name, base->list[j].us, "-", "-");
+        }
+    }
+
+    printf("compared:%zu slower:%d faster:%d tolerance:%.1f%% noise:%.2fus\n",
+           results->count, slower, faster, tolerance, noise);
+    return slower;
+}
+
+/**
+ *\brief                        判断用例是否选中
+ *\param[in]    names           逗号分隔的用例名称,可以带位宽,NULL为全部
+ *\param[in]    name            用例名称
+ *\param[in]    full            带位宽的用例名称
+ *\return                       1-选中,0-没有选中
+ */
+static int suite_selected(const char *names, const char *name, const char *full)
+{
+    while (NULL != names && *names)
+    {
+        size_t len = strcspn(names, ",");
+
+        if ((len == strlen(name) && 0 == memcmp(names, name, len)) ||
+            (len == strlen(full) && 0 == memcmp(names, full, len)))
+        {
+            return 1;
+        }
+
+        names += len + (',' == names[len]);
+    }
+
+    return NULL == names;
+}
+
+/**
+ *\brief                        模拟管道读取回调,每次最多PE_STREAM_SKIP字节
+ *\param[in]    param           SUITE_PIPE
+ *\param[out]   buff            缓冲区
+ *\param[in]    size            最多读取的字节数
+ *\return                       读到的字节数
+ */
+static size_t suite_pipe_read(void *param, void *buff, size_t size)
+{
+    PSUITE_PIPE pipe = (PSUITE_PIPE)param;
+    size_t      n    = pipe->size - pipe->pos;
+
+    n = (n < size) ? n : size;
+    n = (n < PE_STREAM_SKIP) ? n : PE_STREAM_SKIP;
+
+    memcpy(buff, pipe->data + pipe->pos, n);
+    pipe->pos += n;
+    return n;
+}
+
+/**
+ *\brief                        解析,取版本信息和清单并输出JSON记录
+ *\param[in]    run             运行数据
+ *\param[in]    data            文件数据
+ *\param[in]    size            数据长度
+ *\param[out]   buf             记录
+ *\return                       0-成功,其它失败
+ */
+static int suite_version_json(PSUITE_RUN run, UCHAR *data, size_t size, PPE_BUF buf)
+{
+    PE_IMAGE image;
+    int      ret = 0;
+
+    pe_parse_pool(&image, data, size, NULL, &run->intern);
+
+    if (0 != pe_version(&image, PE_VERSION_ALL) || 0 != pe_emit(buf, PE_EMIT_JSON, "ok", &image, run->size, run->name))
+    {
+        ret = -1;
+    }
+
+    pe_free(&image);
+    return ret;
+}
+
+/**
+ *\brief                        检查流式读取与映射文件的JSON记录和版本信息相同,数据目录与scan -x -v相同
+ *\param[in]    run             运行数据
+ *\return                       0-相同,其它不同或失败
+ */
+static int suite_stream_check(PSUITE_RUN run)
+{
+    SUITE_PIPE pipe   = { run->data, run->size, 0 };
+    PE_BUF     buf    = { 0 };
+    PE_STREAM  stream;
+
+    if (0 != pe_stream_load(&stream, suite_pipe_read, &pipe, run->size, PE_STREAM_DIRS | PE_STREAM_RSRC))
+    {
+        return -1;
+    }
+
+    run->buf.len = 0;
+
+    int ret = suite_version_json(run, run->data, run->size, &run->buf) |
+              suite_version_json(run, stream.data, pe_stream_size(&stream), &buf);
+
+    if (0 == ret && (buf.len != run->buf.len || 0 != memcmp(buf.data, run->buf.data, buf.len)))
+    {
+        ret = -2;
+    }
+
+    pe_buf_free(&buf);
+    pe_stream_free(&stream);
+    return ret;
+}
+
+/**
+ *\brief                        运行一个用例,结果写入列表和结果文件
+ *\param[in]    run             运行数据,name,data,size,path已填写
+ *\param[in]    rounds          轮数
+ *\param[in]    results         结果列表
+ *\param[in]    out             结果文件,可以为NULL
+ *\return                       0-成功,其它失败
+ */
+static int suite_run(PSUITE_RUN run, int rounds, PSUITE_LIST results, FILE *out)
+{
+    char  name[SUITE_LINE];
+    DWORD parse_reps = 1;
+    int   ret        = pe_parse_pool(&run->image, run->data, run->size, NULL, &run->intern); // 不用内存池,计时时会重置
+
+    if (PE_OK != ret)
+    {
+        fprintf(stderr, "%s parse error %d\n", run->name, ret);
+        pe_free(&run->image);
+        return -1;
+    }
+
+    if (0 != suite_stream_check(run))
+    {
+        fprintf(stderr, "%s stream result differs from mapped file\n", run->name);
+        pe_free(&run->image);
+        return -2;
+    }
+
+    ULONGLONG funcs = 0;
+
+    for (DWORD i = 0; i < run->image.lib_count; i++)
+    {
+        funcs += run->image.lib[i].func_count;
+    }
+
+    if (NULL != out)
+    {
+        fprintf(out, "{\"case\":\"%s\",\"bits\":%u,\"bytes\":%zu,\"sections\":%d,\"libs\":%u,\"imports\":%llu,"
+                     "\"exports\":%u,\"reloc_blocks\":%u,\"relocs\":%llu}\n",
+                run->name, (PE_MAGIC_64 == run->image.magic) ? 64 : 32, run->size, run->image.section_count,
+                run->image.lib_count, (unsigned long long)funcs, run->image.export.func_count,
+                run->image.reloc_count, (unsigned long long)run->image.reloc_entries);
+    }
+
+    DWORD  reps[SIZEOF(g_suite_metric)];
+    double secs[SIZEOF(g_suite_metric)][SUITE_ROUNDS_MAX];
+#ifndef PE_STAT_OFF
+    double stage_secs[PE_STAT_STAGES][SUITE_ROUNDS_MAX];
+#endif
+
+    for (size_t m = 0; m < SIZEOF(g_suite_metric); m++)
+    {
+        reps[m]    = suite_reps(run, g_suite_metric[m].proc);
+        parse_reps = (suite_parse == g_suite_metric[m].proc) ? reps[m] : parse_reps;
+    }
+
+    // 每轮依次执行所有项目,机器在运行期间变慢时各项的多轮都受影响,计入波动而不是只偏移其中几项
+    for (int r = 0; r < rounds && !run->failed; r++)
+    {
+        for (size_t m = 0; m < SIZEOF(g_suite_metric); m++)
+        {
+            secs[m][r] = suite_round(run, g_suite_metric[m].proc, reps[m]);
+        }
+
+#ifndef PE_STAT_OFF
+        // 解析的各部分,每轮单独计数
+        memset(&run->stat, 0, sizeof(run->stat));
+
+        for (DWORD i = 0; i < parse_reps; i++) // 与解析的总时间相同的重复次数
+        {
+            suite_parse_stat(run);
+        }
+
+        for (int s = PE_STAT_HEAD; s <= PE_STAT_RELOC; s++)
+        {
+            PPE_STAT_STAGE stage = &run->stat.stage[s];
+
+            stage_secs[s][r] = (stage->calls > 0) ? stage->wall / stage->calls : 0;
+        }
+#endif
+    }
+
+    ret = run->failed ? -2 : 0;
+
+    for (size_t m = 0; m < SIZEOF(g_suite_metric) && 0 == ret; m++)
+    {
+        double mad    = 0;
+        double median = suite_median(secs[m], rounds, &mad);
+
+        snprintf(name, sizeof(name), "%s/%s", run->name, g_suite_metric[m].name);
+        printf("%-28s %12.3f %10.3f %10u\n", name, median * 1e6, mad * 1e6, reps[m]);
+
+        if (NULL != out)
+        {
+            fprintf(out, "{\"case\":\"%s\",\"metric\":\"%s\",\"us\":%.3f,\"mad\":%.3f,\"reps\":%u}\n",
+                    run->name, g_suite_metric[m].name, median * 1e6, mad * 1e6, reps[m]);
+        }
+
+        ret = suite_add(results, name, median * 1e6, mad * 1e6);
+    }
+
+#ifndef PE_STAT_OFF
+    for (int s = PE_STAT_HEAD; s <= PE_STAT_RELOC && 0 == ret; s++)
+    {
+        double mad    = 0;
+        double median = suite_median(stage_secs[s], rounds, &mad);
+
+        snprintf(name, sizeof(name), "%s/parse_%s", run->name, pe_stat_name(s));
+        printf("%-28s %12.3f %10.3f %10u\n", name, median * 1e6, mad * 1e6, parse_reps);
+
+        if (NULL != out)
+        {
+            fprintf(out, "{\"case\":\"%s\",\"metric\":\"parse_%s\",\"us\":%.3f,\"mad\":%.3f,\"reps\":%u}\n",
+                    run->name, pe_stat_name(s), median * 1e6, mad * 1e6, parse_reps);
+        }
+
+        ret = suite_add(results, name, median * 1e6, mad * 1e6);
+    }
+#endif
+
+    pe_free(&run->image);
+    return ret;
+}
+
+int bench_suite(int argc, char **argv)
+{
+    SUITE_LIST  results   = { 0 };
+    SUITE_LIST  base      = { 0 };
+    const char *cases     = NULL;
+    const char *dir       = ".";
+    const char *out_path  = NULL;
+    const char *base_path = NULL;
+    double      tolerance = SUITE_TOLERANCE;
+    double      noise     = SUITE_NOISE;
+    int         rounds    = SUITE_ROUNDS;
+    int         ret       = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if      (0 == strcmp(argv[i], "-n") && i + 1 < argc) rounds    = atoi(argv[++i]);
+        else if (0 == strcmp(argv[i], "-c") && i + 1 < argc) cases     = argv[++i];
+        else if (0 == strcmp(argv[i], "-d") && i + 1 < argc) dir       = argv[++i];
+        else if (0 == strcmp(argv[i], "-o") && i + 1 < argc) out_path  = argv[++i];
+        else if (0 == strcmp(argv[i], "-b") && i + 1 < argc) base_path = argv[++i];
+        else if (0 == strcmp(argv[i], "-t") && i + 1 < argc) tolerance = atof(argv[++i]);
+        else if (0 == strcmp(argv[i], "-a") && i + 1 < argc) noise     = atof(argv[++i]);
+        else rounds = 0;
+    }
+
+    if (rounds < 1 || rounds > SUITE_ROUNDS_MAX)
+    {
+        fprintf(stderr, "usage: peinfo bench suite [-n rounds] [-c case,...] [-d tmpdir] [-o result] [-b baseline] "
+                        "[-t percent] [-a us]\n");
+        return -1;
+    }
+
+    if (NULL != base_path && 0 != suite_load(base_path, &base)) // 先读基准,结果可以覆盖基准文件
+    {
+        fprintf(stderr, "read baseline %s error\n", base_path);
+        return -2;
+    }
+
+    FILE *out  = (NULL != out_path) ? file_open(out_path, "wb") : NULL;
+    char *path = malloc(strlen(dir) + 32);
+
+    if ((NULL != out_path && NULL == out) || NULL == path)
+    {
+        fprintf(stderr, "open %s error\n", (NULL != out_path) ? out_path : "result");
+
+        if (NULL != out)
+        {
+            fclose(out);
+        }
+
+        free(path);
+        free(base.list);
+        return -3;
+    }
+
+    sprintf(path, "%s%cpeinfo_suite.tmp", dir, PATH_SEP);
+
+    if (NULL != out)
+    {
+        fprintf(out, "{\"suite\":\"peinfo\",\"version\":1,\"rounds\":%d,\"stat\":%d}\n", rounds,
+#ifndef PE_STAT_OFF
+                1
+#else
+                0
+#endif
+                );
+    }
+
+    printf("%-28s %12s %10s %10s\n", "case/metric", "us", "mad", "reps");
+
+    for (size_t c = 0; c < SIZEOF(g_suite_case) && 0 == ret; c++)
+    {
+        for (DWORD bits = 32; bits <= 64 && 0 == ret; bits += 32)
+        {
+            SUITE_RUN run = { 0 };
+            PE_GEN    gen = g_suite_case[c].gen;
+
+            snprintf(run.name, sizeof(run.name), "%s-%u", g_suite_case[c].name, bits);
+
+            if (!suite_selected(cases, g_suite_case[c].name, run.name))
+            {
+                continue;
+            }
+
+            gen.bits = bits;
+            run.path = path;
+
+            if (0 != pe_gen(&gen, &run.data, &run.size))
+            {
+                fprintf(stderr, "%s gen error\n", run.name);
+                ret = -4;
+                break;
+            }
+
+            FILE *fp = file_open(path, "wb"); // 整个扫描从磁盘读取
+
+            if (NULL == fp || run.size != fwrite(run.data, 1, run.size, fp))
+            {
+                fprintf(stderr, "write %s error\n", path);
+                ret = -5;
+            }
+
+            if (NULL != fp && 0 != fclose(fp))
+            {
+                ret = -5;
+            }
+
+            if (0 == ret && 0 != suite_run(&run, rounds, &results, out))
+            {
+                fprintf(stderr, "%s run error\n", run.name);
+                ret = -6;
+            }
+
+            remove(path);
+            free(run.data);
+            pe_arena_free(&run.pool);
+            pe_intern_free(&run.intern);
+            pe_buf_free(&run.buf);
+        }
+    }
+
+    if (NULL != out && 0 != fclose(out) && 0 == ret)
+    {
+        fprintf(stderr, "write %s error\n", out_path);
+        ret = -7;
+    }
+
+    if (0 == ret && NULL != base_path)
+    {
+        ret = (suite_compare(&results, &base, NULL == cases, tolerance, noise) > 0) ? 1 : 0;
+    }
+
+    free(path);
+    free(results.list);
+    free(base.list);
+    return ret;
+}
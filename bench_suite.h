@@ -0,0 +1,35 @@
+/**
+ *\file     bench_suite.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    性能回归测试集接口定义
+ *          用合成PE文件覆盖各种表的大小(节很多,导入很多,导出很多,重定位很多,文件很大),
+ *          PE32和PE32+各一份,分别计时解析的各部分,树的各部分,JSON记录和从文件开始的整个扫描,
+ *          结果写成JSON Lines,与保存的基准比较,变慢超过阈值时返回非0
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|默认轮数增加,取中位数,绝对阈值按每项的波动放大
+ */
+#ifndef _BENCH_SUITE_H_
+#define _BENCH_SUITE_H_
+
+#define SUITE_MIN_TIME          0.002                                       ///< 一次计时至少的秒数,不够时重复执行
+#define SUITE_TOLERANCE         10.0                                        ///< 默认的变慢阈值,百分比
+#define SUITE_NOISE             0.5                                         ///< 默认的绝对阈值,变慢不超过这么多微秒时不算
+#define SUITE_ROUNDS            15                                          ///< 默认的轮数
+#define SUITE_ROUNDS_MAX        255                                         ///< 最多的轮数
+#define SUITE_SPREAD            4.0                                         ///< 每项的绝对阈值至少为波动(中位数绝对偏差)的倍数
+#define SUITE_LINE              512                                         ///< 结果文件一行的最大长度
+
+/**
+ *\brief                        性能回归测试集
+ *                              peinfo bench suite [-n 轮数] [-c 用例,...] [-d 临时目录] [-o 结果] [-b 基准] [-t 百分比] [-a 微秒]
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数,argv[0]为测试项名称
+ *\return                       0-成功,1-有变慢的项,<0-失败
+ */
+int bench_suite(int argc, char **argv);
+
+#endif
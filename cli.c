@@ -0,0 +1,96 @@
+/**
+ *\file     cli.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    命令行模式实现
+ *          Linux下只有命令行模式: gcc -O2 -o peinfo *.c -lpthread
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|scan增加-o输出格式
+ *          2026.10.18|增加导入符号索引命令
+ *          2026.10.18|scan增加-c结果缓存
+ *          2026.10.18|scan增加-s树的分段节点数
+ *          2026.10.18|scan增加-x流式读取
+ *          2026.10.18|scan增加-d节的熵和摘要
+ *          2026.10.18|scan增加-f导入表散列和Rich头,-g按指纹分组
+ *          2026.10.18|scan增加-m分阶段计时和计数
+ *          2026.10.18|scan增加-v版本信息和清单
+ *          2026.10.18|gen帮助增加-c和-d
+ *          2026.10.18|scan增加-p调试目录,-k只取符号键,gen帮助增加-g
+ *          2026.10.18|scan增加-a检查签名的摘要,gen帮助增加-a
+ *          2026.10.18|启动线程前选择重定位解码的实现
+ *          2026.10.18|启动线程前选择名称字符串的实现
+ *          2026.10.18|启动线程前选择SHA-256的实现
+ */
+#include "platform.h"
+#include "cli.h"
+#include "scan.h"
+#include "bench.h"
+#include "gen.h"
+#include "pe_index.h"
+#include "pe_reloc.h"
+#include "pe_str.h"
+#include "hash.h"
+
+typedef int (*cli_proc)(int argc, char **argv);                             ///< 子命令函数
+
+typedef struct _CLI_CMD                                                     ///  子命令
+{
+    char     *name;                                                         ///< 命令名称
+    cli_proc  proc;                                                         ///< 命令函数
+    char     *help;                                                         ///< 说明
+
+} CLI_CMD, *PCLI_CMD;
+
+static CLI_CMD g_cmd[] = {
+    { "scan",   scan_main,  "[-j threads] [-t] [-s nodes] [-r] [-x] [-d items] [-f] [-g groups] [-v] [-p] [-k] [-a] [-o json|bin] [-c cache] [-m metrics] path...   递归扫描目录,每个文件输出一条记录" },
+    { "bench",  bench_main, "<item> [args]   性能测试" },
+    { "gen",    gen_main,   "[-s n] [-i n] [-f n] [-e n] [-b n] [-r n] [-p n] [-w 32|64] [-c n] [-d n] [-g 0|1] [-a 0|1] file   生成合成PE文件" },
+    { "index",  index_main, "build [-f] index path... | query index dll[!func|#ordinal]...   导入符号倒排索引" }
+};
+
+
+/**
+ *\brief                        输出帮助
+ *\return                       无
+ */
+static void cli_usage(void)
+{
+    fprintf(stderr, "usage: peinfo <command> [args]\n");
+
+    for (int i = 0; i < SIZEOF(g_cmd); i++)
+    {
+        fprintf(stderr, "  %-8s %s\n", g_cmd[i].name, g_cmd[i].help);
+    }
+}
+
+int cli_main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        cli_usage();
+        return -1;
+    }
+
+    pe_reloc_use(PE_RELOC_AUTO); // 各命令启动线程前按CPU选择实现,线程中只读
+    pe_str_use(PE_STR_AUTO);
+    hash_sha256_use(SIMD_AUTO);
+
+    for (int i = 0; i < SIZEOF(g_cmd); i++)
+    {
+        if (0 == strcmp(argv[1], g_cmd[i].name))
+        {
+            return g_cmd[i].proc(argc - 1, argv + 1);
+        }
+    }
+
+    if (0 == strcmp(argv[1], "-h"))
+    {
+        cli_usage();
+        return 0;
+    }
+
+    return scan_main(argc, argv); // 没有子命令时参数都是路径
+}
@@ -0,0 +1,22 @@
+/**
+ *\file     cli.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    命令行模式接口定义
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#ifndef _CLI_H_
+#define _CLI_H_
+
+/**
+ *\brief                        命令行模式主函数,按第1个参数分派子命令,默认为scan
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数,UTF-8
+ *\return                       程序返回值
+ */
+int cli_main(int argc, char **argv);
+
+#endif
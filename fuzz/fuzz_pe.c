@@ -0,0 +1,192 @@
+/**
+ *\file     fuzz_pe.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    PE解析模糊测试目标,对任意数据做完整解析并插入全部节点,没有界面
+ *          libFuzzer:
+ *              clang -g -O1 -fsanitize=fuzzer,address,undefined -I.. fuzz_pe.c ../pe*.c ../hash.c ../platform.c -lpthread -o fuzz_pe
+ *              ./fuzz_pe corpus_new corpus
+ *          AFL:
+ *              afl-clang-fast -O2 -DFUZZ_MAIN -I.. fuzz_pe.c ../pe*.c ../hash.c ../platform.c -lpthread -o fuzz_pe
+ *              afl-fuzz -i corpus -o out -- ./fuzz_pe @@
+ *          回放和性能测试,每个文件解析n轮,输出每秒解析次数和每字节纳秒数:
+ *              gcc -O2 -DFUZZ_MAIN -I.. fuzz_pe.c ../pe*.c ../hash.c ../platform.c -lpthread -o fuzz_pe
+ *              ./fuzz_pe [-n 轮数] corpus...
+ *          corpus为种子文件,最小的PE32/PE32+文件,由peinfo gen生成:
+ *              peinfo gen -w 32|64 -s 0 -i 0 -e 0 -b 0 pe32_min.dll
+ *              peinfo gen -w 32|64 -s 1 -i 2 -f 2 -e 2 -b 2 -r 4 pe32_small.dll
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|同时计算导入表散列和Rich头
+ *          2026.10.18|同时取版本信息和清单,树中包括资源表
+ *          2026.10.18|同时解码调试目录
+ *          2026.10.18|同时解码证书表和计算Authenticode摘要
+ *          2026.10.18|初始化时按CPU选择重定位解码的实现,向量实现也被测试
+ *          2026.10.18|初始化时按CPU选择字符串扫描的实现
+ *          2026.10.18|初始化时按CPU选择SHA-256的实现
+ */
+#include "pe_tree.h"
+#include "pe_finger.h"
+#include "pe_rsrc.h"
+#include "pe_debug.h"
+#include "pe_auth.h"
+#include "pe_reloc.h"
+#include "pe_str.h"
+#include "hash.h"
+
+/**
+ *\brief                        插入树节点回调,不输出
+ *\param[in]    param           节点数量
+ *\param[in]    parent          父节点句柄
+ *\param[in]    txt             节点文本
+ *\return                       新节点句柄
+ */
+static PE_NODE fuzz_insert(void *param, PE_NODE parent, const char *txt)
+{
+    (*(size_t*)param) += (0 != txt[0]);
+    return (PE_NODE)1;
+}
+
+/**
+ *\brief                        模糊测试初始化,与peinfo相同在开始前按CPU选择实现,没有选择时只测试标量实现
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0
+ */
+int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    (void)argc;
+    (void)argv;
+
+    pe_reloc_use(PE_RELOC_AUTO);
+    pe_str_use(PE_STR_AUTO);
+    hash_sha256_use(SIMD_AUTO);
+    return 0;
+}
+
+/**
+ *\brief                        模糊测试入口,数据复制到长度正好的缓冲区,越界读能被检查出来
+ *\param[in]    data            数据
+ *\param[in]    size            数据长度
+ *\return                       0
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    UCHAR   *buff  = malloc(size ? size : 1);
+    size_t   items = 0;
+    PE_TREE  tree  = { fuzz_insert, &items, NULL };
+    PE_IMAGE image;
+
+    if (NULL == buff)
+    {
+        return 0;
+    }
+
+    memcpy(buff, data, size);
+
+    int ret = pe_parse(&image, buff, size);
+
+    if (PE_OK == ret || ret <= PE_ERR_RELOC_SECTION) // 结构错误时检查过的部分仍然可以显示
+    {
+        pe_finger(&image, PE_FINGER_ALL);
+        pe_version(&image, PE_VERSION_ALL);
+        pe_debug(&image, PE_DEBUG_ALL);
+        pe_auth(&image, PE_AUTH_ALL);
+        pe_insert_tree(&tree, &image);
+    }
+
+    pe_free(&image);
+    free(buff);
+    return 0;
+}
+
+#ifdef FUZZ_MAIN
+
+typedef struct _FUZZ_STAT                                                   ///  回放统计
+{
+    int         rounds;                                                     ///< 每个文件解析轮数
+    ULONGLONG   files;                                                      ///< 文件数量
+    ULONGLONG   parses;                                                     ///< 解析次数
+    ULONGLONG   bytes;                                                      ///< 解析的字节数
+    double      secs;                                                       ///< 解析耗时
+
+} FUZZ_STAT, *PFUZZ_STAT;
+
+/**
+ *\brief                        遍历目录回调,回放一个文件
+ *\param[in]    path            文件路径
+ *\param[in]    param           回放统计
+ *\return                       0-成功,其它失败
+ */
+static int fuzz_file(const char *path, void *param)
+{
+    PFUZZ_STAT stat = (PFUZZ_STAT)param;
+    FILE_MAP   map;
+
+    if (0 != file_read(path, &map))
+    {
+        fprintf(stderr, "read %s error\n", path);
+        return 0;
+    }
+
+    double start = time_now();
+
+    for (int i = 0; i < stat->rounds; i++)
+    {
+        LLVMFuzzerTestOneInput(map.data, map.size);
+    }
+
+    stat->secs   += time_now() - start;
+    stat->files  += 1;
+    stat->parses += stat->rounds;
+    stat->bytes  += (ULONGLONG)map.size * stat->rounds;
+
+    file_unmap(&map);
+    return 0;
+}
+
+/**
+ *\brief                        回放和性能测试,也用于AFL
+ *                              fuzz_pe [-n 轮数] 路径...
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数
+ *\return                       0-成功,其它失败
+ */
+int main(int argc, char **argv)
+{
+    FUZZ_STAT stat  = { 1 };
+    int       first = 1;
+
+    LLVMFuzzerInitialize(&argc, &argv);
+
+    if (argc > 2 && 0 == strcmp(argv[1], "-n"))
+    {
+        stat.rounds = atoi(argv[2]);
+        first       = 3;
+    }
+
+    if (first >= argc || stat.rounds <= 0)
+    {
+        fprintf(stderr, "usage: fuzz_pe [-n rounds] path...\n");
+        return -1;
+    }
+
+    for (int i = first; i < argc; i++)
+    {
+        dir_walk(argv[i], fuzz_file, &stat);
+    }
+
+    if (stat.secs > 0)
+    {
+        fprintf(stderr, "files:%llu parses:%llu bytes:%llu time:%.4fs %.0f parses/s %.3f ns/byte\n",
+                (unsigned long long)stat.files, (unsigned long long)stat.parses,
+                (unsigned long long)stat.bytes, stat.secs,
+                stat.parses / stat.secs, stat.secs * 1e9 / (stat.bytes ? stat.bytes : 1));
+    }
+
+    return 0;
+}
+
+#endif
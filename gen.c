@@ -0,0 +1,1009 @@
+/**
+ *\file     gen.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    合成PE文件生成实现
+ *          布局: 头 | .text | .rdata(导出表,导入表,延迟导入表,调试目录) | .reloc | .rsrc(有资源时) | 额外的空节 | 证书表
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加PE32+
+ *          2026.10.18|没有重定位块时不复制重定位数据
+ *          2026.10.18|没有导入导出表时不复制.rdata数据
+ *          2026.10.18|预留0字节时不访问缓冲区
+ *          2026.10.18|增加资源表
+ *          2026.10.18|增加延迟导入表,输入地址表指向代码节
+ *          2026.10.18|增加调试目录,CodeView,POGO和repro记录跟在目录后面
+ *          2026.10.18|增加证书表,PKCS#7中的摘要按Authenticode计算
+ */
+#include "gen.h"
+#include "hash.h"
+
+#define GEN_FILE_ALIGN          0x200                                       ///< 文件对齐
+#define GEN_SECTION_ALIGN       0x1000                                      ///< 内存对齐
+#define GEN_IMAGE_BASE          0x10000000                                  ///< 内存首选装载地址
+#define GEN_IMAGE_BASE_64       0x180000000ULL                              ///< 内存首选装载地址(64位)
+#define GEN_TEXT_PAGES          16                                          ///< 代码节最多的页数,重定位块循环使用这些页
+
+#define ALIGN(x, a)             (((x) + (a) - 1) / (a) * (a))               ///< 向上取整
+
+#define GEN_PKCS7_DIGEST        88                                          ///< PKCS#7中SHA-256摘要的位置
+
+static const UCHAR g_gen_pkcs7[] = {                                        ///< 最小的Authenticode PKCS#7,没有证书和签名者
+    0x30, 0x78, 0x06, 0x09, 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x07, 0x02,                       // ContentInfo,signedData
+    0xA0, 0x6B, 0x30, 0x69, 0x02, 0x01, 0x01,                                                           // [0],SignedData,版本
+    0x31, 0x0F, 0x30, 0x0D, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, // 摘要算法集{sha256}
+    0x30, 0x51, 0x06, 0x0A, 0x2B, 0x06, 0x01, 0x04, 0x01, 0x82, 0x37, 0x02, 0x01, 0x04,                 // contentInfo,SpcIndirectDataContent
+    0xA0, 0x43, 0x30, 0x41, 0x30, 0x0C, 0x06, 0x0A, 0x2B, 0x06, 0x01, 0x04, 0x01, 0x82, 0x37, 0x02, 0x01, 0x0F, // [0],data{SpcPeImageData}
+    0x30, 0x31, 0x30, 0x0D, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20, // DigestInfo{sha256}
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,   // 摘要
+    0x31, 0x00                                                                                          // 签名者集
+};
+
+typedef struct _GEN_BUF                                                     ///  生成缓冲区
+{
+    UCHAR      *data;                                                       ///< 数据
+    size_t      len;                                                        ///< 已使用长度
+    size_t      cap;                                                        ///< 容量
+
+} GEN_BUF, *PGEN_BUF;
+
+#define GEN_DWORD(buf, off)     (*(DWORD*)((buf)->data + (off)))            ///< 缓冲区中的DWORD
+#define GEN_WORD(buf, off)      (*(WORD*)((buf)->data + (off)))             ///< 缓冲区中的WORD
+#define GEN_WIDE(gen)           (64 == (gen)->bits)                         ///< 1-PE32+
+#define GEN_THUNK(gen)          (GEN_WIDE(gen) ? 8 : 4)                     ///< thunk长度
+
+
+/**
+ *\brief                        在缓冲区尾部预留空间,填0
+ *\param[in]    buf             缓冲区
+ *\param[in]    len             长度
+ *\return                       预留空间的偏移,失败返回-1
+ */
+static long gen_reserve(PGEN_BUF buf, size_t len)
+{
+    if (buf->len + len > buf->cap)
+    {
+        size_t cap  = buf->cap ? buf->cap : 4096;
+        UCHAR *data = NULL;
+
+        while (cap < buf->len + len)
+        {
+            cap *= 2;
+        }
+
+        data = realloc(buf->data, cap);
+
+        if (NULL == data)
+        {
+            return -1;
+        }
+
+        buf->data = data;
+        buf->cap  = cap;
+    }
+
+    long off = (long)buf->len;
+
+    if (0 == len) // 没有导出函数时数组长度为0,data可能还是NULL
+    {
+        return off;
+    }
+
+    memset(buf->data + off, 0, len);
+    buf->len += len;
+    return off;
+}
+
+/**
+ *\brief                        在缓冲区尾部追加字符串,包括结尾的0,按2字节对齐
+ *\param[in]    buf             缓冲区
+ *\param[in]    str             字符串
+ *\return                       字符串的偏移,失败返回-1
+ */
+static long gen_string(PGEN_BUF buf, const char *str)
+{
+    size_t len = strlen(str) + 1;
+    long   off = gen_reserve(buf, ALIGN(len, 2));
+
+    if (off >= 0)
+    {
+        memcpy(buf->data + off, str, len);
+    }
+
+    return off;
+}
+
+/**
+ *\brief                        生成延迟导入表,描述使用相对虚拟地址,输入地址表中是代码节的虚拟地址
+ *\param[in]    gen             参数
+ *\param[in]    rva             节的相对虚拟地址
+ *\param[out]   buf             节数据
+ *\param[out]   dir             数据目录,填写延迟导入表
+ *\return                       0-成功,其它失败
+ */
+static int gen_delay(PPE_GEN gen, DWORD rva, PGEN_BUF buf, PIMAGE_DATA_DIRECTORY dir)
+{
+    ULONGLONG base = GEN_WIDE(gen) ? GEN_IMAGE_BASE_64 : GEN_IMAGE_BASE;
+    char      name[64];
+    long      off;
+
+    if ((off = gen_reserve(buf, ALIGN(buf->len, 8) - buf->len)) < 0)
+    {
+        return -1;
+    }
+
+    long desc   = gen_reserve(buf, (gen->delays + 1) * sizeof(IMAGE_DELAYLOAD_DESCRIPTOR));
+    long handle = gen_reserve(buf, gen->delays * GEN_THUNK(gen));
+
+    if (desc < 0 || handle < 0)
+    {
+        return -2;
+    }
+
+    for (DWORD i = 0; i < gen->delays; i++)
+    {
+        long thunk = gen_reserve(buf, (gen->funcs + 1) * GEN_THUNK(gen));
+        long iat   = gen_reserve(buf, (gen->funcs + 1) * GEN_THUNK(gen));
+
+        snprintf(name, sizeof(name), "dly%04u.dll", i);
+
+        long lib = gen_string(buf, name);
+
+        if (thunk < 0 || iat < 0 || lib < 0)
+        {
+            return -3;
+        }
+
+        PIMAGE_DELAYLOAD_DESCRIPTOR dd = (PIMAGE_DELAYLOAD_DESCRIPTOR)(buf->data + desc) + i;
+        dd->Attributes.AllAttributes = 1;
+        dd->DllNameRVA               = rva + lib;
+        dd->ModuleHandleRVA          = rva + handle + i * GEN_THUNK(gen);
+        dd->ImportAddressTableRVA    = rva + iat;
+        dd->ImportNameTableRVA       = rva + thunk;
+
+        for (DWORD j = 0; j < gen->funcs; j++)
+        {
+            snprintf(name, sizeof(name), "..Dly%04u_%08u", i, j); // 前2字节是提示序号
+
+            if ((off = gen_string(buf, name)) < 0)
+            {
+                return -4;
+            }
+
+            ULONGLONG stub = base + GEN_SECTION_ALIGN + (j * 16) % GEN_SECTION_ALIGN; // 加载前指向代码节中的桩
+
+            GEN_WORD(buf, off)                         = (WORD)j;
+            GEN_DWORD(buf, thunk + j * GEN_THUNK(gen)) = rva + off;
+            GEN_DWORD(buf, iat + j * GEN_THUNK(gen))   = (DWORD)stub;
+
+            if (GEN_WIDE(gen))
+            {
+                GEN_DWORD(buf, iat + j * GEN_THUNK(gen) + 4) = (DWORD)(stub >> 32);
+            }
+        }
+    }
+
+    dir[13].VirtualAddress = rva + desc;
+    dir[13].Size           = (gen->delays + 1) * sizeof(IMAGE_DELAYLOAD_DESCRIPTOR);
+    return 0;
+}
+
+/**
+ *\brief                        生成.rdata节的内容,导出表,导入表和延迟导入表
+ *\param[in]    gen             参数
+ *\param[in]    rva             节的相对虚拟地址
+ *\param[out]   buf             节数据
+ *\param[out]   dir             数据目录,填写导出表,导入表和延迟导入表
+ *\return                       0-成功,其它失败
+ */
+static int gen_rdata(PPE_GEN gen, DWORD rva, PGEN_BUF buf, PIMAGE_DATA_DIRECTORY dir)
+{
+    char name[64];
+    long off;
+
+    if (gen->exports > 0)
+    {
+        long exp   = gen_reserve(buf, sizeof(IMAGE_EXPORT_DIRECTORY));
+        long func  = gen_reserve(buf, gen->exports * sizeof(DWORD));
+        long names = gen_reserve(buf, gen->exports * sizeof(DWORD));
+        long ords  = gen_reserve(buf, ALIGN(gen->exports * sizeof(WORD), 4));
+        long dll   = gen_string(buf, "gen.dll");
+
+        if (exp < 0 || func < 0 || names < 0 || ords < 0 || dll < 0)
+        {
+            return -1;
+        }
+
+        PIMAGE_EXPORT_DIRECTORY ed = (PIMAGE_EXPORT_DIRECTORY)(buf->data + exp);
+        ed->Name                  = rva + dll;
+        ed->Base                  = 1;
+        ed->NumberOfFunctions     = gen->exports;
+        ed->NumberOfNames         = gen->exports;
+        ed->AddressOfFunctions    = rva + func;
+        ed->AddressOfNames        = rva + names;
+        ed->AddressOfNameOrdinals = rva + ords;
+
+        for (DWORD i = 0; i < gen->exports; i++) // 名称定长,按字典序排列
+        {
+            snprintf(name, sizeof(name), "Func%08u", i);
+
+            if ((off = gen_string(buf, name)) < 0)
+            {
+                return -2;
+            }
+
+            GEN_DWORD(buf, func + i * 4)  = GEN_SECTION_ALIGN + (i * 16) % GEN_SECTION_ALIGN;
+            GEN_DWORD(buf, names + i * 4) = rva + off;
+            GEN_WORD(buf, ords + i * 2)   = (WORD)i;
+        }
+
+        dir[0].VirtualAddress = rva + exp;
+        dir[0].Size           = (DWORD)(buf->len - exp);
+    }
+
+    if (gen->libs > 0)
+    {
+        if ((off = gen_reserve(buf, ALIGN(buf->len, 8) - buf->len)) < 0)
+        {
+            return -3;
+        }
+
+        long desc = gen_reserve(buf, ALIGN((gen->libs + 1) * sizeof(IMAGE_IMPORT_DESCRIPTOR), 8));
+
+        if (desc < 0)
+        {
+            return -4;
+        }
+
+        for (DWORD i = 0; i < gen->libs; i++)
+        {
+            long thunk = gen_reserve(buf, (gen->funcs + 1) * GEN_THUNK(gen));
+            long iat   = gen_reserve(buf, (gen->funcs + 1) * GEN_THUNK(gen));
+
+            snprintf(name, sizeof(name), "lib%04u.dll", i);
+
+            long lib = gen_string(buf, name);
+
+            if (thunk < 0 || iat < 0 || lib < 0)
+            {
+                return -5;
+            }
+
+            PIMAGE_IMPORT_DESCRIPTOR id = (PIMAGE_IMPORT_DESCRIPTOR)(buf->data + desc) + i;
+            id->OriginalFirstThunk = rva + thunk;
+            id->Name               = rva + lib;
+            id->FirstThunk         = rva + iat;
+
+            for (DWORD j = 0; j < gen->funcs; j++)
+            {
+                snprintf(name, sizeof(name), "..Imp%04u_%08u", i, j); // 前2字节是提示序号
+
+                if ((off = gen_string(buf, name)) < 0)
+                {
+                    return -6;
+                }
+
+                GEN_WORD(buf, off)                            = (WORD)j;
+                GEN_DWORD(buf, thunk + j * GEN_THUNK(gen))    = rva + off; // 64位时高32位为0
+                GEN_DWORD(buf, iat + j * GEN_THUNK(gen))      = rva + off;
+            }
+        }
+
+        dir[1].VirtualAddress = rva + desc;
+        dir[1].Size           = (gen->libs + 1) * sizeof(IMAGE_IMPORT_DESCRIPTOR);
+    }
+
+    return (gen->delays > 0) ? gen_delay(gen, rva, buf, dir) : 0;
+}
+
+/**
+ *\brief                        生成调试目录和记录,追加到.rdata节的尾部,记录同时有相对虚拟地址和文件位置
+ *\param[in]    rva             节的相对虚拟地址
+ *\param[in]    fa              节在文件中的位置
+ *\param[out]   buf             节数据
+ *\param[out]   dir             数据目录,填写调试目录
+ *\return                       0-成功,其它失败
+ */
+static int gen_debug(DWORD rva, DWORD fa, PGEN_BUF buf, PIMAGE_DATA_DIRECTORY dir)
+{
+    static const char *pogo[] = { ".text$mn", ".rdata", ".rdata$zzzdbg", ".reloc" };
+    static const char *pdb    = "C:\\gen\\obj\\gen.pdb";
+
+    if (gen_reserve(buf, ALIGN(buf->len, 4) - buf->len) < 0)
+    {
+        return -1;
+    }
+
+    long debug = gen_reserve(buf, 3 * sizeof(IMAGE_DEBUG_DIRECTORY));
+    long cv    = gen_reserve(buf, 24);
+    long path  = gen_string(buf, pdb);
+
+    if (debug < 0 || cv < 0 || path < 0 || gen_reserve(buf, ALIGN(buf->len, 4) - buf->len) < 0)
+    {
+        return -2;
+    }
+
+    GEN_DWORD(buf, cv)      = 0x53445352; // "RSDS"
+    GEN_DWORD(buf, cv + 20) = 1;          // age
+
+    for (int i = 0; i < 16; i++)
+    {
+        buf->data[cv + 4 + i] = (UCHAR)(0x11 * (i + 1));
+    }
+
+    long pgo = gen_reserve(buf, 4);
+
+    if (pgo < 0)
+    {
+        return -3;
+    }
+
+    GEN_DWORD(buf, pgo) = 0x00554750; // "PGU"
+
+    for (int i = 0; i < SIZEOF(pogo); i++)
+    {
+        long item = gen_reserve(buf, 8);
+        long name = gen_reserve(buf, ALIGN(strlen(pogo[i]) + 1, 4));
+
+        if (item < 0 || name < 0)
+        {
+            return -4;
+        }
+
+        GEN_DWORD(buf, item)     = rva + (DWORD)item;
+        GEN_DWORD(buf, item + 4) = 0x100;
+        memcpy(buf->data + name, pogo[i], strlen(pogo[i]));
+    }
+
+    long pgo_end = (long)buf->len;
+    long repro   = gen_reserve(buf, 4 + 32);
+
+    if (repro < 0)
+    {
+        return -5;
+    }
+
+    GEN_DWORD(buf, repro) = 32;
+
+    for (int i = 0; i < 32; i++)
+    {
+        buf->data[repro + 4 + i] = (UCHAR)(0xA0 + i);
+    }
+
+    PIMAGE_DEBUG_DIRECTORY dd = (PIMAGE_DEBUG_DIRECTORY)(buf->data + debug);
+    long   data[3] = { cv, pgo, repro };
+    DWORD  size[3] = { (DWORD)(path + strlen(pdb) + 1 - cv), (DWORD)(pgo_end - pgo), 4 + 32 };
+    DWORD  type[3] = { 2, 13, 16 }; // CODEVIEW,POGO,REPRO
+
+    for (int i = 0; i < 3; i++)
+    {
+        dd[i].TimeDateStamp    = (16 == type[i]) ? 0xA3A2A1A0 : 0x60000000; // repro时为散列的前4字节
+        dd[i].Type             = type[i];
+        dd[i].SizeOfData       = size[i];
+        dd[i].AddressOfRawData = rva + (DWORD)data[i];
+        dd[i].PointerToRawData = fa + (DWORD)data[i];
+    }
+
+    dir[6].VirtualAddress = rva + debug;
+    dir[6].Size           = 3 * sizeof(IMAGE_DEBUG_DIRECTORY);
+    return 0;
+}
+
+/**
+ *\brief                        在缓冲区尾部追加资源目录,目录项跟在目录头后面
+ *\param[in]    buf             缓冲区
+ *\param[in]    named           名称项数量
+ *\param[in]    ids             ID项数量
+ *\return                       目录的偏移,失败返回-1
+ */
+static long gen_rsrc_dir(PGEN_BUF buf, DWORD named, DWORD ids)
+{
+    long off = gen_reserve(buf, sizeof(IMAGE_RESOURCE_DIRECTORY) + (named + ids) * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
+
+    if (off >= 0)
+    {
+        ((PIMAGE_RESOURCE_DIRECTORY)(buf->data + off))->NumberOfNamedEntries = (WORD)named;
+        ((PIMAGE_RESOURCE_DIRECTORY)(buf->data + off))->NumberOfIdEntries    = (WORD)ids;
+    }
+
+    return off;
+}
+
+/**
+ *\brief                        在缓冲区尾部追加UTF-16字符串,只支持ASCII
+ *\param[in]    buf             缓冲区
+ *\param[in]    str             字符串
+ *\param[in]    prefix          1-前面是WORD长度(资源名称),0-后面是结尾的0(版本信息)
+ *\return                       字符串的偏移,失败返回-1
+ */
+static long gen_wide(PGEN_BUF buf, const char *str, int prefix)
+{
+    size_t len = strlen(str);
+    long   off = gen_reserve(buf, (len + 1) * sizeof(WORD));
+
+    if (off < 0)
+    {
+        return -1;
+    }
+
+    WORD *dst = (WORD*)(buf->data + off);
+
+    if (prefix)
+    {
+        *dst++ = (WORD)len;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        dst[i] = (UCHAR)str[i];
+    }
+
+    return off;
+}
+
+/**
+ *\brief                        开始一个版本信息块,先按4字节对齐,写入块头,名称和值,块长度在gen_ver_end中回填
+ *\param[in]    buf             缓冲区,版本信息从8字节对齐的位置开始
+ *\param[in]    key             名称
+ *\param[in]    type            1-文本,0-二进制
+ *\param[in]    value           值,文本时为ASCII字符串,NULL为没有值
+ *\param[in]    size            二进制值的字节数
+ *\return                       块的偏移,失败返回-1
+ */
+static long gen_ver_begin(PGEN_BUF buf, const char *key, WORD type, const void *value, size_t size)
+{
+    long start = gen_reserve(buf, ALIGN(buf->len, 4) - buf->len);
+
+    if (start < 0 || (start = gen_reserve(buf, 3 * sizeof(WORD))) < 0 || gen_wide(buf, key, 0) < 0 ||
+        gen_reserve(buf, ALIGN(buf->len, 4) - buf->len) < 0)
+    {
+        return -1;
+    }
+
+    GEN_WORD(buf, start + 4) = type;
+
+    if (NULL == value)
+    {
+        return start;
+    }
+
+    if (1 == type)
+    {
+        GEN_WORD(buf, start + 2) = (WORD)(strlen(value) + 1); // 文本的长度是字符数,包括结尾的0
+        return (gen_wide(buf, value, 0) < 0) ? -1 : start;
+    }
+
+    long off = gen_reserve(buf, size);
+
+    if (off < 0)
+    {
+        return -1;
+    }
+
+    memcpy(buf->data + off, value, size);
+    GEN_WORD(buf, start + 2) = (WORD)size;
+    return start;
+}
+
+/**
+ *\brief                        结束一个版本信息块,回填块长度,不包括后面的对齐
+ *\param[in]    buf             缓冲区
+ *\param[in]    start           块的偏移
+ *\return                       无
+ */
+static void gen_ver_end(PGEN_BUF buf, long start)
+{
+    GEN_WORD(buf, start) = (WORD)(buf->len - start);
+}
+
+/**
+ *\brief                        生成VS_VERSIONINFO,版本1.2.3.4,一个StringTable
+ *\param[out]   buf             缓冲区,从8字节对齐的位置开始
+ *\return                       0-成功,其它失败
+ */
+static int gen_version(PGEN_BUF buf)
+{
+    static const char *str[][2] = {
+        { "CompanyName",      "peinfo gen"   }, { "FileDescription", "Synthetic PE" },
+        { "FileVersion",      "1.2.3.4"      }, { "InternalName",    "gen.dll"      },
+        { "OriginalFilename", "gen.dll"      }, { "ProductName",     "peinfo"       },
+        { "ProductVersion",   "1.2.3.4"      },
+    };
+
+    DWORD fixed[13] = { 0xFEEF04BD, 0x10000, 0x10002, 0x30004, 0x10002, 0x30004, 0x3F, 0, 0x40004, 2, 0, 0, 0 };
+    DWORD lang      = 0x04B00409;
+
+    long root  = gen_ver_begin(buf, "VS_VERSION_INFO", 0, fixed, sizeof(fixed));
+    long info  = gen_ver_begin(buf, "StringFileInfo", 1, NULL, 0);
+    long table = gen_ver_begin(buf, "040904b0", 1, NULL, 0);
+
+    if (root < 0 || info < 0 || table < 0)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < SIZEOF(str); i++)
+    {
+        long off = gen_ver_begin(buf, str[i][0], 1, str[i][1], 0);
+
+        if (off < 0)
+        {
+            return -2;
+        }
+
+        gen_ver_end(buf, off);
+    }
+
+    gen_ver_end(buf, table);
+    gen_ver_end(buf, info);
+
+    long var   = gen_ver_begin(buf, "VarFileInfo", 1, NULL, 0);
+    long trans = gen_ver_begin(buf, "Translation", 0, &lang, sizeof(lang));
+
+    if (var < 0 || trans < 0)
+    {
+        return -3;
+    }
+
+    gen_ver_end(buf, trans);
+    gen_ver_end(buf, var);
+    gen_ver_end(buf, root);
+    return 0;
+}
+
+/**
+ *\brief                        生成.rsrc节的内容
+ *                              类型层:图标,对话框(按名称),版本信息,清单;每项一种语言.
+ *                              按链接器的顺序排列:根目录,各类型的名称层目录,语言层目录,数据项,名称,数据
+ *\param[in]    gen             参数
+ *\param[in]    rva             节的相对虚拟地址
+ *\param[out]   buf             节数据
+ *\param[out]   dir             数据目录,填写资源表
+ *\return                       0-成功,其它失败
+ */
+static int gen_rsrc(PPE_GEN gen, DWORD rva, PGEN_BUF buf, PIMAGE_DATA_DIRECTORY dir)
+{
+    static const char manifest[] =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\r\n"
+        "<assembly xmlns=\"urn:schemas-microsoft-com:asm.v1\" manifestVersion=\"1.0\">\r\n"
+        "  <trustInfo xmlns=\"urn:schemas-microsoft-com:asm.v3\"><security><requestedPrivileges>\r\n"
+        "    <requestedExecutionLevel level=\"asInvoker\" uiAccess=\"false\"/>\r\n"
+        "  </requestedPrivileges></security></trustInfo>\r\n"
+        "</assembly>\r\n";
+
+    DWORD type[4]  = { 3, 5, 16, 24 }; // RT_ICON,RT_DIALOG,RT_VERSION,RT_MANIFEST,按ID排列
+    DWORD count[4] = { gen->resources, gen->resources / 4, 1, 1 };
+    DWORD total    = count[0] + count[1] + count[2] + count[3];
+    long  sub[4];
+    char  name[32];
+
+    if (gen->resources > 0xFFFF) // 目录项数量是WORD
+    {
+        return -4;
+    }
+
+    long root = gen_rsrc_dir(buf, 0, 4);
+
+    for (int t = 0; t < 4; t++)
+    {
+        sub[t] = (1 == t) ? gen_rsrc_dir(buf, count[t], 0) : gen_rsrc_dir(buf, 0, count[t]);
+    }
+
+    long lang = gen_reserve(buf, total * (sizeof(IMAGE_RESOURCE_DIRECTORY) + sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY)));
+    long data = gen_reserve(buf, total * sizeof(IMAGE_RESOURCE_DATA_ENTRY));
+
+    if (root < 0 || sub[0] < 0 || sub[1] < 0 || sub[2] < 0 || sub[3] < 0 || lang < 0 || data < 0)
+    {
+        return -1;
+    }
+
+    for (DWORD t = 0, k = 0; t < 4; t++)
+    {
+        PIMAGE_RESOURCE_DIRECTORY_ENTRY entry = (PIMAGE_RESOURCE_DIRECTORY_ENTRY)(buf->data + root + sizeof(IMAGE_RESOURCE_DIRECTORY)) + t;
+
+        entry->Name         = type[t];
+        entry->OffsetToData = 0x80000000 | (DWORD)sub[t];
+
+        for (DWORD j = 0; j < count[t]; j++, k++)
+        {
+            long lang_dir = lang + k * (sizeof(IMAGE_RESOURCE_DIRECTORY) + sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY));
+            long entry_fa = sub[t] + sizeof(IMAGE_RESOURCE_DIRECTORY) + j * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY);
+            long name_off = 0;
+
+            if (1 == t) // 名称定长,按字典序排列
+            {
+                snprintf(name, sizeof(name), "DLG%05u", j);
+
+                if ((name_off = gen_wide(buf, name, 1)) < 0)
+                {
+                    return -2;
+                }
+            }
+
+            ((PIMAGE_RESOURCE_DIRECTORY_ENTRY)(buf->data + entry_fa))->Name         = (1 == t) ? 0x80000000 | (DWORD)name_off : j + 1;
+            ((PIMAGE_RESOURCE_DIRECTORY_ENTRY)(buf->data + entry_fa))->OffsetToData = 0x80000000 | (DWORD)lang_dir;
+            ((PIMAGE_RESOURCE_DIRECTORY)(buf->data + lang_dir))->NumberOfIdEntries  = 1;
+
+            entry = (PIMAGE_RESOURCE_DIRECTORY_ENTRY)(buf->data + lang_dir + sizeof(IMAGE_RESOURCE_DIRECTORY));
+            entry->Name         = 0x409;
+            entry->OffsetToData = (DWORD)(data + k * sizeof(IMAGE_RESOURCE_DATA_ENTRY));
+        }
+    }
+
+    for (DWORD t = 0, k = 0; t < 4; t++) // 数据按8字节对齐
+    {
+        for (DWORD j = 0; j < count[t]; j++, k++)
+        {
+            int  err   = (gen_reserve(buf, ALIGN(buf->len, 8) - buf->len) < 0);
+            long start = (long)buf->len;
+
+            if (0 == err && 2 == t)
+            {
+                err = gen_version(buf);
+            }
+            else if (0 == err && 3 == t)
+            {
+                long off = gen_reserve(buf, sizeof(manifest) - 1);
+
+                err = (off < 0);
+
+                if (0 == err)
+                {
+                    memcpy(buf->data + off, manifest, sizeof(manifest) - 1);
+                }
+            }
+            else if (0 == err)
+            {
+                long off = gen_reserve(buf, (0 == t) ? 64 : 32);
+
+                err = (off < 0);
+
+                if (0 == err)
+                {
+                    memset(buf->data + off, (int)(j & 0xFF), (0 == t) ? 64 : 32);
+                }
+            }
+
+            if (0 != err)
+            {
+                return -3;
+            }
+
+            PIMAGE_RESOURCE_DATA_ENTRY entry = (PIMAGE_RESOURCE_DATA_ENTRY)(buf->data + data) + k;
+
+            entry->OffsetToData = rva + (DWORD)start;
+            entry->Size         = (DWORD)(buf->len - start);
+        }
+    }
+
+    dir[2].VirtualAddress = rva;
+    dir[2].Size           = (DWORD)buf->len;
+    return 0;
+}
+
+/**
+ *\brief                        生成.reloc节的内容
+ *\param[in]    gen             参数
+ *\param[in]    pages           代码节页数
+ *\param[out]   buf             节数据
+ *\return                       0-成功,其它失败
+ */
+static int gen_reloc(PPE_GEN gen, DWORD pages, PGEN_BUF buf)
+{
+    DWORD count = ALIGN(gen->reloc_entries, 2); // 块按4字节对齐,不足时补类型为0的项
+    WORD  type  = GEN_WIDE(gen) ? 10 : 3;       // IMAGE_REL_BASED_DIR64,IMAGE_REL_BASED_HIGHLOW
+
+    for (DWORD i = 0; i < gen->reloc_blocks; i++)
+    {
+        long off = gen_reserve(buf, sizeof(IMAGE_BASE_RELOCATION) + count * sizeof(WORD));
+
+        if (off < 0)
+        {
+            return -1;
+        }
+
+        PIMAGE_BASE_RELOCATION block = (PIMAGE_BASE_RELOCATION)(buf->data + off);
+        block->VirtualAddress = GEN_SECTION_ALIGN * (1 + i % pages);
+        block->SizeOfBlock    = sizeof(IMAGE_BASE_RELOCATION) + count * sizeof(WORD);
+
+        WORD *entry = (WORD*)(block + 1);
+
+        for (DWORD j = 0; j < gen->reloc_entries; j++)
+        {
+            entry[j] = (WORD)((type << 12) | ((j * 4) & (GEN_WIDE(gen) ? 0xFF8 : 0xFFC)));
+        }
+    }
+
+    return 0;
+}
+
+/**
+ *\brief                        在文件末尾写证书表:按Authenticode计算SHA-256,跳过校验和与证书表的数据目录项
+ *\param[in]    buff            文件数据,证书表的空间已经预留
+ *\param[in]    len             证书表的位置,也是参与散列的长度
+ *\param[in]    wide            1-PE32+
+ *\return                       无
+ */
+static void gen_sign(UCHAR *buff, size_t len, int wide)
+{
+    DWORD       cks    = 0x80 + (wide ? offsetof(IMAGE_NT_HEADERS64, OptionalHeader.CheckSum)
+                                      : offsetof(IMAGE_NT_HEADERS32, OptionalHeader.CheckSum));
+    DWORD       secdir = 0x80 + (wide ? offsetof(IMAGE_NT_HEADERS64, OptionalHeader.DataDirectory[4])
+                                      : offsetof(IMAGE_NT_HEADERS32, OptionalHeader.DataDirectory[4]));
+    UCHAR      *cert   = buff + len;
+    HASH_SHA256 ctx;
+
+    hash_sha256_init(&ctx);
+    hash_sha256_update(&ctx, buff, cks);
+    hash_sha256_update(&ctx, buff + cks + 4, secdir - cks - 4);
+    hash_sha256_update(&ctx, buff + secdir + 8, len - secdir - 8);
+
+    *(DWORD*)cert       = 8 + sizeof(g_gen_pkcs7);  // dwLength
+    *(WORD*)(cert + 4)  = 0x0200;                   // WIN_CERT_REVISION_2_0
+    *(WORD*)(cert + 6)  = 0x0002;                   // WIN_CERT_TYPE_PKCS_SIGNED_DATA
+    memcpy(cert + 8, g_gen_pkcs7, sizeof(g_gen_pkcs7));
+    hash_sha256_final(&ctx, cert + 8 + GEN_PKCS7_DIGEST);
+
+    ((PIMAGE_DATA_DIRECTORY)(buff + secdir))->VirtualAddress = (DWORD)len; // 地址是文件位置
+    ((PIMAGE_DATA_DIRECTORY)(buff + secdir))->Size           = ALIGN(8 + sizeof(g_gen_pkcs7), 8);
+}
+
+int pe_gen(PPE_GEN gen, UCHAR **data, size_t *size)
+{
+    GEN_BUF rdata = { 0 };
+    GEN_BUF reloc = { 0 };
+    GEN_BUF rsrc  = { 0 };
+    int     count = 3 + (gen->resources > 0) + gen->sections;
+    DWORD   pages = (gen->reloc_blocks < GEN_TEXT_PAGES) ? gen->reloc_blocks : GEN_TEXT_PAGES;
+
+    if (0 == pages)
+    {
+        pages = 1;
+    }
+
+    // 节的相对虚拟地址和文件位置
+    DWORD nt_size   = GEN_WIDE(gen) ? sizeof(IMAGE_NT_HEADERS64) : sizeof(IMAGE_NT_HEADERS32);
+    DWORD head      = ALIGN(0x80 + nt_size + count * sizeof(IMAGE_SECTION_HEADER), GEN_FILE_ALIGN);
+    DWORD text_rva  = GEN_SECTION_ALIGN;
+    DWORD text_raw  = pages * GEN_SECTION_ALIGN + ALIGN(gen->pad, GEN_FILE_ALIGN);
+    DWORD rdata_rva = text_rva + ALIGN(text_raw, GEN_SECTION_ALIGN);
+
+    IMAGE_DATA_DIRECTORY dir[IMAGE_NUMBEROF_DIRECTORY_ENTRIES] = { 0 };
+
+    if (0 != gen_rdata(gen, rdata_rva, &rdata, dir) || (gen->debug && 0 != gen_debug(rdata_rva, head + text_raw, &rdata, dir)) ||
+        0 != gen_reloc(gen, pages, &reloc))
+    {
+        free(rdata.data);
+        free(reloc.data);
+        return -1;
+    }
+
+    DWORD rdata_raw = ALIGN((DWORD)rdata.len, GEN_FILE_ALIGN);
+    DWORD reloc_rva = rdata_rva + ALIGN(rdata_raw ? rdata_raw : 1, GEN_SECTION_ALIGN);
+    DWORD reloc_raw = ALIGN((DWORD)reloc.len, GEN_FILE_ALIGN);
+    DWORD rsrc_rva  = reloc_rva + ALIGN(reloc_raw ? reloc_raw : 1, GEN_SECTION_ALIGN);
+
+    if (gen->resources > 0 && 0 != gen_rsrc(gen, rsrc_rva, &rsrc, dir))
+    {
+        free(rdata.data);
+        free(reloc.data);
+        free(rsrc.data);
+        return -1;
+    }
+
+    DWORD rsrc_raw  = ALIGN((DWORD)rsrc.len, GEN_FILE_ALIGN);
+    DWORD extra_rva = rsrc_rva + (rsrc_raw ? ALIGN(rsrc_raw, GEN_SECTION_ALIGN) : 0);
+    DWORD image_size = extra_rva + gen->sections * GEN_SECTION_ALIGN;
+
+    size_t len  = (size_t)head + text_raw + rdata_raw + reloc_raw + rsrc_raw + (size_t)gen->sections * GEN_FILE_ALIGN;
+    size_t cert = gen->sign ? ALIGN(8 + sizeof(g_gen_pkcs7), 8) : 0;
+    UCHAR *buff = calloc(1, len + cert);
+
+    if (NULL == buff)
+    {
+        free(rdata.data);
+        free(reloc.data);
+        free(rsrc.data);
+        return -2;
+    }
+
+    if (reloc.len > 0)
+    {
+        dir[5].VirtualAddress = reloc_rva;
+        dir[5].Size           = (DWORD)reloc.len;
+    }
+
+    PIMAGE_DOS_HEADER dos = (PIMAGE_DOS_HEADER)buff;
+    dos->e_magic  = IMAGE_DOS_SIGNATURE;
+    dos->e_lfanew = 0x80;
+
+    if (GEN_WIDE(gen))
+    {
+        PIMAGE_NT_HEADERS64 nt = (PIMAGE_NT_HEADERS64)(buff + 0x80);
+        nt->Signature                               = IMAGE_NT_SIGNATURE;
+        nt->FileHeader.Machine                      = 0x8664;
+        nt->FileHeader.NumberOfSections             = (WORD)count;
+        nt->FileHeader.SizeOfOptionalHeader         = sizeof(IMAGE_OPTIONAL_HEADER64);
+        nt->FileHeader.Characteristics              = 0x2022; // DLL,可执行,大地址
+        nt->OptionalHeader.Magic                    = 0x20b;
+        nt->OptionalHeader.AddressOfEntryPoint      = text_rva;
+        nt->OptionalHeader.BaseOfCode               = text_rva;
+        nt->OptionalHeader.ImageBase                = GEN_IMAGE_BASE_64;
+        nt->OptionalHeader.SectionAlignment         = GEN_SECTION_ALIGN;
+        nt->OptionalHeader.FileAlignment            = GEN_FILE_ALIGN;
+        nt->OptionalHeader.MajorSubsystemVersion    = 6;
+        nt->OptionalHeader.SizeOfImage              = image_size;
+        nt->OptionalHeader.SizeOfHeaders            = head;
+        nt->OptionalHeader.Subsystem                = 3;
+        nt->OptionalHeader.NumberOfRvaAndSizes      = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+        memcpy(nt->OptionalHeader.DataDirectory, dir, sizeof(dir));
+    }
+    else
+    {
+        PIMAGE_NT_HEADERS32 nt = (PIMAGE_NT_HEADERS32)(buff + 0x80);
+        nt->Signature                               = IMAGE_NT_SIGNATURE;
+        nt->FileHeader.Machine                      = 0x14c;
+        nt->FileHeader.NumberOfSections             = (WORD)count;
+        nt->FileHeader.SizeOfOptionalHeader         = sizeof(IMAGE_OPTIONAL_HEADER32);
+        nt->FileHeader.Characteristics              = 0x2102; // DLL,可执行,32位
+        nt->OptionalHeader.Magic                    = 0x10b;
+        nt->OptionalHeader.AddressOfEntryPoint      = text_rva;
+        nt->OptionalHeader.BaseOfCode               = text_rva;
+        nt->OptionalHeader.BaseOfData               = rdata_rva;
+        nt->OptionalHeader.ImageBase                = GEN_IMAGE_BASE;
+        nt->OptionalHeader.SectionAlignment         = GEN_SECTION_ALIGN;
+        nt->OptionalHeader.FileAlignment            = GEN_FILE_ALIGN;
+        nt->OptionalHeader.MajorSubsystemVersion    = 6;
+        nt->OptionalHeader.SizeOfImage              = image_size;
+        nt->OptionalHeader.SizeOfHeaders            = head;
+        nt->OptionalHeader.Subsystem                = 3;
+        nt->OptionalHeader.NumberOfRvaAndSizes      = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+        memcpy(nt->OptionalHeader.DataDirectory, dir, sizeof(dir));
+    }
+
+    PIMAGE_SECTION_HEADER section = (PIMAGE_SECTION_HEADER)(buff + 0x80 + nt_size);
+    DWORD                 fa      = head;
+
+    memcpy(section->Name, ".text", 5);
+    section->Misc.VirtualSize  = text_raw;
+    section->VirtualAddress    = text_rva;
+    section->SizeOfRawData     = text_raw;
+    section->PointerToRawData  = fa;
+    section->Characteristics   = 0x60000020; // 代码,可执行,可读
+    memset(buff + fa, 0xCC, text_raw);
+    fa += text_raw;
+    section++;
+
+    memcpy(section->Name, ".rdata", 6);
+    section->Misc.VirtualSize  = (DWORD)rdata.len;
+    section->VirtualAddress    = rdata_rva;
+    section->SizeOfRawData     = rdata_raw;
+    section->PointerToRawData  = fa;
+    section->Characteristics   = 0x40000040; // 已初始化数据,可读
+
+    if (rdata.len > 0)
+    {
+        memcpy(buff + fa, rdata.data, rdata.len); // 没有导入导出表时rdata.data为NULL
+    }
+
+    fa += rdata_raw;
+    section++;
+
+    memcpy(section->Name, ".reloc", 6);
+    section->Misc.VirtualSize  = (DWORD)reloc.len;
+    section->VirtualAddress    = reloc_rva;
+    section->SizeOfRawData     = reloc_raw;
+    section->PointerToRawData  = fa;
+    section->Characteristics   = 0x42000040; // 已初始化数据,可丢弃,可读
+
+    if (reloc.len > 0)
+    {
+        memcpy(buff + fa, reloc.data, reloc.len); // 没有重定位块时reloc.data为NULL
+    }
+
+    fa += reloc_raw;
+    section++;
+
+    if (rsrc.len > 0)
+    {
+        memcpy(section->Name, ".rsrc", 5);
+        section->Misc.VirtualSize  = (DWORD)rsrc.len;
+        section->VirtualAddress    = rsrc_rva;
+        section->SizeOfRawData     = rsrc_raw;
+        section->PointerToRawData  = fa;
+        section->Characteristics   = 0x40000040;
+        memcpy(buff + fa, rsrc.data, rsrc.len);
+        fa += rsrc_raw;
+        section++;
+    }
+
+    for (DWORD i = 0; i < gen->sections; i++)
+    {
+        snprintf((char*)section->Name, IMAGE_SIZEOF_SHORT_NAME, ".s%05u", i % 100000);
+        section->Misc.VirtualSize  = GEN_FILE_ALIGN;
+        section->VirtualAddress    = extra_rva + i * GEN_SECTION_ALIGN;
+        section->SizeOfRawData     = GEN_FILE_ALIGN;
+        section->PointerToRawData  = fa;
+        section->Characteristics   = 0x40000040;
+        fa += GEN_FILE_ALIGN;
+        section++;
+    }
+
+    free(rdata.data);
+    free(reloc.data);
+    free(rsrc.data);
+
+    if (gen->sign) // 最后写,摘要包括整个文件
+    {
+        gen_sign(buff, len, GEN_WIDE(gen));
+    }
+
+    *data = buff;
+    *size = len + cert;
+    return 0;
+}
+
+int gen_main(int argc, char **argv)
+{
+    PE_GEN gen  = { 0, 4, 64, 256, 256, 256, 0, 32 };
+    char  *path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        DWORD *value = NULL;
+
+        if      (0 == strcmp(argv[i], "-s")) value = &gen.sections;
+        else if (0 == strcmp(argv[i], "-i")) value = &gen.libs;
+        else if (0 == strcmp(argv[i], "-f")) value = &gen.funcs;
+        else if (0 == strcmp(argv[i], "-e")) value = &gen.exports;
+        else if (0 == strcmp(argv[i], "-b")) value = &gen.reloc_blocks;
+        else if (0 == strcmp(argv[i], "-r")) value = &gen.reloc_entries;
+        else if (0 == strcmp(argv[i], "-p")) value = &gen.pad;
+        else if (0 == strcmp(argv[i], "-w")) value = &gen.bits;
+        else if (0 == strcmp(argv[i], "-c")) value = &gen.resources;
+        else if (0 == strcmp(argv[i], "-d")) value = &gen.delays;
+        else if (0 == strcmp(argv[i], "-g")) value = &gen.debug;
+        else if (0 == strcmp(argv[i], "-a")) value = &gen.sign;
+        else path = argv[i];
+
+        if (NULL != value && ++i < argc)
+        {
+            *value = (DWORD)strtoul(argv[i], NULL, 0);
+        }
+    }
+
+    if (NULL == path)
+    {
+        fprintf(stderr, "usage: peinfo gen [-s sections] [-i libs] [-f funcs] [-e exports] "
+                        "[-b reloc_blocks] [-r reloc_entries] [-p pad] [-w 32|64] [-c icons] [-d delay_libs] [-g 0|1] [-a 0|1] file\n");
+        return -1;
+    }
+
+    UCHAR *data = NULL;
+    size_t size = 0;
+
+    if (0 != pe_gen(&gen, &data, &size))
+    {
+        fprintf(stderr, "gen error\n");
+        return -2;
+    }
+
+    FILE *fp  = file_open(path, "wb");
+    int   ret = 0;
+
+    if (NULL == fp || size != fwrite(data, 1, size, fp))
+    {
+        fprintf(stderr, "write %s error\n", path);
+        ret = -3;
+    }
+
+    if (NULL != fp)
+    {
+        fclose(fp);
+    }
+
+    free(data);
+    return ret;
+}
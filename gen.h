@@ -0,0 +1,58 @@
+/**
+ *\file     gen.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    合成PE文件生成接口定义,用于性能测试
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加PE32+
+ *          2026.10.18|增加资源表
+ *          2026.10.18|增加延迟导入表
+ *          2026.10.18|增加调试目录
+ *          2026.10.18|增加Authenticode证书表
+ */
+#ifndef _GEN_H_
+#define _GEN_H_
+
+#include "platform.h"
+
+typedef struct _PE_GEN                                                      ///  合成PE文件参数
+{
+    DWORD       sections;                                                   ///< 额外的空节数量
+    DWORD       libs;                                                       ///< 导入库数量
+    DWORD       funcs;                                                      ///< 每个导入库的函数数量
+    DWORD       exports;                                                    ///< 导出函数数量
+    DWORD       reloc_blocks;                                               ///< 重定位块数量
+    DWORD       reloc_entries;                                              ///< 每个重定位块的数据项数量
+    DWORD       pad;                                                        ///< 代码节额外填充的字节数
+    DWORD       bits;                                                       ///< 64-PE32+,其它-PE32
+    DWORD       resources;                                                  ///< 图标资源数量,不为0时还有1/4数量的命名对话框,版本信息和清单
+    DWORD       delays;                                                     ///< 延迟导入库数量,每个库的函数数量与导入库相同
+    DWORD       debug;                                                      ///< 1-生成调试目录(CodeView,POGO,repro)
+    DWORD       sign;                                                       ///< 1-文件末尾追加证书表,PKCS#7中只有SHA-256摘要,没有证书和签名
+
+} PE_GEN, *PPE_GEN;
+
+/**
+ *\brief                        生成合成PE文件
+ *\param[in]    gen             参数
+ *\param[out]   data            文件数据,需要free
+ *\param[out]   size            文件长度
+ *\return                       0-成功,其它失败
+ */
+int pe_gen(PPE_GEN gen, UCHAR **data, size_t *size);
+
+/**
+ *\brief                        生成合成PE文件命令
+ *                              peinfo gen [-s 节数] [-i 导入库数] [-f 每库函数数] [-e 导出函数数]
+ *                                         [-b 重定位块数] [-r 每块重定位项数] [-p 填充字节数] [-w 32|64]
+ *                                         [-c 图标资源数] [-d 延迟导入库数] [-g 1-调试目录] [-a 1-证书表] 文件名
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数,argv[0]为命令名
+ *\return                       0-成功,其它失败
+ */
+int gen_main(int argc, char **argv);
+
+#endif
@@ -0,0 +1,765 @@
+/**
+ *\file     hash.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    文件内容散列实现
+ *          SHA-256的块处理有逐项和x86 SHA扩展指令两种实现,运行时按CPU选择,结果相同
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加分段输入的XXH64和SHA-256
+ *          2026.10.18|增加MD5
+ *          2026.10.18|增加SHA-1
+ *          2026.10.18|SHA-256实现在启动线程前选择,不在计算时选择
+ */
+#include "hash.h"
+#include "view.h"
+
+#define XXH_P1      0x9E3779B185EBCA87ULL
+#define XXH_P2      0xC2B2AE3D27D4EB4FULL
+#define XXH_P3      0x165667B19E3779F9ULL
+#define XXH_P4      0x85EBCA77C2B2AE63ULL
+#define XXH_P5      0x27D4EB2F165667C5ULL
+
+#define XXH_ROTL(x, r)  (((x) << (r)) | ((x) >> (64 - (r))))
+
+/**
+ *\brief                        处理8字节
+ *\param[in]    acc             累加值
+ *\param[in]    input           输入
+ *\return                       新的累加值
+ */
+static inline ULONGLONG xxh_round(ULONGLONG acc, ULONGLONG input)
+{
+    acc += input * XXH_P2;
+    acc  = XXH_ROTL(acc, 31);
+    return acc * XXH_P1;
+}
+
+/**
+ *\brief                        合并一个累加值
+ *\param[in]    hash            散列值
+ *\param[in]    acc             累加值
+ *\return                       新的散列值
+ */
+static inline ULONGLONG xxh_merge(ULONGLONG hash, ULONGLONG acc)
+{
+    hash ^= xxh_round(0, acc);
+    return hash * XXH_P1 + XXH_P4;
+}
+
+/**
+ *\brief                        处理不满32字节的结尾并混合
+ *\param[in]    hash            散列值,已加上总长度
+ *\param[in]    p               结尾数据
+ *\param[in]    end             数据结束位置
+ *\return                       散列值
+ */
+static ULONGLONG xxh_finish(ULONGLONG hash, const UCHAR *p, const UCHAR *end)
+{
+    for (; p + 8 <= end; p += 8)
+    {
+        hash ^= xxh_round(0, le64(p));
+        hash  = XXH_ROTL(hash, 27) * XXH_P1 + XXH_P4;
+    }
+
+    if (p + 4 <= end)
+    {
+        hash ^= (ULONGLONG)le32(p) * XXH_P1;
+        hash  = XXH_ROTL(hash, 23) * XXH_P2 + XXH_P3;
+        p    += 4;
+    }
+
+    for (; p < end; p++)
+    {
+        hash ^= (*p) * XXH_P5;
+        hash  = XXH_ROTL(hash, 11) * XXH_P1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= XXH_P2;
+    hash ^= hash >> 29;
+    hash *= XXH_P3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+ULONGLONG hash_xxh64(const void *data, size_t len, ULONGLONG seed)
+{
+    const UCHAR *p    = (const UCHAR*)data;
+    const UCHAR *end  = p + len;
+    ULONGLONG    hash;
+
+    if (len >= 32)
+    {
+        ULONGLONG v1 = seed + XXH_P1 + XXH_P2;
+        ULONGLONG v2 = seed + XXH_P2;
+        ULONGLONG v3 = seed;
+        ULONGLONG v4 = seed - XXH_P1;
+
+        for (; p + 32 <= end; p += 32)
+        {
+            v1 = xxh_round(v1, le64(p));
+            v2 = xxh_round(v2, le64(p + 8));
+            v3 = xxh_round(v3, le64(p + 16));
+            v4 = xxh_round(v4, le64(p + 24));
+        }
+
+        hash = XXH_ROTL(v1, 1) + XXH_ROTL(v2, 7) + XXH_ROTL(v3, 12) + XXH_ROTL(v4, 18);
+        hash = xxh_merge(hash, v1);
+        hash = xxh_merge(hash, v2);
+        hash = xxh_merge(hash, v3);
+        hash = xxh_merge(hash, v4);
+    }
+    else
+    {
+        hash = seed + XXH_P5;
+    }
+
+    return xxh_finish(hash + (ULONGLONG)len, p, end);
+}
+
+void hash_xxh64_init(PHASH_XXH64 ctx, ULONGLONG seed)
+{
+    memset(ctx, 0, sizeof(HASH_XXH64));
+
+    ctx->seed = seed;
+    ctx->v[0] = seed + XXH_P1 + XXH_P2;
+    ctx->v[1] = seed + XXH_P2;
+    ctx->v[2] = seed;
+    ctx->v[3] = seed - XXH_P1;
+}
+
+void hash_xxh64_update(PHASH_XXH64 ctx, const void *data, size_t len)
+{
+    const UCHAR *p   = (const UCHAR*)data;
+    const UCHAR *end = p + len;
+
+    ctx->total += len;
+
+    if (ctx->buff_len + len < 32)
+    {
+        memcpy(ctx->buff + ctx->buff_len, p, len);
+        ctx->buff_len += (DWORD)len;
+        return;
+    }
+
+    if (ctx->buff_len > 0) // 先补满上次剩下的
+    {
+        memcpy(ctx->buff + ctx->buff_len, p, 32 - ctx->buff_len);
+        p += 32 - ctx->buff_len;
+
+        ctx->v[0] = xxh_round(ctx->v[0], le64(ctx->buff));
+        ctx->v[1] = xxh_round(ctx->v[1], le64(ctx->buff + 8));
+        ctx->v[2] = xxh_round(ctx->v[2], le64(ctx->buff + 16));
+        ctx->v[3] = xxh_round(ctx->v[3], le64(ctx->buff + 24));
+        ctx->buff_len = 0;
+    }
+
+    ULONGLONG v1 = ctx->v[0];
+    ULONGLONG v2 = ctx->v[1];
+    ULONGLONG v3 = ctx->v[2];
+    ULONGLONG v4 = ctx->v[3];
+
+    for (; p + 32 <= end; p += 32)
+    {
+        v1 = xxh_round(v1, le64(p));
+        v2 = xxh_round(v2, le64(p + 8));
+        v3 = xxh_round(v3, le64(p + 16));
+        v4 = xxh_round(v4, le64(p + 24));
+    }
+
+    ctx->v[0] = v1;
+    ctx->v[1] = v2;
+    ctx->v[2] = v3;
+    ctx->v[3] = v4;
+
+    memcpy(ctx->buff, p, end - p);
+    ctx->buff_len = (DWORD)(end - p);
+}
+
+ULONGLONG hash_xxh64_final(PHASH_XXH64 ctx)
+{
+    ULONGLONG hash;
+
+    if (ctx->total >= 32)
+    {
+        hash = XXH_ROTL(ctx->v[0], 1) + XXH_ROTL(ctx->v[1], 7) + XXH_ROTL(ctx->v[2], 12) + XXH_ROTL(ctx->v[3], 18);
+        hash = xxh_merge(hash, ctx->v[0]);
+        hash = xxh_merge(hash, ctx->v[1]);
+        hash = xxh_merge(hash, ctx->v[2]);
+        hash = xxh_merge(hash, ctx->v[3]);
+    }
+    else
+    {
+        hash = ctx->seed + XXH_P5;
+    }
+
+    return xxh_finish(hash + ctx->total, ctx->buff, ctx->buff + ctx->buff_len);
+}
+
+/**
+ *\brief                        SHA-256块处理函数
+ *\param[in,out] state          中间散列值
+ *\param[in]    data            数据,整块
+ *\param[in]    blocks          块数
+ *\return                       无
+ */
+typedef void (*sha256_block_proc)(DWORD state[8], const UCHAR *data, size_t blocks);
+
+static const DWORD g_sha256_k[64] = {                                       ///< 轮常数
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define SHA_ROTR(x, r)          (((x) >> (r)) | ((x) << (32 - (r))))
+
+/**
+ *\brief                        逐项处理SHA-256块
+ *\param[in,out] state          中间散列值
+ *\param[in]    data            数据,整块
+ *\param[in]    blocks          块数
+ *\return                       无
+ */
+static void sha256_block_scalar(DWORD state[8], const UCHAR *data, size_t blocks)
+{
+    DWORD w[64];
+
+    for (; blocks > 0; blocks--, data += 64)
+    {
+        for (int i = 0; i < 16; i++)
+        {
+            w[i] = ((DWORD)data[i * 4] << 24) | ((DWORD)data[i * 4 + 1] << 16) |
+                   ((DWORD)data[i * 4 + 2] << 8) | data[i * 4 + 3];
+        }
+
+        for (int i = 16; i < 64; i++)
+        {
+            DWORD s0 = SHA_ROTR(w[i - 15], 7) ^ SHA_ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            DWORD s1 = SHA_ROTR(w[i - 2], 17) ^ SHA_ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        DWORD a = state[0], b = state[1], c = state[2], d = state[3];
+        DWORD e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (int i = 0; i < 64; i++)
+        {
+            DWORD t1 = h + (SHA_ROTR(e, 6) ^ SHA_ROTR(e, 11) ^ SHA_ROTR(e, 25)) + ((e & f) ^ (~e & g)) + g_sha256_k[i] + w[i];
+            DWORD t2 = (SHA_ROTR(a, 2) ^ SHA_ROTR(a, 13) ^ SHA_ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+}
+
+#ifdef SIMD_X86
+
+/**
+ *\brief                        用SHA扩展指令处理SHA-256块,每组4轮,消息扩展与轮计算交错
+ *\param[in,out] state          中间散列值
+ *\param[in]    data            数据,整块
+ *\param[in]    blocks          块数
+ *\return                       无
+ */
+SIMD_TARGET("sha,sse4.1,ssse3")
+static void sha256_block_ni(DWORD state[8], const UCHAR *data, size_t blocks)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL); // 每个DWORD转为大端
+
+    __m128i tmp    = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0xB1);        // CDAB
+    __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(state + 4)), 0x1B); // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);                                       // ABEF
+
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);                                            // CDGH
+
+    for (; blocks > 0; blocks--, data += 64)
+    {
+        __m128i abef = state0;
+        __m128i cdgh = state1;
+        __m128i msg[4];
+
+#ifdef __GNUC__
+#pragma GCC unroll 16
+#endif
+        for (int g = 0; g < 16; g++) // 循环次数固定,展开后msg在寄存器中
+        {
+            if (g < 4)
+            {
+                msg[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + g * 16)), mask);
+            }
+
+            __m128i m = _mm_add_epi32(msg[g & 3], _mm_loadu_si128((const __m128i*)(g_sha256_k + g * 4)));
+
+            state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+
+            if (g >= 3 && g < 15) // 下一组的消息
+            {
+                __m128i next = _mm_add_epi32(msg[(g + 1) & 3], _mm_alignr_epi8(msg[g & 3], msg[(g - 1) & 3], 4));
+
+                msg[(g + 1) & 3] = _mm_sha256msg2_epu32(next, msg[g & 3]);
+            }
+
+            state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(m, 0x0E));
+
+            if (g >= 1 && g < 13)
+            {
+                msg[(g - 1) & 3] = _mm_sha256msg1_epu32(msg[(g - 1) & 3], msg[g & 3]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abef);
+        state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp    = _mm_shuffle_epi32(state0, 0x1B);                                               // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);                                               // DCHG
+
+    _mm_storeu_si128((__m128i*)state, _mm_blend_epi16(tmp, state1, 0xF0));                  // DCBA
+    _mm_storeu_si128((__m128i*)(state + 4), _mm_alignr_epi8(state1, tmp, 8));               // HGFE
+}
+
+#endif
+
+static int g_sha256_impl = SIMD_SCALAR;                                     ///< 使用的实现,启动线程前用hash_sha256_use选择
+
+int hash_sha256_use(int impl)
+{
+    if (SIMD_AUTO == impl)
+    {
+        impl = simd_supported(SIMD_SHA) ? SIMD_SHA : SIMD_SCALAR;
+    }
+    else if ((SIMD_SCALAR != impl && SIMD_SHA != impl) || !simd_supported(impl))
+    {
+        return -1;
+    }
+
+    g_sha256_impl = impl;
+    return 0;
+}
+
+const char* hash_sha256_impl(void)
+{
+    return (SIMD_SHA == g_sha256_impl) ? "sha-ni" : "scalar";
+}
+
+/**
+ *\brief                        按选择的实现处理块
+ *\param[in,out] state          中间散列值
+ *\param[in]    data            数据,整块
+ *\param[in]    blocks          块数
+ *\return                       无
+ */
+static void sha256_block(DWORD state[8], const UCHAR *data, size_t blocks)
+{
+#ifdef SIMD_X86
+    if (SIMD_SHA == g_sha256_impl)
+    {
+        sha256_block_ni(state, data, blocks);
+        return;
+    }
+#endif
+
+    sha256_block_scalar(state, data, blocks);
+}
+
+void hash_sha256_init(PHASH_SHA256 ctx)
+{
+    static const DWORD init[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    memset(ctx, 0, sizeof(HASH_SHA256));
+    memcpy(ctx->state, init, sizeof(init));
+}
+
+void hash_sha256_update(PHASH_SHA256 ctx, const void *data, size_t len)
+{
+    const UCHAR *p = (const UCHAR*)data;
+
+    ctx->total += len;
+
+    if (ctx->buff_len > 0)
+    {
+        size_t n = 64 - ctx->buff_len;
+
+        n = (n < len) ? n : len;
+        memcpy(ctx->buff + ctx->buff_len, p, n);
+        ctx->buff_len += (DWORD)n;
+        p   += n;
+        len -= n;
+
+        if (ctx->buff_len < 64)
+        {
+            return;
+        }
+
+        sha256_block(ctx->state, ctx->buff, 1);
+        ctx->buff_len = 0;
+    }
+
+    if (len >= 64)
+    {
+        sha256_block(ctx->state, p, len / 64);
+        p   += len & ~(size_t)63;
+        len &= 63;
+    }
+
+    memcpy(ctx->buff, p, len);
+    ctx->buff_len = (DWORD)len;
+}
+
+void hash_sha256_final(PHASH_SHA256 ctx, UCHAR digest[HASH_SHA256_SIZE])
+{
+    ULONGLONG bits = ctx->total * 8;
+    UCHAR     pad[72] = { 0x80 };
+    size_t    n       = (ctx->buff_len < 56) ? 56 - ctx->buff_len : 120 - ctx->buff_len;
+
+    for (int i = 0; i < 8; i++) // 长度为大端
+    {
+        pad[n + i] = (UCHAR)(bits >> (56 - i * 8));
+    }
+
+    hash_sha256_update(ctx, pad, n + 8);
+
+    for (int i = 0; i < 8; i++)
+    {
+        digest[i * 4]     = (UCHAR)(ctx->state[i] >> 24);
+        digest[i * 4 + 1] = (UCHAR)(ctx->state[i] >> 16);
+        digest[i * 4 + 2] = (UCHAR)(ctx->state[i] >> 8);
+        digest[i * 4 + 3] = (UCHAR)ctx->state[i];
+    }
+}
+
+void hash_sha256(const void *data, size_t len, UCHAR digest[HASH_SHA256_SIZE])
+{
+    HASH_SHA256 ctx;
+
+    hash_sha256_init(&ctx);
+    hash_sha256_update(&ctx, data, len);
+    hash_sha256_final(&ctx, digest);
+}
+
+static const DWORD g_md5_k[64] = {                                          ///< 轮常数,floor(abs(sin(i+1))*2^32)
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+static const UCHAR g_md5_r[16] = {                                          ///< 每轮4步的循环左移位数
+    7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21
+};
+
+#define MD5_ROTL(x, r)          (((x) << (r)) | ((x) >> (32 - (r))))
+
+/**
+ *\brief                        处理MD5块
+ *\param[in,out] state          中间散列值
+ *\param[in]    data            数据,整块
+ *\param[in]    blocks          块数
+ *\return                       无
+ */
+static void md5_block(DWORD state[4], const UCHAR *data, size_t blocks)
+{
+    DWORD m[16];
+
+    for (; blocks > 0; blocks--, data += 64)
+    {
+        DWORD a = state[0];
+        DWORD b = state[1];
+        DWORD c = state[2];
+        DWORD d = state[3];
+
+        for (int i = 0; i < 16; i++)
+        {
+            m[i] = le32(data + i * 4);
+        }
+
+        for (int i = 0; i < 64; i++)
+        {
+            DWORD f;
+            int   g;
+
+            if (i < 16)
+            {
+                f = d ^ (b & (c ^ d));
+                g = i;
+            }
+            else if (i < 32)
+            {
+                f = c ^ (d & (b ^ c));
+                g = (5 * i + 1) & 15;
+            }
+            else if (i < 48)
+            {
+                f = b ^ c ^ d;
+                g = (3 * i + 5) & 15;
+            }
+            else
+            {
+                f = c ^ (b | ~d);
+                g = (7 * i) & 15;
+            }
+
+            f = a + f + g_md5_k[i] + m[g];
+            a = d;
+            d = c;
+            c = b;
+            b = b + MD5_ROTL(f, g_md5_r[(i >> 4) * 4 + (i & 3)]);
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+    }
+}
+
+void hash_md5_init(PHASH_MD5 ctx)
+{
+    memset(ctx, 0, sizeof(HASH_MD5));
+    ctx->state[0] = 0x67452301;
+    ctx->state[1] = 0xefcdab89;
+    ctx->state[2] = 0x98badcfe;
+    ctx->state[3] = 0x10325476;
+}
+
+void hash_md5_update(PHASH_MD5 ctx, const void *data, size_t len)
+{
+    const UCHAR *p = (const UCHAR*)data;
+
+    ctx->total += len;
+
+    if (ctx->buff_len > 0)
+    {
+        size_t n = 64 - ctx->buff_len;
+
+        n = (n < len) ? n : len;
+        memcpy(ctx->buff + ctx->buff_len, p, n);
+        ctx->buff_len += (DWORD)n;
+        p   += n;
+        len -= n;
+
+        if (ctx->buff_len < 64)
+        {
+            return;
+        }
+
+        md5_block(ctx->state, ctx->buff, 1);
+        ctx->buff_len = 0;
+    }
+
+    if (len >= 64)
+    {
+        md5_block(ctx->state, p, len / 64);
+        p   += len & ~(size_t)63;
+        len &= 63;
+    }
+
+    memcpy(ctx->buff, p, len);
+    ctx->buff_len = (DWORD)len;
+}
+
+void hash_md5_final(PHASH_MD5 ctx, UCHAR digest[HASH_MD5_SIZE])
+{
+    ULONGLONG bits = ctx->total * 8;
+    UCHAR     pad[72] = { 0x80 };
+    size_t    n       = (ctx->buff_len < 56) ? 56 - ctx->buff_len : 120 - ctx->buff_len;
+
+    for (int i = 0; i < 8; i++) // 长度为小端
+    {
+        pad[n + i] = (UCHAR)(bits >> (i * 8));
+    }
+
+    hash_md5_update(ctx, pad, n + 8);
+
+    for (int i = 0; i < 4; i++)
+    {
+        digest[i * 4]     = (UCHAR)ctx->state[i];
+        digest[i * 4 + 1] = (UCHAR)(ctx->state[i] >> 8);
+        digest[i * 4 + 2] = (UCHAR)(ctx->state[i] >> 16);
+        digest[i * 4 + 3] = (UCHAR)(ctx->state[i] >> 24);
+    }
+}
+
+void hash_md5(const void *data, size_t len, UCHAR digest[HASH_MD5_SIZE])
+{
+    HASH_MD5 ctx;
+
+    hash_md5_init(&ctx);
+    hash_md5_update(&ctx, data, len);
+    hash_md5_final(&ctx, digest);
+}
+
+#define SHA1_ROTL(x, r)         (((x) << (r)) | ((x) >> (32 - (r))))
+
+/**
+ *\brief                        处理SHA-1块
+ *\param[in,out] state          中间散列值
+ *\param[in]    data            数据,整块
+ *\param[in]    blocks          块数
+ *\return                       无
+ */
+static void sha1_block(DWORD state[5], const UCHAR *data, size_t blocks)
+{
+    DWORD w[16];
+
+    for (; blocks > 0; blocks--, data += 64)
+    {
+        DWORD a = state[0];
+        DWORD b = state[1];
+        DWORD c = state[2];
+        DWORD d = state[3];
+        DWORD e = state[4];
+
+        for (int i = 0; i < 16; i++) // 大端
+        {
+            w[i] = ((DWORD)data[i * 4] << 24) | ((DWORD)data[i * 4 + 1] << 16) | ((DWORD)data[i * 4 + 2] << 8) | data[i * 4 + 3];
+        }
+
+        for (int i = 0; i < 80; i++)
+        {
+            DWORD f;
+            DWORD k;
+
+            if (i >= 16) // 只保留16项,按位置循环使用
+            {
+                w[i & 15] = SHA1_ROTL(w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15], 1);
+            }
+
+            if (i < 20)
+            {
+                f = d ^ (b & (c ^ d));
+                k = 0x5a827999;
+            }
+            else if (i < 40)
+            {
+                f = b ^ c ^ d;
+                k = 0x6ed9eba1;
+            }
+            else if (i < 60)
+            {
+                f = (b & c) | (d & (b | c));
+                k = 0x8f1bbcdc;
+            }
+            else
+            {
+                f = b ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+
+            f = SHA1_ROTL(a, 5) + f + e + k + w[i & 15];
+            e = d;
+            d = c;
+            c = SHA1_ROTL(b, 30);
+            b = a;
+            a = f;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+}
+
+void hash_sha1_init(PHASH_SHA1 ctx)
+{
+    memset(ctx, 0, sizeof(HASH_SHA1));
+    ctx->state[0] = 0x67452301;
+    ctx->state[1] = 0xefcdab89;
+    ctx->state[2] = 0x98badcfe;
+    ctx->state[3] = 0x10325476;
+    ctx->state[4] = 0xc3d2e1f0;
+}
+
+void hash_sha1_update(PHASH_SHA1 ctx, const void *data, size_t len)
+{
+    const UCHAR *p = (const UCHAR*)data;
+
+    ctx->total += len;
+
+    if (ctx->buff_len > 0)
+    {
+        size_t n = 64 - ctx->buff_len;
+
+        n = (n < len) ? n : len;
+        memcpy(ctx->buff + ctx->buff_len, p, n);
+        ctx->buff_len += (DWORD)n;
+        p   += n;
+        len -= n;
+
+        if (ctx->buff_len < 64)
+        {
+            return;
+        }
+
+        sha1_block(ctx->state, ctx->buff, 1);
+        ctx->buff_len = 0;
+    }
+
+    if (len >= 64)
+    {
+        sha1_block(ctx->state, p, len / 64);
+        p   += len & ~(size_t)63;
+        len &= 63;
+    }
+
+    memcpy(ctx->buff, p, len);
+    ctx->buff_len = (DWORD)len;
+}
+
+void hash_sha1_final(PHASH_SHA1 ctx, UCHAR digest[HASH_SHA1_SIZE])
+{
+    ULONGLONG bits = ctx->total * 8;
+    UCHAR     pad[72] = { 0x80 };
+    size_t    n       = (ctx->buff_len < 56) ? 56 - ctx->buff_len : 120 - ctx->buff_len;
+
+    for (int i = 0; i < 8; i++) // 长度为大端
+    {
+        pad[n + i] = (UCHAR)(bits >> (56 - i * 8));
+    }
+
+    hash_sha1_update(ctx, pad, n + 8);
+
+    for (int i = 0; i < 5; i++)
+    {
+        digest[i * 4]     = (UCHAR)(ctx->state[i] >> 24);
+        digest[i * 4 + 1] = (UCHAR)(ctx->state[i] >> 16);
+        digest[i * 4 + 2] = (UCHAR)(ctx->state[i] >> 8);
+        digest[i * 4 + 3] = (UCHAR)ctx->state[i];
+    }
+}
+
+void hash_sha1(const void *data, size_t len, UCHAR digest[HASH_SHA1_SIZE])
+{
+    HASH_SHA1 ctx;
+
+    hash_sha1_init(&ctx);
+    hash_sha1_update(&ctx, data, len);
+    hash_sha1_final(&ctx, digest);
+}
@@ -0,0 +1,209 @@
+/**
+ *\file     hash.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    文件内容散列,XXH64用于判断文件内容是否变化,不用于安全校验;SHA-256用于输出节的摘要.
+ *          两种散列都可以分段输入,与一次输入整段数据的结果相同
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加分段输入的XXH64和SHA-256
+ *          2026.10.18|增加MD5,用于导入表散列和Rich头散列,与其它工具的结果比较
+ *          2026.10.18|增加SHA-1,用于Authenticode摘要
+ *          2026.10.18|没有选择SHA-256实现时用标量实现
+ */
+#ifndef _HASH_H_
+#define _HASH_H_
+
+#include <stddef.h>
+#include "platform.h"
+#include "simd.h"
+
+/**
+ *\brief                        XXH64散列,与xxHash的XXH64结果相同
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\param[in]    seed            种子
+ *\return                       散列值
+ */
+ULONGLONG hash_xxh64(const void *data, size_t len, ULONGLONG seed);
+
+#define HASH_SHA256_SIZE        32                                          ///< SHA-256摘要长度
+#define HASH_MD5_SIZE           16                                          ///< MD5摘要长度
+#define HASH_SHA1_SIZE          20                                          ///< SHA-1摘要长度
+
+typedef struct _HASH_XXH64                                                  ///  分段输入的XXH64状态
+{
+    ULONGLONG       v[4];                                                   ///< 4路累加值
+    ULONGLONG       seed;                                                   ///< 种子
+    ULONGLONG       total;                                                  ///< 已输入的长度
+    UCHAR           buff[32];                                               ///< 不满32字节的剩余数据
+    DWORD           buff_len;                                               ///< 剩余数据长度
+
+} HASH_XXH64, *PHASH_XXH64;
+
+typedef struct _HASH_SHA256                                                 ///  SHA-256状态
+{
+    DWORD           state[8];                                               ///< 中间散列值
+    ULONGLONG       total;                                                  ///< 已输入的长度
+    UCHAR           buff[64];                                               ///< 不满一块的剩余数据
+    DWORD           buff_len;                                               ///< 剩余数据长度
+
+} HASH_SHA256, *PHASH_SHA256;
+
+typedef struct _HASH_MD5                                                    ///  MD5状态
+{
+    DWORD           state[4];                                               ///< 中间散列值
+    ULONGLONG       total;                                                  ///< 已输入的长度
+    UCHAR           buff[64];                                               ///< 不满一块的剩余数据
+    DWORD           buff_len;                                               ///< 剩余数据长度
+
+} HASH_MD5, *PHASH_MD5;
+
+typedef struct _HASH_SHA1                                                   ///  SHA-1状态
+{
+    DWORD           state[5];                                               ///< 中间散列值
+    ULONGLONG       total;                                                  ///< 已输入的长度
+    UCHAR           buff[64];                                               ///< 不满一块的剩余数据
+    DWORD           buff_len;                                               ///< 剩余数据长度
+
+} HASH_SHA1, *PHASH_SHA1;
+
+/**
+ *\brief                        开始分段计算XXH64
+ *\param[out]   ctx             状态
+ *\param[in]    seed            种子
+ *\return                       无
+ */
+void hash_xxh64_init(PHASH_XXH64 ctx, ULONGLONG seed);
+
+/**
+ *\brief                        输入一段数据
+ *\param[in]    ctx             状态
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\return                       无
+ */
+void hash_xxh64_update(PHASH_XXH64 ctx, const void *data, size_t len);
+
+/**
+ *\brief                        得到散列值,与hash_xxh64一次输入所有数据的结果相同
+ *\param[in]    ctx             状态
+ *\return                       散列值
+ */
+ULONGLONG hash_xxh64_final(PHASH_XXH64 ctx);
+
+/**
+ *\brief                        开始计算SHA-256
+ *\param[out]   ctx             状态
+ *\return                       无
+ */
+void hash_sha256_init(PHASH_SHA256 ctx);
+
+/**
+ *\brief                        输入一段数据,整块直接从data处理,不复制
+ *\param[in]    ctx             状态
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\return                       无
+ */
+void hash_sha256_update(PHASH_SHA256 ctx, const void *data, size_t len);
+
+/**
+ *\brief                        得到摘要
+ *\param[in]    ctx             状态
+ *\param[out]   digest          HASH_SHA256_SIZE字节摘要
+ *\return                       无
+ */
+void hash_sha256_final(PHASH_SHA256 ctx, UCHAR digest[HASH_SHA256_SIZE]);
+
+/**
+ *\brief                        计算一段数据的SHA-256
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\param[out]   digest          HASH_SHA256_SIZE字节摘要
+ *\return                       无
+ */
+void hash_sha256(const void *data, size_t len, UCHAR digest[HASH_SHA256_SIZE]);
+
+/**
+ *\brief                        指定SHA-256的块处理实现,不是线程安全的,在启动线程前调用,没有调用时用标量实现
+ *\param[in]    impl            SIMD_AUTO,SIMD_SCALAR,SIMD_SHA
+ *\return                       0-成功,-1-CPU不支持
+ */
+int hash_sha256_use(int impl);
+
+/**
+ *\brief                        得到当前使用的SHA-256实现的名称
+ *\return                       scalar,sha-ni
+ */
+const char* hash_sha256_impl(void);
+
+/**
+ *\brief                        开始计算MD5
+ *\param[out]   ctx             状态
+ *\return                       无
+ */
+void hash_md5_init(PHASH_MD5 ctx);
+
+/**
+ *\brief                        输入一段数据,可以多次输入很短的数据
+ *\param[in]    ctx             状态
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\return                       无
+ */
+void hash_md5_update(PHASH_MD5 ctx, const void *data, size_t len);
+
+/**
+ *\brief                        得到摘要
+ *\param[in]    ctx             状态
+ *\param[out]   digest          HASH_MD5_SIZE字节摘要
+ *\return                       无
+ */
+void hash_md5_final(PHASH_MD5 ctx, UCHAR digest[HASH_MD5_SIZE]);
+
+/**
+ *\brief                        计算一段数据的MD5
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\param[out]   digest          HASH_MD5_SIZE字节摘要
+ *\return                       无
+ */
+void hash_md5(const void *data, size_t len, UCHAR digest[HASH_MD5_SIZE]);
+
+/**
+ *\brief                        开始计算SHA-1
+ *\param[out]   ctx             状态
+ *\return                       无
+ */
+void hash_sha1_init(PHASH_SHA1 ctx);
+
+/**
+ *\brief                        输入一段数据,整块直接从data处理,不复制
+ *\param[in]    ctx             状态
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\return                       无
+ */
+void hash_sha1_update(PHASH_SHA1 ctx, const void *data, size_t len);
+
+/**
+ *\brief                        得到摘要
+ *\param[in]    ctx             状态
+ *\param[out]   digest          HASH_SHA1_SIZE字节摘要
+ *\return                       无
+ */
+void hash_sha1_final(PHASH_SHA1 ctx, UCHAR digest[HASH_SHA1_SIZE]);
+
+/**
+ *\brief                        计算一段数据的SHA-1
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\param[out]   digest          HASH_SHA1_SIZE字节摘要
+ *\return                       无
+ */
+void hash_sha1(const void *data, size_t len, UCHAR digest[HASH_SHA1_SIZE]);
+
+#endif
@@ -0,0 +1,1235 @@
+/**
+ *\file     pe.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    PE文件解析实现,与界面无关
+ *          时间|事件
+ *          -|-
+ *          2022.02.06|创建文件
+ *          2024.06.23|添加Doxygen注释
+ *          2026.10.18|从main.c中分离,输出改为PE_TREE回调
+ *          2026.10.18|解析结果保存到PE_IMAGE,树形输出移到pe_tree.c
+ *          2026.10.18|节查找改为按相对虚拟地址排序的索引二分查找
+ *          2026.10.18|通过有界视图读取文件数据,出错时记录结构化错误
+ *          2026.10.18|支持PE32+,OPTION头和导入函数按位宽在编译时特化
+ *          2026.10.18|增加导出函数查找,按名称二分查找,按序号直接取,识别转发
+ *          2026.10.18|解析结构从内存池分配,pe_free一次释放;可以填写驻留的导入名称
+ *          2026.10.18|各部分分阶段计时和计数
+ *          2026.10.18|导入表到库名称或输入地址表为0的描述为止;增加延迟导入表和绑定导入表,与导入表共用一个库列表
+ *          2026.10.18|头部和节表的解析分出pe_parse_head
+ */
+#include "pe.h"
+#include "pe_str.h"
+#include "pe_stat.h"
+
+/// 解析结构使用的内存池
+#define ARENA(image)            ((NULL != (image)->pool) ? (image)->pool : &(image)->arena)
+
+/**
+ *\brief                        记录解析错误,只保留第一个
+ *\param[in]    image           解析结果
+ *\param[in]    code            错误码
+ *\param[in]    part            出错的部分
+ *\param[in]    fa              出错的结构在文件中的位置
+ *\return                       code
+ */
+static int parse_error(PPE_IMAGE image, int code, const char *part, DWORD fa)
+{
+    if (0 == image->error.count++)
+    {
+        image->error.code = code;
+        image->error.part = part;
+        image->error.fa   = fa;
+    }
+
+    return code;
+}
+
+const char* pe_error_string(int code)
+{
+    switch (code)
+    {
+        case PE_OK:                 return "ok";
+        case PE_ERR_NOT_MZ:         return "not-mz";
+        case PE_ERR_NT_RANGE:       return "nt-range";
+        case PE_ERR_NOT_PE:         return "not-pe";
+        case PE_ERR_UNSUPPORTED:    return "unsupported";
+        case PE_ERR_MEMORY:         return "memory";
+        case PE_ERR_RELOC_SECTION:  return "reloc-section";
+        case PE_ERR_RANGE:          return "range";
+        case PE_ERR_RVA:            return "rva";
+        case PE_ERR_FORMAT:         return "format";
+        default:                    return "unknown";
+    }
+}
+
+int pe_check(UCHAR *buff, size_t size)
+{
+    PE_VIEW view = { buff, size };
+
+    if (!VIEW_HAS(&view, 0, sizeof(IMAGE_DOS_HEADER)) || buff[0] != 'M' || buff[1] != 'Z')
+    {
+        return PE_ERR_NOT_MZ;
+    }
+
+    LONG lfanew = (LONG)VIEW_FIELD32(buff, IMAGE_DOS_HEADER, e_lfanew);
+
+    if (lfanew < 0 || !VIEW_HAS(&view, lfanew, offsetof(IMAGE_NT_HEADERS32, OptionalHeader) + sizeof(WORD)))
+    {
+        return PE_ERR_NT_RANGE;
+    }
+
+    UCHAR *nt    = buff + lfanew;
+    WORD   magic = VIEW_FIELD16(nt, IMAGE_NT_HEADERS32, OptionalHeader.Magic);
+
+    if (IMAGE_NT_SIGNATURE != VIEW_FIELD32(nt, IMAGE_NT_HEADERS32, Signature))
+    {
+        return PE_ERR_NOT_PE;
+    }
+
+    if (PE_MAGIC_32 != magic && PE_MAGIC_64 != magic)
+    {
+        return PE_ERR_UNSUPPORTED;
+    }
+
+    size_t nt_size = (PE_MAGIC_64 == magic) ? sizeof(IMAGE_NT_HEADERS64) : sizeof(IMAGE_NT_HEADERS32);
+
+    if (!VIEW_HAS(&view, lfanew, nt_size))
+    {
+        return PE_ERR_NT_RANGE;
+    }
+
+    return PE_OK;
+}
+
+int pe_section_find_linear(PPE_IMAGE image, DWORD rva)
+{
+    PPE_SECTION section = image->section;
+
+    if (0 == image->section_align)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < image->section_count; i++)
+    {
+        DWORD size = (section->virtual_size + image->section_align - 1) /
+                      image->section_align *
+                      image->section_align; // 取整
+
+        if (rva >= section->virtual_address && rva <= (section->virtual_address + size - 1))
+        {
+            return i;
+        }
+
+        section++;
+    }
+
+    return -1;
+}
+
+/**
+ *\brief                        在索引中二分查找相对虚拟地址
+ *\param[in]    image           解析结果
+ *\param[in]    rva             相对虚拟地址
+ *\return                       索引项,NULL为没有找到
+ */
+static PPE_RVA_INDEX index_find(PPE_IMAGE image, DWORD rva)
+{
+    int low  = 0;
+    int high = image->index_count; // 查找第一个start大于rva的项
+
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+
+        if (image->index[mid].start <= rva)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    if (0 == low || rva > image->index[low - 1].last)
+    {
+        return NULL;
+    }
+
+    return &image->index[low - 1];
+}
+
+int pe_section_find(PPE_IMAGE image, DWORD rva)
+{
+    if (image->index_linear)
+    {
+        return pe_section_find_linear(image, rva);
+    }
+
+    PPE_RVA_INDEX index = index_find(image, rva);
+
+    return (NULL != index) ? index->section : -1;
+}
+
+int pe_rva_to_fa(PPE_IMAGE image, DWORD rva, DWORD *fa)
+{
+    if (image->index_linear)
+    {
+        int id = pe_section_find_linear(image, rva);
+
+        if (id >= 0)
+        {
+            *fa = image->section[id].raw_fa + rva - image->section[id].virtual_address;
+        }
+
+        return id;
+    }
+
+    PPE_RVA_INDEX index = index_find(image, rva);
+
+    if (NULL == index)
+    {
+        return -1;
+    }
+
+    *fa = rva + index->delta;
+    return index->section;
+}
+
+char* pe_section_name(PPE_IMAGE image, int id, char *name)
+{
+    memcpy(name, image->view.data + image->section[id].fa, IMAGE_SIZEOF_SHORT_NAME); // 节名可能没有结尾
+    name[IMAGE_SIZEOF_SHORT_NAME] = '\0';
+    return name;
+}
+
+/**
+ *\brief                        索引项排序比较函数,start相同时按节序号
+ *\param[in]    a               索引项
+ *\param[in]    b               索引项
+ *\return                       <0,0,>0
+ */
+static int index_compare(const void *a, const void *b)
+{
+    PPE_RVA_INDEX x = (PPE_RVA_INDEX)a;
+    PPE_RVA_INDEX y = (PPE_RVA_INDEX)b;
+
+    if (x->start != y->start)
+    {
+        return (x->start < y->start) ? -1 : 1;
+    }
+
+    return x->section - y->section;
+}
+
+/**
+ *\brief                        建立相对虚拟地址索引,对齐后的结束地址和文件位置差只计算一次
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int parse_index(PPE_IMAGE image)
+{
+    if (0 == image->section_align || 0 == image->section_count)
+    {
+        return 0; // 找不到任何节
+    }
+
+    image->index = pe_arena_array(ARENA(image), image->section_count, sizeof(PE_RVA_INDEX));
+
+    if (NULL == image->index)
+    {
+        return parse_error(image, PE_ERR_MEMORY, "section", 0);
+    }
+
+    for (int i = 0; i < image->section_count; i++)
+    {
+        PPE_SECTION section = &image->section[i];
+
+        DWORD size = (section->virtual_size + image->section_align - 1) /
+                      image->section_align *
+                      image->section_align; // 取整,与线性查找的计算相同
+
+        DWORD last = section->virtual_address + size - 1;
+
+        if (last < section->virtual_address)
+        {
+            continue; // 空节,任何地址都不在其中
+        }
+
+        PPE_RVA_INDEX index = &image->index[image->index_count++];
+
+        index->start   = section->virtual_address;
+        index->last    = last;
+        index->delta   = section->raw_fa - section->virtual_address;
+        index->section = i;
+    }
+
+    qsort(image->index, image->index_count, sizeof(PE_RVA_INDEX), index_compare);
+
+    for (int i = 1; i < image->index_count; i++)
+    {
+        if (image->index[i].start <= image->index[i - 1].last)
+        {
+            image->index_linear = 1; // 范围重叠时以节头顺序为准
+            break;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ *\brief                        解析节头,超出文件的节头不解析
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int parse_section(PPE_IMAGE image)
+{
+    PPE_VIEW view  = &image->view;
+    DWORD    fa    = image->opt_fa + image->opt_size; // 第1个段头在exe文件中的位置
+    int      count = VIEW_FIELD16(view->data + image->file_fa, IMAGE_FILE_HEADER, NumberOfSections);
+
+    if (!VIEW_HAS(view, fa, (ULONGLONG)count * sizeof(IMAGE_SECTION_HEADER)))
+    {
+        parse_error(image, PE_ERR_RANGE, "section", fa);
+        count = (fa < view->size) ? (int)((view->size - fa) / sizeof(IMAGE_SECTION_HEADER)) : 0;
+    }
+
+    image->section_count = count;
+    image->section       = pe_arena_array(ARENA(image), image->section_count + 1, sizeof(PE_SECTION));
+
+    if (NULL == image->section)
+    {
+        image->section_count = 0;
+        return parse_error(image, PE_ERR_MEMORY, "section", fa);
+    }
+
+    for (int i = 0; i < image->section_count; i++)
+    {
+        PPE_SECTION section     = &image->section[i];
+        UCHAR      *header      = view->data + fa;
+
+        section->fa              = fa;
+        section->virtual_size    = VIEW_FIELD32(header, IMAGE_SECTION_HEADER, Misc.VirtualSize);
+        section->virtual_address = VIEW_FIELD32(header, IMAGE_SECTION_HEADER, VirtualAddress);
+        section->raw_size        = VIEW_FIELD32(header, IMAGE_SECTION_HEADER, SizeOfRawData);
+        section->raw_fa          = VIEW_FIELD32(header, IMAGE_SECTION_HEADER, PointerToRawData);
+        section->characteristics = VIEW_FIELD32(header, IMAGE_SECTION_HEADER, Characteristics);
+
+        fa += sizeof(IMAGE_SECTION_HEADER);
+    }
+
+    return parse_index(image);
+}
+
+/**
+ *\brief                        检查导出表中的数组,超出文件时数量减少到文件内的部分
+ *\param[in]    image           解析结果
+ *\param[in]    rva             数组的相对虚拟地址
+ *\param[in]    size            数组元素长度
+ *\param[out]   fa              数组在文件中的位置
+ *\param[in,out]count           数组元素数量
+ *\return                       无
+ */
+static void parse_export_array(PPE_IMAGE image, DWORD rva, DWORD size, DWORD *fa, DWORD *count)
+{
+    if (0 == *count)
+    {
+        return;
+    }
+
+    if (pe_rva_to_fa(image, rva, fa) < 0)
+    {
+        parse_error(image, PE_ERR_RVA, "export", image->export.fa);
+        *count = 0;
+    }
+    else if (!VIEW_HAS(&image->view, *fa, (ULONGLONG)*count * size))
+    {
+        parse_error(image, PE_ERR_RANGE, "export", *fa);
+        *count = (*fa < image->view.size) ? (DWORD)((image->view.size - *fa) / size) : 0;
+    }
+}
+
+/**
+ *\brief                        解析导出表
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int parse_export(PPE_IMAGE image)
+{
+    PPE_EXPORT export = &image->export;
+    DWORD      va     = image->dir[PE_DIR_EXPORT].VirtualAddress;
+
+    image->export_section = -1;
+
+    if (0 == va)
+    {
+        return 0; // 没有导出表
+    }
+
+    int id = pe_rva_to_fa(image, va, &export->fa); // 一般在.edata
+
+    if (id < 0)
+    {
+        return 0;
+    }
+
+    if (!VIEW_HAS(&image->view, export->fa, sizeof(IMAGE_EXPORT_DIRECTORY)))
+    {
+        return parse_error(image, PE_ERR_RANGE, "export", export->fa);
+    }
+
+    UCHAR *dir = image->view.data + export->fa;
+
+    image->export_section = id;
+    export->base       = VIEW_FIELD32(dir, IMAGE_EXPORT_DIRECTORY, Base);
+    export->func_count = VIEW_FIELD32(dir, IMAGE_EXPORT_DIRECTORY, NumberOfFunctions);
+    export->name_count = VIEW_FIELD32(dir, IMAGE_EXPORT_DIRECTORY, NumberOfNames);
+    export->func_rva   = VIEW_FIELD32(dir, IMAGE_EXPORT_DIRECTORY, AddressOfFunctions);
+    export->names_rva  = VIEW_FIELD32(dir, IMAGE_EXPORT_DIRECTORY, AddressOfNames);
+    export->ords_rva   = VIEW_FIELD32(dir, IMAGE_EXPORT_DIRECTORY, AddressOfNameOrdinals);
+
+    DWORD ords_count   = export->name_count;
+
+    pe_rva_to_fa(image, VIEW_FIELD32(dir, IMAGE_EXPORT_DIRECTORY, Name), &export->name_fa);
+    parse_export_array(image, export->func_rva,  sizeof(DWORD), &export->func_fa,  &export->func_count);
+    parse_export_array(image, export->names_rva, sizeof(DWORD), &export->names_fa, &export->name_count);
+    parse_export_array(image, export->ords_rva,  sizeof(WORD),  &export->ords_fa,  &ords_count);
+
+    if (ords_count < export->name_count)
+    {
+        export->name_count = ords_count; // 名称表与序号表一一对应
+    }
+
+    return 0;
+}
+
+typedef PPE_IMPORT_FUNC (*parse_thunk_proc)(PPE_IMAGE image, DWORD rva, ULONGLONG base, int names, DWORD *count); ///< 解析导入函数列表
+
+#define PE_FUNC(name)           name##32
+#define PE_OPT_HEADER           IMAGE_OPTIONAL_HEADER32
+#define PE_THUNK                DWORD
+#define PE_THUNK_READ(p)        le32(p)
+#define PE_ORDINAL_FLAG         0x80000000UL
+#include "pe_width.h"
+#undef  PE_FUNC
+#undef  PE_OPT_HEADER
+#undef  PE_THUNK
+#undef  PE_THUNK_READ
+#undef  PE_ORDINAL_FLAG
+
+#define PE_FUNC(name)           name##64
+#define PE_OPT_HEADER           IMAGE_OPTIONAL_HEADER64
+#define PE_THUNK                ULONGLONG
+#define PE_THUNK_READ(p)        le64(p)
+#define PE_ORDINAL_FLAG         0x8000000000000000ULL
+#include "pe_width.h"
+#undef  PE_FUNC
+#undef  PE_OPT_HEADER
+#undef  PE_THUNK
+#undef  PE_THUNK_READ
+#undef  PE_ORDINAL_FLAG
+
+/**
+ *\brief                        填写导入库和输入名称表中函数的驻留名称,与输出时相同,最多PE_INTERN_NAME_MAX字节
+ *\param[in]    image           解析结果
+ *\param[in]    lib             导入库
+ *\return                       无
+ */
+static void intern_import(PPE_IMAGE image, PPE_IMPORT_LIB lib)
+{
+    PE_STR str;
+
+    pe_str_view(&image->view, lib->name_fa, PE_INTERN_NAME_MAX, &str);
+    lib->name = pe_intern(image->intern, str.data, str.len, str.flags);
+
+    for (DWORD i = 0; i < lib->func_count; i++)
+    {
+        PPE_IMPORT_FUNC func = &lib->func[i];
+
+        if (!func->by_ordinal)
+        {
+            pe_str_view(&image->view, func->name_fa ? func->name_fa + 2 : 0, PE_INTERN_NAME_MAX, &str);
+            func->name = pe_intern(image->intern, str.data, str.len, str.flags);
+        }
+    }
+}
+
+/**
+ *\brief                        找到导入表,数一下库描述的数量.与系统加载器相同,到库名称或输入地址表为0的描述为止,
+ *                              输入名称表为0的描述也是有效的,函数取输入地址表
+ *\param[in]    image           解析结果
+ *\return                       库描述数量
+ */
+static DWORD import_static_count(PPE_IMAGE image)
+{
+    PPE_VIEW view  = &image->view;
+    DWORD    va    = image->dir[PE_DIR_IMPORT].VirtualAddress;
+    DWORD    count = 0;
+
+    if (0 == va || (image->import_section = pe_rva_to_fa(image, va, &image->import_fa)) < 0) // 一般在.rdata
+    {
+        return 0; // 没有导入表
+    }
+
+    // 一次算出文件内最多的库描述数量,循环中不再检查
+    ULONGLONG max    = (image->import_fa < view->size) ?
+                       (view->size - image->import_fa) / sizeof(IMAGE_IMPORT_DESCRIPTOR) : 0;
+    UCHAR    *import = view->data + image->import_fa;
+
+    while (count < max &&
+           0 != VIEW_FIELD32(import + count * sizeof(IMAGE_IMPORT_DESCRIPTOR), IMAGE_IMPORT_DESCRIPTOR, Name) &&
+           0 != VIEW_FIELD32(import + count * sizeof(IMAGE_IMPORT_DESCRIPTOR), IMAGE_IMPORT_DESCRIPTOR, FirstThunk))
+    {
+        count++;
+    }
+
+    if (count == max)
+    {
+        parse_error(image, PE_ERR_RANGE, "import", image->import_fa); // 没有结尾的空描述
+    }
+
+    return count;
+}
+
+/**
+ *\brief                        找到延迟导入表,数一下库描述的数量,到库名称为0的描述为止
+ *\param[in]    image           解析结果
+ *\return                       库描述数量
+ */
+static DWORD import_delay_count(PPE_IMAGE image)
+{
+    PPE_VIEW view  = &image->view;
+    DWORD    va    = image->dir[PE_DIR_DELAY].VirtualAddress;
+    DWORD    count = 0;
+
+    if (0 == va || (image->delay_section = pe_rva_to_fa(image, va, &image->delay_fa)) < 0)
+    {
+        return 0; // 没有延迟导入表
+    }
+
+    ULONGLONG max   = (image->delay_fa < view->size) ?
+                      (view->size - image->delay_fa) / sizeof(IMAGE_DELAYLOAD_DESCRIPTOR) : 0;
+    UCHAR    *delay = view->data + image->delay_fa;
+
+    while (count < max &&
+           0 != VIEW_FIELD32(delay + count * sizeof(IMAGE_DELAYLOAD_DESCRIPTOR), IMAGE_DELAYLOAD_DESCRIPTOR, DllNameRVA))
+    {
+        count++;
+    }
+
+    if (count == max)
+    {
+        parse_error(image, PE_ERR_RANGE, "delay", image->delay_fa);
+    }
+
+    return count;
+}
+
+/**
+ *\brief                        找到绑定导入表,数一下描述和转发引用的数量,到全0的描述或数据目录的结尾为止.
+ *                              绑定导入表一般在节表后面的文件头中,不在任何节中
+ *\param[in]    image           解析结果
+ *\return                       描述和转发引用的数量
+ */
+static DWORD import_bound_count(PPE_IMAGE image)
+{
+    PPE_VIEW view  = &image->view;
+    DWORD    va    = image->dir[PE_DIR_BOUND].VirtualAddress;
+    DWORD    count = 0;
+
+    if (0 == va)
+    {
+        return 0; // 没有绑定导入表
+    }
+
+    image->bound_section = pe_rva_to_fa(image, va, &image->bound_fa);
+
+    if (image->bound_section < 0)
+    {
+        for (int i = 0; i < image->section_count; i++)
+        {
+            if (va >= image->section[i].virtual_address)
+            {
+                return 0; // 不在文件头中
+            }
+        }
+
+        image->bound_section = PE_SECTION_HEAD;
+        image->bound_fa      = va;
+    }
+
+    ULONGLONG size  = (image->bound_fa < view->size) ? view->size - image->bound_fa : 0;
+    ULONGLONG max   = ((size < image->dir[PE_DIR_BOUND].Size) ? size : image->dir[PE_DIR_BOUND].Size) /
+                      sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR);
+    UCHAR    *bound = view->data + image->bound_fa;
+
+    while (count < max)
+    {
+        UCHAR *desc = bound + count * sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR);
+        DWORD  refs = VIEW_FIELD16(desc, IMAGE_BOUND_IMPORT_DESCRIPTOR, NumberOfModuleForwarderRefs);
+
+        if (0 == VIEW_FIELD32(desc, IMAGE_BOUND_IMPORT_DESCRIPTOR, TimeDateStamp) &&
+            0 == VIEW_FIELD16(desc, IMAGE_BOUND_IMPORT_DESCRIPTOR, OffsetModuleName))
+        {
+            break;
+        }
+
+        if (refs >= max - count) // 转发引用超出数据目录,不要这个描述
+        {
+            parse_error(image, PE_ERR_RANGE, "bound", image->bound_fa + count * sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR));
+            break;
+        }
+
+        count += 1 + refs;
+    }
+
+    return count;
+}
+
+/**
+ *\brief                        解析导入表中的库
+ *\param[in]    image           解析结果
+ *\param[in]    lib             导入库,已清0
+ *\param[in]    fa              库描述在文件中的位置
+ *\return                       无
+ */
+static void parse_import_static(PPE_IMAGE image, PPE_IMPORT_LIB lib, DWORD fa)
+{
+    // 每个库选一次,函数列表的循环中不判断位宽
+    parse_thunk_proc parse_thunk = (PE_MAGIC_64 == image->magic) ? parse_import_thunk64 : parse_import_thunk32;
+    UCHAR           *import      = image->view.data + fa;
+
+    lib->type      = PE_IMPORT_STATIC;
+    lib->fa        = fa;
+    lib->int_rva   = VIEW_FIELD32(import, IMAGE_IMPORT_DESCRIPTOR, OriginalFirstThunk);
+    lib->time      = VIEW_FIELD32(import, IMAGE_IMPORT_DESCRIPTOR, TimeDateStamp);
+    lib->forwarder = VIEW_FIELD32(import, IMAGE_IMPORT_DESCRIPTOR, ForwarderChain);
+    lib->name_rva  = VIEW_FIELD32(import, IMAGE_IMPORT_DESCRIPTOR, Name);
+    lib->iat_rva   = VIEW_FIELD32(import, IMAGE_IMPORT_DESCRIPTOR, FirstThunk);
+
+    if (pe_rva_to_fa(image, lib->name_rva, &lib->name_fa) < 0)
+    {
+        parse_error(image, PE_ERR_RVA, "import", lib->fa);
+        lib->name_fa = 0;
+    }
+
+    int shared = (0 == lib->int_rva || lib->int_rva == lib->iat_rva); // 同一段thunk只解析一次
+
+    if (!shared)
+    {
+        lib->func = parse_thunk(image, lib->int_rva, 0, 1, &lib->func_count);
+    }
+
+    lib->iat = parse_thunk(image, lib->iat_rva, 0, 1, &lib->iat_count);
+
+    if (shared)
+    {
+        lib->func       = lib->iat;
+        lib->func_count = lib->iat_count;
+    }
+}
+
+/**
+ *\brief                        延迟导入描述中的地址转成相对虚拟地址
+ *\param[in]    value           描述中的地址
+ *\param[in]    base            旧格式为ImageBase,新格式为0
+ *\return                       相对虚拟地址,没有时为0
+ */
+static DWORD delay_rva(DWORD value, DWORD base)
+{
+    return (0 != value) ? value - base : 0;
+}
+
+/**
+ *\brief                        解析延迟导入表中的库,输入地址表中是桩代码的虚拟地址,只取thunk值
+ *\param[in]    image           解析结果
+ *\param[in]    lib             导入库,已清0
+ *\param[in]    fa              库描述在文件中的位置
+ *\return                       无
+ */
+static void parse_import_delay(PPE_IMAGE image, PPE_IMPORT_LIB lib, DWORD fa)
+{
+    parse_thunk_proc parse_thunk = (PE_MAGIC_64 == image->magic) ? parse_import_thunk64 : parse_import_thunk32;
+    UCHAR           *delay       = image->view.data + fa;
+
+    lib->type       = PE_IMPORT_DELAY;
+    lib->fa         = fa;
+    lib->attributes = VIEW_FIELD32(delay, IMAGE_DELAYLOAD_DESCRIPTOR, Attributes);
+
+    // 旧格式(VC6)描述和输入名称表中都是虚拟地址
+    DWORD base = (lib->attributes & PE_IMPORT_DELAY_RVA) ? 0 : (DWORD)image->image_base;
+
+    lib->name_rva   = delay_rva(VIEW_FIELD32(delay, IMAGE_DELAYLOAD_DESCRIPTOR, DllNameRVA), base);
+    lib->handle_rva = delay_rva(VIEW_FIELD32(delay, IMAGE_DELAYLOAD_DESCRIPTOR, ModuleHandleRVA), base);
+    lib->iat_rva    = delay_rva(VIEW_FIELD32(delay, IMAGE_DELAYLOAD_DESCRIPTOR, ImportAddressTableRVA), base);
+    lib->int_rva    = delay_rva(VIEW_FIELD32(delay, IMAGE_DELAYLOAD_DESCRIPTOR, ImportNameTableRVA), base);
+    lib->bound_rva  = delay_rva(VIEW_FIELD32(delay, IMAGE_DELAYLOAD_DESCRIPTOR, BoundImportAddressTableRVA), base);
+    lib->unload_rva = delay_rva(VIEW_FIELD32(delay, IMAGE_DELAYLOAD_DESCRIPTOR, UnloadInformationTableRVA), base);
+    lib->time       = VIEW_FIELD32(delay, IMAGE_DELAYLOAD_DESCRIPTOR, TimeDateStamp);
+
+    if (pe_rva_to_fa(image, lib->name_rva, &lib->name_fa) < 0)
+    {
+        parse_error(image, PE_ERR_RVA, "delay", lib->fa);
+        lib->name_fa = 0;
+    }
+
+    if (0 != lib->int_rva)
+    {
+        lib->func = parse_thunk(image, lib->int_rva, base, 1, &lib->func_count);
+    }
+
+    if (0 != lib->iat_rva)
+    {
+        lib->iat = parse_thunk(image, lib->iat_rva, 0, 0, &lib->iat_count);
+    }
+}
+
+/**
+ *\brief                        解析绑定导入表的描述和转发引用,两种结构的时间和名称位置相同
+ *\param[in]    image           解析结果
+ *\param[in]    lib             第一个描述,已清0
+ *\param[in]    count           描述和转发引用的数量
+ *\return                       无
+ */
+static void parse_import_bound(PPE_IMAGE image, PPE_IMPORT_LIB lib, DWORD count)
+{
+    DWORD refs = 0; // 当前描述还剩下的转发引用
+
+    for (DWORD i = 0; i < count; i++, lib++)
+    {
+        UCHAR *bound = image->view.data + image->bound_fa + i * sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR);
+
+        lib->type     = (refs > 0) ? PE_IMPORT_BOUND_REF : PE_IMPORT_BOUND;
+        lib->fa       = image->bound_fa + i * sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR);
+        lib->time     = VIEW_FIELD32(bound, IMAGE_BOUND_IMPORT_DESCRIPTOR, TimeDateStamp);
+        lib->name_rva = VIEW_FIELD16(bound, IMAGE_BOUND_IMPORT_DESCRIPTOR, OffsetModuleName);
+        lib->name_fa  = image->bound_fa + lib->name_rva;
+
+        if (refs > 0)
+        {
+            refs--;
+        }
+        else
+        {
+            refs = lib->forwarder = VIEW_FIELD16(bound, IMAGE_BOUND_IMPORT_DESCRIPTOR, NumberOfModuleForwarderRefs);
+        }
+
+        if (lib->name_fa >= image->view.size)
+        {
+            parse_error(image, PE_ERR_RANGE, "bound", lib->fa);
+            lib->name_fa = 0;
+        }
+    }
+}
+
+/**
+ *\brief                        解析导入表,延迟导入表和绑定导入表,先数出三种描述的数量,一次分配导入库列表
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int parse_import(PPE_IMAGE image)
+{
+    image->import_section = -1;
+    image->delay_section  = -1;
+    image->bound_section  = -1;
+
+    image->lib_static = import_static_count(image);
+    image->lib_delay  = import_delay_count(image);
+    image->lib_bound  = import_bound_count(image);
+
+    // 三个数量都不超过文件长度/8
+    ULONGLONG total = (ULONGLONG)image->lib_static + image->lib_delay + image->lib_bound;
+
+    if (0 == total)
+    {
+        return 0;
+    }
+
+    image->lib = pe_arena_array(ARENA(image), (size_t)total, sizeof(PE_IMPORT_LIB));
+
+    if (NULL == image->lib)
+    {
+        image->lib_static = image->lib_delay = image->lib_bound = 0;
+        return parse_error(image, PE_ERR_MEMORY, "import", image->import_fa);
+    }
+
+    image->lib_count = (DWORD)total;
+
+    PPE_IMPORT_LIB lib = image->lib;
+
+    for (DWORD i = 0; i < image->lib_static; i++, lib++)
+    {
+        parse_import_static(image, lib, image->import_fa + i * sizeof(IMAGE_IMPORT_DESCRIPTOR));
+    }
+
+    for (DWORD i = 0; i < image->lib_delay; i++, lib++)
+    {
+        parse_import_delay(image, lib, image->delay_fa + i * sizeof(IMAGE_DELAYLOAD_DESCRIPTOR));
+    }
+
+    parse_import_bound(image, lib, image->lib_bound);
+
+    if (NULL != image->intern)
+    {
+        for (DWORD i = 0; i < image->lib_count; i++)
+        {
+            intern_import(image, &image->lib[i]);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ *\brief                        解析重定位表,到全0的块或数据目录的结尾为止
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int parse_reloc(PPE_IMAGE image)
+{
+    PPE_VIEW view = &image->view;
+    DWORD    va   = image->dir[PE_DIR_RELOC].VirtualAddress;
+
+    image->reloc_section = -1;
+
+    if (0 == va)
+    {
+        return 0; // 没有重定位表
+    }
+
+    image->reloc_section = pe_rva_to_fa(image, va, &image->reloc_fa);
+
+    if (image->reloc_section < 0)
+    {
+        return 0;
+    }
+
+    ULONGLONG end = view->size; // 块只在这个范围内
+
+    if (0 != image->dir[PE_DIR_RELOC].Size && (ULONGLONG)image->reloc_fa + image->dir[PE_DIR_RELOC].Size < end)
+    {
+        end = (ULONGLONG)image->reloc_fa + image->dir[PE_DIR_RELOC].Size;
+    }
+
+    DWORD fa  = image->reloc_fa;
+    DWORD cap = 0;
+
+    while (fa < end)
+    {
+        if ((ULONGLONG)fa + sizeof(IMAGE_BASE_RELOCATION) > end)
+        {
+            return parse_error(image, PE_ERR_RANGE, "reloc", fa);
+        }
+
+        UCHAR *block = view->data + fa; // 块数据长度不定
+        DWORD  page  = VIEW_FIELD32(block, IMAGE_BASE_RELOCATION, VirtualAddress);
+        DWORD  size  = VIEW_FIELD32(block, IMAGE_BASE_RELOCATION, SizeOfBlock);
+
+        if (0 == page || 0 == size)
+        {
+            break;
+        }
+
+        if (size < sizeof(IMAGE_BASE_RELOCATION))
+        {
+            return parse_error(image, PE_ERR_FORMAT, "reloc", fa);
+        }
+
+        if ((ULONGLONG)fa + size > end)
+        {
+            return parse_error(image, PE_ERR_RANGE, "reloc", fa);
+        }
+
+        int section = pe_section_find(image, page); // 查找重定位数据块所在的段
+
+        if (section < 0)
+        {
+            return parse_error(image, PE_ERR_RELOC_SECTION, "reloc", fa);
+        }
+
+        if (image->reloc_count == cap)
+        {
+            PPE_RELOC_BLOCK list = pe_arena_grow(ARENA(image), image->reloc, cap * sizeof(PE_RELOC_BLOCK),
+                                                 (cap ? cap * 2 : 64) * sizeof(PE_RELOC_BLOCK)); // 通常是最后一次分配,原地扩大
+
+            if (NULL == list)
+            {
+                return parse_error(image, PE_ERR_MEMORY, "reloc", fa);
+            }
+
+            image->reloc = list;
+            cap          = cap ? cap * 2 : 64;
+        }
+
+        PPE_RELOC_BLOCK reloc = &image->reloc[image->reloc_count];
+
+        reloc->fa      = fa;
+        reloc->page    = page;
+        reloc->size    = size;
+        reloc->count   = (size - sizeof(IMAGE_BASE_RELOCATION)) / 2; // 数据项数量
+        reloc->section = section;
+
+        image->reloc_count++;
+        image->reloc_entries += reloc->count;
+
+        fa += size;
+    }
+
+    return 0;
+}
+
+int pe_parse(PPE_IMAGE image, UCHAR *buff, size_t size)
+{
+    return pe_parse_pool(image, buff, size, NULL, NULL);
+}
+
+#ifndef PE_STAT_OFF
+
+/**
+ *\brief                        导入表解码的数据项数,三种库描述和函数列表的项,共用的函数列表只算一次
+ *\param[in]    image           解析结果
+ *\return                       数据项数
+ */
+static ULONGLONG stat_import_items(PPE_IMAGE image)
+{
+    ULONGLONG items = image->lib_count;
+
+    for (DWORD i = 0; i < image->lib_count; i++)
+    {
+        PPE_IMPORT_LIB lib = &image->lib[i];
+
+        items += ((lib->func != lib->iat) ? lib->func_count : 0) + (ULONGLONG)lib->iat_count;
+    }
+
+    return items;
+}
+
+/**
+ *\brief                        导入表读过的字节数,库描述包括结尾的空描述,函数列表包括结尾的0,不包括名称
+ *\param[in]    image           解析结果
+ *\return                       字节数
+ */
+static ULONGLONG stat_import_bytes(PPE_IMAGE image)
+{
+    ULONGLONG thunk = (PE_MAGIC_64 == image->magic) ? 8 : 4;
+    ULONGLONG bytes = 0;
+
+    bytes += (image->import_section >= 0) ? (image->lib_static + 1ULL) * sizeof(IMAGE_IMPORT_DESCRIPTOR) : 0;
+    bytes += (image->delay_section >= 0) ? (image->lib_delay + 1ULL) * sizeof(IMAGE_DELAYLOAD_DESCRIPTOR) : 0;
+    bytes += (ULONGLONG)image->lib_bound * sizeof(IMAGE_BOUND_IMPORT_DESCRIPTOR);
+
+    for (DWORD i = 0; i < image->lib_count; i++)
+    {
+        PPE_IMPORT_LIB lib = &image->lib[i];
+
+        bytes += (lib->func_count && lib->func != lib->iat) ? (lib->func_count + 1ULL) * thunk : 0;
+        bytes += lib->iat_count ? (lib->iat_count + 1ULL) * thunk : 0;
+    }
+
+    return bytes;
+}
+
+#endif
+
+int pe_parse_head(PPE_IMAGE image, UCHAR *buff, size_t size, PPE_ARENA pool)
+{
+    PE_STAT_START(mark);
+
+    memset(image, 0, sizeof(PE_IMAGE));
+
+    image->pool = pool;
+
+    int ret = pe_check(buff, size);
+
+    if (PE_OK != ret)
+    {
+        PE_STAT_LAP(mark, PE_STAT_HEAD, 0, (size < sizeof(IMAGE_DOS_HEADER)) ? size : sizeof(IMAGE_DOS_HEADER));
+        return ret;
+    }
+
+    UCHAR *nt  = buff + VIEW_FIELD32(buff, IMAGE_DOS_HEADER, e_lfanew); // pe_check检查过整个NT头
+    UCHAR *opt = nt + offsetof(IMAGE_NT_HEADERS32, OptionalHeader);         // 两种位宽的位置相同
+
+    image->view.data       = buff;
+    image->view.size       = size;
+    image->nt_fa           = (DWORD)(nt - buff);
+    image->file_fa         = image->nt_fa + 4;
+    image->opt_fa          = image->nt_fa + 4 + sizeof(IMAGE_FILE_HEADER);
+
+    image->machine         = VIEW_FIELD16(nt, IMAGE_NT_HEADERS32, FileHeader.Machine);
+    image->characteristics = VIEW_FIELD16(nt, IMAGE_NT_HEADERS32, FileHeader.Characteristics);
+    image->time            = VIEW_FIELD32(nt, IMAGE_NT_HEADERS32, FileHeader.TimeDateStamp);
+    image->opt_size        = VIEW_FIELD16(nt, IMAGE_NT_HEADERS32, FileHeader.SizeOfOptionalHeader);
+
+    if (PE_MAGIC_64 == VIEW_FIELD16(opt, IMAGE_OPTIONAL_HEADER32, Magic))
+    {
+        parse_optional64(image, opt);
+    }
+    else
+    {
+        parse_optional32(image, opt);
+    }
+
+    // 数据目录最多读IMAGE_NUMBEROF_DIRECTORY_ENTRIES项,OPTION头后面多出的部分不读
+    PE_STAT_LAP(mark, PE_STAT_HEAD,
+                1 + ((image->dir_count < IMAGE_NUMBEROF_DIRECTORY_ENTRIES) ? image->dir_count : IMAGE_NUMBEROF_DIRECTORY_ENTRIES),
+                sizeof(IMAGE_DOS_HEADER) + 4 + sizeof(IMAGE_FILE_HEADER) +
+                ((image->opt_size < sizeof(IMAGE_OPTIONAL_HEADER64)) ? image->opt_size : sizeof(IMAGE_OPTIONAL_HEADER64)));
+
+    // 某部分出错时其它部分继续解析,内存不足时停止
+    if (PE_ERR_MEMORY == parse_section(image))
+    {
+        return image->error.code;
+    }
+
+    PE_STAT_LAP(mark, PE_STAT_SECTION, image->section_count, (ULONGLONG)image->section_count * sizeof(IMAGE_SECTION_HEADER));
+
+    return image->error.code;
+}
+
+int pe_parse_pool(PPE_IMAGE image, UCHAR *buff, size_t size, PPE_ARENA pool, PPE_INTERN intern)
+{
+    int ret = pe_parse_head(image, buff, size, pool);
+
+    if (PE_ERR_MEMORY == ret || (ret < 0 && ret >= PE_ERR_UNSUPPORTED)) // 没有头部或节表内存不足
+    {
+        return ret;
+    }
+
+    PE_STAT_START(mark);
+
+    image->intern = intern;
+
+    if (PE_ERR_MEMORY == parse_export(image))
+    {
+        return image->error.code;
+    }
+
+    PE_STAT_LAP(mark, PE_STAT_EXPORT, (image->export_section >= 0), (image->export_section >= 0) ? sizeof(IMAGE_EXPORT_DIRECTORY) : 0);
+
+    if (PE_ERR_MEMORY == parse_import(image))
+    {
+        return image->error.code;
+    }
+
+    PE_STAT_LAP(mark, PE_STAT_IMPORT, stat_import_items(image), stat_import_bytes(image));
+
+    parse_reloc(image);
+
+    PE_STAT_LAP(mark, PE_STAT_RELOC, image->reloc_count, (ULONGLONG)image->reloc_count * sizeof(IMAGE_BASE_RELOCATION));
+
+    return image->error.code;
+}
+
+void pe_free(PPE_IMAGE image)
+{
+    if (NULL != image->pool)
+    {
+        pe_arena_reset(image->pool); // 保留块给下一个文件
+    }
+    else
+    {
+        pe_arena_free(&image->arena);
+    }
+
+    memset(image, 0, sizeof(PE_IMAGE));
+}
+
+/**
+ *\brief                        比较名称表中的名称与函数名,按无符号字节比较,与系统加载器相同
+ *\param[in]    image           解析结果
+ *\param[in]    id              名称表序号,小于name_count
+ *\param[in]    name            函数名
+ *\param[in]    len             函数名长度
+ *\return                       <0-名称表中的小,0-相等,>0-名称表中的大
+ */
+static int export_compare(PPE_IMAGE image, DWORD id, const char *name, size_t len)
+{
+    DWORD  fa  = 0;
+    size_t n   = 0;
+    DWORD  rva = le32(image->view.data + image->export.names_fa + id * sizeof(DWORD));
+
+    if (pe_rva_to_fa(image, rva, &fa) < 0)
+    {
+        fa = 0; // 地址非法时当作空字符串
+    }
+
+    // 最多取len+1字节就能判断大小
+    const char *str = view_strn(&image->view, fa, len + 1, &n);
+    int         cmp = memcmp(str, name, (n < len) ? n : len);
+
+    return (0 != cmp) ? cmp : (int)(n > len) - (int)(n < len);
+}
+
+/**
+ *\brief                        在名称表[*pos,high)中二分查找
+ *\param[in]    image           解析结果
+ *\param[in]    name            函数名
+ *\param[in]    len             函数名长度
+ *\param[in,out] pos            输入查找起点,输出第一个不小于函数名的位置
+ *\param[in]    high            查找终点,不大于name_count
+ *\return                       0-找到,-1-没有找到
+ */
+static int export_search(PPE_IMAGE image, const char *name, size_t len, DWORD *pos, DWORD high)
+{
+    DWORD low  = *pos;
+
+    while (low < high)
+    {
+        DWORD mid = low + (high - low) / 2;
+
+        if (export_compare(image, mid, name, len) < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    *pos = low;
+
+    return (low < image->export.name_count && 0 == export_compare(image, low, name, len)) ? 0 : -1;
+}
+
+/**
+ *\brief                        取函数地址表中的一项,地址在导出表范围内时为转发
+ *\param[in]    image           解析结果
+ *\param[in]    index           函数地址表序号,序号-base
+ *\param[out]   sym             查找结果,name_id由调用者填写
+ *\return                       0-找到,-1-序号超出范围或地址为0
+ */
+static int export_function(PPE_IMAGE image, DWORD index, PPE_EXPORT_SYMBOL sym)
+{
+    PPE_EXPORT export = &image->export;
+    DWORD      dir    = image->dir[PE_DIR_EXPORT].VirtualAddress;
+    DWORD      size   = image->dir[PE_DIR_EXPORT].Size;
+
+    if (index >= export->func_count)
+    {
+        return -1;
+    }
+
+    sym->ordinal = export->base + index;
+    sym->rva     = le32(image->view.data + export->func_fa + index * sizeof(DWORD));
+
+    if (0 == sym->rva)
+    {
+        return -1; // 序号没有使用
+    }
+
+    if (sym->rva - dir < size && pe_rva_to_fa(image, sym->rva, &sym->forward_fa) < 0)
+    {
+        sym->forward_fa = 0;
+    }
+
+    sym->found = 1;
+    return 0;
+}
+
+/**
+ *\brief                        通过名称表序号得到函数
+ *\param[in]    image           解析结果
+ *\param[in]    id              名称表序号,小于name_count
+ *\param[out]   sym             查找结果
+ *\return                       0-找到,-1-函数序号超出范围
+ */
+static int export_name_symbol(PPE_IMAGE image, DWORD id, PPE_EXPORT_SYMBOL sym)
+{
+    sym->name_id = id;
+
+    return export_function(image, le16(image->view.data + image->export.ords_fa + id * sizeof(WORD)), sym);
+}
+
+int pe_export_find(PPE_IMAGE image, const char *name, size_t len, DWORD hint, PPE_EXPORT_SYMBOL sym)
+{
+    DWORD id = 0;
+
+    memset(sym, 0, sizeof(PE_EXPORT_SYMBOL));
+    sym->name_id = PE_EXPORT_NO_NAME;
+
+    if (image->export_section < 0)
+    {
+        return -1;
+    }
+
+    if (hint < image->export.name_count && 0 == export_compare(image, hint, name, len))
+    {
+        return export_name_symbol(image, hint, sym);
+    }
+
+    return (0 == export_search(image, name, len, &id, image->export.name_count)) ? export_name_symbol(image, id, sym) : -1;
+}
+
+int pe_export_ordinal(PPE_IMAGE image, DWORD ordinal, PPE_EXPORT_SYMBOL sym)
+{
+    memset(sym, 0, sizeof(PE_EXPORT_SYMBOL));
+    sym->name_id = PE_EXPORT_NO_NAME;
+
+    if (image->export_section < 0)
+    {
+        return -1;
+    }
+
+    return export_function(image, ordinal - image->export.base, sym);
+}
+
+DWORD pe_export_resolve(PPE_IMAGE image, const char * const *names, const WORD *hints,
+                        DWORD count, PPE_EXPORT_SYMBOL syms)
+{
+    DWORD found = 0;
+    DWORD low   = 0;    // 名称升序时,后面的名称不会在前一个结果之前
+
+    for (DWORD i = 0; i < count; i++)
+    {
+        PPE_EXPORT_SYMBOL sym = &syms[i];
+        size_t            len = strlen(names[i]);
+
+        memset(sym, 0, sizeof(PE_EXPORT_SYMBOL));
+        sym->name_id = PE_EXPORT_NO_NAME;
+
+        if (image->export_section < 0)
+        {
+            continue;
+        }
+
+        if (NULL != hints && hints[i] < image->export.name_count && 0 == export_compare(image, hints[i], names[i], len))
+        {
+            found += (0 == export_name_symbol(image, hints[i], sym));
+            continue;
+        }
+
+        if (i > 0 && strcmp(names[i - 1], names[i]) > 0)
+        {
+            low = 0;
+        }
+
+        // 从上一个结果开始按1,2,4..的步长向后找,相邻的名称在名称表中也相近
+        DWORD high = low;
+        DWORD step = 1;
+
+        while (high < image->export.name_count && export_compare(image, high, names[i], len) < 0)
+        {
+            low   = high + 1;
+            high  = (image->export.name_count - low > step) ? low + step : image->export.name_count;
+            step *= 2;
+        }
+
+        if (high < image->export.name_count)
+        {
+            high++; // high处不小于名称,包括在查找范围内
+        }
+
+        if (0 == export_search(image, names[i], len, &low, high))
+        {
+            found += (0 == export_name_symbol(image, low, sym));
+        }
+    }
+
+    return found;
+}
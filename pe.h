@@ -0,0 +1,350 @@
+/**
+ *\file     pe.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    PE文件解析接口定义,与界面无关
+ *          解析结果为PE_IMAGE,只保存类型化的数值和文件中的位置,不复制字符串,
+ *          树形输出,文本输出等都是PE_IMAGE的使用者
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件,从main.c中分离
+ *          2026.10.18|增加PE_IMAGE解析结果
+ *          2026.10.18|增加相对虚拟地址索引,二分查找节
+ *          2026.10.18|通过有界视图读取文件数据,增加结构化错误
+ *          2026.10.18|支持PE32+
+ *          2026.10.18|增加导出函数查找
+ *          2026.10.18|解析结构从内存池分配,可以填写驻留的导入名称
+ *          2026.10.18|增加节的熵和摘要
+ *          2026.10.18|增加导入表散列和Rich头指纹
+ *          2026.10.18|增加资源表和版本信息
+ *          2026.10.18|导入库列表增加延迟导入和绑定导入
+ *          2026.10.18|增加调试目录,只解析头部和节表
+ *          2026.10.18|增加Authenticode签名
+ */
+#ifndef _PE_H_
+#define _PE_H_
+
+#include "platform.h"
+#include "view.h"
+#include "pe_arena.h"
+
+#define PE_DIR_EXPORT           0                                           ///< 导出表数据目录
+#define PE_DIR_IMPORT           1                                           ///< 导入表数据目录
+#define PE_DIR_RSRC             2                                           ///< 资源表数据目录
+#define PE_DIR_SECURITY         4                                           ///< 证书表数据目录,地址是文件位置而不是相对虚拟地址
+#define PE_DIR_RELOC            5                                           ///< 重定位表数据目录
+#define PE_DIR_DEBUG            6                                           ///< 调试目录数据目录
+#define PE_DIR_BOUND            11                                          ///< 绑定导入表数据目录
+#define PE_DIR_DELAY            13                                          ///< 延迟导入表数据目录
+
+#define PE_MAGIC_32             0x10b                                       ///< PE32的OPTION头标记
+#define PE_MAGIC_64             0x20b                                       ///< PE32+的OPTION头标记
+
+#define PE_OK                   0                                           ///< 成功
+#define PE_ERR_NOT_MZ           -1                                          ///< 不是MZ文件
+#define PE_ERR_NT_RANGE         -2                                          ///< NT头超出文件
+#define PE_ERR_NOT_PE           -3                                          ///< 不是PE文件
+#define PE_ERR_UNSUPPORTED      -4                                          ///< 不支持的OPTION头
+#define PE_ERR_MEMORY           -5                                          ///< 内存不足
+#define PE_ERR_RELOC_SECTION    -6                                          ///< 重定位块不在任何节中
+#define PE_ERR_RANGE            -7                                          ///< 结构超出文件
+#define PE_ERR_RVA              -8                                          ///< 相对虚拟地址不在任何节中
+#define PE_ERR_FORMAT           -9                                          ///< 结构中的数值非法
+
+#define PE_EXPORT_NO_NAME       0xFFFFFFFF                                  ///< 导出函数没有名称
+#define PE_SECTION_HEAD         -2                                          ///< 结构在文件头中,不在任何节中,相对虚拟地址等于文件位置
+
+#define PE_IMPORT_STATIC        0                                           ///< 导入表中的库
+#define PE_IMPORT_DELAY         1                                           ///< 延迟导入表中的库
+#define PE_IMPORT_BOUND         2                                           ///< 绑定导入描述
+#define PE_IMPORT_BOUND_REF     3                                           ///< 绑定导入的转发引用,跟在所属的描述后面
+#define PE_IMPORT_DELAY_RVA     0x01                                        ///< 延迟导入描述的属性:地址是相对虚拟地址
+
+typedef struct _PE_ERROR                                                    ///  解析错误,只记录第一个
+{
+    int             code;                                                   ///< 错误码,PE_ERR_*
+    const char     *part;                                                   ///< 出错的部分:section,export,import,delay,bound,reloc
+    DWORD           fa;                                                     ///< 出错的结构在文件中的位置
+    DWORD           count;                                                  ///< 错误总数
+
+} PE_ERROR, *PPE_ERROR;
+
+typedef struct _PE_SECTION                                                  ///  节
+{
+    DWORD           fa;                                                     ///< 节头在文件中的位置,节名也在这里
+    DWORD           virtual_size;                                           ///< 被实际使用的区块大小
+    DWORD           virtual_address;                                        ///< 区块的相对虚拟地址
+    DWORD           raw_size;                                               ///< 该块在磁盘中所占的大小
+    DWORD           raw_fa;                                                 ///< 该块在磁盘文件中的偏移
+    DWORD           characteristics;                                        ///< 特性
+
+} PE_SECTION, *PPE_SECTION;
+
+typedef struct _PE_RVA_INDEX                                                ///  相对虚拟地址索引项,按start排序
+{
+    DWORD           start;                                                  ///< 节的相对虚拟地址
+    DWORD           last;                                                   ///< 节按内存对齐后的最后一个地址
+    DWORD           delta;                                                  ///< 文件位置-相对虚拟地址
+    int             section;                                                ///< 节序号
+
+} PE_RVA_INDEX, *PPE_RVA_INDEX;
+
+typedef struct _PE_IMPORT_FUNC                                              ///  导入函数
+{
+    DWORD           fa;                                                     ///< thunk在文件中的位置
+    ULONGLONG       value;                                                  ///< thunk值,PE32+时为64位
+    DWORD           name_fa;                                                ///< IMAGE_IMPORT_BY_NAME在文件中的位置,按序号导入时为0
+    WORD            hint;                                                   ///< 函数名提示序号
+    WORD            ordinal;                                                ///< 按序号导入时的序号
+    UCHAR           by_ordinal;                                             ///< 1-按序号导入,0-按名称导入
+    const PE_NAME  *name;                                                   ///< 驻留的函数名,没有驻留表或没有驻留时为NULL,只填写输入名称表
+
+} PE_IMPORT_FUNC, *PPE_IMPORT_FUNC;
+
+typedef struct _PE_IMPORT_LIB                                               ///  导入库,导入表,延迟导入表和绑定导入表共用
+{
+    DWORD           type;                                                   ///< PE_IMPORT_*
+    DWORD           fa;                                                     ///< 库描述在文件中的位置
+    DWORD           name_fa;                                                ///< 库名称在文件中的位置
+    DWORD           int_rva;                                                ///< 输入名称表(OriginalFirstThunk),为0时函数取输入地址表
+    DWORD           time;                                                   ///< 文件创建时间,绑定导入时为被绑定库的时间
+    DWORD           forwarder;                                              ///< 被转向API的索引,绑定导入描述为转发引用数量
+    DWORD           name_rva;                                               ///< 库名称地址,绑定导入时为名称相对绑定导入表的位置
+    DWORD           iat_rva;                                                ///< 输入地址表(FirstThunk)
+    DWORD           attributes;                                             ///< 延迟导入描述的属性,PE_IMPORT_DELAY_RVA
+    DWORD           handle_rva;                                             ///< 延迟导入的模块句柄地址
+    DWORD           bound_rva;                                              ///< 延迟导入的绑定输入地址表
+    DWORD           unload_rva;                                             ///< 延迟导入的卸载信息表
+    const PE_NAME  *name;                                                   ///< 驻留的库名称,没有驻留表或没有驻留时为NULL
+
+    PPE_IMPORT_FUNC func;                                                   ///< 输入名称表中的函数,没有输入名称表或与输入地址表相同时与iat共用
+    DWORD           func_count;                                             ///< 输入名称表中的函数数量
+    PPE_IMPORT_FUNC iat;                                                    ///< 输入地址表中的函数,延迟导入时只有thunk值
+    DWORD           iat_count;                                              ///< 输入地址表中的函数数量
+
+} PE_IMPORT_LIB, *PPE_IMPORT_LIB;
+
+typedef struct _PE_EXPORT                                                   ///  导出表
+{
+    DWORD           fa;                                                     ///< IMAGE_EXPORT_DIRECTORY在文件中的位置
+    DWORD           name_fa;                                                ///< 文件名在文件中的位置
+    DWORD           base;                                                   ///< 导出函数的起始序号
+    DWORD           func_count;                                             ///< 所有的导出函数的个数
+    DWORD           name_count;                                             ///< 以名字导出的函数的个数
+    DWORD           func_rva;                                               ///< 导出的函数表地址
+    DWORD           names_rva;                                              ///< 导出的函数名称表地址
+    DWORD           ords_rva;                                               ///< 导出函数序号表地址
+    DWORD           func_fa;                                                ///< 导出的函数表在文件中的位置,DWORD数组
+    DWORD           names_fa;                                               ///< 导出的函数名称表在文件中的位置,DWORD数组
+    DWORD           ords_fa;                                                ///< 导出函数序号表在文件中的位置,WORD数组
+
+} PE_EXPORT, *PPE_EXPORT;
+
+typedef struct _PE_EXPORT_SYMBOL                                            ///  导出函数查找结果
+{
+    int             found;                                                  ///< 1-找到,0-没有找到
+    DWORD           name_id;                                                ///< 名称表序号,按序号查找时为PE_EXPORT_NO_NAME
+    DWORD           ordinal;                                                ///< 序号,包括base
+    DWORD           rva;                                                    ///< 函数地址
+    DWORD           forward_fa;                                             ///< 转发字符串"库名.函数名"在文件中的位置,0为不是转发
+
+} PE_EXPORT_SYMBOL, *PPE_EXPORT_SYMBOL;
+
+typedef struct _PE_RELOC_BLOCK                                              ///  重定位块
+{
+    DWORD           fa;                                                     ///< 块头在文件中的位置,数据项紧随其后
+    DWORD           page;                                                   ///< 页的相对虚拟地址
+    DWORD           size;                                                   ///< 块大小
+    DWORD           count;                                                  ///< 数据项数量
+    int             section;                                                ///< 页所在节
+
+} PE_RELOC_BLOCK, *PPE_RELOC_BLOCK;
+
+typedef struct _PE_IMAGE                                                    ///  PE文件解析结果
+{
+    PE_VIEW         view;                                                   ///< 文件数据
+    PE_ERROR        error;                                                  ///< 解析错误,出错的部分只保留检查过的数据
+
+    DWORD           nt_fa;                                                  ///< IMAGE_NT_HEADERS在文件中的位置
+    DWORD           file_fa;                                                ///< IMAGE_FILE_HEADER在文件中的位置
+    DWORD           opt_fa;                                                 ///< IMAGE_OPTIONAL_HEADER在文件中的位置
+    WORD            opt_size;                                               ///< OPTION头大小,节头紧随其后
+
+    WORD            machine;                                                ///< 目标CPU类型
+    WORD            characteristics;                                        ///< 文件的类型
+    DWORD           time;                                                   ///< 文件创建时间
+    WORD            magic;                                                  ///< OPTION头标记,PE_MAGIC_32或PE_MAGIC_64
+    WORD            subsystem;                                              ///< 子系统类型
+    DWORD           entry;                                                  ///< 程序执行的入口
+    ULONGLONG       image_base;                                             ///< 内存首选装载地址
+    DWORD           section_align;                                          ///< 节在内存中的对齐值
+    DWORD           file_align;                                             ///< 节在文件中的对齐值
+    DWORD           image_size;                                             ///< 装入内存后的总大小
+    DWORD           dir_count;                                              ///< 数据目录项的个数
+    IMAGE_DATA_DIRECTORY dir[IMAGE_NUMBEROF_DIRECTORY_ENTRIES];             ///< 数据目录
+
+    PPE_SECTION     section;                                                ///< 节
+    int             section_count;                                          ///< 节数量
+
+    PPE_RVA_INDEX   index;                                                  ///< 相对虚拟地址索引
+    int             index_count;                                            ///< 索引项数量
+    int             index_linear;                                           ///< 1-节的地址范围有重叠,按节头顺序线性查找
+
+    int             export_section;                                         ///< 导出表所在节,-1为没有导出表
+    PE_EXPORT       export;                                                 ///< 导出表
+
+    int             import_section;                                         ///< 导入表所在节,-1为没有导入表
+    DWORD           import_fa;                                              ///< 导入表在文件中的位置
+    int             delay_section;                                          ///< 延迟导入表所在节,-1为没有延迟导入表
+    DWORD           delay_fa;                                               ///< 延迟导入表在文件中的位置
+    int             bound_section;                                          ///< 绑定导入表所在节,在头中时为PE_SECTION_HEAD,-1为没有
+    DWORD           bound_fa;                                               ///< 绑定导入表在文件中的位置
+    PPE_IMPORT_LIB  lib;                                                    ///< 导入库,依次是导入表,延迟导入表和绑定导入表的项
+    DWORD           lib_count;                                              ///< 导入库总数
+    DWORD           lib_static;                                             ///< 导入表中的库数量
+    DWORD           lib_delay;                                              ///< 延迟导入表中的库数量
+    DWORD           lib_bound;                                              ///< 绑定导入描述和转发引用数量
+
+    int             reloc_section;                                          ///< 重定位表所在节,-1为没有重定位表
+    DWORD           reloc_fa;                                               ///< 重定位表在文件中的位置
+    PPE_RELOC_BLOCK reloc;                                                  ///< 重定位块
+    DWORD           reloc_count;                                            ///< 重定位块数量
+    ULONGLONG       reloc_entries;                                          ///< 重定位数据项总数
+
+    struct _PE_DIGEST *digest;                                              ///< 节和附加数据的熵和摘要,pe_digest计算,NULL为没有计算
+    struct _PE_FINGER *finger;                                              ///< 导入表散列和Rich头,pe_finger计算,NULL为没有计算
+    struct _PE_VERSION *version;                                            ///< 版本信息和清单,pe_version计算,NULL为没有计算
+    struct _PE_DEBUG *debug;                                                ///< 调试目录,pe_debug计算,NULL为没有计算
+    struct _PE_AUTH *auth;                                                  ///< Authenticode签名和摘要,pe_auth计算,NULL为没有计算
+
+    PE_ARENA        arena;                                                  ///< 解析结构的内存池,没有指定pool时使用
+    PPE_ARENA       pool;                                                   ///< 调用者的内存池,NULL时使用arena
+    PPE_INTERN      intern;                                                 ///< 名称驻留表,NULL时不填写名称
+
+} PE_IMAGE, *PPE_IMAGE;
+
+/**
+ *\brief                        检查PE文件头
+ *\param[in]    buff            PE文件数据
+ *\param[in]    size            数据长度
+ *\return                       PE_OK,PE_ERR_NOT_MZ,PE_ERR_NT_RANGE,PE_ERR_NOT_PE,PE_ERR_UNSUPPORTED(不是PE32或PE32+)
+ */
+int pe_check(UCHAR *buff, size_t size);
+
+/**
+ *\brief                        解析PE文件,只保存数值和文件中的位置,不格式化
+ *                              某部分出错时记录到image->error并跳过该部分余下的数据,其它部分继续解析,
+ *                              解析结果中的位置和数量都已检查过,不会超出文件
+ *\param[out]   image           解析结果,使用后调用pe_free
+ *\param[in]    buff            PE文件数据,解析结果引用该数据,使用期间不能释放
+ *\param[in]    size            数据长度
+ *\return                       PE_OK,pe_check的错误码,或image->error.code
+ */
+int pe_parse(PPE_IMAGE image, UCHAR *buff, size_t size);
+
+/**
+ *\brief                        解析PE文件,解析结构从调用者的内存池分配,批量解析时复用内存池和驻留表
+ *\param[out]   image           解析结果,使用后调用pe_free,pe_free清空pool
+ *\param[in]    buff            PE文件数据
+ *\param[in]    size            数据长度
+ *\param[in]    pool            内存池,NULL时与pe_parse相同
+ *\param[in]    intern          名称驻留表,不为NULL时填写导入库和输入名称表中的函数名,
+ *                              驻留的名称在驻留表释放前都可以使用
+ *\return                       同pe_parse
+ */
+int pe_parse_pool(PPE_IMAGE image, UCHAR *buff, size_t size, PPE_ARENA pool, PPE_INTERN intern);
+
+/**
+ *\brief                        只解析头部和节表,不解析导出表,导入表和重定位表,
+ *                              只需要头部和某个数据目录时使用,文件中只读入了头部和需要的部分时也可以用
+ *\param[out]   image           解析结果,使用后调用pe_free
+ *\param[in]    buff            PE文件数据
+ *\param[in]    size            数据长度
+ *\param[in]    pool            内存池,NULL时使用解析结果自己的内存池
+ *\return                       同pe_parse
+ */
+int pe_parse_head(PPE_IMAGE image, UCHAR *buff, size_t size, PPE_ARENA pool);
+
+/**
+ *\brief                        得到错误码的说明
+ *\param[in]    code            错误码
+ *\return                       说明
+ */
+const char* pe_error_string(int code);
+
+/**
+ *\brief                        释放解析结果,所有解析结构在内存池中一次释放
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void pe_free(PPE_IMAGE image);
+
+/**
+ *\brief                        通过相对虚拟地址查找节,使用索引二分查找
+ *\param[in]    image           解析结果
+ *\param[in]    rva             相对虚拟地址
+ *\return                       节序号,-1为没有找到
+ */
+int pe_section_find(PPE_IMAGE image, DWORD rva);
+
+/**
+ *\brief                        通过相对虚拟地址查找节,按节头顺序线性查找,节的地址范围有重叠时使用
+ *\param[in]    image           解析结果
+ *\param[in]    rva             相对虚拟地址
+ *\return                       节序号,-1为没有找到
+ */
+int pe_section_find_linear(PPE_IMAGE image, DWORD rva);
+
+/**
+ *\brief                        相对虚拟地址转成文件中的位置
+ *\param[in]    image           解析结果
+ *\param[in]    rva             相对虚拟地址
+ *\param[out]   fa              文件中的位置
+ *\return                       节序号,-1为没有找到
+ */
+int pe_rva_to_fa(PPE_IMAGE image, DWORD rva, DWORD *fa);
+
+/**
+ *\brief                        得到节名称
+ *\param[in]    image           解析结果
+ *\param[in]    id              节序号
+ *\param[out]   name            节名称,至少9字节
+ *\return                       name
+ */
+char* pe_section_name(PPE_IMAGE image, int id, char *name);
+
+/**
+ *\brief                        按名称查找导出函数,与系统加载器相同,先试提示序号,再在名称表中二分查找,
+ *                              名称表按字节升序排列,没有排序的文件可能找不到
+ *\param[in]    image           解析结果
+ *\param[in]    name            函数名
+ *\param[in]    len             函数名长度
+ *\param[in]    hint            名称表序号提示,导入表中的Hint,没有时为PE_EXPORT_NO_NAME
+ *\param[out]   sym             查找结果
+ *\return                       0-找到,-1-没有找到
+ */
+int pe_export_find(PPE_IMAGE image, const char *name, size_t len, DWORD hint, PPE_EXPORT_SYMBOL sym);
+
+/**
+ *\brief                        按序号查找导出函数,直接取函数地址表,不查找名称
+ *\param[in]    image           解析结果
+ *\param[in]    ordinal         序号,包括base
+ *\param[out]   sym             查找结果
+ *\return                       0-找到,-1-没有找到
+ */
+int pe_export_ordinal(PPE_IMAGE image, DWORD ordinal, PPE_EXPORT_SYMBOL sym);
+
+/**
+ *\brief                        批量按名称查找导出函数,名称按升序排列时从上一个结果处继续查找
+ *\param[in]    image           解析结果
+ *\param[in]    names           函数名,以0结尾
+ *\param[in]    hints           名称表序号提示,可以为NULL
+ *\param[in]    count           函数数量
+ *\param[out]   syms            查找结果,count项
+ *\return                       找到的数量
+ */
+DWORD pe_export_resolve(PPE_IMAGE image, const char * const *names, const WORD *hints,
+                        DWORD count, PPE_EXPORT_SYMBOL syms);
+
+#endif
@@ -0,0 +1,289 @@
+/**
+ *\file     pe_arena.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    解析结果的内存池和名称驻留表实现
+ *          块按链表连接,新块的长度是前一块的两倍,分配只移动当前块的空闲位置.
+ *          驻留表为开放寻址散列表,负载不超过一半,名称和项在驻留表自己的内存池中
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#include "pe_arena.h"
+
+/// 向上对齐
+#define ARENA_ROUND(n)          (((n) + PE_ARENA_ALIGN - 1) & ~(size_t)(PE_ARENA_ALIGN - 1))
+
+#define ARENA_HEAD              ARENA_ROUND(sizeof(PE_ARENA_BLOCK))         ///< 块头长度,数据从对齐的位置开始
+
+/**
+ *\brief                        分配新块,成为当前块
+ *\param[in]    arena           内存池
+ *\param[in]    need            至少需要的长度
+ *\return                       0-成功,其它失败
+ */
+static int arena_block(PPE_ARENA arena, size_t need)
+{
+    size_t size = (NULL != arena->head) ? arena->head->size * 2 : PE_ARENA_FIRST;
+
+    while (size < need)
+    {
+        size = (size > ((size_t)-1 - ARENA_HEAD) / 2) ? need : size * 2;
+    }
+
+    if (size > (size_t)-1 - ARENA_HEAD)
+    {
+        return -1;
+    }
+
+    PPE_ARENA_BLOCK block = malloc(ARENA_HEAD + size);
+
+    if (NULL == block)
+    {
+        return -2;
+    }
+
+    block->next = arena->head;
+    block->size = size;
+
+    arena->head      = block;
+    arena->pos       = (UCHAR*)block + ARENA_HEAD;
+    arena->end       = arena->pos + size;
+    arena->reserved += size;
+    arena->blocks++;
+    return 0;
+}
+
+/**
+ *\brief                        分配内存,不清0
+ *\param[in]    arena           内存池
+ *\param[in]    size            长度
+ *\return                       内存,失败时为NULL
+ */
+static void* arena_take(PPE_ARENA arena, size_t size)
+{
+    size_t need = ARENA_ROUND(size);
+
+    if (need < size)
+    {
+        return NULL;
+    }
+
+    if ((size_t)(arena->end - arena->pos) < need && 0 != arena_block(arena, need)) // 当前块剩下的部分丢弃
+    {
+        return NULL;
+    }
+
+    void *ptr = arena->pos;
+
+    arena->pos  += need;
+    arena->last  = ptr;
+    arena->used += need;
+    arena->peak  = (arena->used > arena->peak) ? arena->used : arena->peak;
+    arena->allocs++;
+    return ptr;
+}
+
+void* pe_arena_alloc(PPE_ARENA arena, size_t size)
+{
+    void *ptr = arena_take(arena, size);
+
+    if (NULL != ptr)
+    {
+        memset(ptr, 0, size);
+    }
+
+    return ptr;
+}
+
+void* pe_arena_array(PPE_ARENA arena, size_t count, size_t size)
+{
+    if (0 != size && count > (size_t)-1 / size)
+    {
+        return NULL;
+    }
+
+    return pe_arena_alloc(arena, count * size);
+}
+
+void* pe_arena_grow(PPE_ARENA arena, void *ptr, size_t old_size, size_t new_size)
+{
+    size_t old_need = ARENA_ROUND(old_size);
+    size_t new_need = ARENA_ROUND(new_size);
+
+    if (new_need < new_size)
+    {
+        return NULL;
+    }
+
+    if (NULL != ptr && ptr == arena->last && new_need <= (size_t)(arena->end - (UCHAR*)ptr))
+    {
+        arena->pos   = (UCHAR*)ptr + new_need;
+        arena->used += new_need - old_need;
+        arena->peak  = (arena->used > arena->peak) ? arena->used : arena->peak;
+        return ptr;
+    }
+
+    void *data = arena_take(arena, new_size);
+
+    if (NULL != data && NULL != ptr)
+    {
+        memcpy(data, ptr, old_size);
+    }
+
+    return data;
+}
+
+void pe_arena_reset(PPE_ARENA arena)
+{
+    if (NULL == arena->head)
+    {
+        return;
+    }
+
+    PPE_ARENA_BLOCK block = arena->head->next; // 新块比旧块大,只保留当前块
+
+    while (NULL != block)
+    {
+        PPE_ARENA_BLOCK next = block->next;
+
+        arena->reserved -= block->size;
+        free(block);
+        block = next;
+    }
+
+    arena->head->next = NULL;
+    arena->pos        = (UCHAR*)arena->head + ARENA_HEAD;
+    arena->last       = NULL;
+    arena->used       = 0;
+}
+
+void pe_arena_free(PPE_ARENA arena)
+{
+    pe_arena_reset(arena);
+    free(arena->head);
+
+    arena->head     = NULL;
+    arena->pos      = NULL;
+    arena->end      = NULL;
+    arena->reserved = 0;
+}
+
+/**
+ *\brief                        FNV-1a散列
+ *\param[in]    str             数据
+ *\param[in]    len             长度
+ *\return                       散列值
+ */
+static DWORD intern_hash(const char *str, size_t len)
+{
+    DWORD hash = 2166136261U;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        hash = (hash ^ (UCHAR)str[i]) * 16777619U;
+    }
+
+    return hash;
+}
+
+/**
+ *\brief                        散列表扩大一倍,重新放入所有名称
+ *\param[in]    table           驻留表
+ *\return                       0-成功,其它失败
+ */
+static int intern_rehash(PPE_INTERN table)
+{
+    DWORD     size = table->slot_count ? table->slot_count * 2 : 1024;
+    PPE_NAME *slot = calloc(size, sizeof(PPE_NAME));
+
+    if (NULL == slot)
+    {
+        return -1;
+    }
+
+    for (DWORD i = 0; i < table->slot_count; i++)
+    {
+        if (NULL != table->slot[i])
+        {
+            DWORD j = table->slot[i]->hash & (size - 1);
+
+            while (NULL != slot[j])
+            {
+                j = (j + 1) & (size - 1);
+            }
+
+            slot[j] = table->slot[i];
+        }
+    }
+
+    free(table->slot);
+    table->slot       = slot;
+    table->slot_count = size;
+    return 0;
+}
+
+const PE_NAME* pe_intern(PPE_INTERN table, const char *str, size_t len, DWORD flags)
+{
+    if (len > PE_INTERN_NAME_MAX)
+    {
+        return NULL;
+    }
+
+    if ((table->count + 1) * 2 > table->slot_count && 0 != intern_rehash(table)) // 负载不超过一半
+    {
+        return NULL;
+    }
+
+    DWORD hash = intern_hash(str, len);
+    DWORD mask = table->slot_count - 1;
+    DWORD i    = hash & mask;
+
+    table->lookups++;
+    table->bytes += len + 1;
+
+    for (; NULL != table->slot[i]; i = (i + 1) & mask)
+    {
+        PPE_NAME name = table->slot[i];
+
+        if (name->hash == hash && name->len == len && 0 == memcmp(name->str, str, len))
+        {
+            return name;
+        }
+    }
+
+    if (table->arena.reserved >= PE_INTERN_BYTES_MAX)
+    {
+        table->full++;
+        return NULL;
+    }
+
+    PPE_NAME name = arena_take(&table->arena, sizeof(PE_NAME) + len + 1);
+
+    if (NULL == name)
+    {
+        return NULL;
+    }
+
+    char *copy = (char*)(name + 1);
+
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    name->str   = copy;
+    name->len   = (DWORD)len;
+    name->flags = flags;
+    name->hash  = hash;
+
+    table->slot[i] = name;
+    table->count++;
+    return name;
+}
+
+void pe_intern_free(PPE_INTERN table)
+{
+    pe_arena_free(&table->arena);
+    free(table->slot);
+    memset(table, 0, sizeof(PE_INTERN));
+}
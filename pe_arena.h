@@ -0,0 +1,127 @@
+/**
+ *\file     pe_arena.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    解析结果的内存池和名称驻留表
+ *          一个文件的解析结构(节,索引,导入库,导入函数,重定位块)都从内存池顺序分配,
+ *          用完后一次释放.批量扫描时每个线程的内存池在文件之间复用,清空时保留最大的块,
+ *          大小相近的文件解析时不再调用malloc.
+ *          名称驻留表每个线程一个,kernel32.dll,GetProcAddress等在很多文件中重复的名称只保存一份,
+ *          解析时填写导入库和导入函数的名称,输出时不用再查找结尾和检查字符
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#ifndef _PE_ARENA_H_
+#define _PE_ARENA_H_
+
+#include "platform.h"
+
+#define PE_ARENA_FIRST          (16 * 1024)                                 ///< 第一个块的长度,之后每块加倍
+#define PE_ARENA_ALIGN          16                                          ///< 分配的对齐
+
+#define PE_INTERN_NAME_MAX      4096                                        ///< 驻留名称的最大长度,更长的不驻留
+#define PE_INTERN_BYTES_MAX     (64 * 1024 * 1024)                          ///< 驻留表最多占用的内存,超过后不再加入新名称
+
+typedef struct _PE_ARENA_BLOCK                                              ///  内存块,数据紧随其后
+{
+    struct _PE_ARENA_BLOCK *next;                                           ///< 前一个块
+    size_t          size;                                                   ///< 数据长度
+
+} PE_ARENA_BLOCK, *PPE_ARENA_BLOCK;
+
+typedef struct _PE_ARENA                                                    ///  内存池,不是线程安全的
+{
+    PPE_ARENA_BLOCK head;                                                   ///< 当前块,链表
+    UCHAR          *pos;                                                    ///< 当前块的空闲位置
+    UCHAR          *end;                                                    ///< 当前块的结尾
+    void           *last;                                                   ///< 最后一次分配的位置,可以原地扩大
+    size_t          used;                                                   ///< 清空后分配的字节数,包括对齐和扩大时丢弃的部分
+    size_t          peak;                                                   ///< used的最大值
+    size_t          reserved;                                               ///< 所有块的长度
+    ULONGLONG       allocs;                                                 ///< 分配次数,累计
+    ULONGLONG       blocks;                                                 ///< 调用malloc的次数,累计
+
+} PE_ARENA, *PPE_ARENA;
+
+typedef struct _PE_NAME                                                     ///  驻留的名称,保存期间地址不变
+{
+    const char     *str;                                                    ///< 名称,以0结尾
+    DWORD           len;                                                    ///< 长度
+    DWORD           flags;                                                  ///< PE_STR_*
+    DWORD           hash;                                                   ///< 散列值
+
+} PE_NAME, *PPE_NAME;
+
+typedef struct _PE_INTERN                                                   ///  名称驻留表,每个线程一个
+{
+    PE_ARENA        arena;                                                  ///< 名称和项
+    PPE_NAME       *slot;                                                   ///< 开放寻址散列表,NULL为空
+    DWORD           slot_count;                                             ///< 散列表长度,2的幂
+    DWORD           count;                                                  ///< 名称数
+    ULONGLONG       lookups;                                                ///< 查找次数
+    ULONGLONG       bytes;                                                  ///< 查找的名称总长度,不驻留时需要保存的字节数
+    ULONGLONG       full;                                                   ///< 超过内存限制没有加入的次数
+
+} PE_INTERN, *PPE_INTERN;
+
+/**
+ *\brief                        分配内存,内容清0
+ *\param[in]    arena           内存池
+ *\param[in]    size            长度
+ *\return                       内存,失败时为NULL
+ */
+void* pe_arena_alloc(PPE_ARENA arena, size_t size);
+
+/**
+ *\brief                        分配数组,内容清0,检查长度溢出
+ *\param[in]    arena           内存池
+ *\param[in]    count           项数
+ *\param[in]    size            每项长度
+ *\return                       内存,失败时为NULL
+ */
+void* pe_arena_array(PPE_ARENA arena, size_t count, size_t size);
+
+/**
+ *\brief                        扩大已分配的内存,是最后一次分配并且当前块足够时原地扩大,否则分配新的并复制
+ *\param[in]    arena           内存池
+ *\param[in]    ptr             原来的内存,可以为NULL
+ *\param[in]    old_size        原来的长度
+ *\param[in]    new_size        新的长度,大于old_size,增加的部分不清0
+ *\return                       内存,失败时为NULL,原来的内存不变
+ */
+void* pe_arena_grow(PPE_ARENA arena, void *ptr, size_t old_size, size_t new_size);
+
+/**
+ *\brief                        清空内存池,之前分配的内存都不能再使用,保留最大的块给下次使用
+ *\param[in]    arena           内存池
+ *\return                       无
+ */
+void pe_arena_reset(PPE_ARENA arena);
+
+/**
+ *\brief                        释放内存池的所有块
+ *\param[in]    arena           内存池
+ *\return                       无
+ */
+void pe_arena_free(PPE_ARENA arena);
+
+/**
+ *\brief                        得到驻留的名称,没有时加入
+ *\param[in]    table           驻留表
+ *\param[in]    str             名称,不要求以0结尾
+ *\param[in]    len             长度
+ *\param[in]    flags           PE_STR_*,加入时保存
+ *\return                       驻留的名称,名称太长,超过内存限制或内存不足时为NULL
+ */
+const PE_NAME* pe_intern(PPE_INTERN table, const char *str, size_t len, DWORD flags);
+
+/**
+ *\brief                        释放驻留表
+ *\param[in]    table           驻留表
+ *\return                       无
+ */
+void pe_intern_free(PPE_INTERN table);
+
+#endif
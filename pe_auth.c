@@ -0,0 +1,719 @@
+/**
+ *\file     pe_auth.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    Authenticode签名和摘要实现
+ *          PKCS#7按DER逐层取出需要的项,长度都先检查在上一层的范围内,不支持BER的不定长度.
+ *          流水线中读线程只在环形缓冲区满时等待,散列线程只在空时等待,同一个条件变量不会同时有两个等待者
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#include "pe_auth.h"
+
+/// 解析结构使用的内存池
+#define ARENA(image)            ((NULL != (image)->pool) ? (image)->pool : &(image)->arena)
+
+#define DER_SEQUENCE            0x30                                        ///< SEQUENCE
+#define DER_SET                 0x31                                        ///< SET
+#define DER_INTEGER             0x02                                        ///< INTEGER
+#define DER_OCTETS              0x04                                        ///< OCTET STRING
+#define DER_OID                 0x06                                        ///< OBJECT IDENTIFIER
+#define DER_CONTEXT0            0xA0                                        ///< [0],构造类型
+
+/// DER项的内容与OID相同
+#define DER_IS(item, oid)       ((item).len == sizeof(oid) && 0 == memcmp((item).data, oid, sizeof(oid)))
+
+static const UCHAR g_oid_signed[]   = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x01, 0x07, 0x02 };       ///< 1.2.840.113549.1.7.2 signedData
+static const UCHAR g_oid_spc[]      = { 0x2B, 0x06, 0x01, 0x04, 0x01, 0x82, 0x37, 0x02, 0x01, 0x04 }; ///< 1.3.6.1.4.1.311.2.1.4 SpcIndirectDataContent
+static const UCHAR g_oid_md5[]      = { 0x2A, 0x86, 0x48, 0x86, 0xF7, 0x0D, 0x02, 0x05 };             ///< 1.2.840.113549.2.5
+static const UCHAR g_oid_sha1[]     = { 0x2B, 0x0E, 0x03, 0x02, 0x1A };                               ///< 1.3.14.3.2.26
+static const UCHAR g_oid_sha256[]   = { 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01 };       ///< 2.16.840.1.101.3.4.2.1
+static const UCHAR g_oid_sha384[]   = { 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x02 };       ///< 2.16.840.1.101.3.4.2.2
+static const UCHAR g_oid_sha512[]   = { 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x03 };       ///< 2.16.840.1.101.3.4.2.3
+
+static const char *g_auth_alg[] = { "-", "md5", "sha1", "sha256", "sha384", "sha512", "unknown" };   ///< 按PE_AUTH_ALG_*排列
+
+typedef struct _AUTH_DER                                                    ///  DER编码的一项
+{
+    UCHAR           tag;                                                    ///< 标记
+    const UCHAR    *data;                                                   ///< 内容
+    size_t          len;                                                    ///< 内容长度
+
+} AUTH_DER, *PAUTH_DER;
+
+typedef struct _AUTH_HASH                                                   ///  按算法选择的散列状态
+{
+    int             alg;                                                    ///< PE_AUTH_ALG_MD5,SHA1或SHA256
+
+    union
+    {
+        HASH_MD5    md5;                                                    ///< MD5状态
+        HASH_SHA1   sha1;                                                   ///< SHA-1状态
+        HASH_SHA256 sha256;                                                 ///< SHA-256状态
+    } ctx;
+
+} AUTH_HASH, *PAUTH_HASH;
+
+typedef struct _AUTH_PIPE                                                   ///  读线程和散列线程共享的环形缓冲区
+{
+    FILE           *fp;                                                     ///< 文件
+    PPE_AUTH        auth;                                                   ///< 参与散列的各段
+    UCHAR          *buff;                                                   ///< depth个块
+    size_t         *len;                                                    ///< 每个块读入的长度
+    size_t          block;                                                  ///< 块大小
+    DWORD           depth;                                                  ///< 块数
+    ULONGLONG       head;                                                   ///< 读入的块数
+    ULONGLONG       tail;                                                   ///< 散列完的块数
+    int             done;                                                   ///< 1-读完了所有段
+    int             error;                                                  ///< 1-读取失败
+    mutex_t         lock;                                                   ///< 锁
+    cond_t          cond;                                                   ///< 读入或散列完一块时唤醒另一方
+
+} AUTH_PIPE, *PAUTH_PIPE;
+
+const char* pe_auth_alg(int alg)
+{
+    return (alg >= 0 && (size_t)alg < SIZEOF(g_auth_alg)) ? g_auth_alg[alg] : g_auth_alg[PE_AUTH_ALG_UNKNOWN];
+}
+
+const char* pe_auth_status(PPE_AUTH auth)
+{
+    int cert = (0 != (auth->flags & PE_AUTH_CERT));
+
+    if (!auth->cert)
+    {
+        return "unsigned";
+    }
+
+    if (cert && (auth->cert_bad || !auth->pkcs7))
+    {
+        return "bad";
+    }
+
+    if (cert && auth->alg != auth->hash_alg)
+    {
+        return "unsupported";
+    }
+
+    if (!cert || !auth->hashed)
+    {
+        return "unchecked";
+    }
+
+    return auth->match ? "match" : "mismatch";
+}
+
+/**
+ *\brief                        读一个DER项,只支持单字节标记和不超过4字节的长度
+ *\param[in,out] p              当前位置,成功时移到下一项
+ *\param[in]    end             上一层内容的结尾
+ *\param[out]   item            项
+ *\return                       0-成功,-1-超出范围或不支持的编码
+ */
+static int der_next(const UCHAR **p, const UCHAR *end, PAUTH_DER item)
+{
+    const UCHAR *q = *p;
+
+    if (end - q < 2 || 0x1F == (q[0] & 0x1F))
+    {
+        return -1;
+    }
+
+    size_t len = q[1];
+
+    item->tag = q[0];
+    q += 2;
+
+    if (len & 0x80) // 长格式,0x80为不定长度
+    {
+        size_t bytes = len & 0x7F;
+
+        if (0 == bytes || bytes > 4 || (size_t)(end - q) < bytes)
+        {
+            return -1;
+        }
+
+        for (len = 0; bytes > 0; bytes--)
+        {
+            len = (len << 8) | *q++;
+        }
+    }
+
+    if ((size_t)(end - q) < len)
+    {
+        return -1;
+    }
+
+    item->data = q;
+    item->len  = len;
+    *p         = q + len;
+    return 0;
+}
+
+/**
+ *\brief                        读一个指定标记的DER项
+ *\param[in,out] p              当前位置
+ *\param[in]    end             上一层内容的结尾
+ *\param[in]    tag             需要的标记
+ *\param[out]   item            项
+ *\return                       0-成功,-1-失败或标记不同
+ */
+static int der_expect(const UCHAR **p, const UCHAR *end, UCHAR tag, PAUTH_DER item)
+{
+    return (0 == der_next(p, end, item) && tag == item->tag) ? 0 : -1;
+}
+
+/**
+ *\brief                        计算构造类型中的项数
+ *\param[in]    item            构造类型的项
+ *\return                       能解码的项数
+ */
+static DWORD der_count(PAUTH_DER item)
+{
+    const UCHAR *p     = item->data;
+    const UCHAR *end   = p + item->len;
+    DWORD        count = 0;
+    AUTH_DER     sub;
+
+    while (p < end && 0 == der_next(&p, end, &sub))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ *\brief                        摘要算法的OID转成PE_AUTH_ALG_*
+ *\param[in]    oid             OID项
+ *\return                       PE_AUTH_ALG_*
+ */
+static int der_alg(PAUTH_DER oid)
+{
+    if (DER_IS(*oid, g_oid_md5))
+    {
+        return PE_AUTH_ALG_MD5;
+    }
+
+    if (DER_IS(*oid, g_oid_sha1))
+    {
+        return PE_AUTH_ALG_SHA1;
+    }
+
+    if (DER_IS(*oid, g_oid_sha256))
+    {
+        return PE_AUTH_ALG_SHA256;
+    }
+
+    if (DER_IS(*oid, g_oid_sha384))
+    {
+        return PE_AUTH_ALG_SHA384;
+    }
+
+    return DER_IS(*oid, g_oid_sha512) ? PE_AUTH_ALG_SHA512 : PE_AUTH_ALG_UNKNOWN;
+}
+
+/**
+ *\brief                        解码PKCS#7: ContentInfo{signedData, [0]{SignedData{版本, 摘要算法集,
+ *                              contentInfo{SpcIndirectDataContent, [0]{{data, DigestInfo{算法, 摘要}}}},
+ *                              [0]证书, [1]CRL, 签名者集}}}
+ *\param[in,out] auth           签名和摘要
+ *\param[in]    data            WIN_CERTIFICATE头后面的数据
+ *\param[in]    len             数据长度
+ *\return                       无
+ */
+static void auth_pkcs7(PPE_AUTH auth, const UCHAR *data, size_t len)
+{
+    const UCHAR *p   = data;
+    const UCHAR *end = data + len;
+    AUTH_DER     item;
+    AUTH_DER     content;
+
+    if (0 != der_expect(&p, end, DER_SEQUENCE, &item))
+    {
+        return;
+    }
+
+    end = item.data + item.len;
+    p   = item.data;
+
+    if (0 != der_expect(&p, end, DER_OID, &item) || !DER_IS(item, g_oid_signed) ||
+        0 != der_expect(&p, end, DER_CONTEXT0, &item))
+    {
+        return;
+    }
+
+    end = item.data + item.len;
+    p   = item.data;
+
+    if (0 != der_expect(&p, end, DER_SEQUENCE, &item))
+    {
+        return;
+    }
+
+    end = item.data + item.len;
+    p   = item.data;
+
+    if (0 != der_expect(&p, end, DER_INTEGER, &item) || 0 != der_expect(&p, end, DER_SET, &item) ||
+        0 != der_expect(&p, end, DER_SEQUENCE, &content))
+    {
+        return;
+    }
+
+    while (p < end && 0 == der_next(&p, end, &item)) // 可选的证书和CRL,最后是签名者集
+    {
+        if (DER_CONTEXT0 == item.tag)
+        {
+            auth->certs = der_count(&item);
+        }
+        else if (DER_SET == item.tag)
+        {
+            auth->signers = der_count(&item);
+        }
+    }
+
+    end = content.data + content.len;
+    p   = content.data;
+
+    if (0 != der_expect(&p, end, DER_OID, &item) || !DER_IS(item, g_oid_spc) ||
+        0 != der_expect(&p, end, DER_CONTEXT0, &item))
+    {
+        return;
+    }
+
+    end = item.data + item.len;
+    p   = item.data;
+
+    if (0 != der_expect(&p, end, DER_SEQUENCE, &item))
+    {
+        return;
+    }
+
+    end = item.data + item.len;
+    p   = item.data;
+
+    if (0 != der_expect(&p, end, DER_SEQUENCE, &item) || 0 != der_expect(&p, end, DER_SEQUENCE, &item))
+    {
+        return;
+    }
+
+    end = item.data + item.len;
+    p   = item.data;
+
+    AUTH_DER     alg;
+    AUTH_DER     digest;
+    const UCHAR *q = NULL;
+
+    if (0 != der_expect(&p, end, DER_SEQUENCE, &alg) || 0 != der_expect(&p, end, DER_OCTETS, &digest) ||
+        0 == digest.len || digest.len > PE_AUTH_DIGEST_MAX)
+    {
+        return;
+    }
+
+    q = alg.data;
+
+    if (0 != der_expect(&q, alg.data + alg.len, DER_OID, &item))
+    {
+        return;
+    }
+
+    auth->pkcs7      = 1;
+    auth->alg        = der_alg(&item);
+    auth->signed_len = (DWORD)digest.len;
+    memcpy(auth->signed_digest, digest.data, digest.len);
+}
+
+/**
+ *\brief                        找到证书表,解码其中的WIN_CERTIFICATE和第一个PKCS#7
+ *\param[in]    image           解析结果
+ *\param[in,out] auth           签名和摘要,已取得证书表的位置
+ *\return                       0-成功,-1-内存不足
+ */
+static int auth_cert(PPE_IMAGE image, PPE_AUTH auth)
+{
+    const UCHAR *table = image->view.data + auth->cert_fa;
+    ULONGLONG    pos   = 0;
+    int          pkcs7 = 0;
+
+    for (; auth->count < PE_AUTH_CERT_MAX && pos + PE_AUTH_HEAD <= auth->cert_size; auth->count++) // 先计数
+    {
+        DWORD len = le32(table + pos);
+
+        if (len < PE_AUTH_HEAD || len > auth->cert_size - pos)
+        {
+            break;
+        }
+
+        pos += ((ULONGLONG)len + 7) & ~(ULONGLONG)7; // 每项按8字节对齐
+    }
+
+    if (0 == auth->count)
+    {
+        auth->cert_bad = 1;
+        return 0;
+    }
+
+    auth->entry = pe_arena_array(ARENA(image), auth->count, sizeof(PE_AUTH_ENTRY));
+
+    if (NULL == auth->entry)
+    {
+        return -1;
+    }
+
+    pos = 0;
+
+    for (DWORD i = 0; i < auth->count; i++)
+    {
+        PPE_AUTH_ENTRY entry = &auth->entry[i];
+
+        entry->fa       = auth->cert_fa + (DWORD)pos;
+        entry->length   = le32(table + pos);
+        entry->revision = le16(table + pos + 4);
+        entry->type     = le16(table + pos + 6);
+
+        if (PE_AUTH_TYPE_PKCS7 == entry->type && !pkcs7) // 只解码第一个
+        {
+            auth_pkcs7(auth, table + pos + PE_AUTH_HEAD, entry->length - PE_AUTH_HEAD);
+            pkcs7 = 1;
+        }
+
+        pos += ((ULONGLONG)entry->length + 7) & ~(ULONGLONG)7;
+    }
+
+    return 0;
+}
+
+/**
+ *\brief                        计算参与散列的各段,跳过的部分按开始位置排序后从文件中扣除
+ *\param[in]    image           解析结果
+ *\param[in,out] auth           签名和摘要,已取得证书表的位置
+ *\return                       无
+ */
+static void auth_ranges(PPE_IMAGE image, PPE_AUTH auth)
+{
+    ULONGLONG size    = image->view.size;
+    DWORD     dir_off = (PE_MAGIC_64 == image->magic) ? offsetof(IMAGE_OPTIONAL_HEADER64, DataDirectory)
+                                                      : offsetof(IMAGE_OPTIONAL_HEADER32, DataDirectory);
+    ULONGLONG skip[3][2] = {                                                // 开始,结尾
+        { image->opt_fa + offsetof(IMAGE_OPTIONAL_HEADER32, CheckSum), 0 },
+        { image->opt_fa + dir_off + PE_DIR_SECURITY * sizeof(IMAGE_DATA_DIRECTORY), 0 },
+        { auth->cert_fa, (ULONGLONG)auth->cert_fa + auth->cert_size },
+    };
+    int       count = auth->cert ? 3 : 2;
+    ULONGLONG pos   = 0;
+
+    skip[0][1] = skip[0][0] + 4;
+    skip[1][1] = skip[1][0] + sizeof(IMAGE_DATA_DIRECTORY);
+
+    if (count > 2 && skip[2][0] < skip[1][0]) // 证书表不在文件末尾时位置可能在头部,最多3项,直接插入
+    {
+        ULONGLONG fa  = skip[2][0];
+        ULONGLONG end = skip[2][1];
+        int       i   = (fa < skip[0][0]) ? 0 : 1;
+
+        memmove(skip[i + 1], skip[i], (2 - i) * sizeof(skip[0]));
+        skip[i][0] = fa;
+        skip[i][1] = end;
+    }
+
+    auth->range_count = 0;
+
+    for (int i = 0; i <= count; i++)
+    {
+        ULONGLONG end = (i < count) ? skip[i][0] : size;
+
+        end = (end < size) ? end : size;
+
+        if (end > pos)
+        {
+            auth->range[auth->range_count].fa   = pos;
+            auth->range[auth->range_count].size = end - pos;
+            auth->range_count++;
+        }
+
+        if (i < count && skip[i][1] > pos)
+        {
+            pos = skip[i][1];
+        }
+    }
+}
+
+/**
+ *\brief                        开始散列
+ *\param[out]   hash            散列状态
+ *\param[in]    alg             PE_AUTH_ALG_MD5,SHA1或SHA256
+ *\return                       无
+ */
+static void auth_hash_init(PAUTH_HASH hash, int alg)
+{
+    hash->alg = alg;
+
+    if (PE_AUTH_ALG_MD5 == alg)
+    {
+        hash_md5_init(&hash->ctx.md5);
+    }
+    else if (PE_AUTH_ALG_SHA1 == alg)
+    {
+        hash_sha1_init(&hash->ctx.sha1);
+    }
+    else
+    {
+        hash_sha256_init(&hash->ctx.sha256);
+    }
+}
+
+/**
+ *\brief                        输入一段数据
+ *\param[in]    hash            散列状态
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\return                       无
+ */
+static void auth_hash_update(PAUTH_HASH hash, const void *data, size_t len)
+{
+    if (PE_AUTH_ALG_MD5 == hash->alg)
+    {
+        hash_md5_update(&hash->ctx.md5, data, len);
+    }
+    else if (PE_AUTH_ALG_SHA1 == hash->alg)
+    {
+        hash_sha1_update(&hash->ctx.sha1, data, len);
+    }
+    else
+    {
+        hash_sha256_update(&hash->ctx.sha256, data, len);
+    }
+}
+
+/**
+ *\brief                        得到摘要,与签名中的摘要比较
+ *\param[in]    hash            散列状态
+ *\param[in,out] auth           签名和摘要
+ *\return                       无
+ */
+static void auth_hash_final(PAUTH_HASH hash, PPE_AUTH auth)
+{
+    if (PE_AUTH_ALG_MD5 == hash->alg)
+    {
+        hash_md5_final(&hash->ctx.md5, auth->digest);
+        auth->digest_len = HASH_MD5_SIZE;
+    }
+    else if (PE_AUTH_ALG_SHA1 == hash->alg)
+    {
+        hash_sha1_final(&hash->ctx.sha1, auth->digest);
+        auth->digest_len = HASH_SHA1_SIZE;
+    }
+    else
+    {
+        hash_sha256_final(&hash->ctx.sha256, auth->digest);
+        auth->digest_len = HASH_SHA256_SIZE;
+    }
+
+    auth->hashed = 1;
+    auth->match  = auth->pkcs7 && auth->alg == auth->hash_alg && auth->signed_len == auth->digest_len &&
+                   0 == memcmp(auth->signed_digest, auth->digest, auth->digest_len);
+}
+
+int pe_auth(PPE_IMAGE image, DWORD flags)
+{
+    PPE_AUTH auth = pe_arena_alloc(ARENA(image), sizeof(PE_AUTH));
+
+    if (NULL == auth)
+    {
+        return -1;
+    }
+
+    memset(auth, 0, sizeof(PE_AUTH));
+    auth->flags     = flags;
+    auth->cert_fa   = (image->dir_count > PE_DIR_SECURITY) ? image->dir[PE_DIR_SECURITY].VirtualAddress : 0;
+    auth->cert_size = (image->dir_count > PE_DIR_SECURITY) ? image->dir[PE_DIR_SECURITY].Size : 0;
+    auth->cert      = (0 != auth->cert_fa && 0 != auth->cert_size);
+    auth->cert_bad  = auth->cert && !VIEW_HAS(&image->view, auth->cert_fa, auth->cert_size);
+
+    if (auth->cert && !auth->cert_bad && (flags & PE_AUTH_CERT) && 0 != auth_cert(image, auth))
+    {
+        return -2;
+    }
+
+    auth_ranges(image, auth);
+
+    // 签名中的算法不能计算时用SHA-256,结果为unsupported
+    auth->hash_alg = (auth->alg >= PE_AUTH_ALG_MD5 && auth->alg <= PE_AUTH_ALG_SHA256) ? auth->alg : PE_AUTH_ALG_SHA256;
+
+    if (flags & PE_AUTH_HASH)
+    {
+        AUTH_HASH hash;
+
+        auth_hash_init(&hash, auth->hash_alg);
+
+        for (DWORD i = 0; i < auth->range_count; i++)
+        {
+            auth_hash_update(&hash, image->view.data + auth->range[i].fa, (size_t)auth->range[i].size);
+            auth->bytes += auth->range[i].size;
+        }
+
+        auth_hash_final(&hash, auth);
+    }
+
+    image->auth = auth;
+    return 0;
+}
+
+/**
+ *\brief                        读线程:按段把文件读入环形缓冲区,每块不超过block字节
+ *\param[in]    param           环形缓冲区
+ *\return                       无
+ */
+static void auth_read_proc(void *param)
+{
+    PAUTH_PIPE pipe = (PAUTH_PIPE)param;
+    PPE_AUTH   auth = pipe->auth;
+
+    for (DWORD i = 0; i < auth->range_count && !pipe->error; i++)
+    {
+        ULONGLONG fa  = auth->range[i].fa;
+        ULONGLONG end = fa + auth->range[i].size;
+
+        while (fa < end)
+        {
+            size_t len = (end - fa < pipe->block) ? (size_t)(end - fa) : pipe->block;
+
+            mutex_lock(&pipe->lock);
+
+            while (pipe->head - pipe->tail >= pipe->depth)
+            {
+                cond_wait(&pipe->cond, &pipe->lock);
+            }
+
+            mutex_unlock(&pipe->lock);
+
+            DWORD  slot = (DWORD)(pipe->head % pipe->depth);
+            size_t got  = file_read_at(pipe->fp, fa, pipe->buff + slot * pipe->block, len);
+
+            mutex_lock(&pipe->lock);
+            pipe->len[slot] = got;
+            pipe->head++;
+            pipe->error     = (got != len);
+            cond_signal(&pipe->cond);
+            mutex_unlock(&pipe->lock);
+
+            if (got != len)
+            {
+                return;
+            }
+
+            fa += len;
+        }
+    }
+
+    mutex_lock(&pipe->lock);
+    pipe->done = 1;
+    cond_signal(&pipe->cond);
+    mutex_unlock(&pipe->lock);
+}
+
+int pe_auth_file(PPE_IMAGE image, const char *path, size_t block, DWORD depth)
+{
+    ULONGLONG size  = 0;
+    ULONGLONG mtime = 0;
+    AUTH_PIPE pipe  = { 0 };
+    AUTH_HASH hash;
+    thread_t  thread;
+
+    if (NULL == image->auth && 0 != pe_auth(image, PE_AUTH_CERT))
+    {
+        return PE_ERR_MEMORY;
+    }
+
+    if (0 != file_stat(path, &size, &mtime, NULL) || size != image->view.size)
+    {
+        return 1;
+    }
+
+    pipe.fp    = file_open(path, "rb");
+    pipe.auth  = image->auth;
+    pipe.block = (0 != block) ? block : PE_AUTH_BLOCK;
+    pipe.depth = (0 != depth) ? depth : PE_AUTH_DEPTH;
+    pipe.buff  = malloc(pipe.block * pipe.depth);
+    pipe.len   = malloc(pipe.depth * sizeof(size_t));
+
+    int ret = (NULL == pipe.fp) ? 1 : (NULL == pipe.buff || NULL == pipe.len) ? PE_ERR_MEMORY : 0;
+
+    if (0 == ret)
+    {
+        mutex_init(&pipe.lock);
+        cond_init(&pipe.cond);
+
+        if (0 != thread_create(&thread, auth_read_proc, &pipe))
+        {
+            ret = PE_ERR_MEMORY;
+        }
+    }
+
+    if (0 == ret)
+    {
+        PPE_AUTH auth = image->auth;
+
+        auth->bytes = 0;
+        auth_hash_init(&hash, auth->hash_alg);
+
+        for (;;)
+        {
+            mutex_lock(&pipe.lock);
+
+            while (pipe.tail == pipe.head && !pipe.done && !pipe.error)
+            {
+                cond_wait(&pipe.cond, &pipe.lock);
+            }
+
+            int empty = (pipe.tail == pipe.head);
+
+            mutex_unlock(&pipe.lock);
+
+            if (empty)
+            {
+                break;
+            }
+
+            DWORD slot = (DWORD)(pipe.tail % pipe.depth);
+
+            auth_hash_update(&hash, pipe.buff + slot * pipe.block, pipe.len[slot]);
+            auth->bytes += pipe.len[slot];
+
+            mutex_lock(&pipe.lock);
+            pipe.tail++;
+            cond_signal(&pipe.cond);
+            mutex_unlock(&pipe.lock);
+        }
+
+        thread_join(thread);
+
+        if (pipe.error)
+        {
+            ret = 1;
+        }
+        else
+        {
+            auth->pipe   = 1;
+            auth->flags |= PE_AUTH_HASH;
+            auth_hash_final(&hash, auth);
+        }
+    }
+
+    if (NULL != pipe.fp)
+    {
+        if (NULL != pipe.buff && NULL != pipe.len)
+        {
+            cond_free(&pipe.cond);
+            mutex_free(&pipe.lock);
+        }
+
+        fclose(pipe.fp);
+    }
+
+    free(pipe.buff);
+    free(pipe.len);
+    return ret;
+}
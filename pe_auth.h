@@ -0,0 +1,127 @@
+/**
+ *\file     pe_auth.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    Authenticode签名和摘要
+ *          证书表(数据目录4)的地址是文件位置,不装入内存,通常在文件末尾,由8字节对齐的WIN_CERTIFICATE组成.
+ *          PKCS#7 SignedData的内容是SpcIndirectDataContent,其中的DigestInfo是文件的Authenticode摘要.
+ *          摘要按文件顺序散列整个文件,跳过OPTION头中的校验和,证书表的数据目录项和证书表本身,
+ *          即最多4段:[0,校验和) [校验和+4,数据目录项) [数据目录项+8,证书表) [证书表结尾,文件结尾).
+ *          只比较计算的摘要和签名中的摘要,不验证签名和证书链,只解码第一个PKCS#7,不解码嵌套的签名.
+ *          大文件可以按路径用流水线计算:读线程按块读入环形缓冲区,调用线程同时散列已读入的块
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#ifndef _PE_AUTH_H_
+#define _PE_AUTH_H_
+
+#include "pe.h"
+#include "hash.h"
+
+#define PE_AUTH_CERT            0x01                                        ///< 解码证书表和PKCS#7
+#define PE_AUTH_HASH            0x02                                        ///< 在解析结果的数据上计算摘要
+#define PE_AUTH_ALL             0x03                                        ///< 所有项
+
+#define PE_AUTH_ALG_NONE        0                                           ///< 没有摘要算法
+#define PE_AUTH_ALG_MD5         1                                           ///< MD5
+#define PE_AUTH_ALG_SHA1        2                                           ///< SHA-1
+#define PE_AUTH_ALG_SHA256      3                                           ///< SHA-256
+#define PE_AUTH_ALG_SHA384      4                                           ///< SHA-384,识别但不计算
+#define PE_AUTH_ALG_SHA512      5                                           ///< SHA-512,识别但不计算
+#define PE_AUTH_ALG_UNKNOWN     6                                           ///< 不认识的算法
+
+#define PE_AUTH_REVISION        0x0200                                      ///< WIN_CERT_REVISION_2_0
+#define PE_AUTH_TYPE_PKCS7      0x0002                                      ///< WIN_CERT_TYPE_PKCS_SIGNED_DATA
+#define PE_AUTH_HEAD            8                                           ///< WIN_CERTIFICATE头:长度,版本,类型
+#define PE_AUTH_CERT_MAX        64                                          ///< 最多解码的WIN_CERTIFICATE数
+#define PE_AUTH_DIGEST_MAX      64                                          ///< 签名中摘要的最大长度
+#define PE_AUTH_RANGES          4                                           ///< 散列的最多段数
+
+#define PE_AUTH_BLOCK           (1024 * 1024)                               ///< 流水线默认的块大小
+#define PE_AUTH_DEPTH           4                                           ///< 流水线默认的块数
+#define PE_AUTH_PIPE_MIN        (8 * 1024 * 1024)                           ///< 使用流水线的最小文件长度
+
+typedef struct _PE_AUTH_ENTRY                                               ///  证书表中的一项WIN_CERTIFICATE
+{
+    DWORD           fa;                                                     ///< 在文件中的位置
+    DWORD           length;                                                 ///< dwLength,包括头
+    WORD            revision;                                               ///< wRevision,PE_AUTH_REVISION
+    WORD            type;                                                   ///< wCertificateType,PE_AUTH_TYPE_*
+
+} PE_AUTH_ENTRY, *PPE_AUTH_ENTRY;
+
+typedef struct _PE_AUTH_RANGE                                               ///  参与散列的一段文件
+{
+    ULONGLONG       fa;                                                     ///< 开始位置
+    ULONGLONG       size;                                                   ///< 长度
+
+} PE_AUTH_RANGE, *PPE_AUTH_RANGE;
+
+typedef struct _PE_AUTH                                                     ///  Authenticode签名和摘要
+{
+    DWORD           flags;                                                  ///< 计算了哪几项,PE_AUTH_*
+    int             cert;                                                   ///< 1-数据目录中有证书表
+    int             cert_bad;                                               ///< 1-证书表超出文件
+    DWORD           cert_fa;                                                ///< 证书表在文件中的位置
+    DWORD           cert_size;                                              ///< 证书表的长度
+    PPE_AUTH_ENTRY  entry;                                                  ///< WIN_CERTIFICATE
+    DWORD           count;                                                  ///< WIN_CERTIFICATE数量
+
+    int             pkcs7;                                                  ///< 1-第一个PKCS#7解码出了摘要
+    int             alg;                                                    ///< 签名中的摘要算法,PE_AUTH_ALG_*
+    UCHAR           signed_digest[PE_AUTH_DIGEST_MAX];                      ///< 签名中的摘要
+    DWORD           signed_len;                                             ///< 签名中的摘要长度
+    DWORD           certs;                                                  ///< SignedData中的证书数
+    DWORD           signers;                                                ///< SignedData中的签名者数
+
+    int             hashed;                                                 ///< 1-计算了摘要
+    int             hash_alg;                                               ///< 计算摘要的算法,签名中的算法,不能计算时为SHA-256
+    UCHAR           digest[HASH_SHA256_SIZE];                               ///< 计算的摘要
+    DWORD           digest_len;                                             ///< 计算的摘要长度
+    int             match;                                                  ///< 1-计算的摘要与签名中的相同
+    int             pipe;                                                   ///< 1-按路径用流水线计算
+    ULONGLONG       bytes;                                                  ///< 散列的字节数
+
+    PE_AUTH_RANGE   range[PE_AUTH_RANGES];                                  ///< 参与散列的各段
+    DWORD           range_count;                                            ///< 段数
+
+} PE_AUTH, *PPE_AUTH;
+
+/**
+ *\brief                        解码证书表和第一个PKCS#7,计算参与散列的各段,需要时在解析结果的数据上计算摘要.
+ *                              结果从解析结果的内存池分配,保存到image->auth
+ *\param[in]    image           解析结果,至少解析了头部
+ *\param[in]    flags           需要的项,PE_AUTH_*,各段总是计算
+ *\return                       0-成功,其它失败(内存不足)
+ */
+int pe_auth(PPE_IMAGE image, DWORD flags);
+
+/**
+ *\brief                        按路径用流水线计算摘要:读线程用file_read_at读入depth个block字节的环形缓冲区,
+ *                              调用线程同时散列,只读参与散列的各段,不读证书表.没有image->auth时先解码证书表
+ *\param[in]    image           解析结果,文件长度为image->view.size
+ *\param[in]    path            文件路径,内容必须与解析结果相同
+ *\param[in]    block           块大小,0为PE_AUTH_BLOCK
+ *\param[in]    depth           块数,0为PE_AUTH_DEPTH
+ *\return                       0-成功,1-打开或读取失败(文件长度变了),其它失败(内存不足)
+ */
+int pe_auth_file(PPE_IMAGE image, const char *path, size_t block, DWORD depth);
+
+/**
+ *\brief                        得到摘要算法的名称
+ *\param[in]    alg             PE_AUTH_ALG_*
+ *\return                       md5,sha1,sha256,sha384,sha512,unknown,没有算法时为-
+ */
+const char* pe_auth_alg(int alg);
+
+/**
+ *\brief                        得到签名的检查结果
+ *\param[in]    auth            签名和摘要
+ *\return                       unsigned-没有证书表,bad-证书表超出文件或没有解码出摘要,
+ *                              unsupported-不能计算签名中的摘要算法,unchecked-没有计算摘要,match,mismatch
+ */
+const char* pe_auth_status(PPE_AUTH auth);
+
+#endif
@@ -0,0 +1,387 @@
+/**
+ *\file     pe_cache.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    扫描结果缓存实现
+ *          打开时校验所有项,只把每个键最新的项的位置放入散列表,查找时直接读映射的文件
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|输出格式的高4位放在标志字节的高4位
+ */
+#include "pe_cache.h"
+#include "hash.h"
+
+#define CACHE_ALIGN(x)          (((x) + 7) & ~(ULONGLONG)7)                 ///< 按8字节对齐
+
+typedef struct _CACHE_HEAD                                                  ///  项头,文件中为小端
+{
+    DWORD       magic;                                                      ///< PE_CACHE_MAGIC
+    DWORD       len;                                                        ///< 项长度
+    ULONGLONG   check;                                                      ///< 校验值
+    ULONGLONG   size;                                                       ///< 文件长度
+    ULONGLONG   mtime;                                                      ///< 修改时间
+    ULONGLONG   id;                                                         ///< 文件标识
+    ULONGLONG   hash;                                                       ///< 文件内容散列
+    ULONGLONG   items;                                                      ///< 解析出的数据项数
+    BYTE        mode;                                                       ///< 输出格式低8位
+    BYTE        flags;                                                      ///< 低4位为标志,高4位为输出格式高4位
+    WORD        path_len;                                                   ///< 路径长度
+    DWORD       record_len;                                                 ///< 记录长度
+
+} CACHE_HEAD, *PCACHE_HEAD;
+
+/**
+ *\brief                        键的散列值
+ *\param[in]    path            路径
+ *\param[in]    len             路径长度
+ *\param[in]    mode            输出格式
+ *\return                       散列值
+ */
+static ULONGLONG cache_key(const char *path, size_t len, DWORD mode)
+{
+    return hash_xxh64(path, len, mode);
+}
+
+/**
+ *\brief                        检查off处是否为完整的项
+ *\param[in]    view            缓存文件
+ *\param[in]    off             位置
+ *\return                       项长度,0为不是完整的项
+ */
+static DWORD cache_check(PPE_VIEW view, ULONGLONG off)
+{
+    if (!VIEW_HAS(view, off, PE_CACHE_HEAD_SIZE))
+    {
+        return 0;
+    }
+
+    const UCHAR *head = view->data + off;
+    DWORD        len  = VIEW_FIELD32(head, CACHE_HEAD, len);
+
+    if (PE_CACHE_MAGIC != VIEW_FIELD32(head, CACHE_HEAD, magic) || len < PE_CACHE_HEAD_SIZE || 0 != (len & 7) ||
+        !VIEW_HAS(view, off, len) ||
+        PE_CACHE_HEAD_SIZE + (ULONGLONG)VIEW_FIELD16(head, CACHE_HEAD, path_len) +
+                             VIEW_FIELD32(head, CACHE_HEAD, record_len) > len ||
+        le64(head + offsetof(CACHE_HEAD, check)) != hash_xxh64(head + offsetof(CACHE_HEAD, size),
+                                                               len - offsetof(CACHE_HEAD, size), 0))
+    {
+        return 0;
+    }
+
+    return len;
+}
+
+/**
+ *\brief                        读取已经检查过的项
+ *\param[in]    cache           缓存
+ *\param[in]    off             位置
+ *\param[out]   entry           缓存项
+ *\return                       无
+ */
+static void cache_entry(PPE_CACHE cache, ULONGLONG off, PPE_CACHE_ENTRY entry)
+{
+    const UCHAR *head = cache->map.data + off;
+
+    entry->size       = le64(head + offsetof(CACHE_HEAD, size));
+    entry->mtime      = le64(head + offsetof(CACHE_HEAD, mtime));
+    entry->id         = le64(head + offsetof(CACHE_HEAD, id));
+    entry->hash       = le64(head + offsetof(CACHE_HEAD, hash));
+    entry->items      = le64(head + offsetof(CACHE_HEAD, items));
+    entry->mode       = head[offsetof(CACHE_HEAD, mode)] | ((DWORD)(head[offsetof(CACHE_HEAD, flags)] >> 4) << 8);
+    entry->flags      = head[offsetof(CACHE_HEAD, flags)] & 0x0F;
+    entry->path_len   = VIEW_FIELD16(head, CACHE_HEAD, path_len);
+    entry->record_len = VIEW_FIELD32(head, CACHE_HEAD, record_len);
+    entry->path       = (const char*)head + PE_CACHE_HEAD_SIZE;
+    entry->record     = head + PE_CACHE_HEAD_SIZE + entry->path_len;
+    entry->stored     = VIEW_FIELD32(head, CACHE_HEAD, len);
+}
+
+/**
+ *\brief                        在散列表中找键的位置
+ *\param[in]    cache           缓存
+ *\param[in]    path            路径
+ *\param[in]    len             路径长度
+ *\param[in]    mode            输出格式
+ *\return                       散列表序号,该位置为空或为相同的键
+ */
+static DWORD cache_slot(PPE_CACHE cache, const char *path, size_t len, DWORD mode)
+{
+    DWORD mask = cache->slot_count - 1;
+    DWORD i    = (DWORD)cache_key(path, len, mode) & mask;
+
+    for (;; i = (i + 1) & mask)
+    {
+        PE_CACHE_ENTRY entry;
+
+        if (0 == cache->slot[i])
+        {
+            return i;
+        }
+
+        cache_entry(cache, cache->slot[i] - 1, &entry);
+
+        if (entry.mode == mode && entry.path_len == len && 0 == memcmp(entry.path, path, len))
+        {
+            return i;
+        }
+    }
+}
+
+int pe_cache_open(PPE_CACHE cache, const char *path)
+{
+    ULONGLONG  size;
+    ULONGLONG  mtime;
+    ULONGLONG *list  = NULL;
+    DWORD      count = 0;
+    DWORD      cap   = 0;
+
+    memset(cache, 0, sizeof(PE_CACHE));
+
+    if (0 != file_stat(path, &size, &mtime, NULL))
+    {
+        return 0; // 还没有缓存文件
+    }
+
+    if (0 != file_map(path, &cache->map))
+    {
+        return -1;
+    }
+
+    PE_VIEW view = { cache->map.data, cache->map.size };
+
+    // 先找出所有完整的项,写入中断或损坏的字节跳过,从下一个校验正确的项继续
+    for (ULONGLONG off = 0; off < view.size; )
+    {
+        DWORD len = (view.size - off >= 4 && PE_CACHE_MAGIC == le32(view.data + off)) ? cache_check(&view, off) : 0;
+
+        if (0 == len)
+        {
+            cache->garbage++;
+            off++;
+            continue;
+        }
+
+        if (count == cap)
+        {
+            DWORD      n = cap ? cap * 2 : 1024;
+            ULONGLONG *p = realloc(list, n * sizeof(ULONGLONG));
+
+            if (NULL == p)
+            {
+                free(list);
+                pe_cache_close(cache);
+                return -2;
+            }
+
+            list = p;
+            cap  = n;
+        }
+
+        list[count++] = off;
+        off          += len;
+    }
+
+    for (cache->slot_count = 16; cache->slot_count < (ULONGLONG)count * 2; cache->slot_count *= 2);
+
+    cache->slot = calloc(cache->slot_count, sizeof(ULONGLONG));
+
+    if (NULL == cache->slot)
+    {
+        free(list);
+        pe_cache_close(cache);
+        return -2;
+    }
+
+    for (DWORD n = 0; n < count; n++)
+    {
+        PE_CACHE_ENTRY entry;
+
+        cache_entry(cache, list[n], &entry);
+
+        DWORD i = cache_slot(cache, entry.path, entry.path_len, entry.mode);
+
+        if (0 != cache->slot[i]) // 后面的项覆盖前面的项
+        {
+            PE_CACHE_ENTRY old;
+
+            cache_entry(cache, cache->slot[i] - 1, &old);
+            cache->live_bytes -= old.stored;
+            cache->dead_bytes += old.stored;
+        }
+        else
+        {
+            cache->count++;
+        }
+
+        cache->slot[i]     = list[n] + 1;
+        cache->live_bytes += entry.stored;
+    }
+
+    free(list);
+    return 0;
+}
+
+void pe_cache_close(PPE_CACHE cache)
+{
+    free(cache->slot);
+    file_unmap(&cache->map);
+    memset(cache, 0, sizeof(PE_CACHE));
+}
+
+int pe_cache_find(PPE_CACHE cache, const char *path, DWORD mode, PPE_CACHE_ENTRY entry)
+{
+    if (0 == cache->count)
+    {
+        return -1;
+    }
+
+    DWORD i = cache_slot(cache, path, strlen(path), mode);
+
+    if (0 == cache->slot[i])
+    {
+        return -1;
+    }
+
+    cache_entry(cache, cache->slot[i] - 1, entry);
+    return 0;
+}
+
+/**
+ *\brief                        写入小端数值
+ *\param[out]   dst             目标
+ *\param[in]    value           数值
+ *\param[in]    len             字节数:1,2,4,8
+ *\return                       无
+ */
+static void cache_num(UCHAR *dst, ULONGLONG value, int len)
+{
+    for (int i = 0; i < len; i++, value >>= 8)
+    {
+        dst[i] = (UCHAR)(value & 0xFF);
+    }
+}
+
+int pe_cache_put(PPE_BUF buf, PPE_CACHE_ENTRY entry)
+{
+    if (entry->path_len > 0xFFFF || entry->record_len > PE_CACHE_RECORD_MAX || entry->mode > PE_CACHE_MODE_MAX)
+    {
+        return -1;
+    }
+
+    size_t len = (size_t)CACHE_ALIGN(PE_CACHE_HEAD_SIZE + entry->path_len + entry->record_len);
+
+    if (0 != pe_buf_reserve(buf, len))
+    {
+        return -2;
+    }
+
+    UCHAR *head = (UCHAR*)buf->data + buf->len;
+
+    memset(head, 0, len);
+    cache_num(head + offsetof(CACHE_HEAD, magic),      PE_CACHE_MAGIC,     4);
+    cache_num(head + offsetof(CACHE_HEAD, len),        len,                4);
+    cache_num(head + offsetof(CACHE_HEAD, size),       entry->size,        8);
+    cache_num(head + offsetof(CACHE_HEAD, mtime),      entry->mtime,       8);
+    cache_num(head + offsetof(CACHE_HEAD, id),         entry->id,          8);
+    cache_num(head + offsetof(CACHE_HEAD, hash),       entry->hash,        8);
+    cache_num(head + offsetof(CACHE_HEAD, items),      entry->items,       8);
+    cache_num(head + offsetof(CACHE_HEAD, mode),       entry->mode & 0xFF, 1);
+    cache_num(head + offsetof(CACHE_HEAD, flags),      (entry->flags & 0x0F) | ((entry->mode >> 8) << 4), 1);
+    cache_num(head + offsetof(CACHE_HEAD, path_len),   entry->path_len,    2);
+    cache_num(head + offsetof(CACHE_HEAD, record_len), entry->record_len,  4);
+    memcpy(head + PE_CACHE_HEAD_SIZE, entry->path, entry->path_len);
+    memcpy(head + PE_CACHE_HEAD_SIZE + entry->path_len, entry->record, entry->record_len);
+    cache_num(head + offsetof(CACHE_HEAD, check),
+              hash_xxh64(head + offsetof(CACHE_HEAD, size), len - offsetof(CACHE_HEAD, size), 0), 8);
+
+    buf->len += len;
+    return 0;
+}
+
+int pe_cache_append(const char *path, PPE_BUF buf)
+{
+    if (0 == buf->len)
+    {
+        return 0;
+    }
+
+    int ret = file_append(path, buf->data, buf->len);
+
+    buf->len = 0;
+    return ret;
+}
+
+int pe_cache_compact(const char *path, int force, ULONGLONG *before, ULONGLONG *after)
+{
+    PE_CACHE cache;
+    int      ret = pe_cache_open(&cache, path);
+
+    *before = *after = cache.map.size;
+
+    if (0 != ret || (!force && cache.dead_bytes <= cache.live_bytes && 0 == cache.garbage))
+    {
+        pe_cache_close(&cache);
+        return ret;
+    }
+
+    size_t len = strlen(path);
+    char  *tmp = malloc(len + 5);
+    FILE  *fp  = NULL;
+
+    if (NULL != tmp)
+    {
+        memcpy(tmp, path, len);
+        memcpy(tmp + len, ".tmp", 5);
+        fp = file_open(tmp, "wb");
+    }
+
+    if (NULL == fp)
+    {
+        free(tmp);
+        pe_cache_close(&cache);
+        return -3;
+    }
+
+    // 写入散列表中每个键最新的项,项是连续的字节,直接复制
+    for (DWORD i = 0; i < cache.slot_count && 0 == ret; i++)
+    {
+        PE_CACHE_ENTRY entry;
+
+        if (0 == cache.slot[i])
+        {
+            continue;
+        }
+
+        cache_entry(&cache, cache.slot[i] - 1, &entry);
+
+        if (fwrite(cache.map.data + cache.slot[i] - 1, 1, entry.stored, fp) != entry.stored)
+        {
+            ret = -4;
+        }
+    }
+
+    *after = cache.live_bytes;
+
+    if (0 != fclose(fp) && 0 == ret)
+    {
+        ret = -5;
+    }
+
+    pe_cache_close(&cache); // Windows下映射着的文件不能被替换
+
+    if (0 == ret && 0 != file_rename(tmp, path))
+    {
+        ret = -6;
+    }
+
+    if (0 != ret)
+    {
+        remove(tmp);
+        *after = *before;
+    }
+
+    free(tmp);
+    return ret;
+}
@@ -0,0 +1,122 @@
+/**
+ *\file     pe_cache.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    扫描结果缓存,再次扫描没有变化的文件时只需stat,不再打开和解析
+ *          缓存为一个只追加的文件,每项是一个文件在一种输出格式下的完整记录,
+ *          以(路径,输出格式)为键,后写入的项覆盖前面的项.
+ *          文件长度,修改时间和文件标识都相同时命中;长度相同而修改时间或文件标识变了时,
+ *          比较文件内容的XXH64散列,相同时也命中并追加一个更新了修改时间的项.
+ *          每项的格式,所有数值为小端,项长度按8字节对齐:
+ *              DWORD     PE_CACHE_MAGIC
+ *              DWORD     项长度,包括头
+ *              ULONGLONG 校验值,项中本字段之后所有字节的XXH64
+ *              ULONGLONG 文件长度, 修改时间, 文件标识, 文件内容散列, 解析出的数据项数
+ *              BYTE      输出格式低8位, BYTE 标志(低4位)和输出格式高4位, WORD 路径长度, DWORD 记录长度
+ *              路径, 记录, 补0
+ *          打开时映射整个文件并校验每一项,不完整或校验不对的字节跳过,从下一个校验正确的项继续,
+ *          映射之后其它进程追加的项本次看不到.写入通过file_append加锁追加,
+ *          多个扫描进程可以同时读写同一个缓存文件.
+ *          过期的项超过有效的项或有损坏的字节时压缩:只保留每个键最新的项,先写临时文件再替换,
+ *          已经映射了旧文件的进程不受影响,压缩期间其它进程追加的项可能丢失,只会导致下次未命中.
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|输出格式扩展到12位,高4位放在标志字节的高4位,格式版本改为"PEC2",旧的缓存项不再使用
+ *          2026.10.18|记录中增加延迟导入和绑定导入,格式版本改为"PEC3"
+ */
+#ifndef _PE_CACHE_H_
+#define _PE_CACHE_H_
+
+#include "pe_emit.h"
+
+#define PE_CACHE_MAGIC          0x33434550                                  ///< "PEC3",包括格式版本
+#define PE_CACHE_HEAD_SIZE      64                                          ///< 项头长度
+#define PE_CACHE_RECORD_MAX     (64 * 1024 * 1024)                          ///< 记录最大长度,超过时不缓存
+
+#define PE_CACHE_FLAG_PE        0x01                                        ///< 是PE文件
+#define PE_CACHE_FLAG_ERROR     0x02                                        ///< 解析出错
+#define PE_CACHE_MODE_MAX       0xFFF                                       ///< 输出格式的最大值
+
+typedef struct _PE_CACHE_ENTRY                                              ///  缓存项
+{
+    ULONGLONG       size;                                                   ///< 文件长度
+    ULONGLONG       mtime;                                                  ///< 修改时间
+    ULONGLONG       id;                                                     ///< 文件标识
+    ULONGLONG       hash;                                                   ///< 文件内容散列
+    ULONGLONG       items;                                                  ///< 解析出的数据项数
+    DWORD           mode;                                                   ///< 输出格式,由调用者定义,不超过PE_CACHE_MODE_MAX
+    DWORD           flags;                                                  ///< PE_CACHE_FLAG_*
+    const char     *path;                                                   ///< 路径
+    size_t          path_len;                                               ///< 路径长度
+    const UCHAR    *record;                                                 ///< 记录
+    size_t          record_len;                                             ///< 记录长度
+    size_t          stored;                                                 ///< 在缓存文件中的长度,查找时填写
+
+} PE_CACHE_ENTRY, *PPE_CACHE_ENTRY;
+
+typedef struct _PE_CACHE                                                    ///  打开的缓存,查找时只读,多个线程可以同时查找
+{
+    FILE_MAP        map;                                                    ///< 缓存文件
+    ULONGLONG      *slot;                                                   ///< 散列表,项的位置+1,0为空
+    DWORD           slot_count;                                             ///< 散列表长度,2的幂
+    DWORD           count;                                                  ///< 有效项数
+    ULONGLONG       live_bytes;                                             ///< 有效项的长度
+    ULONGLONG       dead_bytes;                                             ///< 被覆盖的项的长度
+    ULONGLONG       garbage;                                                ///< 写入中断或损坏的字节数
+
+} PE_CACHE, *PPE_CACHE;
+
+/**
+ *\brief                        打开缓存文件,文件不存在时为空缓存
+ *\param[out]   cache           缓存,使用后调用pe_cache_close
+ *\param[in]    path            缓存文件路径
+ *\return                       0-成功,其它失败
+ */
+int pe_cache_open(PPE_CACHE cache, const char *path);
+
+/**
+ *\brief                        关闭缓存
+ *\param[in]    cache           缓存
+ *\return                       无
+ */
+void pe_cache_close(PPE_CACHE cache);
+
+/**
+ *\brief                        查找路径和输出格式对应的最新项
+ *\param[in]    cache           缓存
+ *\param[in]    path            路径
+ *\param[in]    mode            输出格式
+ *\param[out]   entry           缓存项,路径和记录指向映射的缓存文件
+ *\return                       0-找到,-1-没有
+ */
+int pe_cache_find(PPE_CACHE cache, const char *path, DWORD mode, PPE_CACHE_ENTRY entry);
+
+/**
+ *\brief                        将缓存项编码后追加到缓冲区,攒够一批后用pe_cache_append写入
+ *\param[in]    buf             缓冲区
+ *\param[in]    entry           缓存项
+ *\return                       0-成功,-1-记录太长,-2-内存不足
+ */
+int pe_cache_put(PPE_BUF buf, PPE_CACHE_ENTRY entry);
+
+/**
+ *\brief                        缓冲区中的项追加到缓存文件,成功后清空缓冲区
+ *\param[in]    path            缓存文件路径
+ *\param[in]    buf             缓冲区
+ *\return                       0-成功,其它失败
+ */
+int pe_cache_append(const char *path, PPE_BUF buf);
+
+/**
+ *\brief                        压缩缓存文件,只保留每个键最新的项,去掉不完整或损坏的字节
+ *\param[in]    path            缓存文件路径
+ *\param[in]    force           0-过期的项不超过有效的项并且没有损坏的字节时不压缩
+ *\param[out]   before          压缩前的长度
+ *\param[out]   after           压缩后的长度,没有压缩时与before相同
+ *\return                       0-成功,其它失败
+ */
+int pe_cache_compact(const char *path, int force, ULONGLONG *before, ULONGLONG *after);
+
+#endif
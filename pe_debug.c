@@ -0,0 +1,533 @@
+/**
+ *\file     pe_debug.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    调试目录和PDB标识实现
+ *          记录的位置和长度先限制在文件范围内再读,只取符号键时没有读入的部分为0,解码出来相当于没有该记录
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|保留地址空间后提交文件长度,没有读的部分解析时读出0
+ *          2026.10.18|只提交头部,节表,调试目录和读入的记录,提交量与文件长度无关
+ */
+#include "pe_debug.h"
+
+/// 解析结构使用的内存池
+#define ARENA(image)            ((NULL != (image)->pool) ? (image)->pool : &(image)->arena)
+
+#define DEBUG_HEAD_MAX          (4 * 1024 * 1024)                           ///< 只取符号键时头部最多读入的长度,包括节表
+#define DEBUG_RSDS_HEAD         24                                          ///< RSDS记录头:标记,GUID,age
+#define DEBUG_NB10_HEAD         16                                          ///< NB10记录头:标记,偏移,签名,age
+#define DEBUG_COMMIT_PAD        16                                          ///< 读入范围后面多提交的长度,路径和POGO名称读过读入范围时读到0
+
+static const char *g_debug_type[PE_DEBUG_TYPE_MAX + 1] = {                  ///< 调试目录项类型,按值排列
+    "UNKNOWN",  "COFF",     "CODEVIEW", "FPO",          "MISC",         "EXCEPTION",    "FIXUP",
+    "OMAP_TO_SRC",          "OMAP_FROM_SRC",            "BORLAND",      "RESERVED10",   "CLSID",
+    "VC_FEATURE",           "POGO",     "ILTCG",        "MPX",          "REPRO",        "EMBEDDED_PDB",
+    "SPGO",     "PDBCHECKSUM",          "EX_DLLCHARACTERISTICS"
+};
+
+const char* pe_debug_type(DWORD type)
+{
+    return (type <= PE_DEBUG_TYPE_MAX) ? g_debug_type[type] : NULL;
+}
+
+/**
+ *\brief                        得到调试数据在文件中的位置,有PointerToRawData时用它,否则通过相对虚拟地址转换
+ *\param[in]    image           解析结果
+ *\param[in]    rva             AddressOfRawData
+ *\param[in]    ptr             PointerToRawData
+ *\return                       文件位置,没有数据时为0
+ */
+static DWORD debug_raw_fa(PPE_IMAGE image, DWORD rva, DWORD ptr)
+{
+    DWORD fa = 0;
+
+    if (0 != ptr)
+    {
+        return ptr;
+    }
+
+    return (0 != rva && pe_rva_to_fa(image, rva, &fa) >= 0) ? fa : 0;
+}
+
+int pe_debug_dir(PPE_IMAGE image, DWORD *fa, DWORD *count)
+{
+    DWORD rva  = image->dir[PE_DIR_DEBUG].VirtualAddress;
+    DWORD size = image->dir[PE_DIR_DEBUG].Size;
+    int   id   = -1;
+
+    *count = 0;
+
+    if (image->dir_count <= PE_DIR_DEBUG || 0 == rva || 0 == size || (id = pe_rva_to_fa(image, rva, fa)) < 0 ||
+        *fa >= image->view.size)
+    {
+        return -1;
+    }
+
+    ULONGLONG left = image->view.size - *fa;
+
+    *count = (DWORD)(((size < left) ? size : left) / sizeof(IMAGE_DEBUG_DIRECTORY));
+    *count = (*count < PE_DEBUG_ENTRY_MAX) ? *count : PE_DEBUG_ENTRY_MAX;
+    return id;
+}
+
+/**
+ *\brief                        解码CodeView记录,RSDS或NB10
+ *\param[in]    image           解析结果
+ *\param[in,out] debug          调试目录
+ *\param[in]    entry           CodeView目录项
+ *\return                       无
+ */
+static void debug_codeview(PPE_IMAGE image, PPE_DEBUG debug, PPE_DEBUG_ENTRY entry)
+{
+    UCHAR *data = image->view.data + entry->raw_fa; // avail已限制在文件内
+    DWORD  sig  = (entry->avail >= 4) ? le32(data) : 0;
+    DWORD  head = 0;
+
+    if (PE_DEBUG_RSDS == sig && entry->avail >= DEBUG_RSDS_HEAD)
+    {
+        memcpy(debug->cv_guid, data + 4, sizeof(debug->cv_guid));
+        debug->cv_age = le32(data + 20);
+        head          = DEBUG_RSDS_HEAD;
+    }
+    else if (PE_DEBUG_NB10 == sig && entry->avail >= DEBUG_NB10_HEAD)
+    {
+        debug->cv_signature = le32(data + 8);
+        debug->cv_age       = le32(data + 12);
+        head                = DEBUG_NB10_HEAD;
+    }
+    else
+    {
+        return;
+    }
+
+    size_t len = 0;
+
+    view_strn(&image->view, entry->raw_fa + head, entry->avail - head, &len);
+
+    debug->codeview    = 1;
+    debug->cv_fa       = entry->raw_fa;
+    debug->cv_format   = sig;
+    debug->cv_path_fa  = entry->raw_fa + head;
+    debug->cv_path_len = (DWORD)((len < PE_DEBUG_PATH_MAX) ? len : PE_DEBUG_PATH_MAX);
+}
+
+/**
+ *\brief                        解码POGO记录,标记后面是{DWORD 地址, DWORD 长度, 以0结尾按4字节对齐的名称}
+ *\param[in]    image           解析结果
+ *\param[in,out] debug          调试目录
+ *\param[in]    entry           POGO目录项
+ *\return                       无
+ */
+static void debug_pogo(PPE_IMAGE image, PPE_DEBUG debug, PPE_DEBUG_ENTRY entry)
+{
+    if (entry->avail < 4)
+    {
+        return;
+    }
+
+    DWORD pos = 4;
+
+    debug->pogo           = 1;
+    debug->pogo_signature = le32(image->view.data + entry->raw_fa);
+
+    while (pos + 8 < entry->avail) // 名称为空时结束,只读入了一部分时后面为0
+    {
+        size_t len = 0;
+
+        view_strn(&image->view, entry->raw_fa + pos + 8, entry->avail - pos - 8, &len);
+
+        if (0 == len || pos + 8 + len >= entry->avail)
+        {
+            break;
+        }
+
+        debug->pogo_count++;
+        pos = (DWORD)((pos + 8 + len + 1 + 3) & ~3u);
+    }
+}
+
+/**
+ *\brief                        解码repro记录和嵌入的可移植PDB
+ *\param[in]    image           解析结果
+ *\param[in,out] debug          调试目录
+ *\param[in]    entry           目录项
+ *\return                       无
+ */
+static void debug_repro_pdb(PPE_IMAGE image, PPE_DEBUG debug, PPE_DEBUG_ENTRY entry)
+{
+    UCHAR *data = image->view.data + entry->raw_fa;
+
+    if (PE_DEBUG_TYPE_REPRO == entry->type && !debug->repro)
+    {
+        DWORD len = (entry->avail >= 4) ? le32(data) : 0;
+
+        debug->repro = 1; // 没有数据时只表示是可重现构建
+
+        if (len > 0 && len <= entry->avail - 4 && len <= PE_DEBUG_RECORD_MAX - 4) // 只取符号键时最多读入这么多
+        {
+            debug->repro_fa  = entry->raw_fa + 4;
+            debug->repro_len = len;
+        }
+    }
+    else if (PE_DEBUG_TYPE_EMBEDDED_PDB == entry->type && !debug->pdb && entry->avail >= 8 && PE_DEBUG_MPDB == le32(data))
+    {
+        debug->pdb        = 1;
+        debug->pdb_size   = le32(data + 4);
+        debug->pdb_fa     = entry->raw_fa + 8;
+        debug->pdb_stored = entry->avail - 8;
+    }
+}
+
+int pe_debug(PPE_IMAGE image, DWORD flags)
+{
+    PPE_DEBUG debug = pe_arena_alloc(ARENA(image), sizeof(PE_DEBUG));
+
+    if (NULL == debug)
+    {
+        return -1;
+    }
+
+    memset(debug, 0, sizeof(PE_DEBUG));
+    debug->flags   = flags;
+    debug->section = pe_debug_dir(image, &debug->fa, &debug->count);
+
+    if (debug->count > 0)
+    {
+        debug->entry = pe_arena_array(ARENA(image), debug->count, sizeof(PE_DEBUG_ENTRY));
+
+        if (NULL == debug->entry)
+        {
+            return -2;
+        }
+    }
+
+    for (DWORD i = 0; i < debug->count; i++)
+    {
+        PPE_DEBUG_ENTRY entry = &debug->entry[i];
+        UCHAR          *dir   = image->view.data + debug->fa + i * sizeof(IMAGE_DEBUG_DIRECTORY);
+
+        entry->fa              = debug->fa + i * sizeof(IMAGE_DEBUG_DIRECTORY);
+        entry->characteristics = VIEW_FIELD32(dir, IMAGE_DEBUG_DIRECTORY, Characteristics);
+        entry->time            = VIEW_FIELD32(dir, IMAGE_DEBUG_DIRECTORY, TimeDateStamp);
+        entry->major           = VIEW_FIELD16(dir, IMAGE_DEBUG_DIRECTORY, MajorVersion);
+        entry->minor           = VIEW_FIELD16(dir, IMAGE_DEBUG_DIRECTORY, MinorVersion);
+        entry->type            = VIEW_FIELD32(dir, IMAGE_DEBUG_DIRECTORY, Type);
+        entry->size            = VIEW_FIELD32(dir, IMAGE_DEBUG_DIRECTORY, SizeOfData);
+        entry->rva             = VIEW_FIELD32(dir, IMAGE_DEBUG_DIRECTORY, AddressOfRawData);
+        entry->raw_fa          = debug_raw_fa(image, entry->rva, VIEW_FIELD32(dir, IMAGE_DEBUG_DIRECTORY, PointerToRawData));
+
+        if (0 != entry->raw_fa && entry->raw_fa < image->view.size)
+        {
+            ULONGLONG left = image->view.size - entry->raw_fa;
+
+            entry->avail = (entry->size < left) ? entry->size : (DWORD)left;
+        }
+
+        if (PE_DEBUG_TYPE_CODEVIEW == entry->type && (flags & PE_DEBUG_CODEVIEW) && !debug->codeview)
+        {
+            debug_codeview(image, debug, entry);
+        }
+        else if (PE_DEBUG_TYPE_POGO == entry->type && (flags & PE_DEBUG_POGO) && !debug->pogo)
+        {
+            debug_pogo(image, debug, entry);
+        }
+        else if ((PE_DEBUG_TYPE_REPRO == entry->type && (flags & PE_DEBUG_REPRO)) ||
+                 (PE_DEBUG_TYPE_EMBEDDED_PDB == entry->type && (flags & PE_DEBUG_PDB)))
+        {
+            debug_repro_pdb(image, debug, entry);
+        }
+    }
+
+    image->debug = debug;
+    return 0;
+}
+
+char* pe_debug_guid(const UCHAR *guid, char *text)
+{
+    sprintf(text, "%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+            le32(guid), le16(guid + 4), le16(guid + 6),
+            guid[8], guid[9], guid[10], guid[11], guid[12], guid[13], guid[14], guid[15]);
+    return text;
+}
+
+/**
+ *\brief                        取路径中最后一个/或\后面的文件名
+ *\param[in]    path            路径
+ *\param[in]    len             路径长度
+ *\param[out]   name_len        文件名长度
+ *\return                       文件名
+ */
+static const char* debug_file_name(const char *path, size_t len, size_t *name_len)
+{
+    size_t begin = len;
+
+    while (begin > 0 && '/' != path[begin - 1] && '\\' != path[begin - 1])
+    {
+        begin--;
+    }
+
+    *name_len = len - begin;
+    return path + begin;
+}
+
+size_t pe_debug_key(PPE_IMAGE image, char *key, size_t size)
+{
+    PPE_DEBUG debug = image->debug;
+    char      id[48];
+    size_t    len   = 0;
+
+    if (NULL == debug || !debug->codeview || 0 == debug->cv_path_len)
+    {
+        *key = '\0';
+        return 0;
+    }
+
+    const UCHAR *g    = debug->cv_guid;
+    const char  *name = debug_file_name((const char*)image->view.data + debug->cv_path_fa, debug->cv_path_len, &len);
+
+    if (PE_DEBUG_RSDS == debug->cv_format)
+    {
+        sprintf(id, "%08X%04X%04X%02X%02X%02X%02X%02X%02X%02X%02X%X", le32(g), le16(g + 4), le16(g + 6),
+                g[8], g[9], g[10], g[11], g[12], g[13], g[14], g[15], debug->cv_age);
+    }
+    else
+    {
+        sprintf(id, "%08X%X", debug->cv_signature, debug->cv_age);
+    }
+
+    int ret = snprintf(key, size, "%.*s/%s/%.*s", (int)len, name, id, (int)len, name);
+
+    return (ret < 0) ? 0 : ((size_t)ret < size) ? (size_t)ret : size - 1;
+}
+
+size_t pe_image_key(PPE_IMAGE image, const char *path, char *key, size_t size)
+{
+    size_t      len  = 0;
+    const char *name = debug_file_name(path, strlen(path), &len);
+    int         ret  = snprintf(key, size, "%.*s/%08X%x/%.*s", (int)len, name, image->time, image->image_size, (int)len, name);
+
+    return (ret < 0) ? 0 : ((size_t)ret < size) ? (size_t)ret : size - 1;
+}
+
+/**
+ *\brief                        提交文件的一段,超出文件的部分不提交,没有读入的部分为0
+ *\param[in,out] file           读入的数据
+ *\param[in]    begin           开始位置
+ *\param[in]    len             长度
+ *\return                       0-成功,-2-提交量不足
+ */
+static int debug_commit(PPE_DEBUG_FILE file, ULONGLONG begin, ULONGLONG len)
+{
+    ULONGLONG end = begin + len;
+
+    end = (end < file->size) ? end : file->size;
+
+    return (begin >= end || 0 == mem_commit(file->data + begin, (size_t)(end - begin))) ? 0 : -2;
+}
+
+/**
+ *\brief                        读入文件的一段,超出文件的部分不读,与已经连续读入的头部重叠的部分不再读,
+ *                              先提交这一段和后面的DEBUG_COMMIT_PAD字节
+ *\param[in,out] file           读入的数据
+ *\param[in]    fp              文件指针
+ *\param[in]    begin           开始位置
+ *\param[in]    len             长度
+ *\return                       0-成功,-1-读取失败,-2-提交量不足
+ */
+static int debug_read(PPE_DEBUG_FILE file, FILE *fp, ULONGLONG begin, ULONGLONG len)
+{
+    ULONGLONG end = begin + len;
+
+    if (0 != debug_commit(file, begin, len + DEBUG_COMMIT_PAD))
+    {
+        return -2;
+    }
+
+    begin = (begin < file->head) ? file->head : begin;
+    end   = (end < file->size) ? end : file->size;
+
+    if (begin >= end)
+    {
+        return 0;
+    }
+
+    size_t size = (size_t)(end - begin);
+
+    if (size != file_read_at(fp, begin, file->data + begin, size))
+    {
+        return -1;
+    }
+
+    file->loaded += size;
+    file->reads++;
+
+    if (begin == file->head) // 头部连续时延长
+    {
+        file->head = (size_t)end;
+    }
+
+    return 0;
+}
+
+/**
+ *\brief                        读入头部和节表,e_lfanew或节表太远时只读前DEBUG_HEAD_MAX字节,
+ *                              NT头和节表只提交不读,解析时读出0,头部检查会出错
+ *\param[in,out] file           读入的数据
+ *\param[in]    fp              文件指针
+ *\return                       0-成功,-1-读取失败,-2-提交量不足
+ */
+static int debug_read_head(PPE_DEBUG_FILE file, FILE *fp)
+{
+    int ret = debug_read(file, fp, 0, PE_DEBUG_HEAD);
+
+    if (0 != ret || file->head < sizeof(IMAGE_DOS_HEADER))
+    {
+        return ret;
+    }
+
+    ULONGLONG nt = VIEW_FIELD32(file->data, IMAGE_DOS_HEADER, e_lfanew);
+
+    if (nt + sizeof(IMAGE_NT_HEADERS64) > DEBUG_HEAD_MAX)
+    {
+        return debug_commit(file, nt, sizeof(IMAGE_NT_HEADERS64));
+    }
+
+    if (0 != (ret = debug_read(file, fp, 0, nt + sizeof(IMAGE_NT_HEADERS64))))
+    {
+        return (-2 == ret) ? ret : 0;
+    }
+
+    if (nt + sizeof(IMAGE_NT_HEADERS64) > file->size)
+    {
+        return 0;
+    }
+
+    UCHAR    *head = file->data + nt;
+    ULONGLONG end  = nt + offsetof(IMAGE_NT_HEADERS32, OptionalHeader) +
+                     VIEW_FIELD16(head, IMAGE_NT_HEADERS32, FileHeader.SizeOfOptionalHeader) +
+                     (ULONGLONG)VIEW_FIELD16(head, IMAGE_NT_HEADERS32, FileHeader.NumberOfSections) * sizeof(IMAGE_SECTION_HEADER);
+
+    return (end > DEBUG_HEAD_MAX) ? debug_commit(file, file->head, end - file->head) : debug_read(file, fp, 0, end);
+}
+
+/**
+ *\brief                        读入调试目录和需要解码的记录
+ *\param[in]    image           只解析了头部和节表的解析结果
+ *\param[in,out] file           读入的数据
+ *\param[in]    fp              文件指针
+ *\param[in]    flags           需要解码的记录,PE_DEBUG_*
+ *\return                       0-成功,-1-读取失败,-2-提交量不足
+ */
+static int debug_read_records(PPE_IMAGE image, PPE_DEBUG_FILE file, FILE *fp, DWORD flags)
+{
+    DWORD fa    = 0;
+    DWORD count = 0;
+    int   ret   = 0;
+
+    if (pe_debug_dir(image, &fa, &count) < 0)
+    {
+        return 0; // 没有调试目录时解码出来为空
+    }
+
+    if (0 != (ret = debug_read(file, fp, fa, (ULONGLONG)count * sizeof(IMAGE_DEBUG_DIRECTORY))))
+    {
+        return (-2 == ret) ? ret : 0; // 读取失败时目录已提交,解码出来为空
+    }
+
+    for (DWORD i = 0; i < count; i++)
+    {
+        UCHAR *dir  = file->data + fa + i * sizeof(IMAGE_DEBUG_DIRECTORY);
+        DWORD  type = VIEW_FIELD32(dir, IMAGE_DEBUG_DIRECTORY, Type);
+        DWORD  size = VIEW_FIELD32(dir, IMAGE_DEBUG_DIRECTORY, SizeOfData);
+        DWORD  raw  = debug_raw_fa(image, VIEW_FIELD32(dir, IMAGE_DEBUG_DIRECTORY, AddressOfRawData),
+                                   VIEW_FIELD32(dir, IMAGE_DEBUG_DIRECTORY, PointerToRawData));
+        DWORD  need = 0;
+
+        if (PE_DEBUG_TYPE_CODEVIEW == type && (flags & PE_DEBUG_CODEVIEW))
+        {
+            need = DEBUG_RSDS_HEAD + PE_DEBUG_PATH_MAX + 1;
+        }
+        else if ((PE_DEBUG_TYPE_POGO == type && (flags & PE_DEBUG_POGO)) || (PE_DEBUG_TYPE_REPRO == type && (flags & PE_DEBUG_REPRO)))
+        {
+            need = PE_DEBUG_RECORD_MAX;
+        }
+        else if (PE_DEBUG_TYPE_EMBEDDED_PDB == type && (flags & PE_DEBUG_PDB))
+        {
+            need = 8; // 只取标记和解压后的长度
+        }
+
+        if (0 != raw && 0 != need && 0 != (ret = debug_read(file, fp, raw, (size < need) ? size : need)))
+        {
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+int pe_debug_open(PPE_IMAGE image, const char *path, PPE_ARENA pool, DWORD flags, PPE_DEBUG_FILE file)
+{
+    ULONGLONG size  = 0;
+    ULONGLONG mtime = 0;
+
+    memset(file, 0, sizeof(PE_DEBUG_FILE));
+    memset(image, 0, sizeof(PE_IMAGE));
+
+    if (0 != file_stat(path, &size, &mtime, NULL) || size > (size_t)-1)
+    {
+        return 1;
+    }
+
+    FILE *fp = file_open(path, "rb");
+
+    if (NULL == fp)
+    {
+        return 1;
+    }
+
+    file->size = (size_t)size;
+    file->data = (size > 0) ? mem_reserve(file->size) : NULL; // 只有读入的页占用内存
+
+    int ret = (size > 0 && NULL == file->data) ? PE_ERR_MEMORY : 0;
+
+    if (0 == ret)
+    {
+        ret = debug_read_head(file, fp);
+        ret = (-2 == ret) ? PE_ERR_MEMORY : (0 != ret) ? 1 : 0;
+    }
+
+    if (0 == ret)
+    {
+        ret = pe_parse_head(image, file->data, file->size, pool);
+
+        if (PE_ERR_MEMORY != ret && !(ret < 0 && ret >= PE_ERR_UNSUPPORTED))
+        {
+            int read = debug_read_records(image, file, fp, flags);
+
+            if (0 != read)
+            {
+                ret = (-2 == read) ? PE_ERR_MEMORY : 1;
+            }
+            else if (0 != pe_debug(image, flags))
+            {
+                ret = PE_ERR_MEMORY;
+            }
+        }
+    }
+
+    fclose(fp);
+    return ret;
+}
+
+void pe_debug_close(PPE_DEBUG_FILE file)
+{
+    if (NULL != file->data)
+    {
+        mem_release(file->data, file->size);
+    }
+
+    memset(file, 0, sizeof(PE_DEBUG_FILE));
+}
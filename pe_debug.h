@@ -0,0 +1,171 @@
+/**
+ *\file     pe_debug.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    调试目录和PDB标识
+ *          调试目录是IMAGE_DEBUG_DIRECTORY数组,每项的数据通常不装入内存,只能按PointerToRawData在文件中找到.
+ *          解码CodeView(RSDS/NB10)的PDB路径,GUID或签名和age,POGO的项数,repro的散列和嵌入的可移植PDB的长度,
+ *          符号服务器的键为 PDB文件名/GUID和age/PDB文件名, 映像自身的键为 文件名/时间和映像大小/文件名.
+ *          只取符号键时不读整个文件:按位置读入头部,节表,调试目录和CodeView记录,
+ *          保存到按文件长度保留的地址空间中,没有读的部分为0,读入的量与文件长度无关
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|读入的数据只提交读入的范围
+ */
+#ifndef _PE_DEBUG_H_
+#define _PE_DEBUG_H_
+
+#include "pe.h"
+
+#define PE_DEBUG_TYPE_CODEVIEW      2                                       ///< CodeView,PDB路径和标识
+#define PE_DEBUG_TYPE_POGO          13                                      ///< 按配置文件优化的节信息
+#define PE_DEBUG_TYPE_REPRO         16                                      ///< 可重现构建,时间为散列而不是时间
+#define PE_DEBUG_TYPE_EMBEDDED_PDB  17                                      ///< 嵌入的可移植PDB
+#define PE_DEBUG_TYPE_MAX           20                                      ///< 已知的最大类型
+
+#define PE_DEBUG_CODEVIEW           0x01                                    ///< 解码CodeView
+#define PE_DEBUG_POGO               0x02                                    ///< 解码POGO
+#define PE_DEBUG_REPRO              0x04                                    ///< 解码repro
+#define PE_DEBUG_PDB                0x08                                    ///< 解码嵌入的可移植PDB
+#define PE_DEBUG_ALL                0x0F                                    ///< 所有项
+
+#define PE_DEBUG_RSDS               0x53445352                              ///< CodeView 7.0,"RSDS"
+#define PE_DEBUG_NB10               0x3031424E                              ///< CodeView 2.0,"NB10"
+#define PE_DEBUG_MPDB               0x4244504D                              ///< 嵌入的可移植PDB,"MPDB"
+
+#define PE_DEBUG_ENTRY_MAX          1024                                    ///< 最多解码的调试目录项数
+#define PE_DEBUG_PATH_MAX           1024                                    ///< PDB路径最多取的字节数
+#define PE_DEBUG_RECORD_MAX         (64 * 1024)                             ///< 只取符号键时一个记录最多读的字节数
+#define PE_DEBUG_HEAD               4096                                    ///< 只取符号键时先读的头部长度
+#define PE_DEBUG_KEY_MAX            (PE_DEBUG_PATH_MAX + 80)                ///< 符号键的最大长度,包括结尾的0
+
+typedef struct _PE_DEBUG_ENTRY                                              ///  调试目录项
+{
+    DWORD           fa;                                                     ///< 目录项在文件中的位置
+    DWORD           characteristics;                                        ///< 特征
+    DWORD           time;                                                   ///< 时间,repro时为散列的一部分
+    WORD            major;                                                  ///< 主版本号
+    WORD            minor;                                                  ///< 次版本号
+    DWORD           type;                                                   ///< 类型,PE_DEBUG_TYPE_*
+    DWORD           size;                                                   ///< 数据大小
+    DWORD           rva;                                                    ///< 数据的相对虚拟地址
+    DWORD           raw_fa;                                                 ///< 数据在文件中的位置
+    DWORD           avail;                                                  ///< 文件中实际有的数据长度,不超过size
+
+} PE_DEBUG_ENTRY, *PPE_DEBUG_ENTRY;
+
+typedef struct _PE_DEBUG                                                    ///  调试目录
+{
+    DWORD           flags;                                                  ///< 解码了哪几项,PE_DEBUG_*
+    int             section;                                                ///< 调试目录所在节,-1为没有调试目录
+    DWORD           fa;                                                     ///< 调试目录在文件中的位置
+    PPE_DEBUG_ENTRY entry;                                                  ///< 目录项
+    DWORD           count;                                                  ///< 目录项数量
+
+    int             codeview;                                               ///< 1-有CodeView,只取第一个
+    DWORD           cv_fa;                                                  ///< CodeView记录在文件中的位置
+    DWORD           cv_format;                                              ///< PE_DEBUG_RSDS或PE_DEBUG_NB10
+    UCHAR           cv_guid[16];                                            ///< RSDS的GUID,按文件中的字节
+    DWORD           cv_signature;                                           ///< NB10的签名
+    DWORD           cv_age;                                                 ///< age
+    DWORD           cv_path_fa;                                             ///< PDB路径在文件中的位置
+    DWORD           cv_path_len;                                            ///< PDB路径的长度,不超过PE_DEBUG_PATH_MAX
+
+    int             pogo;                                                   ///< 1-有POGO
+    DWORD           pogo_signature;                                         ///< POGO的标记,如"PGU\0","LTCG"
+    DWORD           pogo_count;                                             ///< POGO项数
+
+    int             repro;                                                  ///< 1-有repro项
+    DWORD           repro_fa;                                               ///< 散列在文件中的位置
+    DWORD           repro_len;                                              ///< 散列长度,没有数据时为0
+
+    int             pdb;                                                    ///< 1-有嵌入的可移植PDB
+    DWORD           pdb_fa;                                                 ///< 压缩数据在文件中的位置
+    DWORD           pdb_size;                                               ///< 解压后的长度
+    DWORD           pdb_stored;                                             ///< 文件中压缩数据的长度
+
+} PE_DEBUG, *PPE_DEBUG;
+
+typedef struct _PE_DEBUG_FILE                                               ///  只读入头部和调试记录的文件
+{
+    UCHAR          *data;                                                   ///< 按文件位置保存的数据,只提交读入的范围,没有读的部分为0或不能访问
+    size_t          size;                                                   ///< 文件长度,也是data的长度
+    size_t          head;                                                   ///< 从0开始连续读入的长度
+    ULONGLONG       loaded;                                                 ///< 读入的字节数
+    DWORD           reads;                                                  ///< 读的次数
+
+} PE_DEBUG_FILE, *PPE_DEBUG_FILE;
+
+/**
+ *\brief                        找到调试目录,计算在文件范围内的目录项数
+ *\param[in]    image           解析结果
+ *\param[out]   fa              调试目录在文件中的位置
+ *\param[out]   count           目录项数,不超过PE_DEBUG_ENTRY_MAX
+ *\return                       调试目录所在节,-1为没有调试目录或不在任何节中
+ */
+int pe_debug_dir(PPE_IMAGE image, DWORD *fa, DWORD *count);
+
+/**
+ *\brief                        解码调试目录,结果从解析结果的内存池分配,保存到image->debug
+ *\param[in]    image           解析结果,至少解析了头部和节表
+ *\param[in]    flags           需要解码的记录,PE_DEBUG_*,目录项总是解码
+ *\return                       0-成功,其它失败(内存不足)
+ */
+int pe_debug(PPE_IMAGE image, DWORD flags);
+
+/**
+ *\brief                        得到调试目录项类型的名称
+ *\param[in]    type            类型
+ *\return                       名称,未知类型为NULL
+ */
+const char* pe_debug_type(DWORD type);
+
+/**
+ *\brief                        GUID转成文本,按Data1-Data2-Data3-Data4的格式,大写
+ *\param[in]    guid            文件中的16字节
+ *\param[out]   text            至少37字节
+ *\return                       text
+ */
+char* pe_debug_guid(const UCHAR *guid, char *text);
+
+/**
+ *\brief                        得到PDB在符号服务器中的键: PDB文件名/GUID(RSDS)或签名(NB10),再跟十六进制的age/PDB文件名
+ *\param[in]    image           解析结果
+ *\param[out]   key             键,以0结尾
+ *\param[in]    size            key的大小,PE_DEBUG_KEY_MAX时不会截断
+ *\return                       键的长度,没有CodeView或PDB路径为空时为0
+ */
+size_t pe_debug_key(PPE_IMAGE image, char *key, size_t size);
+
+/**
+ *\brief                        得到映像在符号服务器中的键: 文件名/时间(8位十六进制)和映像大小(十六进制)/文件名
+ *\param[in]    image           解析结果
+ *\param[in]    path            文件路径,取最后一个/或\后面的文件名
+ *\param[out]   key             键,以0结尾
+ *\param[in]    size            key的大小
+ *\return                       键的长度
+ */
+size_t pe_image_key(PPE_IMAGE image, const char *path, char *key, size_t size);
+
+/**
+ *\brief                        只读入头部,节表,调试目录和需要的调试记录,解析头部并解码调试目录.
+ *                              读入的数据保存在file中,解析结果引用这些数据,使用后先pe_free再pe_debug_close
+ *\param[out]   image           解析结果
+ *\param[in]    path            文件路径
+ *\param[in]    pool            内存池,NULL时使用解析结果自己的内存池
+ *\param[in]    flags           需要解码的记录,PE_DEBUG_*
+ *\param[out]   file            读入的数据
+ *\return                       1-打开或读取失败,PE_ERR_MEMORY-内存不足,其它同pe_parse_head
+ */
+int pe_debug_open(PPE_IMAGE image, const char *path, PPE_ARENA pool, DWORD flags, PPE_DEBUG_FILE file);
+
+/**
+ *\brief                        释放读入的数据
+ *\param[in]    file            读入的数据
+ *\return                       无
+ */
+void pe_debug_close(PPE_DEBUG_FILE file);
+
+#endif
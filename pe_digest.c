@@ -0,0 +1,277 @@
+/**
+ *\file     pe_digest.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    节数据和附加数据的熵,SHA-256,XXH64实现
+ *          字节直方图用4张计数表轮流计数,相邻字节落在不同的表里,相同字节连续出现时
+ *          不会等上一次加1写回,每次取8字节拆成8个下标;散列按CPU选择的实现分块输入
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#include "pe_digest.h"
+
+/// 解析结构使用的内存池
+#define ARENA(image)            ((NULL != (image)->pool) ? (image)->pool : &(image)->arena)
+
+#define DIGEST_TABLES           4                                           ///< 计数表数
+#define DIGEST_FLUSH            0x40000000                                  ///< 计数表累计这么多字节后并入总数,DWORD不会溢出
+
+/**
+ *\brief                        log2,只用于正数,避免依赖数学库
+ *                              拆出指数后尾数在[sqrt(2)/2,sqrt(2))内,ln用atanh级数计算
+ *\param[in]    x               正数
+ *\return                       log2(x)
+ */
+static double digest_log2(double x)
+{
+    ULONGLONG bits;
+    double    m;
+
+    memcpy(&bits, &x, sizeof(bits));
+
+    int e = (int)((bits >> 52) & 0x7FF) - 1023;
+
+    bits = (bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL; // 尾数,[1,2)
+    memcpy(&m, &bits, sizeof(m));
+
+    if (m > 1.41421356237309504880)
+    {
+        m /= 2;
+        e++;
+    }
+
+    double t    = (m - 1) / (m + 1);
+    double t2   = t * t;
+    double term = t;
+    double sum  = 0;
+
+    for (int k = 1; k < 30; k += 2) // |t|<0.172,15项后小于1e-22
+    {
+        sum  += term / k;
+        term *= t2;
+    }
+
+    return e + 2 * sum * 1.44269504088896340736; // ln(m)/ln(2)
+}
+
+/**
+ *\brief                        按字节计数,每次取8字节,轮流写4张表
+ *\param[in,out] count          计数表
+ *\param[in]    data            数据
+ *\param[in]    size            长度
+ *\return                       无
+ */
+static void digest_count(DWORD count[DIGEST_TABLES][256], const UCHAR *data, size_t size)
+{
+    size_t i = 0;
+
+    for (; i + 8 <= size; i += 8)
+    {
+        ULONGLONG v = le64(data + i);
+
+        count[0][v & 0xFF]++;
+        count[1][(v >> 8) & 0xFF]++;
+        count[2][(v >> 16) & 0xFF]++;
+        count[3][(v >> 24) & 0xFF]++;
+        count[0][(v >> 32) & 0xFF]++;
+        count[1][(v >> 40) & 0xFF]++;
+        count[2][(v >> 48) & 0xFF]++;
+        count[3][v >> 56]++;
+    }
+
+    for (; i < size; i++)
+    {
+        count[0][data[i]]++;
+    }
+}
+
+/**
+ *\brief                        计数表并入总数并清0
+ *\param[in,out] count          计数表
+ *\param[in,out] hist           总数
+ *\return                       无
+ */
+static void digest_flush(DWORD count[DIGEST_TABLES][256], ULONGLONG hist[256])
+{
+    for (int i = 0; i < 256; i++)
+    {
+        hist[i] += (ULONGLONG)count[0][i] + count[1][i] + count[2][i] + count[3][i];
+    }
+
+    memset(count, 0, sizeof(DWORD) * DIGEST_TABLES * 256);
+}
+
+void pe_digest_data(const UCHAR *data, size_t size, DWORD flags, PPE_DIGEST_ITEM item)
+{
+    DWORD       count[DIGEST_TABLES][256];
+    ULONGLONG   hist[256] = { 0 };
+    HASH_SHA256 sha;
+    HASH_XXH64  xxh;
+    size_t      since = 0;
+
+    memset(count, 0, sizeof(count));
+    hash_sha256_init(&sha);
+    hash_xxh64_init(&xxh, 0);
+
+    for (size_t pos = 0; pos < size; pos += PE_DIGEST_CHUNK) // 一块的所有计算都在缓存中完成
+    {
+        size_t n = (size - pos < PE_DIGEST_CHUNK) ? size - pos : PE_DIGEST_CHUNK;
+
+        if (flags & PE_DIGEST_ENTROPY)
+        {
+            digest_count(count, data + pos, n);
+
+            since += n;
+
+            if (since >= DIGEST_FLUSH)
+            {
+                digest_flush(count, hist);
+                since = 0;
+            }
+        }
+
+        if (flags & PE_DIGEST_SHA256)
+        {
+            hash_sha256_update(&sha, data + pos, n);
+        }
+
+        if (flags & PE_DIGEST_XXH64)
+        {
+            hash_xxh64_update(&xxh, data + pos, n);
+        }
+    }
+
+    item->size    = size;
+    item->entropy = 0;
+    item->xxh64   = 0;
+    memset(item->sha256, 0, sizeof(item->sha256));
+
+    if ((flags & PE_DIGEST_ENTROPY) && size > 0)
+    {
+        double sum = 0;
+
+        digest_flush(count, hist);
+
+        for (int i = 0; i < 256; i++) // H = log2(n) - sum(c*log2(c)) / n
+        {
+            if (hist[i] > 1)
+            {
+                sum += (double)hist[i] * digest_log2((double)hist[i]);
+            }
+        }
+
+        item->entropy = digest_log2((double)size) - sum / (double)size;
+        item->entropy = (item->entropy < 0) ? 0 : item->entropy; // 只有一种字节时的舍入误差
+    }
+
+    if (flags & PE_DIGEST_SHA256)
+    {
+        hash_sha256_final(&sha, item->sha256);
+    }
+
+    if (flags & PE_DIGEST_XXH64)
+    {
+        item->xxh64 = hash_xxh64_final(&xxh);
+    }
+}
+
+int pe_digest(PPE_IMAGE image, DWORD flags)
+{
+    PPE_DIGEST digest = pe_arena_alloc(ARENA(image), sizeof(PE_DIGEST));
+    size_t     size   = image->view.size;
+    ULONGLONG  end    = 0;
+
+    if (NULL == digest)
+    {
+        return -1;
+    }
+
+    digest->section = pe_arena_array(ARENA(image), image->section_count + 1, sizeof(PE_DIGEST_ITEM));
+
+    if (NULL == digest->section)
+    {
+        return -2;
+    }
+
+    digest->flags         = flags;
+    digest->section_count = image->section_count;
+
+    for (int i = 0; i < image->section_count; i++)
+    {
+        PPE_SECTION     section = &image->section[i];
+        PPE_DIGEST_ITEM item    = &digest->section[i];
+        size_t          len     = 0;
+
+        if (section->raw_fa < size) // 超出文件的部分不计算
+        {
+            len = size - section->raw_fa;
+            len = (section->raw_size < len) ? section->raw_size : len;
+        }
+
+        pe_digest_data((len > 0) ? image->view.data + section->raw_fa : image->view.data, len, flags, item);
+
+        item->fa       = section->raw_fa;
+        digest->bytes += len;
+
+        if (len > 0 && section->raw_fa + (ULONGLONG)len > end)
+        {
+            end = section->raw_fa + (ULONGLONG)len;
+        }
+    }
+
+    if ((flags & PE_DIGEST_OVERLAY) && end > 0 && end < size && end <= 0xFFFFFFFF)
+    {
+        DWORD cert_fa   = (image->dir_count > 4) ? image->dir[4].VirtualAddress : 0; // 证书表的地址是文件位置
+        DWORD cert_size = (image->dir_count > 4) ? image->dir[4].Size : 0;
+
+        digest->overlay      = 1;
+        digest->overlay_cert = (0 != cert_size && cert_fa >= end && cert_fa < size);
+
+        pe_digest_data(image->view.data + end, size - (size_t)end, flags, &digest->overlay_item);
+
+        digest->overlay_item.fa  = (DWORD)end;
+        digest->bytes           += size - (size_t)end;
+    }
+
+    image->digest = digest;
+    return 0;
+}
+
+int pe_digest_flags(const char *names)
+{
+    static const struct { const char *name; DWORD flags; } item[] = {
+        { "entropy", PE_DIGEST_ENTROPY },
+        { "sha256",  PE_DIGEST_SHA256  },
+        { "xxh64",   PE_DIGEST_XXH64   },
+        { "overlay", PE_DIGEST_OVERLAY },
+        { "all",     PE_DIGEST_ALL     },
+    };
+
+    int flags = 0;
+
+    while (*names)
+    {
+        size_t len   = strcspn(names, ",");
+        int    found = 0;
+
+        for (size_t i = 0; i < SIZEOF(item); i++)
+        {
+            if (len == strlen(item[i].name) && 0 == memcmp(names, item[i].name, len))
+            {
+                flags |= item[i].flags;
+                found  = 1;
+            }
+        }
+
+        if (!found)
+        {
+            return -1;
+        }
+
+        names += len + (',' == names[len]);
+    }
+
+    return flags;
+}
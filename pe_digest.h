@@ -0,0 +1,75 @@
+/**
+ *\file     pe_digest.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    节数据和附加数据的熵,SHA-256,XXH64,一次遍历计算
+ *          每个节的文件数据按PE_DIGEST_CHUNK分块,每块在缓存中依次做字节直方图和两种散列,
+ *          文件数据只从内存读一遍.附加数据为最后一个节的文件数据之后的部分,
+ *          证书表在附加数据中时单独标出.需要哪几项在每次扫描时指定,不需要的不计算
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#ifndef _PE_DIGEST_H_
+#define _PE_DIGEST_H_
+
+#include "pe.h"
+#include "hash.h"
+
+#define PE_DIGEST_ENTROPY       0x01                                        ///< 香农熵,位/字节
+#define PE_DIGEST_SHA256        0x02                                        ///< SHA-256
+#define PE_DIGEST_XXH64         0x04                                        ///< XXH64,种子为0
+#define PE_DIGEST_OVERLAY       0x08                                        ///< 检测附加数据,同时计算附加数据的其它项
+#define PE_DIGEST_ALL           0x0F                                        ///< 所有项
+
+#define PE_DIGEST_CHUNK         (16 * 1024)                                 ///< 一次处理的块长度,在一级/二级缓存中完成所有计算
+
+typedef struct _PE_DIGEST_ITEM                                              ///  一段文件数据的统计
+{
+    DWORD           fa;                                                     ///< 在文件中的位置
+    ULONGLONG       size;                                                   ///< 计算的长度,超出文件的部分不计算
+    double          entropy;                                                ///< 香农熵,0-8
+    UCHAR           sha256[HASH_SHA256_SIZE];                               ///< SHA-256
+    ULONGLONG       xxh64;                                                  ///< XXH64
+
+} PE_DIGEST_ITEM, *PPE_DIGEST_ITEM;
+
+typedef struct _PE_DIGEST                                                   ///  节和附加数据的统计
+{
+    DWORD           flags;                                                  ///< 计算了哪几项,PE_DIGEST_*
+    PPE_DIGEST_ITEM section;                                                ///< 每个节一项,与image->section对应
+    int             section_count;                                          ///< 节数
+    int             overlay;                                                ///< 1-有附加数据
+    int             overlay_cert;                                           ///< 1-证书表在附加数据中
+    PE_DIGEST_ITEM  overlay_item;                                           ///< 附加数据
+    ULONGLONG       bytes;                                                  ///< 读过的字节数
+
+} PE_DIGEST, *PPE_DIGEST;
+
+/**
+ *\brief                        计算节的统计,结果从解析结果的内存池分配,保存到image->digest
+ *\param[in]    image           解析结果,节表已解析
+ *\param[in]    flags           需要的项,PE_DIGEST_*
+ *\return                       0-成功,其它失败(内存不足)
+ */
+int pe_digest(PPE_IMAGE image, DWORD flags);
+
+/**
+ *\brief                        计算一段数据的统计
+ *\param[in]    data            数据
+ *\param[in]    size            长度
+ *\param[in]    flags           需要的项,PE_DIGEST_*
+ *\param[out]   item            结果,fa不填写
+ *\return                       无
+ */
+void pe_digest_data(const UCHAR *data, size_t size, DWORD flags, PPE_DIGEST_ITEM item);
+
+/**
+ *\brief                        通过名称列表得到需要的项
+ *\param[in]    names           逗号分隔的entropy,sha256,xxh64,overlay,all
+ *\return                       PE_DIGEST_*的组合,-1为有不支持的名称
+ */
+int pe_digest_flags(const char *names);
+
+#endif
@@ -0,0 +1,1604 @@
+/**
+ *\file     pe_emit.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    PE解析结果的机器可读输出实现
+ *          每个部分先按最大长度预留一次空间,再直接写缓冲区,不用printf格式化,
+ *          二进制格式中文件里本来就是小端的数组(导出函数地址,重定位项)整块复制
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|文件中的字符串改用view_strn
+ *          2026.10.18|JSON中不需要转义的名称整段复制
+ *          2026.10.18|导入名称有驻留时直接使用
+ *          2026.10.18|输出节和附加数据的熵和摘要
+ *          2026.10.18|输出导入表散列和Rich头
+ *          2026.10.18|输出版本信息和清单
+ *          2026.10.18|输出延迟导入和绑定导入
+ *          2026.10.18|输出调试目录,增加只有符号键的记录
+ *          2026.10.18|输出Authenticode签名和摘要
+ */
+#include "pe_emit.h"
+#include "pe_str.h"
+#include "pe_digest.h"
+#include "pe_finger.h"
+#include "pe_rsrc.h"
+#include "pe_debug.h"
+#include "pe_auth.h"
+
+/// 确保缓冲区还能写入n字节,0-成功
+#define EMIT_NEED(buf, n)       (((buf)->cap - (buf)->len >= (size_t)(n)) ? 0 : pe_buf_reserve(buf, n))
+
+/// 输出字符串常量
+#define EMIT_LIT(buf, s)        emit_raw(buf, s, sizeof(s) - 1)
+
+/// 输出JSON数值,key包括前面的逗号和后面的冒号
+#define JSON_NUM(buf, key, v)   json_num(buf, key, sizeof(key) - 1, v)
+
+#define NUM_MAX                 20                                          ///< ULONGLONG十进制的最大长度
+
+static const char g_digits[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                               "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                               "8081828384858687888990919293949596979899";  ///< 0-99的两位十进制数字
+
+static const char g_hex[] = "0123456789abcdef";                             ///< 十六进制数字
+
+
+int pe_buf_reserve(PPE_BUF buf, size_t need)
+{
+    if (buf->cap - buf->len >= need)
+    {
+        return 0;
+    }
+
+    size_t cap = buf->cap ? buf->cap : 64 * 1024;
+
+    while (cap - buf->len < need)
+    {
+        if (cap > SIZE_MAX / 2)
+        {
+            return -1;
+        }
+
+        cap *= 2;
+    }
+
+    char *data = realloc(buf->data, cap);
+
+    if (NULL == data)
+    {
+        return -1;
+    }
+
+    buf->data = data;
+    buf->cap  = cap;
+    return 0;
+}
+
+void pe_buf_free(PPE_BUF buf)
+{
+    free(buf->data);
+    memset(buf, 0, sizeof(PE_BUF));
+}
+
+int pe_emit_format(const char *name)
+{
+    if (0 == strcmp(name, "json"))
+    {
+        return PE_EMIT_JSON;
+    }
+
+    if (0 == strcmp(name, "bin"))
+    {
+        return PE_EMIT_BIN;
+    }
+
+    return -1;
+}
+
+/**
+ *\brief                        数值转十进制,每次处理两位
+ *\param[out]   dst             输出,至少NUM_MAX字节
+ *\param[in]    value           数值
+ *\return                       长度
+ */
+static size_t emit_u64(char *dst, ULONGLONG value)
+{
+    char  tmp[NUM_MAX];
+    char *p = tmp + NUM_MAX;
+
+    while (value >= 100)
+    {
+        p -= 2;
+        memcpy(p, g_digits + (value % 100) * 2, 2);
+        value /= 100;
+    }
+
+    if (value >= 10)
+    {
+        p -= 2;
+        memcpy(p, g_digits + value * 2, 2);
+    }
+    else
+    {
+        *--p = (char)('0' + value);
+    }
+
+    size_t len = tmp + NUM_MAX - p;
+
+    memcpy(dst, p, len);
+    return len;
+}
+
+/**
+ *\brief                        输出原样数据
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    src             数据
+ *\param[in]    len             长度
+ *\return                       0-成功,其它失败
+ */
+static int emit_raw(PPE_BUF buf, const void *src, size_t len)
+{
+    if (0 != EMIT_NEED(buf, len))
+    {
+        return -1;
+    }
+
+    memcpy(buf->data + buf->len, src, len);
+    buf->len += len;
+    return 0;
+}
+
+/**
+ *\brief                        输出JSON数值
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    key             键,包括前面的逗号和后面的冒号
+ *\param[in]    key_len         键长度
+ *\param[in]    value           数值
+ *\return                       0-成功,其它失败
+ */
+static int json_num(PPE_BUF buf, const char *key, size_t key_len, ULONGLONG value)
+{
+    if (0 != EMIT_NEED(buf, key_len + NUM_MAX))
+    {
+        return -1;
+    }
+
+    memcpy(buf->data + buf->len, key, key_len);
+    buf->len += key_len;
+    buf->len += emit_u64(buf->data + buf->len, value);
+    return 0;
+}
+
+/**
+ *\brief                        输出JSON字符串,转义引号,反斜杠和控制字符
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    src             字符串
+ *\param[in]    len             长度
+ *\param[in]    utf8            1-0x80以上的字节原样输出(路径),0-转义为\u00XX(文件中的字符串,不一定是UTF-8)
+ *\return                       0-成功,其它失败
+ */
+static int json_str(PPE_BUF buf, const char *src, size_t len, int utf8)
+{
+    if (0 != EMIT_NEED(buf, len * 6 + 2))
+    {
+        return -1;
+    }
+
+    char *dst = buf->data + buf->len;
+
+    *dst++ = '"';
+
+    for (size_t i = 0; i < len; i++)
+    {
+        UCHAR c = (UCHAR)src[i];
+
+        if (c >= 0x20 && c != '"' && c != '\\' && (c < 0x80 || utf8))
+        {
+            *dst++ = (char)c;
+        }
+        else if ('"' == c || '\\' == c)
+        {
+            *dst++ = '\\';
+            *dst++ = (char)c;
+        }
+        else
+        {
+            memcpy(dst, "\\u00", 4);
+            dst[4] = g_hex[c >> 4];
+            dst[5] = g_hex[c & 0xF];
+            dst   += 6;
+        }
+    }
+
+    *dst++ = '"';
+
+    buf->len = dst - buf->data;
+    return 0;
+}
+
+/**
+ *\brief                        输出文件中的字符串为JSON字符串,不需要转义时整段复制
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    src             字符串
+ *\param[in]    len             长度
+ *\param[in]    flags           PE_STR_*
+ *\return                       0-成功,其它失败
+ */
+static int json_text(PPE_BUF buf, const char *src, size_t len, DWORD flags)
+{
+    if (0 == (flags & PE_STR_PLAIN))
+    {
+        return json_str(buf, src, len, 0);
+    }
+
+    if (0 != EMIT_NEED(buf, len + 2))
+    {
+        return -1;
+    }
+
+    char *dst = buf->data + buf->len;
+
+    dst[0] = '"';
+    memcpy(dst + 1, src, len);
+    dst[len + 1] = '"';
+
+    buf->len += len + 2;
+    return 0;
+}
+
+/**
+ *\brief                        输出文件中的字符串为JSON字符串
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\param[in]    fa              字符串在文件中的位置,0为没有
+ *\param[in]    interned        驻留的名称,不为NULL时直接使用,不再查找结尾和检查字符
+ *\return                       0-成功,其它失败
+ */
+static int json_name(PPE_BUF buf, PPE_IMAGE image, DWORD fa, const PE_NAME *interned)
+{
+    PE_STR name;
+
+    if (NULL != interned)
+    {
+        return json_text(buf, interned->str, interned->len, interned->flags);
+    }
+
+    pe_str_view(&image->view, fa, PE_EMIT_NAME_MAX, &name);
+
+    return json_text(buf, name.data, name.len, name.flags);
+}
+
+/**
+ *\brief                        输出JSON头部数值和数据目录
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int json_head(PPE_BUF buf, PPE_IMAGE image)
+{
+    int err = 0;
+
+    if (PE_OK == image->error.code)
+    {
+        err |= EMIT_LIT(buf, ",\"error\":null");
+    }
+    else
+    {
+        const char *code = pe_error_string(image->error.code);
+
+        err |= EMIT_LIT(buf, ",\"error\":{\"part\":");
+        err |= json_str(buf, image->error.part ? image->error.part : "", image->error.part ? strlen(image->error.part) : 0, 1);
+        err |= EMIT_LIT(buf, ",\"code\":");
+        err |= json_str(buf, code, strlen(code), 1);
+        err |= JSON_NUM(buf, ",\"fa\":", image->error.fa);
+        err |= JSON_NUM(buf, ",\"count\":", image->error.count);
+        err |= EMIT_LIT(buf, "}");
+    }
+
+    err |= JSON_NUM(buf, ",\"machine\":",         image->machine);
+    err |= JSON_NUM(buf, ",\"characteristics\":", image->characteristics);
+    err |= JSON_NUM(buf, ",\"time\":",            image->time);
+    err |= JSON_NUM(buf, ",\"magic\":",           image->magic);
+    err |= JSON_NUM(buf, ",\"subsystem\":",       image->subsystem);
+    err |= JSON_NUM(buf, ",\"entry\":",           image->entry);
+    err |= JSON_NUM(buf, ",\"image_base\":",      image->image_base);
+    err |= JSON_NUM(buf, ",\"section_align\":",   image->section_align);
+    err |= JSON_NUM(buf, ",\"file_align\":",      image->file_align);
+    err |= JSON_NUM(buf, ",\"image_size\":",      image->image_size);
+    err |= EMIT_LIT(buf, ",\"dirs\":[");
+
+    for (int i = 0; i < IMAGE_NUMBEROF_DIRECTORY_ENTRIES; i++)
+    {
+        err |= JSON_NUM(buf, "[", image->dir[i].VirtualAddress);
+        err |= JSON_NUM(buf, ",", image->dir[i].Size);
+        err |= (i + 1 < IMAGE_NUMBEROF_DIRECTORY_ENTRIES) ? EMIT_LIT(buf, "],") : EMIT_LIT(buf, "]");
+    }
+
+    err |= EMIT_LIT(buf, "]");
+    return err;
+}
+
+/**
+ *\brief                        输出十六进制字符串,按字节顺序
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    data            数据
+ *\param[in]    len             字节数
+ *\return                       0-成功,其它失败
+ */
+static int json_hex(PPE_BUF buf, const UCHAR *data, size_t len)
+{
+    if (0 != EMIT_NEED(buf, len * 2 + 2))
+    {
+        return -1;
+    }
+
+    char *dst = buf->data + buf->len;
+
+    *dst++ = '"';
+
+    for (size_t i = 0; i < len; i++)
+    {
+        *dst++ = g_hex[data[i] >> 4];
+        *dst++ = g_hex[data[i] & 0xF];
+    }
+
+    *dst++ = '"';
+    buf->len = dst - buf->data;
+    return 0;
+}
+
+/**
+ *\brief                        输出一段数据的熵和散列,只输出计算了的项,熵保留4位小数
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    flags           计算了哪几项,PE_DIGEST_*
+ *\param[in]    item            统计结果
+ *\return                       0-成功,其它失败
+ */
+static int json_digest(PPE_BUF buf, DWORD flags, PPE_DIGEST_ITEM item)
+{
+    int err = 0;
+
+    if (flags & PE_DIGEST_ENTROPY)
+    {
+        ULONGLONG value = (ULONGLONG)(item->entropy * 10000 + 0.5);
+        char      frac[4];
+
+        for (int i = 3; i >= 0; i--, value /= 10)
+        {
+            frac[i] = (char)('0' + value % 10);
+        }
+
+        err |= JSON_NUM(buf, ",\"entropy\":", value);
+        err |= EMIT_LIT(buf, ".");
+        err |= emit_raw(buf, frac, sizeof(frac));
+    }
+
+    if (flags & PE_DIGEST_SHA256)
+    {
+        err |= EMIT_LIT(buf, ",\"sha256\":");
+        err |= json_hex(buf, item->sha256, HASH_SHA256_SIZE);
+    }
+
+    if (flags & PE_DIGEST_XXH64)
+    {
+        UCHAR hash[8];
+
+        for (int i = 0; i < 8; i++) // 按数值的十六进制,高位在前
+        {
+            hash[i] = (UCHAR)(item->xxh64 >> (56 - i * 8));
+        }
+
+        err |= EMIT_LIT(buf, ",\"xxh64\":");
+        err |= json_hex(buf, hash, sizeof(hash));
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出JSON附加数据
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    digest          摘要
+ *\return                       0-成功,其它失败
+ */
+static int json_overlay(PPE_BUF buf, PPE_DIGEST digest)
+{
+    int err = 0;
+
+    if (!digest->overlay)
+    {
+        return EMIT_LIT(buf, ",\"overlay\":null");
+    }
+
+    err |= JSON_NUM(buf, ",\"overlay\":{\"fa\":", digest->overlay_item.fa);
+    err |= JSON_NUM(buf, ",\"size\":", digest->overlay_item.size);
+    err |= JSON_NUM(buf, ",\"cert\":", digest->overlay_cert);
+    err |= json_digest(buf, digest->flags, &digest->overlay_item);
+    err |= EMIT_LIT(buf, "}");
+    return err;
+}
+
+/**
+ *\brief                        输出JSON节列表
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int json_section(PPE_BUF buf, PPE_IMAGE image)
+{
+    int  err = 0;
+    char name[IMAGE_SIZEOF_SHORT_NAME + 1];
+
+    err |= EMIT_LIT(buf, ",\"sections\":[");
+
+    for (int i = 0; i < image->section_count; i++)
+    {
+        PPE_SECTION section = &image->section[i];
+
+        pe_section_name(image, i, name);
+
+        err |= (0 == i) ? EMIT_LIT(buf, "{\"name\":") : EMIT_LIT(buf, ",{\"name\":");
+        err |= json_str(buf, name, strlen(name), 0);
+        err |= JSON_NUM(buf, ",\"va\":",    section->virtual_address);
+        err |= JSON_NUM(buf, ",\"vsize\":", section->virtual_size);
+        err |= JSON_NUM(buf, ",\"raw\":",   section->raw_fa);
+        err |= JSON_NUM(buf, ",\"rsize\":", section->raw_size);
+        err |= JSON_NUM(buf, ",\"flags\":", section->characteristics);
+
+        if (NULL != image->digest && i < image->digest->section_count)
+        {
+            err |= json_digest(buf, image->digest->flags, &image->digest->section[i]);
+        }
+
+        err |= EMIT_LIT(buf, "}");
+    }
+
+    err |= EMIT_LIT(buf, "]");
+
+    if (NULL != image->digest && (image->digest->flags & PE_DIGEST_OVERLAY))
+    {
+        err |= json_overlay(buf, image->digest);
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出JSON导入表,导入表,延迟导入表和绑定导入表的项在同一个数组中.
+ *                              导入表的函数取输入名称表,没有时取输入地址表;延迟导入的函数只取输入名称表
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int json_import(PPE_BUF buf, PPE_IMAGE image)
+{
+    int err = 0;
+
+    err |= EMIT_LIT(buf, ",\"imports\":[");
+
+    for (DWORD i = 0; i < image->lib_count; i++)
+    {
+        PPE_IMPORT_LIB  lib   = &image->lib[i];
+        PPE_IMPORT_FUNC func  = (lib->func_count || PE_IMPORT_STATIC != lib->type) ? lib->func : lib->iat;
+        DWORD           count = (lib->func_count || PE_IMPORT_STATIC != lib->type) ? lib->func_count : lib->iat_count;
+
+        err |= (0 == i) ? EMIT_LIT(buf, "{\"dll\":") : EMIT_LIT(buf, ",{\"dll\":");
+        err |= json_name(buf, image, lib->name_fa, lib->name);
+
+        if (PE_IMPORT_BOUND == lib->type || PE_IMPORT_BOUND_REF == lib->type) // 只有被绑定库的时间
+        {
+            err |= (PE_IMPORT_BOUND == lib->type) ? EMIT_LIT(buf, ",\"type\":\"bound\"") : EMIT_LIT(buf, ",\"type\":\"bound_ref\"");
+            err |= JSON_NUM(buf, ",\"time\":", lib->time);
+            err |= (PE_IMPORT_BOUND == lib->type) ? JSON_NUM(buf, ",\"refs\":", lib->forwarder) : 0;
+            err |= EMIT_LIT(buf, "}");
+            continue;
+        }
+
+        if (PE_IMPORT_DELAY == lib->type)
+        {
+            err |= EMIT_LIT(buf, ",\"type\":\"delay\"");
+            err |= JSON_NUM(buf, ",\"attrs\":", lib->attributes);
+        }
+
+        err |= EMIT_LIT(buf, ",\"funcs\":[");
+
+        for (DWORD j = 0; j < count; j++, func++)
+        {
+            if (func->by_ordinal)
+            {
+                err |= (0 == j) ? JSON_NUM(buf, "{\"ordinal\":", func->ordinal) : JSON_NUM(buf, ",{\"ordinal\":", func->ordinal);
+            }
+            else
+            {
+                err |= (0 == j) ? EMIT_LIT(buf, "{\"name\":") : EMIT_LIT(buf, ",{\"name\":");
+                err |= json_name(buf, image, func->name_fa ? func->name_fa + 2 : 0, func->name);
+                err |= JSON_NUM(buf, ",\"hint\":", func->hint);
+            }
+
+            err |= EMIT_LIT(buf, "}");
+        }
+
+        err |= EMIT_LIT(buf, "]}");
+    }
+
+    err |= EMIT_LIT(buf, "]");
+    return err;
+}
+
+/**
+ *\brief                        输出JSON导出表,函数地址按序号-base排列,名称指向函数地址的下标
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int json_export(PPE_BUF buf, PPE_IMAGE image)
+{
+    PPE_EXPORT export = &image->export;
+    UCHAR     *data   = image->view.data;
+    int        err    = 0;
+
+    if (image->export_section < 0)
+    {
+        return EMIT_LIT(buf, ",\"exports\":null");
+    }
+
+    err |= EMIT_LIT(buf, ",\"exports\":{\"dll\":");
+    err |= json_name(buf, image, export->name_fa, NULL);
+    err |= JSON_NUM(buf, ",\"base\":", export->base);
+    err |= EMIT_LIT(buf, ",\"rvas\":[");
+
+    // 地址都是数值,一次预留
+    if (0 == EMIT_NEED(buf, (size_t)export->func_count * (NUM_MAX + 1)))
+    {
+        char *dst = buf->data + buf->len;
+
+        for (DWORD i = 0; i < export->func_count; i++)
+        {
+            if (0 != i)
+            {
+                *dst++ = ',';
+            }
+
+            dst += emit_u64(dst, le32(data + export->func_fa + i * sizeof(DWORD)));
+        }
+
+        buf->len = dst - buf->data;
+    }
+    else
+    {
+        err = -1;
+    }
+
+    err |= EMIT_LIT(buf, "],\"names\":[");
+
+    for (DWORD i = 0; i < export->name_count; i++)
+    {
+        DWORD fa = 0;
+
+        if (pe_rva_to_fa(image, le32(data + export->names_fa + i * sizeof(DWORD)), &fa) < 0)
+        {
+            fa = 0;
+        }
+
+        err |= (0 == i) ? EMIT_LIT(buf, "{\"name\":") : EMIT_LIT(buf, ",{\"name\":");
+        err |= json_name(buf, image, fa, NULL);
+        err |= JSON_NUM(buf, ",\"index\":", le16(data + export->ords_fa + i * sizeof(WORD)));
+        err |= EMIT_LIT(buf, "}");
+    }
+
+    err |= EMIT_LIT(buf, "]}");
+    return err;
+}
+
+/**
+ *\brief                        输出JSON重定位表,重定位项为原始WORD值:类型<<12|页内偏移
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int json_reloc(PPE_BUF buf, PPE_IMAGE image)
+{
+    int err = 0;
+
+    err |= EMIT_LIT(buf, ",\"relocs\":[");
+
+    for (DWORD i = 0; i < image->reloc_count; i++)
+    {
+        PPE_RELOC_BLOCK block = &image->reloc[i];
+        const UCHAR    *entry = image->view.data + block->fa + sizeof(IMAGE_BASE_RELOCATION);
+
+        err |= (0 == i) ? JSON_NUM(buf, "{\"page\":", block->page) : JSON_NUM(buf, ",{\"page\":", block->page);
+        err |= EMIT_LIT(buf, ",\"entries\":[");
+
+        // 每项最多5位数字和1个逗号,一次预留
+        if (0 != EMIT_NEED(buf, (size_t)block->count * 6))
+        {
+            return -1;
+        }
+
+        char *dst = buf->data + buf->len;
+
+        for (DWORD j = 0; j < block->count; j++, entry += sizeof(WORD))
+        {
+            if (0 != j)
+            {
+                *dst++ = ',';
+            }
+
+            dst += emit_u64(dst, le16(entry));
+        }
+
+        buf->len = dst - buf->data;
+
+        err |= EMIT_LIT(buf, "]}");
+    }
+
+    err |= EMIT_LIT(buf, "]");
+    return err;
+}
+
+/**
+ *\brief                        输出JSON指纹,只输出计算了的项
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    finger          指纹
+ *\return                       0-成功,其它失败
+ */
+static int json_finger(PPE_BUF buf, PPE_FINGER finger)
+{
+    int err = 0;
+
+    if (finger->flags & PE_FINGER_IMPHASH)
+    {
+        err |= EMIT_LIT(buf, ",\"imphash\":");
+        err |= finger->imphash ? json_hex(buf, finger->imphash_md5, HASH_MD5_SIZE) : EMIT_LIT(buf, "null");
+    }
+
+    if (!(finger->flags & PE_FINGER_RICH))
+    {
+        return err;
+    }
+
+    if (!finger->rich)
+    {
+        return err | EMIT_LIT(buf, ",\"rich\":null");
+    }
+
+    err |= JSON_NUM(buf, ",\"rich\":{\"fa\":", finger->rich_fa);
+    err |= JSON_NUM(buf, ",\"key\":",   finger->rich_key);
+    err |= JSON_NUM(buf, ",\"valid\":", finger->rich_valid);
+    err |= EMIT_LIT(buf, ",\"hash\":");
+    err |= json_hex(buf, finger->rich_md5, HASH_MD5_SIZE);
+    err |= EMIT_LIT(buf, ",\"entries\":[");
+
+    for (DWORD i = 0; i < finger->rich_count; i++)
+    {
+        PPE_RICH_ENTRY entry = &finger->rich_entry[i];
+
+        err |= (0 == i) ? JSON_NUM(buf, "[", entry->prod) : JSON_NUM(buf, ",[", entry->prod);
+        err |= JSON_NUM(buf, ",", entry->build);
+        err |= JSON_NUM(buf, ",", entry->count);
+        err |= EMIT_LIT(buf, "]");
+    }
+
+    err |= EMIT_LIT(buf, "]}");
+    return err;
+}
+
+/**
+ *\brief                        输出JSON版本信息和清单,只输出计算了的项
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\param[in]    version         版本信息
+ *\return                       0-成功,其它失败
+ */
+static int json_version(PPE_BUF buf, PPE_IMAGE image, PPE_VERSION version)
+{
+    char text[24];
+    int  err = 0;
+
+    if (version->flags & PE_VERSION_INFO)
+    {
+        if (!version->info)
+        {
+            err |= EMIT_LIT(buf, ",\"version\":null");
+        }
+        else
+        {
+            err |= JSON_NUM(buf, ",\"version\":{\"fa\":", version->info_fa);
+            err |= JSON_NUM(buf, ",\"size\":", version->info_size);
+            err |= JSON_NUM(buf, ",\"lang\":", version->info_lang);
+
+            if (version->fixed)
+            {
+                pe_version_text(version->file_ms, version->file_ls, text);
+                err |= EMIT_LIT(buf, ",\"file\":");
+                err |= json_str(buf, text, strlen(text), 1);
+                pe_version_text(version->product_ms, version->product_ls, text);
+                err |= EMIT_LIT(buf, ",\"product\":");
+                err |= json_str(buf, text, strlen(text), 1);
+            }
+            else
+            {
+                err |= EMIT_LIT(buf, ",\"file\":null,\"product\":null");
+            }
+
+            err |= JSON_NUM(buf, ",\"flags\":", version->file_flags);
+            err |= JSON_NUM(buf, ",\"os\":",    version->file_os);
+            err |= JSON_NUM(buf, ",\"type\":",  version->file_type);
+            err |= EMIT_LIT(buf, ",\"table\":");
+            err |= json_str(buf, version->table, strlen(version->table), 1);
+            err |= EMIT_LIT(buf, ",\"strings\":{");
+
+            for (DWORD i = 0; i < version->str_count; i++)
+            {
+                PPE_VERSION_STRING str = &version->str[i];
+
+                err |= (0 == i) ? 0 : EMIT_LIT(buf, ",");
+                err |= json_str(buf, str->key, strlen(str->key), 1);
+                err |= EMIT_LIT(buf, ":");
+                err |= json_str(buf, str->value, strlen(str->value), 1);
+            }
+
+            err |= EMIT_LIT(buf, "}}");
+        }
+    }
+
+    if (!(version->flags & PE_VERSION_MANIFEST))
+    {
+        return err;
+    }
+
+    if (!version->manifest)
+    {
+        return err | EMIT_LIT(buf, ",\"manifest\":null");
+    }
+
+    DWORD len = (version->manifest_size < PE_VERSION_MANIFEST_MAX) ? version->manifest_size : PE_VERSION_MANIFEST_MAX;
+
+    err |= JSON_NUM(buf, ",\"manifest\":{\"fa\":", version->manifest_fa);
+    err |= JSON_NUM(buf, ",\"size\":", version->manifest_size);
+    err |= JSON_NUM(buf, ",\"id\":",   version->manifest_id);
+    err |= EMIT_LIT(buf, ",\"text\":");
+    err |= json_str(buf, (const char*)image->view.data + version->manifest_fa, len, 0);
+    err |= EMIT_LIT(buf, "}");
+    return err;
+}
+
+/**
+ *\brief                        输出JSON的CodeView,没有时为null
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\param[in]    debug           调试目录
+ *\return                       0-成功,其它失败
+ */
+static int json_codeview(PPE_BUF buf, PPE_IMAGE image, PPE_DEBUG debug)
+{
+    char text[PE_DEBUG_KEY_MAX];
+    int  err = 0;
+
+    if (!debug->codeview)
+    {
+        return EMIT_LIT(buf, ",\"codeview\":null");
+    }
+
+    if (PE_DEBUG_RSDS == debug->cv_format)
+    {
+        err |= EMIT_LIT(buf, ",\"codeview\":{\"format\":\"RSDS\",\"guid\":");
+        err |= json_str(buf, pe_debug_guid(debug->cv_guid, text), 36, 1);
+    }
+    else
+    {
+        err |= EMIT_LIT(buf, ",\"codeview\":{\"format\":\"NB10\"");
+        err |= JSON_NUM(buf, ",\"signature\":", debug->cv_signature);
+    }
+
+    size_t len = pe_debug_key(image, text, sizeof(text));
+
+    err |= JSON_NUM(buf, ",\"age\":", debug->cv_age);
+    err |= EMIT_LIT(buf, ",\"path\":");
+    err |= json_str(buf, (const char*)image->view.data + debug->cv_path_fa, debug->cv_path_len, 0);
+    err |= EMIT_LIT(buf, ",\"key\":");
+    err |= json_str(buf, text, len, 0);
+    err |= EMIT_LIT(buf, "}");
+    return err;
+}
+
+/**
+ *\brief                        输出JSON调试目录,目录项总是输出,记录只输出解码了的项
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\param[in]    debug           调试目录
+ *\return                       0-成功,其它失败
+ */
+static int json_debug(PPE_BUF buf, PPE_IMAGE image, PPE_DEBUG debug)
+{
+    int err = EMIT_LIT(buf, ",\"debug\":[");
+
+    for (DWORD i = 0; i < debug->count; i++)
+    {
+        PPE_DEBUG_ENTRY entry = &debug->entry[i];
+
+        err |= (0 == i) ? JSON_NUM(buf, "{\"type\":", entry->type) : JSON_NUM(buf, ",{\"type\":", entry->type);
+        err |= JSON_NUM(buf, ",\"time\":",  entry->time);
+        err |= JSON_NUM(buf, ",\"major\":", entry->major);
+        err |= JSON_NUM(buf, ",\"minor\":", entry->minor);
+        err |= JSON_NUM(buf, ",\"size\":",  entry->size);
+        err |= JSON_NUM(buf, ",\"rva\":",   entry->rva);
+        err |= JSON_NUM(buf, ",\"fa\":",    entry->raw_fa);
+        err |= EMIT_LIT(buf, "}");
+    }
+
+    err |= EMIT_LIT(buf, "]");
+
+    if (debug->flags & PE_DEBUG_CODEVIEW)
+    {
+        err |= json_codeview(buf, image, debug);
+    }
+
+    if (debug->flags & PE_DEBUG_POGO)
+    {
+        err |= debug->pogo ? JSON_NUM(buf, ",\"pogo\":{\"signature\":", debug->pogo_signature) : EMIT_LIT(buf, ",\"pogo\":null");
+        err |= debug->pogo ? JSON_NUM(buf, ",\"entries\":", debug->pogo_count) : 0;
+        err |= debug->pogo ? EMIT_LIT(buf, "}") : 0;
+    }
+
+    if (debug->flags & PE_DEBUG_REPRO)
+    {
+        err |= debug->repro ? EMIT_LIT(buf, ",\"repro\":{\"hash\":") : EMIT_LIT(buf, ",\"repro\":null");
+        err |= debug->repro ? json_hex(buf, image->view.data + debug->repro_fa, debug->repro_len) : 0;
+        err |= debug->repro ? EMIT_LIT(buf, "}") : 0;
+    }
+
+    if (debug->flags & PE_DEBUG_PDB)
+    {
+        err |= debug->pdb ? JSON_NUM(buf, ",\"embedded_pdb\":{\"fa\":", debug->pdb_fa) : EMIT_LIT(buf, ",\"embedded_pdb\":null");
+        err |= debug->pdb ? JSON_NUM(buf, ",\"size\":", debug->pdb_size) : 0;
+        err |= debug->pdb ? JSON_NUM(buf, ",\"stored\":", debug->pdb_stored) : 0;
+        err |= debug->pdb ? EMIT_LIT(buf, "}") : 0;
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出JSON签名,没有解码或计算的项为null
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    auth            签名和摘要
+ *\return                       0-成功,其它失败
+ */
+static int json_auth(PPE_BUF buf, PPE_AUTH auth)
+{
+    const char *status = pe_auth_status(auth);
+    const char *alg    = pe_auth_alg(auth->hash_alg);
+    int         err    = 0;
+
+    err |= EMIT_LIT(buf, ",\"auth\":{\"status\":");
+    err |= json_str(buf, status, strlen(status), 1);
+    err |= JSON_NUM(buf, ",\"fa\":",   auth->cert_fa);
+    err |= JSON_NUM(buf, ",\"size\":", auth->cert_size);
+    err |= EMIT_LIT(buf, ",\"entries\":[");
+
+    for (DWORD i = 0; i < auth->count; i++)
+    {
+        PPE_AUTH_ENTRY entry = &auth->entry[i];
+
+        err |= (0 == i) ? JSON_NUM(buf, "[", entry->fa) : JSON_NUM(buf, ",[", entry->fa);
+        err |= JSON_NUM(buf, ",", entry->length);
+        err |= JSON_NUM(buf, ",", entry->revision);
+        err |= JSON_NUM(buf, ",", entry->type);
+        err |= EMIT_LIT(buf, "]");
+    }
+
+    err |= EMIT_LIT(buf, "],\"alg\":");
+    err |= json_str(buf, alg, strlen(alg), 1);
+    err |= EMIT_LIT(buf, ",\"signed\":");
+    err |= auth->pkcs7 ? json_hex(buf, auth->signed_digest, auth->signed_len) : EMIT_LIT(buf, "null");
+    err |= JSON_NUM(buf, ",\"certs\":",   auth->certs);
+    err |= JSON_NUM(buf, ",\"signers\":", auth->signers);
+    err |= EMIT_LIT(buf, ",\"digest\":");
+    err |= auth->hashed ? json_hex(buf, auth->digest, auth->digest_len) : EMIT_LIT(buf, "null");
+    err |= JSON_NUM(buf, ",\"bytes\":", auth->bytes);
+    err |= EMIT_LIT(buf, "}");
+    return err;
+}
+
+/**
+ *\brief                        输出一条JSON Lines记录
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    status          状态
+ *\param[in]    image           解析结果,可以为NULL
+ *\param[in]    size            文件长度
+ *\param[in]    path            文件路径
+ *\return                       0-成功,其它失败
+ */
+static int emit_json(PPE_BUF buf, const char *status, PPE_IMAGE image, size_t size, const char *path)
+{
+    int err = 0;
+
+    err |= EMIT_LIT(buf, "{\"path\":");
+    err |= json_str(buf, path, strlen(path), 1);
+    err |= JSON_NUM(buf, ",\"size\":", size);
+    err |= EMIT_LIT(buf, ",\"status\":");
+    err |= json_str(buf, status, strlen(status), 1);
+
+    if (NULL != image)
+    {
+        err |= json_head(buf, image);
+        err |= json_section(buf, image);
+        err |= json_import(buf, image);
+        err |= json_export(buf, image);
+        err |= json_reloc(buf, image);
+
+        if (NULL != image->finger)
+        {
+            err |= json_finger(buf, image->finger);
+        }
+
+        if (NULL != image->version)
+        {
+            err |= json_version(buf, image, image->version);
+        }
+
+        if (NULL != image->debug)
+        {
+            err |= json_debug(buf, image, image->debug);
+        }
+
+        if (NULL != image->auth)
+        {
+            err |= json_auth(buf, image->auth);
+        }
+    }
+
+    err |= EMIT_LIT(buf, "}\n");
+    return err;
+}
+
+/**
+ *\brief                        写小端数值,已预留空间
+ *\param[out]   dst             输出
+ *\param[in]    value           数值
+ *\param[in]    len             字节数
+ *\return                       无
+ */
+static void bin_put(char *dst, ULONGLONG value, int len)
+{
+    for (int i = 0; i < len; i++, value >>= 8)
+    {
+        dst[i] = (char)(value & 0xFF);
+    }
+}
+
+/**
+ *\brief                        输出小端数值
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    value           数值
+ *\param[in]    len             字节数:1,2,4,8
+ *\return                       0-成功,其它失败
+ */
+static int bin_num(PPE_BUF buf, ULONGLONG value, int len)
+{
+    if (0 != EMIT_NEED(buf, len))
+    {
+        return -1;
+    }
+
+    bin_put(buf->data + buf->len, value, len);
+    buf->len += len;
+    return 0;
+}
+
+/**
+ *\brief                        输出WORD长度+字节的字符串,超过0xFFFF字节时截断
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    src             字符串
+ *\param[in]    len             长度
+ *\return                       0-成功,其它失败
+ */
+static int bin_str(PPE_BUF buf, const char *src, size_t len)
+{
+    if (len > 0xFFFF)
+    {
+        len = 0xFFFF;
+    }
+
+    if (0 != EMIT_NEED(buf, len + 2))
+    {
+        return -1;
+    }
+
+    bin_put(buf->data + buf->len, len, 2);
+    memcpy(buf->data + buf->len + 2, src, len);
+    buf->len += len + 2;
+    return 0;
+}
+
+/**
+ *\brief                        输出文件中的字符串
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\param[in]    fa              字符串在文件中的位置,0为没有
+ *\param[in]    interned        驻留的名称,不为NULL时直接使用
+ *\return                       0-成功,其它失败
+ */
+static int bin_name(PPE_BUF buf, PPE_IMAGE image, DWORD fa, const PE_NAME *interned)
+{
+    size_t      len  = 0;
+    const char *name = NULL;
+
+    if (NULL != interned)
+    {
+        return bin_str(buf, interned->str, interned->len);
+    }
+
+    name = view_strn(&image->view, fa, PE_EMIT_NAME_MAX, &len);
+
+    return bin_str(buf, name, len);
+}
+
+/**
+ *\brief                        输出二进制记录中的一个导入库:库名,函数数和函数
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\param[in]    func            函数列表
+ *\param[in]    count           函数数量
+ *\param[in]    lib             导入库
+ *\return                       0-成功,其它失败
+ */
+static int bin_import_lib(PPE_BUF buf, PPE_IMAGE image, PPE_IMPORT_FUNC func, DWORD count, PPE_IMPORT_LIB lib)
+{
+    int err = 0;
+
+    err |= bin_name(buf, image, lib->name_fa, lib->name);
+    err |= bin_num(buf, count, 4);
+
+    for (DWORD j = 0; j < count; j++, func++)
+    {
+        err |= bin_num(buf, func->by_ordinal, 1);
+        err |= bin_num(buf, func->by_ordinal ? func->ordinal : func->hint, 2);
+
+        if (!func->by_ordinal)
+        {
+            err |= bin_name(buf, image, func->name_fa ? func->name_fa + 2 : 0, func->name);
+        }
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出二进制解析结果,格式见pe_emit.h
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int bin_image(PPE_BUF buf, PPE_IMAGE image)
+{
+    PPE_EXPORT export = &image->export;
+    UCHAR     *data   = image->view.data;
+    int        err    = 0;
+
+    err |= bin_num(buf, (DWORD)image->error.code, 4);
+    err |= bin_num(buf, image->error.fa, 4);
+    err |= bin_str(buf, image->error.part ? image->error.part : "", image->error.part ? strlen(image->error.part) : 0);
+    err |= bin_num(buf, image->machine, 2);
+    err |= bin_num(buf, image->characteristics, 2);
+    err |= bin_num(buf, image->magic, 2);
+    err |= bin_num(buf, image->subsystem, 2);
+    err |= bin_num(buf, image->time, 4);
+    err |= bin_num(buf, image->entry, 4);
+    err |= bin_num(buf, image->image_base, 8);
+    err |= bin_num(buf, image->section_align, 4);
+    err |= bin_num(buf, image->file_align, 4);
+    err |= bin_num(buf, image->image_size, 4);
+    err |= bin_num(buf, image->dir_count, 4);
+
+    for (int i = 0; i < IMAGE_NUMBEROF_DIRECTORY_ENTRIES; i++)
+    {
+        err |= bin_num(buf, image->dir[i].VirtualAddress, 4);
+        err |= bin_num(buf, image->dir[i].Size, 4);
+    }
+
+    err |= bin_num(buf, image->section_count, 4);
+
+    for (int i = 0; i < image->section_count; i++)
+    {
+        PPE_SECTION section = &image->section[i];
+
+        err |= emit_raw(buf, data + section->fa, IMAGE_SIZEOF_SHORT_NAME);
+        err |= bin_num(buf, section->virtual_address, 4);
+        err |= bin_num(buf, section->virtual_size, 4);
+        err |= bin_num(buf, section->raw_fa, 4);
+        err |= bin_num(buf, section->raw_size, 4);
+        err |= bin_num(buf, section->characteristics, 4);
+    }
+
+    err |= bin_num(buf, image->lib_static, 4);
+
+    for (DWORD i = 0; i < image->lib_static; i++)
+    {
+        PPE_IMPORT_LIB lib = &image->lib[i];
+
+        err |= bin_import_lib(buf, image, lib->func_count ? lib->func : lib->iat,
+                              lib->func_count ? lib->func_count : lib->iat_count, lib);
+    }
+
+    DWORD func_count = (image->export_section < 0) ? 0 : export->func_count;
+    DWORD name_count = (image->export_section < 0) ? 0 : export->name_count;
+
+    err |= bin_name(buf, image, (image->export_section < 0) ? 0 : export->name_fa, NULL);
+    err |= bin_num(buf, export->base, 4);
+    err |= bin_num(buf, func_count, 4);
+    err |= emit_raw(buf, data + export->func_fa, (size_t)func_count * sizeof(DWORD)); // 文件中就是小端DWORD数组
+    err |= bin_num(buf, name_count, 4);
+
+    for (DWORD i = 0; i < name_count; i++)
+    {
+        DWORD fa = 0;
+
+        if (pe_rva_to_fa(image, le32(data + export->names_fa + i * sizeof(DWORD)), &fa) < 0)
+        {
+            fa = 0;
+        }
+
+        err |= emit_raw(buf, data + export->ords_fa + i * sizeof(WORD), sizeof(WORD));
+        err |= bin_name(buf, image, fa, NULL);
+    }
+
+    err |= bin_num(buf, image->reloc_count, 4);
+
+    for (DWORD i = 0; i < image->reloc_count; i++)
+    {
+        PPE_RELOC_BLOCK block = &image->reloc[i];
+
+        err |= bin_num(buf, block->page, 4);
+        err |= bin_num(buf, block->count, 4);
+        err |= emit_raw(buf, data + block->fa + sizeof(IMAGE_BASE_RELOCATION), (size_t)block->count * sizeof(WORD));
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出二进制的一段数据的熵和散列,没有计算的项为0
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    item            统计结果
+ *\return                       0-成功,其它失败
+ */
+static int bin_digest_item(PPE_BUF buf, PPE_DIGEST_ITEM item)
+{
+    int err = 0;
+
+    err |= bin_num(buf, (DWORD)(item->entropy * 1000000 + 0.5), 4);
+    err |= emit_raw(buf, item->sha256, HASH_SHA256_SIZE);
+    err |= bin_num(buf, item->xxh64, 8);
+    return err;
+}
+
+/**
+ *\brief                        输出二进制摘要,格式见pe_emit.h
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    digest          摘要,节数与记录中的节数相同
+ *\return                       0-成功,其它失败
+ */
+static int bin_digest(PPE_BUF buf, PPE_DIGEST digest)
+{
+    int err = 0;
+
+    err |= bin_num(buf, digest->flags, 4);
+
+    for (int i = 0; i < digest->section_count; i++)
+    {
+        err |= bin_digest_item(buf, &digest->section[i]);
+    }
+
+    err |= bin_num(buf, digest->overlay, 1);
+
+    if (digest->overlay)
+    {
+        err |= bin_num(buf, digest->overlay_item.fa, 4);
+        err |= bin_num(buf, digest->overlay_item.size, 8);
+        err |= bin_num(buf, digest->overlay_cert, 1);
+        err |= bin_digest_item(buf, &digest->overlay_item);
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出二进制指纹,格式见pe_emit.h
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    finger          指纹
+ *\return                       0-成功,其它失败
+ */
+static int bin_finger(PPE_BUF buf, PPE_FINGER finger)
+{
+    int err = 0;
+
+    err |= bin_num(buf, finger->flags, 4);
+    err |= bin_num(buf, finger->imphash, 1);
+
+    if (finger->imphash)
+    {
+        err |= emit_raw(buf, finger->imphash_md5, HASH_MD5_SIZE);
+        err |= bin_num(buf, finger->imp_count, 4);
+    }
+
+    err |= bin_num(buf, finger->rich, 1);
+
+    if (finger->rich)
+    {
+        err |= bin_num(buf, finger->rich_fa, 4);
+        err |= bin_num(buf, finger->rich_key, 4);
+        err |= bin_num(buf, finger->rich_valid, 1);
+        err |= emit_raw(buf, finger->rich_md5, HASH_MD5_SIZE);
+        err |= bin_num(buf, finger->rich_count, 4);
+
+        for (DWORD i = 0; i < finger->rich_count; i++)
+        {
+            err |= bin_num(buf, finger->rich_entry[i].prod, 2);
+            err |= bin_num(buf, finger->rich_entry[i].build, 2);
+            err |= bin_num(buf, finger->rich_entry[i].count, 4);
+        }
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出二进制版本信息和清单,格式见pe_emit.h
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\param[in]    version         版本信息
+ *\return                       0-成功,其它失败
+ */
+static int bin_version(PPE_BUF buf, PPE_IMAGE image, PPE_VERSION version)
+{
+    int err = 0;
+
+    err |= bin_num(buf, version->flags, 4);
+    err |= bin_num(buf, version->info, 1);
+
+    if (version->info)
+    {
+        err |= bin_num(buf, version->info_fa, 4);
+        err |= bin_num(buf, version->info_size, 4);
+        err |= bin_num(buf, version->info_lang, 4);
+        err |= bin_num(buf, version->fixed, 1);
+
+        if (version->fixed)
+        {
+            err |= bin_num(buf, version->file_ms, 4);
+            err |= bin_num(buf, version->file_ls, 4);
+            err |= bin_num(buf, version->product_ms, 4);
+            err |= bin_num(buf, version->product_ls, 4);
+            err |= bin_num(buf, version->file_flags, 4);
+            err |= bin_num(buf, version->file_os, 4);
+            err |= bin_num(buf, version->file_type, 4);
+        }
+
+        err |= bin_str(buf, version->table, strlen(version->table));
+        err |= bin_num(buf, version->str_count, 4);
+
+        for (DWORD i = 0; i < version->str_count; i++)
+        {
+            err |= bin_str(buf, version->str[i].key, strlen(version->str[i].key));
+            err |= bin_str(buf, version->str[i].value, strlen(version->str[i].value));
+        }
+    }
+
+    err |= bin_num(buf, version->manifest, 1);
+
+    if (version->manifest)
+    {
+        err |= bin_num(buf, version->manifest_fa, 4);
+        err |= bin_num(buf, version->manifest_size, 4);
+        err |= bin_num(buf, version->manifest_id, 4);
+        err |= bin_str(buf, (const char*)image->view.data + version->manifest_fa, version->manifest_size);
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出二进制CodeView,格式见pe_emit.h
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\param[in]    debug           调试目录
+ *\return                       0-成功,其它失败
+ */
+static int bin_codeview(PPE_BUF buf, PPE_IMAGE image, PPE_DEBUG debug)
+{
+    char key[PE_DEBUG_KEY_MAX];
+    int  err = bin_num(buf, debug->codeview, 1);
+
+    if (debug->codeview)
+    {
+        size_t len = pe_debug_key(image, key, sizeof(key));
+
+        err |= bin_num(buf, debug->cv_format, 4);
+        err |= EMIT_NEED(buf, sizeof(debug->cv_guid)) || emit_raw(buf, debug->cv_guid, sizeof(debug->cv_guid));
+        err |= bin_num(buf, debug->cv_signature, 4);
+        err |= bin_num(buf, debug->cv_age, 4);
+        err |= bin_str(buf, (const char*)image->view.data + debug->cv_path_fa, debug->cv_path_len);
+        err |= bin_str(buf, key, len);
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出二进制调试目录,格式见pe_emit.h
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\param[in]    debug           调试目录
+ *\return                       0-成功,其它失败
+ */
+static int bin_debug(PPE_BUF buf, PPE_IMAGE image, PPE_DEBUG debug)
+{
+    int err = 0;
+
+    err |= bin_num(buf, debug->flags, 4);
+    err |= bin_num(buf, debug->count, 4);
+
+    for (DWORD i = 0; i < debug->count; i++)
+    {
+        PPE_DEBUG_ENTRY entry = &debug->entry[i];
+
+        err |= bin_num(buf, entry->type, 4);
+        err |= bin_num(buf, entry->time, 4);
+        err |= bin_num(buf, entry->major, 2);
+        err |= bin_num(buf, entry->minor, 2);
+        err |= bin_num(buf, entry->size, 4);
+        err |= bin_num(buf, entry->rva, 4);
+        err |= bin_num(buf, entry->raw_fa, 4);
+    }
+
+    err |= bin_codeview(buf, image, debug);
+    err |= bin_num(buf, debug->pogo, 1);
+
+    if (debug->pogo)
+    {
+        err |= bin_num(buf, debug->pogo_signature, 4);
+        err |= bin_num(buf, debug->pogo_count, 4);
+    }
+
+    err |= bin_num(buf, debug->repro, 1);
+
+    if (debug->repro)
+    {
+        err |= bin_str(buf, (const char*)image->view.data + debug->repro_fa, debug->repro_len);
+    }
+
+    err |= bin_num(buf, debug->pdb, 1);
+
+    if (debug->pdb)
+    {
+        err |= bin_num(buf, debug->pdb_fa, 4);
+        err |= bin_num(buf, debug->pdb_size, 4);
+        err |= bin_num(buf, debug->pdb_stored, 4);
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出二进制签名,格式见pe_emit.h
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    auth            签名和摘要
+ *\return                       0-成功,其它失败
+ */
+static int bin_auth(PPE_BUF buf, PPE_AUTH auth)
+{
+    int err = 0;
+
+    err |= bin_num(buf, auth->flags, 4);
+    err |= bin_num(buf, auth->cert_fa, 4);
+    err |= bin_num(buf, auth->cert_size, 4);
+    err |= bin_num(buf, auth->count, 4);
+
+    for (DWORD i = 0; i < auth->count; i++)
+    {
+        err |= bin_num(buf, auth->entry[i].fa, 4);
+        err |= bin_num(buf, auth->entry[i].length, 4);
+        err |= bin_num(buf, auth->entry[i].revision, 2);
+        err |= bin_num(buf, auth->entry[i].type, 2);
+    }
+
+    err |= bin_num(buf, auth->pkcs7, 1);
+
+    if (auth->pkcs7)
+    {
+        err |= bin_num(buf, auth->alg, 1);
+        err |= bin_str(buf, (const char*)auth->signed_digest, auth->signed_len);
+        err |= bin_num(buf, auth->certs, 4);
+        err |= bin_num(buf, auth->signers, 4);
+    }
+
+    err |= bin_num(buf, auth->hashed, 1);
+
+    if (auth->hashed)
+    {
+        err |= bin_num(buf, auth->hash_alg, 1);
+        err |= bin_str(buf, (const char*)auth->digest, auth->digest_len);
+        err |= bin_num(buf, auth->match, 1);
+        err |= bin_num(buf, auth->bytes, 8);
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出二进制记录的延迟导入和绑定导入部分,格式见pe_emit.h
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int bin_import_more(PPE_BUF buf, PPE_IMAGE image)
+{
+    PPE_IMPORT_LIB lib = image->lib + image->lib_static;
+    int            err = 0;
+
+    err |= bin_num(buf, image->lib_delay, 4);
+
+    for (DWORD i = 0; i < image->lib_delay; i++, lib++)
+    {
+        err |= bin_num(buf, lib->attributes, 4);
+        err |= bin_import_lib(buf, image, lib->func, lib->func_count, lib);
+    }
+
+    err |= bin_num(buf, image->lib_bound, 4);
+
+    for (DWORD i = 0; i < image->lib_bound; i++, lib++)
+    {
+        err |= bin_num(buf, lib->type, 1);
+        err |= bin_name(buf, image, lib->name_fa, lib->name);
+        err |= bin_num(buf, lib->time, 4);
+        err |= bin_num(buf, lib->forwarder, 2);
+    }
+
+    return err;
+}
+
+/**
+ *\brief                        输出一条二进制记录,先占位记录长度,写完后回填
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    status          状态
+ *\param[in]    image           解析结果,可以为NULL
+ *\param[in]    size            文件长度
+ *\param[in]    path            文件路径
+ *\return                       0-成功,其它失败
+ */
+static int emit_bin(PPE_BUF buf, const char *status, PPE_IMAGE image, size_t size, const char *path)
+{
+    size_t start   = buf->len;
+    int    err     = 0;
+    int    version = PE_EMIT_VERSION;
+
+    if (NULL != image && (NULL != image->finger || NULL != image->version || NULL != image->debug ||
+                          NULL != image->auth || image->lib_count > image->lib_static)) // 只有摘要时保持原来的版本
+    {
+        version = PE_EMIT_VERSION_PARTS;
+    }
+    else if (NULL != image && NULL != image->digest)
+    {
+        version = PE_EMIT_VERSION_DIGEST;
+    }
+
+    err |= bin_num(buf, 0, 4);
+    err |= bin_num(buf, version, 2);
+    err |= bin_num(buf, NULL != image, 2);
+    err |= bin_num(buf, size, 8);
+    err |= bin_str(buf, status, strlen(status));
+    err |= bin_str(buf, path, strlen(path));
+
+    if (NULL != image)
+    {
+        err |= bin_image(buf, image);
+
+        if (PE_EMIT_VERSION_PARTS == version)
+        {
+            err |= bin_num(buf, ((NULL != image->digest)  ? PE_EMIT_PART_DIGEST  : 0) |
+                                ((NULL != image->finger)  ? PE_EMIT_PART_FINGER  : 0) |
+                                ((NULL != image->version) ? PE_EMIT_PART_VERSION : 0) |
+                                ((image->lib_count > image->lib_static) ? PE_EMIT_PART_IMPORT : 0) |
+                                ((NULL != image->debug)   ? PE_EMIT_PART_DEBUG   : 0) |
+                                ((NULL != image->auth)    ? PE_EMIT_PART_AUTH    : 0), 4);
+        }
+
+        if (NULL != image->digest)
+        {
+            err |= bin_digest(buf, image->digest);
+        }
+
+        if (NULL != image->finger)
+        {
+            err |= bin_finger(buf, image->finger);
+        }
+
+        if (NULL != image->version)
+        {
+            err |= bin_version(buf, image, image->version);
+        }
+
+        if (image->lib_count > image->lib_static)
+        {
+            err |= bin_import_more(buf, image);
+        }
+
+        if (NULL != image->debug)
+        {
+            err |= bin_debug(buf, image, image->debug);
+        }
+
+        if (NULL != image->auth)
+        {
+            err |= bin_auth(buf, image->auth);
+        }
+    }
+
+    if (0 == err)
+    {
+        bin_put(buf->data + start, buf->len - start - 4, 4);
+    }
+
+    return err;
+}
+
+int pe_emit(PPE_BUF buf, int format, const char *status, PPE_IMAGE image,
+            size_t size, const char *path)
+{
+    size_t start = buf->len;
+    int    ret   = (PE_EMIT_BIN == format) ? emit_bin(buf, status, image, size, path) :
+                                             emit_json(buf, status, image, size, path);
+
+    if (0 != ret)
+    {
+        buf->len = start;
+    }
+
+    return ret;
+}
+
+int pe_emit_key(PPE_BUF buf, const char *status, PPE_IMAGE image, size_t size, const char *path,
+                ULONGLONG loaded, DWORD reads)
+{
+    char   key[PE_DEBUG_KEY_MAX];
+    size_t start = buf->len;
+    int    err   = 0;
+
+    err |= EMIT_LIT(buf, "{\"path\":");
+    err |= json_str(buf, path, strlen(path), 1);
+    err |= JSON_NUM(buf, ",\"size\":", size);
+    err |= EMIT_LIT(buf, ",\"status\":");
+    err |= json_str(buf, status, strlen(status), 1);
+
+    if (NULL != image)
+    {
+        size_t len = pe_image_key(image, path, key, sizeof(key));
+
+        err |= JSON_NUM(buf, ",\"time\":", image->time);
+        err |= JSON_NUM(buf, ",\"image_size\":", image->image_size);
+        err |= EMIT_LIT(buf, ",\"image_key\":");
+        err |= json_str(buf, key, len, 1);
+
+        if (NULL != image->debug)
+        {
+            err |= json_codeview(buf, image, image->debug);
+        }
+
+        err |= JSON_NUM(buf, ",\"loaded\":", loaded);
+        err |= JSON_NUM(buf, ",\"reads\":", reads);
+    }
+
+    err |= EMIT_LIT(buf, "}\n");
+
+    if (0 != err)
+    {
+        buf->len = start;
+    }
+
+    return err;
+}
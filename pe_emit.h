@@ -0,0 +1,173 @@
+/**
+ *\file     pe_emit.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    PE解析结果的机器可读输出,每个文件一条记录,直接写入可重用的输出缓冲区
+ *          缓冲区只在容量不够时按倍数扩大,写每个字段都不分配内存
+ *          JSON Lines格式,每条记录一行:
+ *              {"path":"..","size":N,"status":"ok","error":null或{"part":"..","code":"..","fa":N},
+ *               "machine":N,"characteristics":N,"time":N,"magic":N,"subsystem":N,"entry":N,
+ *               "image_base":N,"section_align":N,"file_align":N,"image_size":N,
+ *               "dirs":[[rva,size],..],
+ *               "sections":[{"name":"..","va":N,"vsize":N,"raw":N,"rsize":N,"flags":N},..],
+ *               "imports":[{"dll":"..","funcs":[{"name":"..","hint":N}或{"ordinal":N},..]},..],
+ *               "exports":{"dll":"..","base":N,"rvas":[N,..],"names":[{"name":"..","index":N},..]},
+ *               "relocs":[{"page":N,"entries":[type<<12|offset,..]},..]}
+ *              没有解析结果时(不是PE文件等)只有path,size,status.
+ *              imports中导入表的库后面是延迟导入的库{"dll":"..","type":"delay","attrs":N,"funcs":[..]}
+ *              和绑定导入{"dll":"..","type":"bound","time":N,"refs":N},转发引用{"dll":"..","type":"bound_ref","time":N}
+ *              计算了摘要时节中增加计算了的"entropy":F,"sha256":"..","xxh64":"..",
+ *              检测附加数据时增加"overlay":null或{"fa":N,"size":N,"cert":0或1,同上的摘要项}
+ *              计算了指纹时记录结尾增加计算了的"imphash":null或"..",
+ *              "rich":null或{"fa":N,"key":N,"valid":0或1,"hash":"..","entries":[[prod,build,count],..]}
+ *              计算了版本信息时记录结尾增加计算了的
+ *              "version":null或{"fa":N,"size":N,"lang":N,"file":null或"a.b.c.d","product":null或"a.b.c.d",
+ *               "flags":N,"os":N,"type":N,"table":"..","strings":{"名称":"值",..}},
+ *              "manifest":null或{"fa":N,"size":N,"id":N,"text":".."},清单最多PE_VERSION_MANIFEST_MAX字节
+ *              检查了签名时记录结尾增加"auth":{"status":"..","fa":N,"size":N,"entries":[[fa,length,revision,type],..],
+ *               "alg":"..","signed":null或"..","certs":N,"signers":N,"digest":null或"..","bytes":N}
+ *              文件中的字符串按字节输出,引号,反斜杠,控制字符和0x80以上的字节转义为\\u00XX;
+ *              版本信息中的字符串已经从UTF-16转成UTF-8,只转义引号,反斜杠和控制字符
+ *          二进制格式,所有数值为小端,字符串为WORD长度+字节,没有结尾的0:
+ *              DWORD   记录长度,不包括本字段
+ *              WORD    格式版本PE_EMIT_VERSION
+ *              WORD    有无解析结果,0-只有下面3项
+ *              ULONGLONG 文件长度, 字符串 状态, 字符串 路径
+ *              int     错误码, DWORD 出错位置, 字符串 出错部分
+ *              WORD    machine, characteristics, magic, subsystem
+ *              DWORD   time, entry
+ *              ULONGLONG image_base
+ *              DWORD   section_align, file_align, image_size, dir_count
+ *              16 * (DWORD rva, DWORD size) 数据目录
+ *              DWORD   节数, 每个节: 8字节节名, DWORD va, vsize, raw, rsize, flags
+ *              DWORD   导入库数, 每个库: 字符串 库名, DWORD 函数数,
+ *                      每个函数: BYTE 1-按序号, WORD 序号或提示序号, 按名称时再跟 字符串 函数名
+ *              字符串  导出文件名, DWORD base, DWORD 函数数, DWORD * 函数数 函数地址,
+ *                      DWORD 名称数, 每个名称: WORD 函数序号-base, 字符串 名称
+ *              DWORD   重定位块数, 每个块: DWORD 页地址, DWORD 项数, WORD * 项数 重定位项
+ *              计算了摘要时格式版本为PE_EMIT_VERSION_DIGEST,记录结尾再跟:
+ *              DWORD   摘要项PE_DIGEST_*, 每个节: DWORD 熵*1000000, 32字节 SHA-256, ULONGLONG XXH64
+ *              BYTE    有无附加数据, 有时: DWORD 位置, ULONGLONG 长度, BYTE 包括证书表, 同上的熵和散列
+ *              没有计算的项为0
+ *              计算了指纹时格式版本为PE_EMIT_VERSION_PARTS,记录结尾先是DWORD 附加部分PE_EMIT_PART_*,
+ *              再按位从低到高跟各部分,摘要部分同上;指纹部分:
+ *              DWORD   指纹项PE_FINGER_*
+ *              BYTE    有无导入表散列, 有时: 16字节 MD5, DWORD 参与计算的函数数
+ *              BYTE    有无Rich头, 有时: DWORD 位置, DWORD 密钥, BYTE 校验和正确, 16字节 MD5,
+ *                      DWORD 项数, 每项: WORD 产品ID, WORD 版本号, DWORD 数量
+ *              计算了版本信息时也是PE_EMIT_VERSION_PARTS;版本信息部分:
+ *              DWORD   版本信息项PE_VERSION_*
+ *              BYTE    有无VS_VERSIONINFO, 有时: DWORD 位置, DWORD 长度, DWORD 语言, BYTE 有无VS_FIXEDFILEINFO,
+ *                      有时: DWORD 文件版本高,低32位, 产品版本高,低32位, 标志, 系统, 类型;
+ *                      字符串 StringTable名称, DWORD 字符串数, 每个: 字符串 名称, 字符串 值(UTF-8)
+ *              BYTE    有无清单, 有时: DWORD 位置, DWORD 长度, DWORD 资源ID, 字符串 清单
+ *              有延迟导入或绑定导入时也是PE_EMIT_VERSION_PARTS,上面的导入库只有导入表中的库;延迟导入和绑定导入部分:
+ *              DWORD   延迟导入库数, 每个库: DWORD 属性, 同上的库名,函数数和函数(取输入名称表)
+ *              DWORD   绑定导入项数, 每项: BYTE 类型PE_IMPORT_BOUND或PE_IMPORT_BOUND_REF, 字符串 库名,
+ *                      DWORD 时间, WORD 转发引用数(转发引用为0)
+ *              解码了调试目录时也是PE_EMIT_VERSION_PARTS;调试目录部分:
+ *              DWORD   解码的记录PE_DEBUG_*, DWORD 目录项数,
+ *                      每项: DWORD 类型, 时间, WORD 主版本号, 次版本号, DWORD 数据大小, 相对虚拟地址, 文件位置
+ *              BYTE    有无CodeView, 有时: DWORD 格式(RSDS/NB10标记), 16字节 GUID, DWORD 签名, DWORD age,
+ *                      字符串 PDB路径, 字符串 符号键
+ *              BYTE    有无POGO, 有时: DWORD 标记, DWORD 项数
+ *              BYTE    有无repro, 有时: 字符串 散列(原始字节)
+ *              BYTE    有无嵌入的PDB, 有时: DWORD 位置, DWORD 解压后长度, DWORD 压缩数据长度
+ *              检查了签名时也是PE_EMIT_VERSION_PARTS;签名部分:
+ *              DWORD   签名项PE_AUTH_*, DWORD 证书表位置, DWORD 证书表长度, DWORD WIN_CERTIFICATE数,
+ *                      每项: DWORD 位置, DWORD 长度, WORD 版本, WORD 类型
+ *              BYTE    有无PKCS#7摘要, 有时: BYTE 算法PE_AUTH_ALG_*, 字符串 摘要(原始字节), DWORD 证书数, DWORD 签名者数
+ *              BYTE    有无计算的摘要, 有时: BYTE 算法, 字符串 摘要(原始字节), BYTE 1-相同, ULONGLONG 散列的字节数
+ *          只取符号键时每个文件一条记录,JSON Lines:
+ *              {"path":"..","size":N,"status":"..","time":N,"image_size":N,"image_key":"..",
+ *               "codeview":同上,"loaded":N,"reads":N},不是PE文件时只有path,size,status
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加节的熵和摘要,附加数据
+ *          2026.10.18|增加导入表散列和Rich头,二进制记录结尾的附加部分用掩码标出
+ *          2026.10.18|增加版本信息和清单
+ *          2026.10.18|增加延迟导入和绑定导入
+ *          2026.10.18|增加调试目录和只有符号键的记录
+ *          2026.10.18|增加Authenticode签名
+ */
+#ifndef _PE_EMIT_H_
+#define _PE_EMIT_H_
+
+#include "pe.h"
+
+#define PE_EMIT_JSON            0                                           ///< JSON Lines
+#define PE_EMIT_BIN             1                                           ///< 长度前缀的二进制记录
+
+#define PE_EMIT_VERSION         1                                           ///< 二进制记录格式版本
+#define PE_EMIT_VERSION_DIGEST  2                                           ///< 记录结尾有摘要时的格式版本
+#define PE_EMIT_VERSION_PARTS   3                                           ///< 记录结尾有附加部分掩码时的格式版本
+
+#define PE_EMIT_PART_DIGEST     0x01                                        ///< 附加部分:摘要
+#define PE_EMIT_PART_FINGER     0x02                                        ///< 附加部分:指纹
+#define PE_EMIT_PART_VERSION    0x04                                        ///< 附加部分:版本信息和清单
+#define PE_EMIT_PART_IMPORT     0x08                                        ///< 附加部分:延迟导入和绑定导入
+#define PE_EMIT_PART_DEBUG      0x10                                        ///< 附加部分:调试目录
+#define PE_EMIT_PART_AUTH       0x20                                        ///< 附加部分:签名
+
+#define PE_EMIT_NAME_MAX        4096                                        ///< 文件中字符串的最大输出长度
+
+typedef struct _PE_BUF                                                      ///  可重用的输出缓冲区
+{
+    char       *data;                                                       ///< 数据
+    size_t      len;                                                        ///< 数据长度
+    size_t      cap;                                                        ///< 缓冲区长度
+
+} PE_BUF, *PPE_BUF;
+
+/**
+ *\brief                        确保缓冲区还能写入need字节,不够时按倍数扩大
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    need            需要的字节数
+ *\return                       0-成功,其它失败
+ */
+int pe_buf_reserve(PPE_BUF buf, size_t need);
+
+/**
+ *\brief                        释放输出缓冲区
+ *\param[in]    buf             输出缓冲区
+ *\return                       无
+ */
+void pe_buf_free(PPE_BUF buf);
+
+/**
+ *\brief                        输出一个文件的记录,追加到缓冲区尾部
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    format          PE_EMIT_JSON或PE_EMIT_BIN
+ *\param[in]    status          状态,与scan的文本记录相同
+ *\param[in]    image           解析结果,可以为NULL
+ *\param[in]    size            文件长度
+ *\param[in]    path            文件路径
+ *\return                       0-成功,其它失败(内存不足),失败时缓冲区恢复到调用前的长度
+ */
+int pe_emit(PPE_BUF buf, int format, const char *status, PPE_IMAGE image,
+            size_t size, const char *path);
+
+/**
+ *\brief                        输出只取符号键时一个文件的JSON记录,追加到缓冲区尾部
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    status          状态
+ *\param[in]    image           只解析了头部并解码了调试目录的解析结果,可以为NULL
+ *\param[in]    size            文件长度
+ *\param[in]    path            文件路径
+ *\param[in]    loaded          读入的字节数
+ *\param[in]    reads           读的次数
+ *\return                       0-成功,其它失败(内存不足),失败时缓冲区恢复到调用前的长度
+ */
+int pe_emit_key(PPE_BUF buf, const char *status, PPE_IMAGE image, size_t size, const char *path,
+                ULONGLONG loaded, DWORD reads);
+
+/**
+ *\brief                        通过名称得到输出格式
+ *\param[in]    name            json或bin
+ *\return                       PE_EMIT_JSON,PE_EMIT_BIN,-1为不支持
+ */
+int pe_emit_format(const char *name);
+
+#endif
@@ -0,0 +1,571 @@
+/**
+ *\file     pe_finger.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    导入表散列和Rich头解码实现
+ *          名称分段转小写后直接输入MD5,一个文件的计算只用栈上的小缓冲区,不分配内存
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|导入表散列只取导入表中的库,不包括延迟导入和绑定导入
+ *          2026.10.18|按序号导入的函数名使用pefile的完整ws2_32表,增加oleaut32表
+ */
+#include "pe_finger.h"
+
+/// 解析结构使用的内存池
+#define ARENA(image)            ((NULL != (image)->pool) ? (image)->pool : &(image)->arena)
+
+#define FINGER_CHUNK            256                                         ///< 转小写和解码时一次处理的字节数
+#define FINGER_RICH_START       0x40                                        ///< Rich头在DOS头之后
+#define FINGER_RICH_SEARCH      0x10000                                     ///< 最多在DOS头之后这么长的范围内找"Rich"
+
+#define FINGER_ROTL(x, r)       (((x) << ((r) & 31)) | ((x) >> ((32 - ((r) & 31)) & 31)))
+
+typedef struct _FINGER_ORD                                                  ///  按序号导入的函数名
+{
+    WORD            ordinal;                                                ///< 序号
+    const char     *name;                                                   ///< 函数名
+
+} FINGER_ORD, *PFINGER_ORD;
+
+static const FINGER_ORD g_ws2_32[] = {                                      ///< ws2_32和wsock32的序号,与pefile的ordlookup相同,按序号排列
+    {   1, "accept"                           }, {   2, "bind"                             }, {   3, "closesocket"                      },
+    {   4, "connect"                          }, {   5, "getpeername"                      }, {   6, "getsockname"                      },
+    {   7, "getsockopt"                       }, {   8, "htonl"                            }, {   9, "htons"                            },
+    {  10, "ioctlsocket"                      }, {  11, "inet_addr"                        }, {  12, "inet_ntoa"                        },
+    {  13, "listen"                           }, {  14, "ntohl"                            }, {  15, "ntohs"                            },
+    {  16, "recv"                             }, {  17, "recvfrom"                         }, {  18, "select"                           },
+    {  19, "send"                             }, {  20, "sendto"                           }, {  21, "setsockopt"                       },
+    {  22, "shutdown"                         }, {  23, "socket"                           }, {  24, "GetAddrInfoW"                     },
+    {  25, "GetNameInfoW"                     }, {  26, "WSApSetPostRoutine"               }, {  27, "FreeAddrInfoW"                    },
+    {  28, "WPUCompleteOverlappedRequest"     }, {  29, "WSAAccept"                        }, {  30, "WSAAddressToStringA"              },
+    {  31, "WSAAddressToStringW"              }, {  32, "WSACloseEvent"                    }, {  33, "WSAConnect"                       },
+    {  34, "WSACreateEvent"                   }, {  35, "WSADuplicateSocketA"              }, {  36, "WSADuplicateSocketW"              },
+    {  37, "WSAEnumNameSpaceProvidersA"       }, {  38, "WSAEnumNameSpaceProvidersW"       }, {  39, "WSAEnumNetworkEvents"             },
+    {  40, "WSAEnumProtocolsA"                }, {  41, "WSAEnumProtocolsW"                }, {  42, "WSAEventSelect"                   },
+    {  43, "WSAGetOverlappedResult"           }, {  44, "WSAGetQOSByName"                  }, {  45, "WSAGetServiceClassInfoA"          },
+    {  46, "WSAGetServiceClassInfoW"          }, {  47, "WSAGetServiceClassNameByClassIdA" }, {  48, "WSAGetServiceClassNameByClassIdW" },
+    {  49, "WSAHtonl"                         }, {  50, "WSAHtons"                         }, {  51, "gethostbyaddr"                    },
+    {  52, "gethostbyname"                    }, {  53, "getprotobyname"                   }, {  54, "getprotobynumber"                 },
+    {  55, "getservbyname"                    }, {  56, "getservbyport"                    }, {  57, "gethostname"                      },
+    {  58, "WSAInstallServiceClassA"          }, {  59, "WSAInstallServiceClassW"          }, {  60, "WSAIoctl"                         },
+    {  61, "WSAJoinLeaf"                      }, {  62, "WSALookupServiceBeginA"           }, {  63, "WSALookupServiceBeginW"           },
+    {  64, "WSALookupServiceEnd"              }, {  65, "WSALookupServiceNextA"            }, {  66, "WSALookupServiceNextW"            },
+    {  67, "WSANSPIoctl"                      }, {  68, "WSANtohl"                         }, {  69, "WSANtohs"                         },
+    {  70, "WSAProviderConfigChange"          }, {  71, "WSARecv"                          }, {  72, "WSARecvDisconnect"                },
+    {  73, "WSARecvFrom"                      }, {  74, "WSARemoveServiceClass"            }, {  75, "WSAResetEvent"                    },
+    {  76, "WSASend"                          }, {  77, "WSASendDisconnect"                }, {  78, "WSASendTo"                        },
+    {  79, "WSASetEvent"                      }, {  80, "WSASetServiceA"                   }, {  81, "WSASetServiceW"                   },
+    {  82, "WSASocketA"                       }, {  83, "WSASocketW"                       }, {  84, "WSAStringToAddressA"              },
+    {  85, "WSAStringToAddressW"              }, {  86, "WSAWaitForMultipleEvents"         }, {  87, "WSCDeinstallProvider"             },
+    {  88, "WSCEnableNSProvider"              }, {  89, "WSCEnumProtocols"                 }, {  90, "WSCGetProviderPath"               },
+    {  91, "WSCInstallNameSpace"              }, {  92, "WSCInstallProvider"               }, {  93, "WSCUnInstallNameSpace"            },
+    {  94, "WSCUpdateProvider"                }, {  95, "WSCWriteNameSpaceOrder"           }, {  96, "WSCWriteProviderOrder"            },
+    {  97, "freeaddrinfo"                     }, {  98, "getaddrinfo"                      }, {  99, "getnameinfo"                      },
+    { 101, "WSAAsyncSelect"                   }, { 102, "WSAAsyncGetHostByAddr"            }, { 103, "WSAAsyncGetHostByName"            },
+    { 104, "WSAAsyncGetProtoByNumber"         }, { 105, "WSAAsyncGetProtoByName"           }, { 106, "WSAAsyncGetServByPort"            },
+    { 107, "WSAAsyncGetServByName"            }, { 108, "WSACancelAsyncRequest"            }, { 109, "WSASetBlockingHook"               },
+    { 110, "WSAUnhookBlockingHook"            }, { 111, "WSAGetLastError"                  }, { 112, "WSASetLastError"                  },
+    { 113, "WSACancelBlockingCall"            }, { 114, "WSAIsBlocking"                    }, { 115, "WSAStartup"                       },
+    { 116, "WSACleanup"                       }, { 151, "__WSAFDIsSet"                     }, { 500, "WEP"                              },
+};
+
+static const FINGER_ORD g_oleaut32[] = {                                    ///< oleaut32的序号,与pefile的ordlookup相同,按序号排列
+    {   1, "DllGetClassObject"              }, {   2, "SysAllocString"                 }, {   3, "SysReAllocString"               },
+    {   4, "SysAllocStringLen"              }, {   5, "SysReAllocStringLen"            }, {   6, "SysFreeString"                  },
+    {   7, "SysStringLen"                   }, {   8, "VariantInit"                    }, {   9, "VariantClear"                   },
+    {  10, "VariantCopy"                    }, {  11, "VariantCopyInd"                 }, {  12, "VariantChangeType"              },
+    {  13, "VariantTimeToDosDateTime"       }, {  14, "DosDateTimeToVariantTime"       }, {  15, "SafeArrayCreate"                },
+    {  16, "SafeArrayDestroy"               }, {  17, "SafeArrayGetDim"                }, {  18, "SafeArrayGetElemsize"           },
+    {  19, "SafeArrayGetUBound"             }, {  20, "SafeArrayGetLBound"             }, {  21, "SafeArrayLock"                  },
+    {  22, "SafeArrayUnlock"                }, {  23, "SafeArrayAccessData"            }, {  24, "SafeArrayUnaccessData"          },
+    {  25, "SafeArrayGetElement"            }, {  26, "SafeArrayPutElement"            }, {  27, "SafeArrayCopy"                  },
+    {  28, "DispGetParam"                   }, {  29, "DispGetIDsOfNames"              }, {  30, "DispInvoke"                     },
+    {  31, "CreateDispTypeInfo"             }, {  32, "CreateStdDispatch"              }, {  33, "RegisterActiveObject"           },
+    {  34, "RevokeActiveObject"             }, {  35, "GetActiveObject"                }, {  36, "SafeArrayAllocDescriptor"       },
+    {  37, "SafeArrayAllocData"             }, {  38, "SafeArrayDestroyDescriptor"     }, {  39, "SafeArrayDestroyData"           },
+    {  40, "SafeArrayRedim"                 }, {  41, "SafeArrayAllocDescriptorEx"     }, {  42, "SafeArrayCreateEx"              },
+    {  43, "SafeArrayCreateVectorEx"        }, {  44, "SafeArraySetRecordInfo"         }, {  45, "SafeArrayGetRecordInfo"         },
+    {  46, "VarParseNumFromStr"             }, {  47, "VarNumFromParseNum"             }, {  48, "VarI2FromUI1"                   },
+    {  49, "VarI2FromI4"                    }, {  50, "VarI2FromR4"                    }, {  51, "VarI2FromR8"                    },
+    {  52, "VarI2FromCy"                    }, {  53, "VarI2FromDate"                  }, {  54, "VarI2FromStr"                   },
+    {  55, "VarI2FromDisp"                  }, {  56, "VarI2FromBool"                  }, {  57, "SafeArraySetIID"                },
+    {  58, "VarI4FromUI1"                   }, {  59, "VarI4FromI2"                    }, {  60, "VarI4FromR4"                    },
+    {  61, "VarI4FromR8"                    }, {  62, "VarI4FromCy"                    }, {  63, "VarI4FromDate"                  },
+    {  64, "VarI4FromStr"                   }, {  65, "VarI4FromDisp"                  }, {  66, "VarI4FromBool"                  },
+    {  67, "SafeArrayGetIID"                }, {  68, "VarR4FromUI1"                   }, {  69, "VarR4FromI2"                    },
+    {  70, "VarR4FromI4"                    }, {  71, "VarR4FromR8"                    }, {  72, "VarR4FromCy"                    },
+    {  73, "VarR4FromDate"                  }, {  74, "VarR4FromStr"                   }, {  75, "VarR4FromDisp"                  },
+    {  76, "VarR4FromBool"                  }, {  77, "SafeArrayGetVartype"            }, {  78, "VarR8FromUI1"                   },
+    {  79, "VarR8FromI2"                    }, {  80, "VarR8FromI4"                    }, {  81, "VarR8FromR4"                    },
+    {  82, "VarR8FromCy"                    }, {  83, "VarR8FromDate"                  }, {  84, "VarR8FromStr"                   },
+    {  85, "VarR8FromDisp"                  }, {  86, "VarR8FromBool"                  }, {  87, "VarFormat"                      },
+    {  88, "VarDateFromUI1"                 }, {  89, "VarDateFromI2"                  }, {  90, "VarDateFromI4"                  },
+    {  91, "VarDateFromR4"                  }, {  92, "VarDateFromR8"                  }, {  93, "VarDateFromCy"                  },
+    {  94, "VarDateFromStr"                 }, {  95, "VarDateFromDisp"                }, {  96, "VarDateFromBool"                },
+    {  97, "VarFormatDateTime"              }, {  98, "VarCyFromUI1"                   }, {  99, "VarCyFromI2"                    },
+    { 100, "VarCyFromI4"                    }, { 101, "VarCyFromR4"                    }, { 102, "VarCyFromR8"                    },
+    { 103, "VarCyFromDate"                  }, { 104, "VarCyFromStr"                   }, { 105, "VarCyFromDisp"                  },
+    { 106, "VarCyFromBool"                  }, { 107, "VarFormatNumber"                }, { 108, "VarBstrFromUI1"                 },
+    { 109, "VarBstrFromI2"                  }, { 110, "VarBstrFromI4"                  }, { 111, "VarBstrFromR4"                  },
+    { 112, "VarBstrFromR8"                  }, { 113, "VarBstrFromCy"                  }, { 114, "VarBstrFromDate"                },
+    { 115, "VarBstrFromDisp"                }, { 116, "VarBstrFromBool"                }, { 117, "VarFormatPercent"               },
+    { 118, "VarBoolFromUI1"                 }, { 119, "VarBoolFromI2"                  }, { 120, "VarBoolFromI4"                  },
+    { 121, "VarBoolFromR4"                  }, { 122, "VarBoolFromR8"                  }, { 123, "VarBoolFromDate"                },
+    { 124, "VarBoolFromCy"                  }, { 125, "VarBoolFromStr"                 }, { 126, "VarBoolFromDisp"                },
+    { 127, "VarFormatCurrency"              }, { 128, "VarWeekdayName"                 }, { 129, "VarMonthName"                   },
+    { 130, "VarUI1FromI2"                   }, { 131, "VarUI1FromI4"                   }, { 132, "VarUI1FromR4"                   },
+    { 133, "VarUI1FromR8"                   }, { 134, "VarUI1FromCy"                   }, { 135, "VarUI1FromDate"                 },
+    { 136, "VarUI1FromStr"                  }, { 137, "VarUI1FromDisp"                 }, { 138, "VarUI1FromBool"                 },
+    { 139, "VarFormatFromTokens"            }, { 140, "VarTokenizeFormatString"        }, { 141, "VarAdd"                         },
+    { 142, "VarAnd"                         }, { 143, "VarDiv"                         }, { 146, "DispCallFunc"                   },
+    { 147, "VariantChangeTypeEx"            }, { 148, "SafeArrayPtrOfIndex"            }, { 149, "SysStringByteLen"               },
+    { 150, "SysAllocStringByteLen"          }, { 152, "VarEqv"                         }, { 153, "VarIdiv"                        },
+    { 154, "VarImp"                         }, { 155, "VarMod"                         }, { 156, "VarMul"                         },
+    { 157, "VarOr"                          }, { 158, "VarPow"                         }, { 159, "VarSub"                         },
+    { 160, "CreateTypeLib"                  }, { 161, "LoadTypeLib"                    }, { 162, "LoadRegTypeLib"                 },
+    { 163, "RegisterTypeLib"                }, { 164, "QueryPathOfRegTypeLib"          }, { 165, "LHashValOfNameSys"              },
+    { 166, "LHashValOfNameSysA"             }, { 167, "VarXor"                         }, { 168, "VarAbs"                         },
+    { 169, "VarFix"                         }, { 170, "OaBuildVersion"                 }, { 171, "ClearCustData"                  },
+    { 172, "VarInt"                         }, { 173, "VarNeg"                         }, { 174, "VarNot"                         },
+    { 175, "VarRound"                       }, { 176, "VarCmp"                         }, { 177, "VarDecAdd"                      },
+    { 178, "VarDecDiv"                      }, { 179, "VarDecMul"                      }, { 180, "CreateTypeLib2"                 },
+    { 181, "VarDecSub"                      }, { 182, "VarDecAbs"                      }, { 183, "LoadTypeLibEx"                  },
+    { 184, "SystemTimeToVariantTime"        }, { 185, "VariantTimeToSystemTime"        }, { 186, "UnRegisterTypeLib"              },
+    { 187, "VarDecFix"                      }, { 188, "VarDecInt"                      }, { 189, "VarDecNeg"                      },
+    { 190, "VarDecFromUI1"                  }, { 191, "VarDecFromI2"                   }, { 192, "VarDecFromI4"                   },
+    { 193, "VarDecFromR4"                   }, { 194, "VarDecFromR8"                   }, { 195, "VarDecFromDate"                 },
+    { 196, "VarDecFromCy"                   }, { 197, "VarDecFromStr"                  }, { 198, "VarDecFromDisp"                 },
+    { 199, "VarDecFromBool"                 }, { 200, "GetErrorInfo"                   }, { 201, "SetErrorInfo"                   },
+    { 202, "CreateErrorInfo"                }, { 203, "VarDecRound"                    }, { 204, "VarDecCmp"                      },
+    { 205, "VarI2FromI1"                    }, { 206, "VarI2FromUI2"                   }, { 207, "VarI2FromUI4"                   },
+    { 208, "VarI2FromDec"                   }, { 209, "VarI4FromI1"                    }, { 210, "VarI4FromUI2"                   },
+    { 211, "VarI4FromUI4"                   }, { 212, "VarI4FromDec"                   }, { 213, "VarR4FromI1"                    },
+    { 214, "VarR4FromUI2"                   }, { 215, "VarR4FromUI4"                   }, { 216, "VarR4FromDec"                   },
+    { 217, "VarR8FromI1"                    }, { 218, "VarR8FromUI2"                   }, { 219, "VarR8FromUI4"                   },
+    { 220, "VarR8FromDec"                   }, { 221, "VarDateFromI1"                  }, { 222, "VarDateFromUI2"                 },
+    { 223, "VarDateFromUI4"                 }, { 224, "VarDateFromDec"                 }, { 225, "VarCyFromI1"                    },
+    { 226, "VarCyFromUI2"                   }, { 227, "VarCyFromUI4"                   }, { 228, "VarCyFromDec"                   },
+    { 229, "VarBstrFromI1"                  }, { 230, "VarBstrFromUI2"                 }, { 231, "VarBstrFromUI4"                 },
+    { 232, "VarBstrFromDec"                 }, { 233, "VarBoolFromI1"                  }, { 234, "VarBoolFromUI2"                 },
+    { 235, "VarBoolFromUI4"                 }, { 236, "VarBoolFromDec"                 }, { 237, "VarUI1FromI1"                   },
+    { 238, "VarUI1FromUI2"                  }, { 239, "VarUI1FromUI4"                  }, { 240, "VarUI1FromDec"                  },
+    { 241, "VarDecFromI1"                   }, { 242, "VarDecFromUI2"                  }, { 243, "VarDecFromUI4"                  },
+    { 244, "VarI1FromUI1"                   }, { 245, "VarI1FromI2"                    }, { 246, "VarI1FromI4"                    },
+    { 247, "VarI1FromR4"                    }, { 248, "VarI1FromR8"                    }, { 249, "VarI1FromDate"                  },
+    { 250, "VarI1FromCy"                    }, { 251, "VarI1FromStr"                   }, { 252, "VarI1FromDisp"                  },
+    { 253, "VarI1FromBool"                  }, { 254, "VarI1FromUI2"                   }, { 255, "VarI1FromUI4"                   },
+    { 256, "VarI1FromDec"                   }, { 257, "VarUI2FromUI1"                  }, { 258, "VarUI2FromI2"                   },
+    { 259, "VarUI2FromI4"                   }, { 260, "VarUI2FromR4"                   }, { 261, "VarUI2FromR8"                   },
+    { 262, "VarUI2FromDate"                 }, { 263, "VarUI2FromCy"                   }, { 264, "VarUI2FromStr"                  },
+    { 265, "VarUI2FromDisp"                 }, { 266, "VarUI2FromBool"                 }, { 267, "VarUI2FromI1"                   },
+    { 268, "VarUI2FromUI4"                  }, { 269, "VarUI2FromDec"                  }, { 270, "VarUI4FromUI1"                  },
+    { 271, "VarUI4FromI2"                   }, { 272, "VarUI4FromI4"                   }, { 273, "VarUI4FromR4"                   },
+    { 274, "VarUI4FromR8"                   }, { 275, "VarUI4FromDate"                 }, { 276, "VarUI4FromCy"                   },
+    { 277, "VarUI4FromStr"                  }, { 278, "VarUI4FromDisp"                 }, { 279, "VarUI4FromBool"                 },
+    { 280, "VarUI4FromI1"                   }, { 281, "VarUI4FromUI2"                  }, { 282, "VarUI4FromDec"                  },
+    { 283, "BSTR_UserSize"                  }, { 284, "BSTR_UserMarshal"               }, { 285, "BSTR_UserUnmarshal"             },
+    { 286, "BSTR_UserFree"                  }, { 287, "VARIANT_UserSize"               }, { 288, "VARIANT_UserMarshal"            },
+    { 289, "VARIANT_UserUnmarshal"          }, { 290, "VARIANT_UserFree"               }, { 291, "LPSAFEARRAY_UserSize"           },
+    { 292, "LPSAFEARRAY_UserMarshal"        }, { 293, "LPSAFEARRAY_UserUnmarshal"      }, { 294, "LPSAFEARRAY_UserFree"           },
+    { 295, "LPSAFEARRAY_Size"               }, { 296, "LPSAFEARRAY_Marshal"            }, { 297, "LPSAFEARRAY_Unmarshal"          },
+    { 298, "VarDecCmpR8"                    }, { 299, "VarCyAdd"                       }, { 303, "VarCyMul"                       },
+    { 304, "VarCyMulI4"                     }, { 305, "VarCySub"                       }, { 306, "VarCyAbs"                       },
+    { 307, "VarCyFix"                       }, { 308, "VarCyInt"                       }, { 309, "VarCyNeg"                       },
+    { 310, "VarCyRound"                     }, { 311, "VarCyCmp"                       }, { 312, "VarCyCmpR8"                     },
+    { 313, "VarBstrCat"                     }, { 314, "VarBstrCmp"                     }, { 315, "VarR8Pow"                       },
+    { 316, "VarR4CmpR8"                     }, { 317, "VarR8Round"                     }, { 318, "VarCat"                         },
+    { 319, "VarDateFromUdateEx"             }, { 320, "DllRegisterServer"              }, { 321, "DllUnregisterServer"            },
+    { 322, "GetRecordInfoFromGuids"         }, { 323, "GetRecordInfoFromTypeInfo"      }, { 325, "SetVarConversionLocaleSetting"  },
+    { 326, "GetVarConversionLocaleSetting"  }, { 327, "SetOaNoCache"                   }, { 329, "VarCyMulI8"                     },
+    { 330, "VarDateFromUdate"               }, { 331, "VarUdateFromDate"               }, { 332, "GetAltMonthNames"               },
+    { 333, "VarI8FromUI1"                   }, { 334, "VarI8FromI2"                    }, { 335, "VarI8FromR4"                    },
+    { 336, "VarI8FromR8"                    }, { 337, "VarI8FromCy"                    }, { 338, "VarI8FromDate"                  },
+    { 339, "VarI8FromStr"                   }, { 340, "VarI8FromDisp"                  }, { 341, "VarI8FromBool"                  },
+    { 342, "VarI8FromI1"                    }, { 343, "VarI8FromUI2"                   }, { 344, "VarI8FromUI4"                   },
+    { 345, "VarI8FromDec"                   }, { 346, "VarI2FromI8"                    }, { 347, "VarI2FromUI8"                   },
+    { 348, "VarI4FromI8"                    }, { 349, "VarI4FromUI8"                   }, { 360, "VarR4FromI8"                    },
+    { 361, "VarR4FromUI8"                   }, { 362, "VarR8FromI8"                    }, { 363, "VarR8FromUI8"                   },
+    { 364, "VarDateFromI8"                  }, { 365, "VarDateFromUI8"                 }, { 366, "VarCyFromI8"                    },
+    { 367, "VarCyFromUI8"                   }, { 368, "VarBstrFromI8"                  }, { 369, "VarBstrFromUI8"                 },
+    { 370, "VarBoolFromI8"                  }, { 371, "VarBoolFromUI8"                 }, { 372, "VarUI1FromI8"                   },
+    { 373, "VarUI1FromUI8"                  }, { 374, "VarDecFromI8"                   }, { 375, "VarDecFromUI8"                  },
+    { 376, "VarI1FromI8"                    }, { 377, "VarI1FromUI8"                   }, { 378, "VarUI2FromI8"                   },
+    { 379, "VarUI2FromUI8"                  }, { 401, "OleLoadPictureEx"               }, { 402, "OleLoadPictureFileEx"           },
+    { 410, "DllCanUnloadNow"                }, { 411, "SafeArrayCreateVector"          }, { 412, "SafeArrayCopyData"              },
+    { 413, "VectorFromBstr"                 }, { 414, "BstrFromVector"                 }, { 415, "OleIconToCursor"                },
+    { 416, "OleCreatePropertyFrameIndirect" }, { 417, "OleCreatePropertyFrame"         }, { 418, "OleLoadPicture"                 },
+    { 419, "OleCreatePictureIndirect"       }, { 420, "OleCreateFontIndirect"          }, { 421, "OleTranslateColor"              },
+    { 422, "OleLoadPictureFile"             }, { 423, "OleSavePictureFile"             }, { 424, "OleLoadPicturePath"             },
+    { 425, "VarUI4FromI8"                   }, { 426, "VarUI4FromUI8"                  }, { 427, "VarI8FromUI8"                   },
+    { 428, "VarUI8FromI8"                   }, { 429, "VarUI8FromUI1"                  }, { 430, "VarUI8FromI2"                   },
+    { 431, "VarUI8FromR4"                   }, { 432, "VarUI8FromR8"                   }, { 433, "VarUI8FromCy"                   },
+    { 434, "VarUI8FromDate"                 }, { 435, "VarUI8FromStr"                  }, { 436, "VarUI8FromDisp"                 },
+    { 437, "VarUI8FromBool"                 }, { 438, "VarUI8FromI1"                   }, { 439, "VarUI8FromUI2"                  },
+    { 440, "VarUI8FromUI4"                  }, { 441, "VarUI8FromDec"                  }, { 442, "RegisterTypeLibForUser"         },
+    { 443, "UnRegisterTypeLibForUser"       },
+};
+
+typedef struct _FINGER_ORD_LIB                                              ///  有序号表的库
+{
+    const char         *name;                                               ///< 小写库名
+    const FINGER_ORD   *list;                                               ///< 序号表
+    size_t              count;                                              ///< 序号表项数
+
+} FINGER_ORD_LIB, *PFINGER_ORD_LIB;
+
+static const FINGER_ORD_LIB g_ord_lib[] = {                                 ///< 与pefile的ordlookup相同的库
+    { "ws2_32.dll",   g_ws2_32,   SIZEOF(g_ws2_32)   },
+    { "wsock32.dll",  g_ws2_32,   SIZEOF(g_ws2_32)   },
+    { "oleaut32.dll", g_oleaut32, SIZEOF(g_oleaut32) },
+};
+
+/**
+ *\brief                        不区分大小写比较,b为小写
+ *\param[in]    a               字符串
+ *\param[in]    len             a的长度
+ *\param[in]    b               小写字符串,以0结尾
+ *\return                       1-相同,0-不同
+ */
+static int finger_equal(const char *a, size_t len, const char *b)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        char c = a[i];
+
+        if (c >= 'A' && c <= 'Z')
+        {
+            c += 'a' - 'A';
+        }
+
+        if (c != b[i])
+        {
+            return 0;
+        }
+    }
+
+    return '\0' == b[len];
+}
+
+/**
+ *\brief                        查找按序号导入的函数名,只有ws2_32.dll,wsock32.dll和oleaut32.dll有表
+ *\param[in]    lib             库名
+ *\param[in]    len             库名长度
+ *\param[in]    ordinal         序号
+ *\return                       函数名,NULL为没有找到
+ */
+static const char* finger_ordinal(const char *lib, size_t len, WORD ordinal)
+{
+    const FINGER_ORD *list = NULL;
+    size_t            low  = 0;
+    size_t            high = 0;
+
+    for (size_t i = 0; i < SIZEOF(g_ord_lib) && NULL == list; i++)
+    {
+        if (finger_equal(lib, len, g_ord_lib[i].name))
+        {
+            list = g_ord_lib[i].list;
+            high = g_ord_lib[i].count;
+        }
+    }
+
+    while (low < high)
+    {
+        size_t mid = (low + high) / 2;
+
+        if (list[mid].ordinal == ordinal)
+        {
+            return list[mid].name;
+        }
+
+        if (list[mid].ordinal < ordinal)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ *\brief                        字符串转成小写后输入MD5,ASCII以外的字节不变
+ *\param[in]    md5             MD5状态
+ *\param[in]    str             字符串
+ *\param[in]    len             长度
+ *\return                       无
+ */
+static void finger_lower(PHASH_MD5 md5, const char *str, size_t len)
+{
+    char buff[FINGER_CHUNK];
+
+    while (len > 0)
+    {
+        size_t n = (len < sizeof(buff)) ? len : sizeof(buff);
+
+        for (size_t i = 0; i < n; i++)
+        {
+            char c = str[i];
+
+            buff[i] = (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+        }
+
+        hash_md5_update(md5, buff, n);
+        str += n;
+        len -= n;
+    }
+}
+
+/**
+ *\brief                        得到库名或函数名,有驻留的名称时直接使用
+ *\param[in]    image           解析结果
+ *\param[in]    fa              名称在文件中的位置,0为没有
+ *\param[in]    interned        驻留的名称,可以为NULL
+ *\param[out]   len             长度
+ *\return                       名称
+ */
+static const char* finger_name(PPE_IMAGE image, DWORD fa, const PE_NAME *interned, size_t *len)
+{
+    if (NULL != interned)
+    {
+        *len = interned->len;
+        return interned->str;
+    }
+
+    return view_strn(&image->view, fa, PE_FINGER_NAME_MAX, len);
+}
+
+/**
+ *\brief                        计算导入表散列,与pefile相同只取导入表中的库,函数取输入名称表,没有时取输入地址表
+ *\param[in]    image           解析结果
+ *\param[out]   finger          指纹
+ *\return                       无
+ */
+static void finger_imphash(PPE_IMAGE image, PPE_FINGER finger)
+{
+    HASH_MD5 md5;
+    char     ord[16];
+
+    hash_md5_init(&md5);
+
+    for (DWORD i = 0; i < image->lib_static; i++)
+    {
+        PPE_IMPORT_LIB  lib   = &image->lib[i];
+        PPE_IMPORT_FUNC func  = (lib->func_count > 0) ? lib->func : lib->iat;
+        DWORD           count = (lib->func_count > 0) ? lib->func_count : lib->iat_count;
+        size_t          len   = 0;
+        const char     *name  = finger_name(image, lib->name_fa, lib->name, &len);
+        size_t          base  = len;
+
+        for (size_t dot = len; dot > 0; dot--) // 只去掉最后一个后缀
+        {
+            if ('.' == name[dot - 1])
+            {
+                const char *ext = name + dot;
+
+                if (finger_equal(ext, len - dot, "dll") || finger_equal(ext, len - dot, "ocx") ||
+                    finger_equal(ext, len - dot, "sys"))
+                {
+                    base = dot - 1;
+                }
+
+                break;
+            }
+        }
+
+        for (DWORD j = 0; j < count; j++, func++)
+        {
+            const char *func_name = NULL;
+            size_t      func_len  = 0;
+
+            if (func->by_ordinal)
+            {
+                func_name = finger_ordinal(name, len, func->ordinal);
+
+                if (NULL == func_name)
+                {
+                    func_len  = snprintf(ord, sizeof(ord), "ord%u", func->ordinal);
+                    func_name = ord;
+                }
+                else
+                {
+                    func_len = strlen(func_name);
+                }
+            }
+            else
+            {
+                func_name = finger_name(image, func->name_fa ? func->name_fa + 2 : 0, func->name, &func_len);
+            }
+
+            if (0 == func_len) // 读不到名称的函数不参与计算
+            {
+                continue;
+            }
+
+            if (finger->imp_count > 0)
+            {
+                hash_md5_update(&md5, ",", 1);
+            }
+
+            finger_lower(&md5, name, base);
+            hash_md5_update(&md5, ".", 1);
+            finger_lower(&md5, func_name, func_len);
+            finger->imp_count++;
+        }
+    }
+
+    hash_md5_final(&md5, finger->imphash_md5);
+    finger->imphash = (image->lib_static > 0);
+}
+
+/**
+ *\brief                        解码Rich头,计算校验和与散列
+ *\param[in]    image           解析结果
+ *\param[out]   finger          指纹
+ *\return                       0-成功或没有Rich头,其它失败(内存不足)
+ */
+static int finger_rich(PPE_IMAGE image, PPE_FINGER finger)
+{
+    const UCHAR *data  = image->view.data;
+    DWORD        limit = (image->nt_fa < FINGER_RICH_START + FINGER_RICH_SEARCH) ? image->nt_fa :
+                                                                                 FINGER_RICH_START + FINGER_RICH_SEARCH;
+    DWORD        rich  = 0;
+    DWORD        dans  = 0;
+    DWORD        key   = 0;
+
+    for (DWORD fa = FINGER_RICH_START + 16; fa + 8 <= limit; fa += 4) // 在DanS和3个填充之后,后面跟密钥
+    {
+        if (PE_RICH_MARK == le32(data + fa))
+        {
+            rich = fa;
+            break;
+        }
+    }
+
+    if (0 == rich)
+    {
+        return 0;
+    }
+
+    key = le32(data + rich + 4);
+
+    for (DWORD fa = rich - 16; fa >= FINGER_RICH_START; fa -= 4)
+    {
+        if (PE_RICH_DANS == (le32(data + fa) ^ key))
+        {
+            dans = fa;
+            break;
+        }
+    }
+
+    if (0 == dans)
+    {
+        return 0;
+    }
+
+    finger->rich_count = (rich - dans - 16) / 8;
+    finger->rich_entry = pe_arena_array(ARENA(image), finger->rich_count + 1, sizeof(PE_RICH_ENTRY));
+
+    if (NULL == finger->rich_entry)
+    {
+        return -1;
+    }
+
+    DWORD sum = dans; // 与链接器相同:DOS头(不包括e_lfanew)和DOS程序的每个字节,再加上每一项
+
+    for (DWORD i = 0; i < dans; i++)
+    {
+        if (i < 0x3c || i >= 0x40)
+        {
+            sum += FINGER_ROTL((DWORD)data[i], i);
+        }
+    }
+
+    for (DWORD i = 0; i < finger->rich_count; i++)
+    {
+        DWORD id    = le32(data + dans + 16 + i * 8) ^ key;
+        DWORD count = le32(data + dans + 20 + i * 8) ^ key;
+
+        finger->rich_entry[i].prod  = (WORD)(id >> 16);
+        finger->rich_entry[i].build = (WORD)id;
+        finger->rich_entry[i].count = count;
+
+        sum += FINGER_ROTL(id, count);
+    }
+
+    HASH_MD5 md5;
+    UCHAR    buff[FINGER_CHUNK];
+
+    hash_md5_init(&md5);
+
+    for (DWORD fa = dans; fa < rich; ) // 解码后的DanS,填充和各项
+    {
+        DWORD n = (rich - fa < sizeof(buff)) ? rich - fa : sizeof(buff);
+
+        for (DWORD i = 0; i < n; i += 4)
+        {
+            DWORD value = le32(data + fa + i) ^ key;
+
+            buff[i]     = (UCHAR)value;
+            buff[i + 1] = (UCHAR)(value >> 8);
+            buff[i + 2] = (UCHAR)(value >> 16);
+            buff[i + 3] = (UCHAR)(value >> 24);
+        }
+
+        hash_md5_update(&md5, buff, n);
+        fa += n;
+    }
+
+    hash_md5_final(&md5, finger->rich_md5);
+
+    finger->rich       = 1;
+    finger->rich_fa    = dans;
+    finger->rich_end   = rich;
+    finger->rich_key   = key;
+    finger->rich_valid = (sum == key);
+    return 0;
+}
+
+int pe_finger(PPE_IMAGE image, DWORD flags)
+{
+    PPE_FINGER finger = pe_arena_alloc(ARENA(image), sizeof(PE_FINGER));
+
+    if (NULL == finger)
+    {
+        return -1;
+    }
+
+    memset(finger, 0, sizeof(PE_FINGER));
+    finger->flags = flags;
+
+    if (flags & PE_FINGER_IMPHASH)
+    {
+        finger_imphash(image, finger);
+    }
+
+    if ((flags & PE_FINGER_RICH) && 0 != finger_rich(image, finger))
+    {
+        return -2;
+    }
+
+    image->finger = finger;
+    return 0;
+}
+
+char* pe_finger_hex(const UCHAR *md5, char *hex)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    for (int i = 0; i < HASH_MD5_SIZE; i++)
+    {
+        hex[i * 2]     = digits[md5[i] >> 4];
+        hex[i * 2 + 1] = digits[md5[i] & 0xF];
+    }
+
+    hex[HASH_MD5_SIZE * 2] = '\0';
+    return hex;
+}
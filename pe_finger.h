@@ -0,0 +1,73 @@
+/**
+ *\file     pe_finger.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    PE文件的聚类指纹:导入表散列(imphash)和Rich头
+ *          imphash与pefile的get_imphash相同:库名去掉.dll/.ocx/.sys后缀,与函数名一起转成小写,
+ *          "库名.函数名"用逗号连接后计算MD5,按序号导入时ws2_32/wsock32/oleaut32按pefile的表得到函数名,其它为"ord序号".
+ *          直接使用解析好的导入库和函数列表,边生成边输入MD5,不再读导入表,也不拼接字符串.
+ *          Rich头在DOS头和NT头之间,"Rich"后是异或密钥,向前解码到"DanS",
+ *          中间是(产品ID<<16|版本号,数量)对;Rich头散列为解码后"DanS"到"Rich"之前的数据的MD5
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|oleaut32按序号导入时也查表
+ */
+#ifndef _PE_FINGER_H_
+#define _PE_FINGER_H_
+
+#include "pe.h"
+#include "hash.h"
+
+#define PE_FINGER_IMPHASH       0x01                                        ///< 导入表散列
+#define PE_FINGER_RICH          0x02                                        ///< Rich头
+#define PE_FINGER_ALL           0x03                                        ///< 所有项
+
+#define PE_FINGER_NAME_MAX      4096                                        ///< 参与计算的名称的最大长度
+
+#define PE_RICH_DANS            0x536E6144                                  ///< "DanS",解码后的开始标记
+#define PE_RICH_MARK            0x68636952                                  ///< "Rich",没有编码的结束标记
+
+typedef struct _PE_RICH_ENTRY                                               ///  Rich头中的一项,一种编译工具
+{
+    WORD            prod;                                                   ///< 产品ID
+    WORD            build;                                                  ///< 版本号
+    DWORD           count;                                                  ///< 使用该工具生成的目标文件数
+
+} PE_RICH_ENTRY, *PPE_RICH_ENTRY;
+
+typedef struct _PE_FINGER                                                   ///  聚类指纹
+{
+    DWORD           flags;                                                  ///< 计算了哪几项,PE_FINGER_*
+    int             imphash;                                                ///< 1-有导入表,imphash有效
+    UCHAR           imphash_md5[HASH_MD5_SIZE];                             ///< 导入表散列
+    DWORD           imp_count;                                              ///< 参与计算的导入函数数
+    int             rich;                                                   ///< 1-有Rich头
+    DWORD           rich_fa;                                                ///< "DanS"在文件中的位置
+    DWORD           rich_end;                                               ///< "Rich"在文件中的位置
+    DWORD           rich_key;                                               ///< 异或密钥,也是链接器写入的校验和
+    int             rich_valid;                                             ///< 1-按DOS头和各项重新计算的校验和与密钥相同
+    PPE_RICH_ENTRY  rich_entry;                                             ///< 各项
+    DWORD           rich_count;                                             ///< 项数
+    UCHAR           rich_md5[HASH_MD5_SIZE];                                ///< Rich头散列
+
+} PE_FINGER, *PPE_FINGER;
+
+/**
+ *\brief                        计算聚类指纹,结果从解析结果的内存池分配,保存到image->finger
+ *\param[in]    image           解析结果,导入表已解析
+ *\param[in]    flags           需要的项,PE_FINGER_*
+ *\return                       0-成功,其它失败(内存不足)
+ */
+int pe_finger(PPE_IMAGE image, DWORD flags);
+
+/**
+ *\brief                        MD5转成十六进制字符串
+ *\param[in]    md5             HASH_MD5_SIZE字节
+ *\param[out]   hex             HASH_MD5_SIZE*2+1字节
+ *\return                       hex
+ */
+char* pe_finger_hex(const UCHAR *md5, char *hex);
+
+#endif
@@ -0,0 +1,1138 @@
+/**
+ *\file     pe_index.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    导入符号倒排索引实现
+ *          建立时符号名放入字符串表并用散列表去重,每个文件只保存符号序号,
+ *          全部文件处理完后按符号统计并倒排成文件列表,
+ *          散列表原样写入索引文件,查询时直接在映射的文件上查找
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|包括延迟导入的函数和绑定导入的库
+ */
+#include "pe_index.h"
+#include "pe_emit.h"
+
+#define INDEX_ALIGN(x)          (((x) + 7) & ~(ULONGLONG)7)                 ///< 按8字节对齐
+#define INDEX_OUT_SIZE          (64 * 1024)                                 ///< 写文件缓冲区长度
+
+typedef struct _INDEX_HEAD                                                  ///  索引文件头,文件中为小端
+{
+    DWORD       magic;                                                      ///< PE_INDEX_MAGIC
+    DWORD       version;                                                    ///< PE_INDEX_VERSION
+    DWORD       file_count;                                                 ///< 文件数
+    DWORD       symbol_count;                                               ///< 符号数
+    DWORD       hash_size;                                                  ///< 散列表长度,2的幂
+    DWORD       reserved;                                                   ///< 保留,为0
+    ULONGLONG   fsym_count;                                                 ///< 文件符号总数
+    ULONGLONG   post_count;                                                 ///< 文件列表总数
+    ULONGLONG   str_size;                                                   ///< 字符串表长度
+    ULONGLONG   file_off;                                                   ///< 文件的位置
+    ULONGLONG   fsym_off;                                                   ///< 文件符号的位置
+    ULONGLONG   symbol_off;                                                 ///< 符号的位置
+    ULONGLONG   post_off;                                                   ///< 文件列表的位置
+    ULONGLONG   hash_off;                                                   ///< 散列表的位置
+    ULONGLONG   str_off;                                                    ///< 字符串表的位置
+
+} INDEX_HEAD, *PINDEX_HEAD;
+
+typedef struct _INDEX_FILE                                                  ///  文件,文件中为小端
+{
+    ULONGLONG   size;                                                       ///< 文件长度
+    ULONGLONG   mtime;                                                      ///< 修改时间
+    DWORD       path;                                                       ///< 路径在字符串表中的位置
+    DWORD       fsym_first;                                                 ///< 第一个文件符号
+    DWORD       fsym_count;                                                 ///< 文件符号数
+    LONG        status;                                                     ///< pe_parse的返回值,打开失败时为1
+
+} INDEX_FILE, *PINDEX_FILE;
+
+typedef struct _INDEX_SYMBOL                                                ///  符号,文件中为小端
+{
+    DWORD       name;                                                       ///< 名称在字符串表中的位置
+    DWORD       len;                                                        ///< 名称长度
+    DWORD       post_first;                                                 ///< 第一个文件列表项
+    DWORD       post_count;                                                 ///< 文件数
+
+} INDEX_SYMBOL, *PINDEX_SYMBOL;
+
+typedef struct _INDEX_LIST                                                  ///  路径列表
+{
+    char      **list;                                                       ///< 路径
+    size_t      count;                                                      ///< 路径数量
+    size_t      cap;                                                        ///< 列表容量
+
+} INDEX_LIST, *PINDEX_LIST;
+
+typedef struct _INDEX_BUILD                                                 ///  建立中的索引
+{
+    PE_BUF          str;                                                    ///< 字符串表
+    PINDEX_SYMBOL   sym;                                                    ///< 符号
+    DWORD           sym_count;                                              ///< 符号数
+    DWORD           sym_cap;                                                ///< 符号容量
+    DWORD          *hash;                                                   ///< 散列表,符号序号+1
+    DWORD           hash_size;                                              ///< 散列表长度
+    PINDEX_FILE     file;                                                   ///< 文件
+    DWORD           file_count;                                             ///< 文件数
+    DWORD          *fsym;                                                   ///< 文件符号
+    ULONGLONG       fsym_count;                                             ///< 文件符号数
+    ULONGLONG       fsym_cap;                                               ///< 文件符号容量
+
+} INDEX_BUILD, *PINDEX_BUILD;
+
+typedef struct _INDEX_OUT                                                   ///  带缓冲区的索引文件输出
+{
+    FILE       *fp;                                                         ///< 文件
+    int         err;                                                        ///< 写失败
+    size_t      len;                                                        ///< 缓冲区中的数据长度
+    ULONGLONG   pos;                                                        ///< 已写入的长度
+    UCHAR       buf[INDEX_OUT_SIZE];                                        ///< 缓冲区
+
+} INDEX_OUT, *PINDEX_OUT;
+
+
+/**
+ *\brief                        FNV-1a散列
+ *\param[in]    key             数据
+ *\param[in]    len             长度
+ *\return                       散列值
+ */
+static DWORD index_hash(const char *key, size_t len)
+{
+    DWORD hash = 2166136261U;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        hash = (hash ^ (UCHAR)key[i]) * 16777619U;
+    }
+
+    return hash;
+}
+
+int pe_index_open(PPE_INDEX index, const char *path)
+{
+    memset(index, 0, sizeof(PE_INDEX));
+
+    if (0 != file_map(path, &index->map))
+    {
+        return -1;
+    }
+
+    PE_VIEW      view = { index->map.data, index->map.size };
+    const UCHAR *head = view.data;
+
+    if (!VIEW_HAS(&view, 0, PE_INDEX_HEAD_SIZE) ||
+        PE_INDEX_MAGIC   != VIEW_FIELD32(head, INDEX_HEAD, magic) ||
+        PE_INDEX_VERSION != VIEW_FIELD32(head, INDEX_HEAD, version))
+    {
+        pe_index_close(index);
+        return -2;
+    }
+
+    index->file_count   = VIEW_FIELD32(head, INDEX_HEAD, file_count);
+    index->symbol_count = VIEW_FIELD32(head, INDEX_HEAD, symbol_count);
+    index->hash_size    = VIEW_FIELD32(head, INDEX_HEAD, hash_size);
+    index->fsym_count   = le64(head + offsetof(INDEX_HEAD, fsym_count));
+    index->post_count   = le64(head + offsetof(INDEX_HEAD, post_count));
+    index->str_size     = le64(head + offsetof(INDEX_HEAD, str_size));
+
+    ULONGLONG file_off   = le64(head + offsetof(INDEX_HEAD, file_off));
+    ULONGLONG fsym_off   = le64(head + offsetof(INDEX_HEAD, fsym_off));
+    ULONGLONG symbol_off = le64(head + offsetof(INDEX_HEAD, symbol_off));
+    ULONGLONG post_off   = le64(head + offsetof(INDEX_HEAD, post_off));
+    ULONGLONG hash_off   = le64(head + offsetof(INDEX_HEAD, hash_off));
+    ULONGLONG str_off    = le64(head + offsetof(INDEX_HEAD, str_off));
+
+    // 数量先和文件长度比较,乘法不会溢出
+    if (index->fsym_count > view.size || index->post_count > view.size ||
+        !VIEW_HAS(&view, file_off,   (ULONGLONG)index->file_count   * sizeof(INDEX_FILE))   ||
+        !VIEW_HAS(&view, fsym_off,   index->fsym_count              * sizeof(DWORD))        ||
+        !VIEW_HAS(&view, symbol_off, (ULONGLONG)index->symbol_count * sizeof(INDEX_SYMBOL)) ||
+        !VIEW_HAS(&view, post_off,   index->post_count              * sizeof(DWORD))        ||
+        !VIEW_HAS(&view, hash_off,   (ULONGLONG)index->hash_size    * sizeof(DWORD))        ||
+        !VIEW_HAS(&view, str_off,    index->str_size)                                        ||
+        0 == index->hash_size || 0 != (index->hash_size & (index->hash_size - 1))         ||
+        0 == index->str_size  || 0 != view.data[str_off + index->str_size - 1]) // 最后一个字符串以0结尾
+    {
+        pe_index_close(index);
+        return -3;
+    }
+
+    index->file   = view.data + file_off;
+    index->fsym   = view.data + fsym_off;
+    index->symbol = view.data + symbol_off;
+    index->post   = view.data + post_off;
+    index->hash   = view.data + hash_off;
+    index->str    = (const char*)view.data + str_off;
+    return 0;
+}
+
+void pe_index_close(PPE_INDEX index)
+{
+    file_unmap(&index->map);
+    memset(index, 0, sizeof(PE_INDEX));
+}
+
+const char* pe_index_symbol(PPE_INDEX index, DWORD symbol, size_t *len)
+{
+    if (symbol >= index->symbol_count)
+    {
+        return NULL;
+    }
+
+    const UCHAR *sym  = index->symbol + (size_t)symbol * sizeof(INDEX_SYMBOL);
+    DWORD        name = VIEW_FIELD32(sym, INDEX_SYMBOL, name);
+
+    *len = VIEW_FIELD32(sym, INDEX_SYMBOL, len);
+
+    if (name >= index->str_size || *len >= index->str_size - name)
+    {
+        return NULL;
+    }
+
+    return index->str + name;
+}
+
+int pe_index_find(PPE_INDEX index, const char *key, size_t len)
+{
+    DWORD hash = index_hash(key, len);
+    DWORD mask = index->hash_size - 1;
+
+    for (DWORD i = 0; i < index->hash_size; i++)
+    {
+        DWORD  id   = le32(index->hash + ((hash + i) & mask) * sizeof(DWORD));
+        size_t size = 0;
+
+        if (0 == id)
+        {
+            return -1;
+        }
+
+        const char *name = pe_index_symbol(index, id - 1, &size);
+
+        if (NULL != name && size == len && 0 == memcmp(name, key, len))
+        {
+            return (int)(id - 1);
+        }
+    }
+
+    return -1;
+}
+
+const UCHAR* pe_index_posting(PPE_INDEX index, int symbol, DWORD *count)
+{
+    *count = 0;
+
+    if (symbol < 0 || (DWORD)symbol >= index->symbol_count)
+    {
+        return NULL;
+    }
+
+    const UCHAR *sym   = index->symbol + (size_t)symbol * sizeof(INDEX_SYMBOL);
+    DWORD        first = VIEW_FIELD32(sym, INDEX_SYMBOL, post_first);
+    DWORD        num   = VIEW_FIELD32(sym, INDEX_SYMBOL, post_count);
+
+    if ((ULONGLONG)first + num > index->post_count)
+    {
+        return NULL;
+    }
+
+    *count = num;
+    return index->post + (size_t)first * sizeof(DWORD);
+}
+
+const char* pe_index_path(PPE_INDEX index, DWORD file)
+{
+    if (file >= index->file_count)
+    {
+        return NULL;
+    }
+
+    DWORD path = VIEW_FIELD32(index->file + (size_t)file * sizeof(INDEX_FILE), INDEX_FILE, path);
+
+    return (path < index->str_size) ? index->str + path : NULL; // 字符串表以0结尾
+}
+
+size_t pe_index_key(char *dst, const char *src)
+{
+    size_t len = 0;
+
+    // 库名转小写
+    for (; '\0' != src[len] && '!' != src[len] && '#' != src[len] && len + 1 < PE_INDEX_KEY_MAX; len++)
+    {
+        dst[len] = (src[len] >= 'A' && src[len] <= 'Z') ? (char)(src[len] - 'A' + 'a') : src[len];
+    }
+
+    if ('#' == src[len]) // 序号统一成十进制
+    {
+        len += snprintf(dst + len, PE_INDEX_KEY_MAX - len, "#%lu", strtoul(src + len + 1, NULL, 0));
+    }
+    else
+    {
+        for (; '\0' != src[len] && len + 1 < PE_INDEX_KEY_MAX; len++)
+        {
+            dst[len] = src[len];
+        }
+    }
+
+    dst[len] = '\0';
+    return len;
+}
+
+/**
+ *\brief                        向字符串表追加字符串和结尾的0
+ *\param[in]    build           建立中的索引
+ *\param[in]    src             字符串
+ *\param[in]    len             长度
+ *\param[out]   off             字符串在字符串表中的位置
+ *\return                       0-成功,其它失败
+ */
+static int index_str(PINDEX_BUILD build, const char *src, size_t len, DWORD *off)
+{
+    if (build->str.len + len + 1 > 0xFFFFFFFF || 0 != pe_buf_reserve(&build->str, len + 1))
+    {
+        return -1;
+    }
+
+    *off = (DWORD)build->str.len;
+
+    memcpy(build->str.data + build->str.len, src, len);
+    build->str.data[build->str.len + len] = '\0';
+    build->str.len += len + 1;
+    return 0;
+}
+
+/**
+ *\brief                        散列表扩大一倍,重新放入所有符号
+ *\param[in]    build           建立中的索引
+ *\return                       0-成功,其它失败
+ */
+static int index_rehash(PINDEX_BUILD build)
+{
+    DWORD  size = build->hash_size ? build->hash_size * 2 : 1024;
+    DWORD *hash = calloc(size, sizeof(DWORD));
+
+    if (NULL == hash)
+    {
+        return -1;
+    }
+
+    for (DWORD id = 0; id < build->sym_count; id++)
+    {
+        PINDEX_SYMBOL sym = &build->sym[id];
+        DWORD         i   = index_hash(build->str.data + sym->name, sym->len) & (size - 1);
+
+        while (0 != hash[i])
+        {
+            i = (i + 1) & (size - 1);
+        }
+
+        hash[i] = id + 1;
+    }
+
+    free(build->hash);
+    build->hash      = hash;
+    build->hash_size = size;
+    return 0;
+}
+
+/**
+ *\brief                        得到符号序号,没有时加入
+ *\param[in]    build           建立中的索引
+ *\param[in]    key             符号名
+ *\param[in]    len             符号名长度
+ *\param[out]   id              符号序号
+ *\return                       0-成功,其它失败
+ */
+static int index_intern(PINDEX_BUILD build, const char *key, size_t len, DWORD *id)
+{
+    if ((build->sym_count + 1) * 2 > build->hash_size && 0 != index_rehash(build)) // 负载不超过一半
+    {
+        return -1;
+    }
+
+    DWORD mask = build->hash_size - 1;
+    DWORD i    = index_hash(key, len) & mask;
+
+    for (; 0 != build->hash[i]; i = (i + 1) & mask)
+    {
+        PINDEX_SYMBOL sym = &build->sym[build->hash[i] - 1];
+
+        if (sym->len == len && 0 == memcmp(build->str.data + sym->name, key, len))
+        {
+            *id = build->hash[i] - 1;
+            return 0;
+        }
+    }
+
+    if (build->sym_count == build->sym_cap)
+    {
+        DWORD         cap = build->sym_cap ? build->sym_cap * 2 : 1024;
+        PINDEX_SYMBOL sym = realloc(build->sym, cap * sizeof(INDEX_SYMBOL));
+
+        if (NULL == sym)
+        {
+            return -2;
+        }
+
+        build->sym     = sym;
+        build->sym_cap = cap;
+    }
+
+    PINDEX_SYMBOL sym = &build->sym[build->sym_count];
+
+    memset(sym, 0, sizeof(INDEX_SYMBOL));
+    sym->len = (DWORD)len;
+
+    if (0 != index_str(build, key, len, &sym->name))
+    {
+        return -3;
+    }
+
+    build->hash[i] = build->sym_count + 1;
+    *id            = build->sym_count++;
+    return 0;
+}
+
+/**
+ *\brief                        追加当前文件的符号序号
+ *\param[in]    build           建立中的索引
+ *\param[in]    id              符号序号
+ *\return                       0-成功,其它失败
+ */
+static int index_push(PINDEX_BUILD build, DWORD id)
+{
+    if (build->fsym_count == build->fsym_cap)
+    {
+        ULONGLONG cap  = build->fsym_cap ? build->fsym_cap * 2 : 64 * 1024;
+        DWORD    *fsym = (cap <= 0xFFFFFFFF) ? realloc(build->fsym, (size_t)cap * sizeof(DWORD)) : NULL;
+
+        if (NULL == fsym)
+        {
+            return -1;
+        }
+
+        build->fsym     = fsym;
+        build->fsym_cap = cap;
+    }
+
+    build->fsym[build->fsym_count++] = id;
+    return 0;
+}
+
+/**
+ *\brief                        追加当前文件的符号
+ *\param[in]    build           建立中的索引
+ *\param[in]    key             符号名
+ *\param[in]    len             符号名长度
+ *\return                       0-成功,其它失败
+ */
+static int index_add_symbol(PINDEX_BUILD build, const char *key, size_t len)
+{
+    DWORD id = 0;
+
+    if (0 != index_intern(build, key, len, &id))
+    {
+        return -1;
+    }
+
+    return index_push(build, id);
+}
+
+/**
+ *\brief                        提取解析结果中的导入符号,包括延迟导入和绑定导入的库.
+ *                              导入表的函数取输入名称表,没有时取输入地址表;延迟导入的函数只取输入名称表
+ *\param[in]    build           建立中的索引
+ *\param[in]    image           解析结果
+ *\return                       0-成功,其它失败
+ */
+static int index_image(PINDEX_BUILD build, PPE_IMAGE image)
+{
+    char key[PE_INDEX_KEY_MAX];
+
+    for (DWORD i = 0; i < image->lib_count; i++)
+    {
+        PPE_IMPORT_LIB  lib   = &image->lib[i];
+        PPE_IMPORT_FUNC func  = (lib->func_count || PE_IMPORT_STATIC != lib->type) ? lib->func : lib->iat;
+        DWORD           count = (lib->func_count || PE_IMPORT_STATIC != lib->type) ? lib->func_count : lib->iat_count;
+        size_t          dll   = 0;
+        const char     *name  = view_strn(&image->view, lib->name_fa, PE_INDEX_KEY_MAX / 2, &dll);
+
+        if (0 == dll)
+        {
+            continue;
+        }
+
+        for (size_t j = 0; j < dll; j++)
+        {
+            key[j] = (name[j] >= 'A' && name[j] <= 'Z') ? (char)(name[j] - 'A' + 'a') : name[j];
+        }
+
+        if (0 != index_add_symbol(build, key, dll))
+        {
+            return -1;
+        }
+
+        for (DWORD j = 0; j < count; j++, func++)
+        {
+            size_t len = 0;
+
+            if (func->by_ordinal)
+            {
+                len = dll + snprintf(key + dll, PE_INDEX_KEY_MAX - dll, "#%u", func->ordinal);
+            }
+            else
+            {
+                name = view_strn(&image->view, func->name_fa ? func->name_fa + 2 : 0, PE_INDEX_KEY_MAX - dll - 1, &len);
+
+                if (0 == len)
+                {
+                    continue;
+                }
+
+                key[dll] = '!';
+                memcpy(key + dll + 1, name, len);
+                len += dll + 1;
+            }
+
+            if (0 != index_add_symbol(build, key, len))
+            {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ *\brief                        比较DWORD,用于排序
+ */
+static int index_cmp_dword(const void *a, const void *b)
+{
+    DWORD x = *(const DWORD*)a;
+    DWORD y = *(const DWORD*)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ *\brief                        比较路径,用于排序
+ */
+static int index_cmp_path(const void *a, const void *b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/**
+ *\brief                        当前文件的符号排序并去掉重复的
+ *\param[in]    build           建立中的索引
+ *\param[in]    file            当前文件
+ *\return                       无
+ */
+static void index_unique(PINDEX_BUILD build, PINDEX_FILE file)
+{
+    DWORD *fsym  = build->fsym + file->fsym_first;
+    DWORD  count = (DWORD)(build->fsym_count - file->fsym_first);
+    DWORD  n     = 0;
+
+    qsort(fsym, count, sizeof(DWORD), index_cmp_dword);
+
+    for (DWORD i = 0; i < count; i++)
+    {
+        if (0 == n || fsym[n - 1] != fsym[i])
+        {
+            fsym[n++] = fsym[i];
+        }
+    }
+
+    file->fsym_count  = n;
+    build->fsym_count = file->fsym_first + n;
+}
+
+/**
+ *\brief                        在旧索引中按路径二分查找文件
+ *\param[in]    old             旧索引
+ *\param[in]    path            路径
+ *\return                       文件序号,-1为没有
+ */
+static LONG index_old_find(PPE_INDEX old, const char *path)
+{
+    DWORD low  = 0;
+    DWORD high = old->file_count;
+
+    while (low < high)
+    {
+        DWORD       mid  = low + (high - low) / 2;
+        const char *name = pe_index_path(old, mid);
+
+        if (NULL == name)
+        {
+            return -1;
+        }
+
+        int cmp = strcmp(name, path);
+
+        if (0 == cmp)
+        {
+            return (LONG)mid;
+        }
+
+        if (cmp < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ *\brief                        复用旧索引中文件的符号,旧符号序号转成新序号
+ *\param[in]    build           建立中的索引
+ *\param[in]    old             旧索引
+ *\param[in]    old_map         旧符号序号对应的新序号+1,0为还没有转换
+ *\param[in]    id              旧文件序号
+ *\param[in]    file            当前文件
+ *\return                       0-成功,其它失败,失败时需要重新解析
+ */
+static int index_reuse(PINDEX_BUILD build, PPE_INDEX old, DWORD *old_map, DWORD id, PINDEX_FILE file)
+{
+    const UCHAR *rec   = old->file + (size_t)id * sizeof(INDEX_FILE);
+    DWORD        first = VIEW_FIELD32(rec, INDEX_FILE, fsym_first);
+    DWORD        count = VIEW_FIELD32(rec, INDEX_FILE, fsym_count);
+
+    if ((ULONGLONG)first + count > old->fsym_count)
+    {
+        return -1;
+    }
+
+    file->status = (LONG)VIEW_FIELD32(rec, INDEX_FILE, status);
+
+    for (DWORD i = 0; i < count; i++)
+    {
+        DWORD sym = le32(old->fsym + ((size_t)first + i) * sizeof(DWORD));
+
+        if (sym >= old->symbol_count)
+        {
+            return -2;
+        }
+
+        if (0 == old_map[sym])
+        {
+            size_t      len    = 0;
+            const char *name   = pe_index_symbol(old, sym, &len);
+            DWORD       new_id = 0;
+
+            if (NULL == name || 0 != index_intern(build, name, len, &new_id))
+            {
+                return -3;
+            }
+
+            old_map[sym] = new_id + 1;
+        }
+
+        if (0 != index_push(build, old_map[sym] - 1))
+        {
+            return -4;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ *\brief                        解析文件并提取导入符号
+ *\param[in]    build           建立中的索引
+ *\param[in]    path            文件路径
+ *\param[in]    file            当前文件
+ *\return                       0-成功,其它失败(内存不足)
+ */
+static int index_parse(PINDEX_BUILD build, const char *path, PINDEX_FILE file)
+{
+    FILE_MAP map;
+    PE_IMAGE image;
+    int      ret = 0;
+
+    if (0 != file_map(path, &map))
+    {
+        file->status = 1;
+        return 0;
+    }
+
+    file->status = pe_parse(&image, map.data, map.size);
+
+    if (PE_ERR_MEMORY == file->status)
+    {
+        ret = -1;
+    }
+    else if (file->status >= 0 || file->status <= PE_ERR_RELOC_SECTION) // 结构错误时检查过的部分仍然可用
+    {
+        ret = index_image(build, &image);
+    }
+
+    pe_free(&image);
+    file_unmap(&map);
+    return ret;
+}
+
+/**
+ *\brief                        写入数据
+ *\param[in]    out             输出
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\return                       无
+ */
+static void out_bytes(PINDEX_OUT out, const void *data, size_t len)
+{
+    const UCHAR *src = (const UCHAR*)data;
+
+    while (len > 0)
+    {
+        if (out->len == INDEX_OUT_SIZE)
+        {
+            out->err |= (fwrite(out->buf, 1, out->len, out->fp) != out->len);
+            out->len  = 0;
+        }
+
+        size_t n = INDEX_OUT_SIZE - out->len;
+
+        if (n > len)
+        {
+            n = len;
+        }
+
+        memcpy(out->buf + out->len, src, n);
+        out->len += n;
+        out->pos += n;
+        src      += n;
+        len      -= n;
+    }
+}
+
+/**
+ *\brief                        写入小端数值
+ *\param[in]    out             输出
+ *\param[in]    value           数值
+ *\param[in]    len             字节数:4,8
+ *\return                       无
+ */
+static void out_num(PINDEX_OUT out, ULONGLONG value, int len)
+{
+    UCHAR data[8];
+
+    for (int i = 0; i < len; i++, value >>= 8)
+    {
+        data[i] = (UCHAR)(value & 0xFF);
+    }
+
+    out_bytes(out, data, len);
+}
+
+/**
+ *\brief                        补0到指定位置
+ *\param[in]    out             输出
+ *\param[in]    pos             位置
+ *\return                       无
+ */
+static void out_pad(PINDEX_OUT out, ULONGLONG pos)
+{
+    static const UCHAR zero[8] = { 0 };
+
+    while (out->pos < pos)
+    {
+        out_bytes(out, zero, (size_t)((pos - out->pos < 8) ? pos - out->pos : 8));
+    }
+}
+
+/**
+ *\brief                        倒排并写入索引文件
+ *\param[in]    build           建立中的索引
+ *\param[in]    path            索引文件路径
+ *\param[out]   stat            统计信息
+ *\return                       0-成功,其它失败
+ */
+static int index_write(PINDEX_BUILD build, const char *path, PPE_INDEX_STAT stat)
+{
+    INDEX_HEAD head = { PE_INDEX_MAGIC, PE_INDEX_VERSION, build->file_count, build->sym_count, build->hash_size };
+    DWORD     *post = malloc((size_t)(build->fsym_count ? build->fsym_count : 1) * sizeof(DWORD));
+    DWORD     *next = malloc((size_t)(build->sym_count ? build->sym_count : 1) * sizeof(DWORD));
+    PINDEX_OUT out  = malloc(sizeof(INDEX_OUT));
+
+    if (NULL == post || NULL == next || NULL == out)
+    {
+        free(post);
+        free(next);
+        free(out);
+        return -1;
+    }
+
+    // 按符号统计文件数,再按文件顺序填入,每个符号的文件列表自然有序
+    for (ULONGLONG i = 0; i < build->fsym_count; i++)
+    {
+        build->sym[build->fsym[i]].post_count++;
+    }
+
+    for (DWORD i = 0, first = 0; i < build->sym_count; i++)
+    {
+        build->sym[i].post_first = first;
+        next[i]                  = first;
+        first                   += build->sym[i].post_count;
+    }
+
+    for (DWORD f = 0; f < build->file_count; f++)
+    {
+        PINDEX_FILE file = &build->file[f];
+
+        for (DWORD j = 0; j < file->fsym_count; j++)
+        {
+            post[next[build->fsym[file->fsym_first + j]]++] = f;
+        }
+    }
+
+    head.fsym_count = build->fsym_count;
+    head.post_count = build->fsym_count;
+    head.str_size   = build->str.len;
+    head.file_off   = PE_INDEX_HEAD_SIZE;
+    head.fsym_off   = INDEX_ALIGN(head.file_off   + (ULONGLONG)build->file_count * sizeof(INDEX_FILE));
+    head.symbol_off = INDEX_ALIGN(head.fsym_off   + build->fsym_count * sizeof(DWORD));
+    head.post_off   = INDEX_ALIGN(head.symbol_off + (ULONGLONG)build->sym_count * sizeof(INDEX_SYMBOL));
+    head.hash_off   = INDEX_ALIGN(head.post_off   + build->fsym_count * sizeof(DWORD));
+    head.str_off    = INDEX_ALIGN(head.hash_off   + (ULONGLONG)build->hash_size * sizeof(DWORD));
+
+    out->fp  = file_open(path, "wb");
+    out->err = (NULL == out->fp);
+    out->len = 0;
+    out->pos = 0;
+
+    if (!out->err)
+    {
+        out_num(out, head.magic, 4);
+        out_num(out, head.version, 4);
+        out_num(out, head.file_count, 4);
+        out_num(out, head.symbol_count, 4);
+        out_num(out, head.hash_size, 4);
+        out_num(out, head.reserved, 4);
+        out_num(out, head.fsym_count, 8);
+        out_num(out, head.post_count, 8);
+        out_num(out, head.str_size, 8);
+        out_num(out, head.file_off, 8);
+        out_num(out, head.fsym_off, 8);
+        out_num(out, head.symbol_off, 8);
+        out_num(out, head.post_off, 8);
+        out_num(out, head.hash_off, 8);
+        out_num(out, head.str_off, 8);
+
+        for (DWORD i = 0; i < build->file_count; i++)
+        {
+            out_num(out, build->file[i].size, 8);
+            out_num(out, build->file[i].mtime, 8);
+            out_num(out, build->file[i].path, 4);
+            out_num(out, build->file[i].fsym_first, 4);
+            out_num(out, build->file[i].fsym_count, 4);
+            out_num(out, (DWORD)build->file[i].status, 4);
+        }
+
+        out_pad(out, head.fsym_off);
+
+        for (ULONGLONG i = 0; i < build->fsym_count; i++)
+        {
+            out_num(out, build->fsym[i], 4);
+        }
+
+        out_pad(out, head.symbol_off);
+
+        for (DWORD i = 0; i < build->sym_count; i++)
+        {
+            out_num(out, build->sym[i].name, 4);
+            out_num(out, build->sym[i].len, 4);
+            out_num(out, build->sym[i].post_first, 4);
+            out_num(out, build->sym[i].post_count, 4);
+        }
+
+        out_pad(out, head.post_off);
+
+        for (ULONGLONG i = 0; i < build->fsym_count; i++)
+        {
+            out_num(out, post[i], 4);
+        }
+
+        out_pad(out, head.hash_off);
+
+        for (DWORD i = 0; i < build->hash_size; i++)
+        {
+            out_num(out, build->hash[i], 4);
+        }
+
+        out_pad(out, head.str_off);
+        out_bytes(out, build->str.data, build->str.len);
+
+        out->err |= (fwrite(out->buf, 1, out->len, out->fp) != out->len);
+        out->err |= (0 != fclose(out->fp));
+    }
+
+    int ret = out->err ? -2 : 0;
+
+    stat->symbols  = build->sym_count;
+    stat->postings = build->fsym_count;
+    stat->bytes    = out->pos;
+
+    free(post);
+    free(next);
+    free(out);
+    return ret;
+}
+
+/**
+ *\brief                        遍历目录回调,将文件加入列表
+ *\param[in]    path            文件路径
+ *\param[in]    param           路径列表
+ *\return                       0-成功,其它失败
+ */
+static int index_add(const char *path, void *param)
+{
+    PINDEX_LIST files = (PINDEX_LIST)param;
+
+    if (files->count == files->cap)
+    {
+        size_t cap  = files->cap ? files->cap * 2 : 1024;
+        char **list = realloc(files->list, cap * sizeof(char*));
+
+        if (NULL == list)
+        {
+            return -1;
+        }
+
+        files->list = list;
+        files->cap  = cap;
+    }
+
+    files->list[files->count] = strdup(path);
+
+    return (NULL == files->list[files->count++]) ? -2 : 0;
+}
+
+int pe_index_build(const char *out, int full, int argc, char **argv, PPE_INDEX_STAT stat)
+{
+    INDEX_LIST  files  = { 0 };
+    INDEX_BUILD build  = { 0 };
+    PE_INDEX    old;
+    DWORD      *old_map = NULL;
+    int         ret     = 0;
+    DWORD       dummy   = 0;
+
+    memset(stat, 0, sizeof(PE_INDEX_STAT));
+
+    for (int i = 0; i < argc && 0 == ret; i++)
+    {
+        if (0 != dir_walk(argv[i], index_add, &files))
+        {
+            fprintf(stderr, "walk %s error\n", argv[i]);
+        }
+    }
+
+    // 文件按路径排序,增量重建时在旧索引中二分查找
+    qsort(files.list, files.count, sizeof(char*), index_cmp_path);
+
+    int has_old = !full && 0 == pe_index_open(&old, out);
+
+    if (has_old)
+    {
+        old_map = calloc(old.symbol_count + 1, sizeof(DWORD));
+        has_old = (NULL != old_map);
+    }
+
+    build.file = calloc(files.count + 1, sizeof(INDEX_FILE));
+
+    if (NULL == build.file || files.count > 0xFFFFFFFF || 0 != index_str(&build, "", 0, &dummy)) // 位置0为空字符串
+    {
+        ret = -1;
+    }
+
+    for (size_t i = 0; i < files.count && 0 == ret; i++)
+    {
+        if (i > 0 && 0 == strcmp(files.list[i - 1], files.list[i]))
+        {
+            continue; // 同一个文件在多个参数中
+        }
+
+        PINDEX_FILE file = &build.file[build.file_count];
+        LONG        id   = has_old ? index_old_find(&old, files.list[i]) : -1;
+
+        if (0 != index_str(&build, files.list[i], strlen(files.list[i]), &file->path))
+        {
+            ret = -1;
+            break;
+        }
+
+        if (0 != file_stat(files.list[i], &file->size, &file->mtime, NULL))
+        {
+            file->size  = 0;
+            file->mtime = 0;
+        }
+
+        file->fsym_first = (DWORD)build.fsym_count;
+
+        const UCHAR *rec = (id >= 0) ? old.file + (size_t)id * sizeof(INDEX_FILE) : NULL;
+
+        if (NULL != rec && le64(rec + offsetof(INDEX_FILE, size)) == file->size &&
+            le64(rec + offsetof(INDEX_FILE, mtime)) == file->mtime &&
+            0 == index_reuse(&build, &old, old_map, (DWORD)id, file))
+        {
+            stat->reused++;
+        }
+        else
+        {
+            build.fsym_count = file->fsym_first; // 复用失败时丢掉已加入的符号
+            ret = index_parse(&build, files.list[i], file);
+            stat->parsed++;
+        }
+
+        index_unique(&build, file);
+        build.file_count++;
+    }
+
+    if (has_old)
+    {
+        pe_index_close(&old); // Windows下映射中的文件不能替换
+    }
+
+    if (0 == ret && (0 != build.hash_size || 0 == index_rehash(&build)))
+    {
+        char *tmp = malloc(strlen(out) + 5);
+
+        if (NULL == tmp)
+        {
+            ret = -2;
+        }
+        else
+        {
+            sprintf(tmp, "%s.tmp", out);
+            ret = index_write(&build, tmp, stat);
+
+            if (0 == ret && 0 != file_rename(tmp, out))
+            {
+                ret = -3;
+            }
+
+            if (0 != ret)
+            {
+                remove(tmp);
+            }
+
+            free(tmp);
+        }
+    }
+    else if (0 == ret)
+    {
+        ret = -4;
+    }
+
+    stat->files = build.file_count;
+
+    for (size_t i = 0; i < files.count; i++)
+    {
+        free(files.list[i]);
+    }
+
+    free(files.list);
+    free(old_map);
+    free(build.file);
+    free(build.fsym);
+    free(build.sym);
+    free(build.hash);
+    pe_buf_free(&build.str);
+    return ret;
+}
+
+/**
+ *\brief                        查询索引,每个符号输出导入了它的文件路径
+ *\param[in]    path            索引文件路径
+ *\param[in]    argc            符号个数
+ *\param[in]    argv            符号,库名[!函数名|#序号]
+ *\return                       0-成功,其它失败
+ */
+static int index_query(const char *path, int argc, char **argv)
+{
+    PE_INDEX index;
+    char     key[PE_INDEX_KEY_MAX];
+    double   start = time_now();
+
+    if (0 != pe_index_open(&index, path))
+    {
+        fprintf(stderr, "open index %s error\n", path);
+        return -1;
+    }
+
+    double open = time_now() - start;
+
+    for (int i = 0; i < argc; i++)
+    {
+        DWORD  count = 0;
+        size_t len   = pe_index_key(key, argv[i]);
+
+        start = time_now();
+
+        const UCHAR *post = pe_index_posting(&index, pe_index_find(&index, key, len), &count);
+
+        double secs = time_now() - start;
+
+        for (DWORD j = 0; NULL != post && j < count; j++)
+        {
+            const char *name = pe_index_path(&index, le32(post + j * sizeof(DWORD)));
+
+            if (NULL != name)
+            {
+                printf("%s\t%s\n", key, name);
+            }
+        }
+
+        fprintf(stderr, "%s: %u files %.2fus\n", key, count, secs * 1e6);
+    }
+
+    fprintf(stderr, "index files:%u symbols:%u open:%.2fus\n", index.file_count, index.symbol_count, open * 1e6);
+
+    pe_index_close(&index);
+    return 0;
+}
+
+int index_main(int argc, char **argv)
+{
+    if (argc >= 4 && 0 == strcmp(argv[1], "build"))
+    {
+        PE_INDEX_STAT stat;
+        int           full  = (0 == strcmp(argv[2], "-f"));
+        int           first = 2 + full;
+
+        if (first + 1 < argc)
+        {
+            double start = time_now();
+            int    ret   = pe_index_build(argv[first], full, argc - first - 1, argv + first + 1, &stat);
+            double secs  = time_now() - start;
+
+            if (0 != ret)
+            {
+                fprintf(stderr, "build index %s error %d\n", argv[first], ret);
+            }
+
+            fprintf(stderr, "files:%u reused:%u parsed:%u symbols:%u postings:%llu bytes:%llu time:%.3fs\n",
+                    stat.files, stat.reused, stat.parsed, stat.symbols,
+                    (unsigned long long)stat.postings, (unsigned long long)stat.bytes, secs);
+            return ret;
+        }
+    }
+    else if (argc >= 4 && 0 == strcmp(argv[1], "query"))
+    {
+        return index_query(argv[2], argc - 3, argv + 3);
+    }
+
+    fprintf(stderr, "usage: peinfo index build [-f] index path...\n"
+                    "       peinfo index query index dll[!func|#ordinal]...\n");
+    return -1;
+}
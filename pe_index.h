@@ -0,0 +1,146 @@
+/**
+ *\file     pe_index.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    导入符号倒排索引,回答"哪些文件导入了某个库或函数"
+ *          符号为导入的(库,函数名或序号),库名转成小写:
+ *              kernel32.dll            导入了该库的任意函数
+ *              kernel32.dll!CreateFileW 按名称导入
+ *              ws2_32.dll#23           按序号导入
+ *          索引文件可以直接内存映射查询,所有数值为小端,各部分按8字节对齐:
+ *              部分|内容
+ *              -|-
+ *              头|PE_INDEX_HEAD_SIZE字节,见pe_index.c中的INDEX_HEAD
+ *              文件|按路径排序,每项32字节:长度,修改时间,路径,符号列表起始,符号数,解析结果
+ *              文件符号|每个文件导入的符号序号,DWORD,按序号排序,增量重建时复用
+ *              符号|每项16字节:名称,名称长度,文件列表起始,文件数
+ *              文件列表|每个符号的文件序号,DWORD,按序号排序
+ *              散列表|开放寻址,DWORD符号序号+1,0为空,长度为2的幂
+ *              字符串|路径和符号名,以0结尾
+ *          重建时路径,长度和修改时间都没变的文件直接复用旧索引中的符号,不再解析
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|符号包括延迟导入的函数和绑定导入的库,格式版本改为2,旧索引不再复用
+ */
+#ifndef _PE_INDEX_H_
+#define _PE_INDEX_H_
+
+#include "pe.h"
+
+#define PE_INDEX_MAGIC          0x58494550                                  ///< "PEIX"
+#define PE_INDEX_VERSION        2                                           ///< 索引文件格式版本
+#define PE_INDEX_HEAD_SIZE      96                                          ///< 索引文件头长度
+#define PE_INDEX_KEY_MAX        1024                                        ///< 符号名最大长度,超过时截断
+
+typedef struct _PE_INDEX                                                    ///  打开的索引,内存映射,查询时不复制数据
+{
+    FILE_MAP        map;                                                    ///< 索引文件
+    DWORD           file_count;                                             ///< 文件数
+    DWORD           symbol_count;                                           ///< 符号数
+    DWORD           hash_size;                                              ///< 散列表长度
+    ULONGLONG       fsym_count;                                             ///< 文件符号总数
+    ULONGLONG       post_count;                                             ///< 文件列表总数
+    ULONGLONG       str_size;                                               ///< 字符串表长度
+
+    const UCHAR    *file;                                                   ///< 文件
+    const UCHAR    *fsym;                                                   ///< 文件符号
+    const UCHAR    *symbol;                                                 ///< 符号
+    const UCHAR    *post;                                                   ///< 文件列表
+    const UCHAR    *hash;                                                   ///< 散列表
+    const char     *str;                                                    ///< 字符串表
+
+} PE_INDEX, *PPE_INDEX;
+
+typedef struct _PE_INDEX_STAT                                               ///  建立索引的统计信息
+{
+    DWORD           files;                                                  ///< 文件数
+    DWORD           reused;                                                 ///< 复用旧索引的文件数
+    DWORD           parsed;                                                 ///< 重新解析的文件数
+    DWORD           symbols;                                                ///< 符号数
+    ULONGLONG       postings;                                               ///< 文件列表总数
+    ULONGLONG       bytes;                                                  ///< 索引文件长度
+
+} PE_INDEX_STAT, *PPE_INDEX_STAT;
+
+/**
+ *\brief                        打开索引文件,检查头和各部分的范围,记录中的序号在使用时检查
+ *\param[out]   index           索引,使用后调用pe_index_close
+ *\param[in]    path            索引文件路径
+ *\return                       0-成功,其它失败
+ */
+int pe_index_open(PPE_INDEX index, const char *path);
+
+/**
+ *\brief                        关闭索引
+ *\param[in]    index           索引
+ *\return                       无
+ */
+void pe_index_close(PPE_INDEX index);
+
+/**
+ *\brief                        查找符号
+ *\param[in]    index           索引
+ *\param[in]    key             符号名,库名必须是小写,见pe_index_key
+ *\param[in]    len             符号名长度
+ *\return                       符号序号,-1为没有
+ */
+int pe_index_find(PPE_INDEX index, const char *key, size_t len);
+
+/**
+ *\brief                        得到导入了符号的文件序号列表
+ *\param[in]    index           索引
+ *\param[in]    symbol          符号序号
+ *\param[out]   count           文件数
+ *\return                       小端DWORD数组,用le32读,出错时返回NULL
+ */
+const UCHAR* pe_index_posting(PPE_INDEX index, int symbol, DWORD *count);
+
+/**
+ *\brief                        得到文件路径
+ *\param[in]    index           索引
+ *\param[in]    file            文件序号
+ *\return                       路径,序号或偏移非法时返回NULL
+ */
+const char* pe_index_path(PPE_INDEX index, DWORD file);
+
+/**
+ *\brief                        得到符号名
+ *\param[in]    index           索引
+ *\param[in]    symbol          符号序号
+ *\param[out]   len             符号名长度
+ *\return                       符号名,序号或偏移非法时返回NULL
+ */
+const char* pe_index_symbol(PPE_INDEX index, DWORD symbol, size_t *len);
+
+/**
+ *\brief                        查询字符串转成符号名,库名转成小写
+ *\param[out]   dst             符号名,至少PE_INDEX_KEY_MAX字节
+ *\param[in]    src             查询字符串,库名[!函数名|#序号]
+ *\return                       符号名长度
+ */
+size_t pe_index_key(char *dst, const char *src);
+
+/**
+ *\brief                        建立索引,out已存在时复用没有变化的文件,先写临时文件再替换
+ *\param[in]    out             索引文件路径
+ *\param[in]    full            1-不复用旧索引,全部重新解析
+ *\param[in]    argc            路径个数
+ *\param[in]    argv            目录或文件路径
+ *\param[out]   stat            统计信息
+ *\return                       0-成功,其它失败
+ */
+int pe_index_build(const char *out, int full, int argc, char **argv, PPE_INDEX_STAT stat);
+
+/**
+ *\brief                        索引命令
+ *                              peinfo index build [-f] 索引文件 路径...
+ *                              peinfo index query 索引文件 库名[!函数名|#序号]...
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数,argv[0]为命令名
+ *\return                       0-成功,其它失败
+ */
+int index_main(int argc, char **argv);
+
+#endif
@@ -0,0 +1,377 @@
+/**
+ *\file     pe_reloc.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    重定位数据项批量解码和统计实现
+ *          向量实现一次取8或16项,移位得到类型,与0x0fff得到偏移,
+ *          类型0,3,10用比较结果累加计数,出现其它类型的段再对类型数组按类型逐个比较计数.
+ *          x86是小端,可以直接按WORD读文件数据;其它CPU只用逐项的实现
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|CPU检查移到simd.h
+ *          2026.10.18|实现在启动线程前选择,不在解码时选择
+ */
+#include "pe_reloc.h"
+
+#define RELOC_CHUNK             (16 * 1024)                                 ///< 每段的项数,类型数组在一级缓存内,16位计数器不会溢出
+#define RELOC_BUF               4096                                        ///< 统计时每次解码的项数
+
+typedef void (*reloc_decode_proc)(const UCHAR *list, DWORD count, WORD *offset, BYTE *type, ULONGLONG *hist);
+
+/**
+ *\brief                        逐项解码
+ *\param[in]    list            数据项
+ *\param[in]    count           数据项数
+ *\param[out]   offset          页内偏移
+ *\param[out]   type            类型
+ *\param[in,out] hist           每种类型的数量
+ *\return                       无
+ */
+static void reloc_decode_scalar(const UCHAR *list, DWORD count, WORD *offset, BYTE *type, ULONGLONG *hist)
+{
+    for (DWORD i = 0; i < count; i++)
+    {
+        WORD value = le16(list + i * sizeof(WORD));
+
+        offset[i] = value & 0x0fff;
+        type[i]   = (BYTE)(value >> 12);
+        hist[type[i]]++;
+    }
+}
+
+#ifdef SIMD_X86
+
+/**
+ *\brief                        8个16位计数器求和
+ *\param[in]    count           计数器
+ *\return                       和
+ */
+SIMD_TARGET("sse2")
+static DWORD reloc_sum_sse2(__m128i count)
+{
+    __m128i sum = _mm_madd_epi16(count, _mm_set1_epi16(1));
+
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (DWORD)_mm_cvtsi128_si32(sum);
+}
+
+/**
+ *\brief                        SSE2统计0,3,10以外的类型,每种类型比较一遍类型数组,每次16项
+ *\param[in,out] hist           每种类型的数量
+ *\param[in]    type            类型
+ *\param[in]    count           项数
+ *\param[in]    other           0,3,10以外的类型的项数,都找到后停止
+ *\return                       无
+ */
+SIMD_TARGET("sse2")
+static void reloc_hist_sse2(ULONGLONG *hist, const BYTE *type, DWORD count, DWORD other)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    for (int t = 1; t < PE_RELOC_TYPES && other > 0; t++)
+    {
+        if (PE_RELOC_HIGHLOW == t || PE_RELOC_DIR64 == t)
+        {
+            continue;
+        }
+
+        const __m128i key   = _mm_set1_epi8((char)t);
+        __m128i       total = zero;
+        DWORD         n     = 0;
+        DWORD         i     = 0;
+
+        while (count - i >= 16)
+        {
+            DWORD   end = i + (((count - i < 255 * 16) ? count - i : 255 * 16) & ~15U); // 8位计数器最多255次
+            __m128i acc = zero;
+
+            for (; i < end; i += 16)
+            {
+                acc = _mm_sub_epi8(acc, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(type + i)), key));
+            }
+
+            total = _mm_add_epi64(total, _mm_sad_epu8(acc, zero));
+        }
+
+        n = (DWORD)_mm_cvtsi128_si32(total) + (DWORD)_mm_cvtsi128_si32(_mm_unpackhi_epi64(total, total));
+
+        for (; i < count; i++)
+        {
+            n += (t == type[i]);
+        }
+
+        hist[t] += n;
+        other   -= n;
+    }
+}
+
+/**
+ *\brief                        SSE2解码,一次8项
+ *\param[in]    list            数据项
+ *\param[in]    count           数据项数
+ *\param[out]   offset          页内偏移
+ *\param[out]   type            类型
+ *\param[in,out] hist           每种类型的数量
+ *\return                       无
+ */
+SIMD_TARGET("sse2")
+static void reloc_decode_sse2(const UCHAR *list, DWORD count, WORD *offset, BYTE *type, ULONGLONG *hist)
+{
+    const __m128i mask = _mm_set1_epi16(0x0fff);
+    const __m128i t3   = _mm_set1_epi16(PE_RELOC_HIGHLOW);
+    const __m128i t10  = _mm_set1_epi16(PE_RELOC_DIR64);
+    const __m128i zero = _mm_setzero_si128();
+    DWORD         i    = 0;
+
+    while (count - i >= 8)
+    {
+        DWORD   start = i;
+        DWORD   end   = start + (((count - start < RELOC_CHUNK) ? count - start : RELOC_CHUNK) & ~7U);
+        __m128i c0    = zero;
+        __m128i c3    = zero;
+        __m128i c10   = zero;
+
+        for (; i < end; i += 8)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(list + i * sizeof(WORD)));
+            __m128i t = _mm_srli_epi16(v, 12);
+
+            _mm_storeu_si128((__m128i*)(offset + i), _mm_and_si128(v, mask));
+            _mm_storel_epi64((__m128i*)(type + i), _mm_packus_epi16(t, t));
+
+            c0  = _mm_sub_epi16(c0,  _mm_cmpeq_epi16(t, zero)); // 相等时为-1
+            c3  = _mm_sub_epi16(c3,  _mm_cmpeq_epi16(t, t3));
+            c10 = _mm_sub_epi16(c10, _mm_cmpeq_epi16(t, t10));
+        }
+
+        DWORD n0  = reloc_sum_sse2(c0);
+        DWORD n3  = reloc_sum_sse2(c3);
+        DWORD n10 = reloc_sum_sse2(c10);
+
+        hist[PE_RELOC_ABSOLUTE] += n0;
+        hist[PE_RELOC_HIGHLOW]  += n3;
+        hist[PE_RELOC_DIR64]    += n10;
+
+        if (n0 + n3 + n10 != end - start)
+        {
+            reloc_hist_sse2(hist, type + start, end - start, end - start - n0 - n3 - n10);
+        }
+    }
+
+    reloc_decode_scalar(list + i * sizeof(WORD), count - i, offset + i, type + i, hist);
+}
+
+/**
+ *\brief                        16个16位计数器求和
+ *\param[in]    count           计数器
+ *\return                       和
+ */
+SIMD_TARGET("avx2")
+static DWORD reloc_sum_avx2(__m256i count)
+{
+    return reloc_sum_sse2(_mm_add_epi16(_mm256_castsi256_si128(count), _mm256_extracti128_si256(count, 1)));
+}
+
+/**
+ *\brief                        AVX2统计0,3,10以外的类型,每种类型比较一遍类型数组,每次32项
+ *\param[in,out] hist           每种类型的数量
+ *\param[in]    type            类型
+ *\param[in]    count           项数
+ *\param[in]    other           0,3,10以外的类型的项数,都找到后停止
+ *\return                       无
+ */
+SIMD_TARGET("avx2")
+static void reloc_hist_avx2(ULONGLONG *hist, const BYTE *type, DWORD count, DWORD other)
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (int t = 1; t < PE_RELOC_TYPES && other > 0; t++)
+    {
+        if (PE_RELOC_HIGHLOW == t || PE_RELOC_DIR64 == t)
+        {
+            continue;
+        }
+
+        const __m256i key   = _mm256_set1_epi8((char)t);
+        __m256i       total = zero;
+        DWORD         n     = 0;
+        DWORD         i     = 0;
+
+        while (count - i >= 32)
+        {
+            DWORD   end = i + (((count - i < 255 * 32) ? count - i : 255 * 32) & ~31U);
+            __m256i acc = zero;
+
+            for (; i < end; i += 32)
+            {
+                acc = _mm256_sub_epi8(acc, _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(type + i)), key));
+            }
+
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(acc, zero));
+        }
+
+        __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+
+        n = (DWORD)_mm_cvtsi128_si32(sum) + (DWORD)_mm_cvtsi128_si32(_mm_unpackhi_epi64(sum, sum));
+
+        for (; i < count; i++)
+        {
+            n += (t == type[i]);
+        }
+
+        hist[t] += n;
+        other   -= n;
+    }
+}
+
+/**
+ *\brief                        AVX2解码,一次16项
+ *\param[in]    list            数据项
+ *\param[in]    count           数据项数
+ *\param[out]   offset          页内偏移
+ *\param[out]   type            类型
+ *\param[in,out] hist           每种类型的数量
+ *\return                       无
+ */
+SIMD_TARGET("avx2")
+static void reloc_decode_avx2(const UCHAR *list, DWORD count, WORD *offset, BYTE *type, ULONGLONG *hist)
+{
+    const __m256i mask = _mm256_set1_epi16(0x0fff);
+    const __m256i t3   = _mm256_set1_epi16(PE_RELOC_HIGHLOW);
+    const __m256i t10  = _mm256_set1_epi16(PE_RELOC_DIR64);
+    const __m256i zero = _mm256_setzero_si256();
+    DWORD         i    = 0;
+
+    while (count - i >= 16)
+    {
+        DWORD   start = i;
+        DWORD   end   = start + (((count - start < RELOC_CHUNK) ? count - start : RELOC_CHUNK) & ~15U);
+        __m256i c0    = zero;
+        __m256i c3    = zero;
+        __m256i c10   = zero;
+
+        for (; i < end; i += 16)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(list + i * sizeof(WORD)));
+            __m256i t = _mm256_srli_epi16(v, 12);
+
+            // packus在每个128位内交错,取第0和第2个64位得到16个连续的字节
+            __m256i p = _mm256_permute4x64_epi64(_mm256_packus_epi16(t, t), _MM_SHUFFLE(0, 0, 2, 0));
+
+            _mm256_storeu_si256((__m256i*)(offset + i), _mm256_and_si256(v, mask));
+            _mm_storeu_si128((__m128i*)(type + i), _mm256_castsi256_si128(p));
+
+            c0  = _mm256_sub_epi16(c0,  _mm256_cmpeq_epi16(t, zero));
+            c3  = _mm256_sub_epi16(c3,  _mm256_cmpeq_epi16(t, t3));
+            c10 = _mm256_sub_epi16(c10, _mm256_cmpeq_epi16(t, t10));
+        }
+
+        DWORD n0  = reloc_sum_avx2(c0);
+        DWORD n3  = reloc_sum_avx2(c3);
+        DWORD n10 = reloc_sum_avx2(c10);
+
+        hist[PE_RELOC_ABSOLUTE] += n0;
+        hist[PE_RELOC_HIGHLOW]  += n3;
+        hist[PE_RELOC_DIR64]    += n10;
+
+        if (n0 + n3 + n10 != end - start)
+        {
+            reloc_hist_avx2(hist, type + start, end - start, end - start - n0 - n3 - n10);
+        }
+    }
+
+    reloc_decode_sse2(list + i * sizeof(WORD), count - i, offset + i, type + i, hist);
+}
+
+#endif
+
+static reloc_decode_proc g_reloc_proc[] = {                                 ///< 按PE_RELOC_*排列
+    reloc_decode_scalar,
+#ifdef SIMD_X86
+    reloc_decode_sse2,
+    reloc_decode_avx2,
+#endif
+};
+
+static const char *g_reloc_name[] = { "scalar", "sse2", "avx2" };           ///< 实现的名称
+
+static int g_reloc_impl = PE_RELOC_SCALAR;                                  ///< 使用的实现,启动线程前用pe_reloc_use选择
+
+int pe_reloc_use(int impl)
+{
+    if (PE_RELOC_AUTO == impl)
+    {
+        impl = simd_best((int)(SIZEOF(g_reloc_proc)) - 1);
+    }
+    else if (impl < 0 || impl >= (int)(SIZEOF(g_reloc_proc)) || !simd_supported(impl))
+    {
+        return -1;
+    }
+
+    g_reloc_impl = impl;
+    return 0;
+}
+
+const char* pe_reloc_impl(void)
+{
+    return g_reloc_name[g_reloc_impl];
+}
+
+void pe_reloc_decode(const UCHAR *list, DWORD count, WORD *offset, BYTE *type, ULONGLONG hist[PE_RELOC_TYPES])
+{
+    g_reloc_proc[g_reloc_impl](list, count, offset, type, hist);
+}
+
+int pe_reloc_stat(PPE_IMAGE image, PPE_RELOC_STAT stat)
+{
+    WORD  offset[RELOC_BUF];
+    BYTE  type[RELOC_BUF];
+
+    memset(stat, 0, sizeof(PE_RELOC_STAT));
+
+    if (0 == image->reloc_count)
+    {
+        return 0;
+    }
+
+    stat->page = malloc(image->reloc_count * sizeof(DWORD));
+
+    if (NULL == stat->page)
+    {
+        return -1;
+    }
+
+    stat->page_count = image->reloc_count;
+
+    for (DWORD i = 0; i < image->reloc_count; i++)
+    {
+        PPE_RELOC_BLOCK block = &image->reloc[i];
+        const UCHAR    *list  = image->view.data + block->fa + sizeof(IMAGE_BASE_RELOCATION);
+        ULONGLONG       hist[PE_RELOC_TYPES] = { 0 };
+
+        for (DWORD j = 0; j < block->count; j += RELOC_BUF)
+        {
+            DWORD n = (block->count - j < RELOC_BUF) ? block->count - j : RELOC_BUF;
+
+            pe_reloc_decode(list + j * sizeof(WORD), n, offset, type, hist);
+        }
+
+        stat->page[i] = block->count - (DWORD)hist[PE_RELOC_ABSOLUTE];
+
+        for (int t = 0; t < PE_RELOC_TYPES; t++)
+        {
+            stat->type[t] += hist[t];
+        }
+    }
+
+    return 0;
+}
+
+void pe_reloc_stat_free(PPE_RELOC_STAT stat)
+{
+    free(stat->page);
+    memset(stat, 0, sizeof(PE_RELOC_STAT));
+}
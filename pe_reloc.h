@@ -0,0 +1,78 @@
+/**
+ *\file     pe_reloc.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    重定位数据项批量解码和统计
+ *          每个数据项为WORD,高4位为类型,低12位为页内偏移.整块解码成类型数组和偏移数组,
+ *          同时统计每种类型的数量.x86下运行时按CPU选择AVX2,SSE2或逐项的实现,结果相同
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|实现编号使用simd.h的定义
+ *          2026.10.18|没有选择实现时逐项解码
+ */
+#ifndef _PE_RELOC_H_
+#define _PE_RELOC_H_
+
+#include "pe.h"
+#include "simd.h"
+
+#define PE_RELOC_TYPES          16                                          ///< 类型数,4位
+#define PE_RELOC_ABSOLUTE       0                                           ///< 用于对齐的空项,不需要修正
+#define PE_RELOC_HIGHLOW        3                                           ///< 修正4字节
+#define PE_RELOC_DIR64          10                                          ///< 修正8字节
+
+#define PE_RELOC_AUTO           SIMD_AUTO                                   ///< 按CPU选择实现
+#define PE_RELOC_SCALAR         SIMD_SCALAR                                 ///< 逐项解码
+#define PE_RELOC_SSE2           SIMD_SSE2                                   ///< SSE2,一次8项
+#define PE_RELOC_AVX2           SIMD_AVX2                                   ///< AVX2,一次16项
+
+typedef struct _PE_RELOC_STAT                                               ///  重定位统计
+{
+    ULONGLONG       type[PE_RELOC_TYPES];                                   ///< 每种类型的数据项数
+    DWORD          *page;                                                   ///< 每个块需要修正的数据项数(类型不为0),与image->reloc对应
+    DWORD           page_count;                                             ///< 块数
+
+} PE_RELOC_STAT, *PPE_RELOC_STAT;
+
+/**
+ *\brief                        解码一组重定位数据项
+ *\param[in]    list            数据项,小端WORD数组,不要求对齐
+ *\param[in]    count           数据项数
+ *\param[out]   offset          页内偏移,count项
+ *\param[out]   type            类型,count项
+ *\param[in,out] hist           每种类型的数量,累加
+ *\return                       无
+ */
+void pe_reloc_decode(const UCHAR *list, DWORD count, WORD *offset, BYTE *type, ULONGLONG hist[PE_RELOC_TYPES]);
+
+/**
+ *\brief                        统计整个重定位表,每个块的数量和所有块的类型
+ *\param[in]    image           解析结果
+ *\param[out]   stat            统计结果,使用后调用pe_reloc_stat_free
+ *\return                       0-成功,其它失败(内存不足)
+ */
+int pe_reloc_stat(PPE_IMAGE image, PPE_RELOC_STAT stat);
+
+/**
+ *\brief                        释放统计结果
+ *\param[in]    stat            统计结果
+ *\return                       无
+ */
+void pe_reloc_stat_free(PPE_RELOC_STAT stat);
+
+/**
+ *\brief                        指定解码的实现,不是线程安全的,在启动线程前调用,没有调用时逐项解码
+ *\param[in]    impl            PE_RELOC_AUTO,PE_RELOC_SCALAR,PE_RELOC_SSE2,PE_RELOC_AVX2
+ *\return                       0-成功,-1-CPU不支持
+ */
+int pe_reloc_use(int impl);
+
+/**
+ *\brief                        得到当前使用的实现的名称
+ *\return                       scalar,sse2,avx2
+ */
+const char* pe_reloc_impl(void);
+
+#endif
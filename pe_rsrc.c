@@ -0,0 +1,652 @@
+/**
+ *\file     pe_rsrc.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    资源表和版本信息实现
+ *          所有位置先检查在资源表或VS_VERSIONINFO范围内再读,嵌套的长度只能缩小不能超出外层
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#include "pe_rsrc.h"
+
+/// 解析结构使用的内存池
+#define ARENA(image)            ((NULL != (image)->pool) ? (image)->pool : &(image)->arena)
+
+#define RSRC_BLOCK_HEAD         6                                           ///< 版本信息块头:wLength,wValueLength,wType
+#define RSRC_KEY_MAX            64                                          ///< 版本信息块名称的最大字符数
+#define RSRC_BLOCK_MAX          256                                         ///< 一层最多处理的版本信息块数
+#define RSRC_FIXED_SIZE         52                                          ///< VS_FIXEDFILEINFO的大小
+
+/// 版本信息中的块按4字节对齐,相对于VS_VERSIONINFO开始
+#define RSRC_ALIGN(base, x)     ((base) + ((((x) - (base)) + 3) & ~3u))
+
+typedef struct _RSRC_BLOCK                                                  ///  版本信息中的一个块
+{
+    DWORD           fa;                                                     ///< 块在文件中的位置
+    DWORD           end;                                                    ///< 块结束的位置,不超过外层
+    DWORD           value_len;                                              ///< wValueLength,文本时为字符数
+    DWORD           type;                                                   ///< wType,1-文本,0-二进制
+    DWORD           key;                                                    ///< 名称在文件中的位置
+    DWORD           key_chars;                                              ///< 名称的字符数,不包括结尾的0
+    DWORD           value;                                                  ///< 值在文件中的位置
+    DWORD           child;                                                  ///< 第一个子块的位置
+
+} RSRC_BLOCK, *PRSRC_BLOCK;
+
+static const char *g_rsrc_type[] = {                                        ///< 预定义资源类型,按ID排列
+    NULL,           "CURSOR",   "BITMAP",       "ICON",         "MENU",         "DIALOG",
+    "STRING",       "FONTDIR",  "FONT",         "ACCELERATOR",  "RCDATA",       "MESSAGETABLE",
+    "GROUP_CURSOR", NULL,       "GROUP_ICON",   NULL,           "VERSION",      "DLGINCLUDE",
+    NULL,           "PLUGPLAY", "VXD",          "ANICURSOR",    "ANIICON",      "HTML",
+    "MANIFEST",
+};
+
+/**
+ *\brief                        UTF-16LE转成UTF-8,不成对的代理转成U+FFFD,dst放不下时在完整字符处截断
+ *\param[in]    src             UTF-16LE数据
+ *\param[in]    chars           字符数
+ *\param[out]   dst             UTF-8,以0结尾
+ *\param[in]    size            dst的大小
+ *\return                       UTF-8的长度
+ */
+static size_t rsrc_utf8(const UCHAR *src, size_t chars, char *dst, size_t size)
+{
+    size_t len = 0;
+
+    for (size_t i = 0; i < chars; i++)
+    {
+        DWORD c = le16(src + i * 2);
+        char  buf[4];
+        int   n;
+
+        if (c >= 0xD800 && c <= 0xDBFF && i + 1 < chars)
+        {
+            DWORD low = le16(src + i * 2 + 2);
+
+            if (low >= 0xDC00 && low <= 0xDFFF)
+            {
+                c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                i++;
+            }
+        }
+
+        if (c >= 0xD800 && c <= 0xDFFF)
+        {
+            c = 0xFFFD;
+        }
+
+        if (c < 0x80)
+        {
+            buf[0] = (char)c;
+            n = 1;
+        }
+        else if (c < 0x800)
+        {
+            buf[0] = (char)(0xC0 | (c >> 6));
+            buf[1] = (char)(0x80 | (c & 0x3F));
+            n = 2;
+        }
+        else if (c < 0x10000)
+        {
+            buf[0] = (char)(0xE0 | (c >> 12));
+            buf[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+            buf[2] = (char)(0x80 | (c & 0x3F));
+            n = 3;
+        }
+        else
+        {
+            buf[0] = (char)(0xF0 | (c >> 18));
+            buf[1] = (char)(0x80 | ((c >> 12) & 0x3F));
+            buf[2] = (char)(0x80 | ((c >> 6) & 0x3F));
+            buf[3] = (char)(0x80 | (c & 0x3F));
+            n = 4;
+        }
+
+        if (len + n >= size)
+        {
+            break;
+        }
+
+        memcpy(dst + len, buf, n);
+        len += n;
+    }
+
+    dst[len] = '\0';
+    return len;
+}
+
+int pe_rsrc_root(PPE_IMAGE image, PPE_RSRC rsrc)
+{
+    DWORD va = image->dir[PE_DIR_RSRC].VirtualAddress;
+
+    memset(rsrc, 0, sizeof(PE_RSRC));
+    rsrc->section = -1;
+
+    if (0 == va)
+    {
+        return 1; // 没有资源表
+    }
+
+    int id = pe_rva_to_fa(image, va, &rsrc->fa); // 一般在.rsrc
+
+    if (id < 0 || rsrc->fa >= image->view.size)
+    {
+        return -1;
+    }
+
+    // 数据目录中的大小常常不准,以节在文件中的结束位置为界
+    PPE_SECTION section = &image->section[id];
+    ULONGLONG   end     = (ULONGLONG)section->raw_fa + section->raw_size;
+
+    if (end > image->view.size || end <= rsrc->fa)
+    {
+        end = image->view.size;
+    }
+
+    rsrc->section = id;
+    rsrc->rva     = va;
+    rsrc->size    = (DWORD)(end - rsrc->fa);
+    return 0;
+}
+
+int pe_rsrc_dir(PPE_IMAGE image, PPE_RSRC rsrc, DWORD off, PPE_RSRC_DIR dir)
+{
+    if (off > rsrc->size || rsrc->size - off < sizeof(IMAGE_RESOURCE_DIRECTORY))
+    {
+        return -1;
+    }
+
+    const UCHAR *p = image->view.data + rsrc->fa + off;
+
+    dir->off   = off;
+    dir->time  = VIEW_FIELD32(p, IMAGE_RESOURCE_DIRECTORY, TimeDateStamp);
+    dir->major = VIEW_FIELD16(p, IMAGE_RESOURCE_DIRECTORY, MajorVersion);
+    dir->minor = VIEW_FIELD16(p, IMAGE_RESOURCE_DIRECTORY, MinorVersion);
+    dir->named = VIEW_FIELD16(p, IMAGE_RESOURCE_DIRECTORY, NumberOfNamedEntries);
+    dir->ids   = VIEW_FIELD16(p, IMAGE_RESOURCE_DIRECTORY, NumberOfIdEntries);
+    dir->count = (DWORD)dir->named + dir->ids;
+
+    DWORD room = (rsrc->size - off - sizeof(IMAGE_RESOURCE_DIRECTORY)) / sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY);
+
+    if (dir->count > room)
+    {
+        dir->count = room;
+    }
+
+    return 0;
+}
+
+void pe_rsrc_entry(PPE_IMAGE image, PPE_RSRC rsrc, PPE_RSRC_DIR dir, DWORD i, PPE_RSRC_ENTRY entry)
+{
+    DWORD        off  = dir->off + sizeof(IMAGE_RESOURCE_DIRECTORY) + i * sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY);
+    const UCHAR *p    = image->view.data + rsrc->fa + off;
+    DWORD        name = VIEW_FIELD32(p, IMAGE_RESOURCE_DIRECTORY_ENTRY, Name);
+    DWORD        data = VIEW_FIELD32(p, IMAGE_RESOURCE_DIRECTORY_ENTRY, OffsetToData);
+
+    entry->off    = off;
+    entry->named  = (name & PE_RSRC_HIGH) ? 1 : 0;
+    entry->id     = name & ~PE_RSRC_HIGH;
+    entry->dir    = (data & PE_RSRC_HIGH) ? 1 : 0;
+    entry->target = data & ~PE_RSRC_HIGH;
+}
+
+int pe_rsrc_find(PPE_IMAGE image, PPE_RSRC rsrc, PPE_RSRC_DIR dir, DWORD id, PPE_RSRC_ENTRY entry)
+{
+    DWORD low  = (dir->named < dir->count) ? dir->named : dir->count;
+    DWORD high = dir->count;
+
+    while (low < high)
+    {
+        DWORD mid = low + (high - low) / 2;
+
+        pe_rsrc_entry(image, rsrc, dir, mid, entry);
+
+        if (!entry->named && entry->id == id)
+        {
+            return 0;
+        }
+
+        if (entry->named || entry->id < id)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    // 链接器都会排序,没有找到时再顺序查找一遍,处理没有排序的文件
+    for (DWORD i = 0; i < dir->count; i++)
+    {
+        pe_rsrc_entry(image, rsrc, dir, i, entry);
+
+        if (!entry->named && entry->id == id)
+        {
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int pe_rsrc_data(PPE_IMAGE image, PPE_RSRC rsrc, DWORD off, PPE_RSRC_DATA data)
+{
+    if (off > rsrc->size || rsrc->size - off < sizeof(IMAGE_RESOURCE_DATA_ENTRY))
+    {
+        return -1;
+    }
+
+    const UCHAR *p = image->view.data + rsrc->fa + off;
+
+    data->off      = off;
+    data->rva      = VIEW_FIELD32(p, IMAGE_RESOURCE_DATA_ENTRY, OffsetToData);
+    data->size     = VIEW_FIELD32(p, IMAGE_RESOURCE_DATA_ENTRY, Size);
+    data->codepage = VIEW_FIELD32(p, IMAGE_RESOURCE_DATA_ENTRY, CodePage);
+    data->fa       = 0;
+    data->avail    = 0;
+    data->section  = pe_rva_to_fa(image, data->rva, &data->fa);
+
+    if (data->section >= 0 && data->fa < image->view.size)
+    {
+        size_t left = image->view.size - data->fa;
+
+        data->avail = (data->size < left) ? data->size : (DWORD)left;
+    }
+
+    return 0;
+}
+
+size_t pe_rsrc_name(PPE_IMAGE image, PPE_RSRC rsrc, DWORD off, char *name, size_t size)
+{
+    if (off > rsrc->size || rsrc->size - off < sizeof(WORD))
+    {
+        name[0] = '\0';
+        return 0;
+    }
+
+    const UCHAR *p     = image->view.data + rsrc->fa + off;
+    size_t       chars = le16(p);
+    size_t       room  = (rsrc->size - off - sizeof(WORD)) / 2;
+
+    chars = (chars < room) ? chars : room;
+    chars = (chars < PE_RSRC_NAME_MAX) ? chars : PE_RSRC_NAME_MAX;
+    return rsrc_utf8(p + sizeof(WORD), chars, name, size);
+}
+
+int pe_rsrc_walk(PPE_IMAGE image, PPE_RSRC rsrc, pe_rsrc_proc proc, void *param)
+{
+    PE_RSRC_DIR   dir[PE_RSRC_LEVELS];
+    PE_RSRC_ENTRY entry[PE_RSRC_LEVELS];
+    PE_RSRC_DATA  data;
+    DWORD         budget = rsrc->size / sizeof(IMAGE_RESOURCE_DIRECTORY_ENTRY); // 还可以展开的目录项数
+    int           count  = 0;
+
+    if (0 != pe_rsrc_dir(image, rsrc, 0, &dir[0]))
+    {
+        return 0;
+    }
+
+    budget -= dir[0].count; // 根目录在资源表内,不会超过
+
+    for (DWORD i = 0; i < dir[0].count; i++)
+    {
+        pe_rsrc_entry(image, rsrc, &dir[0], i, &entry[0]);
+
+        if (!entry[0].dir || 0 != pe_rsrc_dir(image, rsrc, entry[0].target, &dir[1]))
+        {
+            continue;
+        }
+
+        if (dir[1].count > budget)
+        {
+            return -1;
+        }
+
+        budget -= dir[1].count;
+
+        for (DWORD j = 0; j < dir[1].count; j++)
+        {
+            pe_rsrc_entry(image, rsrc, &dir[1], j, &entry[1]);
+
+            if (!entry[1].dir || 0 != pe_rsrc_dir(image, rsrc, entry[1].target, &dir[2]))
+            {
+                continue;
+            }
+
+            if (dir[2].count > budget)
+            {
+                return -1;
+            }
+
+            budget -= dir[2].count;
+
+            for (DWORD k = 0; k < dir[2].count; k++)
+            {
+                pe_rsrc_entry(image, rsrc, &dir[2], k, &entry[2]);
+
+                if (entry[2].dir)
+                {
+                    continue; // 超过三层的不展开
+                }
+
+                count++;
+
+                if (NULL != proc && 0 == pe_rsrc_data(image, rsrc, entry[2].target, &data))
+                {
+                    proc(param, &entry[0], &entry[1], &entry[2], &data);
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+const char* pe_rsrc_type(DWORD type)
+{
+    return (type < SIZEOF(g_rsrc_type)) ? g_rsrc_type[type] : NULL;
+}
+
+/**
+ *\brief                        沿着类型,第一个名称,第一个语言找到一项资源
+ *\param[in]    image           解析结果
+ *\param[in]    rsrc            资源表位置
+ *\param[in]    type            类型ID
+ *\param[out]   name            名称层的目录项
+ *\param[out]   lang            语言层的目录项
+ *\param[out]   data            数据项
+ *\return                       0-找到,-1-没有找到
+ */
+static int rsrc_first(PPE_IMAGE image, PPE_RSRC rsrc, DWORD type, PPE_RSRC_ENTRY name, PPE_RSRC_ENTRY lang, PPE_RSRC_DATA data)
+{
+    PE_RSRC_DIR dir;
+
+    if (0 != pe_rsrc_dir(image, rsrc, 0, &dir) || 0 != pe_rsrc_find(image, rsrc, &dir, type, name) || !name->dir)
+    {
+        return -1;
+    }
+
+    if (0 != pe_rsrc_dir(image, rsrc, name->target, &dir) || 0 == dir.count)
+    {
+        return -1;
+    }
+
+    pe_rsrc_entry(image, rsrc, &dir, 0, name);
+
+    if (!name->dir || 0 != pe_rsrc_dir(image, rsrc, name->target, &dir) || 0 == dir.count)
+    {
+        return -1;
+    }
+
+    pe_rsrc_entry(image, rsrc, &dir, 0, lang);
+
+    if (lang->dir || 0 != pe_rsrc_data(image, rsrc, lang->target, data) || 0 == data->avail)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ *\brief                        解码版本信息块头,块的长度不超过外层
+ *\param[in]    view            文件数据
+ *\param[in]    base            VS_VERSIONINFO在文件中的位置,对齐相对于这里
+ *\param[in]    fa              块在文件中的位置
+ *\param[in]    end             外层结束的位置
+ *\param[out]   block           块
+ *\return                       0-成功,-1-长度不对
+ */
+static int rsrc_block(PPE_VIEW view, DWORD base, DWORD fa, DWORD end, PRSRC_BLOCK block)
+{
+    if (fa > end || end - fa < RSRC_BLOCK_HEAD)
+    {
+        return -1;
+    }
+
+    const UCHAR *p   = view->data + fa;
+    DWORD        len = le16(p);
+
+    if (len < RSRC_BLOCK_HEAD)
+    {
+        return -1;
+    }
+
+    block->fa        = fa;
+    block->end       = (len < end - fa) ? fa + len : end;
+    block->value_len = le16(p + 2);
+    block->type      = le16(p + 4);
+    block->key       = fa + RSRC_BLOCK_HEAD;
+    block->key_chars = 0;
+
+    while (block->key + block->key_chars * 2 + 2 <= block->end &&
+           0 != le16(view->data + block->key + block->key_chars * 2))
+    {
+        block->key_chars++;
+    }
+
+    DWORD value_bytes = (1 == block->type) ? block->value_len * 2 : block->value_len;
+
+    block->value = RSRC_ALIGN(base, block->key + block->key_chars * 2 + 2);
+    block->value = (block->value < block->end) ? block->value : block->end;
+    block->child = (value_bytes < block->end - block->value) ? RSRC_ALIGN(base, block->value + value_bytes) : block->end;
+    block->child = (block->child < block->end) ? block->child : block->end;
+    return 0;
+}
+
+/**
+ *\brief                        比较版本信息块的名称
+ *\param[in]    view            文件数据
+ *\param[in]    block           块
+ *\param[in]    key             ASCII名称
+ *\return                       1-相同,0-不同
+ */
+static int rsrc_key_is(PPE_VIEW view, PRSRC_BLOCK block, const char *key)
+{
+    size_t len = strlen(key);
+
+    if (block->key_chars != len)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        if (le16(view->data + block->key + i * 2) != (UCHAR)key[i])
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ *\brief                        版本信息中的文本转成UTF-8,从内存池分配
+ *\param[in]    image           解析结果
+ *\param[in]    fa              文本在文件中的位置
+ *\param[in]    end             最多到这里
+ *\param[in]    max             最多转换的字符数
+ *\return                       UTF-8字符串,NULL为内存不足
+ */
+static char* rsrc_text(PPE_IMAGE image, DWORD fa, DWORD end, DWORD max)
+{
+    DWORD chars = 0;
+
+    while (chars < max && fa + chars * 2 + 2 <= end && 0 != le16(image->view.data + fa + chars * 2))
+    {
+        chars++;
+    }
+
+    size_t size = (size_t)chars * 3 + 1; // BMP字符最多3字节,代理对4字节对应2个字符
+    char  *text = pe_arena_alloc(ARENA(image), size);
+
+    if (NULL != text)
+    {
+        rsrc_utf8(image->view.data + fa, chars, text, size);
+    }
+
+    return text;
+}
+
+/**
+ *\brief                        解码第一个StringTable中的字符串
+ *\param[in]    image           解析结果
+ *\param[in]    version         版本信息
+ *\param[in]    table           StringTable块
+ *\return                       0-成功,-1-内存不足
+ */
+static int rsrc_strings(PPE_IMAGE image, PPE_VERSION version, PRSRC_BLOCK table)
+{
+    PPE_VIEW   view = &image->view;
+    RSRC_BLOCK block;
+    DWORD      count = 0;
+    DWORD      fa;
+
+    if (table->key_chars > 0)
+    {
+        rsrc_utf8(view->data + table->key, table->key_chars, version->table, sizeof(version->table));
+    }
+
+    for (fa = table->child; count < PE_VERSION_STRINGS_MAX && 0 == rsrc_block(view, version->info_fa, fa, table->end, &block); count++)
+    {
+        fa = RSRC_ALIGN(version->info_fa, block.end);
+    }
+
+    if (0 == count)
+    {
+        return 0;
+    }
+
+    version->str = pe_arena_array(ARENA(image), count, sizeof(PE_VERSION_STRING));
+
+    if (NULL == version->str)
+    {
+        return -1;
+    }
+
+    fa = table->child;
+
+    for (DWORD i = 0; i < count; i++)
+    {
+        PPE_VERSION_STRING str = &version->str[i];
+
+        rsrc_block(view, version->info_fa, fa, table->end, &block);
+        str->key   = rsrc_text(image, block.key, block.end, RSRC_KEY_MAX);
+        str->value = rsrc_text(image, block.value, block.end, PE_VERSION_VALUE_MAX);
+
+        if (NULL == str->key || NULL == str->value)
+        {
+            return -1;
+        }
+
+        fa = RSRC_ALIGN(version->info_fa, block.end);
+    }
+
+    version->str_count = count;
+    return 0;
+}
+
+/**
+ *\brief                        解码VS_VERSIONINFO
+ *\param[in]    image           解析结果
+ *\param[in]    version         版本信息,info_fa和info_size已填写
+ *\return                       0-成功,-1-内存不足
+ */
+static int rsrc_info(PPE_IMAGE image, PPE_VERSION version)
+{
+    PPE_VIEW   view = &image->view;
+    DWORD      base = version->info_fa;
+    RSRC_BLOCK root;
+    RSRC_BLOCK block;
+
+    if (0 != rsrc_block(view, base, base, base + version->info_size, &root) || !rsrc_key_is(view, &root, "VS_VERSION_INFO"))
+    {
+        return 0; // 不是VS_VERSIONINFO,只记录位置
+    }
+
+    if (root.value_len >= RSRC_FIXED_SIZE && root.end - root.value >= RSRC_FIXED_SIZE &&
+        PE_VERSION_SIGNATURE == le32(view->data + root.value))
+    {
+        const UCHAR *fixed = view->data + root.value;
+
+        version->fixed      = 1;
+        version->file_ms    = le32(fixed + 8);
+        version->file_ls    = le32(fixed + 12);
+        version->product_ms = le32(fixed + 16);
+        version->product_ls = le32(fixed + 20);
+        version->file_flags = le32(fixed + 28) & le32(fixed + 24);
+        version->file_os    = le32(fixed + 32);
+        version->file_type  = le32(fixed + 36);
+    }
+
+    DWORD fa = root.child;
+
+    for (int n = 0; n < RSRC_BLOCK_MAX && 0 == rsrc_block(view, base, fa, root.end, &block); n++)
+    {
+        RSRC_BLOCK table;
+
+        if (rsrc_key_is(view, &block, "StringFileInfo") && 0 == rsrc_block(view, base, block.child, block.end, &table))
+        {
+            return rsrc_strings(image, version, &table);
+        }
+
+        fa = RSRC_ALIGN(base, block.end);
+    }
+
+    return 0;
+}
+
+int pe_version(PPE_IMAGE image, DWORD flags)
+{
+    PPE_VERSION version = pe_arena_alloc(ARENA(image), sizeof(PE_VERSION));
+
+    if (NULL == version)
+    {
+        return -1;
+    }
+
+    memset(version, 0, sizeof(PE_VERSION));
+    version->flags = flags;
+
+    PE_RSRC       rsrc;
+    PE_RSRC_ENTRY name;
+    PE_RSRC_ENTRY lang;
+    PE_RSRC_DATA  data;
+
+    if (0 == pe_rsrc_root(image, &rsrc))
+    {
+        if ((flags & PE_VERSION_INFO) && 0 == rsrc_first(image, &rsrc, PE_RT_VERSION, &name, &lang, &data))
+        {
+            version->info      = 1;
+            version->info_fa   = data.fa;
+            version->info_size = data.avail;
+            version->info_lang = lang.id;
+
+            if (0 != rsrc_info(image, version))
+            {
+                return -2;
+            }
+        }
+
+        if ((flags & PE_VERSION_MANIFEST) && 0 == rsrc_first(image, &rsrc, PE_RT_MANIFEST, &name, &lang, &data))
+        {
+            version->manifest      = 1;
+            version->manifest_id   = name.named ? 0 : name.id;
+            version->manifest_fa   = data.fa;
+            version->manifest_size = data.avail;
+        }
+    }
+
+    image->version = version;
+    return 0;
+}
+
+char* pe_version_text(DWORD ms, DWORD ls, char *text)
+{
+    sprintf(text, "%u.%u.%u.%u", ms >> 16, ms & 0xFFFF, ls >> 16, ls & 0xFFFF);
+    return text;
+}
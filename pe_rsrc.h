@@ -0,0 +1,222 @@
+/**
+ *\file     pe_rsrc.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    资源表和版本信息
+ *          资源表是三层目录(类型,名称,语言),每层目录头后面先是按名称排序的名称项,再是按ID排序的ID项,
+ *          目录项和名称的位置都相对于资源表开始,数据项中是数据的相对虚拟地址.
+ *          解析时不展开资源表,使用时从数据目录找到资源表,按位置解码一个目录,一个目录项或一个数据项,
+ *          树形输出只展开打开的那一层.
+ *          版本信息只取RT_VERSION和RT_MANIFEST:在类型层按ID二分查找,名称层和语言层取第一项,
+ *          不遍历其它资源;VS_VERSIONINFO只解码VS_FIXEDFILEINFO和第一个StringTable中的字符串
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#ifndef _PE_RSRC_H_
+#define _PE_RSRC_H_
+
+#include "pe.h"
+
+#define PE_RSRC_LEVELS          3                                           ///< 目录层数:类型,名称,语言
+#define PE_RSRC_HIGH            0x80000000                                  ///< 目录项的名称是字符串,或指向下一层目录
+#define PE_RSRC_NAME_MAX        256                                         ///< 资源名称最多转换的字符数
+
+#define PE_RT_ICON              3                                           ///< 图标
+#define PE_RT_VERSION           16                                          ///< 版本信息
+#define PE_RT_MANIFEST          24                                          ///< 清单
+
+#define PE_VERSION_INFO         0x01                                        ///< VS_VERSIONINFO
+#define PE_VERSION_MANIFEST     0x02                                        ///< 清单
+#define PE_VERSION_ALL          0x03                                        ///< 所有项
+
+#define PE_VERSION_SIGNATURE    0xFEEF04BD                                  ///< VS_FIXEDFILEINFO的标记
+#define PE_VERSION_STRINGS_MAX  64                                          ///< 最多取的字符串数
+#define PE_VERSION_VALUE_MAX    1024                                        ///< 字符串最多转换的字符数
+#define PE_VERSION_MANIFEST_MAX 0xFFFF                                      ///< 输出清单的最大字节数
+
+typedef struct _PE_RSRC                                                     ///  资源表位置
+{
+    int             section;                                                ///< 资源表所在节
+    DWORD           rva;                                                    ///< 资源表的相对虚拟地址
+    DWORD           fa;                                                     ///< 资源表在文件中的位置,目录项中的位置都相对于这里
+    DWORD           size;                                                   ///< 可以读的长度,不超过文件
+
+} PE_RSRC, *PPE_RSRC;
+
+typedef struct _PE_RSRC_DIR                                                 ///  资源目录
+{
+    DWORD           off;                                                    ///< 目录头相对资源表的位置
+    DWORD           time;                                                   ///< 时间
+    WORD            major;                                                  ///< 主版本号
+    WORD            minor;                                                  ///< 次版本号
+    WORD            named;                                                  ///< 名称项数量,名称项在ID项之前
+    WORD            ids;                                                    ///< ID项数量
+    DWORD           count;                                                  ///< 在资源表范围内的目录项数量
+
+} PE_RSRC_DIR, *PPE_RSRC_DIR;
+
+typedef struct _PE_RSRC_ENTRY                                               ///  资源目录项
+{
+    DWORD           off;                                                    ///< 目录项相对资源表的位置
+    int             named;                                                  ///< 1-名称是字符串
+    DWORD           id;                                                     ///< ID,名称是字符串时为名称相对资源表的位置
+    int             dir;                                                    ///< 1-指向下一层目录,0-指向数据项
+    DWORD           target;                                                 ///< 下一层目录或数据项相对资源表的位置
+
+} PE_RSRC_ENTRY, *PPE_RSRC_ENTRY;
+
+typedef struct _PE_RSRC_DATA                                                ///  资源数据项
+{
+    DWORD           off;                                                    ///< 数据项相对资源表的位置
+    DWORD           rva;                                                    ///< 数据的相对虚拟地址
+    DWORD           size;                                                   ///< 数据大小
+    DWORD           codepage;                                               ///< 代码页
+    int             section;                                                ///< 数据所在节,-1为不在任何节中
+    DWORD           fa;                                                     ///< 数据在文件中的位置
+    DWORD           avail;                                                  ///< 文件中实际有的数据长度,不超过size
+
+} PE_RSRC_DATA, *PPE_RSRC_DATA;
+
+typedef struct _PE_VERSION_STRING                                           ///  StringTable中的一个字符串
+{
+    const char     *key;                                                    ///< 名称,UTF-8
+    const char     *value;                                                  ///< 值,UTF-8
+
+} PE_VERSION_STRING, *PPE_VERSION_STRING;
+
+typedef struct _PE_VERSION                                                  ///  版本信息和清单
+{
+    DWORD           flags;                                                  ///< 计算了哪几项,PE_VERSION_*
+    int             info;                                                   ///< 1-有VS_VERSIONINFO
+    DWORD           info_fa;                                                ///< VS_VERSIONINFO在文件中的位置
+    DWORD           info_size;                                              ///< VS_VERSIONINFO的长度
+    DWORD           info_lang;                                              ///< 资源的语言ID
+    int             fixed;                                                  ///< 1-有VS_FIXEDFILEINFO
+    DWORD           file_ms;                                                ///< 文件版本高32位
+    DWORD           file_ls;                                                ///< 文件版本低32位
+    DWORD           product_ms;                                             ///< 产品版本高32位
+    DWORD           product_ls;                                             ///< 产品版本低32位
+    DWORD           file_flags;                                             ///< dwFileFlags & dwFileFlagsMask
+    DWORD           file_os;                                                ///< 操作系统
+    DWORD           file_type;                                              ///< 文件类型
+    char            table[12];                                              ///< 第一个StringTable的名称(语言和代码页),UTF-8
+    PPE_VERSION_STRING str;                                                 ///< StringTable中的字符串
+    DWORD           str_count;                                              ///< 字符串数量
+    int             manifest;                                               ///< 1-有清单
+    DWORD           manifest_id;                                            ///< 清单的资源ID,1为exe,2为dll
+    DWORD           manifest_fa;                                            ///< 清单在文件中的位置
+    DWORD           manifest_size;                                          ///< 清单在文件中的长度
+
+} PE_VERSION, *PPE_VERSION;
+
+/**
+ *\brief                        找到资源表
+ *\param[in]    image           解析结果
+ *\param[out]   rsrc            资源表位置
+ *\return                       0-有资源表,1-没有资源表,-1-资源表不在任何节中或超出文件
+ */
+int pe_rsrc_root(PPE_IMAGE image, PPE_RSRC rsrc);
+
+/**
+ *\brief                        解码一个资源目录头
+ *\param[in]    image           解析结果
+ *\param[in]    rsrc            资源表位置
+ *\param[in]    off             目录头相对资源表的位置,根目录为0
+ *\param[out]   dir             目录,目录项数量只算资源表范围内的
+ *\return                       0-成功,-1-超出资源表
+ */
+int pe_rsrc_dir(PPE_IMAGE image, PPE_RSRC rsrc, DWORD off, PPE_RSRC_DIR dir);
+
+/**
+ *\brief                        解码一个资源目录项
+ *\param[in]    image           解析结果
+ *\param[in]    rsrc            资源表位置
+ *\param[in]    dir             目录
+ *\param[in]    i               目录项序号,小于dir->count
+ *\param[out]   entry           目录项
+ *\return                       无
+ */
+void pe_rsrc_entry(PPE_IMAGE image, PPE_RSRC rsrc, PPE_RSRC_DIR dir, DWORD i, PPE_RSRC_ENTRY entry);
+
+/**
+ *\brief                        在目录的ID项中二分查找,ID项没有排序时顺序查找
+ *\param[in]    image           解析结果
+ *\param[in]    rsrc            资源表位置
+ *\param[in]    dir             目录
+ *\param[in]    id              ID
+ *\param[out]   entry           目录项
+ *\return                       0-找到,-1-没有找到
+ */
+int pe_rsrc_find(PPE_IMAGE image, PPE_RSRC rsrc, PPE_RSRC_DIR dir, DWORD id, PPE_RSRC_ENTRY entry);
+
+/**
+ *\brief                        解码一个资源数据项,通过节表找到数据在文件中的位置
+ *\param[in]    image           解析结果
+ *\param[in]    rsrc            资源表位置
+ *\param[in]    off             数据项相对资源表的位置
+ *\param[out]   data            数据项
+ *\return                       0-成功,-1-数据项超出资源表
+ */
+int pe_rsrc_data(PPE_IMAGE image, PPE_RSRC rsrc, DWORD off, PPE_RSRC_DATA data);
+
+/**
+ *\brief                        资源名称转成UTF-8,名称是长度(WORD)加UTF-16字符
+ *\param[in]    image           解析结果
+ *\param[in]    rsrc            资源表位置
+ *\param[in]    off             名称相对资源表的位置
+ *\param[out]   name            名称,最多PE_RSRC_NAME_MAX个字符,以0结尾
+ *\param[in]    size            name的大小
+ *\return                       UTF-8的长度
+ */
+size_t pe_rsrc_name(PPE_IMAGE image, PPE_RSRC rsrc, DWORD off, char *name, size_t size);
+
+/**
+ *\brief                        得到预定义资源类型的名称
+ *\param[in]    type            类型ID
+ *\return                       名称,不是预定义类型时为NULL
+ */
+const char* pe_rsrc_type(DWORD type);
+
+/**
+ *\brief                        遍历资源的回调函数
+ *\param[in]    param           回调参数
+ *\param[in]    type            类型层的目录项
+ *\param[in]    name            名称层的目录项
+ *\param[in]    lang            语言层的目录项
+ *\param[in]    data            数据项
+ *\return                       无
+ */
+typedef void (*pe_rsrc_proc)(void *param, PPE_RSRC_ENTRY type, PPE_RSRC_ENTRY name, PPE_RSRC_ENTRY lang, PPE_RSRC_DATA data);
+
+/**
+ *\brief                        遍历三层目录下的所有数据项.
+ *                              正常的资源表中每个目录项占8字节,总数不超过资源表大小/8,
+ *                              多个目录项指向同一个目录时展开的数量会成倍增加,超过时停止并返回-1
+ *\param[in]    image           解析结果
+ *\param[in]    rsrc            资源表位置
+ *\param[in]    proc            回调函数,NULL时只计数,不解码数据项
+ *\param[in]    param           回调参数
+ *\return                       数据项数,-1为目录项总数超过资源表大小/8
+ */
+int pe_rsrc_walk(PPE_IMAGE image, PPE_RSRC rsrc, pe_rsrc_proc proc, void *param);
+
+/**
+ *\brief                        取版本信息和清单,结果从解析结果的内存池分配,保存到image->version
+ *\param[in]    image           解析结果
+ *\param[in]    flags           需要的项,PE_VERSION_*
+ *\return                       0-成功,其它失败(内存不足)
+ */
+int pe_version(PPE_IMAGE image, DWORD flags);
+
+/**
+ *\brief                        版本号转成a.b.c.d
+ *\param[in]    ms              高32位
+ *\param[in]    ls              低32位
+ *\param[out]   text            至少24字节
+ *\return                       text
+ */
+char* pe_version_text(DWORD ms, DWORD ls, char *text);
+
+#endif
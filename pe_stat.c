@@ -0,0 +1,199 @@
+/**
+ *\file     pe_stat.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    分阶段计时和计数实现
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加版本信息阶段
+ *          2026.10.18|增加调试目录阶段
+ *          2026.10.18|增加签名阶段
+ *          2026.10.18|没有线程的缺页次数时缺页列为-,不输出缺页指标
+ */
+#include "pe_stat.h"
+
+#ifndef PE_STAT_OFF
+THREAD_LOCAL PPE_STAT g_pe_stat = NULL;
+#endif
+
+static const char *g_pe_stat_name[PE_STAT_STAGES] = {
+    "load", "head", "section", "export", "import", "reloc", "digest", "finger", "version", "debug", "auth", "output"
+};
+
+void pe_stat_bind(PPE_STAT stat)
+{
+#ifndef PE_STAT_OFF
+    g_pe_stat = stat;
+#else
+    (void)stat;
+#endif
+}
+
+void pe_stat_sample(PPE_STAT_MARK mark)
+{
+    mark->wall = time_now();
+    thread_usage(&mark->cpu, &mark->faults);
+}
+
+void pe_stat_lap(PPE_STAT_MARK mark, int id, ULONGLONG items, ULONGLONG bytes)
+{
+    PE_STAT_MARK   now   = *mark;
+    PPE_STAT_STAGE stage = &mark->stat->stage[id];
+
+    pe_stat_sample(&now);
+
+    stage->calls++;
+    stage->wall   += now.wall - mark->wall;
+    stage->cpu    += now.cpu - mark->cpu;
+    stage->items  += items;
+    stage->bytes  += bytes;
+    stage->faults += now.faults - mark->faults;
+
+    *mark = now;
+}
+
+void pe_stat_merge(PPE_STAT dst, const PE_STAT *src)
+{
+    for (int i = 0; i < PE_STAT_STAGES; i++)
+    {
+        dst->stage[i].calls  += src->stage[i].calls;
+        dst->stage[i].wall   += src->stage[i].wall;
+        dst->stage[i].cpu    += src->stage[i].cpu;
+        dst->stage[i].items  += src->stage[i].items;
+        dst->stage[i].bytes  += src->stage[i].bytes;
+        dst->stage[i].faults += src->stage[i].faults;
+    }
+}
+
+const char* pe_stat_name(int id)
+{
+    return (id >= 0 && id < PE_STAT_STAGES) ? g_pe_stat_name[id] : "?";
+}
+
+void pe_stat_print(FILE *fp, const PE_STAT *stat)
+{
+    double total = 0;
+
+    for (int i = 0; i < PE_STAT_STAGES; i++)
+    {
+        total += stat->stage[i].wall;
+    }
+
+    total = (total > 0) ? total : 1e-9;
+
+    // 时间是各线程之和,百分比为占所有阶段之和的比例
+    fprintf(fp, "%-8s %10s %10s %6s %10s %12s %12s %10s %10s\n",
+            "stage", "calls", "wall(s)", "wall%", "cpu(s)", "items", "bytes", "faults", "us/call");
+
+    for (int i = 0; i < PE_STAT_STAGES; i++)
+    {
+        const PE_STAT_STAGE *stage      = &stat->stage[i];
+        char                 faults[24] = "-"; // 没有线程的缺页次数时进程的缺页次数只在结尾输出一次
+
+        if (0 == stage->calls)
+        {
+            continue;
+        }
+
+        if (THREAD_FAULTS)
+        {
+            snprintf(faults, sizeof(faults), "%llu", (unsigned long long)stage->faults);
+        }
+
+        fprintf(fp, "%-8s %10llu %10.4f %6.1f %10.4f %12llu %12llu %10s %10.2f\n",
+                g_pe_stat_name[i],
+                (unsigned long long)stage->calls,
+                stage->wall,
+                stage->wall * 100 / total,
+                stage->cpu,
+                (unsigned long long)stage->items,
+                (unsigned long long)stage->bytes,
+                faults,
+                stage->wall * 1e6 / stage->calls);
+    }
+}
+
+int pe_stat_prom(const char *path, const PE_STAT *stat, int threads, double secs)
+{
+    static const struct { const char *name; const char *help; } metric[] = {
+        { "peinfo_stage_calls_total",       "Number of times each stage ran." },
+        { "peinfo_stage_seconds_total",     "Wall time spent in each stage, summed over threads." },
+        { "peinfo_stage_cpu_seconds_total", "Thread CPU time spent in each stage, summed over threads." },
+        { "peinfo_stage_items_total",       "Entries decoded in each stage." },
+        { "peinfo_stage_bytes_total",       "Bytes touched in each stage." },
+        { "peinfo_stage_page_faults_total", "Page faults taken in each stage." },
+    };
+
+    size_t len = strlen(path);
+    char  *tmp = malloc(len + 5);
+    int    ret = 0;
+
+    if (NULL == tmp)
+    {
+        return -1;
+    }
+
+    sprintf(tmp, "%s.tmp", path);
+
+    FILE *fp = file_open(tmp, "wb"); // 换行只能是\n
+
+    if (NULL == fp)
+    {
+        free(tmp);
+        return -2;
+    }
+
+    fprintf(fp, "# HELP peinfo_scan_seconds Wall time of the whole scan.\n"
+                "# TYPE peinfo_scan_seconds gauge\n"
+                "peinfo_scan_seconds %.6f\n"
+                "# HELP peinfo_scan_threads Number of worker threads.\n"
+                "# TYPE peinfo_scan_threads gauge\n"
+                "peinfo_scan_threads %d\n", secs, threads);
+
+    for (size_t m = 0; m < SIZEOF(metric) - !THREAD_FAULTS; m++) // 缺页指标在最后,没有线程的缺页次数时不输出
+    {
+        fprintf(fp, "# HELP %s %s\n# TYPE %s counter\n", metric[m].name, metric[m].help, metric[m].name);
+
+        for (int i = 0; i < PE_STAT_STAGES; i++)
+        {
+            const PE_STAT_STAGE *stage = &stat->stage[i];
+
+            fprintf(fp, "%s{stage=\"%s\"} ", metric[m].name, g_pe_stat_name[i]);
+
+            switch (m)
+            {
+            case 0:  fprintf(fp, "%llu\n", (unsigned long long)stage->calls);  break;
+            case 1:  fprintf(fp, "%.6f\n", stage->wall);                       break;
+            case 2:  fprintf(fp, "%.6f\n", stage->cpu);                        break;
+            case 3:  fprintf(fp, "%llu\n", (unsigned long long)stage->items);  break;
+            case 4:  fprintf(fp, "%llu\n", (unsigned long long)stage->bytes);  break;
+            default: fprintf(fp, "%llu\n", (unsigned long long)stage->faults); break;
+            }
+        }
+    }
+
+    if (ferror(fp))
+    {
+        ret = -3;
+    }
+
+    if (0 != fclose(fp) && 0 == ret)
+    {
+        ret = -4;
+    }
+
+    if (0 == ret && 0 != file_rename(tmp, path))
+    {
+        ret = -5;
+    }
+
+    if (0 != ret)
+    {
+        remove(tmp);
+    }
+
+    free(tmp);
+    return ret;
+}
@@ -0,0 +1,144 @@
+/**
+ *\file     pe_stat.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    分阶段计时和计数
+ *          每个线程绑定自己的PE_STAT,计数时不加锁,结束时合并后输出表格和Prometheus文本格式.
+ *          阶段开始时取一次墙上时间,线程CPU时间和缺页次数,结束时再取一次,差值计入该阶段,
+ *          同时作为下一阶段的开始;线程没有绑定时只判断一次指针,数据项数和字节数的表达式不求值.
+ *          编译时定义PE_STAT_OFF去掉所有计时代码
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加版本信息阶段
+ *          2026.10.18|增加调试目录阶段
+ *          2026.10.18|增加签名阶段
+ *          2026.10.18|没有线程的缺页次数时不输出缺页列
+ */
+#ifndef _PE_STAT_H_
+#define _PE_STAT_H_
+
+#include "platform.h"
+
+#define PE_STAT_LOAD            0                                           ///< 读取文件
+#define PE_STAT_HEAD            1                                           ///< DOS头和NT头
+#define PE_STAT_SECTION         2                                           ///< 节表
+#define PE_STAT_EXPORT          3                                           ///< 导出表
+#define PE_STAT_IMPORT          4                                           ///< 导入表
+#define PE_STAT_RELOC           5                                           ///< 重定位表
+#define PE_STAT_DIGEST          6                                           ///< 节的熵和摘要
+#define PE_STAT_FINGER          7                                           ///< 导入表散列和Rich头
+#define PE_STAT_VERSION         8                                           ///< 版本信息和清单
+#define PE_STAT_DEBUG           9                                           ///< 调试目录
+#define PE_STAT_AUTH            10                                          ///< Authenticode签名和摘要
+#define PE_STAT_OUTPUT          11                                          ///< 输出记录和树
+#define PE_STAT_STAGES          12                                          ///< 阶段数
+
+typedef struct _PE_STAT_STAGE                                               ///  一个阶段的累计值
+{
+    ULONGLONG       calls;                                                  ///< 次数
+    double          wall;                                                   ///< 墙上时间,秒
+    double          cpu;                                                    ///< 线程CPU时间,秒
+    ULONGLONG       items;                                                  ///< 解码的数据项数
+    ULONGLONG       bytes;                                                  ///< 读过的字节数
+    ULONGLONG       faults;                                                 ///< 缺页次数,THREAD_FAULTS为0时没有
+
+} PE_STAT_STAGE, *PPE_STAT_STAGE;
+
+typedef struct _PE_STAT                                                     ///  各阶段的累计值,每个线程一份
+{
+    PE_STAT_STAGE   stage[PE_STAT_STAGES];                                  ///< 按PE_STAT_*排列
+
+} PE_STAT, *PPE_STAT;
+
+typedef struct _PE_STAT_MARK                                                ///  上一次取样
+{
+    PPE_STAT        stat;                                                   ///< 计入的统计,NULL为不计时
+    double          wall;                                                   ///< 墙上时间
+    double          cpu;                                                    ///< 线程CPU时间
+    size_t          faults;                                                 ///< 缺页次数
+
+} PE_STAT_MARK, *PPE_STAT_MARK;
+
+#ifndef PE_STAT_OFF
+
+extern THREAD_LOCAL PPE_STAT g_pe_stat;                                     ///< 当前线程绑定的统计,NULL为不计时
+
+/// 开始计时,声明取样变量,当前线程没有绑定统计时不取样
+#define PE_STAT_START(mark)     PE_STAT_MARK mark = { g_pe_stat, 0, 0, 0 }; \
+                                do { if (NULL != (mark).stat) pe_stat_sample(&(mark)); } while (0)
+
+/// 上次取样到现在计入一个阶段并重新取样,不计时时items和bytes不求值
+#define PE_STAT_LAP(mark, id, items, bytes) \
+                                do { if (NULL != (mark).stat) pe_stat_lap(&(mark), (id), (items), (bytes)); } while (0)
+
+/// 重新取样,上次取样到现在不计入任何阶段
+#define PE_STAT_SKIP(mark)      do { if (NULL != (mark).stat) pe_stat_sample(&(mark)); } while (0)
+
+#else
+
+#define PE_STAT_START(mark)
+#define PE_STAT_LAP(mark, id, items, bytes)
+#define PE_STAT_SKIP(mark)
+
+#endif
+
+/**
+ *\brief                        当前线程绑定统计,之后本线程的计时计入stat
+ *\param[in]    stat            统计,NULL为不计时
+ *\return                       无
+ */
+void pe_stat_bind(PPE_STAT stat);
+
+/**
+ *\brief                        取样,记下墙上时间,线程CPU时间和缺页次数
+ *\param[out]   mark            取样结果
+ *\return                       无
+ */
+void pe_stat_sample(PPE_STAT_MARK mark);
+
+/**
+ *\brief                        上次取样到现在计入一个阶段并重新取样
+ *\param[in,out] mark           上次取样
+ *\param[in]    id              阶段,PE_STAT_*
+ *\param[in]    items           数据项数
+ *\param[in]    bytes           字节数
+ *\return                       无
+ */
+void pe_stat_lap(PPE_STAT_MARK mark, int id, ULONGLONG items, ULONGLONG bytes);
+
+/**
+ *\brief                        合并统计
+ *\param[in,out] dst            合计
+ *\param[in]    src             一个线程的统计
+ *\return                       无
+ */
+void pe_stat_merge(PPE_STAT dst, const PE_STAT *src);
+
+/**
+ *\brief                        得到阶段名称
+ *\param[in]    id              阶段,PE_STAT_*
+ *\return                       名称
+ */
+const char* pe_stat_name(int id);
+
+/**
+ *\brief                        输出表格,没有次数的阶段不输出
+ *\param[in]    fp              输出文件
+ *\param[in]    stat            合计
+ *\return                       无
+ */
+void pe_stat_print(FILE *fp, const PE_STAT *stat);
+
+/**
+ *\brief                        写入Prometheus文本格式文件,先写临时文件再替换,读取方不会看到写了一半的文件
+ *\param[in]    path            文件路径
+ *\param[in]    stat            合计
+ *\param[in]    threads         线程数
+ *\param[in]    secs            总时间,秒
+ *\return                       0-成功,其它失败
+ */
+int pe_stat_prom(const char *path, const PE_STAT *stat, int threads, double secs);
+
+#endif
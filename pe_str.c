@@ -0,0 +1,461 @@
+/**
+ *\file     pe_str.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    文件中字符串的提取实现
+ *          向量实现一次取16或32字节,分别比较得到0,不可显示字符(小于0x20,0x7f,按有符号比较时0x80以上为负数),
+ *          引号和反斜杠的位掩码,找到0后只看0之前的位.只读取不超过max的完整块,剩下的字节逐个检查.
+ *          追加时每块先写入目标再检查0,不需要先找到结尾再复制.
+ *          宽字符转换时整块都是ASCII的直接与0交错展开,其它字节逐个按UTF-8解码
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|实现在启动线程前选择,不在使用时选择
+ */
+#include "pe_str.h"
+
+#define STR_BAD                 (PE_STR_ASCII | PE_STR_PLAIN)               ///< 有不可显示字符时清除的标志
+#define STR_REPLACE             0xFFFD                                      ///< 无效UTF-8字节的替换字符
+
+typedef size_t (*str_scan_proc)(const UCHAR *src, size_t max, DWORD *flags);
+
+typedef size_t (*str_copy_proc)(char *dst, const UCHAR *src, size_t max);
+
+typedef size_t (*str_widen_proc)(const UCHAR *src, size_t len, WORD *dst, size_t size);
+
+/**
+ *\brief                        逐字节查找字符串结尾和检查字符
+ *\param[in]    src             字符串
+ *\param[in]    max             最多检查的字节数
+ *\param[out]   flags           PE_STR_*
+ *\return                       长度
+ */
+static size_t str_scan_scalar(const UCHAR *src, size_t max, DWORD *flags)
+{
+    DWORD  f = PE_STR_ASCII | PE_STR_PLAIN;
+    size_t i = 0;
+
+    for (; i < max && '\0' != src[i]; i++)
+    {
+        if (src[i] < 0x20 || src[i] > 0x7e)
+        {
+            f &= ~STR_BAD;
+        }
+        else if ('"' == src[i] || '\\' == src[i])
+        {
+            f &= ~PE_STR_PLAIN;
+        }
+    }
+
+    *flags = (i == max) ? (f | PE_STR_CUT) : f;
+    return i;
+}
+
+/**
+ *\brief                        逐字节复制到结尾的0
+ *\param[out]   dst             目标,至少max字节,不写结尾的0
+ *\param[in]    src             字符串
+ *\param[in]    max             最多复制的字节数
+ *\return                       长度
+ */
+static size_t str_copy_scalar(char *dst, const UCHAR *src, size_t max)
+{
+    size_t i = 0;
+
+    for (; i < max && '\0' != src[i]; i++)
+    {
+        dst[i] = (char)src[i];
+    }
+
+    return i;
+}
+
+/**
+ *\brief                        解码一个UTF-8字符
+ *\param[in]    src             字符串
+ *\param[in]    len             长度,大于0
+ *\param[out]   code            字符,无效时为STR_REPLACE
+ *\return                       使用的字节数
+ */
+static size_t str_utf8(const UCHAR *src, size_t len, DWORD *code)
+{
+    DWORD  c    = src[0];
+    DWORD  min  = 0;
+    size_t need = 0;
+
+    if (c < 0x80)
+    {
+        *code = c;
+        return 1;
+    }
+
+    if (c >= 0xc2 && c <= 0xdf)
+    {
+        c &= 0x1f, min = 0x80, need = 1;
+    }
+    else if (c >= 0xe0 && c <= 0xef)
+    {
+        c &= 0x0f, min = 0x800, need = 2;
+    }
+    else if (c >= 0xf0 && c <= 0xf4)
+    {
+        c &= 0x07, min = 0x10000, need = 3;
+    }
+    else
+    {
+        *code = STR_REPLACE;
+        return 1;
+    }
+
+    for (size_t i = 1; i <= need; i++)
+    {
+        if (i >= len || 0x80 != (src[i] & 0xc0)) // 不完整的序列替换为一个字符,从下一个非后续字节继续
+        {
+            *code = STR_REPLACE;
+            return i;
+        }
+
+        c = (c << 6) | (src[i] & 0x3f);
+    }
+
+    *code = (c < min || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff)) ? STR_REPLACE : c;
+    return need + 1;
+}
+
+/**
+ *\brief                        逐字符转为UTF-16
+ *\param[in]    src             UTF-8字符串
+ *\param[in]    len             长度
+ *\param[in]    stop            转换到这个位置为止,最后一个字符可以超过
+ *\param[out]   dst             UTF-16字符串,不写结尾的0
+ *\param[in]    size            dst长度
+ *\param[out]   used            使用的src字节数
+ *\return                       转换后的长度
+ */
+static size_t str_widen_tail(const UCHAR *src, size_t len, size_t stop, WORD *dst, size_t size, size_t *used)
+{
+    size_t i = 0;
+    size_t n = 0;
+
+    stop = (stop < len) ? stop : len;
+
+    while (i < stop && n < size)
+    {
+        DWORD  code;
+        size_t step = str_utf8(src + i, len - i, &code);
+
+        if (code < 0x10000)
+        {
+            dst[n++] = (WORD)code;
+        }
+        else if (n + 2 <= size)
+        {
+            code    -= 0x10000;
+            dst[n++] = (WORD)(0xd800 | (code >> 10));
+            dst[n++] = (WORD)(0xdc00 | (code & 0x3ff));
+        }
+        else
+        {
+            break;
+        }
+
+        i += step;
+    }
+
+    *used = i;
+    return n;
+}
+
+/**
+ *\brief                        逐字符转为UTF-16
+ *\param[in]    src             UTF-8字符串
+ *\param[in]    len             长度
+ *\param[out]   dst             UTF-16字符串,不写结尾的0
+ *\param[in]    size            dst长度
+ *\return                       转换后的长度
+ */
+static size_t str_widen_scalar(const UCHAR *src, size_t len, WORD *dst, size_t size)
+{
+    size_t used;
+
+    return str_widen_tail(src, len, len, dst, size, &used);
+}
+
+#ifdef SIMD_X86
+
+/**
+ *\brief                        SSE2查找字符串结尾和检查字符
+ *\param[in]    src             字符串
+ *\param[in]    max             最多检查的字节数
+ *\param[out]   flags           PE_STR_*
+ *\return                       长度
+ */
+SIMD_TARGET("sse2")
+static size_t str_scan_sse2(const UCHAR *src, size_t max, DWORD *flags)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i del   = _mm_set1_epi8(0x7f);
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i slash = _mm_set1_epi8('\\');
+
+    DWORD  f = PE_STR_ASCII | PE_STR_PLAIN;
+    size_t i = 0;
+
+    for (; i + 16 <= max; i += 16)
+    {
+        __m128i  v    = _mm_loadu_si128((const __m128i*)(src + i));
+        unsigned end  = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero));
+        unsigned bad  = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpgt_epi8(space, v), _mm_cmpeq_epi8(v, del)));
+        unsigned esc  = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash)));
+
+        if (0 != end)
+        {
+            unsigned before = (end & (0 - end)) - 1; // 0之前的字节
+
+            f &= (0 != (bad & before)) ? ~STR_BAD : ~0u;
+            f &= (0 != (esc & before)) ? ~PE_STR_PLAIN : ~0u;
+
+            *flags = f;
+            return i + simd_ctz(end);
+        }
+
+        f &= (0 != bad) ? ~STR_BAD : ~0u;
+        f &= (0 != esc) ? ~PE_STR_PLAIN : ~0u;
+    }
+
+    DWORD  tail;
+    size_t len = str_scan_scalar(src + i, max - i, &tail);
+
+    *flags = (f | PE_STR_CUT) & tail; // 结尾是否截断由剩下的部分决定
+    return i + len;
+}
+
+/**
+ *\brief                        SSE2复制到结尾的0,整块写入目标,0之后的字节也会写入,不超过max
+ *\param[out]   dst             目标,至少max字节,不写结尾的0
+ *\param[in]    src             字符串
+ *\param[in]    max             最多复制的字节数
+ *\return                       长度
+ */
+SIMD_TARGET("sse2")
+static size_t str_copy_sse2(char *dst, const UCHAR *src, size_t max)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+
+    for (; i + 16 <= max; i += 16)
+    {
+        __m128i  v   = _mm_loadu_si128((const __m128i*)(src + i));
+        unsigned end = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero));
+
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+
+        if (0 != end)
+        {
+            return i + simd_ctz(end);
+        }
+    }
+
+    return i + str_copy_scalar(dst + i, src + i, max - i);
+}
+
+/**
+ *\brief                        AVX2查找字符串结尾和检查字符
+ *\param[in]    src             字符串
+ *\param[in]    max             最多检查的字节数
+ *\param[out]   flags           PE_STR_*
+ *\return                       长度
+ */
+SIMD_TARGET("avx2")
+static size_t str_scan_avx2(const UCHAR *src, size_t max, DWORD *flags)
+{
+    const __m256i zero  = _mm256_setzero_si256();
+    const __m256i space = _mm256_set1_epi8(0x20);
+    const __m256i del   = _mm256_set1_epi8(0x7f);
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i slash = _mm256_set1_epi8('\\');
+
+    DWORD  f = PE_STR_ASCII | PE_STR_PLAIN;
+    size_t i = 0;
+
+    for (; i + 32 <= max; i += 32)
+    {
+        __m256i  v    = _mm256_loadu_si256((const __m256i*)(src + i));
+        unsigned end  = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero));
+        unsigned bad  = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpgt_epi8(space, v), _mm256_cmpeq_epi8(v, del)));
+        unsigned esc  = (unsigned)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, slash)));
+
+        if (0 != end)
+        {
+            unsigned before = (end & (0 - end)) - 1;
+
+            f &= (0 != (bad & before)) ? ~STR_BAD : ~0u;
+            f &= (0 != (esc & before)) ? ~PE_STR_PLAIN : ~0u;
+
+            *flags = f;
+            return i + simd_ctz(end);
+        }
+
+        f &= (0 != bad) ? ~STR_BAD : ~0u;
+        f &= (0 != esc) ? ~PE_STR_PLAIN : ~0u;
+    }
+
+    DWORD  tail;
+    size_t len = str_scan_sse2(src + i, max - i, &tail); // 不足32字节的部分
+
+    *flags = (f | PE_STR_CUT) & tail; // 结尾是否截断由剩下的部分决定
+    return i + len;
+}
+
+/**
+ *\brief                        SSE2转为UTF-16,16字节都是ASCII时整块展开
+ *\param[in]    src             UTF-8字符串
+ *\param[in]    len             长度
+ *\param[out]   dst             UTF-16字符串,不写结尾的0
+ *\param[in]    size            dst长度
+ *\return                       转换后的长度
+ */
+SIMD_TARGET("sse2")
+static size_t str_widen_sse2(const UCHAR *src, size_t len, WORD *dst, size_t size)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    size_t n = 0;
+
+    while (i < len && n < size)
+    {
+        if (i + 16 <= len && n + 16 <= size)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+
+            if (0 == _mm_movemask_epi8(v))
+            {
+                _mm_storeu_si128((__m128i*)(dst + n),     _mm_unpacklo_epi8(v, zero));
+                _mm_storeu_si128((__m128i*)(dst + n + 8), _mm_unpackhi_epi8(v, zero));
+                i += 16;
+                n += 16;
+                continue;
+            }
+        }
+
+        // 有非ASCII字节或不足一块,逐字符转换这16字节
+        size_t used;
+
+        n += str_widen_tail(src + i, len - i, 16, dst + n, size - n, &used);
+
+        if (0 == used)
+        {
+            break;
+        }
+
+        i += used;
+    }
+
+    return n;
+}
+
+#endif
+
+typedef struct _STR_IMPL                                                    ///  一种实现
+{
+    const char     *name;                                                   ///< 名称
+    str_scan_proc   scan;                                                   ///< 查找结尾
+    str_copy_proc   copy;                                                   ///< 复制
+    str_widen_proc  widen;                                                  ///< 宽字符转换
+
+} STR_IMPL;
+
+static const STR_IMPL g_str_impl[] = {                                      ///< 按PE_STR_*排列
+    { "scalar", str_scan_scalar, str_copy_scalar, str_widen_scalar },
+#ifdef SIMD_X86
+    { "sse2",   str_scan_sse2,   str_copy_sse2,   str_widen_sse2   },
+    { "avx2",   str_scan_avx2,   str_copy_sse2,   str_widen_sse2   },       // 名称大多短于32字节,复制和转换用16字节的块更快
+#endif
+};
+
+static int g_str_level = PE_STR_SCALAR;                                     ///< 使用的实现,启动线程前用pe_str_use选择
+
+int pe_str_use(int impl)
+{
+    if (PE_STR_AUTO == impl)
+    {
+        impl = simd_best((int)(SIZEOF(g_str_impl)) - 1);
+    }
+    else if (impl < 0 || impl >= (int)(SIZEOF(g_str_impl)) || !simd_supported(impl))
+    {
+        return -1;
+    }
+
+    g_str_level = impl;
+    return 0;
+}
+
+const char* pe_str_impl(void)
+{
+    return g_str_impl[g_str_level].name;
+}
+
+size_t pe_str_scan(const char *src, size_t max, DWORD *flags)
+{
+    return g_str_impl[g_str_level].scan((const UCHAR*)src, max, flags);
+}
+
+const char* pe_str_view(PPE_VIEW view, ULONGLONG off, size_t max, PPE_STR str)
+{
+    if (0 == off || off >= view->size)
+    {
+        str->data  = "";
+        str->len   = 0;
+        str->flags = PE_STR_ASCII | PE_STR_PLAIN;
+        return str->data;
+    }
+
+    if (max > view->size - off)
+    {
+        max = (size_t)(view->size - off);
+    }
+
+    str->data = (const char*)view->data + off;
+    str->len  = pe_str_scan(str->data, max, &str->flags);
+    return str->data;
+}
+
+size_t pe_str_append(char *dst, size_t len, size_t size, PPE_VIEW view, ULONGLONG off)
+{
+    if (len + 1 >= size) // 已经满了,snprintf截断时len可能超过size
+    {
+        return (size > 0) ? size - 1 : 0;
+    }
+
+    if (0 != off && off < view->size)
+    {
+        size_t max = size - len - 1;
+
+        if (max > view->size - off)
+        {
+            max = (size_t)(view->size - off);
+        }
+
+        len += g_str_impl[g_str_level].copy(dst + len, view->data + off, max); // 查找结尾的同时复制
+    }
+
+    dst[len] = '\0';
+    return len;
+}
+
+size_t pe_str_widen(const char *src, size_t len, WORD *dst, size_t size)
+{
+    if (0 == size)
+    {
+        return 0;
+    }
+
+    size_t n = g_str_impl[g_str_level].widen((const UCHAR*)src, len, dst, size - 1);
+
+    dst[n] = 0;
+    return n;
+}
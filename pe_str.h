@@ -0,0 +1,92 @@
+/**
+ *\file     pe_str.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    文件中字符串的提取
+ *          导入导出名称,库名称等以0结尾的字符串在文件中的长度不受限制,
+ *          查找结尾时不超过文件结尾和指定的最大长度,同时检查是否都是可显示的ASCII字符.
+ *          x86下运行时按CPU选择AVX2,SSE2或逐字节的实现,一次检查16或32字节,结果相同.
+ *          字符串以指向映射文件的视图返回,不复制;需要宽字符时整段转换
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|没有选择实现时逐字节处理
+ */
+#ifndef _PE_STR_H_
+#define _PE_STR_H_
+
+#include "pe.h"
+#include "simd.h"
+
+#define PE_STR_ASCII            0x01                                        ///< 都是可显示的ASCII字符,0x20-0x7e
+#define PE_STR_PLAIN            0x02                                        ///< 都是可显示的ASCII字符,并且没有引号和反斜杠,JSON中不需要转义
+#define PE_STR_CUT              0x04                                        ///< 到最大长度或文件结尾都没有0,被截断
+
+#define PE_STR_AUTO             SIMD_AUTO                                   ///< 按CPU选择实现
+#define PE_STR_SCALAR           SIMD_SCALAR                                 ///< 逐字节
+#define PE_STR_SSE2             SIMD_SSE2                                   ///< SSE2,一次16字节
+#define PE_STR_AVX2             SIMD_AVX2                                   ///< AVX2,一次32字节
+
+typedef struct _PE_STR                                                      ///  字符串视图
+{
+    const char     *data;                                                   ///< 字符串,指向映射的文件,不一定以0结尾
+    size_t          len;                                                    ///< 长度
+    DWORD           flags;                                                  ///< PE_STR_*
+
+} PE_STR, *PPE_STR;
+
+/**
+ *\brief                        查找字符串结尾,同时检查字符
+ *\param[in]    src             字符串
+ *\param[in]    max             最多检查的字节数,不会读取src+max及之后的字节
+ *\param[out]   flags           PE_STR_*
+ *\return                       长度,没有0时为max
+ */
+size_t pe_str_scan(const char *src, size_t max, DWORD *flags);
+
+/**
+ *\brief                        得到文件中的字符串,不复制
+ *\param[in]    view            文件数据视图
+ *\param[in]    off             字符串在文件中的位置,0或超出文件时为空字符串
+ *\param[in]    max             最大长度
+ *\param[out]   str             字符串视图
+ *\return                       字符串,同str->data
+ */
+const char* pe_str_view(PPE_VIEW view, ULONGLONG off, size_t max, PPE_STR str);
+
+/**
+ *\brief                        追加文件中的字符串,超出缓冲区时截断
+ *\param[in]    dst             目标,以0结尾
+ *\param[in]    len             dst已有的长度,不需要再计算strlen
+ *\param[in]    size            dst缓冲区长度
+ *\param[in]    view            文件数据视图
+ *\param[in]    off             字符串在文件中的位置,0或超出文件时不追加
+ *\return                       追加后dst的长度
+ */
+size_t pe_str_append(char *dst, size_t len, size_t size, PPE_VIEW view, ULONGLONG off);
+
+/**
+ *\brief                        UTF-8转为UTF-16,无效的字节转为U+FFFD
+ *\param[in]    src             UTF-8字符串
+ *\param[in]    len             长度
+ *\param[out]   dst             UTF-16字符串,以0结尾
+ *\param[in]    size            dst长度,WORD数,超出时截断
+ *\return                       转换后的长度,WORD数,不包括结尾的0
+ */
+size_t pe_str_widen(const char *src, size_t len, WORD *dst, size_t size);
+
+/**
+ *\brief                        指定使用的实现,不是线程安全的,在启动线程前调用,没有调用时逐字节处理
+ *\param[in]    impl            PE_STR_AUTO,PE_STR_SCALAR,PE_STR_SSE2,PE_STR_AVX2
+ *\return                       0-成功,-1-CPU不支持
+ */
+int pe_str_use(int impl);
+
+/**
+ *\brief                        得到当前使用的实现的名称
+ *\return                       scalar,sse2,avx2
+ */
+const char* pe_str_impl(void);
+
+#endif
@@ -0,0 +1,572 @@
+/**
+ *\file     pe_stream.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    流式读取PE文件实现
+ *          数据目录所在的节整个保存,导入名称,导出名称等通常和目录在同一个节中;
+ *          在其它节中并且已经读过的数据不能再读,解析时为0
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加保存整个文件的方式
+ *          2026.10.18|保留的地址空间不一次提交,读到哪里提交到哪里
+ */
+#include "pe_stream.h"
+
+#define STREAM_RESERVE_MAX      ((ULONGLONG)1 << 32)                        ///< 长度未知时保留的地址空间,文件位置都是DWORD
+#define STREAM_RESERVE_MIN      (16 * 1024 * 1024)                          ///< 地址空间不足时最少保留的长度
+#define STREAM_COMMIT           (1024 * 1024)                               ///< 一次至少提交的长度
+
+#define TAR_PAX_MAX             (64 * 1024)                                 ///< pax扩展头最大长度,更长的跳过
+
+/**
+ *\brief                        提交保留的地址空间到指定位置,按STREAM_COMMIT取整,不超过保留长度
+ *\param[in]    stream          读取结果
+ *\param[in]    end             结束位置
+ *\return                       0-成功,-1-提交量不足
+ */
+static int stream_commit(PPE_STREAM stream, ULONGLONG end)
+{
+    if (end <= stream->committed)
+    {
+        return 0;
+    }
+
+    end = (end + STREAM_COMMIT - 1) / STREAM_COMMIT * STREAM_COMMIT;
+    end = (end < stream->reserved) ? end : stream->reserved;
+
+    if (0 != mem_commit(stream->data + stream->committed, (size_t)(end - stream->committed)))
+    {
+        return -1;
+    }
+
+    stream->committed = (size_t)end;
+    return 0;
+}
+
+/**
+ *\brief                        读到指定位置,超出保留长度的部分不读
+ *\param[in]    stream          读取结果
+ *\param[in]    read            读取回调
+ *\param[in]    param           回调参数
+ *\param[in]    end             结束位置
+ *\return                       0-读到了,-1-输入结尾或提交量不足
+ */
+static int stream_read_to(PPE_STREAM stream, pe_read_proc read, void *param, ULONGLONG end)
+{
+    if (end > stream->reserved)
+    {
+        end = stream->reserved;
+    }
+
+    if (0 != stream_commit(stream, end))
+    {
+        return -1;
+    }
+
+    while (stream->size < end)
+    {
+        size_t n = read(param, stream->data + stream->size, (size_t)(end - stream->size));
+
+        if (0 == n)
+        {
+            return -1;
+        }
+
+        stream->size   += n;
+        stream->loaded += n;
+    }
+
+    return 0;
+}
+
+/**
+ *\brief                        读出数据丢弃,到指定位置或输入结尾
+ *\param[in]    stream          读取结果
+ *\param[in]    read            读取回调
+ *\param[in]    param           回调参数
+ *\param[in]    skip            丢弃数据的缓冲区,PE_STREAM_SKIP字节
+ *\param[in]    end             结束位置,PE_STREAM_UNKNOWN为到输入结尾
+ *\return                       0-读到了,-1-输入结尾
+ */
+static int stream_skip_to(PPE_STREAM stream, pe_read_proc read, void *param, UCHAR *skip, ULONGLONG end)
+{
+    int ret = 0;
+
+    while (stream->size < end)
+    {
+        size_t n = (end - stream->size < PE_STREAM_SKIP) ? (size_t)(end - stream->size) : PE_STREAM_SKIP;
+
+        n = read(param, skip, n);
+
+        if (0 == n)
+        {
+            ret = -1;
+            break;
+        }
+
+        stream->size    += n;
+        stream->skipped += n;
+    }
+
+    stream_commit(stream, stream->size); // 解析时丢弃的部分读出0,提交不了时pe_stream_size不包括
+    return ret;
+}
+
+/**
+ *\brief                        加入需要的范围,超出保留长度的部分不要
+ *\param[in]    stream          读取结果
+ *\param[in]    begin           开始位置
+ *\param[in]    end             结束位置
+ *\return                       无
+ */
+static void stream_add(PPE_STREAM stream, ULONGLONG begin, ULONGLONG end)
+{
+    if (end > stream->reserved)
+    {
+        end = stream->reserved;
+    }
+
+    if (begin < end && stream->range_count < PE_STREAM_RANGES)
+    {
+        stream->range[stream->range_count].begin = begin;
+        stream->range[stream->range_count].end   = end;
+        stream->range_count++;
+    }
+}
+
+/**
+ *\brief                        范围排序比较函数
+ *\param[in]    a               范围
+ *\param[in]    b               范围
+ *\return                       <0,0,>0
+ */
+static int range_compare(const void *a, const void *b)
+{
+    PPE_RANGE x = (PPE_RANGE)a;
+    PPE_RANGE y = (PPE_RANGE)b;
+
+    return (x->begin < y->begin) ? -1 : (x->begin > y->begin);
+}
+
+/**
+ *\brief                        读头部和节表,由数据目录得到需要的范围,排序并合并重叠的范围
+ *\param[in]    stream          读取结果
+ *\param[in]    read            读取回调
+ *\param[in]    param           回调参数
+ *\param[in]    dirs            需要的数据目录
+ *\return                       无
+ */
+static void stream_head(PPE_STREAM stream, pe_read_proc read, void *param, DWORD dirs)
+{
+    PE_VIEW view = { stream->data, 0 };
+
+    if (PE_STREAM_ALL == dirs)
+    {
+        stream_add(stream, 0, PE_STREAM_UNKNOWN);
+        return;
+    }
+
+    stream_read_to(stream, read, param, sizeof(IMAGE_DOS_HEADER));
+    view.size = (size_t)stream->size;
+
+    DWORD nt_fa = view_get32(&view, offsetof(IMAGE_DOS_HEADER, e_lfanew));
+
+    if (IMAGE_DOS_SIGNATURE != view_get16(&view, 0) || nt_fa > PE_STREAM_HEAD_MAX - sizeof(IMAGE_NT_HEADERS64))
+    {
+        stream_add(stream, 0, stream->size); // 不是PE文件,解析只需要DOS头
+        return;
+    }
+
+    DWORD file_fa = nt_fa + sizeof(DWORD);
+    DWORD opt_fa  = file_fa + sizeof(IMAGE_FILE_HEADER);
+
+    stream_read_to(stream, read, param, opt_fa);
+    view.size = (size_t)stream->size;
+
+    ULONGLONG table = opt_fa + (ULONGLONG)view_get16(&view, file_fa + offsetof(IMAGE_FILE_HEADER, SizeOfOptionalHeader));
+    DWORD     count = view_get16(&view, file_fa + offsetof(IMAGE_FILE_HEADER, NumberOfSections));
+    ULONGLONG end   = table + (ULONGLONG)count * sizeof(IMAGE_SECTION_HEADER);
+
+    stream_read_to(stream, read, param, (end < PE_STREAM_HEAD_MAX) ? end : PE_STREAM_HEAD_MAX);
+    view.size = (size_t)stream->size;
+
+    ULONGLONG headers = view_get32(&view, opt_fa + offsetof(IMAGE_OPTIONAL_HEADER32, SizeOfHeaders)); // 32位和64位位置相同
+
+    if (headers > end)
+    {
+        stream_read_to(stream, read, param, (headers < PE_STREAM_HEAD_MAX) ? headers : PE_STREAM_HEAD_MAX);
+        view.size = (size_t)stream->size;
+    }
+
+    stream_add(stream, 0, stream->size);
+
+    int   magic64  = (PE_MAGIC_64 == view_get16(&view, opt_fa));
+    DWORD dir_fa   = opt_fa + (magic64 ? offsetof(IMAGE_OPTIONAL_HEADER64, DataDirectory) : offsetof(IMAGE_OPTIONAL_HEADER32, DataDirectory));
+    DWORD dir_max  = view_get32(&view, dir_fa - sizeof(DWORD)); // NumberOfRvaAndSizes在DataDirectory之前
+
+    for (DWORD i = 0; i < IMAGE_NUMBEROF_DIRECTORY_ENTRIES && i < dir_max; i++)
+    {
+        DWORD rva  = view_get32(&view, dir_fa + i * sizeof(IMAGE_DATA_DIRECTORY));
+        DWORD size = view_get32(&view, dir_fa + i * sizeof(IMAGE_DATA_DIRECTORY) + sizeof(DWORD));
+
+        if (0 == (dirs & PE_STREAM_DIR(i)) || 0 == rva)
+        {
+            continue;
+        }
+
+        if (4 == i) // 证书表的地址是文件位置
+        {
+            stream_add(stream, rva, (ULONGLONG)rva + size);
+            continue;
+        }
+
+        for (DWORD j = 0; j < count && VIEW_HAS(&view, table + (j + 1) * sizeof(IMAGE_SECTION_HEADER), 0); j++)
+        {
+            const UCHAR *header = view.data + table + j * sizeof(IMAGE_SECTION_HEADER);
+
+            DWORD va       = VIEW_FIELD32(header, IMAGE_SECTION_HEADER, VirtualAddress);
+            DWORD vsize    = VIEW_FIELD32(header, IMAGE_SECTION_HEADER, Misc.VirtualSize);
+            DWORD raw_size = VIEW_FIELD32(header, IMAGE_SECTION_HEADER, SizeOfRawData);
+            DWORD raw_fa   = VIEW_FIELD32(header, IMAGE_SECTION_HEADER, PointerToRawData);
+
+            if (rva >= va && (ULONGLONG)rva - va < ((vsize > raw_size) ? vsize : raw_size))
+            {
+                // 整个节和目录本身,目录可能超出节的文件数据
+                stream_add(stream, raw_fa, (ULONGLONG)raw_fa + raw_size);
+                stream_add(stream, (ULONGLONG)raw_fa + rva - va, (ULONGLONG)raw_fa + rva - va + size);
+                break;
+            }
+        }
+    }
+}
+
+int pe_stream_load(PPE_STREAM stream, pe_read_proc read, void *param, ULONGLONG size, DWORD dirs)
+{
+    memset(stream, 0, sizeof(PE_STREAM));
+
+    ULONGLONG reserve = (PE_STREAM_UNKNOWN == size || size > STREAM_RESERVE_MAX) ? STREAM_RESERVE_MAX : size;
+
+    if (reserve > (size_t)-1 / 2) // 32位下地址空间不够
+    {
+        reserve = (size_t)-1 / 2 + 1;
+    }
+
+    if (0 == reserve)
+    {
+        reserve = 1;
+    }
+
+    // 地址空间不够时减少,超出的部分读出后丢弃
+    while (NULL == (stream->data = mem_reserve((size_t)reserve)) && reserve > STREAM_RESERVE_MIN)
+    {
+        reserve /= 2;
+    }
+
+    stream->reserved = (size_t)reserve;
+
+    UCHAR *skip = malloc(PE_STREAM_SKIP);
+
+    if (NULL == stream->data || NULL == skip)
+    {
+        free(skip);
+        pe_stream_free(stream);
+        return -1;
+    }
+
+    stream_head(stream, read, param, dirs);
+
+    qsort(stream->range, stream->range_count, sizeof(PE_RANGE), range_compare);
+
+    DWORD count = 0;
+
+    for (DWORD i = 0; i < stream->range_count; i++) // 合并重叠和相邻的范围
+    {
+        if (count > 0 && stream->range[i].begin <= stream->range[count - 1].end)
+        {
+            if (stream->range[i].end > stream->range[count - 1].end)
+            {
+                stream->range[count - 1].end = stream->range[i].end;
+            }
+        }
+        else
+        {
+            stream->range[count++] = stream->range[i];
+        }
+    }
+
+    stream->range_count = count;
+
+    int ret = 0;
+
+    for (DWORD i = 0; 0 == ret && i < stream->range_count; i++)
+    {
+        if (stream->range[i].end <= stream->size)
+        {
+            continue; // 头部已经读过
+        }
+
+        ret = stream_skip_to(stream, read, param, skip, stream->range[i].begin);
+
+        if (0 == ret)
+        {
+            ret = stream_read_to(stream, read, param, stream->range[i].end);
+        }
+    }
+
+    stream_skip_to(stream, read, param, skip, PE_STREAM_UNKNOWN); // 读到结尾,得到文件长度
+
+    free(skip);
+    return 0;
+}
+
+size_t pe_stream_size(PPE_STREAM stream)
+{
+    return (stream->size < stream->committed) ? (size_t)stream->size : stream->committed; // 没有提交的部分不能读
+}
+
+void pe_stream_free(PPE_STREAM stream)
+{
+    if (NULL != stream->data)
+    {
+        mem_release(stream->data, stream->reserved ? stream->reserved : 1);
+    }
+
+    stream->data      = NULL;
+    stream->reserved  = 0;
+    stream->committed = 0;
+}
+
+/**
+ *\brief                        解析tar头中的数字,八进制文本或最高位为1时的大端二进制
+ *\param[in]    p               字段
+ *\param[in]    len             字段长度
+ *\return                       值
+ */
+static ULONGLONG tar_number(const UCHAR *p, size_t len)
+{
+    ULONGLONG value = 0;
+    size_t    i     = 0;
+
+    if (p[0] & 0x80) // GNU的大文件长度
+    {
+        value = p[0] & 0x7F;
+
+        for (i = 1; i < len; i++)
+        {
+            value = (value << 8) | p[i];
+        }
+
+        return value;
+    }
+
+    for (; i < len && ' ' == p[i]; i++);
+
+    for (; i < len && p[i] >= '0' && p[i] <= '7'; i++)
+    {
+        value = (value << 3) | (p[i] - '0');
+    }
+
+    return value;
+}
+
+int pe_tar_check(const UCHAR *block)
+{
+    DWORD sum = 0;
+
+    for (int i = 0; i < PE_TAR_BLOCK; i++)
+    {
+        sum += (i >= 148 && i < 156) ? ' ' : block[i]; // 校验和字段按空格计算
+    }
+
+    return sum != 8 * ' ' && sum == tar_number(block + 148, 8);
+}
+
+/**
+ *\brief                        读取整个包的数据,直到读够或输入结尾
+ *\param[in]    tar             tar包读取
+ *\param[out]   buff            缓冲区,NULL时丢弃
+ *\param[in]    size            字节数
+ *\return                       读到的字节数
+ */
+static ULONGLONG tar_read_full(PPE_TAR tar, void *buff, ULONGLONG size)
+{
+    UCHAR     skip[PE_TAR_BLOCK * 8];
+    ULONGLONG done = 0;
+
+    while (done < size)
+    {
+        size_t want = (size - done < sizeof(skip)) ? (size_t)(size - done) : sizeof(skip);
+        size_t n    = tar->read(tar->param, buff ? (UCHAR*)buff + done : skip, buff ? (size_t)(size - done) : want);
+
+        if (0 == n)
+        {
+            break;
+        }
+
+        done += n;
+    }
+
+    return done;
+}
+
+/**
+ *\brief                        从pax扩展头中取path
+ *\param[in]    tar             tar包读取,取到时写入name
+ *\param[in]    data            扩展头记录,"长度 键=值\n"
+ *\param[in]    size            长度
+ *\return                       无
+ */
+static void tar_pax_path(PPE_TAR tar, const char *data, size_t size)
+{
+    size_t pos = 0;
+
+    while (pos < size)
+    {
+        size_t len = 0;
+        size_t i   = pos;
+
+        for (; i < size && data[i] >= '0' && data[i] <= '9'; i++)
+        {
+            len = len * 10 + (data[i] - '0');
+        }
+
+        if (0 == len || len > size - pos || i >= size || ' ' != data[i])
+        {
+            return;
+        }
+
+        const char *key = data + i + 1;
+        size_t      n   = pos + len - (i + 1); // 键=值\n 的长度
+
+        if (n > 6 && 0 == memcmp(key, "path=", 5) && n - 6 < PE_TAR_NAME)
+        {
+            memcpy(tar->name, key + 5, n - 6);
+            tar->name[n - 6] = '\0';
+        }
+
+        pos += len;
+    }
+}
+
+int pe_tar_next(PPE_TAR tar)
+{
+    UCHAR block[PE_TAR_BLOCK];
+    int   named = 0; // 已由GNU长名称或pax得到名称
+
+    if (tar_read_full(tar, NULL, tar->left + tar->pad) != tar->left + tar->pad)
+    {
+        return -1;
+    }
+
+    tar->left = 0;
+    tar->pad  = 0;
+
+    for (;;)
+    {
+        ULONGLONG n = tar_read_full(tar, block, PE_TAR_BLOCK);
+
+        if (0 == n)
+        {
+            return 0; // 没有结尾的0块也算结束
+        }
+
+        if (PE_TAR_BLOCK != n)
+        {
+            return -1;
+        }
+
+        if (!pe_tar_check(block))
+        {
+            for (int i = 0; i < PE_TAR_BLOCK; i++)
+            {
+                if (0 != block[i])
+                {
+                    return -2;
+                }
+            }
+
+            return 0; // 结尾的0块
+        }
+
+        ULONGLONG size = tar_number(block + 124, 12);
+        DWORD     pad  = (DWORD)((PE_TAR_BLOCK - size % PE_TAR_BLOCK) % PE_TAR_BLOCK);
+        char      type = (char)block[156];
+
+        if ('L' == type || ('x' == type && size <= TAR_PAX_MAX)) // 下一个成员的名称
+        {
+            char *data = malloc((size_t)size + 1);
+
+            if (NULL == data || tar_read_full(tar, data, size + pad) != size + pad)
+            {
+                free(data);
+                return -1;
+            }
+
+            if ('L' == type)
+            {
+                size_t len = strnlen(data, (size_t)size);
+
+                len = (len < PE_TAR_NAME) ? len : PE_TAR_NAME - 1;
+                memcpy(tar->name, data, len);
+                tar->name[len] = '\0';
+                named = 1;
+            }
+            else
+            {
+                tar->name[0] = '\0';
+                tar_pax_path(tar, data, (size_t)size);
+                named = ('\0' != tar->name[0]);
+            }
+
+            free(data);
+            continue;
+        }
+
+        if ('0' != type && '\0' != type && '7' != type) // 只要普通文件
+        {
+            if (tar_read_full(tar, NULL, size + pad) != size + pad)
+            {
+                return -1;
+            }
+
+            named = 0;
+            continue;
+        }
+
+        if (!named)
+        {
+            char prefix[156] = "";
+            char name[101]   = "";
+
+            if (0 == memcmp(block + 257, "ustar", 5))
+            {
+                memcpy(prefix, block + 345, 155);
+            }
+
+            memcpy(name, block, 100);
+            snprintf(tar->name, PE_TAR_NAME, "%s%s%s", prefix, prefix[0] ? "/" : "", name);
+        }
+
+        tar->size = size;
+        tar->left = size;
+        tar->pad  = pad;
+        return 1;
+    }
+}
+
+size_t pe_tar_read(void *param, void *buff, size_t size)
+{
+    PPE_TAR tar = (PPE_TAR)param;
+
+    if (size > tar->left)
+    {
+        size = (size_t)tar->left;
+    }
+
+    size_t n = (size > 0) ? tar->read(tar->param, buff, size) : 0;
+
+    tar->left -= n;
+    return n;
+}
@@ -0,0 +1,130 @@
+/**
+ *\file     pe_stream.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    从不能定位的输入(管道,tar包)流式读取PE文件
+ *          先读头部和节表,由需要的数据目录通过节表得到要保存的文件范围,
+ *          之后只向前读,需要的范围写入与文件位置相同的地址,其它数据读出后丢弃.
+ *          保存数据的地址空间按文件长度分配,只有写入的页占用内存,
+ *          内存占用只与需要的表的大小有关,与文件长度无关;解析时不需要的部分读出来为0.
+ *          tar包按成员逐个读取,只支持不压缩的ustar/GNU格式
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加保存整个文件的方式,计算节的摘要时使用
+ *          2026.10.18|保留的地址空间随读取按需提交
+ *          2026.10.18|增加资源表的掩码,取版本信息和输出资源树时使用
+ *          2026.10.18|默认还需要延迟导入表和绑定导入表
+ */
+#ifndef _PE_STREAM_H_
+#define _PE_STREAM_H_
+
+#include "pe.h"
+
+#define PE_STREAM_UNKNOWN       ((ULONGLONG)-1)                             ///< 输入长度未知
+#define PE_STREAM_HEAD_MAX      (4 * 1024 * 1024)                           ///< 头部最多读取的长度,包括节表
+#define PE_STREAM_SKIP          (64 * 1024)                                 ///< 丢弃数据时每次读取的长度
+#define PE_STREAM_RANGES        (IMAGE_NUMBEROF_DIRECTORY_ENTRIES * 2 + 1)  ///< 最多的范围数,头部和每个目录的节与目录本身
+
+#define PE_STREAM_DIR(dir)      (1U << (dir))                               ///< 数据目录掩码
+#define PE_STREAM_DIRS          (PE_STREAM_DIR(PE_DIR_EXPORT) | PE_STREAM_DIR(PE_DIR_IMPORT) | \
+                                 PE_STREAM_DIR(PE_DIR_RELOC)  | PE_STREAM_DIR(12) | \
+                                 PE_STREAM_DIR(PE_DIR_DELAY)  | PE_STREAM_DIR(PE_DIR_BOUND)) ///< 默认需要的数据目录,12为导入地址表
+#define PE_STREAM_RSRC          PE_STREAM_DIR(PE_DIR_RSRC)                  ///< 取版本信息,清单和输出资源树时还需要的数据目录
+#define PE_STREAM_ALL           0xFFFFFFFF                                  ///< 保存整个文件,不丢弃数据
+
+#define PE_TAR_BLOCK            512                                         ///< tar块长度
+#define PE_TAR_NAME             1024                                        ///< 成员名称最大长度
+
+/**
+ *\brief                        读取回调
+ *\param[in]    param           回调参数
+ *\param[out]   buff            缓冲区
+ *\param[in]    size            最多读取的字节数
+ *\return                       读到的字节数,0为结尾或出错
+ */
+typedef size_t (*pe_read_proc)(void *param, void *buff, size_t size);
+
+typedef struct _PE_RANGE                                                    ///  文件范围
+{
+    ULONGLONG       begin;                                                  ///< 开始位置
+    ULONGLONG       end;                                                    ///< 结束位置,不包括
+
+} PE_RANGE, *PPE_RANGE;
+
+typedef struct _PE_STREAM                                                   ///  流式读取的文件
+{
+    UCHAR          *data;                                                   ///< 按文件位置保存的数据,只有需要的范围写入
+    size_t          reserved;                                               ///< data的长度
+    size_t          committed;                                              ///< data中已提交的长度,不超过reserved
+    ULONGLONG       size;                                                   ///< 文件长度,读到结尾为止
+    ULONGLONG       loaded;                                                 ///< 保存的字节数
+    ULONGLONG       skipped;                                                ///< 读出后丢弃的字节数
+    PE_RANGE        range[PE_STREAM_RANGES];                                ///< 需要的范围,按位置排列,不重叠
+    DWORD           range_count;                                            ///< 范围数
+
+} PE_STREAM, *PPE_STREAM;
+
+typedef struct _PE_TAR                                                      ///  tar包读取
+{
+    pe_read_proc    read;                                                   ///< 读取整个包的回调
+    void           *param;                                                  ///< 回调参数
+    char            name[PE_TAR_NAME];                                      ///< 当前成员名称
+    ULONGLONG       size;                                                   ///< 当前成员长度
+    ULONGLONG       left;                                                   ///< 当前成员还没有读的字节数
+    DWORD           pad;                                                    ///< 当前成员数据后补齐到块的字节数
+
+} PE_TAR, *PPE_TAR;
+
+/**
+ *\brief                        流式读取一个文件,读到输入结尾
+ *\param[out]   stream          读取结果,用pe_stream_free释放
+ *\param[in]    read            读取回调
+ *\param[in]    param           回调参数
+ *\param[in]    size            文件长度,PE_STREAM_UNKNOWN为未知
+ *\param[in]    dirs            需要的数据目录,PE_STREAM_DIR的组合,PE_STREAM_ALL为整个文件
+ *\return                       0-成功,其它失败
+ */
+int pe_stream_load(PPE_STREAM stream, pe_read_proc read, void *param, ULONGLONG size, DWORD dirs);
+
+/**
+ *\brief                        得到用于解析的数据长度,长度未知的输入超过保留的地址空间时为保留的长度,
+ *                              提交量不足时为已提交的长度
+ *\param[in]    stream          读取结果
+ *\return                       长度
+ */
+size_t pe_stream_size(PPE_STREAM stream);
+
+/**
+ *\brief                        释放读取结果
+ *\param[in]    stream          读取结果
+ *\return                       无
+ */
+void pe_stream_free(PPE_STREAM stream);
+
+/**
+ *\brief                        检查是否为tar头块,校验和正确
+ *\param[in]    block           PE_TAR_BLOCK字节
+ *\return                       1-是,0-不是
+ */
+int pe_tar_check(const UCHAR *block);
+
+/**
+ *\brief                        跳过当前成员剩下的数据,读到下一个普通文件成员,
+ *                              GNU长名称和pax的path用作成员名称,目录等其它类型跳过
+ *\param[in]    tar             tar包读取,第一次调用前read,param之外清0
+ *\return                       1-读到成员,0-包结尾,<0-格式错误或读取失败
+ */
+int pe_tar_next(PPE_TAR tar);
+
+/**
+ *\brief                        读取当前成员的数据,用作pe_stream_load的读取回调
+ *\param[in]    param           PE_TAR
+ *\param[out]   buff            缓冲区
+ *\param[in]    size            最多读取的字节数
+ *\return                       读到的字节数,成员结尾时为0
+ */
+size_t pe_tar_read(void *param, void *buff, size_t size);
+
+#endif
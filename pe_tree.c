@@ -0,0 +1,1726 @@
+/**
+ *\file     pe_tree.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    PE解析结果树形输出实现
+ *          时间|事件
+ *          -|-
+ *          2022.02.06|创建文件
+ *          2024.06.23|添加Doxygen注释
+ *          2026.10.18|从pe.c中分离,改为PE_IMAGE的使用者
+ *          2026.10.18|大的子树改为展开时才插入
+ *          2026.10.18|通过有界视图读取文件数据
+ *          2026.10.18|支持PE32+
+ *          2026.10.18|导出函数表按函数数量显示,序号表按WORD显示,名称表显示对应的序号,地址和转发
+ *          2026.10.18|重定位数据项按段批量解码
+ *          2026.10.18|文件中的名称用pe_str_append追加,不再逐字节复制和重复计算长度
+ *          2026.10.18|延迟子树可以按子节点范围展开,分段输出
+ *          2026.10.18|计算了摘要时显示节数据和附加数据的熵和散列
+ *          2026.10.18|计算了指纹时显示Rich头各项和导入表散列
+ *          2026.10.18|增加资源表,三层目录都展开时才解码;计算了版本信息时显示版本信息和清单
+ *          2026.10.18|增加延迟导入表和绑定导入表
+ *          2026.10.18|增加调试目录,解码了调试目录时显示CodeView,POGO,repro和嵌入的PDB
+ *          2026.10.18|增加证书表,检查了签名时显示摘要和散列的各段
+ *          2026.10.18|头部各节点插入后紧接着插入子节点,插入顺序与树的顺序相同
+ */
+#include "pe_tree.h"
+#include "pe_reloc.h"
+#include "pe_str.h"
+#include "pe_digest.h"
+#include "pe_finger.h"
+#include "pe_rsrc.h"
+#include "pe_debug.h"
+#include "pe_auth.h"
+
+#define SP(...)                 snprintf(txt, SIZEOF(txt), __VA_ARGS__)     ///< 格式化输出
+
+#define INSERT(parent)          tree->insert(tree->param, parent, txt)      ///< 插入节点
+
+#define BUFF                    (image->view.data)                          ///< PE文件数据
+
+#define VIEW                    (&image->view)                              ///< PE文件数据视图
+
+typedef struct _DATA                                                        ///  数据顶
+{
+    UCHAR size;                                                             ///< 数据项长
+    char *name;                                                             ///< 数据项名称
+
+} DATA, *PDATA;
+
+
+/**
+ *\brief                        导出函数是转发时追加转发字符串
+ *\param[in]    dst             字符串
+ *\param[in]    len             dst已有的长度
+ *\param[in]    size            dst长度
+ *\param[in]    image           解析结果
+ *\param[in]    sym             导出函数
+ *\return                       无
+ */
+static void append_forward(char *dst, size_t len, size_t size, PPE_IMAGE image, PPE_EXPORT_SYMBOL sym)
+{
+    if (0 != sym->forward_fa && len + 1 < size)
+    {
+        len += snprintf(dst + len, size - len, " 转发:");
+        pe_str_append(dst, len, size, VIEW, sym->forward_fa);
+    }
+}
+
+/**
+ *\brief                        得到节中文件位置与相对虚拟地址的差
+ *\param[in]    image           解析结果
+ *\param[in]    id              节序号
+ *\return                       相对虚拟地址-文件位置
+ */
+static DWORD section_delta(PPE_IMAGE image, int id)
+{
+    return image->section[id].virtual_address - image->section[id].raw_fa;
+}
+
+/**
+ *\brief                        插入有子节点的节点,输出树支持延迟子树时只插入该节点,否则立即插入全部子节点
+ *\param[in]    tree            输出树
+ *\param[in]    parent          父节点句柄
+ *\param[in]    image           解析结果
+ *\param[in]    txt             节点文本
+ *\param[in]    lazy            延迟子树标识
+ *\param[in]    count           子节点数量,为0时作为普通节点插入
+ *\return                       新节点句柄
+ */
+static PE_NODE insert_children(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image,
+                               const char *txt, DWORD lazy, DWORD count)
+{
+    if (0 == count)
+    {
+        return INSERT(parent);
+    }
+
+    if (NULL != tree->lazy)
+    {
+        return tree->lazy(tree->param, parent, txt, lazy);
+    }
+
+    PE_NODE node = INSERT(parent);
+
+    pe_tree_expand(tree, image, node, lazy);
+
+    return node;
+}
+
+/**
+ *\brief                        在树中插入DOS节点数据项
+ *\param[in]    tree            输出树
+ *\param[in]    parent          父节点句柄
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+static void insert_dos_head(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image)
+{
+    DATA data_item[] = {
+        { 2,  "可执行文件标记                 "},
+        { 2,  "文件最后页的字节数             "},
+        { 2,  "文件页数                       "},
+        { 2,  "重定位元素个数                 "},
+        { 2,  "以段落为单位的头部大小         "},
+        { 2,  "所需的最小附加段               "},
+        { 2,  "所需的最大附加段               "},
+        { 2,  "初始的堆栈段(SS)相对偏移量值   "},
+        { 2,  "初始的堆栈指针(SP)值           "},
+        { 2,  "校验和                         "},
+        { 2,  "初始的指令指针(IP)值           "},
+        { 2,  "初始的代码段(CS)相对偏移量值   "},
+        { 2,  "重定位表在文件中的偏移地址     "},
+        { 2,  "覆盖号                         "},
+        { 8,  "保留字,一般都是为确保对齐而预留"},
+        { 2,  "OEM标识符,相对于e_oeminfo      "},
+        { 2,  "OEM信息,即e_oemid的细节        "},
+        { 20, "保留字,一般都是为确保对齐而预留"},
+        { 4,  "指向PE文件头的偏移量           "}
+    };
+
+    char   txt[256]   = "";
+
+    int    fa         = 0; // DOS头节点在exe文件中的位置
+    char  *name       = 0;
+    UCHAR  size       = 0;
+
+    // 插入DOS头数据项
+    for (int i = 0; i < SIZEOF(data_item); i++)
+    {
+        name = data_item[i].name;
+        size = data_item[i].size;
+
+        if (2 == size)  // 2字节数据项
+        {
+            SP("%04x %s : %04x", fa, name, le16(BUFF + fa));
+        }
+        else if (4 == size)
+        {
+            SP("%04x %s : %08x", fa, name, le32(BUFF + fa));
+        }
+        else if (8 == size)
+        {
+            SP("%04x %s : %08x%08x", fa, name, le32(BUFF + fa), le32(BUFF + fa + 4));
+        }
+        else
+        {
+            SP("%04x %s : %08x%08x%08x%08x%08x", fa, name,
+                le32(BUFF + fa),
+                le32(BUFF + fa + 4),
+                le32(BUFF + fa + 8),
+                le32(BUFF + fa + 12),
+                le32(BUFF + fa + 16));
+        }
+
+        INSERT(parent);
+
+        fa += size;
+    }
+}
+
+/**
+ *\brief                        在树中插入FILE节点数据项
+ *\param[in]    tree            输出树
+ *\param[in]    parent          父节点句柄
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+static void insert_file_head(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image)
+{
+    char txt[256];
+
+    DATA data_item[] = {
+        { 2, "可执行文件的目标CPU类型        "},
+        { 2, "PE文件的节区的个数             "},
+        { 4, "文件创建时间                   "},
+        { 4, "符号表                         "},
+        { 4, "符号数量                       "},
+        { 2, "IMAGE_OPTIONAL_HEADER结构的大小"},
+        { 2, "指定文件的类型                 "}
+    };
+
+    int    fa               = image->file_fa; // FILE头节点在exe文件中的位置
+    char  *name             = 0;
+    UCHAR  size             = 0;
+
+    for (int i = 0; i < SIZEOF(data_item); i++)
+    {
+        name = data_item[i].name;
+        size = data_item[i].size;
+
+        if (2 == size)  // 2字节数据项
+        {
+            SP("%04x %s : %04x", fa, name, le16(BUFF + fa));
+        }
+        else
+        {
+            SP("%04x %s : %08x", fa, name, le32(BUFF + fa));
+        }
+
+        INSERT(parent);
+
+        fa += size;
+    }
+}
+
+/**
+ *\brief                        在树中插入OPTION节点数据项
+ *\param[in]    tree            输出树
+ *\param[in]    parent          父节点句柄
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+static void insert_option_head(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image)
+{
+    DATA data_item[] = {
+        { 2, "文件的状态类型                    "},
+        { 1, "主链接版本号                      "},
+        { 1, "次链接版本号                      "},
+        { 4, "代码节的大小                      "},
+        { 4, "已初始化数据块的大小              "},
+        { 4, "未初始化数据块的大小              "},
+        { 4, "程序执行的入口,相对虚拟地址,简称EP"},
+        { 4, "代码段的起始相对虚拟地址          "},
+        { 4, "数据段的起始相对虚拟地址          "},
+        { 4, "内存首选装载地址                  "},
+        { 4, "节在内存中的对齐值                "},
+        { 4, "节在文件中的对齐值                "},
+        { 2, "要求最低操作系统的主版本号        "},
+        { 2, "要求最低操作系统的次版本号        "},
+        { 2, "可执行文件的主版本号              "},
+        { 2, "可执行文件的次版本号              "},
+        { 2, "要求最低子系统的主版本号          "},
+        { 2, "要求最低子系统的次版本号          "},
+        { 4, "该成员变量是被保留的              "},
+        { 4, "可执行文件装入内存后的总大小      "},
+        { 4, "PE头的大小(DOS头,PE头,节表总和)   "},
+        { 4, "校验和                            "},
+        { 2, "可执行文件的子系统类型            "},
+        { 2, "指定DLL文件的属性                 "},
+        { 4, "为线程保留的栈大小                "},
+        { 4, "为线程已经提交的栈大小            "},
+        { 4, "为线程保留的堆大小                "},
+        { 4, "为线程已经提交的堆大小            "},
+        { 4, "被废弃的成员值                    "},
+        { 4, "数据目录项的个数                  "},
+        { 4, "导出表虚拟地址                    "},
+        { 4, "导出表大小                        "},
+        { 4, "导入表虚拟地址                    "},
+        { 4, "导入表大小                        "},
+        { 4, "资源表虚拟地址                    "},
+        { 4, "资源表大小                        "},
+        { 4, "异常虚拟地址                      "},
+        { 4, "异常大小                          "},
+        { 4, "安全证书虚拟地址                  "},
+        { 4, "安全证书大小                      "},
+        { 4, "重定位表虚拟地址                  "},
+        { 4, "重定位表大小                      "},
+        { 4, "调试信息虚拟地址                  "},
+        { 4, "调试信息大小                      "},
+        { 4, "版权所有虚拟地址                  "},
+        { 4, "版权所有大小                      "},
+        { 4, "全局指针虚拟地址                  "},
+        { 4, "全局指针大小                      "},
+        { 4, "TLS表虚拟地址                     "},
+        { 4, "TLS表大小                         "},
+        { 4, "加载配置虚拟地址                  "},
+        { 4, "加载配置大小                      "},
+        { 4, "绑定导入虚拟地址                  "},
+        { 4, "绑定导入大小                      "},
+        { 4, "IAT表虚拟地址                     "},
+        { 4, "IAT表大小                         "},
+        { 4, "延迟导入虚拟地址                  "},
+        { 4, "延迟导入大小                      "},
+        { 4, "COM虚拟地址                       "},
+        { 4, "COM大小                           "},
+        { 4, "保留虚拟地址                      "},
+        { 4, "保留大小                          "}
+    };
+
+    char txt[256]                = "";
+
+    int    fa                    = image->opt_fa; // OPTION头节点在exe文件中的位置
+    char  *name                  = 0;
+    UCHAR  size                  = 0;
+    int    wide                  = (PE_MAGIC_64 == image->magic);
+
+    for (int i = 0; i < SIZEOF(data_item); i++)
+    {
+        name = data_item[i].name;
+        size = data_item[i].size;
+
+        if (wide && 8 == i) // PE32+没有数据段地址
+        {
+            continue;
+        }
+
+        if (wide && (9 == i || (i >= 24 && i <= 27))) // PE32+的装载地址,栈和堆大小为8字节
+        {
+            size = 8;
+        }
+
+        if (1 == size)  // 1字节数据项
+        {
+            SP("%04x %s : %02x", fa, name, BUFF[fa]);
+        }
+        else if (2 == size)
+        {
+            SP("%04x %s : %04x", fa, name, le16(BUFF + fa));
+        }
+        else if (4 == size)
+        {
+            SP("%04x %s : %08x", fa, name, le32(BUFF + fa));
+        }
+        else
+        {
+            SP("%04x %s : %016llx", fa, name, (unsigned long long)le64(BUFF + fa));
+        }
+
+        INSERT(parent);
+
+        fa += size;
+    }
+}
+
+/**
+ *\brief                        在树中插入Rich头节点,解码后的各项和散列
+ *\param[in]    tree            输出树
+ *\param[in]    finger          指纹,有Rich头
+ *\return                       无
+ */
+static void insert_rich_head(PE_TREE *tree, PPE_FINGER finger)
+{
+    char txt[256];
+    char hex[HASH_MD5_SIZE * 2 + 1];
+
+    SP("%04x Rich头 密钥:%08x 校验和:%s 项数:%u", finger->rich_fa, finger->rich_key,
+       finger->rich_valid ? "正确" : "错误", finger->rich_count);
+
+    PE_NODE rich = INSERT(PE_ROOT);
+
+    for (DWORD i = 0; i < finger->rich_count; i++)
+    {
+        PPE_RICH_ENTRY entry = &finger->rich_entry[i];
+
+        SP("%04x 产品:%04x 版本:%5u 数量:%u", finger->rich_fa + 16 + i * 8, entry->prod, entry->build, entry->count);
+        INSERT(rich);
+    }
+
+    SP("%04x Rich头散列(MD5)           : %s", finger->rich_end, pe_finger_hex(finger->rich_md5, hex));
+    INSERT(rich);
+}
+
+void insert_dosnt_head(PE_TREE *tree, PPE_IMAGE image)
+{
+    char txt[256];
+
+    SP("0000 IMAGE_DOS_HEADER"); // 按文本输出时按插入顺序显示,每个节点后面紧接着插入子节点
+    PE_NODE top = INSERT(PE_ROOT);
+
+    insert_dos_head(tree, top, image);
+
+    if (NULL != image->finger && image->finger->rich) // DOS程序之后,NT头之前
+    {
+        insert_rich_head(tree, image->finger);
+    }
+
+    SP("%04x IMAGE_NT_HEADERS : %08x", image->nt_fa, le32(BUFF + image->nt_fa));
+    INSERT(PE_ROOT);
+
+    SP("%04x IMAGE_FILE_HEADER", image->file_fa);
+    PE_NODE file = INSERT(PE_ROOT);
+
+    insert_file_head(tree, file, image);
+
+    SP("%04x IMAGE_OPTIONAL_HEADER%s", image->opt_fa, (PE_MAGIC_64 == image->magic) ? "64" : "32");
+    PE_NODE option = INSERT(PE_ROOT);
+
+    insert_option_head(tree, option, image);
+}
+
+/**
+ *\brief                        在树中插入段信息数据项
+ *\param[in]    tree            输出树
+ *\param[in]    parent          父节点句柄
+ *\param[in]    image           解析结果
+ *\param[in]    id              SECTION的序号
+ *\return                       无
+ */
+static void insert_section_data(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image, int id)
+{
+    DATA data_item[] = {
+        { 8, "节名称                       "},
+        { 4, "被实际使用的区块大小         "},
+        { 4, "区块的相对虚拟地址           "},
+        { 4, "该块在磁盘中所占的大小       "},
+        { 4, "该块在磁盘文件中的偏移       "},
+        { 4, "在OBJ文件中使用，重定位偏移  "},
+        { 4, "行号表的偏移，调试中使用     "},
+        { 2, "在OBJ文件中使用，重定位项数目"},
+        { 2, "行号表中行号的数目           "},
+        { 4, "特性                         "}
+    };
+
+    char txt[256]           = "";
+    char sect_name[16]      = "";
+
+    int fa                  = image->section[id].fa; // 该段头在exe文件中的位置
+
+    char  *name             = 0;
+    UCHAR  size             = 0;
+
+    pe_section_name(image, id, sect_name);
+
+    for (int i = 0; i < SIZEOF(data_item); i++)
+    {
+        name = data_item[i].name;
+        size = data_item[i].size;
+
+        if (2 == size)  // 2字节数据项
+        {
+            SP("%04x %s : %04x", fa, name, le16(BUFF + fa));
+        }
+        else if (4 == size)
+        {
+            SP("%04x %s : %08x", fa, name, le32(BUFF + fa));
+        }
+        else
+        {
+            SP("%04x %s : %s", fa, name, sect_name);
+        }
+
+        INSERT(parent);
+
+        fa += size;
+    }
+}
+
+/**
+ *\brief                        在树中插入一段文件数据的熵和散列,只插入计算了的项
+ *\param[in]    tree            输出树
+ *\param[in]    parent          父节点句柄
+ *\param[in]    flags           计算了哪几项,PE_DIGEST_*
+ *\param[in]    item            统计结果
+ *\return                       无
+ */
+static void insert_digest(PE_TREE *tree, PE_NODE parent, DWORD flags, PPE_DIGEST_ITEM item)
+{
+    char txt[256] = "";
+
+    if (flags & PE_DIGEST_ENTROPY)
+    {
+        SP("%08x 数据的熵(位/字节)          : %.4f", item->fa, item->entropy);
+        INSERT(parent);
+    }
+
+    if (flags & PE_DIGEST_SHA256)
+    {
+        int len = SP("%08x 数据的SHA-256              : ", item->fa);
+
+        for (int i = 0; i < HASH_SHA256_SIZE; i++)
+        {
+            len += snprintf(txt + len, SIZEOF(txt) - len, "%02x", item->sha256[i]);
+        }
+
+        INSERT(parent);
+    }
+
+    if (flags & PE_DIGEST_XXH64)
+    {
+        SP("%08x 数据的XXH64                : %016llx", item->fa, (unsigned long long)item->xxh64);
+        INSERT(parent);
+    }
+}
+
+void insert_section_head(PE_TREE *tree, PPE_IMAGE image)
+{
+    char txt[256]         = "";
+    char name[16]         = "";
+    PE_NODE sub           = NULL;
+    PPE_DIGEST digest     = image->digest;
+
+    for (int i = 0; i < image->section_count; i++)
+    {
+        SP("%04x IMAGE_SECTION_HEADER %s", image->section[i].fa, pe_section_name(image, i, name));
+
+        sub = INSERT(PE_ROOT);
+
+        insert_section_data(tree, sub, image, i);
+
+        if (NULL != digest && i < digest->section_count)
+        {
+            insert_digest(tree, sub, digest->flags, &digest->section[i]);
+        }
+    }
+
+    if (NULL != digest && digest->overlay) // 最后一个节的文件数据之后
+    {
+        SP("%08x 附加数据 长度:%llu%s", digest->overlay_item.fa, (unsigned long long)digest->overlay_item.size,
+           digest->overlay_cert ? " 包括证书表" : "");
+
+        sub = INSERT(PE_ROOT);
+
+        insert_digest(tree, sub, digest->flags, &digest->overlay_item);
+    }
+}
+
+/**
+ *\brief                        在树中插入重定位数据块的数据项节点
+ *\param[in]  tree              输出树
+ *\param[in]  parent            树节点句柄
+ *\param[in]  image             解析结果
+ *\param[in]  block_id          块序号
+ *\param[in]  first             第一个数据项序号
+ *\param[in]  end               最后一个数据项序号+1
+ *\return                       无
+ */
+static void insert_reloc_entry(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image, DWORD block_id,
+                               DWORD first, DWORD end)
+{
+    char txt[256]                 = "";
+    PPE_RELOC_BLOCK block         = &image->reloc[block_id];
+    PPE_SECTION section           = &image->section[block->section];
+    DWORD va                      = section_delta(image, image->reloc_section);
+    DWORD fa                      = block->fa + sizeof(IMAGE_BASE_RELOCATION) + first * 2; // 重定位数据项在exe文件中的位置
+
+    UCHAR *list       = BUFF + block->fa + sizeof(IMAGE_BASE_RELOCATION); // 解析时已检查整个块都在文件内
+
+    DWORD base_va     = block->page - section->virtual_address;   // 页在节内的位置,每项只需加上偏移
+    DWORD base_fa     = section->raw_fa + base_va;
+
+    WORD  addr[256];    // 每次解码一段,低12位为重定位数据指向的地址
+    BYTE  type[256];    // 高4位为类型:0-对齐,3-需要修正的数据
+    ULONGLONG hist[PE_RELOC_TYPES] = { 0 };
+
+    for (UINT j = first; j < end; j += SIZEOF(addr))
+    {
+        UINT n = (end - j < SIZEOF(addr)) ? end - j : SIZEOF(addr);
+
+        pe_reloc_decode(list + j * sizeof(WORD), n, addr, type, hist);
+
+        for (UINT k = 0; k < n; k++)
+        {
+            DWORD addr_va = base_va + addr[k];
+            DWORD addr_fa = base_fa + addr[k];
+
+            if (PE_RELOC_DIR64 == type[k]) // 修正8字节
+            {
+                SP("%08x %08x 地址:%04x 类型:%x 节内位置:%08x %08x 数据:%016llx",
+                   fa, fa + va, addr[k], type[k],
+                   addr_fa, addr_va, VIEW_HAS(VIEW, addr_fa, 8) ? (unsigned long long)le64(BUFF + addr_fa) : 0ULL);
+            }
+            else
+            {
+                SP("%08x %08x 地址:%04x 类型:%x 节内位置:%08x %08x 数据:%08x",
+                   fa, fa + va, addr[k], type[k],
+                   addr_fa, addr_va, view_get32(VIEW, addr_fa));
+            }
+
+            INSERT(parent);
+
+            fa += 2;
+        }
+    }
+}
+
+/**
+ *\brief                        在树中插入重定位数据块信息节点,数据项为延迟子树
+ *\param[in]  tree              输出树
+ *\param[in]  parent            树节点句柄
+ *\param[in]  image             解析结果
+ *\param[in]  first             第一个块序号
+ *\param[in]  end               最后一个块序号+1
+ *\return                       无
+ */
+static void insert_reloc_block(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image, DWORD first, DWORD end)
+{
+    char txt[256]                 = "";
+    char name[16]                 = "";
+    DWORD va                      = section_delta(image, image->reloc_section);
+
+    for (DWORD i = first; i < end; i++)
+    {
+        PPE_RELOC_BLOCK block     = &image->reloc[i];
+        PPE_SECTION section       = &image->section[block->section];
+        DWORD fa                  = block->fa;
+
+        SP("%08x %08x 块:%02x 页:%08x 大小:%04x 数量:%02x 节:%08x %08x %s",
+           fa, fa + va, i,
+           block->page, block->size, block->count,
+           section->raw_fa, section->virtual_address, pe_section_name(image, block->section, name));
+
+        insert_children(tree, parent, image, txt, PE_LAZY(PE_LAZY_RELOC_BLOCK, i), block->count);
+    }
+}
+
+void insert_reloc_table(PE_TREE *tree, PPE_IMAGE image)
+{
+    char txt[256]       = "";
+    char name[16]       = "";
+    int  id             = image->reloc_section;
+
+    if (id < 0)
+    {
+        return; // 没有重定位表
+    }
+
+    DWORD fa            = image->reloc_fa;       // 重定位表在exe文件中的位置
+    DWORD va            = section_delta(image, id); // 内存位置与文件位置的偏移
+
+    SP("%08x %08x 重定位 所在节:%08x %08x %s", fa, fa + va,
+       image->section[id].raw_fa, image->section[id].virtual_address, pe_section_name(image, id, name));
+
+    insert_children(tree, PE_ROOT, image, txt, PE_LAZY(PE_LAZY_RELOC, 0), image->reloc_count);
+}
+
+/**
+ *\brief                        在树中插入导出表函数名称信息节点
+ *\param[in]  tree              输出树
+ *\param[in]  parent            树节点句柄
+ *\param[in]  image             解析结果
+ *\param[in]  va                相对地址
+ *\param[in]  first             第一个序号
+ *\param[in]  end               最后一个序号+1
+ *\return                       无
+ */
+static void insert_export_name(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image, DWORD va,
+                               DWORD first, DWORD end)
+{
+    char txt[256]     = "";
+
+    // 导出函数名列表在exe文件中的位置
+    DWORD fa          = image->export.names_fa + first * 4;
+    DWORD name_va     = 0;
+    DWORD name_fa     = 0;
+
+    PE_EXPORT_SYMBOL sym;
+
+    for (UINT i = first; i < end; i++)
+    {
+        name_va = view_get32(VIEW, fa);
+        name_fa = 0;
+        pe_rva_to_fa(image, name_va, &name_fa);
+
+        size_t len = SP("%08x %08x 名称:%08x %08x ", fa, fa + va, name_fa, name_va);
+
+        len = pe_str_append(txt, len, SIZEOF(txt), VIEW, name_fa);
+
+        // 通过序号表找到函数地址
+        if (0 == pe_export_ordinal(image, image->export.base + view_get16(VIEW, image->export.ords_fa + i * 2), &sym))
+        {
+            len += snprintf(txt + len, SIZEOF(txt) - len, " 序号:%04x 函数地址:%08x", sym.ordinal, sym.rva);
+            append_forward(txt, len, SIZEOF(txt), image, &sym);
+        }
+
+        INSERT(parent);
+
+        fa += 4;
+    }
+}
+
+/**
+ *\brief                        在树中插入导出表函数ID信息节点
+ *\param[in]    tree            输出树
+ *\param[in]    parent          树节点句柄
+ *\param[in]    image           解析结果
+ *\param[in]    va              相对地址
+ *\param[in]    first           第一个序号
+ *\param[in]    end             最后一个序号+1
+ *\return                       无
+ */
+static void insert_export_id(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image, DWORD va,
+                             DWORD first, DWORD end)
+{
+    char txt[256];
+
+    // 导出函数ID列表在exe文件中的位置
+    DWORD fa          = image->export.ords_fa + first * 2;
+    WORD  id          = 0;
+
+    for (UINT i = first; i < end; i++)
+    {
+        id = view_get16(VIEW, fa);
+
+        // Base函数序号开始值
+        SP("%08x %08x ID:%04x 序号:%04x", fa, fa + va, id, image->export.base + id);
+
+        INSERT(parent);
+
+        fa += 2;
+    }
+}
+
+/**
+ *\brief                        在树中插入导出表函数信息节点
+ *\param[in]  tree              输出树
+ *\param[in]  parent            树节点句柄
+ *\param[in]  image             解析结果
+ *\param[in]  va                相对地址
+ *\param[in]  first             第一个序号
+ *\param[in]  end               最后一个序号+1
+ *\return                       无
+ */
+static void insert_export_func(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image, DWORD va,
+                               DWORD first, DWORD end)
+{
+    char txt[256]     = "";
+
+    // 导出函数指针列表在exe文件中的位置
+    DWORD fa          = image->export.func_fa + first * 4;
+
+    PE_EXPORT_SYMBOL sym;
+
+    for (UINT i = first; i < end; i++)
+    {
+        size_t len = SP("%08x %08x 函数地址:%08x", fa, fa + va, view_get32(VIEW, fa));
+
+        if (0 == pe_export_ordinal(image, image->export.base + i, &sym))
+        {
+            len += snprintf(txt + len, SIZEOF(txt) - len, " 序号:%04x", sym.ordinal);
+            append_forward(txt, len, SIZEOF(txt), image, &sym);
+        }
+
+        INSERT(parent);
+
+        fa += 4;
+    }
+}
+
+void insert_export_table(PE_TREE *tree, PPE_IMAGE image)
+{
+    DATA data_item[] = {
+        { 4, "主链接版本号                      "},
+        { 4, "文件创建时间                      "},
+        { 2, "主链接版本号                      "},
+        { 2, "次链接版本号                      "},
+        { 4, "导出表文件名地址                  "},
+        { 4, "导出函数的起始序号                "},
+        { 4, "所有的导出函数的个数              "},
+        { 4, "以名字导出的函数的个数            "},
+        { 4, "导出的函数表地址                  "},
+        { 4, "导出的函数名称表地址              "},
+        { 4, "导出函数序号表地址                "}
+    };
+
+    int id = image->export_section;
+
+    if (id < 0)
+    {
+        return; // 没有导出表
+    }
+
+    DWORD fa          = image->export.fa;           // 导出表在exe文件中的位置
+    DWORD va          = section_delta(image, id);   // 内存位置与文件位置的偏移
+
+    char txt[256]     = "";
+    char sect_name[16]= "";
+    PE_NODE sub       = NULL;
+
+    SP("%08x %08x 导出表 所在节:%08x %08x %s", fa, fa + va,
+       image->section[id].raw_fa, image->section[id].virtual_address, pe_section_name(image, id, sect_name));
+
+    sub = INSERT(PE_ROOT);
+
+    char  *name;
+    UCHAR  size;
+
+    for (int i = 0; i < SIZEOF(data_item); i++)
+    {
+        name = data_item[i].name;
+        size = data_item[i].size;
+
+        size_t len;
+
+        if (2 == size)
+        {
+            len = SP("%08x %08x %s :%04x", fa, fa + va, name, le16(BUFF + fa));
+        }
+        else
+        {
+            len = SP("%08x %08x %s :%08x ", fa, fa + va, name, le32(BUFF + fa));
+        }
+
+        if (4 == i) // 名字
+        {
+            pe_str_append(txt, len, SIZEOF(txt), VIEW, image->export.name_fa);
+        }
+
+        if (8 == i) // 导出函数表
+        {
+            insert_children(tree, sub, image, txt, PE_LAZY(PE_LAZY_EXPORT_FUNC, 0), image->export.func_count);
+        }
+        else if (9 == i) // 导出函数名表
+        {
+            insert_children(tree, sub, image, txt, PE_LAZY(PE_LAZY_EXPORT_NAME, 0), image->export.name_count);
+        }
+        else if (10 == i) // 导出函数序号表,与名称表一一对应
+        {
+            insert_children(tree, sub, image, txt, PE_LAZY(PE_LAZY_EXPORT_ID, 0), image->export.name_count);
+        }
+        else
+        {
+            INSERT(sub);
+        }
+
+        fa += size;
+    }
+}
+
+/**
+ *\brief                        在树中插入导入表函数信息节点
+ *\param[in]    tree            输出树
+ *\param[in]    parent          树节点句柄
+ *\param[in]    image           解析结果
+ *\param[in]    func            函数列表
+ *\param[in]    count           函数数量
+ *\param[in]    va              相对地址
+ *\param[in]    names           1-显示类型和函数名,0-只显示thunk值(延迟导入的输入地址表)
+ *\return                       无
+ */
+static void insert_import_thunk(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image,
+                                PPE_IMPORT_FUNC func, DWORD count,
+                                DWORD va, int names)
+{
+    char txt[512]             = "";
+    PE_NODE item              = NULL;
+
+    for (DWORD i = 0; i < count; i++, func++)
+    {
+        if (!names)
+        {
+            SP("%08x %08x 值:%0*llx", func->fa, func->fa + va, (PE_MAGIC_64 == image->magic) ? 16 : 8,
+               (unsigned long long)func->value);
+            INSERT(parent);
+            continue;
+        }
+
+        // 0-按名称导入,存的是函数名地址. 1-按序号导入,存的是序号
+        if (PE_MAGIC_64 == image->magic)
+        {
+            SP("%08x %08x 类型:%x 值:%016llx", func->fa, func->fa + va, func->by_ordinal,
+               (unsigned long long)(func->value & 0x7FFFFFFFFFFFFFFFULL));
+        }
+        else
+        {
+            SP("%08x %08x 类型:%x 值:%08x", func->fa, func->fa + va, func->by_ordinal, (DWORD)func->value & 0x7FFFFFFF);
+        }
+
+        item = INSERT(parent);
+
+        if (!func->by_ordinal)
+        {
+            size_t len = SP("%08x %08x id:%04x 名称:", func->name_fa, func->name_fa + va, func->hint);
+
+            pe_str_append(txt, len, SIZEOF(txt), VIEW, func->name_fa ? func->name_fa + 2 : 0);
+
+            INSERT(item);
+        }
+    }
+}
+
+/**
+ *\brief                        在树中插入导入表库信息节点
+ *\param[in]    tree            输出树
+ *\param[in]    parent          树节点句柄
+ *\param[in]    image           解析结果
+ *\param[in]    lib_id          导入库序号
+ *\param[in]    va              相对地址
+ *\return                       无
+ */
+static void insert_import_library(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image,
+                                  DWORD lib_id, DWORD va)
+{
+    DATA data_item[] = {
+        { 4, "输入名称表的地址                  "},
+        { 4, "文件创建时间                      "},
+        { 4, "被转向API的索引                   "},
+        { 4, "库名称地址                        "},
+        { 4, "输入地址表的地址                  "}
+    };
+
+    char txt[512]     = "";
+    PPE_IMPORT_LIB lib = &image->lib[lib_id];
+    DWORD fa          = lib->fa;
+
+    size_t len = SP("%08x %08x 库名称地址:%08x %08x ", fa, fa + va, lib->name_fa, lib->name_rva);
+
+    pe_str_append(txt, len, SIZEOF(txt), VIEW, lib->name_fa);
+
+    parent = INSERT(parent);
+
+    UCHAR *data = BUFF + fa; // 解析时已检查整个库描述都在文件内
+    char  *name;
+    UCHAR  size;
+
+    for (int i = 0; i < SIZEOF(data_item); i++)
+    {
+        name = data_item[i].name;
+        size = data_item[i].size;
+
+        SP("%08x %08x %s :%08x", fa, fa + va, name, le32(data));
+
+        if (i == 0)
+        {
+            insert_children(tree, parent, image, txt, PE_LAZY(PE_LAZY_IMPORT_INT, lib_id), lib->func_count);
+        }
+        else if (i == 4)
+        {
+            insert_children(tree, parent, image, txt, PE_LAZY(PE_LAZY_IMPORT_IAT, lib_id), lib->iat_count);
+        }
+        else
+        {
+            INSERT(parent);
+        }
+
+        data += 4;
+        fa += size;
+    }
+}
+
+void insert_import_table(PE_TREE *tree, PPE_IMAGE image)
+{
+    char txt[512]     = "";
+    char name[16]     = "";
+    int  id           = image->import_section;
+
+    if (id < 0)
+    {
+        return; // 没有导入表
+    }
+
+    DWORD fa          = image->import_fa;           // 导入表在exe文件中的位置
+    DWORD va          = section_delta(image, id);   // 内存位置与文件位置的偏移
+
+    SP("%08x %08x 导入表 所在节:%08x %08x %s", fa, fa + va,
+       image->section[id].raw_fa, image->section[id].virtual_address, pe_section_name(image, id, name));
+
+    PE_NODE item = INSERT(PE_ROOT);
+
+    for (DWORD i = 0; i < image->lib_static; i++)
+    {
+        insert_import_library(tree, item, image, i, va);
+    }
+
+    if (NULL != image->finger && image->finger->imphash)
+    {
+        char hex[HASH_MD5_SIZE * 2 + 1];
+
+        SP("%08x %08x 导入表散列(imphash)          : %s 函数数:%u", fa, fa + va,
+           pe_finger_hex(image->finger->imphash_md5, hex), image->finger->imp_count);
+        INSERT(item);
+    }
+}
+
+/**
+ *\brief                        得到thunk列表所在节中相对虚拟地址与文件位置的差
+ *\param[in]    image           解析结果
+ *\param[in]    rva             thunk列表的相对虚拟地址
+ *\return                       相对虚拟地址-文件位置,不在任何节中时为0
+ */
+static DWORD thunk_delta(PPE_IMAGE image, DWORD rva)
+{
+    DWORD fa = 0;
+    int   id = pe_rva_to_fa(image, rva, &fa);
+
+    return (id >= 0) ? section_delta(image, id) : 0;
+}
+
+/**
+ *\brief                        在树中插入延迟导入表库信息节点
+ *\param[in]    tree            输出树
+ *\param[in]    parent          树节点句柄
+ *\param[in]    image           解析结果
+ *\param[in]    lib_id          导入库序号,在导入库列表中的位置
+ *\param[in]    va              相对地址
+ *\return                       无
+ */
+static void insert_delay_library(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image,
+                                 DWORD lib_id, DWORD va)
+{
+    DATA data_item[] = {
+        { 4, "属性                              "},
+        { 4, "库名称地址                        "},
+        { 4, "模块句柄的地址                    "},
+        { 4, "输入地址表的地址                  "},
+        { 4, "输入名称表的地址                  "},
+        { 4, "绑定输入地址表的地址              "},
+        { 4, "卸载信息表的地址                  "},
+        { 4, "文件创建时间                      "}
+    };
+
+    char txt[512]     = "";
+    PPE_IMPORT_LIB lib = &image->lib[lib_id];
+    DWORD fa          = lib->fa;
+
+    size_t len = SP("%08x %08x 库名称地址:%08x %08x ", fa, fa + va, lib->name_fa, lib->name_rva);
+
+    pe_str_append(txt, len, SIZEOF(txt), VIEW, lib->name_fa);
+
+    parent = INSERT(parent);
+
+    UCHAR *data = BUFF + fa; // 解析时已检查整个库描述都在文件内
+
+    for (int i = 0; i < SIZEOF(data_item); i++)
+    {
+        SP("%08x %08x %s :%08x", fa, fa + va, data_item[i].name, le32(data));
+
+        if (i == 3)
+        {
+            insert_children(tree, parent, image, txt, PE_LAZY(PE_LAZY_IMPORT_IAT, lib_id), lib->iat_count);
+        }
+        else if (i == 4)
+        {
+            insert_children(tree, parent, image, txt, PE_LAZY(PE_LAZY_IMPORT_INT, lib_id), lib->func_count);
+        }
+        else
+        {
+            INSERT(parent);
+        }
+
+        data += 4;
+        fa += data_item[i].size;
+    }
+}
+
+void insert_delay_table(PE_TREE *tree, PPE_IMAGE image)
+{
+    char txt[512]     = "";
+    char name[16]     = "";
+    int  id           = image->delay_section;
+
+    if (id < 0)
+    {
+        return; // 没有延迟导入表
+    }
+
+    DWORD fa          = image->delay_fa;
+    DWORD va          = section_delta(image, id);
+
+    SP("%08x %08x 延迟导入表 所在节:%08x %08x %s 库数:%u", fa, fa + va,
+       image->section[id].raw_fa, image->section[id].virtual_address, pe_section_name(image, id, name),
+       image->lib_delay);
+
+    PE_NODE item = INSERT(PE_ROOT);
+
+    for (DWORD i = 0; i < image->lib_delay; i++)
+    {
+        insert_delay_library(tree, item, image, image->lib_static + i, va);
+    }
+}
+
+void insert_bound_table(PE_TREE *tree, PPE_IMAGE image)
+{
+    char    txt[512] = "";
+    char    name[16] = "";
+    int     id       = image->bound_section;
+    DWORD   fa       = image->bound_fa;
+    DWORD   va       = (id >= 0) ? section_delta(image, id) : 0; // 在文件头中时相对虚拟地址等于文件位置
+    PE_NODE item     = NULL;
+    PE_NODE desc     = NULL;
+
+    if (PE_SECTION_HEAD == id)
+    {
+        SP("%08x %08x 绑定导入表 在文件头中 项数:%u", fa, fa + va, image->lib_bound);
+    }
+    else if (id >= 0)
+    {
+        SP("%08x %08x 绑定导入表 所在节:%08x %08x %s 项数:%u", fa, fa + va,
+           image->section[id].raw_fa, image->section[id].virtual_address, pe_section_name(image, id, name),
+           image->lib_bound);
+    }
+    else
+    {
+        return; // 没有绑定导入表
+    }
+
+    item = INSERT(PE_ROOT);
+
+    for (DWORD i = 0; i < image->lib_bound; i++)
+    {
+        PPE_IMPORT_LIB lib = &image->lib[image->lib_static + image->lib_delay + i];
+        size_t         len;
+
+        if (PE_IMPORT_BOUND == lib->type)
+        {
+            len = SP("%08x %08x 时间:%08x 转发引用数:%u 库名称:", lib->fa, lib->fa + va, lib->time, lib->forwarder);
+        }
+        else
+        {
+            len = SP("%08x %08x 时间:%08x 转发引用 库名称:", lib->fa, lib->fa + va, lib->time);
+        }
+
+        pe_str_append(txt, len, SIZEOF(txt), VIEW, lib->name_fa);
+
+        if (PE_IMPORT_BOUND == lib->type || NULL == desc)
+        {
+            desc = INSERT(item);
+        }
+        else
+        {
+            INSERT(desc); // 转发引用放在所属的描述下面
+        }
+    }
+}
+
+/**
+ *\brief                        得到资源目录项的名称:字符串名称,预定义类型或ID
+ *\param[in]  image             解析结果
+ *\param[in]  rsrc              资源表位置
+ *\param[in]  entry             目录项
+ *\param[in]  level             所在层,0-类型,1-名称,2-语言
+ *\param[out] name              名称
+ *\param[in]  size              name的大小
+ *\return                       name
+ */
+static char* rsrc_entry_name(PPE_IMAGE image, PPE_RSRC rsrc, PPE_RSRC_ENTRY entry, int level, char *name, size_t size)
+{
+    const char *type = (0 == level && !entry->named) ? pe_rsrc_type(entry->id) : NULL;
+
+    if (entry->named)
+    {
+        size_t len = pe_rsrc_name(image, rsrc, entry->id, name + 1, size - 2);
+
+        name[0]       = '"';
+        name[len + 1] = '"';
+        name[len + 2] = '\0';
+    }
+    else if (NULL != type)
+    {
+        snprintf(name, size, "%s(%u)", type, entry->id);
+    }
+    else
+    {
+        snprintf(name, size, (2 == level) ? "%04x" : "%u", entry->id);
+    }
+
+    return name;
+}
+
+/**
+ *\brief                        在树中插入一层资源目录的目录项
+ *\param[in]  tree              输出树
+ *\param[in]  parent            树节点句柄
+ *\param[in]  image             解析结果
+ *\param[in]  level             所在层,0-类型,1-名称,2-语言
+ *\param[in]  off               目录相对资源表的位置
+ *\param[in]  first             第一个目录项序号
+ *\param[in]  end               最后一个目录项序号+1
+ *\return                       无
+ */
+static void insert_rsrc_dir(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image, int level, DWORD off,
+                            DWORD first, DWORD end)
+{
+    static const char *label[PE_RSRC_LEVELS] = { "类型", "名称", "语言" };
+
+    char          txt[1024]   = "";
+    char          name[PE_RSRC_NAME_MAX * 3 + 3];
+    PE_RSRC       rsrc;
+    PE_RSRC_DIR   dir;
+    PE_RSRC_DIR   sub;
+    PE_RSRC_ENTRY entry;
+    PE_RSRC_DATA  data;
+
+    if (0 != pe_rsrc_root(image, &rsrc) || 0 != pe_rsrc_dir(image, &rsrc, off, &dir))
+    {
+        return;
+    }
+
+    DWORD va = section_delta(image, rsrc.section);
+
+    for (DWORD i = first; i < end && i < dir.count; i++)
+    {
+        pe_rsrc_entry(image, &rsrc, &dir, i, &entry);
+        rsrc_entry_name(image, &rsrc, &entry, level, name, sizeof(name));
+
+        DWORD fa = rsrc.fa + entry.off;
+
+        if (entry.dir && level < PE_RSRC_LEVELS - 1)
+        {
+            DWORD count = (0 == pe_rsrc_dir(image, &rsrc, entry.target, &sub)) ? sub.count : 0;
+
+            SP("%08x %08x %s:%s 目录:%08x 数量:%u", fa, fa + va, label[level], name, entry.target, count);
+
+            if (entry.target > PE_LAZY_ID(0xFFFFFFFF))
+            {
+                count = 0; // 位置放不进延迟子树标识,不展开
+            }
+
+            insert_children(tree, parent, image, txt, PE_LAZY(PE_LAZY_RSRC_TYPE + level + 1, entry.target), count);
+            continue;
+        }
+
+        if (entry.dir)
+        {
+            SP("%08x %08x %s:%s 目录:%08x 超过%d层,不展开", fa, fa + va, label[level], name, entry.target, PE_RSRC_LEVELS);
+        }
+        else if (0 != pe_rsrc_data(image, &rsrc, entry.target, &data))
+        {
+            SP("%08x %08x %s:%s 数据项:%08x 超出资源表", fa, fa + va, label[level], name, entry.target);
+        }
+        else if (data.section < 0)
+        {
+            SP("%08x %08x %s:%s 数据:%08x 大小:%08x 代码页:%u 不在任何节中", fa, fa + va, label[level], name,
+               data.rva, data.size, data.codepage);
+        }
+        else
+        {
+            SP("%08x %08x %s:%s 数据:%08x 大小:%08x 代码页:%u 文件位置:%08x", fa, fa + va, label[level], name,
+               data.rva, data.size, data.codepage, data.fa);
+        }
+
+        INSERT(parent);
+    }
+}
+
+/**
+ *\brief                        控制字符换成空格,一个节点只占一行
+ *\param[in,out] txt            节点文本
+ *\return                       无
+ */
+static void tree_printable(char *txt)
+{
+    for (; '\0' != *txt; txt++)
+    {
+        if ((UCHAR)*txt < 0x20)
+        {
+            *txt = ' ';
+        }
+    }
+}
+
+/**
+ *\brief                        在树中插入版本信息和清单节点
+ *\param[in]    tree            输出树
+ *\param[in]    version         版本信息
+ *\return                       无
+ */
+static void insert_version(PE_TREE *tree, PPE_VERSION version)
+{
+    char txt[PE_VERSION_VALUE_MAX * 3 + 128];
+    char ver[24];
+
+    if (version->info)
+    {
+        SP("%08x 版本信息 语言:%04x 大小:%u", version->info_fa, version->info_lang, version->info_size);
+        PE_NODE node = INSERT(PE_ROOT);
+
+        if (version->fixed)
+        {
+            SP("文件版本 : %s", pe_version_text(version->file_ms, version->file_ls, ver));
+            INSERT(node);
+            SP("产品版本 : %s", pe_version_text(version->product_ms, version->product_ls, ver));
+            INSERT(node);
+            SP("文件标志 : %08x 系统:%08x 类型:%08x", version->file_flags, version->file_os, version->file_type);
+            INSERT(node);
+        }
+
+        if (version->str_count > 0)
+        {
+            SP("字符串表 : %s", version->table);
+            tree_printable(txt);
+            PE_NODE table = INSERT(node);
+
+            for (DWORD i = 0; i < version->str_count; i++)
+            {
+                SP("%s : %s", version->str[i].key, version->str[i].value);
+                tree_printable(txt);
+                INSERT(table);
+            }
+        }
+    }
+
+    if (version->manifest)
+    {
+        SP("%08x 清单 ID:%u 大小:%u", version->manifest_fa, version->manifest_id, version->manifest_size);
+        INSERT(PE_ROOT);
+    }
+}
+
+void insert_rsrc_table(PE_TREE *tree, PPE_IMAGE image)
+{
+    char        txt[256]  = "";
+    char        name[16]  = "";
+    PE_RSRC     rsrc;
+    PE_RSRC_DIR dir;
+
+    if (0 == pe_rsrc_root(image, &rsrc)) // 资源表不在任何节中时不显示
+    {
+        int   id    = rsrc.section;
+        DWORD fa    = rsrc.fa;
+        DWORD va    = section_delta(image, id);
+        int   count = pe_rsrc_walk(image, &rsrc, NULL, NULL);
+        DWORD types = (0 == pe_rsrc_dir(image, &rsrc, 0, &dir)) ? dir.count : 0;
+
+        if (count < 0) // 目录项互相引用,展开后的数量可能是资源表大小的很多倍
+        {
+            SP("%08x %08x 资源表 所在节:%08x %08x %s 目录项总数超过资源表大小,不展开", fa, fa + va,
+               image->section[id].raw_fa, image->section[id].virtual_address, pe_section_name(image, id, name));
+            INSERT(PE_ROOT);
+        }
+        else
+        {
+            SP("%08x %08x 资源表 所在节:%08x %08x %s 类型数:%u 数据项数:%d", fa, fa + va,
+               image->section[id].raw_fa, image->section[id].virtual_address, pe_section_name(image, id, name),
+               types, count);
+            insert_children(tree, PE_ROOT, image, txt, PE_LAZY(PE_LAZY_RSRC_TYPE, 0), types);
+        }
+    }
+
+    if (NULL != image->version)
+    {
+        insert_version(tree, image->version);
+    }
+}
+
+/**
+ *\brief                        在树中插入调试目录项的数据项
+ *\param[in]    tree            输出树
+ *\param[in]    parent          父节点句柄
+ *\param[in]    image           解析结果
+ *\param[in]    fa              目录项在文件中的位置
+ *\param[in]    va              相对虚拟地址-文件位置
+ *\return                       无
+ */
+static void insert_debug_entry(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image, DWORD fa, DWORD va)
+{
+    char txt[256];
+
+    DATA data_item[] = {
+        { 4, "特征                 "},
+        { 4, "时间                 "},
+        { 2, "主版本号             "},
+        { 2, "次版本号             "},
+        { 4, "类型                 "},
+        { 4, "数据大小             "},
+        { 4, "数据的相对虚拟地址   "},
+        { 4, "数据在文件中的位置   "}
+    };
+
+    for (int i = 0; i < SIZEOF(data_item); i++)
+    {
+        if (2 == data_item[i].size)
+        {
+            SP("%08x %08x %s : %04x", fa, fa + va, data_item[i].name, le16(BUFF + fa));
+        }
+        else
+        {
+            SP("%08x %08x %s : %08x", fa, fa + va, data_item[i].name, le32(BUFF + fa));
+        }
+
+        INSERT(parent);
+
+        fa += data_item[i].size;
+    }
+}
+
+/**
+ *\brief                        在树中插入解码了的调试记录
+ *\param[in]    tree            输出树
+ *\param[in]    parent          调试目录节点
+ *\param[in]    image           解析结果
+ *\param[in]    debug           调试目录
+ *\return                       无
+ */
+static void insert_debug_record(PE_TREE *tree, PE_NODE parent, PPE_IMAGE image, PPE_DEBUG debug)
+{
+    char txt[PE_DEBUG_KEY_MAX + 64];
+    char key[PE_DEBUG_KEY_MAX];
+
+    if (debug->codeview)
+    {
+        size_t len;
+
+        if (PE_DEBUG_RSDS == debug->cv_format)
+        {
+            len = SP("%08x CodeView RSDS GUID:%s age:%u PDB:", debug->cv_fa, pe_debug_guid(debug->cv_guid, key), debug->cv_age);
+        }
+        else
+        {
+            len = SP("%08x CodeView NB10 签名:%08x age:%u PDB:", debug->cv_fa, debug->cv_signature, debug->cv_age);
+        }
+
+        pe_str_append(txt, len, SIZEOF(txt), VIEW, debug->cv_path_fa); // 路径不超过PE_DEBUG_PATH_MAX,txt放得下
+        tree_printable(txt);
+
+        PE_NODE node = INSERT(parent);
+
+        pe_debug_key(image, key, sizeof(key));
+        SP("符号键 : %s", key);
+        tree_printable(txt);
+        INSERT(node);
+    }
+
+    if (debug->pogo)
+    {
+        SP("POGO 标记:%08x 项数:%u", debug->pogo_signature, debug->pogo_count);
+        INSERT(parent);
+    }
+
+    if (debug->repro)
+    {
+        size_t len = SP("repro 散列长度:%u", debug->repro_len);
+
+        for (DWORD i = 0; i < debug->repro_len && len + 3 < SIZEOF(txt); i++)
+        {
+            len += snprintf(txt + len, SIZEOF(txt) - len, "%s%02x", (0 == i) ? " " : "", BUFF[debug->repro_fa + i]);
+        }
+
+        INSERT(parent);
+    }
+
+    if (debug->pdb)
+    {
+        SP("%08x 嵌入的可移植PDB 解压后大小:%u 压缩数据大小:%u", debug->pdb_fa, debug->pdb_size, debug->pdb_stored);
+        INSERT(parent);
+    }
+}
+
+void insert_debug_table(PE_TREE *tree, PPE_IMAGE image)
+{
+    char  txt[256] = "";
+    char  name[16] = "";
+    DWORD fa       = 0;
+    DWORD count    = 0;
+    int   id       = pe_debug_dir(image, &fa, &count);
+
+    if (id < 0)
+    {
+        return; // 没有调试目录或不在任何节中
+    }
+
+    DWORD va = section_delta(image, id);
+
+    SP("%08x %08x 调试目录 所在节:%08x %08x %s 项数:%u", fa, fa + va,
+       image->section[id].raw_fa, image->section[id].virtual_address, pe_section_name(image, id, name), count);
+
+    PE_NODE item = INSERT(PE_ROOT);
+
+    for (DWORD i = 0; i < count; i++)
+    {
+        DWORD       entry = fa + i * sizeof(IMAGE_DEBUG_DIRECTORY);
+        DWORD       type  = VIEW_FIELD32(BUFF + entry, IMAGE_DEBUG_DIRECTORY, Type);
+        const char *text  = pe_debug_type(type);
+
+        if (NULL != text)
+        {
+            SP("%08x %08x %s 大小:%u", entry, entry + va, text, VIEW_FIELD32(BUFF + entry, IMAGE_DEBUG_DIRECTORY, SizeOfData));
+        }
+        else
+        {
+            SP("%08x %08x 类型:%u 大小:%u", entry, entry + va, type, VIEW_FIELD32(BUFF + entry, IMAGE_DEBUG_DIRECTORY, SizeOfData));
+        }
+
+        insert_debug_entry(tree, INSERT(item), image, entry, va);
+    }
+
+    if (NULL != image->debug)
+    {
+        insert_debug_record(tree, item, image, image->debug);
+    }
+}
+
+/**
+ *\brief                        在树中插入签名的检查结果,摘要和参与散列的各段
+ *\param[in]    tree            输出树
+ *\param[in]    parent          证书表节点,没有证书表时为根节点
+ *\param[in]    auth            签名和摘要
+ *\return                       无
+ */
+static void insert_auth_record(PE_TREE *tree, PE_NODE parent, PPE_AUTH auth)
+{
+    char txt[256];
+
+    SP("Authenticode %s 摘要算法:%s 证书数:%u 签名者数:%u", pe_auth_status(auth), pe_auth_alg(auth->hash_alg),
+       auth->certs, auth->signers);
+
+    PE_NODE node = INSERT(parent);
+    size_t  len  = 0;
+
+    if (auth->pkcs7)
+    {
+        len = SP("签名中的摘要 : ");
+
+        for (DWORD i = 0; i < auth->signed_len; i++)
+        {
+            len += snprintf(txt + len, SIZEOF(txt) - len, "%02x", auth->signed_digest[i]);
+        }
+
+        INSERT(node);
+    }
+
+    if (auth->hashed)
+    {
+        len = SP("计算的摘要   : ");
+
+        for (DWORD i = 0; i < auth->digest_len; i++)
+        {
+            len += snprintf(txt + len, SIZEOF(txt) - len, "%02x", auth->digest[i]);
+        }
+
+        INSERT(node);
+    }
+
+    len = SP("散列的各段   :");
+
+    for (DWORD i = 0; i < auth->range_count && len + 40 < SIZEOF(txt); i++)
+    {
+        len += snprintf(txt + len, SIZEOF(txt) - len, " [%llx,%llx)", (unsigned long long)auth->range[i].fa,
+                        (unsigned long long)(auth->range[i].fa + auth->range[i].size));
+    }
+
+    INSERT(node);
+}
+
+void insert_security_table(PE_TREE *tree, PPE_IMAGE image)
+{
+    char  txt[256] = "";
+    DWORD fa       = (image->dir_count > PE_DIR_SECURITY) ? image->dir[PE_DIR_SECURITY].VirtualAddress : 0;
+    DWORD size     = (image->dir_count > PE_DIR_SECURITY) ? image->dir[PE_DIR_SECURITY].Size : 0;
+
+    if (0 == fa || 0 == size)
+    {
+        if (NULL != image->auth) // 没有签名时也可以计算摘要
+        {
+            insert_auth_record(tree, PE_ROOT, image->auth);
+        }
+
+        return;
+    }
+
+    if (!VIEW_HAS(VIEW, fa, size))
+    {
+        SP("%08x 证书表 大小:%u 超出文件", fa, size);
+        INSERT(PE_ROOT);
+        return;
+    }
+
+    SP("%08x 证书表 大小:%u", fa, size); // 地址是文件位置,不装入内存
+
+    PE_NODE   item  = INSERT(PE_ROOT);
+    ULONGLONG pos   = 0;
+    DWORD     count = 0;
+
+    while (count < PE_AUTH_CERT_MAX && pos + PE_AUTH_HEAD <= size)
+    {
+        DWORD len  = le32(BUFF + fa + pos);
+        WORD  type = le16(BUFF + fa + pos + 6);
+
+        if (len < PE_AUTH_HEAD || len > size - pos)
+        {
+            break;
+        }
+
+        SP("%08x WIN_CERTIFICATE 长度:%u 版本:%04x 类型:%04x%s", fa + (DWORD)pos, len, le16(BUFF + fa + pos + 4), type,
+           (PE_AUTH_TYPE_PKCS7 == type) ? " PKCS#7" : "");
+        INSERT(item);
+
+        pos += ((ULONGLONG)len + 7) & ~(ULONGLONG)7;
+        count++;
+    }
+
+    if (NULL != image->auth)
+    {
+        insert_auth_record(tree, item, image->auth);
+    }
+}
+
+DWORD pe_tree_count(PPE_IMAGE image, DWORD lazy)
+{
+    DWORD id = PE_LAZY_ID(lazy);
+
+    switch (PE_LAZY_TYPE(lazy))
+    {
+        case PE_LAZY_RELOC:
+            return image->reloc_count;
+
+        case PE_LAZY_RELOC_BLOCK:
+            return (id < image->reloc_count) ? image->reloc[id].count : 0;
+
+        case PE_LAZY_IMPORT_INT:
+            return (id < image->lib_count) ? image->lib[id].func_count : 0;
+
+        case PE_LAZY_IMPORT_IAT:
+            return (id < image->lib_count) ? image->lib[id].iat_count : 0;
+
+        case PE_LAZY_EXPORT_FUNC:
+            return image->export.func_count;
+
+        case PE_LAZY_EXPORT_NAME:
+        case PE_LAZY_EXPORT_ID:
+            return image->export.name_count;
+
+        case PE_LAZY_RSRC_TYPE:
+        case PE_LAZY_RSRC_NAME:
+        case PE_LAZY_RSRC_LANG:
+        {
+            PE_RSRC     rsrc;
+            PE_RSRC_DIR dir;
+
+            if (0 == pe_rsrc_root(image, &rsrc) && 0 == pe_rsrc_dir(image, &rsrc, id, &dir))
+            {
+                return dir.count;
+            }
+
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+ULONGLONG pe_tree_weight(PPE_IMAGE image, DWORD lazy, DWORD first, DWORD count)
+{
+    ULONGLONG weight = count;
+
+    if (PE_LAZY_RELOC == PE_LAZY_TYPE(lazy)) // 每个块下还有全部数据项
+    {
+        for (DWORD i = first; i < first + count && i < image->reloc_count; i++)
+        {
+            weight += image->reloc[i].count;
+        }
+    }
+    else if (PE_LAZY_IMPORT_INT == PE_LAZY_TYPE(lazy) || PE_LAZY_IMPORT_IAT == PE_LAZY_TYPE(lazy))
+    {
+        weight *= 2; // 按名称导入的函数还有名称节点
+    }
+    else if (PE_LAZY_RSRC_TYPE == PE_LAZY_TYPE(lazy) || PE_LAZY_RSRC_NAME == PE_LAZY_TYPE(lazy))
+    {
+        weight *= (PE_LAZY_RSRC_TYPE == PE_LAZY_TYPE(lazy)) ? 4 : 2; // 下面还有名称层和语言层,按每个名称一种语言估计
+    }
+
+    return weight;
+}
+
+void pe_tree_expand_range(PE_TREE *tree, PPE_IMAGE image, PE_NODE node, DWORD lazy, DWORD first, DWORD count)
+{
+    DWORD id    = PE_LAZY_ID(lazy);
+    DWORD total = pe_tree_count(image, lazy);
+
+    if (first >= total)
+    {
+        return;
+    }
+
+    DWORD end = (count < total - first) ? first + count : total;
+
+    switch (PE_LAZY_TYPE(lazy))
+    {
+        case PE_LAZY_RELOC:
+            insert_reloc_block(tree, node, image, first, end);
+            break;
+
+        case PE_LAZY_RELOC_BLOCK:
+            insert_reloc_entry(tree, node, image, id, first, end);
+            break;
+
+        case PE_LAZY_IMPORT_INT:
+            insert_import_thunk(tree, node, image, image->lib[id].func + first, end - first,
+                                (PE_IMPORT_STATIC == image->lib[id].type) ? section_delta(image, image->import_section) :
+                                thunk_delta(image, image->lib[id].int_rva), 1);
+            break;
+
+        case PE_LAZY_IMPORT_IAT:
+            insert_import_thunk(tree, node, image, image->lib[id].iat + first, end - first,
+                                (PE_IMPORT_STATIC == image->lib[id].type) ? section_delta(image, image->import_section) :
+                                thunk_delta(image, image->lib[id].iat_rva), PE_IMPORT_STATIC == image->lib[id].type);
+            break;
+
+        case PE_LAZY_EXPORT_FUNC:
+            insert_export_func(tree, node, image, section_delta(image, image->export_section), first, end);
+            break;
+
+        case PE_LAZY_EXPORT_NAME:
+            insert_export_name(tree, node, image, section_delta(image, image->export_section), first, end);
+            break;
+
+        case PE_LAZY_EXPORT_ID:
+            insert_export_id(tree, node, image, section_delta(image, image->export_section), first, end);
+            break;
+
+        case PE_LAZY_RSRC_TYPE:
+        case PE_LAZY_RSRC_NAME:
+        case PE_LAZY_RSRC_LANG:
+            insert_rsrc_dir(tree, node, image, PE_LAZY_TYPE(lazy) - PE_LAZY_RSRC_TYPE, id, first, end);
+            break;
+    }
+}
+
+void pe_tree_expand(PE_TREE *tree, PPE_IMAGE image, PE_NODE node, DWORD lazy)
+{
+    pe_tree_expand_range(tree, image, node, lazy, 0, pe_tree_count(image, lazy));
+}
+
+void pe_insert_tree(PE_TREE *tree, PPE_IMAGE image)
+{
+    insert_dosnt_head(tree, image);
+    insert_section_head(tree, image);
+    insert_export_table(tree, image);
+    insert_import_table(tree, image);
+    insert_delay_table(tree, image);
+    insert_bound_table(tree, image);
+    insert_debug_table(tree, image);
+    insert_security_table(tree, image);
+    insert_reloc_table(tree, image);
+    insert_rsrc_table(tree, image);
+}
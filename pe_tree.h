@@ -0,0 +1,197 @@
+/**
+ *\file     pe_tree.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    PE解析结果树形输出接口定义
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件,从pe.h中分离
+ *          2026.10.18|大的子树(重定位块,导入函数,导出函数)改为展开时才插入
+ *          2026.10.18|增加按子节点范围展开延迟子树,可以分段由不同的线程输出
+ *          2026.10.18|增加资源表和版本信息
+ *          2026.10.18|增加延迟导入表和绑定导入表
+ *          2026.10.18|增加调试目录
+ *          2026.10.18|增加证书表
+ */
+#ifndef _PE_TREE_H_
+#define _PE_TREE_H_
+
+#include "pe.h"
+
+#define PE_ROOT                 NULL                                        ///< 根节点
+
+#define PE_LAZY_RELOC           1                                           ///< 延迟子树:重定位表的所有块
+#define PE_LAZY_RELOC_BLOCK     2                                           ///< 延迟子树:重定位块的数据项,id为块序号
+#define PE_LAZY_IMPORT_INT      3                                           ///< 延迟子树:输入名称表,id为库在导入库列表中的序号
+#define PE_LAZY_IMPORT_IAT      4                                           ///< 延迟子树:输入地址表,id为库在导入库列表中的序号
+#define PE_LAZY_EXPORT_FUNC     5                                           ///< 延迟子树:导出函数表
+#define PE_LAZY_EXPORT_NAME     6                                           ///< 延迟子树:导出函数名称表
+#define PE_LAZY_EXPORT_ID       7                                           ///< 延迟子树:导出函数序号表
+#define PE_LAZY_RSRC_TYPE       8                                           ///< 延迟子树:资源类型层,id为目录相对资源表的位置
+#define PE_LAZY_RSRC_NAME       9                                           ///< 延迟子树:资源名称层,id为目录相对资源表的位置
+#define PE_LAZY_RSRC_LANG       10                                          ///< 延迟子树:资源语言层,id为目录相对资源表的位置
+
+#define PE_LAZY(type, id)       (((DWORD)(type) << 28) | ((id) & 0x0FFFFFFF)) ///< 延迟子树标识,高4位类型,低28位序号,不为0
+#define PE_LAZY_TYPE(lazy)      ((lazy) >> 28)                              ///< 延迟子树类型
+#define PE_LAZY_ID(lazy)        ((lazy) & 0x0FFFFFFF)                       ///< 延迟子树序号
+
+typedef void *PE_NODE;                                                      ///< 树节点句柄
+
+/**
+ *\brief                        插入树节点回调函数
+ *\param[in]    param           回调参数
+ *\param[in]    parent          父节点句柄,PE_ROOT为根
+ *\param[in]    txt             节点文本,UTF-8
+ *\return                       新节点句柄
+ */
+typedef PE_NODE (*pe_insert_proc)(void *param, PE_NODE parent, const char *txt);
+
+/**
+ *\brief                        插入延迟子树节点回调函数,节点有子节点但还没有插入,
+ *                              展开时调用pe_tree_expand插入子节点
+ *\param[in]    param           回调参数
+ *\param[in]    parent          父节点句柄,PE_ROOT为根
+ *\param[in]    txt             节点文本,UTF-8
+ *\param[in]    lazy            延迟子树标识,PE_LAZY
+ *\return                       新节点句柄
+ */
+typedef PE_NODE (*pe_lazy_proc)(void *param, PE_NODE parent, const char *txt, DWORD lazy);
+
+typedef struct _PE_TREE                                                     ///  输出树
+{
+    pe_insert_proc insert;                                                  ///< 插入节点回调
+    void          *param;                                                   ///< 回调参数
+    pe_lazy_proc   lazy;                                                    ///< 插入延迟子树节点回调,NULL时立即插入全部子节点
+
+} PE_TREE, *PPE_TREE;
+
+/**
+ *\brief                        在树中插入DOS,NT,FILE,OPTION头节点和数据项节点
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void insert_dosnt_head(PE_TREE *tree, PPE_IMAGE image);
+
+/**
+ *\brief                        在树中插入SECTION头节点
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void insert_section_head(PE_TREE *tree, PPE_IMAGE image);
+
+/**
+ *\brief                        在树中插入导出表信息节点
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void insert_export_table(PE_TREE *tree, PPE_IMAGE image);
+
+/**
+ *\brief                        在树中插入导入表信息节点
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void insert_import_table(PE_TREE *tree, PPE_IMAGE image);
+
+/**
+ *\brief                        在树中插入延迟导入表信息节点
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void insert_delay_table(PE_TREE *tree, PPE_IMAGE image);
+
+/**
+ *\brief                        在树中插入绑定导入表信息节点,转发引用放在所属的描述下面
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void insert_bound_table(PE_TREE *tree, PPE_IMAGE image);
+
+/**
+ *\brief                        在树中插入调试目录节点,解码了调试目录时插入解码的记录
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void insert_debug_table(PE_TREE *tree, PPE_IMAGE image);
+
+/**
+ *\brief                        在树中插入证书表节点,检查了签名时插入签名中的摘要和计算的摘要
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void insert_security_table(PE_TREE *tree, PPE_IMAGE image);
+
+/**
+ *\brief                        在树中插入重定位信息节点
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void insert_reloc_table(PE_TREE *tree, PPE_IMAGE image);
+
+/**
+ *\brief                        在树中插入资源表节点,计算了版本信息时插入版本信息节点
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void insert_rsrc_table(PE_TREE *tree, PPE_IMAGE image);
+
+/**
+ *\brief                        展开延迟子树,插入子节点,子节点中大的子树仍是延迟的
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果,与插入延迟子树节点时相同
+ *\param[in]    node            延迟子树节点句柄
+ *\param[in]    lazy            延迟子树标识,PE_LAZY
+ *\return                       无
+ */
+void pe_tree_expand(PE_TREE *tree, PPE_IMAGE image, PE_NODE node, DWORD lazy);
+
+/**
+ *\brief                        展开延迟子树的一部分子节点,各段依次输出的结果与整个展开相同
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果,与插入延迟子树节点时相同
+ *\param[in]    node            延迟子树节点句柄
+ *\param[in]    lazy            延迟子树标识,PE_LAZY
+ *\param[in]    first           第一个子节点序号
+ *\param[in]    count           子节点数量,超出时到最后一个
+ *\return                       无
+ */
+void pe_tree_expand_range(PE_TREE *tree, PPE_IMAGE image, PE_NODE node, DWORD lazy, DWORD first, DWORD count);
+
+/**
+ *\brief                        得到延迟子树的子节点数量
+ *\param[in]    image           解析结果
+ *\param[in]    lazy            延迟子树标识,PE_LAZY
+ *\return                       子节点数量
+ */
+DWORD pe_tree_count(PPE_IMAGE image, DWORD lazy);
+
+/**
+ *\brief                        估计展开一部分子节点要输出的节点数,包括子节点下的延迟子树,用于分段
+ *\param[in]    image           解析结果
+ *\param[in]    lazy            延迟子树标识,PE_LAZY
+ *\param[in]    first           第一个子节点序号
+ *\param[in]    count           子节点数量
+ *\return                       节点数
+ */
+ULONGLONG pe_tree_weight(PPE_IMAGE image, DWORD lazy, DWORD first, DWORD count);
+
+/**
+ *\brief                        在树中插入全部节点
+ *\param[in]    tree            输出树
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+void pe_insert_tree(PE_TREE *tree, PPE_IMAGE image);
+
+#endif
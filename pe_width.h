@@ -0,0 +1,148 @@
+/**
+ *\file     pe_width.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    按位宽特化的解析函数模板,由pe.c分别按PE32和PE32+包含两次,不能单独使用
+ *          位宽在编译时确定,thunk和头字段的循环中不再判断位宽
+ *          包含前需要定义:
+ *          宏|说明
+ *          -|-
+ *          PE_FUNC(name)|函数名加位宽后缀
+ *          PE_OPT_HEADER|IMAGE_OPTIONAL_HEADER32或IMAGE_OPTIONAL_HEADER64
+ *          PE_THUNK|thunk数值类型,DWORD或ULONGLONG
+ *          PE_THUNK_READ(p)|读thunk,le32或le64
+ *          PE_ORDINAL_FLAG|按序号导入标记,thunk的最高位
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|函数列表从内存池分配
+ *          2026.10.18|thunk值可以是虚拟地址,可以只取thunk值不解析名称
+ */
+
+/**
+ *\brief                        解析OPTION头,数据目录只读NumberOfRvaAndSizes和OPTION头大小范围内的项
+ *\param[in]    image           解析结果
+ *\param[in]    opt             OPTION头,pe_check已检查整个结构都在文件内
+ *\return                       无
+ */
+static void PE_FUNC(parse_optional)(PPE_IMAGE image, UCHAR *opt)
+{
+    image->magic           = VIEW_FIELD16(opt, PE_OPT_HEADER, Magic);
+    image->subsystem       = VIEW_FIELD16(opt, PE_OPT_HEADER, Subsystem);
+    image->entry           = VIEW_FIELD32(opt, PE_OPT_HEADER, AddressOfEntryPoint);
+    image->image_base      = PE_THUNK_READ(opt + offsetof(PE_OPT_HEADER, ImageBase));
+    image->section_align   = VIEW_FIELD32(opt, PE_OPT_HEADER, SectionAlignment);
+    image->file_align      = VIEW_FIELD32(opt, PE_OPT_HEADER, FileAlignment);
+    image->image_size      = VIEW_FIELD32(opt, PE_OPT_HEADER, SizeOfImage);
+    image->dir_count       = VIEW_FIELD32(opt, PE_OPT_HEADER, NumberOfRvaAndSizes);
+
+    DWORD count = image->dir_count;
+    DWORD space = 0; // OPTION头中数据目录能放下的项数
+
+    if (image->opt_size > offsetof(PE_OPT_HEADER, DataDirectory))
+    {
+        space = (image->opt_size - offsetof(PE_OPT_HEADER, DataDirectory)) / sizeof(IMAGE_DATA_DIRECTORY);
+    }
+
+    if (count > space)
+    {
+        count = space;
+    }
+
+    if (count > IMAGE_NUMBEROF_DIRECTORY_ENTRIES)
+    {
+        count = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+    }
+
+    UCHAR *dir = opt + offsetof(PE_OPT_HEADER, DataDirectory);
+
+    for (DWORD i = 0; i < count; i++, dir += sizeof(IMAGE_DATA_DIRECTORY))
+    {
+        image->dir[i].VirtualAddress = VIEW_FIELD32(dir, IMAGE_DATA_DIRECTORY, VirtualAddress);
+        image->dir[i].Size           = VIEW_FIELD32(dir, IMAGE_DATA_DIRECTORY, Size);
+    }
+}
+
+/**
+ *\brief                        解析导入函数列表
+ *\param[in]    image           解析结果
+ *\param[in]    rva             thunk列表的相对虚拟地址
+ *\param[in]    base            按名称导入时thunk值减去base是函数名的相对虚拟地址,旧格式的延迟导入为ImageBase
+ *\param[in]    names           1-解析序号和函数名,0-只取thunk值(延迟导入的输入地址表存的是桩代码地址)
+ *\param[out]   count           函数数量
+ *\return                       函数列表,没有函数或出错时返回NULL
+ */
+static PPE_IMPORT_FUNC PE_FUNC(parse_import_thunk)(PPE_IMAGE image, DWORD rva, ULONGLONG base, int names, DWORD *count)
+{
+    PPE_VIEW        view = &image->view;
+    PPE_IMPORT_FUNC func = NULL;
+    DWORD           fa   = 0;
+
+    *count = 0;
+
+    if (pe_rva_to_fa(image, rva, &fa) < 0)
+    {
+        parse_error(image, PE_ERR_RVA, "import", 0);
+        return NULL;
+    }
+
+    // 一次算出文件内最多的thunk数量,循环中不再检查
+    ULONGLONG max   = (fa < view->size) ? (view->size - fa) / sizeof(PE_THUNK) : 0;
+    UCHAR    *thunk = view->data + fa;
+
+    while (*count < max && 0 != PE_THUNK_READ(thunk + *count * sizeof(PE_THUNK)))
+    {
+        (*count)++;
+    }
+
+    if (*count == max)
+    {
+        parse_error(image, PE_ERR_RANGE, "import", fa); // 没有结尾的0
+    }
+
+    if (0 == *count)
+    {
+        return NULL;
+    }
+
+    func = pe_arena_array(ARENA(image), *count, sizeof(PE_IMPORT_FUNC));
+
+    if (NULL == func)
+    {
+        parse_error(image, PE_ERR_MEMORY, "import", fa);
+        *count = 0;
+        return NULL;
+    }
+
+    for (DWORD i = 0; i < *count; i++, thunk += sizeof(PE_THUNK))
+    {
+        PE_THUNK value = PE_THUNK_READ(thunk);
+
+        func[i].fa         = fa + i * sizeof(PE_THUNK);
+        func[i].value      = value;
+
+        if (!names)
+        {
+            continue;
+        }
+
+        func[i].by_ordinal = (0 != (value & PE_ORDINAL_FLAG)); // 最高位为导入类型:0-按名称导入,1-按序号导入
+
+        if (func[i].by_ordinal)
+        {
+            func[i].ordinal = (WORD)value;
+        }
+        else if (pe_rva_to_fa(image, (DWORD)(value - base), &func[i].name_fa) < 0)
+        {
+            parse_error(image, PE_ERR_RVA, "import", func[i].fa);
+        }
+        else if (0 != view_u16(view, func[i].name_fa, &func[i].hint))
+        {
+            parse_error(image, PE_ERR_RANGE, "import", func[i].name_fa);
+            func[i].name_fa = 0;
+        }
+    }
+
+    return func;
+}
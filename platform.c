@@ -0,0 +1,898 @@
+/**
+ *\file     platform.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    平台相关接口实现
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加标准输出二进制模式
+ *          2026.10.18|增加文件属性和替换
+ *          2026.10.18|增加文件标识和加锁追加写
+ *          2026.10.18|增加原子加和让出CPU
+ *          2026.10.18|增加按需占用内存的地址空间,标准输入二进制模式
+ *          2026.10.18|增加线程CPU时间和缺页次数
+ *          2026.10.18|增加按位置读文件
+ *          2026.10.18|Windows下保留地址空间时不提交,增加按需提交
+ *          2026.10.18|Windows下线程的缺页次数为0,不用进程的缺页次数
+ */
+#ifndef _WIN32
+#define _GNU_SOURCE // RUSAGE_THREAD
+#endif
+
+#include "platform.h"
+
+#ifdef _WIN32
+#include <psapi.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <dirent.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#endif
+
+typedef struct _THREAD_PARAM                                                ///  线程启动参数
+{
+    thread_proc proc;                                                       ///< 线程函数
+    void       *param;                                                      ///< 线程参数
+
+} THREAD_PARAM, *PTHREAD_PARAM;
+
+int file_read(const char *path, PFILE_MAP map)
+{
+    memset(map, 0, sizeof(FILE_MAP));
+
+    FILE *fp = file_open(path, "rb");
+
+    if (NULL == fp)
+    {
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    if (size < 0)
+    {
+        fclose(fp);
+        return -2;
+    }
+
+    map->data = malloc(size > 0 ? size : 1);
+
+    if (NULL == map->data)
+    {
+        fclose(fp);
+        return -3;
+    }
+
+    map->size = fread(map->data, 1, size, fp);
+    fclose(fp);
+    return 0;
+}
+
+#ifdef _WIN32
+
+/**
+ *\brief                        UTF-8转成UNICODE
+ *\param[in]    src             UTF-8字符串
+ *\return                       UNICODE字符串,需要free
+ */
+static wchar_t* utf8_to_wide(const char *src)
+{
+    int len = MultiByteToWideChar(CP_UTF8, 0, src, -1, NULL, 0);
+
+    wchar_t *dst = malloc(len * sizeof(wchar_t));
+
+    if (NULL != dst)
+    {
+        MultiByteToWideChar(CP_UTF8, 0, src, -1, dst, len);
+    }
+
+    return dst;
+}
+
+/**
+ *\brief                        UNICODE转成UTF-8
+ *\param[in]    src             UNICODE字符串
+ *\return                       UTF-8字符串,需要free
+ */
+static char* wide_to_utf8(const wchar_t *src)
+{
+    int len = WideCharToMultiByte(CP_UTF8, 0, src, -1, NULL, 0, NULL, NULL);
+
+    char *dst = malloc(len);
+
+    if (NULL != dst)
+    {
+        WideCharToMultiByte(CP_UTF8, 0, src, -1, dst, len, NULL, NULL);
+    }
+
+    return dst;
+}
+
+FILE* file_open(const char *path, const char *mode)
+{
+    wchar_t wmode[8];
+    FILE   *fp    = NULL;
+    wchar_t *wpath = utf8_to_wide(path);
+
+    if (NULL == wpath)
+    {
+        return NULL;
+    }
+
+    MultiByteToWideChar(CP_UTF8, 0, mode, -1, wmode, SIZEOF(wmode));
+
+    _wfopen_s(&fp, wpath, wmode);
+    free(wpath);
+    return fp;
+}
+
+int file_map(const char *path, PFILE_MAP map)
+{
+    LARGE_INTEGER size;
+
+    memset(map, 0, sizeof(FILE_MAP));
+
+    wchar_t *wpath = utf8_to_wide(path);
+
+    if (NULL == wpath)
+    {
+        return -1;
+    }
+
+    // 允许其它进程同时追加和替换,缓存文件映射时仍可写入
+    map->file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                            NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+    free(wpath);
+
+    if (INVALID_HANDLE_VALUE == map->file)
+    {
+        map->file = NULL;
+        return -1;
+    }
+
+    map->mapped = 1;
+
+    if (!GetFileSizeEx(map->file, &size))
+    {
+        file_unmap(map);
+        return -2;
+    }
+
+    map->size   = (size_t)size.QuadPart;
+
+    if (0 == map->size)
+    {
+        return 0; // 空文件不能映射
+    }
+
+    map->mapping = CreateFileMappingW(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (NULL == map->mapping)
+    {
+        file_unmap(map);
+        return -3;
+    }
+
+    map->data = MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+
+    if (NULL == map->data)
+    {
+        file_unmap(map);
+        return -4;
+    }
+
+    return 0;
+}
+
+void file_unmap(PFILE_MAP map)
+{
+    if (!map->mapped)
+    {
+        free(map->data);
+    }
+    else
+    {
+        if (NULL != map->data)      UnmapViewOfFile(map->data);
+        if (NULL != map->mapping)   CloseHandle(map->mapping);
+        if (NULL != map->file)      CloseHandle(map->file);
+    }
+
+    memset(map, 0, sizeof(FILE_MAP));
+}
+
+int file_stat(const char *path, ULONGLONG *size, ULONGLONG *mtime, ULONGLONG *id)
+{
+    BY_HANDLE_FILE_INFORMATION info;
+    wchar_t *wpath = utf8_to_wide(path);
+
+    if (NULL == wpath)
+    {
+        return -1;
+    }
+
+    // 不需要读写权限,FILE_FLAG_BACKUP_SEMANTICS允许打开目录
+    HANDLE file = CreateFileW(wpath, 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+                              OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+    free(wpath);
+
+    if (INVALID_HANDLE_VALUE == file)
+    {
+        return -2;
+    }
+
+    BOOL ok = GetFileInformationByHandle(file, &info);
+    CloseHandle(file);
+
+    if (!ok)
+    {
+        return -3;
+    }
+
+    *size  = ((ULONGLONG)info.nFileSizeHigh << 32) | info.nFileSizeLow;
+    *mtime = ((ULONGLONG)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime;
+
+    if (NULL != id)
+    {
+        *id = (((ULONGLONG)info.nFileIndexHigh << 32) | info.nFileIndexLow) ^ ((ULONGLONG)info.dwVolumeSerialNumber << 48);
+    }
+
+    return 0;
+}
+
+int file_append(const char *path, const void *data, size_t size)
+{
+    OVERLAPPED ov    = { 0 };
+    wchar_t   *wpath = utf8_to_wide(path);
+    int        ret   = 0;
+
+    if (NULL == wpath)
+    {
+        return -1;
+    }
+
+    HANDLE file = CreateFileW(wpath, FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    free(wpath);
+
+    if (INVALID_HANDLE_VALUE == file)
+    {
+        return -2;
+    }
+
+    // 锁文件结尾之外的一个字节作为写锁,不影响读取数据
+    ov.Offset     = 0xFFFFFFFF;
+    ov.OffsetHigh = 0x7FFFFFFF;
+
+    if (!LockFileEx(file, LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &ov))
+    {
+        CloseHandle(file);
+        return -3;
+    }
+
+    for (const char *p = data; size > 0 && 0 == ret; )
+    {
+        DWORD len = (size > 0x40000000) ? 0x40000000 : (DWORD)size;
+        DWORD written;
+
+        if (!WriteFile(file, p, len, &written, NULL) || 0 == written)
+        {
+            ret = -4;
+        }
+
+        p    += written;
+        size -= written;
+    }
+
+    UnlockFileEx(file, 0, 1, 0, &ov);
+    CloseHandle(file);
+    return ret;
+}
+
+int file_rename(const char *from, const char *to)
+{
+    wchar_t *wfrom = utf8_to_wide(from);
+    wchar_t *wto   = utf8_to_wide(to);
+    int      ret   = -1;
+
+    if (NULL != wfrom && NULL != wto)
+    {
+        ret = MoveFileExW(wfrom, wto, MOVEFILE_REPLACE_EXISTING) ? 0 : -2;
+    }
+
+    free(wfrom);
+    free(wto);
+    return ret;
+}
+
+int dir_walk(const char *path, dir_walk_proc proc, void *param)
+{
+    WIN32_FIND_DATAW data;
+
+    wchar_t *wpath = utf8_to_wide(path);
+
+    if (NULL == wpath)
+    {
+        return -1;
+    }
+
+    DWORD attr = GetFileAttributesW(wpath);
+
+    if (INVALID_FILE_ATTRIBUTES == attr)
+    {
+        free(wpath);
+        return -1;
+    }
+
+    if (!(attr & FILE_ATTRIBUTE_DIRECTORY))
+    {
+        free(wpath);
+        return proc(path, param);
+    }
+
+    size_t   len     = wcslen(wpath);
+    wchar_t *pattern = malloc((len + 3) * sizeof(wchar_t));
+
+    swprintf(pattern, len + 3, L"%ls\\*", wpath);
+    free(wpath);
+
+    HANDLE find = FindFirstFileW(pattern, &data);
+    free(pattern);
+
+    if (INVALID_HANDLE_VALUE == find)
+    {
+        return 0;
+    }
+
+    int ret = 0;
+
+    do
+    {
+        if (0 == wcscmp(data.cFileName, L".") || 0 == wcscmp(data.cFileName, L".."))
+        {
+            continue;
+        }
+
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)
+        {
+            continue; // 不跟随链接
+        }
+
+        char  *name = wide_to_utf8(data.cFileName);
+        size_t size = strlen(path) + strlen(name) + 2;
+        char  *sub  = malloc(size);
+
+        snprintf(sub, size, "%s%c%s", path, PATH_SEP, name);
+        free(name);
+
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        {
+            ret = dir_walk(sub, proc, param);
+        }
+        else
+        {
+            ret = proc(sub, param);
+        }
+
+        free(sub);
+    }
+    while (0 == ret && FindNextFileW(find, &data));
+
+    FindClose(find);
+    return ret;
+}
+
+/**
+ *\brief                        线程入口
+ *\param[in]    param           THREAD_PARAM
+ *\return                       0
+ */
+static DWORD WINAPI thread_entry(LPVOID param)
+{
+    THREAD_PARAM tp = *(PTHREAD_PARAM)param;
+    free(param);
+    tp.proc(tp.param);
+    return 0;
+}
+
+int thread_create(thread_t *thread, thread_proc proc, void *param)
+{
+    PTHREAD_PARAM tp = malloc(sizeof(THREAD_PARAM));
+
+    if (NULL == tp)
+    {
+        return -1;
+    }
+
+    tp->proc  = proc;
+    tp->param = param;
+
+    *thread = CreateThread(NULL, 0, thread_entry, tp, 0, NULL);
+
+    if (NULL == *thread)
+    {
+        free(tp);
+        return -2;
+    }
+
+    return 0;
+}
+
+void thread_join(thread_t thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+void mutex_init(mutex_t *mutex)     { InitializeCriticalSection(mutex); }
+void mutex_free(mutex_t *mutex)     { DeleteCriticalSection(mutex); }
+void mutex_lock(mutex_t *mutex)     { EnterCriticalSection(mutex); }
+void mutex_unlock(mutex_t *mutex)   { LeaveCriticalSection(mutex); }
+
+void cond_init(cond_t *cond)                    { InitializeConditionVariable(cond); }
+void cond_free(cond_t *cond)                    { (void)cond; }
+void cond_wait(cond_t *cond, mutex_t *mutex)    { SleepConditionVariableCS(cond, mutex, INFINITE); }
+void cond_signal(cond_t *cond)                  { WakeConditionVariable(cond); }
+void cond_broadcast(cond_t *cond)               { WakeAllConditionVariable(cond); }
+
+long atomic_add(volatile long *value, long add) { return InterlockedExchangeAdd(value, add) + add; }
+void thread_yield(void)                         { SwitchToThread(); }
+
+int cpu_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+
+void* mem_reserve(size_t size)
+{
+    return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS); // 只保留地址空间,不占用提交量
+}
+
+int mem_commit(void *ptr, size_t size)
+{
+    // 提交量按长度计算,物理页在第一次访问时才分配
+    return (0 == size || NULL != VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE)) ? 0 : -1;
+}
+
+void mem_release(void *ptr, size_t size)
+{
+    (void)size;
+    VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
+void mem_peak_reset(void)
+{
+    // Windows不能重置峰值
+}
+
+size_t mem_peak(void)
+{
+    PROCESS_MEMORY_COUNTERS pmc = { sizeof(pmc) };
+    GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+    return pmc.PeakWorkingSetSize / 1024;
+}
+
+size_t page_faults(void)
+{
+    PROCESS_MEMORY_COUNTERS pmc = { sizeof(pmc) };
+    GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+    return pmc.PageFaultCount;
+}
+
+void thread_usage(double *cpu, size_t *faults)
+{
+    FILETIME create;
+    FILETIME exit;
+    FILETIME kernel;
+    FILETIME user;
+
+    GetThreadTimes(GetCurrentThread(), &create, &exit, &kernel, &user);
+
+    ULONGLONG k = ((ULONGLONG)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+    ULONGLONG u = ((ULONGLONG)user.dwHighDateTime << 32) | user.dwLowDateTime;
+
+    *cpu    = (k + u) / 1e7; // 100纳秒
+    *faults = 0;            // 进程的缺页次数包括其它线程的,不能按线程分阶段累加
+}
+
+double time_now(void)
+{
+    LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+
+    return (double)count.QuadPart / (double)freq.QuadPart;
+}
+
+void stdout_binary(void)
+{
+    _setmode(_fileno(stdout), _O_BINARY);
+}
+
+void stdin_binary(void)
+{
+    _setmode(_fileno(stdin), _O_BINARY);
+}
+
+size_t file_read_at(FILE *fp, ULONGLONG offset, void *buff, size_t size)
+{
+    if (0 != _fseeki64(fp, (__int64)offset, SEEK_SET))
+    {
+        return 0;
+    }
+
+    return fread(buff, 1, size, fp);
+}
+
+#else
+
+FILE* file_open(const char *path, const char *mode)
+{
+    return fopen(path, mode);
+}
+
+int file_map(const char *path, PFILE_MAP map)
+{
+    struct stat st;
+
+    memset(map, 0, sizeof(FILE_MAP));
+
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    if (0 != fstat(fd, &st))
+    {
+        close(fd);
+        return -2;
+    }
+
+    map->mapped = 1;
+    map->size   = st.st_size;
+
+    if (0 == map->size)
+    {
+        close(fd);
+        return 0; // 空文件不能映射
+    }
+
+    void *data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (MAP_FAILED == data)
+    {
+        memset(map, 0, sizeof(FILE_MAP));
+        return -3;
+    }
+
+    madvise(data, map->size, MADV_RANDOM); // 关闭预读,只读入访问到的页
+
+    map->data = data;
+    return 0;
+}
+
+void file_unmap(PFILE_MAP map)
+{
+    if (!map->mapped)
+    {
+        free(map->data);
+    }
+    else if (NULL != map->data)
+    {
+        munmap(map->data, map->size);
+    }
+
+    memset(map, 0, sizeof(FILE_MAP));
+}
+
+int file_stat(const char *path, ULONGLONG *size, ULONGLONG *mtime, ULONGLONG *id)
+{
+    struct stat st;
+
+    if (0 != stat(path, &st))
+    {
+        return -1;
+    }
+
+    *size  = st.st_size;
+    *mtime = (ULONGLONG)st.st_mtim.tv_sec * 1000000000ULL + st.st_mtim.tv_nsec;
+
+    if (NULL != id)
+    {
+        *id = (ULONGLONG)st.st_ino ^ ((ULONGLONG)st.st_dev << 48);
+    }
+
+    return 0;
+}
+
+int file_append(const char *path, const void *data, size_t size)
+{
+    int ret = 0;
+    int fd  = open(path, O_WRONLY | O_APPEND | O_CREAT, 0644);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    if (0 != flock(fd, LOCK_EX)) // 进程和线程间互斥,关闭时释放
+    {
+        close(fd);
+        return -2;
+    }
+
+    for (const char *p = data; size > 0; )
+    {
+        ssize_t len = write(fd, p, size);
+
+        if (len <= 0)
+        {
+            ret = -3;
+            break;
+        }
+
+        p    += len;
+        size -= len;
+    }
+
+    close(fd);
+    return ret;
+}
+
+int file_rename(const char *from, const char *to)
+{
+    return rename(from, to); // 目标存在时原子替换
+}
+
+int dir_walk(const char *path, dir_walk_proc proc, void *param)
+{
+    struct stat st;
+
+    if (0 != lstat(path, &st))
+    {
+        return -1;
+    }
+
+    if (S_ISREG(st.st_mode))
+    {
+        return proc(path, param);
+    }
+
+    if (!S_ISDIR(st.st_mode))
+    {
+        return 0; // 不跟随符号链接,跳过设备等文件
+    }
+
+    DIR *dir = opendir(path);
+
+    if (NULL == dir)
+    {
+        return 0;
+    }
+
+    int            ret = 0;
+    struct dirent *ent;
+
+    while (0 == ret && NULL != (ent = readdir(dir)))
+    {
+        if (0 == strcmp(ent->d_name, ".") || 0 == strcmp(ent->d_name, ".."))
+        {
+            continue;
+        }
+
+        size_t size = strlen(path) + strlen(ent->d_name) + 2;
+        char  *sub  = malloc(size);
+
+        if (NULL == sub)
+        {
+            ret = -2;
+            break;
+        }
+
+        snprintf(sub, size, "%s%c%s", path, PATH_SEP, ent->d_name);
+
+        if (DT_REG == ent->d_type)
+        {
+            ret = proc(sub, param);
+        }
+        else if (DT_DIR == ent->d_type || DT_UNKNOWN == ent->d_type)
+        {
+            ret = dir_walk(sub, proc, param);
+        }
+
+        free(sub);
+    }
+
+    closedir(dir);
+    return ret;
+}
+
+/**
+ *\brief                        线程入口
+ *\param[in]    param           THREAD_PARAM
+ *\return                       NULL
+ */
+static void* thread_entry(void *param)
+{
+    THREAD_PARAM tp = *(PTHREAD_PARAM)param;
+    free(param);
+    tp.proc(tp.param);
+    return NULL;
+}
+
+int thread_create(thread_t *thread, thread_proc proc, void *param)
+{
+    PTHREAD_PARAM tp = malloc(sizeof(THREAD_PARAM));
+
+    if (NULL == tp)
+    {
+        return -1;
+    }
+
+    tp->proc  = proc;
+    tp->param = param;
+
+    if (0 != pthread_create(thread, NULL, thread_entry, tp))
+    {
+        free(tp);
+        return -2;
+    }
+
+    return 0;
+}
+
+void thread_join(thread_t thread)
+{
+    pthread_join(thread, NULL);
+}
+
+void mutex_init(mutex_t *mutex)     { pthread_mutex_init(mutex, NULL); }
+void mutex_free(mutex_t *mutex)     { pthread_mutex_destroy(mutex); }
+void mutex_lock(mutex_t *mutex)     { pthread_mutex_lock(mutex); }
+void mutex_unlock(mutex_t *mutex)   { pthread_mutex_unlock(mutex); }
+
+void cond_init(cond_t *cond)                    { pthread_cond_init(cond, NULL); }
+void cond_free(cond_t *cond)                    { pthread_cond_destroy(cond); }
+void cond_wait(cond_t *cond, mutex_t *mutex)    { pthread_cond_wait(cond, mutex); }
+void cond_signal(cond_t *cond)                  { pthread_cond_signal(cond); }
+void cond_broadcast(cond_t *cond)               { pthread_cond_broadcast(cond); }
+
+long atomic_add(volatile long *value, long add) { return __atomic_add_fetch(value, add, __ATOMIC_SEQ_CST); }
+void thread_yield(void)                         { sched_yield(); }
+
+int cpu_count(void)
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (int)count : 1;
+}
+
+void* mem_reserve(size_t size)
+{
+    void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    return (MAP_FAILED == ptr) ? NULL : ptr;
+}
+
+int mem_commit(void *ptr, size_t size)
+{
+    (void)ptr; // MAP_NORESERVE的页可以直接读写
+    (void)size;
+    return 0;
+}
+
+void mem_release(void *ptr, size_t size)
+{
+    munmap(ptr, size);
+}
+
+void mem_peak_reset(void)
+{
+    FILE *fp = fopen("/proc/self/clear_refs", "w");
+
+    if (NULL != fp)
+    {
+        fputs("5", fp); // 5-重置VmHWM
+        fclose(fp);
+    }
+}
+
+size_t mem_peak(void)
+{
+    char   line[128];
+    size_t peak = 0;
+    FILE  *fp   = fopen("/proc/self/status", "r");
+
+    if (NULL == fp)
+    {
+        struct rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+        return ru.ru_maxrss;
+    }
+
+    while (NULL != fgets(line, sizeof(line), fp))
+    {
+        if (0 == strncmp(line, "VmHWM:", 6))
+        {
+            peak = strtoul(line + 6, NULL, 10);
+            break;
+        }
+    }
+
+    fclose(fp);
+    return peak;
+}
+
+size_t page_faults(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_minflt + ru.ru_majflt;
+}
+
+void thread_usage(double *cpu, size_t *faults)
+{
+    struct timespec ts;
+    struct rusage   ru;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts); // rusage的时间按时钟中断采样,精度不够
+    getrusage(RUSAGE_THREAD, &ru);
+
+    *cpu    = ts.tv_sec + ts.tv_nsec / 1e9;
+    *faults = ru.ru_minflt + ru.ru_majflt;
+}
+
+double time_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void stdout_binary(void)
+{
+    // 不区分文本和二进制
+}
+
+void stdin_binary(void)
+{
+    // 不区分文本和二进制
+}
+
+size_t file_read_at(FILE *fp, ULONGLONG offset, void *buff, size_t size)
+{
+    size_t done = 0;
+
+    while (done < size) // 一次可能读不完
+    {
+        ssize_t len = pread(fileno(fp), (char*)buff + done, size - done, (off_t)(offset + done));
+
+        if (len <= 0)
+        {
+            break;
+        }
+
+        done += (size_t)len;
+    }
+
+    return done;
+}
+
+#endif
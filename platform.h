@@ -0,0 +1,563 @@
+/**
+ *\file     platform.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    平台相关接口定义,屏蔽Windows与Linux的差异
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加PE32+结构
+ *          2026.10.18|增加标准输出二进制模式
+ *          2026.10.18|增加文件属性和替换
+ *          2026.10.18|增加文件标识和加锁追加写
+ *          2026.10.18|增加原子加和让出CPU
+ *          2026.10.18|增加按需占用内存的地址空间,标准输入二进制模式
+ *          2026.10.18|增加线程局部变量和线程CPU时间,缺页次数
+ *          2026.10.18|增加资源表结构
+ *          2026.10.18|增加延迟导入和绑定导入结构
+ *          2026.10.18|增加调试目录结构,按位置读文件
+ *          2026.10.18|增加按需提交保留的地址空间
+ *          2026.10.18|增加THREAD_FAULTS,Windows下没有线程的缺页次数
+ */
+#ifndef _PLATFORM_H_
+#define _PLATFORM_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+
+#include <Windows.h>
+
+typedef HANDLE              thread_t;                                       ///< 线程句柄
+typedef CRITICAL_SECTION    mutex_t;                                        ///< 互斥锁
+typedef CONDITION_VARIABLE  cond_t;                                         ///< 条件变量
+
+#define PATH_SEP            '\\'                                            ///< 路径分隔符
+
+#define THREAD_LOCAL        __declspec(thread)                              ///< 线程局部变量
+#define THREAD_FAULTS       0                                               ///< 0-没有线程的缺页次数
+
+#else
+
+#include <pthread.h>
+
+typedef uint8_t             UCHAR;
+typedef uint8_t             BYTE;
+typedef char                CHAR;
+typedef uint16_t            WORD;
+typedef int32_t             LONG;
+typedef uint32_t            DWORD;
+typedef uint32_t            UINT;
+typedef uint64_t            ULONGLONG;
+
+typedef pthread_t           thread_t;                                       ///< 线程句柄
+typedef pthread_mutex_t     mutex_t;                                        ///< 互斥锁
+typedef pthread_cond_t      cond_t;                                         ///< 条件变量
+
+#define PATH_SEP            '/'                                             ///< 路径分隔符
+
+#define THREAD_LOCAL        __thread                                        ///< 线程局部变量
+#define THREAD_FAULTS       1                                               ///< 1-有线程的缺页次数
+
+#define IMAGE_DOS_SIGNATURE                 0x5A4D                          ///< MZ
+#define IMAGE_NT_SIGNATURE                  0x00004550                      ///< PE00
+#define IMAGE_NUMBEROF_DIRECTORY_ENTRIES    16                              ///< 数据目录项个数
+#define IMAGE_SIZEOF_SHORT_NAME             8                               ///< 节名长度
+
+typedef struct _IMAGE_DOS_HEADER                                            ///  DOS头
+{
+    WORD  e_magic;
+    WORD  e_cblp;
+    WORD  e_cp;
+    WORD  e_crlc;
+    WORD  e_cparhdr;
+    WORD  e_minalloc;
+    WORD  e_maxalloc;
+    WORD  e_ss;
+    WORD  e_sp;
+    WORD  e_csum;
+    WORD  e_ip;
+    WORD  e_cs;
+    WORD  e_lfarlc;
+    WORD  e_ovno;
+    WORD  e_res[4];
+    WORD  e_oemid;
+    WORD  e_oeminfo;
+    WORD  e_res2[10];
+    LONG  e_lfanew;
+
+} IMAGE_DOS_HEADER, *PIMAGE_DOS_HEADER;
+
+typedef struct _IMAGE_FILE_HEADER                                           ///  FILE头
+{
+    WORD  Machine;
+    WORD  NumberOfSections;
+    DWORD TimeDateStamp;
+    DWORD PointerToSymbolTable;
+    DWORD NumberOfSymbols;
+    WORD  SizeOfOptionalHeader;
+    WORD  Characteristics;
+
+} IMAGE_FILE_HEADER, *PIMAGE_FILE_HEADER;
+
+typedef struct _IMAGE_DATA_DIRECTORY                                        ///  数据目录项
+{
+    DWORD VirtualAddress;
+    DWORD Size;
+
+} IMAGE_DATA_DIRECTORY, *PIMAGE_DATA_DIRECTORY;
+
+typedef struct _IMAGE_OPTIONAL_HEADER32                                     ///  OPTION头(32位)
+{
+    WORD  Magic;
+    BYTE  MajorLinkerVersion;
+    BYTE  MinorLinkerVersion;
+    DWORD SizeOfCode;
+    DWORD SizeOfInitializedData;
+    DWORD SizeOfUninitializedData;
+    DWORD AddressOfEntryPoint;
+    DWORD BaseOfCode;
+    DWORD BaseOfData;
+    DWORD ImageBase;
+    DWORD SectionAlignment;
+    DWORD FileAlignment;
+    WORD  MajorOperatingSystemVersion;
+    WORD  MinorOperatingSystemVersion;
+    WORD  MajorImageVersion;
+    WORD  MinorImageVersion;
+    WORD  MajorSubsystemVersion;
+    WORD  MinorSubsystemVersion;
+    DWORD Win32VersionValue;
+    DWORD SizeOfImage;
+    DWORD SizeOfHeaders;
+    DWORD CheckSum;
+    WORD  Subsystem;
+    WORD  DllCharacteristics;
+    DWORD SizeOfStackReserve;
+    DWORD SizeOfStackCommit;
+    DWORD SizeOfHeapReserve;
+    DWORD SizeOfHeapCommit;
+    DWORD LoaderFlags;
+    DWORD NumberOfRvaAndSizes;
+    IMAGE_DATA_DIRECTORY DataDirectory[IMAGE_NUMBEROF_DIRECTORY_ENTRIES];
+
+} IMAGE_OPTIONAL_HEADER32, *PIMAGE_OPTIONAL_HEADER32;
+
+typedef struct _IMAGE_OPTIONAL_HEADER64                                     ///  OPTION头(64位)
+{
+    WORD      Magic;
+    BYTE      MajorLinkerVersion;
+    BYTE      MinorLinkerVersion;
+    DWORD     SizeOfCode;
+    DWORD     SizeOfInitializedData;
+    DWORD     SizeOfUninitializedData;
+    DWORD     AddressOfEntryPoint;
+    DWORD     BaseOfCode;
+    ULONGLONG ImageBase;
+    DWORD     SectionAlignment;
+    DWORD     FileAlignment;
+    WORD      MajorOperatingSystemVersion;
+    WORD      MinorOperatingSystemVersion;
+    WORD      MajorImageVersion;
+    WORD      MinorImageVersion;
+    WORD      MajorSubsystemVersion;
+    WORD      MinorSubsystemVersion;
+    DWORD     Win32VersionValue;
+    DWORD     SizeOfImage;
+    DWORD     SizeOfHeaders;
+    DWORD     CheckSum;
+    WORD      Subsystem;
+    WORD      DllCharacteristics;
+    ULONGLONG SizeOfStackReserve;
+    ULONGLONG SizeOfStackCommit;
+    ULONGLONG SizeOfHeapReserve;
+    ULONGLONG SizeOfHeapCommit;
+    DWORD     LoaderFlags;
+    DWORD     NumberOfRvaAndSizes;
+    IMAGE_DATA_DIRECTORY DataDirectory[IMAGE_NUMBEROF_DIRECTORY_ENTRIES];
+
+} IMAGE_OPTIONAL_HEADER64, *PIMAGE_OPTIONAL_HEADER64;
+
+typedef struct _IMAGE_NT_HEADERS                                            ///  NT头(32位)
+{
+    DWORD Signature;
+    IMAGE_FILE_HEADER FileHeader;
+    IMAGE_OPTIONAL_HEADER32 OptionalHeader;
+
+} IMAGE_NT_HEADERS, *PIMAGE_NT_HEADERS, IMAGE_NT_HEADERS32, *PIMAGE_NT_HEADERS32;
+
+typedef struct _IMAGE_NT_HEADERS64                                          ///  NT头(64位)
+{
+    DWORD Signature;
+    IMAGE_FILE_HEADER FileHeader;
+    IMAGE_OPTIONAL_HEADER64 OptionalHeader;
+
+} IMAGE_NT_HEADERS64, *PIMAGE_NT_HEADERS64;
+
+typedef struct _IMAGE_SECTION_HEADER                                        ///  节头
+{
+    BYTE  Name[IMAGE_SIZEOF_SHORT_NAME];
+    union
+    {
+        DWORD PhysicalAddress;
+        DWORD VirtualSize;
+    } Misc;
+    DWORD VirtualAddress;
+    DWORD SizeOfRawData;
+    DWORD PointerToRawData;
+    DWORD PointerToRelocations;
+    DWORD PointerToLinenumbers;
+    WORD  NumberOfRelocations;
+    WORD  NumberOfLinenumbers;
+    DWORD Characteristics;
+
+} IMAGE_SECTION_HEADER, *PIMAGE_SECTION_HEADER;
+
+typedef struct _IMAGE_BASE_RELOCATION                                       ///  重定位块头
+{
+    DWORD VirtualAddress;
+    DWORD SizeOfBlock;
+
+} IMAGE_BASE_RELOCATION, *PIMAGE_BASE_RELOCATION;
+
+typedef struct _IMAGE_EXPORT_DIRECTORY                                      ///  导出表头
+{
+    DWORD Characteristics;
+    DWORD TimeDateStamp;
+    WORD  MajorVersion;
+    WORD  MinorVersion;
+    DWORD Name;
+    DWORD Base;
+    DWORD NumberOfFunctions;
+    DWORD NumberOfNames;
+    DWORD AddressOfFunctions;
+    DWORD AddressOfNames;
+    DWORD AddressOfNameOrdinals;
+
+} IMAGE_EXPORT_DIRECTORY, *PIMAGE_EXPORT_DIRECTORY;
+
+typedef struct _IMAGE_IMPORT_DESCRIPTOR                                     ///  导入表库描述
+{
+    union
+    {
+        DWORD Characteristics;
+        DWORD OriginalFirstThunk;
+    };
+    DWORD TimeDateStamp;
+    DWORD ForwarderChain;
+    DWORD Name;
+    DWORD FirstThunk;
+
+} IMAGE_IMPORT_DESCRIPTOR, *PIMAGE_IMPORT_DESCRIPTOR;
+
+typedef struct _IMAGE_THUNK_DATA32                                          ///  导入函数项(32位)
+{
+    union
+    {
+        DWORD ForwarderString;
+        DWORD Function;
+        DWORD Ordinal;
+        DWORD AddressOfData;
+    } u1;
+
+} IMAGE_THUNK_DATA32, *PIMAGE_THUNK_DATA32;
+
+typedef struct _IMAGE_THUNK_DATA64                                          ///  导入函数项(64位)
+{
+    union
+    {
+        ULONGLONG ForwarderString;
+        ULONGLONG Function;
+        ULONGLONG Ordinal;
+        ULONGLONG AddressOfData;
+    } u1;
+
+} IMAGE_THUNK_DATA64, *PIMAGE_THUNK_DATA64;
+
+typedef struct _IMAGE_IMPORT_BY_NAME                                        ///  按名称导入的函数
+{
+    WORD  Hint;
+    CHAR  Name[1];
+
+} IMAGE_IMPORT_BY_NAME, *PIMAGE_IMPORT_BY_NAME;
+
+typedef struct _IMAGE_DELAYLOAD_DESCRIPTOR                                  ///  延迟导入库描述
+{
+    union
+    {
+        DWORD AllAttributes;                                                ///< 最低位为1时下面都是相对虚拟地址,否则是虚拟地址
+    } Attributes;
+    DWORD DllNameRVA;
+    DWORD ModuleHandleRVA;
+    DWORD ImportAddressTableRVA;
+    DWORD ImportNameTableRVA;
+    DWORD BoundImportAddressTableRVA;
+    DWORD UnloadInformationTableRVA;
+    DWORD TimeDateStamp;
+
+} IMAGE_DELAYLOAD_DESCRIPTOR, *PIMAGE_DELAYLOAD_DESCRIPTOR;
+
+typedef struct _IMAGE_BOUND_IMPORT_DESCRIPTOR                               ///  绑定导入描述,后面是转发引用
+{
+    DWORD TimeDateStamp;
+    WORD  OffsetModuleName;                                                 ///< 库名称相对绑定导入表的位置
+    WORD  NumberOfModuleForwarderRefs;
+
+} IMAGE_BOUND_IMPORT_DESCRIPTOR, *PIMAGE_BOUND_IMPORT_DESCRIPTOR;
+
+typedef struct _IMAGE_BOUND_FORWARDER_REF                                   ///  绑定导入的转发引用
+{
+    DWORD TimeDateStamp;
+    WORD  OffsetModuleName;
+    WORD  Reserved;
+
+} IMAGE_BOUND_FORWARDER_REF, *PIMAGE_BOUND_FORWARDER_REF;
+
+typedef struct _IMAGE_RESOURCE_DIRECTORY                                    ///  资源目录头,后面是名称项和ID项
+{
+    DWORD Characteristics;
+    DWORD TimeDateStamp;
+    WORD  MajorVersion;
+    WORD  MinorVersion;
+    WORD  NumberOfNamedEntries;
+    WORD  NumberOfIdEntries;
+
+} IMAGE_RESOURCE_DIRECTORY, *PIMAGE_RESOURCE_DIRECTORY;
+
+typedef struct _IMAGE_RESOURCE_DIRECTORY_ENTRY                              ///  资源目录项
+{
+    DWORD Name;                                                             ///< 最高位为1时低31位是名称的位置,否则为ID
+    DWORD OffsetToData;                                                     ///< 最高位为1时低31位是下一层目录的位置,否则为数据项的位置
+
+} IMAGE_RESOURCE_DIRECTORY_ENTRY, *PIMAGE_RESOURCE_DIRECTORY_ENTRY;
+
+typedef struct _IMAGE_RESOURCE_DATA_ENTRY                                   ///  资源数据项
+{
+    DWORD OffsetToData;                                                     ///< 数据的相对虚拟地址
+    DWORD Size;
+    DWORD CodePage;
+    DWORD Reserved;
+
+} IMAGE_RESOURCE_DATA_ENTRY, *PIMAGE_RESOURCE_DATA_ENTRY;
+
+typedef struct _IMAGE_DEBUG_DIRECTORY                                       ///  调试目录项
+{
+    DWORD Characteristics;
+    DWORD TimeDateStamp;
+    WORD  MajorVersion;
+    WORD  MinorVersion;
+    DWORD Type;
+    DWORD SizeOfData;
+    DWORD AddressOfRawData;                                                 ///< 数据的相对虚拟地址,不装入内存时为0
+    DWORD PointerToRawData;                                                 ///< 数据在文件中的位置
+
+} IMAGE_DEBUG_DIRECTORY, *PIMAGE_DEBUG_DIRECTORY;
+
+#endif
+
+#define SIZEOF(x)               sizeof(x)/sizeof(x[0])                      ///< 计算数量
+
+typedef struct _FILE_MAP                                                    ///  文件数据视图
+{
+    UCHAR      *data;                                                       ///< 文件数据
+    size_t      size;                                                       ///< 文件长度
+    int         mapped;                                                     ///< 1-内存映射,0-读入内存
+#ifdef _WIN32
+    HANDLE      file;                                                       ///< 文件句柄
+    HANDLE      mapping;                                                    ///< 映射句柄
+#endif
+
+} FILE_MAP, *PFILE_MAP;
+
+typedef void (*thread_proc)(void *param);                                   ///< 线程函数
+
+typedef int (*dir_walk_proc)(const char *path, void *param);                ///< 遍历目录回调函数,返回非0时停止
+
+/**
+ *\brief                        打开文件,路径为UTF-8
+ *\param[in]    path            文件路径
+ *\param[in]    mode            打开方式
+ *\return                       文件指针,失败返回NULL
+ */
+FILE* file_open(const char *path, const char *mode);
+
+/**
+ *\brief                        只读内存映射文件,只有访问到的页才会从磁盘读入
+ *\param[in]    path            文件路径
+ *\param[out]   map             文件数据视图
+ *\return                       0-成功,其它失败
+ */
+int file_map(const char *path, PFILE_MAP map);
+
+/**
+ *\brief                        将整个文件读入内存
+ *\param[in]    path            文件路径
+ *\param[out]   map             文件数据视图
+ *\return                       0-成功,其它失败
+ */
+int file_read(const char *path, PFILE_MAP map);
+
+/**
+ *\brief                        从文件的指定位置读取,不移动也不使用文件指针的缓冲区
+ *\param[in]    fp              文件指针,file_open打开
+ *\param[in]    offset          文件位置
+ *\param[out]   buff            缓冲区
+ *\param[in]    size            读取的字节数
+ *\return                       读到的字节数,出错或超出文件时小于size
+ */
+size_t file_read_at(FILE *fp, ULONGLONG offset, void *buff, size_t size);
+
+/**
+ *\brief                        释放文件数据视图
+ *\param[in]    map             文件数据视图
+ *\return                       无
+ */
+void file_unmap(PFILE_MAP map);
+
+/**
+ *\brief                        得到文件长度,修改时间和文件标识
+ *\param[in]    path            文件路径
+ *\param[out]   size            文件长度
+ *\param[out]   mtime           修改时间,只用于比较是否变化,单位与平台有关
+ *\param[out]   id              文件标识(inode和设备号),可以为NULL,只用于比较是否为同一个文件
+ *\return                       0-成功,其它失败
+ */
+int file_stat(const char *path, ULONGLONG *size, ULONGLONG *mtime, ULONGLONG *id);
+
+/**
+ *\brief                        加锁后追加写入文件,文件不存在时创建,
+ *                              多个线程或进程同时追加时每次调用的数据不会交错
+ *\param[in]    path            文件路径
+ *\param[in]    data            数据
+ *\param[in]    size            长度
+ *\return                       0-成功,其它失败
+ */
+int file_append(const char *path, const void *data, size_t size);
+
+/**
+ *\brief                        重命名文件,目标存在时替换
+ *\param[in]    from            原路径
+ *\param[in]    to              新路径
+ *\return                       0-成功,其它失败
+ */
+int file_rename(const char *from, const char *to);
+
+/**
+ *\brief                        递归遍历目录,对每个普通文件调用回调函数,不跟随符号链接
+ *\param[in]    path            目录或文件路径
+ *\param[in]    proc            回调函数
+ *\param[in]    param           回调参数
+ *\return                       0-成功,其它失败
+ */
+int dir_walk(const char *path, dir_walk_proc proc, void *param);
+
+/**
+ *\brief                        创建线程
+ *\param[out]   thread          线程句柄
+ *\param[in]    proc            线程函数
+ *\param[in]    param           线程参数
+ *\return                       0-成功,其它失败
+ */
+int thread_create(thread_t *thread, thread_proc proc, void *param);
+
+/**
+ *\brief                        等待线程结束
+ *\param[in]    thread          线程句柄
+ *\return                       无
+ */
+void thread_join(thread_t thread);
+
+void mutex_init(mutex_t *mutex);                                            ///< 初始化互斥锁
+void mutex_free(mutex_t *mutex);                                            ///< 释放互斥锁
+void mutex_lock(mutex_t *mutex);                                            ///< 加锁
+void mutex_unlock(mutex_t *mutex);                                          ///< 解锁
+
+void cond_init(cond_t *cond);                                               ///< 初始化条件变量
+void cond_free(cond_t *cond);                                               ///< 释放条件变量
+void cond_wait(cond_t *cond, mutex_t *mutex);                               ///< 等待条件变量
+void cond_signal(cond_t *cond);                                             ///< 唤醒一个等待者
+void cond_broadcast(cond_t *cond);                                          ///< 唤醒所有等待者
+
+long atomic_add(volatile long *value, long add);                            ///< 原子加,返回加后的值,add为0时用于读取
+void thread_yield(void);                                                    ///< 让出CPU
+
+/**
+ *\brief                        得到CPU核数
+ *\return                       核数
+ */
+int cpu_count(void);
+
+/**
+ *\brief                        保留地址空间,不占用物理内存,Windows下也不占用提交量,读写前要用mem_commit提交
+ *\param[in]    size            长度
+ *\return                       地址,失败返回NULL
+ */
+void* mem_reserve(size_t size);
+
+/**
+ *\brief                        提交mem_reserve保留的一段地址空间,内容为0,只有访问过的页才占用物理内存.
+ *                              Windows下提交量按长度计算,其它平台不需要提交
+ *\param[in]    ptr             地址,在保留的范围内
+ *\param[in]    size            长度
+ *\return                       0-成功,-1-提交量不足
+ */
+int mem_commit(void *ptr, size_t size);
+
+/**
+ *\brief                        释放mem_reserve分配的地址空间
+ *\param[in]    ptr             地址
+ *\param[in]    size            长度,与分配时相同
+ *\return                       无
+ */
+void mem_release(void *ptr, size_t size);
+
+/**
+ *\brief                        重置进程内存峰值,不支持时无操作
+ *\return                       无
+ */
+void mem_peak_reset(void);
+
+/**
+ *\brief                        得到进程内存峰值
+ *\return                       KB
+ */
+size_t mem_peak(void);
+
+/**
+ *\brief                        得到进程缺页次数
+ *\return                       次数
+ */
+size_t page_faults(void);
+
+/**
+ *\brief                        得到当前线程的CPU时间和缺页次数
+ *                              Windows下没有线程的缺页次数(THREAD_FAULTS为0),缺页次数为0,只能用page_faults取进程的
+ *\param[out]   cpu             用户态加内核态时间,秒
+ *\param[out]   faults          缺页次数
+ *\return                       无
+ */
+void thread_usage(double *cpu, size_t *faults);
+
+/**
+ *\brief                        得到单调时间
+ *\return                       秒
+ */
+double time_now(void);
+
+/**
+ *\brief                        标准输出设为二进制模式,Windows下不转换换行符
+ *\return                       无
+ */
+void stdout_binary(void);
+
+/**
+ *\brief                        标准输入设为二进制模式,Windows下不转换换行符和结束符
+ *\return                       无
+ */
+void stdin_binary(void);
+
+#endif
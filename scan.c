@@ -0,0 +1,2152 @@
+/**
+ *\file     scan.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    无界面批量扫描实现
+ *          一个线程遍历目录把文件加入任务池,多个工作线程同时解析,
+ *          文件默认只读映射,每个文件输出一行记录,结束时输出统计信息.
+ *          输出树时大的延迟子树(重定位块,导入函数,导出函数)按节点数分段,
+ *          每段一个任务,其它线程可以取走,文件的所有段完成后按位置合并,输出与不分段相同.
+ *          分段只用于-t的树输出;解析和-o json|bin的记录仍由一个线程完成,单个大文件的这部分不能并行.
+ *          -x时输入按流读取(管道,tar包),主线程只向前读,需要的范围读入后交给工作线程解析.
+ *          -d时解析后在同一线程中计算节的熵和摘要,流式读取时保存整个文件.
+ *          -f时解析后计算导入表散列和Rich头,-g时每个线程记下指纹和路径,结束时合并排序,
+ *          相同指纹的文件分成一组写入文件.
+ *          -m时每个线程分阶段计时和计数,结束时合并输出表格并写入Prometheus文本格式文件.
+ *          -v时解析后只查找资源表中的版本信息和清单,不遍历其它资源.
+ *          -p时解析后解码调试目录;-k时只取映像和PDB的符号键,文件不映射,
+ *          只按位置读入头部,节表,调试目录和CodeView记录,读入量与文件长度无关.
+ *          -a时解码证书表,按Authenticode计算摘要并与签名中的比较,映射的大文件按路径用流水线读入和散列
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加JSON Lines和二进制记录输出
+ *          2026.10.18|增加扫描结果缓存
+ *          2026.10.18|每个线程复用解析内存池和名称驻留表,统计分配次数和内存池峰值
+ *          2026.10.18|改用工作窃取任务池,大文件的树分段并行输出
+ *          2026.10.18|增加流式读取,支持标准输入和tar包
+ *          2026.10.18|-d时计算节和附加数据的熵和摘要
+ *          2026.10.18|-f时计算导入表散列和Rich头,-g按指纹分组
+ *          2026.10.18|-m时分阶段计时和计数,输出表格和Prometheus文件
+ *          2026.10.18|-v时取版本信息和清单,输出树时包括资源表
+ *          2026.10.18|文本摘要的库数和函数数包括延迟导入
+ *          2026.10.18|-p时解码调试目录,-k时只取符号键
+ *          2026.10.18|-a时检查Authenticode签名的摘要
+ *          2026.10.18|同一路径查找多次时过期长度不超过有效长度
+ *          2026.10.18|没有输出时不调用fwrite,结构体全部初始化
+ *          2026.10.18|说明只有-t的树输出分段
+ *          2026.10.18|-x时-v和-t也读入资源表,结果与映射文件相同
+ */
+#include <stdarg.h>
+#include "scan.h"
+#include "pe_tree.h"
+#include "pe_emit.h"
+#include "pe_cache.h"
+#include "hash.h"
+#include "task.h"
+#include "pe_stream.h"
+#include "pe_digest.h"
+#include "pe_finger.h"
+#include "pe_rsrc.h"
+#include "pe_stat.h"
+#include "pe_debug.h"
+#include "pe_auth.h"
+
+#define SCAN_CACHE_FLUSH        (1024 * 1024)                               ///< 新的缓存项攒够后追加到缓存文件
+#define SCAN_SPLIT              4096                                        ///< -t时树的一段最多输出的节点数(估计),超过时分段
+
+typedef struct _SCAN_STAT                                                   ///  统计信息
+{
+    ULONGLONG files;                                                        ///< 文件数
+    ULONGLONG pe_files;                                                     ///< PE文件数
+    ULONGLONG errors;                                                       ///< 出错文件数
+    ULONGLONG bytes;                                                        ///< 读取的字节数
+    ULONGLONG items;                                                        ///< 解析出的数据项数
+    ULONGLONG cache_hits;                                                   ///< 缓存命中的文件数
+    ULONGLONG cache_hash_hits;                                              ///< 其中修改时间变了而内容散列相同的文件数
+    ULONGLONG cache_misses;                                                 ///< 缓存没有命中的文件数
+    ULONGLONG cache_saved;                                                  ///< 缓存命中的文件长度,不用读取和解析
+    ULONGLONG cache_stale;                                                  ///< 被新项覆盖的缓存项长度
+    ULONGLONG parsed;                                                       ///< 解析的文件数
+    ULONGLONG arena_allocs;                                                 ///< 从内存池分配的次数,不用内存池时每次都要malloc
+    ULONGLONG arena_blocks;                                                 ///< 内存池调用malloc的次数
+    ULONGLONG arena_peak;                                                   ///< 一个文件使用内存池的最大字节数
+    ULONGLONG intern_lookups;                                               ///< 驻留表查找次数
+    ULONGLONG intern_names;                                                 ///< 驻留的名称数,各线程之和
+    ULONGLONG intern_bytes;                                                 ///< 查找的名称总长度
+    ULONGLONG intern_stored;                                                ///< 驻留表占用的内存
+    ULONGLONG parts;                                                        ///< 树分出的段数
+    ULONGLONG stream_files;                                                 ///< 流式读取的文件数
+    ULONGLONG stream_loaded;                                                ///< 流式读取时保存的字节数
+    ULONGLONG stream_skipped;                                               ///< 流式读取时读出后丢弃的字节数
+    ULONGLONG stream_window;                                                ///< 一个文件保存的最大字节数
+    ULONGLONG digest_files;                                                 ///< 计算了摘要的文件数
+    ULONGLONG digest_bytes;                                                 ///< 计算摘要读过的字节数
+    ULONGLONG digest_overlays;                                              ///< 有附加数据的文件数
+    double    digest_time;                                                  ///< 计算摘要的时间,各线程之和,秒
+    ULONGLONG finger_files;                                                 ///< 计算了指纹的文件数
+    ULONGLONG finger_imphash;                                               ///< 有导入表散列的文件数
+    ULONGLONG finger_rich;                                                  ///< 有Rich头的文件数
+    ULONGLONG finger_invalid;                                               ///< Rich头校验和不对的文件数
+    double    finger_time;                                                  ///< 计算指纹的时间,各线程之和,秒
+    ULONGLONG version_files;                                                ///< 取了版本信息的文件数
+    ULONGLONG version_info;                                                 ///< 有VS_VERSIONINFO的文件数
+    ULONGLONG version_manifest;                                             ///< 有清单的文件数
+    double    version_time;                                                 ///< 取版本信息的时间,各线程之和,秒
+    ULONGLONG debug_files;                                                  ///< 解码了调试目录的文件数
+    ULONGLONG debug_entries;                                                ///< 调试目录项数
+    ULONGLONG debug_codeview;                                               ///< 有CodeView的文件数
+    double    debug_time;                                                   ///< 解码调试目录的时间,各线程之和,秒
+    ULONGLONG key_files;                                                    ///< 只取符号键的PE文件数
+    ULONGLONG key_pdb;                                                      ///< 其中有PDB符号键的文件数
+    ULONGLONG key_reads;                                                    ///< 只取符号键时读文件的次数
+    ULONGLONG auth_files;                                                   ///< 检查了签名的文件数
+    ULONGLONG auth_signed;                                                  ///< 有证书表的文件数
+    ULONGLONG auth_match;                                                   ///< 摘要与签名中相同的文件数
+    ULONGLONG auth_mismatch;                                                ///< 摘要与签名中不同的文件数
+    ULONGLONG auth_pipe;                                                    ///< 用流水线计算摘要的文件数
+    ULONGLONG auth_bytes;                                                   ///< 计算摘要散列的字节数
+    double    auth_time;                                                    ///< 检查签名的时间,各线程之和,秒
+    double    slowest;                                                      ///< 一个文件的最长处理时间,秒
+
+} SCAN_STAT, *PSCAN_STAT;
+
+typedef struct _SCAN                                                        ///  扫描任务
+{
+    TASK_POOL   pool;                                                       ///< 任务池,文件在公共队列,树的段在线程队列
+    struct _SCAN_WORKER *worker;                                            ///< 工作线程
+
+    int         tree;                                                       ///< 是否输出完整的树
+    int         stream;                                                     ///< 1-流式读取输入
+    mutex_t     stream_lock;                                                ///< 读入还没有解析的文件数锁
+    cond_t      stream_cond;                                                ///< 解析完一个文件时唤醒读取线程
+    int         stream_busy;                                                ///< 读入还没有解析的文件数
+    int         stream_max;                                                 ///< 最多读入还没有解析的文件数,限制内存
+    DWORD       split;                                                      ///< -t时树的一段最多输出的节点数,0为不分段
+    int         read;                                                       ///< 1-整个文件读入内存,0-内存映射
+    int         format;                                                     ///< 记录格式,-1-文本,PE_EMIT_JSON,PE_EMIT_BIN
+    DWORD       digest;                                                     ///< 计算的摘要项,PE_DIGEST_*,0为不计算
+    int         finger;                                                     ///< 是否计算导入表散列和Rich头
+    const char *group_path;                                                 ///< 指纹分组的输出文件,NULL为不分组
+    int         version;                                                    ///< 是否取版本信息和清单
+    int         debug;                                                      ///< 是否解码调试目录
+    int         key;                                                        ///< 1-只取符号键,不完整解析
+    int         auth;                                                       ///< 是否检查Authenticode签名
+    const char *cache_path;                                                 ///< 缓存文件路径,NULL为不使用缓存
+    PE_CACHE    cache;                                                      ///< 扫描开始时的缓存
+    DWORD       cache_mode;                                                 ///< 缓存项的输出格式,格式和是否输出树
+    const char *metrics_path;                                               ///< 分阶段统计的Prometheus文件,NULL为不计时
+
+    mutex_t     out_lock;                                                   ///< 输出锁
+    SCAN_STAT   stat;                                                       ///< 合计统计信息
+    PE_STAT     pe_stat;                                                    ///< 主线程流式读取的分阶段统计,结束时为合计
+
+} SCAN, *PSCAN;
+
+typedef struct _SCAN_WORKER                                                 ///  工作线程
+{
+    PSCAN       scan;                                                       ///< 扫描任务
+    int         id;                                                         ///< 线程序号
+    thread_t    thread;                                                     ///< 线程句柄
+    PE_BUF      out;                                                        ///< 输出缓冲区
+    PE_BUF      tree;                                                       ///< 当前文件的树输出缓冲区
+    PE_BUF      log;                                                        ///< 新的缓存项
+    ULONGLONG   items;                                                      ///< 当前文件解析出的数据项数
+    PE_ARENA    pool;                                                       ///< 解析内存池,文件之间复用
+    PE_INTERN   intern;                                                     ///< 名称驻留表,输出导入名称时使用
+    SCAN_STAT   stat;                                                       ///< 本线程统计信息
+    PE_STAT     pe_stat;                                                    ///< 本线程分阶段统计
+    struct _SCAN_GROUP *group;                                              ///< 本线程记下的指纹
+    size_t      group_count;                                                ///< 指纹数
+    size_t      group_cap;                                                  ///< 指纹数组容量
+
+} SCAN_WORKER, *PSCAN_WORKER;
+
+#define SCAN_GROUP_IMPHASH      0                                           ///< 按导入表散列分组
+#define SCAN_GROUP_RICH         1                                           ///< 按Rich头散列分组
+
+typedef struct _SCAN_GROUP                                                  ///  一个文件的一种指纹
+{
+    UCHAR       md5[HASH_MD5_SIZE];                                         ///< 指纹
+    int         kind;                                                       ///< SCAN_GROUP_*
+    char       *path;                                                       ///< 文件路径
+
+} SCAN_GROUP, *PSCAN_GROUP;
+
+typedef struct _SCAN_CLUSTER                                                ///  指纹相同的一组文件
+{
+    size_t      first;                                                      ///< 第一个文件在排序后的指纹数组中的位置
+    size_t      count;                                                      ///< 文件数
+
+} SCAN_CLUSTER, *PSCAN_CLUSTER;
+
+typedef struct _SCAN_FILE                                                   ///  文件任务
+{
+    PSCAN       scan;                                                       ///< 扫描任务
+    PPE_STREAM  stream;                                                     ///< 流式读取的数据,NULL时打开文件
+    char        path[1];                                                    ///< 文件路径
+
+} SCAN_FILE, *PSCAN_FILE;
+
+typedef struct _SCAN_INPUT                                                  ///  流式输入
+{
+    FILE       *file;                                                       ///< 输入文件
+    UCHAR       head[PE_TAR_BLOCK];                                         ///< 判断格式时读出的开头
+    size_t      head_len;                                                   ///< 开头的长度
+    size_t      head_pos;                                                   ///< 开头已经读过的长度
+
+} SCAN_INPUT, *PSCAN_INPUT;
+
+typedef struct _SCAN_HOLE                                                   ///  段中插入其它段的位置
+{
+    size_t      pos;                                                        ///< 在段文本中的位置
+    struct _SCAN_PART *part;                                                ///< 插入的段
+
+} SCAN_HOLE, *PSCAN_HOLE;
+
+typedef struct _SCAN_PART                                                   ///  树输出的一段
+{
+    PE_TREE     tree;                                                       ///< 输出树,回调参数为本段
+    PSCAN       scan;                                                       ///< 扫描任务
+    PPE_IMAGE   image;                                                      ///< 解析结果
+    volatile long *pending;                                                 ///< 所属文件没有完成的段数
+    int         worker;                                                     ///< 执行本段的线程序号
+    PE_NODE     node;                                                       ///< 延迟子树节点
+    DWORD       lazy;                                                       ///< 延迟子树标识
+    DWORD       first;                                                      ///< 第一个子节点序号
+    DWORD       count;                                                      ///< 子节点数量
+    PE_BUF      text;                                                       ///< 本段文本
+    PSCAN_HOLE  hole;                                                       ///< 插入其它段的位置,按位置排列
+    DWORD       hole_count;                                                 ///< 位置数
+    DWORD       hole_cap;                                                   ///< 位置数组容量
+
+} SCAN_PART, *PSCAN_PART;
+
+
+/**
+ *\brief                        向输出缓冲区追加格式化字符串
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    fmt             格式
+ *\return                       无
+ */
+static void buf_printf(PPE_BUF buf, const char *fmt, ...)
+{
+    va_list ap;
+
+    for (;;)
+    {
+        size_t left = buf->cap - buf->len;
+
+        va_start(ap, fmt);
+        int len = vsnprintf(buf->data + buf->len, left, fmt, ap);
+        va_end(ap);
+
+        if (len < 0)
+        {
+            return;
+        }
+
+        if ((size_t)len < left)
+        {
+            buf->len += len;
+            return;
+        }
+
+        size_t cap  = (buf->cap + len + 1) * 2;
+        char  *data = realloc(buf->data, cap);
+
+        if (NULL == data)
+        {
+            return;
+        }
+
+        buf->data = data;
+        buf->cap  = cap;
+    }
+}
+
+/**
+ *\brief                        向输出缓冲区追加数据
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    data            数据
+ *\param[in]    len             长度
+ *\return                       无
+ */
+static void buf_write(PPE_BUF buf, const char *data, size_t len)
+{
+    if (0 != len && 0 == pe_buf_reserve(buf, len))
+    {
+        memcpy(buf->data + buf->len, data, len);
+        buf->len += len;
+    }
+}
+
+/**
+ *\brief                        插入树节点回调,节点句柄为深度+1,按缩进输出
+ *\param[in]    param           树的段
+ *\param[in]    parent          父节点句柄
+ *\param[in]    txt             节点文本
+ *\return                       新节点句柄
+ */
+static PE_NODE scan_insert(void *param, PE_NODE parent, const char *txt)
+{
+    PSCAN_PART part  = (PSCAN_PART)param;
+    intptr_t   depth = (intptr_t)parent;
+
+    buf_printf(&part->text, "%*s%s\n", (int)(depth + 1) * 2, "", txt);
+
+    return (PE_NODE)(depth + 1);
+}
+
+/**
+ *\brief                        段任务,输出延迟子树的一部分子节点
+ *\param[in]    param           树的段
+ *\param[in]    worker          线程序号
+ *\return                       无
+ */
+static void scan_part(void *param, int worker)
+{
+    PSCAN_PART part = (PSCAN_PART)param;
+
+    part->worker = worker; // 段中再分出的段加入这个线程的队列
+
+    pe_tree_expand_range(&part->tree, part->image, part->node, part->lazy, part->first, part->count);
+
+    atomic_add(part->pending, -1);
+}
+
+static PE_NODE scan_lazy(void *param, PE_NODE parent, const char *txt, DWORD lazy);
+
+/**
+ *\brief                        分出一段,在当前位置留下插入位置,加入任务池
+ *\param[in]    part            当前段
+ *\param[in]    node            延迟子树节点
+ *\param[in]    lazy            延迟子树标识
+ *\param[in]    first           第一个子节点序号
+ *\param[in]    count           子节点数量
+ *\return                       无
+ */
+static void scan_split(PSCAN_PART part, PE_NODE node, DWORD lazy, DWORD first, DWORD count)
+{
+    PSCAN_PART sub = calloc(1, sizeof(SCAN_PART));
+
+    if (NULL != sub && part->hole_count == part->hole_cap)
+    {
+        DWORD      cap  = part->hole_cap ? part->hole_cap * 2 : 16;
+        PSCAN_HOLE hole = realloc(part->hole, cap * sizeof(SCAN_HOLE));
+
+        if (NULL == hole)
+        {
+            free(sub);
+            sub = NULL;
+        }
+        else
+        {
+            part->hole     = hole;
+            part->hole_cap = cap;
+        }
+    }
+
+    if (NULL == sub) // 内存不足时在当前段输出
+    {
+        pe_tree_expand_range(&part->tree, part->image, node, lazy, first, count);
+        return;
+    }
+
+    sub->tree.insert = scan_insert;
+    sub->tree.param  = sub;
+    sub->tree.lazy   = scan_lazy;
+    sub->scan        = part->scan;
+    sub->image       = part->image;
+    sub->pending     = part->pending;
+    sub->node        = node;
+    sub->lazy        = lazy;
+    sub->first       = first;
+    sub->count       = count;
+
+    part->hole[part->hole_count].pos  = part->text.len;
+    part->hole[part->hole_count].part = sub;
+    part->hole_count++;
+
+    part->scan->worker[part->worker].stat.parts++;
+
+    atomic_add(part->pending, 1);
+
+    if (0 != task_push(&part->scan->pool, part->worker, scan_part, sub))
+    {
+        scan_part(sub, part->worker);
+    }
+}
+
+/**
+ *\brief                        插入延迟子树节点回调,小的子树立即展开,
+ *                              大的子树按估计的节点数分成多段,每段一个任务
+ *\param[in]    param           树的段
+ *\param[in]    parent          父节点句柄
+ *\param[in]    txt             节点文本
+ *\param[in]    lazy            延迟子树标识
+ *\return                       新节点句柄
+ */
+static PE_NODE scan_lazy(void *param, PE_NODE parent, const char *txt, DWORD lazy)
+{
+    PSCAN_PART part  = (PSCAN_PART)param;
+    PE_NODE    node  = scan_insert(param, parent, txt);
+    DWORD      count = pe_tree_count(part->image, lazy);
+    DWORD      split = part->scan->split;
+
+    if (0 == split || pe_tree_weight(part->image, lazy, 0, count) <= split)
+    {
+        pe_tree_expand(&part->tree, part->image, node, lazy);
+        return node;
+    }
+
+    for (DWORD first = 0, n; first < count; first += n)
+    {
+        ULONGLONG weight = pe_tree_weight(part->image, lazy, first, 1);
+
+        for (n = 1; first + n < count; n++)
+        {
+            ULONGLONG next = pe_tree_weight(part->image, lazy, first + n, 1);
+
+            if (weight + next > split)
+            {
+                break;
+            }
+
+            weight += next;
+        }
+
+        scan_split(part, node, lazy, first, n);
+    }
+
+    return node;
+}
+
+/**
+ *\brief                        按位置合并段的文本,合并后释放分出的段
+ *\param[out]   out             输出缓冲区
+ *\param[in]    part            段
+ *\return                       无
+ */
+static void scan_merge(PPE_BUF out, PSCAN_PART part)
+{
+    size_t pos = 0;
+
+    for (DWORD i = 0; i < part->hole_count; i++)
+    {
+        PSCAN_PART sub = part->hole[i].part;
+
+        buf_write(out, part->text.data + pos, part->hole[i].pos - pos);
+        pos = part->hole[i].pos;
+
+        scan_merge(out, sub);
+        pe_buf_free(&sub->text);
+        free(sub->hole);
+        free(sub);
+    }
+
+    buf_write(out, part->text.data + pos, part->text.len - pos);
+}
+
+/**
+ *\brief                        输出一个文件的树,等待所有段完成后合并
+ *\param[in]    worker          工作线程
+ *\param[in]    image           解析结果
+ *\return                       无
+ */
+static void scan_tree(PSCAN_WORKER worker, PPE_IMAGE image)
+{
+    volatile long pending = 0;
+    SCAN_PART     root    = { 0 };
+
+    root.tree.insert = scan_insert;
+    root.tree.param  = &root;
+    root.tree.lazy   = scan_lazy;
+    root.scan        = worker->scan;
+    root.image       = image;
+    root.pending     = &pending;
+    root.worker      = worker->id;
+    root.text        = worker->tree; // 复用缓冲区
+    root.text.len    = 0;
+
+    pe_insert_tree(&root.tree, image);
+
+    task_wait(&worker->scan->pool, worker->id, &pending);
+
+    scan_merge(&worker->out, &root);
+
+    worker->tree = root.text;
+    free(root.hole);
+}
+
+/**
+ *\brief                        输出一段数据的摘要行,以两个空格开头
+ *                              名称 文件位置 长度 熵 SHA-256 XXH64,没有计算的项为"-"
+ *\param[in]    worker          工作线程
+ *\param[in]    name            节名称或overlay
+ *\param[in]    flags           计算了哪几项
+ *\param[in]    item            统计结果
+ *\return                       无
+ */
+static void scan_digest_item(PSCAN_WORKER worker, const char *name, DWORD flags, PPE_DIGEST_ITEM item)
+{
+    char sha[HASH_SHA256_SIZE * 2 + 1] = "-";
+
+    buf_printf(&worker->out, "  %s\t%08x\t%llu\t", name, item->fa, (unsigned long long)item->size);
+
+    if (flags & PE_DIGEST_ENTROPY)
+    {
+        buf_printf(&worker->out, "%.4f\t", item->entropy);
+    }
+    else
+    {
+        buf_printf(&worker->out, "-\t");
+    }
+
+    if (flags & PE_DIGEST_SHA256)
+    {
+        for (int i = 0; i < HASH_SHA256_SIZE; i++)
+        {
+            snprintf(sha + i * 2, 3, "%02x", item->sha256[i]);
+        }
+    }
+
+    if (flags & PE_DIGEST_XXH64)
+    {
+        buf_printf(&worker->out, "%s\t%016llx\n", sha, (unsigned long long)item->xxh64);
+    }
+    else
+    {
+        buf_printf(&worker->out, "%s\t-\n", sha);
+    }
+}
+
+/**
+ *\brief                        在文件记录后输出每个节和附加数据的摘要行
+ *\param[in]    worker          工作线程
+ *\param[in]    image           解析结果,已计算摘要
+ *\return                       无
+ */
+static void scan_digest(PSCAN_WORKER worker, PPE_IMAGE image)
+{
+    PPE_DIGEST digest = image->digest;
+    char       name[16];
+
+    for (int i = 0; i < digest->section_count; i++)
+    {
+        scan_digest_item(worker, pe_section_name(image, i, name), digest->flags, &digest->section[i]);
+    }
+
+    if (digest->overlay)
+    {
+        scan_digest_item(worker, digest->overlay_cert ? "overlay+cert" : "overlay", digest->flags, &digest->overlay_item);
+    }
+}
+
+/**
+ *\brief                        在文件记录后输出指纹行,以两个空格开头
+ *                              imphash MD5 参与计算的函数数
+ *                              rich 位置 密钥 valid或invalid MD5 产品ID.版本号*数量,..
+ *\param[in]    worker          工作线程
+ *\param[in]    finger          指纹
+ *\return                       无
+ */
+static void scan_finger(PSCAN_WORKER worker, PPE_FINGER finger)
+{
+    char hex[HASH_MD5_SIZE * 2 + 1];
+
+    if (finger->imphash)
+    {
+        buf_printf(&worker->out, "  imphash\t%s\t%u\n", pe_finger_hex(finger->imphash_md5, hex), finger->imp_count);
+    }
+
+    if (!finger->rich)
+    {
+        return;
+    }
+
+    buf_printf(&worker->out, "  rich\t%04x\t%08x\t%s\t%s\t", finger->rich_fa, finger->rich_key,
+               finger->rich_valid ? "valid" : "invalid", pe_finger_hex(finger->rich_md5, hex));
+
+    for (DWORD i = 0; i < finger->rich_count; i++)
+    {
+        PPE_RICH_ENTRY entry = &finger->rich_entry[i];
+
+        buf_printf(&worker->out, "%s%u.%u*%u", (0 == i) ? "" : ",", entry->prod, entry->build, entry->count);
+    }
+
+    buf_write(&worker->out, "\n", 1);
+}
+
+/**
+ *\brief                        输出版本信息中的字符串,制表符和换行等控制字符换成空格
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    str             UTF-8字符串
+ *\return                       无
+ */
+static void scan_text(PPE_BUF buf, const char *str)
+{
+    size_t start = buf->len;
+
+    buf_write(buf, str, strlen(str));
+
+    for (size_t i = start; i < buf->len; i++)
+    {
+        if ((UCHAR)buf->data[i] < 0x20)
+        {
+            buf->data[i] = ' ';
+        }
+    }
+}
+
+/**
+ *\brief                        在文件记录后输出版本信息行,以两个空格开头
+ *                              version 文件版本 产品版本 语言 StringTable名称
+ *                              vstring 名称 值
+ *                              manifest 位置 长度 资源ID
+ *\param[in]    worker          工作线程
+ *\param[in]    version         版本信息
+ *\return                       无
+ */
+static void scan_version(PSCAN_WORKER worker, PPE_VERSION version)
+{
+    char file[24]    = "-";
+    char product[24] = "-";
+
+    if (version->info)
+    {
+        if (version->fixed)
+        {
+            pe_version_text(version->file_ms, version->file_ls, file);
+            pe_version_text(version->product_ms, version->product_ls, product);
+        }
+
+        buf_printf(&worker->out, "  version\t%s\t%s\t%04x\t", file, product, version->info_lang);
+        scan_text(&worker->out, ('\0' != version->table[0]) ? version->table : "-");
+        buf_write(&worker->out, "\n", 1);
+
+        for (DWORD i = 0; i < version->str_count; i++)
+        {
+            buf_write(&worker->out, "  vstring\t", 10);
+            scan_text(&worker->out, version->str[i].key);
+            buf_write(&worker->out, "\t", 1);
+            scan_text(&worker->out, version->str[i].value);
+            buf_write(&worker->out, "\n", 1);
+        }
+    }
+
+    if (version->manifest)
+    {
+        buf_printf(&worker->out, "  manifest\t%08x\t%u\t%u\n", version->manifest_fa, version->manifest_size, version->manifest_id);
+    }
+}
+
+/**
+ *\brief                        记下一个文件的一种指纹,用于结束时分组
+ *\param[in]    worker          工作线程
+ *\param[in]    kind            SCAN_GROUP_*
+ *\param[in]    md5             指纹
+ *\param[in]    path            文件路径
+ *\return                       无
+ */
+static void scan_group_add(PSCAN_WORKER worker, int kind, const UCHAR *md5, const char *path)
+{
+    if (worker->group_count == worker->group_cap)
+    {
+        size_t      cap   = worker->group_cap ? worker->group_cap * 2 : 1024;
+        PSCAN_GROUP group = realloc(worker->group, cap * sizeof(SCAN_GROUP));
+
+        if (NULL == group)
+        {
+            return;
+        }
+
+        worker->group     = group;
+        worker->group_cap = cap;
+    }
+
+    PSCAN_GROUP item = &worker->group[worker->group_count];
+
+    item->path = strdup(path);
+
+    if (NULL == item->path)
+    {
+        return;
+    }
+
+    memcpy(item->md5, md5, HASH_MD5_SIZE);
+    item->kind = kind;
+    worker->group_count++;
+}
+
+/**
+ *\brief                        输出PDB路径,控制字符换成空格,没有路径时为"-"
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    image           解析结果
+ *\param[in]    debug           调试目录
+ *\return                       无
+ */
+static void scan_pdb_path(PPE_BUF buf, PPE_IMAGE image, PPE_DEBUG debug)
+{
+    char path[PE_DEBUG_PATH_MAX + 1];
+
+    if (NULL == debug || !debug->codeview || 0 == debug->cv_path_len)
+    {
+        buf_write(buf, "-", 1);
+        return;
+    }
+
+    memcpy(path, image->view.data + debug->cv_path_fa, debug->cv_path_len);
+    path[debug->cv_path_len] = '\0';
+    scan_text(buf, path);
+}
+
+/**
+ *\brief                        输出调试目录的文本行
+ *                              debug 目录项数 各项类型名称(逗号分隔)
+ *                              pdb RSDS或NB10 GUID或签名 age 符号键 PDB路径
+ *\param[in]    worker          工作线程
+ *\param[in]    image           解析结果
+ *\param[in]    debug           调试目录
+ *\return                       无
+ */
+static void scan_debug(PSCAN_WORKER worker, PPE_IMAGE image, PPE_DEBUG debug)
+{
+    char key[PE_DEBUG_KEY_MAX];
+
+    buf_printf(&worker->out, "  debug\t%u\t", debug->count);
+
+    for (DWORD i = 0; i < debug->count; i++)
+    {
+        const char *name = pe_debug_type(debug->entry[i].type);
+
+        if (NULL != name)
+        {
+            buf_printf(&worker->out, "%s%s", (0 == i) ? "" : ",", name);
+        }
+        else
+        {
+            buf_printf(&worker->out, "%s%u", (0 == i) ? "" : ",", debug->entry[i].type);
+        }
+    }
+
+    buf_printf(&worker->out, "%s\n", (0 == debug->count) ? "-" : "");
+
+    if (debug->codeview)
+    {
+        if (PE_DEBUG_RSDS == debug->cv_format)
+        {
+            buf_printf(&worker->out, "  pdb\tRSDS\t%s\t%u\t", pe_debug_guid(debug->cv_guid, key), debug->cv_age);
+        }
+        else
+        {
+            buf_printf(&worker->out, "  pdb\tNB10\t%08X\t%u\t", debug->cv_signature, debug->cv_age);
+        }
+
+        pe_debug_key(image, key, sizeof(key));
+        scan_text(&worker->out, ('\0' != key[0]) ? key : "-");
+        buf_write(&worker->out, "\t", 1);
+        scan_pdb_path(&worker->out, image, debug);
+        buf_write(&worker->out, "\n", 1);
+    }
+}
+
+/**
+ *\brief                        输出十六进制的摘要,没有时为"-"
+ *\param[in]    buf             输出缓冲区
+ *\param[in]    data            摘要
+ *\param[in]    len             长度
+ *\return                       无
+ */
+static void scan_hex(PPE_BUF buf, const UCHAR *data, DWORD len)
+{
+    if (0 == len)
+    {
+        buf_write(buf, "-", 1);
+    }
+
+    for (DWORD i = 0; i < len; i++)
+    {
+        buf_printf(buf, "%02x", data[i]);
+    }
+}
+
+/**
+ *\brief                        输出签名的文本行
+ *                              auth 检查结果 算法 计算的摘要 签名中的摘要 WIN_CERTIFICATE数 证书数 签名者数
+ *\param[in]    worker          工作线程
+ *\param[in]    auth            签名和摘要
+ *\return                       无
+ */
+static void scan_auth(PSCAN_WORKER worker, PPE_AUTH auth)
+{
+    buf_printf(&worker->out, "  auth\t%s\t%s\t", pe_auth_status(auth), pe_auth_alg(auth->hash_alg));
+    scan_hex(&worker->out, auth->digest, auth->hashed ? auth->digest_len : 0);
+    buf_write(&worker->out, "\t", 1);
+    scan_hex(&worker->out, auth->signed_digest, auth->signed_len);
+    buf_printf(&worker->out, "\t%u\t%u\t%u\n", auth->count, auth->certs, auth->signers);
+}
+
+/**
+ *\brief                        输出一个文件的记录,指定了-o时按pe_emit的格式输出
+ *                              状态 文件长度 CPU类型 节数 导入库数 导入函数数 导出函数数 重定位项数 错误 路径
+ *                              错误为"部分/错误码/文件位置",没有错误时为"-"
+ *                              计算了摘要时后面跟每个节和附加数据的摘要行,计算了指纹时再跟指纹行
+ *\param[in]    worker          工作线程
+ *\param[in]    status          状态
+ *\param[in]    image           解析结果,可以为NULL
+ *\param[in]    size            文件长度
+ *\param[in]    path            文件路径
+ *\return                       无
+ */
+static void scan_record(PSCAN_WORKER worker, const char *status, PPE_IMAGE image,
+                        size_t size, const char *path)
+{
+    ULONGLONG funcs = 0;
+
+    if (worker->scan->format >= 0 && 0 != pe_emit(&worker->out, worker->scan->format, status, image, size, path))
+    {
+        fprintf(stderr, "emit %s error\n", path);
+    }
+
+    if (NULL == image)
+    {
+        if (worker->scan->format < 0)
+        {
+            buf_printf(&worker->out, "%s\t%zu\t0\t0\t0\t0\t0\t0\t-\t%s\n", status, size, path);
+        }
+
+        return;
+    }
+
+    for (DWORD i = 0; i < image->lib_count; i++)
+    {
+        funcs += image->lib[i].func_count;
+    }
+
+    worker->items += funcs + image->export.func_count + image->reloc_entries;
+
+    if (worker->scan->format >= 0)
+    {
+        return;
+    }
+
+    buf_printf(&worker->out, "%s\t%zu\t%04x\t%d\t%u\t%llu\t%u\t%llu\t",
+               status, size, image->machine, image->section_count,
+               image->lib_static + image->lib_delay, (unsigned long long)funcs,
+               image->export.func_count, (unsigned long long)image->reloc_entries);
+
+    if (PE_OK == image->error.code)
+    {
+        buf_printf(&worker->out, "-\t%s\n", path);
+    }
+    else
+    {
+        buf_printf(&worker->out, "%s/%s/%08x\t%s\n", image->error.part,
+                   pe_error_string(image->error.code), image->error.fa, path);
+    }
+
+    if (NULL != image->digest)
+    {
+        scan_digest(worker, image);
+    }
+
+    if (NULL != image->finger)
+    {
+        scan_finger(worker, image->finger);
+    }
+
+    if (NULL != image->version)
+    {
+        scan_version(worker, image->version);
+    }
+
+    if (NULL != image->debug)
+    {
+        scan_debug(worker, image, image->debug);
+    }
+
+    if (NULL != image->auth)
+    {
+        scan_auth(worker, image->auth);
+    }
+}
+
+/**
+ *\brief                        从缓存中取文件的记录,长度相同而修改时间或文件标识变了时比较内容散列
+ *\param[in]    worker          工作线程
+ *\param[in]    path            文件路径
+ *\param[in]    file            文件的长度,修改时间和标识
+ *\return                       0-命中,记录已写入输出缓冲区,-1-没有命中
+ */
+static int scan_cached(PSCAN_WORKER worker, const char *path, PPE_CACHE_ENTRY file)
+{
+    PSCAN          scan = worker->scan;
+    PE_CACHE_ENTRY entry;
+
+    if (0 != pe_cache_find(&scan->cache, path, scan->cache_mode, &entry))
+    {
+        return -1;
+    }
+
+    worker->stat.cache_stale += entry.stored; // 没有命中时会被新项覆盖
+
+    if (entry.size != file->size)
+    {
+        return -1;
+    }
+
+    if (entry.mtime != file->mtime || entry.id != file->id)
+    {
+        FILE_MAP map;
+
+        if (0 != file_map(path, &map))
+        {
+            return -1;
+        }
+
+        ULONGLONG hash = hash_xxh64(map.data, map.size, 0);
+        size_t    size = map.size;
+
+        file_unmap(&map);
+
+        if (size != entry.size || hash != entry.hash)
+        {
+            return -1;
+        }
+
+        entry.mtime = file->mtime;
+        entry.id    = file->id;
+        pe_cache_put(&worker->log, &entry); // 内容没变,更新修改时间,下次不用再算散列
+        worker->stat.cache_hash_hits++;
+    }
+    else
+    {
+        worker->stat.cache_stale -= entry.stored;
+    }
+
+    if (0 != pe_buf_reserve(&worker->out, entry.record_len))
+    {
+        return -1;
+    }
+
+    memcpy(worker->out.data + worker->out.len, entry.record, entry.record_len);
+    worker->out.len += entry.record_len;
+
+    worker->stat.pe_files    += (0 != (entry.flags & PE_CACHE_FLAG_PE));
+    worker->stat.errors      += (0 != (entry.flags & PE_CACHE_FLAG_ERROR));
+    worker->stat.items       += entry.items;
+    worker->stat.cache_hits++;
+    worker->stat.cache_saved += entry.size;
+    return 0;
+}
+
+/**
+ *\brief                        解析一个文件,结果写入输出缓冲区
+ *\param[in]    worker          工作线程
+ *\param[in]    path            文件路径
+ *\param[in]    stream          流式读取的数据,NULL时打开文件
+ *\return                       无
+ */
+static void scan_file(PSCAN_WORKER worker, const char *path, PPE_STREAM stream)
+{
+    PE_CACHE_ENTRY entry  = { 0 };
+    SCAN_STAT      before = worker->stat;
+    size_t         start  = worker->out.len;
+    PE_IMAGE       image;
+    FILE_MAP       map;
+
+    worker->stat.files++;
+    worker->items = 0;
+
+    // 先取长度,修改时间和标识再读文件,文件之后被修改时下次扫描不会命中
+    int cached = (NULL != worker->scan->cache_path) && NULL == stream &&
+                 0 == file_stat(path, &entry.size, &entry.mtime, &entry.id);
+
+    // 分组需要每个文件的指纹,缓存中只有输出的记录,不查缓存,结果仍然写入缓存
+    if (cached && NULL == worker->scan->group_path && 0 == scan_cached(worker, path, &entry))
+    {
+        return;
+    }
+
+    worker->stat.cache_misses += cached;
+
+    int ret = 0;
+
+    PE_STAT_START(mark);
+
+    if (NULL != stream) // 不需要的部分为0
+    {
+        memset(&map, 0, sizeof(map));
+        map.data = stream->data;
+        map.size = pe_stream_size(stream);
+    }
+    else
+    {
+        ret = worker->scan->read ? file_read(path, &map) : file_map(path, &map);
+    }
+
+    if (0 != ret)
+    {
+        worker->stat.errors++;
+        scan_record(worker, "open-error", NULL, 0, path);
+        return;
+    }
+
+    if (NULL == stream) // 流式读取在主线程计时
+    {
+        PE_STAT_LAP(mark, PE_STAT_LOAD, 1, map.size);
+    }
+
+    worker->stat.bytes += map.size;
+    worker->stat.parsed++;
+
+    // 文本格式不输出导入名称,不需要驻留
+    ret = pe_parse_pool(&image, map.data, map.size, &worker->pool, (worker->scan->format >= 0) ? &worker->intern : NULL);
+
+    PE_STAT_SKIP(mark); // 解析的各部分已经计时
+
+    if (PE_ERR_NOT_MZ == ret)
+    {
+        scan_record(worker, "not-pe", NULL, map.size, path);
+    }
+    else if (PE_ERR_UNSUPPORTED == ret)
+    {
+        scan_record(worker, "unsupported", NULL, map.size, path);
+    }
+    else if (PE_ERR_NT_RANGE == ret || PE_ERR_NOT_PE == ret)
+    {
+        worker->stat.errors++;
+        scan_record(worker, "bad-pe", NULL, map.size, path);
+    }
+    else
+    {
+        worker->stat.pe_files++;
+
+        if (PE_OK != ret)
+        {
+            worker->stat.errors++;
+        }
+
+        if (0 != worker->scan->digest && PE_ERR_MEMORY != ret) // 节表出错时只计算检查过的节
+        {
+            double start = time_now();
+
+            if (0 == pe_digest(&image, worker->scan->digest))
+            {
+                worker->stat.digest_files++;
+                worker->stat.digest_bytes    += image.digest->bytes;
+                worker->stat.digest_overlays += image.digest->overlay;
+            }
+
+            worker->stat.digest_time += time_now() - start;
+
+            PE_STAT_LAP(mark, PE_STAT_DIGEST, (NULL != image.digest) ? image.digest->section_count + image.digest->overlay : 0,
+                        (NULL != image.digest) ? image.digest->bytes : 0);
+        }
+
+        if (worker->scan->finger && PE_ERR_MEMORY != ret)
+        {
+            double start = time_now();
+
+            if (0 == pe_finger(&image, PE_FINGER_ALL))
+            {
+                PPE_FINGER finger = image.finger;
+
+                worker->stat.finger_files++;
+                worker->stat.finger_imphash += finger->imphash;
+                worker->stat.finger_rich    += finger->rich;
+                worker->stat.finger_invalid += finger->rich && !finger->rich_valid;
+
+                if (NULL != worker->scan->group_path && finger->imphash)
+                {
+                    scan_group_add(worker, SCAN_GROUP_IMPHASH, finger->imphash_md5, path);
+                }
+
+                if (NULL != worker->scan->group_path && finger->rich)
+                {
+                    scan_group_add(worker, SCAN_GROUP_RICH, finger->rich_md5, path);
+                }
+            }
+
+            worker->stat.finger_time += time_now() - start;
+
+            PE_STAT_LAP(mark, PE_STAT_FINGER, (NULL != image.finger) ? image.finger->imp_count + image.finger->rich_count : 0,
+                        (NULL != image.finger && image.finger->rich) ? image.finger->rich_end + 8 - image.finger->rich_fa : 0);
+        }
+
+        if (worker->scan->version && PE_ERR_MEMORY != ret)
+        {
+            double start = time_now();
+
+            if (0 == pe_version(&image, PE_VERSION_ALL))
+            {
+                worker->stat.version_files++;
+                worker->stat.version_info     += image.version->info;
+                worker->stat.version_manifest += image.version->manifest;
+            }
+
+            worker->stat.version_time += time_now() - start;
+
+            PE_STAT_LAP(mark, PE_STAT_VERSION, (NULL != image.version) ? image.version->str_count + image.version->manifest : 0,
+                        (NULL != image.version) ? image.version->info_size + image.version->manifest_size : 0);
+        }
+
+        if (worker->scan->debug && PE_ERR_MEMORY != ret)
+        {
+            double start = time_now();
+
+            if (0 == pe_debug(&image, PE_DEBUG_ALL))
+            {
+                worker->stat.debug_files++;
+                worker->stat.debug_entries  += image.debug->count;
+                worker->stat.debug_codeview += image.debug->codeview;
+            }
+
+            worker->stat.debug_time += time_now() - start;
+
+            PE_STAT_LAP(mark, PE_STAT_DEBUG, (NULL != image.debug) ? image.debug->count : 0,
+                        (NULL != image.debug) ? image.debug->count * sizeof(IMAGE_DEBUG_DIRECTORY) : 0);
+        }
+
+        if (worker->scan->auth && PE_ERR_MEMORY != ret)
+        {
+            double start = time_now();
+
+            // 映射的大文件按路径用流水线读入和散列,流式读取和整个读入时数据已经在内存中
+            int pipe = (NULL == stream && !worker->scan->read && map.size >= PE_AUTH_PIPE_MIN);
+
+            if (0 == pe_auth(&image, pipe ? PE_AUTH_CERT : PE_AUTH_ALL) && (!pipe || 0 == pe_auth_file(&image, path, 0, 0)))
+            {
+                PPE_AUTH auth = image.auth;
+
+                worker->stat.auth_files++;
+                worker->stat.auth_signed   += auth->cert;
+                worker->stat.auth_match    += auth->match;
+                worker->stat.auth_mismatch += auth->pkcs7 && auth->alg == auth->hash_alg && !auth->match;
+                worker->stat.auth_pipe     += auth->pipe;
+                worker->stat.auth_bytes    += auth->bytes;
+            }
+
+            worker->stat.auth_time += time_now() - start;
+
+            PE_STAT_LAP(mark, PE_STAT_AUTH, (NULL != image.auth) ? image.auth->count : 0,
+                        (NULL != image.auth) ? image.auth->bytes : 0);
+        }
+
+        scan_record(worker, (PE_OK == ret) ? "ok" : "error", &image, map.size, path);
+
+        if (PE_ERR_MEMORY != ret && worker->scan->tree && worker->scan->format < 0) // 出错时输出检查过的部分
+        {
+            scan_tree(worker, &image);
+        }
+    }
+
+    PE_STAT_LAP(mark, PE_STAT_OUTPUT, 1, worker->out.len - start);
+
+    worker->stat.items += worker->items;
+
+    if (cached && map.size == entry.size)
+    {
+        entry.hash       = hash_xxh64(map.data, map.size, 0);
+        entry.items      = worker->items;
+        entry.mode       = worker->scan->cache_mode;
+        entry.flags      = ((worker->stat.pe_files > before.pe_files) ? PE_CACHE_FLAG_PE    : 0) |
+                           ((worker->stat.errors   > before.errors)   ? PE_CACHE_FLAG_ERROR : 0);
+        entry.path       = path;
+        entry.path_len   = strlen(path);
+        entry.record     = (const UCHAR*)worker->out.data + start;
+        entry.record_len = worker->out.len - start;
+
+        pe_cache_put(&worker->log, &entry); // 记录太长或内存不足时不缓存
+    }
+
+    pe_free(&image);
+
+    if (NULL == stream)
+    {
+        file_unmap(&map);
+    }
+}
+
+/**
+ *\brief                        只取一个文件的符号键,结果写入输出缓冲区,不使用缓存.
+ *                              文件只按位置读入头部,节表,调试目录和CodeView记录;流式读取时只保存了这些部分.
+ *                              文本记录: 状态 映像键 PDB键 PDB路径 路径,没有的项为"-"
+ *\param[in]    worker          工作线程
+ *\param[in]    path            文件路径
+ *\param[in]    stream          流式读取的数据,NULL时打开文件
+ *\return                       无
+ */
+static void scan_key(PSCAN_WORKER worker, const char *path, PPE_STREAM stream)
+{
+    PE_DEBUG_FILE file   = { 0 };
+    const char   *status = "ok";
+    size_t        start  = worker->out.len;
+    char          key[PE_DEBUG_KEY_MAX];
+    PE_IMAGE      image;
+    int           ret;
+
+    worker->stat.files++;
+
+    PE_STAT_START(mark);
+
+    if (NULL != stream) // 头部和调试目录所在的节已经读入
+    {
+        file.size = pe_stream_size(stream);
+        ret       = pe_parse_head(&image, stream->data, file.size, &worker->pool);
+
+        if (PE_ERR_MEMORY != ret && !(ret < 0 && ret >= PE_ERR_UNSUPPORTED) && 0 != pe_debug(&image, PE_DEBUG_CODEVIEW))
+        {
+            ret = PE_ERR_MEMORY;
+        }
+    }
+    else
+    {
+        ret = pe_debug_open(&image, path, &worker->pool, PE_DEBUG_CODEVIEW, &file);
+
+        PE_STAT_LAP(mark, PE_STAT_LOAD, file.reads, file.loaded);
+    }
+
+    worker->stat.bytes     += file.loaded;
+    worker->stat.key_reads += file.reads;
+
+    switch (ret)
+    {
+    case 1:                  status = "open-error";  break;
+    case PE_ERR_NOT_MZ:      status = "not-pe";      break;
+    case PE_ERR_UNSUPPORTED: status = "unsupported"; break;
+    case PE_ERR_NT_RANGE:
+    case PE_ERR_NOT_PE:      status = "bad-pe";      break;
+    case PE_ERR_MEMORY:      status = "error";       break;
+    default:                 status = (PE_OK == ret) ? "ok" : "error"; break;
+    }
+
+    int pe = (1 != ret && !(ret < 0 && ret >= PE_ERR_UNSUPPORTED)); // 检查头部通过
+
+    worker->stat.errors    += (PE_OK != ret && PE_ERR_NOT_MZ != ret && PE_ERR_UNSUPPORTED != ret);
+    worker->stat.pe_files  += pe;
+    worker->stat.key_files += pe;
+
+    PE_STAT_LAP(mark, PE_STAT_DEBUG, pe, (NULL != image.debug) ? image.debug->count * sizeof(IMAGE_DEBUG_DIRECTORY) : 0);
+
+    if (pe && NULL != image.debug && image.debug->codeview && image.debug->cv_path_len > 0)
+    {
+        worker->stat.key_pdb++;
+    }
+
+    if (worker->scan->format >= 0)
+    {
+        if (0 != pe_emit_key(&worker->out, status, pe ? &image : NULL, file.size, path, file.loaded, file.reads))
+        {
+            fprintf(stderr, "emit %s error\n", path);
+        }
+    }
+    else if (!pe)
+    {
+        buf_printf(&worker->out, "%s\t-\t-\t-\t%s\n", status, path);
+    }
+    else
+    {
+        pe_image_key(&image, path, key, sizeof(key));
+        buf_printf(&worker->out, "%s\t", status);
+        scan_text(&worker->out, key);
+        buf_write(&worker->out, "\t", 1);
+        scan_text(&worker->out, (0 != pe_debug_key(&image, key, sizeof(key))) ? key : "-");
+        buf_write(&worker->out, "\t", 1);
+        scan_pdb_path(&worker->out, &image, image.debug);
+        buf_printf(&worker->out, "\t%s\n", path);
+    }
+
+    PE_STAT_LAP(mark, PE_STAT_OUTPUT, 1, worker->out.len - start);
+    (void)start; // PE_STAT_OFF时不计时
+
+    pe_free(&image);
+    pe_debug_close(&file);
+}
+
+/**
+ *\brief                        文件任务,解析一个文件,输出攒够一批时写出
+ *\param[in]    param           文件任务
+ *\param[in]    id              线程序号
+ *\return                       无
+ */
+static void scan_task(void *param, int id)
+{
+    PSCAN_FILE   file   = (PSCAN_FILE)param;
+    PSCAN        scan   = file->scan;
+    PSCAN_WORKER worker = &scan->worker[id];
+    double       start  = time_now();
+
+    if (scan->key)
+    {
+        scan_key(worker, file->path, file->stream);
+    }
+    else
+    {
+        scan_file(worker, file->path, file->stream);
+    }
+
+    if (NULL != file->stream)
+    {
+        pe_stream_free(file->stream);
+        free(file->stream);
+
+        mutex_lock(&scan->stream_lock);
+        scan->stream_busy--;
+        cond_signal(&scan->stream_cond);
+        mutex_unlock(&scan->stream_lock);
+    }
+
+    free(file);
+
+    double secs = time_now() - start;
+
+    if (secs > worker->stat.slowest)
+    {
+        worker->stat.slowest = secs;
+    }
+
+    if (worker->out.len >= 64 * 1024) // 攒够一批再输出,减少锁竞争
+    {
+        mutex_lock(&scan->out_lock);
+
+        if (worker->out.len)
+        {
+            fwrite(worker->out.data, 1, worker->out.len, stdout);
+        }
+
+        mutex_unlock(&scan->out_lock);
+        worker->out.len = 0;
+    }
+
+    if (worker->log.len >= SCAN_CACHE_FLUSH && 0 != pe_cache_append(scan->cache_path, &worker->log))
+    {
+        fprintf(stderr, "write cache %s error\n", scan->cache_path);
+    }
+}
+
+/**
+ *\brief                        工作线程,从任务池中取文件和树的段执行
+ *\param[in]    param           工作线程
+ *\return                       无
+ */
+static void scan_worker(void *param)
+{
+    PSCAN_WORKER worker = (PSCAN_WORKER)param;
+    PSCAN        scan   = worker->scan;
+
+    pe_stat_bind((NULL != scan->metrics_path) ? &worker->pe_stat : NULL);
+
+    task_loop(&scan->pool, worker->id);
+
+    if (NULL != scan->cache_path && 0 != pe_cache_append(scan->cache_path, &worker->log))
+    {
+        fprintf(stderr, "write cache %s error\n", scan->cache_path);
+    }
+
+    worker->stat.arena_allocs   = worker->pool.allocs;
+    worker->stat.arena_blocks   = worker->pool.blocks;
+    worker->stat.arena_peak     = worker->pool.peak;
+    worker->stat.intern_lookups = worker->intern.lookups;
+    worker->stat.intern_names   = worker->intern.count;
+    worker->stat.intern_bytes   = worker->intern.bytes;
+    worker->stat.intern_stored  = worker->intern.arena.reserved + worker->intern.slot_count * sizeof(PPE_NAME);
+
+    mutex_lock(&scan->out_lock);
+
+    if (worker->out.len) // 没有输出时缓冲区为NULL
+    {
+        fwrite(worker->out.data, 1, worker->out.len, stdout);
+    }
+
+    mutex_unlock(&scan->out_lock);
+    worker->out.len = 0;
+}
+
+/**
+ *\brief                        遍历目录回调,将文件加入任务池的公共队列
+ *\param[in]    path            文件路径
+ *\param[in]    param           扫描任务
+ *\return                       0-成功,其它失败
+ */
+static int scan_add(const char *path, void *param)
+{
+    PSCAN      scan = (PSCAN)param;
+    size_t     len  = strlen(path);
+    PSCAN_FILE file = malloc(sizeof(SCAN_FILE) + len);
+
+    if (NULL == file)
+    {
+        return -1;
+    }
+
+    file->scan   = scan;
+    file->stream = NULL;
+    memcpy(file->path, path, len + 1);
+
+    if (0 != task_push(&scan->pool, TASK_PUBLIC, scan_task, file))
+    {
+        free(file);
+        return -2;
+    }
+
+    return 0;
+}
+
+/**
+ *\brief                        流式输入读取回调,先返回判断格式时读出的开头
+ *\param[in]    param           SCAN_INPUT
+ *\param[out]   buff            缓冲区
+ *\param[in]    size            最多读取的字节数
+ *\return                       读到的字节数,0为结尾或出错
+ */
+static size_t scan_input_read(void *param, void *buff, size_t size)
+{
+    PSCAN_INPUT input = (PSCAN_INPUT)param;
+
+    if (input->head_pos < input->head_len)
+    {
+        size_t n = input->head_len - input->head_pos;
+
+        n = (n < size) ? n : size;
+        memcpy(buff, input->head + input->head_pos, n);
+        input->head_pos += n;
+        return n;
+    }
+
+    return fread(buff, 1, size, input->file);
+}
+
+/**
+ *\brief                        流式读取一个文件,交给工作线程解析,读入还没有解析的文件太多时等待
+ *\param[in]    scan            扫描任务
+ *\param[in]    name            文件名称
+ *\param[in]    read            读取回调
+ *\param[in]    param           回调参数
+ *\param[in]    size            文件长度,PE_STREAM_UNKNOWN为未知
+ *\return                       0-成功,其它失败
+ */
+static int scan_stream_file(PSCAN scan, const char *name, pe_read_proc read, void *param, ULONGLONG size)
+{
+    size_t     len    = strlen(name);
+    PSCAN_FILE file   = malloc(sizeof(SCAN_FILE) + len);
+    PPE_STREAM stream = malloc(sizeof(PE_STREAM));
+
+    if (NULL == file || NULL == stream)
+    {
+        free(file);
+        free(stream);
+        return -1;
+    }
+
+    mutex_lock(&scan->stream_lock);
+
+    while (scan->stream_busy >= scan->stream_max)
+    {
+        cond_wait(&scan->stream_cond, &scan->stream_lock);
+    }
+
+    scan->stream_busy++;
+    mutex_unlock(&scan->stream_lock);
+
+    PE_STAT_START(mark);
+
+    DWORD dirs = PE_STREAM_DIRS | (scan->debug ? PE_STREAM_DIR(PE_DIR_DEBUG) : 0) | ((scan->version || scan->tree) ? PE_STREAM_RSRC : 0);
+
+    dirs = scan->key ? PE_STREAM_DIR(PE_DIR_DEBUG) : (scan->digest || scan->auth) ? PE_STREAM_ALL : dirs;
+
+    int ret = pe_stream_load(stream, read, param, size, dirs);
+
+    if (0 == ret)
+    {
+        PE_STAT_LAP(mark, PE_STAT_LOAD, 1, stream->loaded + stream->skipped);
+
+        scan->stat.stream_files++;
+        scan->stat.stream_loaded  += stream->loaded;
+        scan->stat.stream_skipped += stream->skipped;
+
+        if (stream->loaded > scan->stat.stream_window)
+        {
+            scan->stat.stream_window = stream->loaded;
+        }
+
+        file->scan   = scan;
+        file->stream = stream;
+        memcpy(file->path, name, len + 1);
+
+        ret = task_push(&scan->pool, TASK_PUBLIC, scan_task, file);
+
+        if (0 != ret)
+        {
+            pe_stream_free(stream);
+        }
+    }
+
+    if (0 != ret)
+    {
+        free(file);
+        free(stream);
+
+        mutex_lock(&scan->stream_lock);
+        scan->stream_busy--;
+        mutex_unlock(&scan->stream_lock);
+    }
+
+    return ret;
+}
+
+/**
+ *\brief                        流式读取一个输入,tar包时逐个读取成员,否则作为一个文件
+ *\param[in]    path            文件路径,"-"为标准输入
+ *\param[in]    param           扫描任务
+ *\return                       0-成功,其它失败
+ */
+static int scan_stream(const char *path, void *param)
+{
+    PSCAN      scan  = (PSCAN)param;
+    SCAN_INPUT input = { 0 };
+    ULONGLONG  size  = PE_STREAM_UNKNOWN;
+    ULONGLONG  mtime = 0;
+    int        ret   = 0;
+
+    if (0 == strcmp(path, "-"))
+    {
+        stdin_binary();
+        input.file = stdin;
+    }
+    else
+    {
+        input.file = file_open(path, "rb");
+
+        if (NULL != input.file && 0 != file_stat(path, &size, &mtime, NULL))
+        {
+            size = PE_STREAM_UNKNOWN;
+        }
+    }
+
+    if (NULL == input.file)
+    {
+        return -1;
+    }
+
+    while (input.head_len < PE_TAR_BLOCK) // 管道一次可能读不满
+    {
+        size_t n = fread(input.head + input.head_len, 1, PE_TAR_BLOCK - input.head_len, input.file);
+
+        if (0 == n)
+        {
+            break;
+        }
+
+        input.head_len += n;
+    }
+
+    if (PE_TAR_BLOCK == input.head_len && pe_tar_check(input.head))
+    {
+        PE_TAR tar = { 0 };
+        char   name[PE_TAR_NAME * 2];
+
+        tar.read  = scan_input_read;
+        tar.param = &input;
+
+        while (0 == ret && 1 == (ret = pe_tar_next(&tar)))
+        {
+            snprintf(name, sizeof(name), "%s:%s", path, tar.name);
+            ret = scan_stream_file(scan, name, pe_tar_read, &tar, tar.size);
+        }
+    }
+    else
+    {
+        ret = scan_stream_file(scan, path, scan_input_read, &input, size);
+    }
+
+    if (stdin != input.file)
+    {
+        fclose(input.file);
+    }
+
+    return (ret < 0) ? ret : 0;
+}
+
+/**
+ *\brief                        指纹排序比较,按种类,指纹,路径
+ *\param[in]    a               SCAN_GROUP
+ *\param[in]    b               SCAN_GROUP
+ *\return                       <0,0,>0
+ */
+static int scan_group_cmp(const void *a, const void *b)
+{
+    const SCAN_GROUP *x = (const SCAN_GROUP*)a;
+    const SCAN_GROUP *y = (const SCAN_GROUP*)b;
+
+    if (x->kind != y->kind)
+    {
+        return x->kind - y->kind;
+    }
+
+    int ret = memcmp(x->md5, y->md5, HASH_MD5_SIZE);
+
+    return (0 != ret) ? ret : strcmp(x->path, y->path);
+}
+
+/**
+ *\brief                        组排序比较,文件多的在前,相同时按指纹顺序
+ *\param[in]    a               SCAN_CLUSTER
+ *\param[in]    b               SCAN_CLUSTER
+ *\return                       <0,0,>0
+ */
+static int scan_cluster_cmp(const void *a, const void *b)
+{
+    const SCAN_CLUSTER *x = (const SCAN_CLUSTER*)a;
+    const SCAN_CLUSTER *y = (const SCAN_CLUSTER*)b;
+
+    if (x->count != y->count)
+    {
+        return (x->count < y->count) ? 1 : -1;
+    }
+
+    return (x->first < y->first) ? -1 : (x->first > y->first);
+}
+
+/**
+ *\brief                        合并各线程记下的指纹,排序后把有2个以上文件的组写入分组文件,文件多的组在前,
+ *                              每行:种类(imphash或rich) 指纹 组内文件数 路径.释放各线程的指纹
+ *\param[in]    scan            扫描任务
+ *\param[in]    threads         线程数
+ *\return                       0-成功,其它失败
+ */
+static int scan_group_write(PSCAN scan, int threads)
+{
+    static const char *kind_name[] = { "imphash", "rich" };
+
+    size_t total = 0;
+
+    for (int i = 0; i < threads; i++)
+    {
+        total += scan->worker[i].group_count;
+    }
+
+    PSCAN_GROUP   group   = malloc((total + 1) * sizeof(SCAN_GROUP));
+    PSCAN_CLUSTER cluster = malloc((total + 1) * sizeof(SCAN_CLUSTER));
+    FILE         *file    = file_open(scan->group_path, "wb");
+    size_t        count   = 0;
+    int           ret     = -1;
+
+    for (int i = 0; i < threads; i++)
+    {
+        PSCAN_WORKER worker = &scan->worker[i];
+
+        if (NULL != group)
+        {
+            memcpy(group + count, worker->group, worker->group_count * sizeof(SCAN_GROUP));
+            count += worker->group_count;
+        }
+        else
+        {
+            for (size_t j = 0; j < worker->group_count; j++)
+            {
+                free(worker->group[j].path);
+            }
+        }
+
+        free(worker->group);
+        worker->group       = NULL;
+        worker->group_count = 0;
+    }
+
+    if (NULL != group && NULL != cluster && NULL != file)
+    {
+        size_t distinct[2] = { 0 };
+        size_t clusters[2] = { 0 };
+        size_t grouped[2]  = { 0 };
+        size_t cluster_count = 0;
+        char   hex[HASH_MD5_SIZE * 2 + 1];
+
+        qsort(group, count, sizeof(SCAN_GROUP), scan_group_cmp);
+
+        for (size_t i = 0, j = 0; i < count; i = j)
+        {
+            for (j = i + 1; j < count && group[j].kind == group[i].kind &&
+                            0 == memcmp(group[j].md5, group[i].md5, HASH_MD5_SIZE); j++)
+            {
+            }
+
+            distinct[group[i].kind]++;
+
+            if (j - i > 1) // 只有一个文件的指纹不成组
+            {
+                cluster[cluster_count].first = i;
+                cluster[cluster_count].count = j - i;
+                cluster_count++;
+                clusters[group[i].kind]++;
+                grouped[group[i].kind] += j - i;
+            }
+        }
+
+        qsort(cluster, cluster_count, sizeof(SCAN_CLUSTER), scan_cluster_cmp);
+
+        for (size_t i = 0; i < cluster_count; i++)
+        {
+            PSCAN_GROUP first = &group[cluster[i].first];
+
+            pe_finger_hex(first->md5, hex);
+
+            for (size_t j = 0; j < cluster[i].count; j++)
+            {
+                fprintf(file, "%s\t%s\t%zu\t%s\n", kind_name[first->kind], hex, cluster[i].count, first[j].path);
+            }
+        }
+
+        ret = ferror(file) ? -2 : 0;
+
+        fprintf(stderr, "group imphash distinct:%zu groups:%zu files:%zu rich distinct:%zu groups:%zu files:%zu\n",
+                distinct[SCAN_GROUP_IMPHASH], clusters[SCAN_GROUP_IMPHASH], grouped[SCAN_GROUP_IMPHASH],
+                distinct[SCAN_GROUP_RICH], clusters[SCAN_GROUP_RICH], grouped[SCAN_GROUP_RICH]);
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        free(group[i].path);
+    }
+
+    if (NULL != file && 0 != fclose(file))
+    {
+        ret = -2;
+    }
+
+    free(cluster);
+    free(group);
+    return ret;
+}
+
+int scan_main(int argc, char **argv)
+{
+    SCAN scan    = {0};
+    int  threads = cpu_count();
+
+    scan.format = -1;
+    scan.split  = SCAN_SPLIT;
+
+    int  first   = argc;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp(argv[i], "-j") && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if (0 == strcmp(argv[i], "-t"))
+        {
+            scan.tree = 1;
+        }
+        else if (0 == strcmp(argv[i], "-s") && i + 1 < argc)
+        {
+            scan.split = (DWORD)strtoul(argv[++i], NULL, 0);
+        }
+        else if (0 == strcmp(argv[i], "-x"))
+        {
+            scan.stream = 1;
+        }
+        else if (0 == strcmp(argv[i], "-d") && i + 1 < argc)
+        {
+            int digest = pe_digest_flags(argv[++i]);
+
+            if (digest <= 0)
+            {
+                first = argc;
+                break;
+            }
+
+            scan.digest = (DWORD)digest;
+        }
+        else if (0 == strcmp(argv[i], "-f"))
+        {
+            scan.finger = 1;
+        }
+        else if (0 == strcmp(argv[i], "-g") && i + 1 < argc)
+        {
+            scan.finger     = 1;
+            scan.group_path = argv[++i];
+        }
+        else if (0 == strcmp(argv[i], "-v"))
+        {
+            scan.version = 1;
+        }
+        else if (0 == strcmp(argv[i], "-p"))
+        {
+            scan.debug = 1;
+        }
+        else if (0 == strcmp(argv[i], "-k"))
+        {
+            scan.key = 1;
+        }
+        else if (0 == strcmp(argv[i], "-a"))
+        {
+            scan.auth = 1;
+        }
+        else if (0 == strcmp(argv[i], "-r"))
+        {
+            scan.read = 1;
+        }
+        else if (0 == strcmp(argv[i], "-c") && i + 1 < argc)
+        {
+            scan.cache_path = argv[++i];
+        }
+        else if (0 == strcmp(argv[i], "-m") && i + 1 < argc)
+        {
+            scan.metrics_path = argv[++i];
+        }
+        else if (0 == strcmp(argv[i], "-o") && i + 1 < argc)
+        {
+            scan.format = pe_emit_format(argv[++i]);
+
+            if (scan.format < 0)
+            {
+                first = argc;
+                break;
+            }
+        }
+        else
+        {
+            first = i;
+            break;
+        }
+    }
+
+    if (scan.key && PE_EMIT_BIN == scan.format) // 只取符号键的记录只有JSON格式
+    {
+        first = argc;
+    }
+
+    if (first >= argc)
+    {
+        fprintf(stderr, "usage: peinfo scan [-j threads] [-t] [-s nodes] [-r] [-x] [-d entropy,sha256,xxh64,overlay|all] [-f] [-g groups] [-v] [-p] [-k] [-a] [-o json|bin] [-c cache] [-m metrics] path...\n");
+        return -1;
+    }
+
+    if (threads < 1)
+    {
+        threads = 1;
+    }
+
+    if (PE_EMIT_BIN == scan.format)
+    {
+        stdout_binary();
+    }
+
+    // 摘要项放在格式和树之外空闲的位,指纹用低字节的最后一位,版本信息,调试目录和签名用缓存项格式扩展出的高4位
+    scan.cache_mode = (DWORD)(scan.format + 1) | ((scan.digest & 3) << 2) | (scan.tree << 4) | ((scan.digest >> 2) << 5) |
+                      (scan.finger << 7) | (scan.version << 8) | (scan.debug << 9) | (scan.auth << 10);
+
+    if (scan.key) // 只取符号键时读入的量很小,不使用缓存
+    {
+        scan.cache_path = NULL;
+    }
+
+    if (NULL != scan.cache_path && 0 != pe_cache_open(&scan.cache, scan.cache_path))
+    {
+        fprintf(stderr, "open cache %s error, scan without it\n", scan.cache_path);
+    }
+
+    PSCAN_WORKER worker = calloc(threads, sizeof(SCAN_WORKER));
+
+    if (NULL == worker || 0 != task_pool_init(&scan.pool, threads))
+    {
+        free(worker);
+        pe_cache_close(&scan.cache);
+        return -2;
+    }
+
+    mutex_init(&scan.out_lock);
+    mutex_init(&scan.stream_lock);
+    cond_init(&scan.stream_cond);
+    scan.worker     = worker;
+    scan.stream_max = threads * 2;
+
+    pe_stat_bind((NULL != scan.metrics_path) ? &scan.pe_stat : NULL); // 流式读取在主线程
+
+    double start = time_now();
+
+    for (int i = 0; i < threads; i++)
+    {
+        worker[i].scan = &scan;
+        worker[i].id   = i;
+        thread_create(&worker[i].thread, scan_worker, &worker[i]);
+    }
+
+    for (int i = first; i < argc; i++)
+    {
+        if (scan.stream && 0 == strcmp(argv[i], "-"))
+        {
+            if (0 != scan_stream(argv[i], &scan))
+            {
+                fprintf(stderr, "read stdin error\n");
+            }
+        }
+        else if (0 != dir_walk(argv[i], scan.stream ? scan_stream : scan_add, &scan))
+        {
+            fprintf(stderr, "walk %s error\n", argv[i]);
+        }
+    }
+
+    task_finish(&scan.pool);
+
+    for (int i = 0; i < threads; i++)
+    {
+        thread_join(worker[i].thread);
+
+        scan.stat.files    += worker[i].stat.files;
+        scan.stat.pe_files += worker[i].stat.pe_files;
+        scan.stat.errors   += worker[i].stat.errors;
+        scan.stat.bytes    += worker[i].stat.bytes;
+        scan.stat.items    += worker[i].stat.items;
+
+        scan.stat.cache_hits      += worker[i].stat.cache_hits;
+        scan.stat.cache_hash_hits += worker[i].stat.cache_hash_hits;
+        scan.stat.cache_misses    += worker[i].stat.cache_misses;
+        scan.stat.cache_saved     += worker[i].stat.cache_saved;
+        scan.stat.cache_stale     += worker[i].stat.cache_stale;
+
+        scan.stat.parsed         += worker[i].stat.parsed;
+        scan.stat.arena_allocs   += worker[i].stat.arena_allocs;
+        scan.stat.arena_blocks   += worker[i].stat.arena_blocks;
+        scan.stat.intern_lookups += worker[i].stat.intern_lookups;
+        scan.stat.intern_names   += worker[i].stat.intern_names;
+        scan.stat.intern_bytes   += worker[i].stat.intern_bytes;
+        scan.stat.intern_stored  += worker[i].stat.intern_stored;
+        scan.stat.parts          += worker[i].stat.parts;
+
+        scan.stat.digest_files    += worker[i].stat.digest_files;
+        scan.stat.digest_bytes    += worker[i].stat.digest_bytes;
+        scan.stat.digest_overlays += worker[i].stat.digest_overlays;
+        scan.stat.digest_time     += worker[i].stat.digest_time;
+
+        scan.stat.finger_files   += worker[i].stat.finger_files;
+        scan.stat.finger_imphash += worker[i].stat.finger_imphash;
+        scan.stat.finger_rich    += worker[i].stat.finger_rich;
+        scan.stat.finger_invalid += worker[i].stat.finger_invalid;
+        scan.stat.finger_time    += worker[i].stat.finger_time;
+        scan.stat.version_files    += worker[i].stat.version_files;
+        scan.stat.version_info     += worker[i].stat.version_info;
+        scan.stat.version_manifest += worker[i].stat.version_manifest;
+        scan.stat.version_time     += worker[i].stat.version_time;
+        scan.stat.debug_files    += worker[i].stat.debug_files;
+        scan.stat.debug_entries  += worker[i].stat.debug_entries;
+        scan.stat.debug_codeview += worker[i].stat.debug_codeview;
+        scan.stat.debug_time     += worker[i].stat.debug_time;
+        scan.stat.key_files += worker[i].stat.key_files;
+        scan.stat.key_pdb   += worker[i].stat.key_pdb;
+        scan.stat.key_reads += worker[i].stat.key_reads;
+        scan.stat.auth_files    += worker[i].stat.auth_files;
+        scan.stat.auth_signed   += worker[i].stat.auth_signed;
+        scan.stat.auth_match    += worker[i].stat.auth_match;
+        scan.stat.auth_mismatch += worker[i].stat.auth_mismatch;
+        scan.stat.auth_pipe     += worker[i].stat.auth_pipe;
+        scan.stat.auth_bytes    += worker[i].stat.auth_bytes;
+        scan.stat.auth_time     += worker[i].stat.auth_time;
+
+        pe_stat_merge(&scan.pe_stat, &worker[i].pe_stat);
+
+        if (worker[i].stat.slowest > scan.stat.slowest)
+        {
+            scan.stat.slowest = worker[i].stat.slowest;
+        }
+
+        if (worker[i].stat.arena_peak > scan.stat.arena_peak)
+        {
+            scan.stat.arena_peak = worker[i].stat.arena_peak;
+        }
+
+        pe_arena_free(&worker[i].pool);
+        pe_intern_free(&worker[i].intern);
+        pe_buf_free(&worker[i].out);
+        pe_buf_free(&worker[i].tree);
+        pe_buf_free(&worker[i].log);
+    }
+
+    double secs = time_now() - start;
+
+    if (secs <= 0)
+    {
+        secs = 1e-9;
+    }
+
+    fflush(stdout);
+    fprintf(stderr, "files:%llu pe:%llu errors:%llu items:%llu bytes:%llu threads:%d\n",
+            (unsigned long long)scan.stat.files,
+            (unsigned long long)scan.stat.pe_files,
+            (unsigned long long)scan.stat.errors,
+            (unsigned long long)scan.stat.items,
+            (unsigned long long)scan.stat.bytes,
+            threads);
+    fprintf(stderr, "time:%.3fs %.1f files/s %.2f MB/s peak:%zuKB faults:%zu\n",
+            secs, scan.stat.files / secs, scan.stat.bytes / secs / (1024 * 1024),
+            mem_peak(), page_faults());
+
+    fprintf(stderr, "tasks parts:%llu stolen:%ld slowest:%.3fs\n",
+            (unsigned long long)scan.stat.parts, scan.pool.stolen, scan.stat.slowest);
+
+    if (scan.stat.stream_files > 0)
+    {
+        fprintf(stderr, "stream files:%llu loaded:%.2fMB skipped:%.2fMB window:%lluKB\n",
+                (unsigned long long)scan.stat.stream_files,
+                scan.stat.stream_loaded / (1024.0 * 1024),
+                scan.stat.stream_skipped / (1024.0 * 1024),
+                (unsigned long long)(scan.stat.stream_window + 1023) / 1024);
+    }
+
+    if (scan.stat.digest_files > 0)
+    {
+        double busy = (scan.stat.digest_time > 0) ? scan.stat.digest_time : 1e-9;
+
+        // 每个线程的速度,总速度约为乘以线程数
+        fprintf(stderr, "digest files:%llu overlays:%llu bytes:%.2fMB %.2f GB/s/thread sha256:%s\n",
+                (unsigned long long)scan.stat.digest_files,
+                (unsigned long long)scan.stat.digest_overlays,
+                scan.stat.digest_bytes / (1024.0 * 1024),
+                scan.stat.digest_bytes / busy / (1024.0 * 1024 * 1024),
+                hash_sha256_impl());
+    }
+
+    if (scan.stat.finger_files > 0)
+    {
+        double busy = (scan.stat.finger_time > 0) ? scan.stat.finger_time : 1e-9;
+
+        fprintf(stderr, "finger files:%llu imphash:%llu rich:%llu rich-invalid:%llu %.0f files/s/thread\n",
+                (unsigned long long)scan.stat.finger_files,
+                (unsigned long long)scan.stat.finger_imphash,
+                (unsigned long long)scan.stat.finger_rich,
+                (unsigned long long)scan.stat.finger_invalid,
+                scan.stat.finger_files / busy);
+    }
+
+    if (scan.stat.version_files > 0)
+    {
+        double busy = (scan.stat.version_time > 0) ? scan.stat.version_time : 1e-9;
+
+        fprintf(stderr, "version files:%llu info:%llu manifest:%llu %.0f files/s/thread\n",
+                (unsigned long long)scan.stat.version_files,
+                (unsigned long long)scan.stat.version_info,
+                (unsigned long long)scan.stat.version_manifest,
+                scan.stat.version_files / busy);
+    }
+
+    if (scan.stat.debug_files > 0)
+    {
+        double busy = (scan.stat.debug_time > 0) ? scan.stat.debug_time : 1e-9;
+
+        fprintf(stderr, "debug files:%llu entries:%llu codeview:%llu %.0f files/s/thread\n",
+                (unsigned long long)scan.stat.debug_files,
+                (unsigned long long)scan.stat.debug_entries,
+                (unsigned long long)scan.stat.debug_codeview,
+                scan.stat.debug_files / busy);
+    }
+
+    if (scan.stat.auth_files > 0)
+    {
+        double busy = (scan.stat.auth_time > 0) ? scan.stat.auth_time : 1e-9;
+
+        // 时间包括解码证书表和流水线的等待
+        fprintf(stderr, "auth files:%llu signed:%llu match:%llu mismatch:%llu pipe:%llu bytes:%.2fMB %.2f GB/s/thread\n",
+                (unsigned long long)scan.stat.auth_files,
+                (unsigned long long)scan.stat.auth_signed,
+                (unsigned long long)scan.stat.auth_match,
+                (unsigned long long)scan.stat.auth_mismatch,
+                (unsigned long long)scan.stat.auth_pipe,
+                scan.stat.auth_bytes / (1024.0 * 1024),
+                scan.stat.auth_bytes / busy / (1024.0 * 1024 * 1024));
+    }
+
+    if (scan.key)
+    {
+        // 每个文件读入的量,与文件长度无关
+        fprintf(stderr, "key files:%llu pdb:%llu reads:%llu loaded:%.2fMB %.1fKB/file\n",
+                (unsigned long long)scan.stat.key_files,
+                (unsigned long long)scan.stat.key_pdb,
+                (unsigned long long)scan.stat.key_reads,
+                scan.stat.bytes / (1024.0 * 1024),
+                (scan.stat.files > 0) ? scan.stat.bytes / 1024.0 / scan.stat.files : 0.0);
+    }
+
+    if (NULL != scan.metrics_path)
+    {
+#ifndef PE_STAT_OFF
+        pe_stat_print(stderr, &scan.pe_stat);
+
+        if (0 != pe_stat_prom(scan.metrics_path, &scan.pe_stat, threads, secs))
+        {
+            fprintf(stderr, "write metrics %s error\n", scan.metrics_path);
+        }
+#else
+        fprintf(stderr, "metrics not compiled in (PE_STAT_OFF), %s not written\n", scan.metrics_path);
+#endif
+    }
+
+    if (NULL != scan.group_path && 0 != scan_group_write(&scan, threads))
+    {
+        fprintf(stderr, "write groups %s error\n", scan.group_path);
+    }
+
+    if (scan.stat.parsed > 0)
+    {
+        // objects为不用内存池时的malloc次数
+        fprintf(stderr, "alloc parsed:%llu objects/file:%.1f mallocs/file:%.3f arena-peak:%lluKB\n",
+                (unsigned long long)scan.stat.parsed,
+                (double)scan.stat.arena_allocs / scan.stat.parsed,
+                (double)scan.stat.arena_blocks / scan.stat.parsed,
+                (unsigned long long)(scan.stat.arena_peak + 1023) / 1024);
+    }
+
+    if (scan.stat.intern_lookups > 0)
+    {
+        fprintf(stderr, "intern names:%llu unique:%llu bytes:%.2fMB stored:%.2fMB\n",
+                (unsigned long long)scan.stat.intern_lookups,
+                (unsigned long long)scan.stat.intern_names,
+                scan.stat.intern_bytes / (1024.0 * 1024),
+                scan.stat.intern_stored / (1024.0 * 1024));
+    }
+
+    if (NULL != scan.cache_path)
+    {
+        ULONGLONG lookups = scan.stat.cache_hits + scan.stat.cache_misses;
+
+        fprintf(stderr, "cache hits:%llu hash-hits:%llu misses:%llu rate:%.1f%% saved:%.2fMB\n",
+                (unsigned long long)scan.stat.cache_hits,
+                (unsigned long long)scan.stat.cache_hash_hits,
+                (unsigned long long)scan.stat.cache_misses,
+                lookups ? 100.0 * scan.stat.cache_hits / lookups : 0.0,
+                scan.stat.cache_saved / (1024.0 * 1024));
+
+        // 同一路径查找多次时(重复给出或经过链接)过期长度会重复计算,不能超过有效长度
+        ULONGLONG stale = (scan.stat.cache_stale < scan.cache.live_bytes) ? scan.stat.cache_stale : scan.cache.live_bytes;
+
+        // 过期的项超过有效的项时压缩,没有新的过期项时不用再读缓存文件
+        if (scan.cache.garbage > 0 || scan.cache.dead_bytes + stale > scan.cache.live_bytes - stale)
+        {
+            ULONGLONG before;
+            ULONGLONG after;
+
+            pe_cache_close(&scan.cache);
+
+            if (0 != pe_cache_compact(scan.cache_path, 0, &before, &after))
+            {
+                fprintf(stderr, "compact cache %s error\n", scan.cache_path);
+            }
+            else if (before != after)
+            {
+                fprintf(stderr, "cache compact:%llu->%llu\n", (unsigned long long)before, (unsigned long long)after);
+            }
+        }
+    }
+
+    pe_stat_bind(NULL);
+    free(worker);
+    pe_cache_close(&scan.cache);
+    task_pool_free(&scan.pool);
+    cond_free(&scan.stream_cond);
+    mutex_free(&scan.stream_lock);
+    mutex_free(&scan.out_lock);
+    return 0;
+}
@@ -0,0 +1,26 @@
+/**
+ *\file     scan.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    无界面批量扫描接口定义
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加结果缓存
+ */
+#ifndef _SCAN_H_
+#define _SCAN_H_
+
+/**
+ *\brief                        批量扫描命令,递归遍历目录,多线程解析所有文件
+ *                              peinfo scan [-j 线程数] [-t] [-r] [-o json|bin] [-c 缓存文件] 路径...
+ *                              -t 输出完整的树, -r 整个文件读入内存而不是内存映射,
+ *                              -o 机器可读的记录格式, -c 使用并更新扫描结果缓存,见pe_cache.h
+ *\param[in]    argc            参数个数
+ *\param[in]    argv            参数,argv[0]为命令名
+ *\return                       0-成功,其它失败
+ */
+int scan_main(int argc, char **argv);
+
+#endif
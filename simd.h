@@ -0,0 +1,134 @@
+/**
+ *\file     simd.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    向量指令集的运行时选择
+ *          x86下向量实现的函数用SIMD_TARGET单独指定指令集,其它代码仍按基本指令集编译,
+ *          运行时用simd_supported检查CPU后再调用;其它CPU只有逐项的实现
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件,从pe_reloc.c中分离
+ *          2026.10.18|增加SHA扩展指令的检查
+ */
+#ifndef _SIMD_H_
+#define _SIMD_H_
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define SIMD_TARGET(x)                                                      ///< MSVC不需要指定指令集
+#else
+#define SIMD_TARGET(x)          __attribute__((target(x)))                  ///< 只有这个函数使用指定的指令集
+#include <cpuid.h>
+#endif
+#endif
+
+#define SIMD_AUTO               -1                                          ///< 按CPU选择
+#define SIMD_SCALAR             0                                           ///< 逐项
+#define SIMD_SSE2               1                                           ///< SSE2,128位
+#define SIMD_AVX2               2                                           ///< AVX2,256位
+#define SIMD_SHA                3                                           ///< SHA扩展指令和SSE4.1,与向量宽度无关,不参与simd_best
+
+/**
+ *\brief                        CPU是否支持指令集
+ *\param[in]    level           SIMD_SCALAR,SIMD_SSE2,SIMD_AVX2
+ *\return                       1-支持,0-不支持
+ */
+static inline int simd_supported(int level)
+{
+    if (SIMD_SCALAR == level)
+    {
+        return 1;
+    }
+
+#if defined(SIMD_X86) && defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 1);
+
+    if (SIMD_SSE2 == level)
+    {
+        return 0 != (info[3] & (1 << 26));
+    }
+
+    if (SIMD_AVX2 == level)
+    {
+        if (0 == (info[2] & (1 << 27)) || 6 != (_xgetbv(0) & 6)) // 系统要保存YMM寄存器
+        {
+            return 0;
+        }
+
+        __cpuidex(info, 7, 0);
+        return 0 != (info[1] & (1 << 5));
+    }
+
+    if (SIMD_SHA == level)
+    {
+        if (0 == (info[2] & (1 << 19)) || 0 == (info[2] & (1 << 9))) // SSE4.1,SSSE3
+        {
+            return 0;
+        }
+
+        __cpuidex(info, 7, 0);
+        return 0 != (info[1] & (1 << 29));
+    }
+#elif defined(SIMD_X86)
+    if (SIMD_SSE2 == level)
+    {
+        return __builtin_cpu_supports("sse2");
+    }
+
+    if (SIMD_AVX2 == level)
+    {
+        return __builtin_cpu_supports("avx2");
+    }
+
+    if (SIMD_SHA == level)
+    {
+        unsigned a, b, c, d;
+
+        if (!__builtin_cpu_supports("sse4.1") || !__builtin_cpu_supports("ssse3") || !__get_cpuid_count(7, 0, &a, &b, &c, &d))
+        {
+            return 0;
+        }
+
+        return 0 != (b & (1 << 29));
+    }
+#endif
+
+    return 0;
+}
+
+/**
+ *\brief                        CPU支持的最高指令集
+ *\param[in]    max             不超过的指令集,实现只到max
+ *\return                       SIMD_SCALAR,SIMD_SSE2,SIMD_AVX2
+ */
+static inline int simd_best(int max)
+{
+    for (; max > SIMD_SCALAR && !simd_supported(max); max--);
+
+    return max;
+}
+
+/**
+ *\brief                        最低的1位的位置
+ *\param[in]    mask            比较结果的掩码,不为0
+ *\return                       位置
+ */
+static inline unsigned simd_ctz(unsigned mask)
+{
+#ifdef _MSC_VER
+    unsigned long pos;
+
+    _BitScanForward(&pos, mask);
+    return (unsigned)pos;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+#endif
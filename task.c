@@ -0,0 +1,253 @@
+/**
+ *\file     task.c
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    工作窃取任务池实现
+ *          队列用锁保护,任务的粒度在毫秒级,锁的开销可以忽略.
+ *          加入任务先增加busy再放入队列,取到的任务执行完才减少busy,
+ *          busy为0并且不再加入公共任务时所有线程退出
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#include "task.h"
+
+int task_pool_init(PTASK_POOL pool, int count)
+{
+    memset(pool, 0, sizeof(TASK_POOL));
+
+    pool->queue = calloc(count + 1, sizeof(TASK_QUEUE));
+
+    if (NULL == pool->queue)
+    {
+        return -1;
+    }
+
+    pool->count = count;
+
+    for (int i = 0; i <= count; i++)
+    {
+        mutex_init(&pool->queue[i].lock);
+    }
+
+    mutex_init(&pool->lock);
+    cond_init(&pool->cond);
+    return 0;
+}
+
+void task_pool_free(PTASK_POOL pool)
+{
+    if (NULL == pool->queue)
+    {
+        return;
+    }
+
+    for (int i = 0; i <= pool->count; i++)
+    {
+        free(pool->queue[i].item);
+        mutex_free(&pool->queue[i].lock);
+    }
+
+    free(pool->queue);
+    cond_free(&pool->cond);
+    mutex_free(&pool->lock);
+    pool->queue = NULL;
+}
+
+/**
+ *\brief                        任务放入队列尾部,满时扩大一倍
+ *\param[in]    queue           任务队列,已加锁
+ *\param[in]    task            任务
+ *\return                       0-成功,其它失败
+ */
+static int queue_put(PTASK_QUEUE queue, PTASK task)
+{
+    if (queue->count == queue->cap)
+    {
+        size_t cap  = queue->cap ? queue->cap * 2 : 256;
+        PTASK  item = malloc(cap * sizeof(TASK));
+
+        if (NULL == item)
+        {
+            return -1;
+        }
+
+        for (size_t i = 0; i < queue->count; i++) // 展开环形缓冲区
+        {
+            item[i] = queue->item[(queue->head + i) % queue->cap];
+        }
+
+        free(queue->item);
+        queue->item = item;
+        queue->head = 0;
+        queue->cap  = cap;
+    }
+
+    queue->item[(queue->head + queue->count) % queue->cap] = *task;
+    queue->count++;
+    return 0;
+}
+
+/**
+ *\brief                        从队列取任务
+ *\param[in]    queue           任务队列
+ *\param[in]    last            1-取尾部最后加入的,0-取头部最早加入的
+ *\param[out]   task            任务
+ *\return                       1-取到,0-队列为空
+ */
+static int queue_take(PTASK_QUEUE queue, int last, PTASK task)
+{
+    int ret = 0;
+
+    mutex_lock(&queue->lock);
+
+    if (queue->count > 0)
+    {
+        if (last)
+        {
+            *task = queue->item[(queue->head + queue->count - 1) % queue->cap];
+        }
+        else
+        {
+            *task = queue->item[queue->head];
+            queue->head = (queue->head + 1) % queue->cap;
+        }
+
+        queue->count--;
+        ret = 1;
+    }
+
+    mutex_unlock(&queue->lock);
+    return ret;
+}
+
+int task_push(PTASK_POOL pool, int worker, task_proc proc, void *param)
+{
+    PTASK_QUEUE queue = &pool->queue[(worker < 0) ? pool->count : worker];
+    TASK        task  = { proc, param };
+
+    atomic_add(&pool->busy, 1); // 先于放入队列,取到任务的线程看到的busy不会为0
+
+    mutex_lock(&queue->lock);
+    int ret = queue_put(queue, &task);
+    mutex_unlock(&queue->lock);
+
+    if (0 != ret)
+    {
+        atomic_add(&pool->busy, -1);
+        return ret;
+    }
+
+    atomic_add(&pool->queued, 1);
+
+    mutex_lock(&pool->lock);
+
+    if (pool->idle > 0)
+    {
+        cond_signal(&pool->cond);
+    }
+
+    mutex_unlock(&pool->lock);
+    return 0;
+}
+
+void task_finish(PTASK_POOL pool)
+{
+    mutex_lock(&pool->lock);
+    pool->done = 1;
+    cond_broadcast(&pool->cond);
+    mutex_unlock(&pool->lock);
+}
+
+/**
+ *\brief                        取一个任务执行,依次从自己的队列尾部,其它线程队列头部,公共队列头部取
+ *\param[in]    pool            任务池
+ *\param[in]    worker          线程序号
+ *\param[in]    pub             是否从公共队列取
+ *\return                       1-执行了任务,0-没有任务
+ */
+static int task_run(PTASK_POOL pool, int worker, int pub)
+{
+    TASK task;
+    int  got = queue_take(&pool->queue[worker], 1, &task);
+
+    for (int i = 1; !got && i < pool->count; i++) // 从下一个线程开始,避免都从同一个线程取
+    {
+        got = queue_take(&pool->queue[(worker + i) % pool->count], 0, &task);
+
+        if (got)
+        {
+            atomic_add(&pool->stolen, 1);
+        }
+    }
+
+    if (!got && pub)
+    {
+        got = queue_take(&pool->queue[pool->count], 0, &task);
+    }
+
+    if (!got)
+    {
+        return 0;
+    }
+
+    atomic_add(&pool->queued, -1);
+
+    task.proc(task.param, worker);
+
+    if (0 == atomic_add(&pool->busy, -1))
+    {
+        mutex_lock(&pool->lock);
+
+        if (pool->done)
+        {
+            cond_broadcast(&pool->cond);
+        }
+
+        mutex_unlock(&pool->lock);
+    }
+
+    return 1;
+}
+
+void task_loop(PTASK_POOL pool, int worker)
+{
+    for (;;)
+    {
+        if (task_run(pool, worker, 1))
+        {
+            continue;
+        }
+
+        mutex_lock(&pool->lock);
+
+        // 加入任务时先增加queued再加锁唤醒,这里加锁后检查不会错过唤醒
+        while (0 == atomic_add(&pool->queued, 0) && !(pool->done && 0 == atomic_add(&pool->busy, 0)))
+        {
+            pool->idle++;
+            cond_wait(&pool->cond, &pool->lock);
+            pool->idle--;
+        }
+
+        int finished = pool->done && 0 == atomic_add(&pool->busy, 0);
+
+        mutex_unlock(&pool->lock);
+
+        if (finished)
+        {
+            break;
+        }
+    }
+}
+
+void task_wait(PTASK_POOL pool, int worker, volatile long *pending)
+{
+    while (atomic_add(pending, 0) > 0)
+    {
+        if (!task_run(pool, worker, 0)) // 剩下的任务在其它线程执行中
+        {
+            thread_yield();
+        }
+    }
+}
@@ -0,0 +1,109 @@
+/**
+ *\file     task.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    工作窃取任务池
+ *          每个线程一个任务队列,线程从自己的队列尾部取最后加入的任务,
+ *          自己的队列空了时从其它线程队列的头部取最早加入的任务;另有一个公共队列按加入顺序取.
+ *          执行中的任务可以再加入任务,等待时帮助执行线程队列中的任务,不会执行公共队列中的任务
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ */
+#ifndef _TASK_H_
+#define _TASK_H_
+
+#include "platform.h"
+
+#define TASK_PUBLIC             -1                                          ///< 加入公共队列
+
+/**
+ *\brief                        任务函数
+ *\param[in]    param           任务参数
+ *\param[in]    worker          执行任务的线程序号
+ *\return                       无
+ */
+typedef void (*task_proc)(void *param, int worker);
+
+typedef struct _TASK                                                        ///  任务
+{
+    task_proc       proc;                                                   ///< 任务函数
+    void           *param;                                                  ///< 任务参数
+
+} TASK, *PTASK;
+
+typedef struct _TASK_QUEUE                                                  ///  任务队列,环形缓冲区
+{
+    mutex_t         lock;                                                   ///< 队列锁
+    PTASK           item;                                                   ///< 任务
+    size_t          head;                                                   ///< 第一个任务的位置
+    size_t          count;                                                  ///< 任务数
+    size_t          cap;                                                    ///< 容量
+
+} TASK_QUEUE, *PTASK_QUEUE;
+
+typedef struct _TASK_POOL                                                   ///  任务池
+{
+    int             count;                                                  ///< 线程数
+    PTASK_QUEUE     queue;                                                  ///< 每个线程一个队列,最后一个是公共队列
+    mutex_t         lock;                                                   ///< 空闲线程等待锁
+    cond_t          cond;                                                   ///< 有新任务或全部完成时唤醒空闲线程
+    int             idle;                                                   ///< 等待中的线程数
+    int             done;                                                   ///< 不再加入公共任务
+    volatile long   queued;                                                 ///< 队列中的任务数
+    volatile long   busy;                                                   ///< 没有完成的任务数,包括执行中的
+    volatile long   stolen;                                                 ///< 从其它线程队列中取到的任务数,统计用
+
+} TASK_POOL, *PTASK_POOL;
+
+/**
+ *\brief                        初始化任务池,不创建线程,线程由使用者创建后调用task_loop
+ *\param[in]    pool            任务池
+ *\param[in]    count           线程数
+ *\return                       0-成功,其它失败
+ */
+int task_pool_init(PTASK_POOL pool, int count);
+
+/**
+ *\brief                        释放任务池,线程都已结束
+ *\param[in]    pool            任务池
+ *\return                       无
+ */
+void task_pool_free(PTASK_POOL pool);
+
+/**
+ *\brief                        加入任务
+ *\param[in]    pool            任务池
+ *\param[in]    worker          当前线程序号,加入自己的队列;TASK_PUBLIC加入公共队列
+ *\param[in]    proc            任务函数
+ *\param[in]    param           任务参数
+ *\return                       0-成功,其它失败
+ */
+int task_push(PTASK_POOL pool, int worker, task_proc proc, void *param);
+
+/**
+ *\brief                        不再加入公共任务,所有任务完成后task_loop返回
+ *\param[in]    pool            任务池
+ *\return                       无
+ */
+void task_finish(PTASK_POOL pool);
+
+/**
+ *\brief                        线程执行任务,直到task_finish后所有任务都完成
+ *\param[in]    pool            任务池
+ *\param[in]    worker          线程序号
+ *\return                       无
+ */
+void task_loop(PTASK_POOL pool, int worker);
+
+/**
+ *\brief                        等待计数变为0,等待时执行线程队列中的任务
+ *\param[in]    pool            任务池
+ *\param[in]    worker          线程序号
+ *\param[in]    pending         未完成的任务数,任务完成时用atomic_add减1
+ *\return                       无
+ */
+void task_wait(PTASK_POOL pool, int worker, volatile long *pending);
+
+#endif
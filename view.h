@@ -0,0 +1,183 @@
+/**
+ *\file     view.h
+ *\note     UTF-8
+ *\author   xt
+ *\version  0.0.1
+ *\brief    有界数据视图,所有对文件数据的读取都通过这里,不会越过文件结尾
+ *          读取按小端字节序逐字节组合,不要求地址对齐,
+ *          检查先做一次范围判断(VIEW_HAS),范围内再用le16/le32直接读
+ *          时间|事件
+ *          -|-
+ *          2026.10.18|创建文件
+ *          2026.10.18|增加le64
+ *          2026.10.18|增加限长字符串view_strn
+ */
+#ifndef _VIEW_H_
+#define _VIEW_H_
+
+#include <stddef.h>
+#include "platform.h"
+
+typedef struct _PE_VIEW                                                     ///  有界数据视图
+{
+    UCHAR      *data;                                                       ///< 数据
+    size_t      size;                                                       ///< 数据长度
+
+} PE_VIEW, *PPE_VIEW;
+
+/// 视图中从off开始有len字节,不会溢出
+#define VIEW_HAS(view, off, len)    ((ULONGLONG)(off) <= (view)->size && (ULONGLONG)(len) <= (view)->size - (ULONGLONG)(off))
+
+/// 读结构成员,p已经检查过包含整个结构
+#define VIEW_FIELD16(p, type, member)   le16((const UCHAR*)(p) + offsetof(type, member))
+#define VIEW_FIELD32(p, type, member)   le32((const UCHAR*)(p) + offsetof(type, member))
+
+/**
+ *\brief                        读小端WORD,不检查范围
+ *\param[in]    p               数据
+ *\return                       值
+ */
+static inline WORD le16(const UCHAR *p)
+{
+    return (WORD)(p[0] | (p[1] << 8));
+}
+
+/**
+ *\brief                        读小端DWORD,不检查范围
+ *\param[in]    p               数据
+ *\return                       值
+ */
+static inline DWORD le32(const UCHAR *p)
+{
+    return (DWORD)p[0] | ((DWORD)p[1] << 8) | ((DWORD)p[2] << 16) | ((DWORD)p[3] << 24);
+}
+
+/**
+ *\brief                        读小端ULONGLONG,不检查范围
+ *\param[in]    p               数据
+ *\return                       值
+ */
+static inline ULONGLONG le64(const UCHAR *p)
+{
+    return (ULONGLONG)le32(p) | ((ULONGLONG)le32(p + 4) << 32);
+}
+
+/**
+ *\brief                        读小端WORD
+ *\param[in]    view            视图
+ *\param[in]    off             位置
+ *\param[out]   value           值
+ *\return                       0-成功,-1-超出范围
+ */
+static inline int view_u16(PPE_VIEW view, ULONGLONG off, WORD *value)
+{
+    if (!VIEW_HAS(view, off, 2))
+    {
+        return -1;
+    }
+
+    *value = le16(view->data + off);
+    return 0;
+}
+
+/**
+ *\brief                        读小端DWORD
+ *\param[in]    view            视图
+ *\param[in]    off             位置
+ *\param[out]   value           值
+ *\return                       0-成功,-1-超出范围
+ */
+static inline int view_u32(PPE_VIEW view, ULONGLONG off, DWORD *value)
+{
+    if (!VIEW_HAS(view, off, 4))
+    {
+        return -1;
+    }
+
+    *value = le32(view->data + off);
+    return 0;
+}
+
+/**
+ *\brief                        读小端WORD,超出范围时返回0,用于显示
+ *\param[in]    view            视图
+ *\param[in]    off             位置
+ *\return                       值
+ */
+static inline WORD view_get16(PPE_VIEW view, ULONGLONG off)
+{
+    return VIEW_HAS(view, off, 2) ? le16(view->data + off) : 0;
+}
+
+/**
+ *\brief                        读小端DWORD,超出范围时返回0,用于显示
+ *\param[in]    view            视图
+ *\param[in]    off             位置
+ *\return                       值
+ */
+static inline DWORD view_get32(PPE_VIEW view, ULONGLONG off)
+{
+    return VIEW_HAS(view, off, 4) ? le32(view->data + off) : 0;
+}
+
+/**
+ *\brief                        得到以0结尾的字符串
+ *\param[in]    view            视图
+ *\param[in]    off             位置
+ *\param[out]   len             字符串长度,不包括结尾的0,可以为NULL
+ *\return                       字符串,超出范围或到文件结尾都没有0时返回NULL
+ */
+static inline const char* view_cstr(PPE_VIEW view, ULONGLONG off, size_t *len)
+{
+    if (off >= view->size)
+    {
+        return NULL;
+    }
+
+    const char *str = (const char*)view->data + off;
+    const char *end = memchr(str, '\0', (size_t)(view->size - off));
+
+    if (NULL == end)
+    {
+        return NULL;
+    }
+
+    if (NULL != len)
+    {
+        *len = (size_t)(end - str);
+    }
+
+    return str;
+}
+
+/**
+ *\brief                        得到以0结尾的字符串,最多max字节,超过max或到文件结尾都没有0时截断
+ *\param[in]    view            视图
+ *\param[in]    off             位置,0为没有字符串
+ *\param[in]    max             最大长度
+ *\param[out]   len             字符串长度,不包括结尾的0
+ *\return                       字符串,没有字符串或超出范围时返回""
+ */
+static inline const char* view_strn(PPE_VIEW view, ULONGLONG off, size_t max, size_t *len)
+{
+    *len = 0;
+
+    if (0 == off || off >= view->size)
+    {
+        return "";
+    }
+
+    const char *str = (const char*)view->data + off;
+
+    if (max > view->size - off)
+    {
+        max = (size_t)(view->size - off);
+    }
+
+    const char *end = memchr(str, '\0', max);
+
+    *len = (NULL != end) ? (size_t)(end - str) : max;
+    return str;
+}
+
+#endif